@@ -0,0 +1,6 @@
+#!/bin/bash
+# Import the results of the benchmarks target to MongoDB.
+# Usage: mongoimport_benchmarks.sh [benchmarks.json]
+file=${1:-../build/perform/benchmarks.json}
+echo $file
+mongoimport -d benchmarks -c results $file
@@ -0,0 +1,106 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Machine-readable results for the benchmarks.
+ *
+ *              A benchmark given "--json" anywhere on its command line
+ *              prints one JSON object per result and line instead of its
+ *              table, e.g.
+ *
+ *              {"benchmark":"hyper_seq_perf","case":"r2_b1","metric":"wr_seq_per_s",
+ *               "value":1.2e+07,"unit":"seq/s","iterations":20,
+ *               "hostname":"jelly","ts":"2018-09-10T12:00:00Z","hdf5":"1.11.4"}
+ *
+ *              so the output of several runs can simply be concatenated
+ *              and read with test/json2csv.py (pandas.read_json with
+ *              lines=True) or mongoimport.
+ */
+#ifndef BENCH_JSON_H
+#define BENCH_JSON_H
+
+#include <time.h>
+
+#include "hdf5.h"
+#include "H5private.h"
+
+/* Whether results are printed as JSON, and by which benchmark */
+static hbool_t bench_json_g = FALSE;
+static const char *bench_name_g = "";
+
+
+/*-------------------------------------------------------------------------
+ * Function:    bench_json_init
+ *
+ * Purpose:     Note the benchmark's NAME and remove "--json" from its
+ *              arguments, so the benchmark's own argument parsing is
+ *              unchanged.
+ *
+ * Return:      Whether results are printed as JSON
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+bench_json_init(const char *name, int *argc, char *argv[])
+{
+    int i, j;
+
+    bench_name_g = name;
+    for(i = j = 1; i < *argc; i++)
+        if(!HDstrcmp(argv[i], "--json"))
+            bench_json_g = TRUE;
+        else
+            argv[j++] = argv[i];
+    *argc = j;
+    argv[j] = NULL;
+
+    return bench_json_g;
+} /* end bench_json_init() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    bench_json_record
+ *
+ * Purpose:     Print the result VALUE, in UNIT, of METRIC for CASE_NAME,
+ *              measured over ITERS iterations, as a JSON object.  Names
+ *              are the caller's and aren't escaped.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+bench_json_record(const char *case_name, const char *metric, double value,
+    const char *unit, unsigned long long iters)
+{
+    static char host[64] = "";
+    static char ts[32] = "";
+    unsigned maj = 0, min = 0, rel = 0;
+
+    /* One host and timestamp per run, so its results group together */
+    if(!host[0]) {
+        time_t now = HDtime(NULL);
+
+        if(HDgethostname(host, sizeof(host)) < 0)
+            HDstrcpy(host, "unknown");
+        host[sizeof(host) - 1] = '\0';
+        HDstrftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%SZ", HDgmtime(&now));
+    } /* end if */
+    H5get_libversion(&maj, &min, &rel);
+
+    HDfprintf(stdout, "{\"benchmark\":\"%s\",\"case\":\"%s\",\"metric\":\"%s\",\"value\":%.6g,"
+            "\"unit\":\"%s\",\"iterations\":%llu,\"hostname\":\"%s\",\"ts\":\"%s\",\"hdf5\":\"%u.%u.%u\"}\n",
+            bench_name_g, case_name, metric, value, unit, iters, host, ts, maj, min, rel);
+} /* end bench_json_record() */
+
+#endif /* BENCH_JSON_H */
@@ -0,0 +1,119 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure the throughput, in GB/s, of each lookup3 metadata
+ *              checksum implementation over buffer sizes typical of
+ *              object header chunks and VFD SWMR indices, after checking
+ *              that every implementation matches H5_checksum_lookup3().
+ *
+ * Usage:       chksum_perf [--json] [total megabytes per measurement]
+ */
+
+#include "bench_json.h"
+
+#define CHKSUM_PERF_DEF_MB      256
+#define CHKSUM_PERF_MAX_SIZE    (1024 * 1024)
+
+static const size_t chksum_perf_sizes_g[] = {64, 512, 4096, 65536, CHKSUM_PERF_MAX_SIZE};
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_impl
+ *
+ * Purpose:     Compare an implementation with H5_checksum_lookup3() for
+ *              every length up to 256 bytes at every 32-bit misalignment.
+ *
+ * Return:      0 on match, 1 on mismatch
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+check_impl(H5_checksum_impl_t impl, const uint8_t *buf)
+{
+    size_t off, len;
+
+    for(off = 0; off < 4; off++)
+        for(len = 0; len <= 256; len++)
+            if(H5_checksum_lookup3_impl(impl, buf + off, len, (uint32_t)len) != H5_checksum_lookup3(buf + off, len, (uint32_t)len)) {
+                HDfprintf(stderr, "%s: mismatch at offset %u, length %u\n", H5_checksum_impl_name(impl), (unsigned)off, (unsigned)len);
+                return 1;
+            } /* end if */
+
+    return 0;
+} /* end check_impl() */
+
+
+int
+main(int argc, char *argv[])
+{
+    uint8_t *buf = NULL;
+    size_t total = (size_t)CHKSUM_PERF_DEF_MB * 1024 * 1024;
+    unsigned s;
+    int i;
+    int ret_value = EXIT_SUCCESS;
+
+    bench_json_init("chksum_perf", &argc, argv);
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        total = (size_t)HDatoi(argv[1]) * 1024 * 1024;
+
+    if(NULL == (buf = (uint8_t *)HDmalloc((size_t)CHKSUM_PERF_MAX_SIZE + 4))) {
+        HDfprintf(stderr, "can't allocate buffer\n");
+        return EXIT_FAILURE;
+    } /* end if */
+    for(s = 0; s < CHKSUM_PERF_MAX_SIZE + 4; s++)
+        buf[s] = (uint8_t)(s * 2654435761U >> 24);
+
+    if(!bench_json_g)
+        HDfprintf(stdout, "%-8s %10s %10s\n", "impl", "size", "GB/s");
+    for(i = 0; i < H5_CHECKSUM_IMPL_NTYPES; i++) {
+        H5_checksum_impl_t impl = (H5_checksum_impl_t)i;
+
+        if(!H5_checksum_impl_supported(impl)) {
+            if(!bench_json_g)
+                HDfprintf(stdout, "%-8s (not supported on this host)\n", H5_checksum_impl_name(impl));
+            continue;
+        } /* end if */
+        if(check_impl(impl, buf)) {
+            ret_value = EXIT_FAILURE;
+            continue;
+        } /* end if */
+
+        for(s = 0; s < NELMTS(chksum_perf_sizes_g); s++) {
+            size_t size = chksum_perf_sizes_g[s];
+            size_t iters = MAX(total / size, 1);
+            volatile uint32_t sink = 0;
+            double start, elapsed, gbps;
+            char name[32];
+            size_t u;
+
+            start = H5_get_time();
+            for(u = 0; u < iters; u++)
+                sink += H5_checksum_lookup3_impl(impl, buf, size, sink);
+            elapsed = H5_get_time() - start;
+
+            gbps = elapsed > 0.0 ? ((double)iters * (double)size) / elapsed / 1e9 : 0.0;
+
+            if(bench_json_g) {
+                HDsnprintf(name, sizeof(name), "%s_%lu", H5_checksum_impl_name(impl), (unsigned long)size);
+                bench_json_record(name, "throughput", gbps, "GB/s", (unsigned long long)iters);
+            } /* end if */
+            else
+                HDfprintf(stdout, "%-8s %10lu %10.3f\n", H5_checksum_impl_name(impl), (unsigned long)size, gbps);
+        } /* end for */
+    } /* end for */
+
+    HDfree(buf);
+
+    return ret_value;
+} /* end main() */
@@ -0,0 +1,184 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure the rate at which a contiguous dataset is read into
+ *              and written from a memory buffer holding one element in
+ *              every STRIDE, for 1, 2, 4 and 8 byte elements, with each of
+ *              the memory gather/scatter kernels selectable with the data
+ *              transfer property list (see H5S_hyper_copy_regular()).
+ *
+ * Usage:       hyper_copy_perf [--json] [iterations]
+ */
+
+#include "bench_json.h"
+
+#define HYPER_COPY_PERF_DEF_ITERS   20
+#define HYPER_COPY_PERF_NELMTS      (1024 * 1024)
+#define HYPER_COPY_PERF_FILE        "hyper_copy_perf.h5"
+
+/* Name of the data transfer property choosing the kernel */
+#define HYPER_COPY_PERF_PROP        "select_copy"
+
+/* Kernels measured, with their H5S_sel_copy_t values */
+static const struct {
+    const char *name;
+    int value;
+} hyper_copy_perf_kernels_g[] = {
+    {"seq_list", 0},
+    {"stride", 2},
+    {"simd", 3}
+};
+
+/* Memory strides, in elements, measured */
+static const hsize_t hyper_copy_perf_strides_g[] = {2, 3, 8};
+
+
+/*-------------------------------------------------------------------------
+ * Function:    run_case
+ *
+ * Purpose:     Write and read back a dataset of elements of type TID from a
+ *              memory buffer with one element every STRIDE, ITERS times
+ *              and report the rates.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+run_case(hid_t fid, hid_t tid, hsize_t stride, const char *kernel, hid_t dxpl,
+    unsigned iters)
+{
+    hsize_t dims = HYPER_COPY_PERF_NELMTS;
+    hsize_t mem_dims = HYPER_COPY_PERF_NELMTS * stride;
+    hsize_t start = 0, count = HYPER_COPY_PERF_NELMTS;
+    hid_t fsid = -1, msid = -1, did = -1;
+    size_t size = H5Tget_size(tid);
+    char name[48];
+    void *buf = NULL;
+    double wstart, wtime, rstart, rtime;
+    unsigned u;
+
+    HDsnprintf(name, sizeof(name), "%s_%u_%u", kernel, (unsigned)size, (unsigned)stride);
+    if((fsid = H5Screate_simple(1, &dims, NULL)) < 0)
+        goto error;
+    if((msid = H5Screate_simple(1, &mem_dims, NULL)) < 0)
+        goto error;
+    if(H5Sselect_hyperslab(msid, H5S_SELECT_SET, &start, &stride, &count, NULL) < 0)
+        goto error;
+    if((did = H5Dcreate2(fid, name, tid, fsid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        goto error;
+    if(NULL == (buf = HDcalloc((size_t)mem_dims, size)))
+        goto error;
+
+    wstart = H5_get_time();
+    for(u = 0; u < iters; u++)
+        if(H5Dwrite(did, tid, msid, fsid, dxpl, buf) < 0)
+            goto error;
+    wtime = H5_get_time() - wstart;
+
+    rstart = H5_get_time();
+    for(u = 0; u < iters; u++)
+        if(H5Dread(did, tid, msid, fsid, dxpl, buf) < 0)
+            goto error;
+    rtime = H5_get_time() - rstart;
+
+    if(bench_json_g) {
+        bench_json_record(name, "wr_elmts_per_s", wtime > 0.0 ? (double)HYPER_COPY_PERF_NELMTS * iters / wtime : 0.0, "elmts/s", iters);
+        bench_json_record(name, "rd_elmts_per_s", rtime > 0.0 ? (double)HYPER_COPY_PERF_NELMTS * iters / rtime : 0.0, "elmts/s", iters);
+    } /* end if */
+    else
+        HDfprintf(stdout, "%-9s %5u %7u %12.1f %12.1f\n", kernel, (unsigned)size, (unsigned)stride,
+                wtime > 0.0 ? (double)HYPER_COPY_PERF_NELMTS * iters / wtime / 1e6 : 0.0,
+                rtime > 0.0 ? (double)HYPER_COPY_PERF_NELMTS * iters / rtime / 1e6 : 0.0);
+
+    HDfree(buf);
+    if(H5Dclose(did) < 0)
+        goto error;
+    if(H5Sclose(msid) < 0)
+        goto error;
+    if(H5Sclose(fsid) < 0)
+        goto error;
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Sclose(msid);
+        H5Sclose(fsid);
+    } H5E_END_TRY;
+    if(buf)
+        HDfree(buf);
+    HDfprintf(stderr, "%s, %u byte elements, stride %u: I/O failed\n", kernel, (unsigned)size, (unsigned)stride);
+    return 1;
+} /* end run_case() */
+
+
+int
+main(int argc, char *argv[])
+{
+    const hid_t types[] = {H5T_NATIVE_UCHAR, H5T_NATIVE_USHORT, H5T_NATIVE_UINT, H5T_NATIVE_ULLONG};
+    unsigned iters = HYPER_COPY_PERF_DEF_ITERS;
+    hid_t fapl = -1, fid = -1, dxpl = -1;
+    htri_t have_prop;
+    unsigned k, t, s;
+    int ret_value = EXIT_SUCCESS;
+
+    bench_json_init("hyper_copy_perf", &argc, argv);
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        iters = (unsigned)HDatoi(argv[1]);
+
+    /* Keep the file in memory, so the copies aren't hidden by I/O */
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto error;
+    if(H5Pset_fapl_core(fapl, (size_t)(64 * 1024 * 1024), FALSE) < 0)
+        goto error;
+    if((fid = H5Fcreate(HYPER_COPY_PERF_FILE, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
+        goto error;
+    if((dxpl = H5Pcreate(H5P_DATASET_XFER)) < 0)
+        goto error;
+    if((have_prop = H5Pexist(dxpl, HYPER_COPY_PERF_PROP)) < 0)
+        goto error;
+    if(!have_prop && !bench_json_g)
+        HDfprintf(stdout, "(no \"%s\" property: measuring the default kernel only)\n", HYPER_COPY_PERF_PROP);
+
+    if(!bench_json_g)
+        HDfprintf(stdout, "%-9s %5s %7s %12s %12s\n", "kernel", "size", "stride", "wr Melem/s", "rd Melem/s");
+    for(k = 0; k < (have_prop ? NELMTS(hyper_copy_perf_kernels_g) : 1); k++) {
+        if(have_prop && H5Pset(dxpl, HYPER_COPY_PERF_PROP, &hyper_copy_perf_kernels_g[k].value) < 0)
+            goto error;
+        for(t = 0; t < NELMTS(types); t++)
+            for(s = 0; s < NELMTS(hyper_copy_perf_strides_g); s++)
+                if(run_case(fid, types[t], hyper_copy_perf_strides_g[s],
+                        have_prop ? hyper_copy_perf_kernels_g[k].name : "default", dxpl, iters))
+                    ret_value = EXIT_FAILURE;
+    } /* end for */
+
+    if(H5Pclose(dxpl) < 0)
+        goto error;
+    if(H5Fclose(fid) < 0)
+        goto error;
+    if(H5Pclose(fapl) < 0)
+        goto error;
+
+    return ret_value;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Pclose(dxpl);
+        H5Fclose(fid);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+    return EXIT_FAILURE;
+} /* end main() */
@@ -0,0 +1,157 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure the time and memory taken to build irregular
+ *              hyperslab selections from many small blocks combined with
+ *              H5S_SELECT_OR, as for point-cloud style selections, and the
+ *              time to copy the result.
+ *
+ * Usage:       hyper_or_perf [--json] [number of blocks] [random seed]
+ */
+
+#include "bench_json.h"
+
+#define HYPER_OR_PERF_DEF_NBLOCKS   10000
+#define HYPER_OR_PERF_DIM           4096
+#define HYPER_OR_PERF_MAX_BLOCK     8
+
+/* Ranks of the selections built */
+static const unsigned hyper_or_perf_ranks_g[] = {2, 3};
+
+
+/*-------------------------------------------------------------------------
+ * Function:    max_rss_kb
+ *
+ * Purpose:     Get the peak resident set size of the process.
+ *
+ * Return:      Peak RSS in kilobytes, or 0 if unknown
+ *
+ *-------------------------------------------------------------------------
+ */
+static long
+max_rss_kb(void)
+{
+#ifdef H5_HAVE_GETRUSAGE
+    struct rusage ru;
+
+    if(0 == HDgetrusage(RUSAGE_SELF, &ru))
+        return (long)ru.ru_maxrss;
+#endif /* H5_HAVE_GETRUSAGE */
+    return 0;
+} /* end max_rss_kb() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    run_rank
+ *
+ * Purpose:     Build one selection of NBLOCKS random blocks in a dataspace
+ *              of RANK dimensions and report the timings.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+run_rank(unsigned rank, unsigned nblocks)
+{
+    hsize_t dims[H5S_MAX_RANK];
+    hsize_t start[H5S_MAX_RANK];
+    hsize_t block[H5S_MAX_RANK];
+    hsize_t count[H5S_MAX_RANK];
+    hid_t sid = -1, copy_sid = -1;
+    double build_start, build_time, copy_start, copy_time;
+    long rss_before;
+    char name[16];
+    unsigned u, d;
+
+    for(d = 0; d < rank; d++) {
+        dims[d] = HYPER_OR_PERF_DIM;
+        count[d] = 1;
+    } /* end for */
+
+    if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+        goto error;
+    if(H5Sselect_none(sid) < 0)
+        goto error;
+
+    rss_before = max_rss_kb();
+    build_start = H5_get_time();
+    for(u = 0; u < nblocks; u++) {
+        for(d = 0; d < rank; d++) {
+            block[d] = (hsize_t)(1 + HDrandom() % HYPER_OR_PERF_MAX_BLOCK);
+            start[d] = (hsize_t)HDrandom() % (dims[d] - block[d]);
+        } /* end for */
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, start, NULL, count, block) < 0)
+            goto error;
+    } /* end for */
+    build_time = H5_get_time() - build_start;
+
+    copy_start = H5_get_time();
+    if((copy_sid = H5Scopy(sid)) < 0)
+        goto error;
+    copy_time = H5_get_time() - copy_start;
+
+    if(bench_json_g) {
+        HDsnprintf(name, sizeof(name), "r%u", rank);
+        bench_json_record(name, "build_blocks_per_s", build_time > 0.0 ? (double)nblocks / build_time : 0.0, "blocks/s", nblocks);
+        bench_json_record(name, "copy_time", copy_time * 1000.0, "ms", 1);
+        bench_json_record(name, "rss_growth", (double)(max_rss_kb() - rss_before), "KB", 1);
+    } /* end if */
+    else
+        HDfprintf(stdout, "%4u %8u %12lld %12.3f %12.0f %10.3f %10ld\n", rank, nblocks,
+                (long long)H5Sget_select_npoints(sid), build_time,
+                build_time > 0.0 ? (double)nblocks / build_time : 0.0, copy_time * 1000.0,
+                max_rss_kb() - rss_before);
+
+    if(H5Sclose(copy_sid) < 0)
+        goto error;
+    if(H5Sclose(sid) < 0)
+        goto error;
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(copy_sid);
+        H5Sclose(sid);
+    } H5E_END_TRY;
+    HDfprintf(stderr, "rank %u: selection build failed\n", rank);
+    return 1;
+} /* end run_rank() */
+
+
+int
+main(int argc, char *argv[])
+{
+    unsigned nblocks = HYPER_OR_PERF_DEF_NBLOCKS;
+    unsigned seed = 12345;
+    unsigned u;
+    int ret_value = EXIT_SUCCESS;
+
+    bench_json_init("hyper_or_perf", &argc, argv);
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        nblocks = (unsigned)HDatoi(argv[1]);
+    if(argc > 2)
+        seed = (unsigned)HDatoi(argv[2]);
+    HDsrandom(seed);
+
+    if(!bench_json_g)
+        HDfprintf(stdout, "%4s %8s %12s %12s %12s %10s %10s\n", "rank", "blocks", "elements",
+                "build (s)", "blocks/s", "copy (ms)", "+RSS (KB)");
+    for(u = 0; u < NELMTS(hyper_or_perf_ranks_g); u++)
+        if(run_rank(hyper_or_perf_ranks_g[u], nblocks))
+            ret_value = EXIT_FAILURE;
+
+    return ret_value;
+} /* end main() */
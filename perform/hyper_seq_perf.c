@@ -0,0 +1,185 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure the rate at which regular strided hyperslab
+ *              selections of rank 2 and 3 are read from and written to a
+ *              contiguous dataset in memory, where the time is dominated
+ *              by generating the offset/length sequence lists.
+ *
+ * Usage:       hyper_seq_perf [--json] [iterations]
+ */
+
+#include "hdf5.h"
+#include "H5private.h"
+#include "bench_json.h"
+
+#define HYPER_SEQ_PERF_DEF_ITERS    20
+#define HYPER_SEQ_PERF_FILE         "hyper_seq_perf.h5"
+
+/* Selections measured: every other BLOCK x ... tile of an EXTENT cube */
+static const struct {
+    unsigned rank;
+    hsize_t extent;
+    hsize_t block;
+} hyper_seq_perf_cases_g[] = {
+    {2, 2048, 1},
+    {2, 2048, 4},
+    {3, 128, 1},
+    {3, 128, 4}
+};
+
+
+/*-------------------------------------------------------------------------
+ * Function:    run_case
+ *
+ * Purpose:     Write and read back a strided selection ITERS times and
+ *              report the rates.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+run_case(hid_t fid, unsigned rank, hsize_t extent, hsize_t blk, unsigned iters)
+{
+    hsize_t dims[H5S_MAX_RANK];
+    hsize_t start[H5S_MAX_RANK];
+    hsize_t stride[H5S_MAX_RANK];
+    hsize_t count[H5S_MAX_RANK];
+    hsize_t block[H5S_MAX_RANK];
+    hid_t sid = -1, did = -1;
+    char name[32];
+    int *buf = NULL;
+    hsize_t nblocks = 1;
+    hsize_t nseq;
+    hssize_t npoints;
+    double wstart, wtime, rstart, rtime;
+    unsigned u, d;
+
+    for(d = 0; d < rank; d++) {
+        dims[d] = extent;
+        start[d] = 0;
+        stride[d] = 2 * blk;
+        count[d] = extent / (2 * blk);
+        block[d] = blk;
+        nblocks *= count[d];
+    } /* end for */
+
+    /* Blocks don't touch, so each row of a block is one sequence */
+    nseq = nblocks;
+    for(d = 1; d < rank; d++)
+        nseq *= blk;
+
+    HDsnprintf(name, sizeof(name), "r%u_b%u", rank, (unsigned)blk);
+    if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+        goto error;
+    if((did = H5Dcreate2(fid, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        goto error;
+    if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, stride, count, block) < 0)
+        goto error;
+    if((npoints = H5Sget_select_npoints(sid)) < 0)
+        goto error;
+
+    /* Use the same dataspace for memory, so both sides are sequenced */
+    if(NULL == (buf = (int *)HDcalloc((size_t)H5Sget_simple_extent_npoints(sid), sizeof(int))))
+        goto error;
+
+    wstart = H5_get_time();
+    for(u = 0; u < iters; u++)
+        if(H5Dwrite(did, H5T_NATIVE_INT, sid, sid, H5P_DEFAULT, buf) < 0)
+            goto error;
+    wtime = H5_get_time() - wstart;
+
+    rstart = H5_get_time();
+    for(u = 0; u < iters; u++)
+        if(H5Dread(did, H5T_NATIVE_INT, sid, sid, H5P_DEFAULT, buf) < 0)
+            goto error;
+    rtime = H5_get_time() - rstart;
+
+    if(bench_json_g) {
+        bench_json_record(name, "wr_seq_per_s", wtime > 0.0 ? (double)(nseq * iters) / wtime : 0.0, "seq/s", iters);
+        bench_json_record(name, "rd_seq_per_s", rtime > 0.0 ? (double)(nseq * iters) / rtime : 0.0, "seq/s", iters);
+        bench_json_record(name, "wr_blocks_per_s", wtime > 0.0 ? (double)(nblocks * iters) / wtime : 0.0, "blocks/s", iters);
+        bench_json_record(name, "rd_blocks_per_s", rtime > 0.0 ? (double)(nblocks * iters) / rtime : 0.0, "blocks/s", iters);
+    } /* end if */
+    else
+        HDfprintf(stdout, "%4u %8llu %6llu %12llu %12.0f %12.0f %10.1f %10.1f\n", rank,
+                (unsigned long long)extent, (unsigned long long)blk, (unsigned long long)nblocks,
+                wtime > 0.0 ? (double)(nblocks * iters) / wtime : 0.0,
+                rtime > 0.0 ? (double)(nblocks * iters) / rtime : 0.0,
+                wtime > 0.0 ? (double)npoints * sizeof(int) * iters / wtime / (1024.0 * 1024.0) : 0.0,
+                rtime > 0.0 ? (double)npoints * sizeof(int) * iters / rtime / (1024.0 * 1024.0) : 0.0);
+
+    HDfree(buf);
+    if(H5Dclose(did) < 0)
+        goto error;
+    if(H5Sclose(sid) < 0)
+        goto error;
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Sclose(sid);
+    } H5E_END_TRY;
+    if(buf)
+        HDfree(buf);
+    HDfprintf(stderr, "rank %u, block %u: I/O failed\n", rank, (unsigned)blk);
+    return 1;
+} /* end run_case() */
+
+
+int
+main(int argc, char *argv[])
+{
+    unsigned iters = HYPER_SEQ_PERF_DEF_ITERS;
+    hid_t fapl = -1, fid = -1;
+    unsigned u;
+    int ret_value = EXIT_SUCCESS;
+
+    bench_json_init("hyper_seq_perf", &argc, argv);
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        iters = (unsigned)HDatoi(argv[1]);
+
+    /* Keep the file in memory, so the sequence lists aren't hidden by I/O */
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto error;
+    if(H5Pset_fapl_core(fapl, (size_t)(16 * 1024 * 1024), FALSE) < 0)
+        goto error;
+    if((fid = H5Fcreate(HYPER_SEQ_PERF_FILE, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
+        goto error;
+
+    if(!bench_json_g)
+        HDfprintf(stdout, "%4s %8s %6s %12s %12s %12s %10s %10s\n", "rank", "extent", "block",
+                "blocks", "wr blocks/s", "rd blocks/s", "wr MB/s", "rd MB/s");
+    for(u = 0; u < NELMTS(hyper_seq_perf_cases_g); u++)
+        if(run_case(fid, hyper_seq_perf_cases_g[u].rank, hyper_seq_perf_cases_g[u].extent,
+                hyper_seq_perf_cases_g[u].block, iters))
+            ret_value = EXIT_FAILURE;
+
+    if(H5Fclose(fid) < 0)
+        goto error;
+    if(H5Pclose(fapl) < 0)
+        goto error;
+
+    return ret_value;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Fclose(fid);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+    return EXIT_FAILURE;
+} /* end main() */
@@ -0,0 +1,191 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure the rate at which object headers are loaded into
+ *              the metadata cache (H5O__cache_deserialize()).
+ *
+ *              A file of datasets, each with a few attributes, is read
+ *              into memory with the core driver, so every pass re-opens it
+ *              with a cold metadata cache and then opens every dataset,
+ *              without file I/O.
+ *
+ * Usage:       ohdr_perf [--json] [iterations] [# of datasets]
+ */
+
+#include "hdf5.h"
+#include "H5private.h"
+#include "bench_json.h"
+
+#define OHDR_PERF_DEF_ITERS     10
+#define OHDR_PERF_DEF_NDSETS    2000
+#define OHDR_PERF_NATTRS        4
+#define OHDR_PERF_FILE          "ohdr_perf.h5"
+
+
+/*-------------------------------------------------------------------------
+ * Function:    create_file
+ *
+ * Purpose:     Create the file with NDSETS datasets, in the OLD (version
+ *              1) or latest object header format.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+create_file(unsigned ndsets, hbool_t old)
+{
+    hid_t fapl = -1, fid = -1, sid = -1, did = -1, aid = -1;
+    hsize_t dims[1] = {16};
+    char name[32];
+    unsigned u, v;
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto error;
+    if(!old && H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST) < 0)
+        goto error;
+    if((fid = H5Fcreate(OHDR_PERF_FILE, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
+        goto error;
+    if((sid = H5Screate_simple(1, dims, NULL)) < 0)
+        goto error;
+
+    for(u = 0; u < ndsets; u++) {
+        HDsnprintf(name, sizeof(name), "d%u", u);
+        if((did = H5Dcreate2(fid, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+            goto error;
+        for(v = 0; v < OHDR_PERF_NATTRS; v++) {
+            HDsnprintf(name, sizeof(name), "a%u", v);
+            if((aid = H5Acreate2(did, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+                goto error;
+            if(H5Aclose(aid) < 0)
+                goto error;
+        } /* end for */
+        if(H5Dclose(did) < 0)
+            goto error;
+    } /* end for */
+
+    if(H5Sclose(sid) < 0)
+        goto error;
+    if(H5Fclose(fid) < 0)
+        goto error;
+    if(H5Pclose(fapl) < 0)
+        goto error;
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Aclose(aid);
+        H5Dclose(did);
+        H5Sclose(sid);
+        H5Fclose(fid);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+    return 1;
+} /* end create_file() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    run_case
+ *
+ * Purpose:     Open the file and every dataset in it ITERS times and
+ *              report the rate.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+run_case(unsigned ndsets, hbool_t old, unsigned iters)
+{
+    const char *case_name = old ? "v1" : "latest";
+    hid_t fapl = -1, fid = -1, did = -1;
+    char name[32];
+    double start, time = 0.0;
+    unsigned u, v;
+
+    if(create_file(ndsets, old))
+        goto error;
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto error;
+    if(H5Pset_fapl_core(fapl, (size_t)(1024 * 1024), FALSE) < 0)
+        goto error;
+
+    for(u = 0; u < iters; u++) {
+        if((fid = H5Fopen(OHDR_PERF_FILE, H5F_ACC_RDONLY, fapl)) < 0)
+            goto error;
+
+        /* Only the opens, not reading the file into memory */
+        start = H5_get_time();
+        for(v = 0; v < ndsets; v++) {
+            HDsnprintf(name, sizeof(name), "d%u", v);
+            if((did = H5Dopen2(fid, name, H5P_DEFAULT)) < 0)
+                goto error;
+            if(H5Dclose(did) < 0)
+                goto error;
+        } /* end for */
+        time += H5_get_time() - start;
+
+        if(H5Fclose(fid) < 0)
+            goto error;
+    } /* end for */
+
+    if(bench_json_g)
+        bench_json_record(case_name, "headers_per_s", time > 0.0 ? (double)ndsets * iters / time : 0.0,
+                "headers/s", iters);
+    else
+        HDfprintf(stdout, "%-8s %8u %12.0f\n", case_name, ndsets,
+                time > 0.0 ? (double)ndsets * iters / time : 0.0);
+
+    if(H5Pclose(fapl) < 0)
+        goto error;
+    HDremove(OHDR_PERF_FILE);
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Fclose(fid);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+    HDremove(OHDR_PERF_FILE);
+    HDfprintf(stderr, "%s object headers: failed\n", case_name);
+    return 1;
+} /* end run_case() */
+
+
+int
+main(int argc, char *argv[])
+{
+    unsigned iters = OHDR_PERF_DEF_ITERS;
+    unsigned ndsets = OHDR_PERF_DEF_NDSETS;
+    int ret_value = EXIT_SUCCESS;
+
+    bench_json_init("ohdr_perf", &argc, argv);
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        iters = (unsigned)HDatoi(argv[1]);
+    if(argc > 2 && HDatoi(argv[2]) > 0)
+        ndsets = (unsigned)HDatoi(argv[2]);
+
+    if(!bench_json_g)
+        HDfprintf(stdout, "%-8s %8s %12s\n", "format", "datasets", "headers/s");
+    if(run_case(ndsets, TRUE, iters))
+        ret_value = EXIT_FAILURE;
+    if(run_case(ndsets, FALSE, iters))
+        ret_value = EXIT_FAILURE;
+
+    return ret_value;
+} /* end main() */
@@ -0,0 +1,202 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure h5repack throughput on a file of chunked datasets:
+ *              a plain copy, which copies unchanged chunks raw, a
+ *              re-chunking and a recompression.
+ *
+ *              h5repack is run as a separate process, the one named by
+ *              the H5REPACK environment variable or else the one on the
+ *              PATH, so the whole tool is measured.
+ *
+ * Usage:       repack_perf [--json] [MB of data]
+ */
+
+#include "hdf5.h"
+#include "H5private.h"
+#include "bench_json.h"
+
+#define REPACK_PERF_DEF_MB      64
+#define REPACK_PERF_NDSETS      4
+#define REPACK_PERF_CHUNK       (64 * 1024)     /* Elements per chunk */
+#define REPACK_PERF_IN_FILE     "repack_perf_in.h5"
+#define REPACK_PERF_OUT_FILE    "repack_perf_out.h5"
+
+/* h5repack options measured, NULL-terminated */
+static const struct {
+    const char *name;
+    const char *opts[4];
+} repack_perf_cases_g[] = {
+    {"copy",    {NULL}},
+    {"rechunk", {"-l", "CHUNK=32768", NULL}},
+    {"gzip1",   {"-f", "GZIP=1", NULL}}
+};
+
+
+/*-------------------------------------------------------------------------
+ * Function:    create_file
+ *
+ * Purpose:     Create the input file, with REPACK_PERF_NDSETS chunked
+ *              datasets of about *NBYTES bytes in all, and set *NBYTES to
+ *              their exact size.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+create_file(hsize_t *nbytes)
+{
+    hid_t fid = -1, sid = -1, dcpl = -1, did = -1;
+    hsize_t dims[1], chunk[1] = {REPACK_PERF_CHUNK};
+    int *buf = NULL;
+    char name[32];
+    hsize_t n;
+    unsigned u;
+
+    dims[0] = *nbytes / REPACK_PERF_NDSETS / sizeof(int);
+    dims[0] -= dims[0] % REPACK_PERF_CHUNK;
+    if(dims[0] == 0)
+        dims[0] = REPACK_PERF_CHUNK;
+    *nbytes = dims[0] * sizeof(int) * REPACK_PERF_NDSETS;
+
+    /* Compressible, but not trivially */
+    if(NULL == (buf = (int *)HDmalloc((size_t)dims[0] * sizeof(int))))
+        goto error;
+    for(n = 0; n < dims[0]; n++)
+        buf[n] = (int)((n * 2654435761U) >> 20);
+
+    if((fid = H5Fcreate(REPACK_PERF_IN_FILE, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        goto error;
+    if((sid = H5Screate_simple(1, dims, NULL)) < 0)
+        goto error;
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        goto error;
+    if(H5Pset_chunk(dcpl, 1, chunk) < 0)
+        goto error;
+    for(u = 0; u < REPACK_PERF_NDSETS; u++) {
+        HDsnprintf(name, sizeof(name), "d%u", u);
+        if((did = H5Dcreate2(fid, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+            goto error;
+        if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+            goto error;
+        if(H5Dclose(did) < 0)
+            goto error;
+    } /* end for */
+
+    if(H5Pclose(dcpl) < 0 || H5Sclose(sid) < 0 || H5Fclose(fid) < 0)
+        goto error;
+    HDfree(buf);
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(dcpl);
+        H5Sclose(sid);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(buf)
+        HDfree(buf);
+    return 1;
+} /* end create_file() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    run_case
+ *
+ * Purpose:     Repack the input file with case U's options and report
+ *              the throughput over the input's NBYTES.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+run_case(const char *h5repack, unsigned u, hsize_t nbytes)
+{
+    char *rargv[8];
+    double start, time;
+    pid_t pid;
+    int status, i = 0, j;
+
+    rargv[i++] = (char *)h5repack;
+    for(j = 0; repack_perf_cases_g[u].opts[j]; j++)
+        rargv[i++] = (char *)repack_perf_cases_g[u].opts[j];
+    rargv[i++] = (char *)REPACK_PERF_IN_FILE;
+    rargv[i++] = (char *)REPACK_PERF_OUT_FILE;
+    rargv[i] = NULL;
+
+    HDremove(REPACK_PERF_OUT_FILE);
+    HDfflush(stdout);
+    start = H5_get_time();
+    if((pid = HDfork()) < 0)
+        goto error;
+    if(pid == 0) {
+        HDexecvp(h5repack, rargv);
+        HD_exit(127);
+    } /* end if */
+    if(HDwaitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        goto error;
+    time = H5_get_time() - start;
+
+    if(bench_json_g)
+        bench_json_record(repack_perf_cases_g[u].name, "mb_per_s",
+                time > 0.0 ? (double)nbytes / time / (1024.0 * 1024.0) : 0.0, "MB/s", 1);
+    else
+        HDfprintf(stdout, "%-8s %8llu %10.3f %10.1f\n", repack_perf_cases_g[u].name,
+                (unsigned long long)(nbytes / (1024 * 1024)), time,
+                time > 0.0 ? (double)nbytes / time / (1024.0 * 1024.0) : 0.0);
+
+    HDremove(REPACK_PERF_OUT_FILE);
+    return 0;
+
+error:
+    HDremove(REPACK_PERF_OUT_FILE);
+    HDfprintf(stderr, "%s: %s failed\n", repack_perf_cases_g[u].name, h5repack);
+    return 1;
+} /* end run_case() */
+
+
+int
+main(int argc, char *argv[])
+{
+    const char *h5repack;
+    hsize_t nbytes = (hsize_t)REPACK_PERF_DEF_MB * 1024 * 1024;
+    unsigned u;
+    int ret_value = EXIT_SUCCESS;
+
+    bench_json_init("repack_perf", &argc, argv);
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        nbytes = (hsize_t)HDatoi(argv[1]) * 1024 * 1024;
+    if(NULL == (h5repack = HDgetenv("H5REPACK")) || !*h5repack)
+        h5repack = "h5repack";
+
+    if(create_file(&nbytes)) {
+        HDfprintf(stderr, "can't create %s\n", REPACK_PERF_IN_FILE);
+        HDremove(REPACK_PERF_IN_FILE);
+        return EXIT_FAILURE;
+    } /* end if */
+
+    if(!bench_json_g)
+        HDfprintf(stdout, "%-8s %8s %10s %10s\n", "options", "MB", "time (s)", "MB/s");
+    for(u = 0; u < NELMTS(repack_perf_cases_g); u++)
+        if(run_case(h5repack, u, nbytes))
+            ret_value = EXIT_FAILURE;
+
+    HDremove(REPACK_PERF_IN_FILE);
+
+    return ret_value;
+} /* end main() */
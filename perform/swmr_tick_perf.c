@@ -0,0 +1,433 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure the VFD SWMR tick latency: the time from a writer
+ *              appending an element to a reader seeing it, through the
+ *              writer's end of tick and the reader's next tick.
+ *
+ *              The writer appends its clock to a dataset.  A reader,
+ *              this program run again with -r, polls the dataset and
+ *              records how long ago each element was written, then
+ *              acknowledges it on a pipe.  The writer waits for the
+ *              acknowledgement and for a varying part of a tick, so
+ *              samples don't lock to the tick phase, before the next
+ *              append.  The writer's ticks end in its API calls, so it
+ *              makes a cheap one while it waits.
+ *
+ * Usage:       swmr_tick_perf [--json] [# of samples]
+ */
+
+#include "hdf5.h"
+#include "H5private.h"
+#include "bench_json.h"
+
+#define SWMR_TICK_PERF_DEF_SAMPLES  50
+#define SWMR_TICK_PERF_FILE         "swmr_tick_perf.h5"
+#define SWMR_TICK_PERF_MD_FILE      "swmr_tick_perf.md"
+#define SWMR_TICK_PERF_DSET         "t"
+#define SWMR_TICK_PERF_TICK_LEN     1           /* Tenths of a second */
+#define SWMR_TICK_PERF_POLL_NS      200000L     /* Time between polls */
+#define SWMR_TICK_PERF_TIMEOUT      10.0        /* Seconds to wait for the other side */
+
+
+/* Sleep for a poll interval */
+static void
+poll_sleep(void)
+{
+    struct timespec ts = {0, SWMR_TICK_PERF_POLL_NS};
+
+    HDnanosleep(&ts, NULL);
+} /* end poll_sleep() */
+
+
+static int
+cmp_double(const void *_a, const void *_b)
+{
+    double a = *(const double *)_a, b = *(const double *)_b;
+
+    return (a > b) - (a < b);
+} /* end cmp_double() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    open_swmr
+ *
+ * Purpose:     Open the file as the VFD SWMR WRITER or as a reader.
+ *
+ * Return:      File ID on success, negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static hid_t
+open_swmr(hbool_t writer)
+{
+    H5F_vfd_swmr_config_t config;
+    hid_t fapl = -1, fid = -1;
+
+    HDmemset(&config, 0, sizeof(config));
+    config.version = H5F__CURR_VFD_SWMR_CONFIG_VERSION;
+    config.tick_len = SWMR_TICK_PERF_TICK_LEN;
+    config.max_lag = 3;
+    config.vfd_swmr_writer = writer;
+    config.md_pages_reserved = 2;
+    HDstrcpy(config.md_file_path, SWMR_TICK_PERF_MD_FILE);
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto error;
+    if(H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST) < 0)
+        goto error;
+    if(H5Pset_page_buffer_size(fapl, 4096, 0, 0) < 0)
+        goto error;
+    if(H5Pset_vfd_swmr_config(fapl, &config) < 0)
+        goto error;
+    if((fid = H5Fopen(SWMR_TICK_PERF_FILE, writer ? H5F_ACC_RDWR : H5F_ACC_RDONLY, fapl)) < 0)
+        goto error;
+    if(H5Pclose(fapl) < 0)
+        goto error;
+
+    return fid;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Fclose(fid);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+    return -1;
+} /* end open_swmr() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    create_file
+ *
+ * Purpose:     Create the file, with paged allocation, and the dataset of
+ *              timestamps.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+create_file(void)
+{
+    hid_t fcpl = -1, fapl = -1, fid = -1, sid = -1, dcpl = -1, did = -1;
+    hsize_t dims[1] = {0}, max_dims[1] = {H5S_UNLIMITED}, chunk[1] = {64};
+
+    if((fcpl = H5Pcreate(H5P_FILE_CREATE)) < 0)
+        goto error;
+    if(H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, FALSE, (hsize_t)1) < 0)
+        goto error;
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto error;
+    if(H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST) < 0)
+        goto error;
+    if((fid = H5Fcreate(SWMR_TICK_PERF_FILE, H5F_ACC_TRUNC, fcpl, fapl)) < 0)
+        goto error;
+    if((sid = H5Screate_simple(1, dims, max_dims)) < 0)
+        goto error;
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        goto error;
+    if(H5Pset_chunk(dcpl, 1, chunk) < 0)
+        goto error;
+    if((did = H5Dcreate2(fid, SWMR_TICK_PERF_DSET, H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+        goto error;
+
+    if(H5Dclose(did) < 0 || H5Pclose(dcpl) < 0 || H5Sclose(sid) < 0)
+        goto error;
+    if(H5Fclose(fid) < 0 || H5Pclose(fapl) < 0 || H5Pclose(fcpl) < 0)
+        goto error;
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(dcpl);
+        H5Sclose(sid);
+        H5Fclose(fid);
+        H5Pclose(fapl);
+        H5Pclose(fcpl);
+    } H5E_END_TRY;
+    return 1;
+} /* end create_file() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    run_reader
+ *
+ * Purpose:     Follow the writer's NSAMPLES timestamps, acknowledging
+ *              each on ACK_FD, and report the latencies.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+run_reader(int ack_fd, unsigned nsamples)
+{
+    hid_t fid = -1, did = -1, sid = -1, mid = -1;
+    double *lat = NULL;
+    double start, sum = 0.0;
+    hsize_t nseen = 0;
+    unsigned u;
+
+    if(NULL == (lat = (double *)HDmalloc(nsamples * sizeof(double))))
+        goto error;
+
+    /* The writer has the file open, but may not have its first tick out */
+    start = H5_get_time();
+    do {
+        H5E_BEGIN_TRY {
+            fid = open_swmr(FALSE);
+        } H5E_END_TRY;
+        if(fid < 0)
+            poll_sleep();
+    } while(fid < 0 && H5_get_time() - start < SWMR_TICK_PERF_TIMEOUT);
+    if(fid < 0)
+        goto error;
+    if((did = H5Dopen2(fid, SWMR_TICK_PERF_DSET, H5P_DEFAULT)) < 0)
+        goto error;
+    if(HDwrite(ack_fd, "r", 1) != 1)
+        goto error;
+
+    while(nseen < nsamples) {
+        hsize_t dims[1], start1[1], count[1] = {1};
+        double stamp;
+
+        if(H5Drefresh(did) < 0)
+            goto error;
+        if((sid = H5Dget_space(did)) < 0)
+            goto error;
+        if(H5Sget_simple_extent_dims(sid, dims, NULL) < 0)
+            goto error;
+
+        if(dims[0] <= nseen) {
+            if(H5Sclose(sid) < 0)
+                goto error;
+            sid = -1;
+            poll_sleep();
+            continue;
+        } /* end if */
+
+        /* The writer waits for each acknowledgement, so there's one new */
+        start1[0] = nseen;
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start1, NULL, count, NULL) < 0)
+            goto error;
+        if((mid = H5Screate_simple(1, count, NULL)) < 0)
+            goto error;
+        if(H5Dread(did, H5T_NATIVE_DOUBLE, mid, sid, H5P_DEFAULT, &stamp) < 0)
+            goto error;
+        lat[nseen] = H5_get_time() - stamp;
+        if(H5Sclose(mid) < 0 || H5Sclose(sid) < 0)
+            goto error;
+        mid = sid = -1;
+
+        nseen++;
+        if(HDwrite(ack_fd, "a", 1) != 1)
+            goto error;
+    } /* end while */
+
+    if(H5Dclose(did) < 0)
+        goto error;
+    if(H5Fclose(fid) < 0)
+        goto error;
+
+    for(u = 0; u < nsamples; u++)
+        sum += lat[u];
+    HDqsort(lat, nsamples, sizeof(double), cmp_double);
+
+    if(bench_json_g) {
+        bench_json_record("tick_1", "latency_mean_ms", 1e3 * sum / nsamples, "ms", nsamples);
+        bench_json_record("tick_1", "latency_p50_ms", 1e3 * lat[nsamples / 2], "ms", nsamples);
+        bench_json_record("tick_1", "latency_p99_ms", 1e3 * lat[(nsamples * 99) / 100], "ms", nsamples);
+        bench_json_record("tick_1", "latency_max_ms", 1e3 * lat[nsamples - 1], "ms", nsamples);
+    } /* end if */
+    else {
+        HDfprintf(stdout, "%8s %10s %10s %10s %10s %10s\n", "tick (s)", "samples", "mean (ms)", "p50 (ms)", "p99 (ms)", "max (ms)");
+        HDfprintf(stdout, "%8.1f %10u %10.1f %10.1f %10.1f %10.1f\n", SWMR_TICK_PERF_TICK_LEN / 10.0,
+                nsamples, 1e3 * sum / nsamples, 1e3 * lat[nsamples / 2], 1e3 * lat[(nsamples * 99) / 100],
+                1e3 * lat[nsamples - 1]);
+    } /* end else */
+
+    HDfree(lat);
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mid);
+        H5Sclose(sid);
+        H5Dclose(did);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(lat)
+        HDfree(lat);
+    HDfprintf(stderr, "reader failed after %llu samples\n", (unsigned long long)nseen);
+    return 1;
+} /* end run_reader() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    wait_ack
+ *
+ * Purpose:     Wait for the reader to write a byte on ACK_FD, making API
+ *              calls on FID so the writer's ticks go on.
+ *
+ * Return:      0 on success, 1 on failure or timeout
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+wait_ack(hid_t fid, int ack_fd)
+{
+    double start = H5_get_time();
+    unsigned intent;
+    char c;
+
+    while(H5_get_time() - start < SWMR_TICK_PERF_TIMEOUT) {
+        ssize_t n = HDread(ack_fd, &c, 1);
+
+        if(n == 1)
+            return 0;
+        if(n == 0 || (n < 0 && errno != EAGAIN))
+            return 1;
+        if(H5Fget_intent(fid, &intent) < 0)
+            return 1;
+        poll_sleep();
+    } /* end while */
+
+    return 1;
+} /* end wait_ack() */
+
+
+int
+main(int argc, char *argv[])
+{
+    unsigned nsamples = SWMR_TICK_PERF_DEF_SAMPLES;
+    hid_t fid = -1, did = -1, sid = -1, mid = -1;
+    int fds[2] = {-1, -1};
+    pid_t pid = -1;
+    int status;
+    unsigned u;
+
+    bench_json_init("swmr_tick_perf", &argc, argv);
+
+    /* Reader: swmr_tick_perf -r ACK_FD NSAMPLES */
+    if(argc > 3 && !HDstrcmp(argv[1], "-r"))
+        return run_reader(HDatoi(argv[2]), (unsigned)HDatoi(argv[3])) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        nsamples = (unsigned)HDatoi(argv[1]);
+
+    if(create_file())
+        goto error;
+    if((fid = open_swmr(TRUE)) < 0)
+        goto error;
+    if((did = H5Dopen2(fid, SWMR_TICK_PERF_DSET, H5P_DEFAULT)) < 0)
+        goto error;
+
+    if(HDpipe(fds) < 0)
+        goto error;
+    HDfflush(stdout);
+    if((pid = HDfork()) < 0)
+        goto error;
+    if(pid == 0) {
+        char fd_str[16], n_str[16];
+        char *rargv[6];
+        int i = 0;
+
+        HDclose(fds[0]);
+        HDsnprintf(fd_str, sizeof(fd_str), "%d", fds[1]);
+        HDsnprintf(n_str, sizeof(n_str), "%u", nsamples);
+        rargv[i++] = argv[0];
+        rargv[i++] = (char *)"-r";
+        rargv[i++] = fd_str;
+        rargv[i++] = n_str;
+        if(bench_json_g)
+            rargv[i++] = (char *)"--json";
+        rargv[i] = NULL;
+        HDexecv(argv[0], rargv);
+        HD_exit(EXIT_FAILURE);
+    } /* end if */
+    HDclose(fds[1]);
+    fds[1] = -1;
+    if(HDfcntl(fds[0], F_SETFL, O_NONBLOCK) < 0)
+        goto error;
+
+    /* Reader is ready */
+    if(wait_ack(fid, fds[0]))
+        goto error;
+
+    for(u = 0; u < nsamples; u++) {
+        hsize_t dims[1], start[1], count[1] = {1};
+        double stamp, pause;
+
+        /* Start the next sample at a varying point of the tick */
+        pause = H5_get_time() + (SWMR_TICK_PERF_TICK_LEN / 10.0) * ((u * 7) % 10) / 10.0;
+        while(H5_get_time() < pause)
+            poll_sleep();
+
+        dims[0] = u + 1;
+        if(H5Dset_extent(did, dims) < 0)
+            goto error;
+        if((sid = H5Dget_space(did)) < 0)
+            goto error;
+        start[0] = u;
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+            goto error;
+        if((mid = H5Screate_simple(1, count, NULL)) < 0)
+            goto error;
+        stamp = H5_get_time();
+        if(H5Dwrite(did, H5T_NATIVE_DOUBLE, mid, sid, H5P_DEFAULT, &stamp) < 0)
+            goto error;
+        if(H5Sclose(mid) < 0 || H5Sclose(sid) < 0)
+            goto error;
+        mid = sid = -1;
+
+        if(wait_ack(fid, fds[0]))
+            goto error;
+    } /* end for */
+
+    if(HDwaitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        goto error;
+    pid = -1;
+    HDclose(fds[0]);
+
+    if(H5Dclose(did) < 0)
+        goto error;
+    if(H5Fclose(fid) < 0)
+        goto error;
+    HDremove(SWMR_TICK_PERF_FILE);
+    HDremove(SWMR_TICK_PERF_MD_FILE);
+
+    return EXIT_SUCCESS;
+
+error:
+    if(pid > 0) {
+        HDkill(pid, SIGTERM);
+        HDwaitpid(pid, &status, 0);
+    } /* end if */
+    if(fds[0] >= 0)
+        HDclose(fds[0]);
+    if(fds[1] >= 0)
+        HDclose(fds[1]);
+    H5E_BEGIN_TRY {
+        H5Sclose(mid);
+        H5Sclose(sid);
+        H5Dclose(did);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    HDremove(SWMR_TICK_PERF_FILE);
+    HDremove(SWMR_TICK_PERF_MD_FILE);
+    HDfprintf(stderr, "SWMR tick latency: failed\n");
+    return EXIT_FAILURE;
+} /* end main() */
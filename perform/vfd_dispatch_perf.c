@@ -0,0 +1,130 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure the overhead of dispatching small reads and writes
+ *              through H5FD_read() / H5FD_write() to a file driver, using
+ *              the core driver so that the driver's own work is a memcpy.
+ *
+ * Usage:       vfd_dispatch_perf [--json] [iterations]
+ */
+
+#include "hdf5.h"
+#include "H5private.h"
+#include "bench_json.h"
+
+#define VFD_DISPATCH_PERF_DEF_ITERS     1000000
+#define VFD_DISPATCH_PERF_FILE          "vfd_dispatch_perf.h5"
+#define VFD_DISPATCH_PERF_EOA           (4 * 1024 * 1024)
+
+/* Request sizes measured */
+static const size_t vfd_dispatch_perf_sizes_g[] = {8, 512, 4096};
+
+
+/*-------------------------------------------------------------------------
+ * Function:    run_case
+ *
+ * Purpose:     Write and read back ITERS requests of SIZE bytes, walking
+ *              through the file, and report the rates.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+run_case(H5FD_t *file, size_t size, unsigned iters)
+{
+    const haddr_t nslots = VFD_DISPATCH_PERF_EOA / size;
+    unsigned char buf[4096];
+    char name[32];
+    double wstart, wtime, rstart, rtime;
+    unsigned u;
+
+    HDmemset(buf, 0xa5, sizeof(buf));
+    HDsnprintf(name, sizeof(name), "core_%u", (unsigned)size);
+
+    wstart = H5_get_time();
+    for(u = 0; u < iters; u++)
+        if(H5FDwrite(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)(u % nslots) * size, size, buf) < 0)
+            goto error;
+    wtime = H5_get_time() - wstart;
+
+    rstart = H5_get_time();
+    for(u = 0; u < iters; u++)
+        if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)(u % nslots) * size, size, buf) < 0)
+            goto error;
+    rtime = H5_get_time() - rstart;
+
+    if(bench_json_g) {
+        bench_json_record(name, "wr_ns_per_op", wtime * 1e9 / iters, "ns", iters);
+        bench_json_record(name, "rd_ns_per_op", rtime * 1e9 / iters, "ns", iters);
+        bench_json_record(name, "wr_ops_per_s", wtime > 0.0 ? iters / wtime : 0.0, "ops/s", iters);
+        bench_json_record(name, "rd_ops_per_s", rtime > 0.0 ? iters / rtime : 0.0, "ops/s", iters);
+    } /* end if */
+    else
+        HDfprintf(stdout, "%6u %12.1f %12.1f %12.0f %12.0f\n", (unsigned)size,
+                wtime * 1e9 / iters, rtime * 1e9 / iters,
+                wtime > 0.0 ? iters / wtime : 0.0, rtime > 0.0 ? iters / rtime : 0.0);
+
+    return 0;
+
+error:
+    HDfprintf(stderr, "%u byte requests: I/O failed\n", (unsigned)size);
+    return 1;
+} /* end run_case() */
+
+
+int
+main(int argc, char *argv[])
+{
+    unsigned iters = VFD_DISPATCH_PERF_DEF_ITERS;
+    hid_t fapl = -1;
+    H5FD_t *file = NULL;
+    unsigned u;
+    int ret_value = EXIT_SUCCESS;
+
+    bench_json_init("vfd_dispatch_perf", &argc, argv);
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        iters = (unsigned)HDatoi(argv[1]);
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto error;
+    if(H5Pset_fapl_core(fapl, (size_t)VFD_DISPATCH_PERF_EOA, FALSE) < 0)
+        goto error;
+    if(NULL == (file = H5FDopen(VFD_DISPATCH_PERF_FILE, H5F_ACC_RDWR | H5F_ACC_CREAT | H5F_ACC_TRUNC, fapl, HADDR_UNDEF)))
+        goto error;
+    if(H5FDset_eoa(file, H5FD_MEM_DRAW, (haddr_t)VFD_DISPATCH_PERF_EOA) < 0)
+        goto error;
+
+    if(!bench_json_g)
+        HDfprintf(stdout, "%6s %12s %12s %12s %12s\n", "size", "wr ns/op", "rd ns/op", "wr ops/s", "rd ops/s");
+    for(u = 0; u < NELMTS(vfd_dispatch_perf_sizes_g); u++)
+        if(run_case(file, vfd_dispatch_perf_sizes_g[u], iters))
+            ret_value = EXIT_FAILURE;
+
+    if(H5FDclose(file) < 0)
+        goto error;
+    if(H5Pclose(fapl) < 0)
+        goto error;
+
+    return ret_value;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+    HDfprintf(stderr, "can't set up the core file\n");
+    return EXIT_FAILURE;
+} /* end main() */
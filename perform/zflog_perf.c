@@ -0,0 +1,109 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Measure the rate of zf_log messages like the SWMR log's:
+ *              turned off by the output level, formatted and discarded,
+ *              and formatted and written to a file as test/vfd_swmr.c
+ *              does.
+ *
+ * Usage:       zflog_perf [--json] [# of messages]
+ */
+
+#include "hdf5.h"
+#include "H5private.h"
+#include "zf_log.h"
+#include "bench_json.h"
+
+#define ZFLOG_PERF_DEF_NMSGS    1000000
+#define ZFLOG_PERF_FILE         "zflog_perf.log"
+
+/* Log file of the "file" case */
+static FILE *zflog_perf_file_g = NULL;
+
+
+static void
+discard_callback(const zf_log_message *msg, void *arg)
+{
+    (void)msg;
+    (void)arg;
+} /* end discard_callback() */
+
+
+static void
+file_callback(const zf_log_message *msg, void *arg)
+{
+    (void)arg;
+    *msg->p = '\n';
+    fwrite(msg->buf, (size_t)(msg->p - msg->buf) + 1, 1, zflog_perf_file_g);
+} /* end file_callback() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    run_case
+ *
+ * Purpose:     Log NMSGS messages through CALLBACK, at an output level
+ *              of LVL, and report the rate.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+run_case(const char *case_name, zf_log_output_cb callback, int lvl, unsigned nmsgs)
+{
+    double start, time;
+    unsigned u;
+
+    zf_log_set_output_v(ZF_LOG_PUT_STD, NULL, callback);
+    zf_log_set_output_level(lvl);
+
+    start = H5_get_time();
+    for(u = 0; u < nmsgs; u++)
+        ZF_LOGI("%i %s tick %u", 3, "end of tick", u);
+    time = H5_get_time() - start;
+
+    if(bench_json_g)
+        bench_json_record(case_name, "msgs_per_s", time > 0.0 ? nmsgs / time : 0.0, "msgs/s", nmsgs);
+    else
+        HDfprintf(stdout, "%-10s %10u %14.0f %10.1f\n", case_name, nmsgs,
+                time > 0.0 ? nmsgs / time : 0.0, time * 1e9 / nmsgs);
+} /* end run_case() */
+
+
+int
+main(int argc, char *argv[])
+{
+    unsigned nmsgs = ZFLOG_PERF_DEF_NMSGS;
+
+    bench_json_init("zflog_perf", &argc, argv);
+    if(argc > 1 && HDatoi(argv[1]) > 0)
+        nmsgs = (unsigned)HDatoi(argv[1]);
+
+    if(NULL == (zflog_perf_file_g = HDfopen(ZFLOG_PERF_FILE, "w"))) {
+        HDfprintf(stderr, "can't open %s\n", ZFLOG_PERF_FILE);
+        return EXIT_FAILURE;
+    } /* end if */
+
+    if(!bench_json_g)
+        HDfprintf(stdout, "%-10s %10s %14s %10s\n", "output", "messages", "msgs/s", "ns/msg");
+    run_case("off", discard_callback, ZF_LOG_WARN, nmsgs);
+    run_case("discard", discard_callback, ZF_LOG_INFO, nmsgs);
+    run_case("file", file_callback, ZF_LOG_INFO, nmsgs);
+
+    zf_log_set_output_v(ZF_LOG_OUT_STDERR);
+    HDfclose(zflog_perf_file_g);
+    HDremove(ZFLOG_PERF_FILE);
+
+    return EXIT_SUCCESS;
+} /* end main() */
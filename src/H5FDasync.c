@@ -0,0 +1,1598 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5FDasync.c
+ *
+ * Purpose:		Asynchronous submission/completion of raw I/O requests
+ *                      behind the VFD dispatch layer.
+ *
+ *                      An engine is attached to a file as it is opened
+ *                      with H5FD_async_file_open(), when the FAPL sets a
+ *                      queue depth, and is found again with
+ *                      H5FD_async_get_engine().  Requests are submitted
+ *                      with H5FD_read_async() and H5FD_write_async() and
+ *                      completed with H5FD_async_test() / H5FD_async_wait().
+ *
+ *                      The engine does the I/O on the file descriptor of
+ *                      the sec2 driver, behind the driver's back, with
+ *                      io_uring when the library was built with liburing
+ *                      and with a pool of worker threads otherwise.  The
+ *                      descriptor is all the state sec2 keeps, apart from
+ *                      its EOF, so writes that would move the EOF are
+ *                      passed to the driver instead.  Every other driver
+ *                      (including the core driver, whose POSIX handle is
+ *                      only its backing store), and engines with a queue
+ *                      depth of 0, complete each request synchronously at
+ *                      submission time through H5FD_read() / H5FD_write().
+ *
+ *                      Engines opened with a prefetch window (see
+ *                      H5P_set_vfd_prefetch_window()) also accept read
+ *                      hints through H5FD_async_prefetch(): the range is
+ *                      read into one of the window's slots in the
+ *                      background, and a later H5FD_read() that falls
+ *                      inside it is served from the slot.  Writes drop any
+ *                      slot they overlap, and a VFD SWMR reader's end of
+ *                      tick empties every window.
+ *
+ *                      The window is split into a metadata tier and a raw
+ *                      data tier, in the manner of ARC.  Each tier evicts
+ *                      its least recently used slot, and remembers the
+ *                      addresses it evicted.  A miss on one of those
+ *                      addresses moves a slot of the split to that tier,
+ *                      within the minimum percentages set with
+ *                      H5Pset_page_buffer_size().
+ *
+ *                      With page buffer read-ahead enabled (see
+ *                      H5P_set_page_buffer_prefetch()), H5FD_read() also
+ *                      reports each read to H5FD_async_prefetch_sequential(),
+ *                      which issues the prefetches itself once it sees a
+ *                      run of back-to-back reads of the same size.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+#include "H5FDmodule.h"         /* This source code file is part of the H5FD module */
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5Fprivate.h"         /* File access				*/
+#include "H5FDpkg.h"		/* File Drivers				*/
+#include "H5FDsec2.h"           /* Sec2 file driver                     */
+#include "H5FLprivate.h"	/* Free Lists                           */
+#include "H5Iprivate.h"		/* IDs			  		*/
+#include "H5MMprivate.h"	/* Memory management			*/
+#include "H5Pprivate.h"		/* Property lists			*/
+
+#ifdef H5_HAVE_LIBURING
+#include <liburing.h>
+#endif /* H5_HAVE_LIBURING */
+#ifdef H5_HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* H5_HAVE_PTHREAD_H */
+
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Upper limit on the number of worker threads in the thread pool backend */
+#define H5FD_ASYNC_MAX_WORKERS  8
+
+/* # of back-to-back reads after the first before reading ahead */
+#define H5FD_ASYNC_SEQ_THRESHOLD 2
+
+/* Prefetch window tiers, and the tier of a memory type */
+#define H5FD_ASYNC_TIER_META    0
+#define H5FD_ASYNC_TIER_RAW     1
+#define H5FD_ASYNC_NTIERS       2
+#define H5FD_ASYNC_TIER(T)      ((T) == H5FD_MEM_DRAW ? H5FD_ASYNC_TIER_RAW : H5FD_ASYNC_TIER_META)
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+/* Backends for servicing asynchronous requests */
+typedef enum {
+    H5FD_ASYNC_BACKEND_SYNC = 0,        /* Complete requests at submission       */
+    H5FD_ASYNC_BACKEND_URING,           /* Linux io_uring                        */
+    H5FD_ASYNC_BACKEND_POOL             /* Worker threads doing pread/pwrite     */
+} H5FD_async_backend_t;
+
+/* An outstanding asynchronous I/O request */
+struct H5FD_async_req_t {
+    H5FD_async_t *aio;          /* Engine the request was submitted to */
+    H5FD_file_op_t op;          /* OP_READ or OP_WRITE */
+    HDoff_t     offset;         /* Absolute file offset of the next byte to transfer */
+    size_t      size;           /* Number of bytes left to transfer */
+    uint8_t    *buf;            /* Buffer for the next byte to transfer */
+    int         err;            /* errno value for a failed request, 0 otherwise */
+    hbool_t     complete;       /* Whether the request has completed */
+    haddr_t     addr;           /* Relative address of the whole request */
+    size_t      len;            /* Size of the whole request */
+    struct H5FD_async_req_t *next;      /* Next request in thread pool queue */
+    struct H5FD_async_req_t *wnext;     /* Next write not yet waited for */
+};
+
+/* A metadata read prefetched into the engine's window */
+typedef struct H5FD_async_prefetch_t {
+    haddr_t     addr;           /* Relative address of the range, HADDR_UNDEF for an empty slot */
+    size_t      size;           /* Size of the range */
+    H5FD_mem_t  type;           /* Memory type the range was read as */
+    uint8_t    *buf;            /* Buffer holding the range */
+    H5FD_async_req_t *req;      /* Read still to be collected, or NULL */
+    uint64_t    used;           /* Engine clock when last filled or hit */
+} H5FD_async_prefetch_t;
+
+/* Asynchronous I/O engine for an open file */
+struct H5FD_async_t {
+    H5FD_t     *file;           /* File the engine is attached to */
+    int         fd;             /* POSIX handle for the file, or -1 */
+    unsigned    queue_depth;    /* Max. # of requests in flight */
+    unsigned    inflight;       /* # of submitted requests not yet completed */
+    unsigned    nreqs;          /* # of submitted requests not yet waited for */
+    H5FD_async_req_t *writes;   /* Writes queued and not yet waited for */
+    H5FD_async_backend_t backend;       /* Backend servicing requests */
+    H5FD_async_prefetch_t *prefetch;    /* Prefetch window slots, or NULL */
+    unsigned    prefetch_window;        /* # of prefetch window slots */
+    uint64_t    clock;                  /* Ticks at each fill or hit of a slot */
+    unsigned    meta_target;            /* # of slots the metadata tier may fill before taking from itself */
+    unsigned    tier_min[H5FD_ASYNC_NTIERS];    /* Least target for each tier */
+    haddr_t    *ghosts;                 /* Addresses each tier evicted last, prefetch_window per tier */
+    unsigned    ghost_next[H5FD_ASYNC_NTIERS];  /* Next ghost of each tier to replace */
+    struct H5FD_async_t *link;  /* Next engine attached to a file */
+    unsigned    seq_pages;      /* # of ranges to read ahead of sequential reads, 0 to disable */
+    unsigned    seq_run;        /* # of back-to-back reads seen */
+    haddr_t     seq_next;       /* Address following the last read */
+    size_t      seq_size;       /* Size of the last read */
+    H5FD_mem_t  seq_type;       /* Memory type of the last read */
+    H5FD_async_stats_t stats;   /* Prefetch window statistics */
+#ifdef H5_HAVE_LIBURING
+    struct io_uring ring;       /* Submission/completion rings */
+#endif /* H5_HAVE_LIBURING */
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_t mutex;      /* Protects the fields below & request completion */
+    pthread_cond_t queue_cv;    /* Signalled when a request is queued or on shutdown */
+    pthread_cond_t done_cv;     /* Signalled when a request completes */
+    H5FD_async_req_t *head;     /* Queue of requests waiting for a worker */
+    H5FD_async_req_t *tail;
+    pthread_t   workers[H5FD_ASYNC_MAX_WORKERS];  /* Worker threads */
+    unsigned    nworkers;       /* # of worker threads started */
+    hbool_t     shutdown;       /* Whether the workers should exit */
+#endif /* H5_HAVE_PTHREAD_H */
+};
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static herr_t H5FD__async_submit(H5FD_async_t *aio, H5FD_file_op_t op,
+    H5FD_mem_t type, haddr_t addr, size_t size, void *buf,
+    H5FD_async_req_t **req);
+static void H5FD__async_transfer(H5FD_async_req_t *req);
+static hbool_t H5FD__async_busy(H5FD_async_t *aio);
+static H5FD_async_t *H5FD__async_prefetch_engine(const H5FD_t *file);
+static void H5FD__async_prefetch_drop(H5FD_async_prefetch_t *slot);
+static H5FD_async_prefetch_t *H5FD__async_prefetch_victim(H5FD_async_t *aio,
+    unsigned tier);
+static void H5FD__async_prefetch_ghost_hit(H5FD_async_t *aio, unsigned tier,
+    haddr_t addr);
+#ifdef H5_HAVE_LIBURING
+static herr_t H5FD__async_uring_prep(H5FD_async_req_t *req);
+static herr_t H5FD__async_uring_reap(H5FD_async_t *aio, hbool_t block);
+#endif /* H5_HAVE_LIBURING */
+#ifdef H5_HAVE_PTHREAD_H
+static void *H5FD__async_worker(void *_aio);
+#endif /* H5_HAVE_PTHREAD_H */
+
+
+/*********************/
+/* Package Variables */
+/*********************/
+
+
+/*****************************/
+/* Library Private Variables */
+/*****************************/
+
+/* # of engines with a prefetch window, checked by H5FD_read() & H5FD_write() */
+unsigned H5FD_async_nprefetch_g = 0;
+
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Declare a free list to manage the H5FD_async_t struct */
+H5FL_DEFINE_STATIC(H5FD_async_t);
+
+/* Declare a free list to manage the H5FD_async_req_t struct */
+H5FL_DEFINE_STATIC(H5FD_async_req_t);
+
+/* Engines attached to files */
+static H5FD_async_t *H5FD_async_head_s = NULL;
+
+/* Engine found by the last lookup, checked before walking the list */
+static H5FD_async_t *H5FD_async_last_s = NULL;
+
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_open
+ *
+ * Purpose:     Attach an asynchronous I/O engine to an open file, using
+ *              the queue depth set in FAPL_ID with
+ *              H5P_set_vfd_async_queue_depth().  A file has at most one
+ *              engine.
+ *
+ * Return:      Success:        Pointer to the new engine
+ *              Failure:        NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+H5FD_async_t *
+H5FD_async_open(H5FD_t *file, hid_t fapl_id)
+{
+    H5FD_async_t *aio = NULL;           /* New engine */
+    H5P_genplist_t *plist;              /* File access property list */
+    H5FD_async_t *ret_value = NULL;     /* Return value */
+
+    FUNC_ENTER_NOAPI(NULL)
+
+    /* Sanity checks */
+    HDassert(file && file->cls);
+
+    if(NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, NULL, "not a file access property list")
+    if(H5FD_async_get_engine(file))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, NULL, "file already has an async I/O engine")
+
+    if(NULL == (aio = H5FL_CALLOC(H5FD_async_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for async I/O engine")
+    aio->file = file;
+    aio->fd = -1;
+    aio->backend = H5FD_ASYNC_BACKEND_SYNC;
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_init(&aio->mutex, NULL);
+    pthread_cond_init(&aio->queue_cv, NULL);
+    pthread_cond_init(&aio->done_cv, NULL);
+#endif /* H5_HAVE_PTHREAD_H */
+
+    if(H5P_get(plist, H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_NAME, &aio->queue_depth) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get async I/O queue depth")
+    if(H5P_get(plist, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, &aio->seq_pages) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get page buffer read-ahead")
+
+    /* Read-ahead alone needs room for its pages in flight */
+    if(0 == aio->queue_depth)
+        aio->queue_depth = aio->seq_pages;
+
+    /* Attach the engine before anything can fail, so closing it on error
+     * finds it on the list
+     */
+    aio->link = H5FD_async_head_s;
+    H5FD_async_head_s = aio;
+    H5FD_async_last_s = aio;
+
+    /* Look up the file descriptor of sec2 files.  Other drivers may keep
+     * state or data of their own behind their POSIX handle, and must see
+     * every request.
+     */
+    if(aio->queue_depth > 0 && file->driver_id == H5FD_SEC2) {
+        int *fdp = NULL;
+
+        if(H5FD_get_vfd_handle(file, fapl_id, (void **)&fdp) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTGET, NULL, "can't get POSIX handle for async I/O")
+        aio->fd = *fdp;
+    } /* end if */
+
+#ifdef H5_HAVE_LIBURING
+    if(aio->fd >= 0 && aio->backend == H5FD_ASYNC_BACKEND_SYNC)
+        /* Fall through to the thread pool if the kernel has no io_uring */
+        if(0 == io_uring_queue_init(aio->queue_depth, &aio->ring, 0))
+            aio->backend = H5FD_ASYNC_BACKEND_URING;
+#endif /* H5_HAVE_LIBURING */
+
+#ifdef H5_HAVE_PTHREAD_H
+    if(aio->fd >= 0 && aio->backend == H5FD_ASYNC_BACKEND_SYNC) {
+        unsigned nworkers = MIN(aio->queue_depth, H5FD_ASYNC_MAX_WORKERS);
+
+        for(aio->nworkers = 0; aio->nworkers < nworkers; aio->nworkers++)
+            if(pthread_create(&aio->workers[aio->nworkers], NULL, H5FD__async_worker, aio))
+                HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, NULL, "can't start async I/O worker thread")
+        aio->backend = H5FD_ASYNC_BACKEND_POOL;
+    } /* end if */
+#endif /* H5_HAVE_PTHREAD_H */
+
+    /* Set up the prefetch window.  Prefetching is pointless when requests
+     * complete at submission, so engines on the synchronous backend don't
+     * get one.
+     */
+    if(H5P_get(plist, H5F_ACS_VFD_PREFETCH_WINDOW_NAME, &aio->prefetch_window) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get metadata prefetch window")
+    if(aio->backend == H5FD_ASYNC_BACKEND_SYNC) {
+        aio->prefetch_window = 0;
+        aio->seq_pages = 0;
+    } /* end if */
+
+    /* Read-ahead keeps its pages in the window, so make room for them */
+    aio->prefetch_window = MAX(aio->prefetch_window, aio->seq_pages);
+    aio->seq_next = HADDR_UNDEF;
+    if(aio->prefetch_window > 0) {
+        unsigned min_perc[H5FD_ASYNC_NTIERS];   /* Page buffer minimum percentages */
+        unsigned u;
+
+        if(NULL == (aio->prefetch = (H5FD_async_prefetch_t *)H5MM_calloc(aio->prefetch_window * sizeof(H5FD_async_prefetch_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for prefetch window")
+        for(u = 0; u < aio->prefetch_window; u++)
+            aio->prefetch[u].addr = HADDR_UNDEF;
+        H5FD_async_nprefetch_g++;
+
+        /* Split the window evenly at first, keeping each tier at its
+         * page buffer minimum (the two add up to at most 100%)
+         */
+        if(H5P_get(plist, H5F_ACS_PAGE_BUFFER_MIN_META_PERC_NAME, &min_perc[H5FD_ASYNC_TIER_META]) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get minimum metadata fraction")
+        if(H5P_get(plist, H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_NAME, &min_perc[H5FD_ASYNC_TIER_RAW]) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get minimum raw data fraction")
+        for(u = 0; u < H5FD_ASYNC_NTIERS; u++)
+            aio->tier_min[u] = (aio->prefetch_window * min_perc[u]) / 100;
+        aio->meta_target = aio->prefetch_window / 2;
+        aio->meta_target = MAX(aio->meta_target, aio->tier_min[H5FD_ASYNC_TIER_META]);
+        aio->meta_target = MIN(aio->meta_target, aio->prefetch_window - aio->tier_min[H5FD_ASYNC_TIER_RAW]);
+        aio->stats.meta_slots = aio->meta_target;
+
+        if(NULL == (aio->ghosts = (haddr_t *)H5MM_malloc(H5FD_ASYNC_NTIERS * aio->prefetch_window * sizeof(haddr_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for prefetch window ghosts")
+        for(u = 0; u < H5FD_ASYNC_NTIERS * aio->prefetch_window; u++)
+            aio->ghosts[u] = HADDR_UNDEF;
+    } /* end if */
+
+    /* Set return value */
+    ret_value = aio;
+
+done:
+    if(NULL == ret_value && aio)
+        if(H5FD_async_close(aio) < 0)
+            HDONE_ERROR(H5E_VFL, H5E_CANTRELEASE, NULL, "can't release async I/O engine")
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_open() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_close
+ *
+ * Purpose:     Stop an asynchronous I/O engine and release it.  All
+ *              requests submitted to the engine must have been completed
+ *              with H5FD_async_wait() first; if some haven't, this fails
+ *              and leaves the engine as it was, apart from its prefetches
+ *              being collected.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_close(H5FD_async_t *aio)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(aio);
+
+    /* Collect outstanding prefetches first, as they are requests too.
+     * The engine stays usable if the caller still has requests of its own
+     * outstanding.
+     */
+    if(aio->prefetch) {
+        unsigned u;
+
+        for(u = 0; u < aio->prefetch_window; u++)
+            if(aio->prefetch[u].req)
+                H5FD__async_prefetch_drop(&aio->prefetch[u]);
+    } /* end if */
+    if(aio->nreqs > 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTCLOSEOBJ, FAIL, "async I/O engine still has %u requests outstanding", aio->nreqs)
+
+    /* Release the prefetch window */
+    if(aio->prefetch) {
+        unsigned u;
+
+        for(u = 0; u < aio->prefetch_window; u++)
+            H5FD__async_prefetch_drop(&aio->prefetch[u]);
+        aio->prefetch = (H5FD_async_prefetch_t *)H5MM_xfree(aio->prefetch);
+        H5FD_async_nprefetch_g--;
+    } /* end if */
+    aio->ghosts = (haddr_t *)H5MM_xfree(aio->ghosts);
+
+    /* Take the engine off the list */
+    if(H5FD_async_head_s) {
+        H5FD_async_t **linkp = &H5FD_async_head_s;
+
+        while(*linkp && *linkp != aio)
+            linkp = &(*linkp)->link;
+        if(*linkp)
+            *linkp = aio->link;
+    } /* end if */
+    if(H5FD_async_last_s == aio)
+        H5FD_async_last_s = NULL;
+
+#ifdef H5_HAVE_LIBURING
+    if(aio->backend == H5FD_ASYNC_BACKEND_URING)
+        io_uring_queue_exit(&aio->ring);
+#endif /* H5_HAVE_LIBURING */
+
+#ifdef H5_HAVE_PTHREAD_H
+    if(aio->nworkers > 0) {
+        unsigned u;
+
+        pthread_mutex_lock(&aio->mutex);
+        aio->shutdown = TRUE;
+        pthread_cond_broadcast(&aio->queue_cv);
+        pthread_mutex_unlock(&aio->mutex);
+
+        for(u = 0; u < aio->nworkers; u++)
+            pthread_join(aio->workers[u], NULL);
+    } /* end if */
+    pthread_cond_destroy(&aio->done_cv);
+    pthread_cond_destroy(&aio->queue_cv);
+    pthread_mutex_destroy(&aio->mutex);
+#endif /* H5_HAVE_PTHREAD_H */
+
+    aio = H5FL_FREE(H5FD_async_t, aio);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_file_open
+ *
+ * Purpose:     Attach an asynchronous I/O engine to a file that is being
+ *              opened, if FAPL_ID sets a queue depth or page buffer
+ *              read-ahead.  Called by
+ *              H5FD_open() once the driver has opened the file.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_file_open(H5FD_t *file, hid_t fapl_id)
+{
+    H5P_genplist_t *plist;              /* File access property list */
+    unsigned queue_depth;               /* Queue depth from the FAPL */
+    unsigned seq_pages;                 /* Read-ahead from the FAPL */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(file);
+
+    if(NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+    if(H5P_get(plist, H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_NAME, &queue_depth) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get async I/O queue depth")
+    if(H5P_get(plist, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, &seq_pages) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get page buffer read-ahead")
+
+    if(queue_depth > 0 || seq_pages > 0)
+        if(NULL == H5FD_async_open(file, fapl_id))
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't attach async I/O engine")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_file_open() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_file_close
+ *
+ * Purpose:     Release the asynchronous I/O engine attached to a file that
+ *              is being closed, if it has one.  Called by H5FD_close()
+ *              before the driver closes the file.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_file_close(H5FD_t *file)
+{
+    H5FD_async_t *aio;                  /* Engine for the file */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(file);
+
+    if(NULL != (aio = H5FD_async_get_engine(file)))
+        if(H5FD_async_close(aio) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTCLOSEOBJ, FAIL, "can't release async I/O engine")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_file_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_get_engine
+ *
+ * Purpose:     Find the asynchronous I/O engine attached to FILE.  Only a
+ *              handful of files have one, so a list is enough.  Every
+ *              read and write looks its file up, and they tend to come in
+ *              runs against one file, so the last engine found is
+ *              checked first.
+ *
+ * Return:      Pointer to the engine, or NULL if there is none
+ *
+ *-------------------------------------------------------------------------
+ */
+H5FD_async_t *
+H5FD_async_get_engine(const H5FD_t *file)
+{
+    H5FD_async_t *aio;                  /* Engine being checked */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(NULL == (aio = H5FD_async_last_s) || aio->file != file) {
+        for(aio = H5FD_async_head_s; aio; aio = aio->link)
+            if(aio->file == file)
+                break;
+        if(aio)
+            H5FD_async_last_s = aio;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(aio)
+} /* end H5FD_async_get_engine() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_read_async
+ *
+ * Purpose:     Submit an asynchronous read of SIZE bytes at ADDR into BUF.
+ *              BUF must not be touched until the request returned in REQ
+ *              has been completed with H5FD_async_wait().
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_read_async(H5FD_async_t *aio, H5FD_mem_t type, haddr_t addr,
+    size_t size, void *buf/*out*/, H5FD_async_req_t **req/*out*/)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    if(H5FD__async_submit(aio, OP_READ, type, addr, size, buf, req) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "can't submit async read request")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_read_async() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_write_async
+ *
+ * Purpose:     Submit an asynchronous write of SIZE bytes from BUF to
+ *              ADDR.  BUF must stay valid and unmodified until the request
+ *              returned in REQ has been completed with H5FD_async_wait().
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_write_async(H5FD_async_t *aio, H5FD_mem_t type, haddr_t addr,
+    size_t size, const void *buf, H5FD_async_req_t **req/*out*/)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Don't leave stale copies of the range in the prefetch window */
+    if(aio->prefetch)
+        if(H5FD_async_prefetch_invalidate(aio->file, addr, size) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTRELEASE, FAIL, "can't invalidate prefetched ranges")
+
+    /* Casting away const OK, the buffer is only read from */
+    if(H5FD__async_submit(aio, OP_WRITE, type, addr, size, (void *)buf, req) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "can't submit async write request")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_write_async() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_test
+ *
+ * Purpose:     Check whether an asynchronous request has completed,
+ *              without blocking.  The request must still be completed
+ *              with H5FD_async_wait() to release it and collect its status.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_test(H5FD_async_req_t *req, hbool_t *done/*out*/)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(req && req->aio);
+    HDassert(done);
+
+    switch(req->aio->backend) {
+        case H5FD_ASYNC_BACKEND_SYNC:
+            break;
+
+#ifdef H5_HAVE_LIBURING
+        case H5FD_ASYNC_BACKEND_URING:
+            if(!req->complete)
+                if(H5FD__async_uring_reap(req->aio, FALSE) < 0)
+                    HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "can't reap io_uring completions")
+            break;
+#endif /* H5_HAVE_LIBURING */
+
+#ifdef H5_HAVE_PTHREAD_H
+        case H5FD_ASYNC_BACKEND_POOL:
+            pthread_mutex_lock(&req->aio->mutex);
+            *done = req->complete;
+            pthread_mutex_unlock(&req->aio->mutex);
+            HGOTO_DONE(SUCCEED)
+#endif /* H5_HAVE_PTHREAD_H */
+
+        default:
+            HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "unknown async I/O backend")
+    } /* end switch */
+
+    *done = req->complete;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_test() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_wait
+ *
+ * Purpose:     Block until an asynchronous request has completed, then
+ *              release it.  The request must not be used afterwards.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL (including when the I/O itself failed)
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_wait(H5FD_async_req_t *req)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(req && req->aio);
+
+    switch(req->aio->backend) {
+        case H5FD_ASYNC_BACKEND_SYNC:
+            break;
+
+#ifdef H5_HAVE_LIBURING
+        case H5FD_ASYNC_BACKEND_URING:
+            while(!req->complete)
+                if(H5FD__async_uring_reap(req->aio, TRUE) < 0)
+                    HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "can't reap io_uring completions")
+            break;
+#endif /* H5_HAVE_LIBURING */
+
+#ifdef H5_HAVE_PTHREAD_H
+        case H5FD_ASYNC_BACKEND_POOL:
+            pthread_mutex_lock(&req->aio->mutex);
+            while(!req->complete)
+                pthread_cond_wait(&req->aio->done_cv, &req->aio->mutex);
+            pthread_mutex_unlock(&req->aio->mutex);
+            break;
+#endif /* H5_HAVE_PTHREAD_H */
+
+        default:
+            HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "unknown async I/O backend")
+    } /* end switch */
+
+    if(req->err)
+        HGOTO_ERROR(H5E_IO, (req->op == OP_READ ? H5E_READERROR : H5E_WRITEERROR), FAIL, "async %s failed, errno = %d, error message = '%s'", (req->op == OP_READ ? "read" : "write"), req->err, HDstrerror(req->err))
+
+done:
+    if(req->op == OP_WRITE) {
+        H5FD_async_req_t **linkp = &req->aio->writes;
+
+        while(*linkp && *linkp != req)
+            linkp = &(*linkp)->wnext;
+        if(*linkp)
+            *linkp = req->wnext;
+    } /* end if */
+    req->aio->nreqs--;
+    req = H5FL_FREE(H5FD_async_req_t, req);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_wait() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_prefetch
+ *
+ * Purpose:     Hint that SIZE bytes at ADDR will be read soon, e.g. the
+ *              header of an object that a traversal is about to visit.
+ *              The range is read into a slot of the engine's prefetch
+ *              window in the background, replacing the least recently
+ *              used slot of its tier (see H5FD__async_prefetch_victim()).
+ *
+ *              This is only a hint: it does nothing when the engine has
+ *              no prefetch window, when the range is already in the
+ *              window, when an async write to the range hasn't been
+ *              waited for yet, or when the engine has its queue depth of
+ *              requests in flight.  Ranges running past the EOA are
+ *              truncated.
+ *
+ *              Sequential read-ahead (H5FD_async_prefetch_sequential())
+ *              is the only caller in the library so far.  In particular,
+ *              H5Ovisit() doesn't prefetch the headers of the objects it
+ *              is about to visit, and still reads them one at a time.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_prefetch(H5FD_async_t *aio, H5FD_mem_t type, haddr_t addr,
+    size_t size)
+{
+    H5FD_async_prefetch_t *slot;        /* Slot for the prefetch */
+    H5FD_async_req_t *req;              /* Write not yet waited for */
+    H5FD_t *file;                       /* File for the prefetch */
+    unsigned u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(aio && aio->file);
+    file = aio->file;
+
+    if(0 == aio->prefetch_window || 0 == size)
+        HGOTO_DONE(SUCCEED)
+
+    /* Nothing to do if the range is already in the window */
+    for(u = 0; u < aio->prefetch_window; u++) {
+        slot = &aio->prefetch[u];
+        if(H5F_addr_defined(slot->addr) && slot->type == type && H5F_addr_le(slot->addr, addr)
+                && H5F_addr_le(addr + size, slot->addr + slot->size))
+            HGOTO_DONE(SUCCEED)
+    } /* end for */
+
+    /* A read racing with a write of the range could get either */
+    for(req = aio->writes; req; req = req->wnext)
+        if(H5F_addr_lt(req->addr, addr + size) && H5F_addr_lt(addr, req->addr + req->len))
+            HGOTO_DONE(SUCCEED)
+
+    /* Don't make the caller wait for a speculative read */
+    if(H5FD__async_busy(aio))
+        HGOTO_DONE(SUCCEED)
+
+    /* Clip the range to the EOA, as H5FD__async_submit() would reject it */
+    if(!(file->access_flags & H5F_ACC_SWMR_READ)) {
+        haddr_t eoa;
+
+        if(HADDR_UNDEF == (eoa = (file->cls->get_eoa)(file, type)))
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "driver get_eoa request failed")
+        if(H5F_addr_ge(addr + file->base_addr, eoa))
+            HGOTO_DONE(SUCCEED)
+        if((addr + file->base_addr + size) > eoa)
+            size = (size_t)(eoa - (addr + file->base_addr));
+    } /* end if */
+
+    /* Take over a slot */
+    slot = H5FD__async_prefetch_victim(aio, H5FD_ASYNC_TIER(type));
+    H5FD__async_prefetch_drop(slot);
+
+    if(NULL == (slot->buf = (uint8_t *)H5MM_malloc(size)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for prefetch buffer")
+    if(H5FD__async_submit(aio, OP_READ, type, addr, size, slot->buf, &slot->req) < 0) {
+        slot->buf = (uint8_t *)H5MM_xfree(slot->buf);
+        HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "can't submit prefetch request")
+    } /* end if */
+    slot->addr = addr;
+    slot->size = size;
+    slot->type = type;
+    slot->used = ++aio->clock;
+    aio->stats.prefetches++;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_prefetch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_prefetch_read
+ *
+ * Purpose:     Serve a read of SIZE bytes at ADDR from the prefetch window
+ *              of FILE's engine, waiting for the prefetch if it is still
+ *              in flight.  The slot stays in the window, since the
+ *              metadata cache commonly re-reads a header once it knows
+ *              its actual size.
+ *
+ *              A prefetch that failed is dropped and reported as a miss,
+ *              so the caller does the read itself and sees the error.
+ *
+ * Return:      Success:        TRUE if BUF was filled from the window,
+ *                              FALSE otherwise
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+htri_t
+H5FD_async_prefetch_read(const H5FD_t *file, H5FD_mem_t type, haddr_t addr,
+    size_t size, void *buf/*out*/)
+{
+    H5FD_async_t *aio;                  /* Engine for the file */
+    unsigned u;                         /* Local index variable */
+    htri_t ret_value = FALSE;           /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(file);
+    HDassert(buf);
+
+    if(NULL == (aio = H5FD__async_prefetch_engine(file)))
+        HGOTO_DONE(FALSE)
+
+    for(u = 0; u < aio->prefetch_window; u++) {
+        H5FD_async_prefetch_t *slot = &aio->prefetch[u];
+
+        if(!H5F_addr_defined(slot->addr) || slot->type != type || H5F_addr_gt(slot->addr, addr)
+                || H5F_addr_gt(addr + size, slot->addr + slot->size))
+            continue;
+
+        if(slot->req) {
+            herr_t status;
+
+            H5E_BEGIN_TRY {
+                status = H5FD_async_wait(slot->req);
+            } H5E_END_TRY;
+            slot->req = NULL;
+            if(status < 0) {
+                H5FD__async_prefetch_drop(slot);
+                break;
+            } /* end if */
+        } /* end if */
+
+        HDmemcpy(buf, slot->buf + (addr - slot->addr), size);
+        slot->used = ++aio->clock;
+        aio->stats.hits++;
+        HGOTO_DONE(TRUE)
+    } /* end for */
+
+    aio->stats.misses++;
+    H5FD__async_prefetch_ghost_hit(aio, H5FD_ASYNC_TIER(type), addr);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_prefetch_read() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_prefetch_invalidate
+ *
+ * Purpose:     Drop every slot in the prefetch window of FILE's engine
+ *              that overlaps SIZE bytes at ADDR, ahead of a write to that
+ *              range.  Prefetches still in flight are waited for, so they
+ *              can't race with the write.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_prefetch_invalidate(const H5FD_t *file, haddr_t addr, size_t size)
+{
+    H5FD_async_t *aio;                  /* Engine for the file */
+    unsigned u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(file);
+
+    if(NULL == (aio = H5FD__async_prefetch_engine(file)))
+        HGOTO_DONE(SUCCEED)
+
+    for(u = 0; u < aio->prefetch_window; u++) {
+        H5FD_async_prefetch_t *slot = &aio->prefetch[u];
+
+        if(H5F_addr_defined(slot->addr) && H5F_addr_lt(slot->addr, addr + size)
+                && H5F_addr_lt(addr, slot->addr + slot->size))
+            H5FD__async_prefetch_drop(slot);
+    } /* end for */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_prefetch_invalidate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_prefetch_end_of_tick
+ *
+ * Purpose:     Empty the prefetch windows of all engines at a VFD SWMR
+ *              reader's end of tick.  The writer may have changed any
+ *              range in the window since it was read, so no slot lives
+ *              past the tick it was filled in.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+void
+H5FD_async_prefetch_end_of_tick(void)
+{
+    H5FD_async_t *aio;                  /* Engine being emptied */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    for(aio = H5FD_async_head_s; aio; aio = aio->link)
+        if(aio->prefetch) {
+            unsigned u;
+
+            for(u = 0; u < aio->prefetch_window; u++)
+                H5FD__async_prefetch_drop(&aio->prefetch[u]);
+        } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD_async_prefetch_end_of_tick() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_prefetch_sequential
+ *
+ * Purpose:     Report a read of SIZE bytes at ADDR to FILE's engine for
+ *              read-ahead.  Once H5FD_ASYNC_SEQ_THRESHOLD reads in a row
+ *              have each started where the one before ended, with the
+ *              same size and memory type, the next "page_buffer_prefetch"
+ *              ranges of that size are prefetched into the window.  Ranges
+ *              already there are skipped, so a steady stream of page reads
+ *              keeps one new prefetch in flight per read.
+ *
+ *              Call this before doing the read, so the prefetches overlap
+ *              with it.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_prefetch_sequential(const H5FD_t *file, H5FD_mem_t type,
+    haddr_t addr, size_t size)
+{
+    H5FD_async_t *aio;                  /* Engine for the file */
+    unsigned u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(file);
+
+    if(NULL == (aio = H5FD__async_prefetch_engine(file)) || 0 == aio->seq_pages || 0 == size)
+        HGOTO_DONE(SUCCEED)
+
+    if(H5F_addr_eq(addr, aio->seq_next) && size == aio->seq_size && type == aio->seq_type)
+        aio->seq_run++;
+    else
+        aio->seq_run = 0;
+    aio->seq_next = addr + size;
+    aio->seq_size = size;
+    aio->seq_type = type;
+
+    if(aio->seq_run >= H5FD_ASYNC_SEQ_THRESHOLD)
+        for(u = 1; u <= aio->seq_pages; u++)
+            if(H5FD_async_prefetch(aio, type, addr + (haddr_t)u * size, size) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "can't read ahead")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_async_prefetch_sequential() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_async_get_stats
+ *
+ * Purpose:     Retrieve the prefetch window statistics of FILE's engine:
+ *              reads served from the window and sent to the driver,
+ *              slots replaced, prefetches submitted, misses on ranges a
+ *              tier evicted and the metadata tier's current share of the
+ *              window.  Files without a window report zeros.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_async_get_stats(const H5FD_t *file, H5FD_async_stats_t *stats/*out*/)
+{
+    H5FD_async_t *aio;                  /* Engine for the file */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(file);
+    HDassert(stats);
+
+    if(NULL != (aio = H5FD__async_prefetch_engine(file)))
+        *stats = aio->stats;
+    else
+        HDmemset(stats, 0, sizeof(*stats));
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_async_get_stats() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_busy
+ *
+ * Purpose:     Check whether the engine has its queue depth of requests
+ *              in flight, i.e. whether a submission would block.
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+H5FD__async_busy(H5FD_async_t *aio)
+{
+    hbool_t ret_value = FALSE;          /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+#ifdef H5_HAVE_PTHREAD_H
+    if(aio->backend == H5FD_ASYNC_BACKEND_POOL) {
+        pthread_mutex_lock(&aio->mutex);
+        ret_value = (hbool_t)(aio->inflight >= aio->queue_depth);
+        pthread_mutex_unlock(&aio->mutex);
+    } /* end if */
+    else
+#endif /* H5_HAVE_PTHREAD_H */
+        ret_value = (hbool_t)(aio->inflight >= aio->queue_depth);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__async_busy() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_prefetch_engine
+ *
+ * Purpose:     Find the engine attached to FILE, if it has a prefetch
+ *              window.
+ *
+ * Return:      Pointer to the engine, or NULL if there is none
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_async_t *
+H5FD__async_prefetch_engine(const H5FD_t *file)
+{
+    H5FD_async_t *ret_value;            /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(NULL != (ret_value = H5FD_async_get_engine(file)) && NULL == ret_value->prefetch)
+        ret_value = NULL;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__async_prefetch_engine() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_prefetch_drop
+ *
+ * Purpose:     Empty a prefetch window slot, collecting its read if it is
+ *              still outstanding.  The read's status is discarded: nobody
+ *              is going to use the data.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__async_prefetch_drop(H5FD_async_prefetch_t *slot)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    if(slot->req) {
+        H5E_BEGIN_TRY {
+            (void)H5FD_async_wait(slot->req);
+        } H5E_END_TRY;
+        slot->req = NULL;
+    } /* end if */
+    slot->buf = (uint8_t *)H5MM_xfree(slot->buf);
+    slot->addr = HADDR_UNDEF;
+    slot->size = 0;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__async_prefetch_drop() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_prefetch_victim
+ *
+ * Purpose:     Pick the slot of the prefetch window to replace with a
+ *              prefetch for TIER: an empty slot if there is one, else the
+ *              least recently used slot of TIER once it has its share of
+ *              the window, else of the other tier.  The address evicted is
+ *              remembered as a ghost of its tier.
+ *
+ * Return:      Pointer to the slot (never NULL)
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_async_prefetch_t *
+H5FD__async_prefetch_victim(H5FD_async_t *aio, unsigned tier)
+{
+    H5FD_async_prefetch_t *lru[H5FD_ASYNC_NTIERS] = {NULL, NULL};  /* Least recently used slot of each tier */
+    unsigned nslots[H5FD_ASYNC_NTIERS] = {0, 0};    /* # of slots each tier fills */
+    unsigned share;                     /* TIER's share of the window */
+    unsigned victim_tier;               /* Tier giving up a slot */
+    unsigned u;                         /* Local index variable */
+    H5FD_async_prefetch_t *ret_value = NULL;    /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(aio && aio->prefetch);
+    HDassert(tier < H5FD_ASYNC_NTIERS);
+
+    for(u = 0; u < aio->prefetch_window; u++) {
+        H5FD_async_prefetch_t *slot = &aio->prefetch[u];
+        unsigned slot_tier;
+
+        if(!H5F_addr_defined(slot->addr))
+            HGOTO_DONE(slot)
+        slot_tier = H5FD_ASYNC_TIER(slot->type);
+        nslots[slot_tier]++;
+        if(NULL == lru[slot_tier] || slot->used < lru[slot_tier]->used)
+            lru[slot_tier] = slot;
+    } /* end for */
+
+    share = (tier == H5FD_ASYNC_TIER_META) ? aio->meta_target : (aio->prefetch_window - aio->meta_target);
+    victim_tier = (nslots[tier] >= share || 0 == nslots[1 - tier]) ? tier : 1 - tier;
+    if(0 == nslots[victim_tier])
+        victim_tier = 1 - victim_tier;
+    ret_value = lru[victim_tier];
+    HDassert(ret_value);
+
+    /* Remember the address, to notice if evicting it was a mistake */
+    aio->ghosts[(victim_tier * aio->prefetch_window) + aio->ghost_next[victim_tier]] = ret_value->addr;
+    aio->ghost_next[victim_tier] = (aio->ghost_next[victim_tier] + 1) % aio->prefetch_window;
+    aio->stats.evictions++;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__async_prefetch_victim() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_prefetch_ghost_hit
+ *
+ * Purpose:     Check a read of ADDR that missed the prefetch window
+ *              against the addresses TIER evicted last.  On a match the
+ *              tier was too small, so one slot of the split moves to it,
+ *              unless that takes the other tier below its minimum.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__async_prefetch_ghost_hit(H5FD_async_t *aio, unsigned tier, haddr_t addr)
+{
+    haddr_t *ghosts;                    /* Ghosts of the tier */
+    unsigned u;                         /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(aio && aio->ghosts);
+    HDassert(tier < H5FD_ASYNC_NTIERS);
+
+    ghosts = &aio->ghosts[tier * aio->prefetch_window];
+    for(u = 0; u < aio->prefetch_window; u++)
+        if(H5F_addr_eq(ghosts[u], addr)) {
+            /* Count each eviction once */
+            ghosts[u] = HADDR_UNDEF;
+            aio->stats.ghost_hits++;
+
+            if(tier == H5FD_ASYNC_TIER_META) {
+                if(aio->meta_target < aio->prefetch_window - aio->tier_min[H5FD_ASYNC_TIER_RAW])
+                    aio->meta_target++;
+            } /* end if */
+            else {
+                if(aio->meta_target > aio->tier_min[H5FD_ASYNC_TIER_META])
+                    aio->meta_target--;
+            } /* end else */
+            aio->stats.meta_slots = aio->meta_target;
+            break;
+        } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__async_prefetch_ghost_hit() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_submit
+ *
+ * Purpose:     Common code for submitting an asynchronous read or write.
+ *              The EOA is checked on the calling thread, as in H5FD_read()
+ *              and H5FD_write().  When the engine already has its queue
+ *              depth of requests in flight this blocks until one of them
+ *              completes.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__async_submit(H5FD_async_t *aio, H5FD_file_op_t op, H5FD_mem_t type,
+    haddr_t addr, size_t size, void *buf, H5FD_async_req_t **req)
+{
+    H5FD_async_req_t *new_req = NULL;   /* New request */
+    H5FD_t *file;                       /* File for the request */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(aio && aio->file);
+    HDassert(buf);
+    HDassert(req);
+    file = aio->file;
+
+    if(NULL == (new_req = H5FL_CALLOC(H5FD_async_req_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for async I/O request")
+    new_req->aio = aio;
+    new_req->op = op;
+
+    /* The synchronous backend just does the I/O now */
+    if(aio->backend == H5FD_ASYNC_BACKEND_SYNC) {
+        if(op == OP_READ) {
+            if(H5FD_read(file, type, addr, size, buf) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "file read failed")
+        } /* end if */
+        else
+            if(H5FD_write(file, type, addr, size, buf) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "file write failed")
+        new_req->complete = TRUE;
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+
+    /* Check the request against the EOA (reads by SWMR readers may go past it) */
+    if(op == OP_WRITE || !(file->access_flags & H5F_ACC_SWMR_READ)) {
+        haddr_t eoa;
+
+        if(HADDR_UNDEF == (eoa = (file->cls->get_eoa)(file, type)))
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "driver get_eoa request failed")
+        if((addr + file->base_addr + size) > eoa)
+            HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu, eoa = %llu", (unsigned long long)(addr + file->base_addr), (unsigned long long)size, (unsigned long long)eoa)
+    } /* end if */
+
+    /* A write that extends the file must go through the driver, so that
+     * its EOF follows
+     */
+    if(op == OP_WRITE) {
+        haddr_t eof;
+
+        if(HADDR_UNDEF == (eof = (file->cls->get_eof)(file, type)))
+            HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "driver get_eof request failed")
+        if((addr + file->base_addr + size) > eof) {
+            if(H5FD_write(file, type, addr, size, buf) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "file write failed")
+            new_req->complete = TRUE;
+            HGOTO_DONE(SUCCEED)
+        } /* end if */
+    } /* end if */
+
+    new_req->offset = (HDoff_t)(addr + file->base_addr);
+    new_req->size = size;
+    new_req->buf = (uint8_t *)buf;
+    new_req->addr = addr;
+    new_req->len = size;
+
+    if(0 == size) {
+        new_req->complete = TRUE;
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+
+#ifdef H5_HAVE_LIBURING
+    if(aio->backend == H5FD_ASYNC_BACKEND_URING) {
+        /* Apply backpressure */
+        while(aio->inflight >= aio->queue_depth)
+            if(H5FD__async_uring_reap(aio, TRUE) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "can't reap io_uring completions")
+
+        if(H5FD__async_uring_prep(new_req) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't queue io_uring request")
+        aio->inflight++;
+    } /* end if */
+#endif /* H5_HAVE_LIBURING */
+
+#ifdef H5_HAVE_PTHREAD_H
+    if(aio->backend == H5FD_ASYNC_BACKEND_POOL) {
+        pthread_mutex_lock(&aio->mutex);
+
+        /* Apply backpressure */
+        while(aio->inflight >= aio->queue_depth)
+            pthread_cond_wait(&aio->done_cv, &aio->mutex);
+
+        /* Append to the queue & wake a worker */
+        if(aio->tail)
+            aio->tail->next = new_req;
+        else
+            aio->head = new_req;
+        aio->tail = new_req;
+        aio->inflight++;
+        pthread_cond_signal(&aio->queue_cv);
+
+        pthread_mutex_unlock(&aio->mutex);
+    } /* end if */
+#endif /* H5_HAVE_PTHREAD_H */
+
+    /* Keep prefetches off the range until the write is waited for */
+    if(op == OP_WRITE) {
+        new_req->wnext = aio->writes;
+        aio->writes = new_req;
+    } /* end if */
+
+done:
+    if(ret_value < 0) {
+        if(new_req)
+            new_req = H5FL_FREE(H5FD_async_req_t, new_req);
+    } /* end if */
+    else {
+        aio->nreqs++;
+        *req = new_req;
+    } /* end else */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__async_submit() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_transfer
+ *
+ * Purpose:     Perform the I/O for a request on the engine's POSIX handle
+ *              with pread/pwrite, retrying interrupted and partial
+ *              transfers.  As in the sec2 driver, a read past the end of
+ *              the file fills the rest of the buffer with zeros.
+ *
+ *              This runs on worker threads, outside of the library's API
+ *              context, so it reports errors through req->err only.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__async_transfer(H5FD_async_req_t *req)
+{
+    int fd = req->aio->fd;
+
+    while(req->size > 0) {
+        ssize_t nbytes;
+
+        if(req->op == OP_READ)
+            nbytes = HDpread(fd, req->buf, req->size, req->offset);
+        else
+            nbytes = HDpwrite(fd, req->buf, req->size, req->offset);
+
+        if(-1 == nbytes) {
+            if(EINTR == errno)
+                continue;
+            req->err = errno;
+            break;
+        } /* end if */
+        if(0 == nbytes) {
+            if(req->op == OP_READ)
+                HDmemset(req->buf, 0, req->size);
+            else
+                req->err = EIO;
+            break;
+        } /* end if */
+
+        req->size -= (size_t)nbytes;
+        req->buf += nbytes;
+        req->offset += (HDoff_t)nbytes;
+    } /* end while */
+} /* end H5FD__async_transfer() */
+
+#ifdef H5_HAVE_LIBURING
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_uring_prep
+ *
+ * Purpose:     Queue the (remaining part of a) request on the engine's
+ *              submission ring and submit it to the kernel.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__async_uring_prep(H5FD_async_req_t *req)
+{
+    struct io_uring_sqe *sqe;           /* Submission queue entry */
+    int ret;                            /* Return value from liburing */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(NULL == (sqe = io_uring_get_sqe(&req->aio->ring)))
+        HGOTO_ERROR(H5E_VFL, H5E_NOSPACE, FAIL, "io_uring submission queue is full")
+
+    if(req->op == OP_READ)
+        io_uring_prep_read(sqe, req->aio->fd, req->buf, (unsigned)req->size, (__u64)req->offset);
+    else
+        io_uring_prep_write(sqe, req->aio->fd, req->buf, (unsigned)req->size, (__u64)req->offset);
+    io_uring_sqe_set_data(sqe, req);
+
+    if((ret = io_uring_submit(&req->aio->ring)) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "io_uring submit failed, error message = '%s'", HDstrerror(-ret))
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__async_uring_prep() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_uring_reap
+ *
+ * Purpose:     Process the entries on the engine's completion ring,
+ *              waiting for at least one if BLOCK is set.  Partial
+ *              transfers are resubmitted for their remaining bytes.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__async_uring_reap(H5FD_async_t *aio, hbool_t block)
+{
+    struct io_uring_cqe *cqe;           /* Completion queue entry */
+    int ret;                            /* Return value from liburing */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    ret = block ? io_uring_wait_cqe(&aio->ring, &cqe) : io_uring_peek_cqe(&aio->ring, &cqe);
+    while(0 == ret) {
+        H5FD_async_req_t *req = (H5FD_async_req_t *)io_uring_cqe_get_data(cqe);
+        int res = cqe->res;
+
+        io_uring_cqe_seen(&aio->ring, cqe);
+
+        if(res == -EINTR || res == -EAGAIN)
+            ;   /* Resubmit the request unchanged below */
+        else if(res < 0)
+            req->err = -res;
+        else if(0 == res) {
+            /* End of file, as in H5FD__async_transfer() */
+            if(req->op == OP_READ)
+                HDmemset(req->buf, 0, req->size);
+            else
+                req->err = EIO;
+            req->size = 0;
+        } /* end if */
+        else {
+            req->size -= (size_t)res;
+            req->buf += res;
+            req->offset += (HDoff_t)res;
+        } /* end else */
+
+        if(req->size > 0 && 0 == req->err) {
+            if(H5FD__async_uring_prep(req) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't resubmit partial io_uring request")
+        } /* end if */
+        else {
+            req->complete = TRUE;
+            aio->inflight--;
+        } /* end else */
+
+        ret = io_uring_peek_cqe(&aio->ring, &cqe);
+    } /* end while */
+
+    if(ret < 0 && ret != -EAGAIN && ret != -EINTR)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "io_uring completion failed, error message = '%s'", HDstrerror(-ret))
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__async_uring_reap() */
+#endif /* H5_HAVE_LIBURING */
+
+#ifdef H5_HAVE_PTHREAD_H
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__async_worker
+ *
+ * Purpose:     Thread pool worker: take requests off the engine's queue
+ *              and perform them until the engine is shut down.
+ *
+ * Return:      NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD__async_worker(void *_aio)
+{
+    H5FD_async_t *aio = (H5FD_async_t *)_aio;
+
+    pthread_mutex_lock(&aio->mutex);
+    for(;;) {
+        H5FD_async_req_t *req;
+
+        while(NULL == aio->head && !aio->shutdown)
+            pthread_cond_wait(&aio->queue_cv, &aio->mutex);
+        if(NULL == aio->head)
+            break;
+
+        /* Take the request at the head of the queue */
+        req = aio->head;
+        if(NULL == (aio->head = req->next))
+            aio->tail = NULL;
+        req->next = NULL;
+
+        pthread_mutex_unlock(&aio->mutex);
+        H5FD__async_transfer(req);
+        pthread_mutex_lock(&aio->mutex);
+
+        req->complete = TRUE;
+        aio->inflight--;
+        pthread_cond_broadcast(&aio->done_cv);
+    } /* end for */
+    pthread_mutex_unlock(&aio->mutex);
+
+    return NULL;
+} /* end H5FD__async_worker() */
+#endif /* H5_HAVE_PTHREAD_H */
@@ -38,17 +38,50 @@
 #include "H5Fprivate.h"         /* File access				*/
 #include "H5FDpkg.h"		/* File Drivers				*/
 #include "H5Iprivate.h"		/* IDs			  		*/
+#include "H5MMprivate.h"        /* Memory management                    */
 
 
 /****************/
 /* Local Macros */
 /****************/
 
+/* Number of vector I/O entries whose prefetch misses are collected on the
+ * stack; longer vectors allocate room for them
+ */
+#define H5FD_VECTOR_NSTACK      16
+
+/* Number of files whose superblock signature address is remembered */
+#define H5FD_SIG_CACHE_NSLOTS   64
+
+/* Nanoseconds of a file's modification time, so that a file rewritten
+ * within a second of the address being found is still seen to change
+ */
+#if defined(H5_HAVE_WIN32_API)
+#define H5FD_SIG_CACHE_MTIME_NSEC(SB)   ((int64_t)0)
+#elif defined(H5_HAVE_DARWIN)
+#define H5FD_SIG_CACHE_MTIME_NSEC(SB)   ((int64_t)(SB)->st_mtimespec.tv_nsec)
+#else
+#define H5FD_SIG_CACHE_MTIME_NSEC(SB)   ((int64_t)(SB)->st_mtim.tv_nsec)
+#endif
 
 /******************/
 /* Local Typedefs */
 /******************/
 
+/* Superblock signature address remembered for a file, which is identified
+ * by its device & inode and is considered changed when its size or
+ * modification time differ from when the address was found.
+ */
+typedef struct H5FD_sig_cache_ent_t {
+    hbool_t     valid;          /* Whether the slot is in use */
+    uint64_t    dev;            /* Device of the file */
+    uint64_t    ino;            /* Inode of the file */
+    uint64_t    size;           /* Size of the file when the address was found */
+    int64_t     mtime;          /* Modification time of the file when the address was found */
+    int64_t     mtime_nsec;     /* Nanoseconds of the modification time */
+    haddr_t     sig_addr;       /* Address of the signature */
+    uint64_t    last_used;      /* Value of the LRU clock at the last hit */
+} H5FD_sig_cache_ent_t;
 
 /********************/
 /* Package Typedefs */
@@ -59,6 +92,14 @@
 /* Local Prototypes */
 /********************/
 
+static herr_t H5FD__vector_check_eoa(const H5FD_t *file, uint32_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[]);
+static herr_t H5FD__vector_abs_addrs(const H5FD_t *file, uint32_t count,
+    const haddr_t addrs[], haddr_t **abs_addrs);
+static htri_t H5FD__sig_cache_stat(H5FD_t *file, h5_stat_t *sb);
+static H5FD_sig_cache_ent_t *H5FD__sig_cache_find(const h5_stat_t *sb);
+static void H5FD__sig_cache_insert(const h5_stat_t *sb, haddr_t sig_addr);
+
 
 /*********************/
 /* Package Variables */
@@ -74,6 +115,14 @@
 /* Local Variables */
 /*******************/
 
+/* Superblock signature addresses of recently opened files, shared by all
+ * opens so that reopening the target of an external link doesn't search
+ * for the signature again.
+ */
+static H5FD_sig_cache_ent_t H5FD_sig_cache_g[H5FD_SIG_CACHE_NSLOTS];
+static uint64_t H5FD_sig_cache_clock_g = 0;
+static H5FD_sig_cache_stats_t H5FD_sig_cache_stats_g;
+
 
 
 /*-------------------------------------------------------------------------
@@ -83,6 +132,11 @@
  *              signature can appear at address 0, or any power of two
  *              beginning with 512.
  *
+ *              Address zero is tried first.  Any other address found is
+ *              remembered for files with a POSIX handle, and tried next
+ *              when the same file is opened again without having changed
+ *              since.
+ *
  * Return:      Success:        SUCCEED
  *              Failure:        FAIL
  *
@@ -97,6 +151,9 @@ H5FD_locate_signature(H5FD_t *file, haddr_t *sig_addr)
     haddr_t         addr, eoa, eof;
     uint8_t         buf[H5F_SIGNATURE_LEN];
     unsigned        n, maxpow;
+    h5_stat_t       sb;                 /* Identity of the file */
+    htri_t          have_sb;            /* Whether the file has an identity */
+    H5FD_sig_cache_ent_t *ent;          /* Remembered signature address */
     herr_t          ret_value = SUCCEED; /* Return value */
 
     FUNC_ENTER_NOAPI_NOINIT
@@ -104,22 +161,64 @@ H5FD_locate_signature(H5FD_t *file, haddr_t *sig_addr)
     /* Sanity checks */
     HDassert(file);
 
-    /* Find the least N such that 2^N is larger than the file size */
+    /* Get the EOF & EOA before the probe below moves the EOA */
     eof = H5FD_get_eof(file, H5FD_MEM_SUPER);
     eoa = H5FD_get_eoa(file, H5FD_MEM_SUPER);
     addr = MAX(eof, eoa);
     if(HADDR_UNDEF == addr)
         HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to obtain EOF/EOA value")
+
+    /* Most files have their signature at address 0, which takes a single
+     * read and doesn't need the cache below
+     */
+    if(H5FD_set_eoa(file, H5FD_MEM_SUPER, (haddr_t)H5F_SIGNATURE_LEN) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to set EOA value for file signature")
+    if(H5FD_read(file, H5FD_MEM_SUPER, (haddr_t)0, (size_t)H5F_SIGNATURE_LEN, buf) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to read file signature")
+    if(!HDmemcmp(buf, H5F_SIGNATURE, (size_t)H5F_SIGNATURE_LEN)) {
+        *sig_addr = 0;
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+
+    /* Try the address found when the file was last opened.  The signature
+     * is read again, so a change that the size & time don't show only
+     * costs the read.
+     */
+    if((have_sb = H5FD__sig_cache_stat(file, &sb)) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_CANTGET, FAIL, "unable to get file identity")
+    if(have_sb) {
+        if(NULL != (ent = H5FD__sig_cache_find(&sb))) {
+            if(H5FD_set_eoa(file, H5FD_MEM_SUPER, ent->sig_addr + H5F_SIGNATURE_LEN) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to set EOA value for file signature")
+            if(H5FD_read(file, H5FD_MEM_SUPER, ent->sig_addr, (size_t)H5F_SIGNATURE_LEN, buf) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to read file signature")
+            if(!HDmemcmp(buf, H5F_SIGNATURE, (size_t)H5F_SIGNATURE_LEN)) {
+                ent->last_used = ++H5FD_sig_cache_clock_g;
+                H5FD_sig_cache_stats_g.hits++;
+                *sig_addr = ent->sig_addr;
+                HGOTO_DONE(SUCCEED)
+            } /* end if */
+            ent->valid = FALSE;
+            H5FD_sig_cache_stats_g.invalidations++;
+
+            /* Put back the EOA the probe moved */
+            if(H5FD_set_eoa(file, H5FD_MEM_SUPER, eoa) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to reset EOA value")
+        } /* end if */
+        H5FD_sig_cache_stats_g.misses++;
+    } /* end if */
+
+    /* Find the least N such that 2^N is larger than the file size */
     for(maxpow = 0; addr; maxpow++)
         addr >>= 1;
     maxpow = MAX(maxpow, 9);
 
     /*
-     * Search for the file signature at format address zero followed by
-     * powers of two larger than 9.
+     * Search for the file signature at powers of two larger than 9,
+     * address zero having been tried above.
      */
-    for(n = 8; n < maxpow; n++) {
-        addr = (8 == n) ? 0 : (haddr_t)1 << n;
+    for(n = 9; n < maxpow; n++) {
+        addr = (haddr_t)1 << n;
         if(H5FD_set_eoa(file, H5FD_MEM_SUPER, addr + H5F_SIGNATURE_LEN) < 0)
             HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to set EOA value for file signature")
         if(H5FD_read(file, H5FD_MEM_SUPER, addr, (size_t)H5F_SIGNATURE_LEN, buf) < 0)
@@ -137,14 +236,161 @@ H5FD_locate_signature(H5FD_t *file, haddr_t *sig_addr)
             HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to reset EOA value")
         *sig_addr = HADDR_UNDEF;
     } /* end if */
-    else
+    else {
         /* Set return value */
         *sig_addr = addr;
 
+        /* Remember the address for the next open */
+        if(have_sb)
+            H5FD__sig_cache_insert(&sb, addr);
+    } /* end else */
+
 done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5FD_locate_signature() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__sig_cache_stat
+ *
+ * Purpose:     Get the identity of FILE for the signature address cache
+ *              into *SB.  Only files with a POSIX handle have one.
+ *
+ * Return:      TRUE if FILE has an identity, FALSE if not, negative on
+ *              failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static htri_t
+H5FD__sig_cache_stat(H5FD_t *file, h5_stat_t *sb)
+{
+    int        *fdp = NULL;             /* POSIX handle of the file */
+    htri_t      ret_value = FALSE;      /* Return value */
+
+    FUNC_ENTER_STATIC
+
+#ifndef H5_HAVE_WIN32_API
+    if(file->feature_flags & H5FD_FEAT_POSIX_COMPAT_HANDLE) {
+        if(H5FD_get_vfd_handle(file, H5P_FILE_ACCESS_DEFAULT, (void **)&fdp) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "can't get POSIX handle")
+
+        /* A file that can't be stat'ed is just not remembered */
+        if(HDfstat(*fdp, sb) == 0)
+            ret_value = TRUE;
+    } /* end if */
+#endif /* H5_HAVE_WIN32_API */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__sig_cache_stat() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__sig_cache_find
+ *
+ * Purpose:     Look up the signature address remembered for the file
+ *              identified by SB.  An entry for the file that was made
+ *              before it last changed is dropped.
+ *
+ * Return:      Success:        The entry
+ *              Failure:        NULL, if the file has no current entry
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_sig_cache_ent_t *
+H5FD__sig_cache_find(const h5_stat_t *sb)
+{
+    unsigned    u;
+    H5FD_sig_cache_ent_t *ret_value = NULL;     /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(u = 0; u < H5FD_SIG_CACHE_NSLOTS; u++) {
+        H5FD_sig_cache_ent_t *ent = &H5FD_sig_cache_g[u];
+
+        if(ent->valid && ent->dev == (uint64_t)sb->st_dev && ent->ino == (uint64_t)sb->st_ino) {
+            if(ent->size == (uint64_t)sb->st_size && ent->mtime == (int64_t)sb->st_mtime
+                    && ent->mtime_nsec == H5FD_SIG_CACHE_MTIME_NSEC(sb))
+                ret_value = ent;
+            else {
+                ent->valid = FALSE;
+                H5FD_sig_cache_stats_g.invalidations++;
+            } /* end else */
+            break;
+        } /* end if */
+    } /* end for */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__sig_cache_find() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__sig_cache_insert
+ *
+ * Purpose:     Remember SIG_ADDR as the signature address of the file
+ *              identified by SB, replacing the least recently used entry
+ *              when all slots are in use.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__sig_cache_insert(const h5_stat_t *sb, haddr_t sig_addr)
+{
+    H5FD_sig_cache_ent_t *ent = &H5FD_sig_cache_g[0];  /* Slot to use */
+    unsigned    u;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(u = 0; u < H5FD_SIG_CACHE_NSLOTS; u++) {
+        if(!H5FD_sig_cache_g[u].valid) {
+            ent = &H5FD_sig_cache_g[u];
+            break;
+        } /* end if */
+        if(H5FD_sig_cache_g[u].last_used < ent->last_used)
+            ent = &H5FD_sig_cache_g[u];
+    } /* end for */
+    if(ent->valid)
+        H5FD_sig_cache_stats_g.evictions++;
+
+    ent->valid = TRUE;
+    ent->dev = (uint64_t)sb->st_dev;
+    ent->ino = (uint64_t)sb->st_ino;
+    ent->size = (uint64_t)sb->st_size;
+    ent->mtime = (int64_t)sb->st_mtime;
+    ent->mtime_nsec = H5FD_SIG_CACHE_MTIME_NSEC(sb);
+    ent->sig_addr = sig_addr;
+    ent->last_used = ++H5FD_sig_cache_clock_g;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__sig_cache_insert() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_sig_cache_get_stats
+ *
+ * Purpose:     Retrieve the signature address cache's statistics: opens
+ *              that used a remembered address and that searched for the
+ *              signature, entries replaced by other files and entries
+ *              dropped because their file changed.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_sig_cache_get_stats(H5FD_sig_cache_stats_t *stats/*out*/)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(stats);
+
+    *stats = H5FD_sig_cache_stats_g;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_sig_cache_get_stats() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5FD_read
@@ -165,6 +411,7 @@ H5FD_read(H5FD_t *file, H5FD_mem_t type, haddr_t addr, size_t size,
 {
     hid_t dxpl_id;                      /* DXPL for operation */
     herr_t ret_value = SUCCEED;         /* Return value */
+    H5_SPAN_DECL(span_start)            /* Start of the tracing span */
 
     FUNC_ENTER_NOAPI(FAIL)
 
@@ -200,11 +447,27 @@ H5FD_read(H5FD_t *file, H5FD_mem_t type, haddr_t addr, size_t size,
             HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu, eoa = %llu", (unsigned long long)(addr + file->base_addr), (unsigned long long)size, (unsigned long long)eoa)
     } /* end if */
 
+    /* Use a prefetched copy of the range, if there is one, and read ahead
+     * of sequential reads
+     */
+    if(H5FD_async_nprefetch_g > 0) {
+        htri_t hit;
+
+        if((hit = H5FD_async_prefetch_read(file, type, addr, size, buf)) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "can't check prefetch window")
+        if(H5FD_async_prefetch_sequential(file, type, addr, size) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "can't read ahead")
+        if(hit)
+            HGOTO_DONE(SUCCEED)
+    } /* end if */
+
     /* Dispatch to driver */
     if((file->cls->read)(file, type, dxpl_id, addr + file->base_addr, size, buf) < 0)
         HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "driver read request failed")
 
 done:
+    H5_SPAN_END(span_start, H5_SPAN_FD_READ, type, size);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5FD_read() */
 
@@ -229,6 +492,7 @@ H5FD_write(H5FD_t *file, H5FD_mem_t type, haddr_t addr, size_t size,
     hid_t dxpl_id;                      /* DXPL for operation */
     haddr_t eoa = HADDR_UNDEF;          /* EOA for file */
     herr_t ret_value = SUCCEED;         /* Return value */
+    H5_SPAN_DECL(span_start)            /* Start of the tracing span */
 
     FUNC_ENTER_NOAPI(FAIL)
 
@@ -253,15 +517,317 @@ H5FD_write(H5FD_t *file, H5FD_mem_t type, haddr_t addr, size_t size,
         HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size=%llu, eoa=%llu", 
                     (unsigned long long)(addr+ file->base_addr), (unsigned long long)size, (unsigned long long)eoa)
 
+    /* Drop prefetched copies of the range */
+    if(H5FD_async_nprefetch_g > 0)
+        if(H5FD_async_prefetch_invalidate(file, addr, size) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTRELEASE, FAIL, "can't invalidate prefetched ranges")
+
     /* Dispatch to driver */
     if((file->cls->write)(file, type, dxpl_id, addr + file->base_addr, size, buf) < 0)
         HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "driver write request failed")
 
 done:
+    H5_SPAN_END(span_start, H5_SPAN_FD_WRITE, type, size);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5FD_write() */
 
 
+/*-------------------------------------------------------------------------
+ * Function:	H5FD__vector_check_eoa
+ *
+ * Purpose:	Verify that every (addr, size) pair in a vector I/O request
+ *              falls below the EOA for its memory type.  The driver's
+ *              'get_eoa' callback is only made when the memory type
+ *              changes between consecutive entries, so a batch of requests
+ *              of the same type costs a single callback.  Undefined
+ *              addresses, and ranges that wrap around the address space,
+ *              are rejected.
+ *
+ * Return:	Success:	Non-negative
+ *		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__vector_check_eoa(const H5FD_t *file, uint32_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[])
+{
+    H5FD_mem_t  eoa_type = H5FD_MEM_NTYPES; /* Memory type 'eoa' is valid for */
+    haddr_t     eoa = HADDR_UNDEF;      /* EOA for current memory type */
+    uint32_t    u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    for(u = 0; u < count; u++) {
+        if(types[u] != eoa_type) {
+            if(HADDR_UNDEF == (eoa = (file->cls->get_eoa)(file, types[u])))
+                HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "driver get_eoa request failed")
+            eoa_type = types[u];
+        } /* end if */
+
+        /* The sums below must not wrap around */
+        if(!H5F_addr_defined(addrs[u]))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, entry = %u", (unsigned)u)
+        if(H5F_addr_overflow(addrs[u], file->base_addr)
+                || H5F_addr_overflow(addrs[u] + file->base_addr, sizes[u]))
+            HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, entry = %u, addr = %llu, size = %llu", (unsigned)u, (unsigned long long)addrs[u], (unsigned long long)sizes[u])
+
+        if((addrs[u] + file->base_addr + sizes[u]) > eoa)
+            HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, entry = %u, addr = %llu, size = %llu, eoa = %llu", (unsigned)u, (unsigned long long)(addrs[u] + file->base_addr), (unsigned long long)sizes[u], (unsigned long long)eoa)
+    } /* end for */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vector_check_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FD__vector_abs_addrs
+ *
+ * Purpose:	Convert the relative addresses of a vector I/O request to
+ *              the absolute addresses the driver expects.  When the file
+ *              has no base address the caller's array is used as-is and
+ *              no memory is allocated; otherwise a translated copy is
+ *              returned, which the caller must release with H5MM_xfree().
+ *
+ * Return:	Success:	Non-negative
+ *		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__vector_abs_addrs(const H5FD_t *file, uint32_t count,
+    const haddr_t addrs[], haddr_t **abs_addrs)
+{
+    uint32_t    u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    *abs_addrs = NULL;
+    if(0 != file->base_addr) {
+        if(NULL == (*abs_addrs = (haddr_t *)H5MM_malloc(count * sizeof(haddr_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for address vector")
+        for(u = 0; u < count; u++)
+            (*abs_addrs)[u] = addrs[u] + file->base_addr;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vector_abs_addrs() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FD_read_vector
+ *
+ * Purpose:	Read a batch of COUNT (type, addr, size, buf) requests from
+ *              the file.  The DXPL is retrieved and the EOA is checked
+ *              once for the whole batch, then the batch is handed to the
+ *              driver's 'read_vector' callback if it provides one, or
+ *              serviced with one 'read' callback per entry otherwise.
+ *              Entries found in the file's prefetch window are copied
+ *              from it and left out of the batch.
+ *
+ * Return:	Success:	Non-negative
+ *		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_read_vector(H5FD_t *file, uint32_t count, const H5FD_mem_t types[],
+    const haddr_t addrs[], const size_t sizes[], void *bufs[]/*out*/)
+{
+    hid_t dxpl_id;                      /* DXPL for operation */
+    haddr_t *abs_addrs = NULL;          /* Absolute addresses, if translated */
+    const haddr_t *drv_addrs;           /* Addresses passed to the driver */
+    haddr_t miss_addrs_s[H5FD_VECTOR_NSTACK];   /* Entries not in the prefetch window, for short vectors */
+    size_t miss_sizes_s[H5FD_VECTOR_NSTACK];
+    void *miss_bufs_s[H5FD_VECTOR_NSTACK];
+    H5FD_mem_t miss_types_s[H5FD_VECTOR_NSTACK];
+    void *miss_block = NULL;            /* Room for the entries of long vectors */
+    uint32_t u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Sanity checks */
+    HDassert(file && file->cls);
+    HDassert(0 == count || (types && addrs && sizes && bufs));
+
+    /* Get proper DXPL for I/O */
+    dxpl_id = H5CX_get_dxpl();
+
+#ifndef H5_HAVE_PARALLEL
+    /* Do not return early for Parallel mode since the I/O could be a */
+    /* collective transfer. */
+    /* The no-op case */
+    if(0 == count)
+        HGOTO_DONE(SUCCEED)
+#endif /* H5_HAVE_PARALLEL */
+
+    /* Allow reads past the EOA for SWMR readers, as in H5FD_read() */
+    if(!(file->access_flags & H5F_ACC_SWMR_READ))
+        if(H5FD__vector_check_eoa(file, count, types, addrs, sizes) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_OVERFLOW, FAIL, "vector read request exceeds EOA")
+
+    /* Use prefetched copies of the entries, as in H5FD_read(), and pass
+     * only the rest on to the driver
+     */
+    if(H5FD_async_nprefetch_g > 0 && H5FD_async_get_engine(file)) {
+        haddr_t *miss_addrs = miss_addrs_s;     /* Entries left for the driver */
+        size_t *miss_sizes = miss_sizes_s;
+        void **miss_bufs = miss_bufs_s;
+        H5FD_mem_t *miss_types = miss_types_s;
+        uint32_t nmiss = 0;             /* # of entries left for the driver */
+
+        /* Carve the four arrays out of a single block, most strictly
+         * aligned first
+         */
+        if(count > H5FD_VECTOR_NSTACK) {
+            if(NULL == (miss_block = H5MM_malloc(count * (sizeof(haddr_t) + sizeof(size_t) + sizeof(void *) + sizeof(H5FD_mem_t)))))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for vector of prefetch misses")
+            miss_addrs = (haddr_t *)miss_block;
+            miss_sizes = (size_t *)(miss_addrs + count);
+            miss_bufs = (void **)(miss_sizes + count);
+            miss_types = (H5FD_mem_t *)(miss_bufs + count);
+        } /* end if */
+
+        for(u = 0; u < count; u++) {
+            htri_t hit = FALSE;
+
+            if(sizes[u] > 0)
+                if((hit = H5FD_async_prefetch_read(file, types[u], addrs[u], sizes[u], bufs[u])) < 0)
+                    HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "can't check prefetch window, entry = %u", (unsigned)u)
+            if(!hit) {
+                miss_types[nmiss] = types[u];
+                miss_addrs[nmiss] = addrs[u];
+                miss_sizes[nmiss] = sizes[u];
+                miss_bufs[nmiss] = bufs[u];
+                nmiss++;
+            } /* end if */
+        } /* end for */
+
+        count = nmiss;
+        types = miss_types;
+        addrs = miss_addrs;
+        sizes = miss_sizes;
+        bufs = miss_bufs;
+
+#ifndef H5_HAVE_PARALLEL
+        if(0 == count)
+            HGOTO_DONE(SUCCEED)
+#endif /* H5_HAVE_PARALLEL */
+    } /* end if */
+
+    /* Convert to absolute addresses */
+    if(H5FD__vector_abs_addrs(file, count, addrs, &abs_addrs) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't convert vector addresses")
+    drv_addrs = abs_addrs ? abs_addrs : addrs;
+
+    /* Dispatch to driver */
+    if(file->feature_flags & H5FD_FEAT_VECTOR_IO) {
+        const H5FD_class_vector_t *cls = (const H5FD_class_vector_t *)file->cls;
+
+        HDassert(cls->read_vector);
+        if((cls->read_vector)(file, dxpl_id, count, types, drv_addrs, sizes, bufs) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "driver read_vector request failed")
+    } /* end if */
+    else
+        for(u = 0; u < count; u++) {
+            if(0 == sizes[u])
+                continue;
+            HDassert(bufs[u]);
+            if((file->cls->read)(file, types[u], dxpl_id, drv_addrs[u], sizes[u], bufs[u]) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "driver read request failed, entry = %u", (unsigned)u)
+        } /* end for */
+
+done:
+    abs_addrs = (haddr_t *)H5MM_xfree(abs_addrs);
+    miss_block = H5MM_xfree(miss_block);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_read_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FD_write_vector
+ *
+ * Purpose:	Write a batch of COUNT (type, addr, size, buf) requests to
+ *              the file.  See H5FD_read_vector() for how the batch is
+ *              checked and dispatched.
+ *
+ * Return:	Success:	Non-negative
+ *		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_write_vector(H5FD_t *file, uint32_t count, const H5FD_mem_t types[],
+    const haddr_t addrs[], const size_t sizes[], const void *bufs[])
+{
+    hid_t dxpl_id;                      /* DXPL for operation */
+    haddr_t *abs_addrs = NULL;          /* Absolute addresses, if translated */
+    const haddr_t *drv_addrs;           /* Addresses passed to the driver */
+    uint32_t u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Sanity checks */
+    HDassert(file && file->cls);
+    HDassert(0 == count || (types && addrs && sizes && bufs));
+
+    /* Get proper DXPL for I/O */
+    dxpl_id = H5CX_get_dxpl();
+
+#ifndef H5_HAVE_PARALLEL
+    /* Do not return early for Parallel mode since the I/O could be a */
+    /* collective transfer. */
+    /* The no-op case */
+    if(0 == count)
+        HGOTO_DONE(SUCCEED)
+#endif /* H5_HAVE_PARALLEL */
+
+    if(H5FD__vector_check_eoa(file, count, types, addrs, sizes) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_OVERFLOW, FAIL, "vector write request exceeds EOA")
+
+    /* Drop prefetched copies of the ranges */
+    if(H5FD_async_nprefetch_g > 0)
+        for(u = 0; u < count; u++)
+            if(H5FD_async_prefetch_invalidate(file, addrs[u], sizes[u]) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_CANTRELEASE, FAIL, "can't invalidate prefetched ranges")
+
+    /* Convert to absolute addresses */
+    if(H5FD__vector_abs_addrs(file, count, addrs, &abs_addrs) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't convert vector addresses")
+    drv_addrs = abs_addrs ? abs_addrs : addrs;
+
+    /* Dispatch to driver */
+    if(file->feature_flags & H5FD_FEAT_VECTOR_IO) {
+        const H5FD_class_vector_t *cls = (const H5FD_class_vector_t *)file->cls;
+
+        HDassert(cls->write_vector);
+        if((cls->write_vector)(file, dxpl_id, count, types, drv_addrs, sizes, bufs) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "driver write_vector request failed")
+    } /* end if */
+    else
+        for(u = 0; u < count; u++) {
+            if(0 == sizes[u])
+                continue;
+            HDassert(bufs[u]);
+            if((file->cls->write)(file, types[u], dxpl_id, drv_addrs[u], sizes[u], bufs[u]) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "driver write request failed, entry = %u", (unsigned)u)
+        } /* end for */
+
+done:
+    abs_addrs = (haddr_t *)H5MM_xfree(abs_addrs);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_write_vector() */
+
+
 /*-------------------------------------------------------------------------
  * Function:	H5FD_set_eoa
  *
@@ -459,6 +1025,10 @@ H5FD_reader_end_of_tick(void)
 
     FUNC_ENTER_NOAPI_NOINIT_NOERR
 
+    /* Prefetched ranges may be out of date now */
+    if(H5FD_async_nprefetch_g > 0)
+        H5FD_async_prefetch_end_of_tick();
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5FD_reader_end_of_tick() */
 
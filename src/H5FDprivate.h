@@ -76,6 +76,32 @@
     + (N * H5FD_MD_INDEX_ENTRY_SIZE)    /* Index entries */                     \
     + H5FD_SIZEOF_CHKSUM                /* Metadata header checksum */          \
     )
+
+/* Metadata file delta index magic */
+#define H5FD_MD_DELTA_MAGIC            "VDLT"          /* Delta index magic */
+
+/* Size of a removed page in a delta index */
+#define H5FD_MD_DELTA_REMOVED_SIZE      4               /* HDF5 file page offset */
+
+/* Size of a delta index record, holding the entries changed & removed
+ * since the last full index (checkpoint) was written
+ */
+#define H5FD_MD_DELTA_SIZE(C, R)        /* C changed, R removed entries */      \
+    (                                                                           \
+    H5_SIZEOF_MAGIC                     /* Signature */                         \
+    + 8                                 /* Tick num */                          \
+    + 8                                 /* Checkpoint tick num */               \
+    + 8                                 /* Checkpoint index offset */           \
+    + 8                                 /* Checkpoint index length */           \
+    + 4                                 /* Number of changed entries */         \
+    + 4                                 /* Number of removed entries */         \
+    + ((C) * H5FD_MD_INDEX_ENTRY_SIZE)  /* Changed index entries */             \
+    + ((R) * H5FD_MD_DELTA_REMOVED_SIZE) /* Removed page offsets */             \
+    + H5FD_SIZEOF_CHKSUM                /* Delta index checksum */              \
+    )
+
+/* Maximum # of ticks between full index checkpoints */
+#define H5FD_MD_DELTA_MAX_TICKS         64
     
 /*  Internal representation of metadata file index */
 typedef struct H5FD_vfd_swmr_idx_entry_t {
@@ -110,7 +136,105 @@ typedef struct H5FD_vfd_swmr_idx_entry_t {
                                     * file
                                     */
 } H5FD_vfd_swmr_idx_entry_t;
+
+/*  In-memory lookup structure kept in sync with the metadata file index */
+typedef struct H5FD_vfd_swmr_idx_hash_t {
+    uint32_t *slots;            /* Open-addressing hash table of index entry
+                                 * positions + 1, 0 for an empty slot
+                                 */
+    uint32_t nslots;            /* # of slots, always a power of two */
+    unsigned shift;             /* 64 - log2(nslots), for Fibonacci hashing */
+    uint32_t nentries;          /* # of index entries in the table */
+    uint64_t *changed;          /* HDF5 page offsets of the entries changed
+                                 * by the writer since the last checkpoint
+                                 */
+    uint32_t nchanged;          /* # of entries in changed */
+    uint32_t alloc_changed;     /* # of entries allocated for changed */
+    uint64_t *removed;          /* HDF5 page offsets of the entries removed
+                                 * by the writer since the last checkpoint
+                                 */
+    uint32_t nremoved;          /* # of entries in removed */
+    uint32_t alloc_removed;     /* # of entries allocated for removed */
+} H5FD_vfd_swmr_idx_hash_t;
+
+/*  Decoded delta index record (see H5FD_MD_DELTA_SIZE) */
+typedef struct H5FD_vfd_swmr_delta_t {
+    uint64_t tick;                  /* Tick of this record */
+    uint64_t checkpoint_tick;       /* Tick of the full index it is relative to */
+    haddr_t checkpoint_offset;      /* Offset of that index in the metadata file */
+    hsize_t checkpoint_length;      /* Length of that index */
+    uint32_t nchanged;              /* # of changed entries */
+    uint32_t nremoved;              /* # of removed entries */
+    const uint8_t *changed_image;   /* Encoded changed entries */
+    const uint8_t *removed_image;   /* Encoded removed page offsets */
+} H5FD_vfd_swmr_delta_t;
+
+/* # of size classes of metadata file free extents: class C holds extents
+ * of [2^C, 2^(C+1)) pages, the last class all longer ones */
+#define H5FD_MD_SPACE_NCLASSES          12
+
+/* Extent of metadata file pages, free or waiting to be */
+typedef struct H5FD_vfd_swmr_md_extent_t {
+    uint64_t page;                  /* First page */
+    uint64_t npages;                /* # of pages */
+    uint64_t tick;                  /* Tick it was freed in */
+} H5FD_vfd_swmr_md_extent_t;
+
+/* Free extents of one size class, sorted by page */
+typedef struct H5FD_vfd_swmr_md_class_t {
+    H5FD_vfd_swmr_md_extent_t *extents;
+    uint32_t nextents;              /* # of extents */
+    uint32_t alloc_extents;         /* # of extents allocated */
+} H5FD_vfd_swmr_md_class_t;
+
+/* Free space of the metadata file (see H5FDvfd_swmr_space.c) */
+typedef struct H5FD_vfd_swmr_md_space_t {
+    uint32_t page_size;             /* Size of a page */
+    uint64_t max_lag;               /* Ticks before freed pages are reused */
+    uint64_t first_page;            /* First page past the header & index */
+    uint64_t eoa_page;              /* First page past allocated space */
+    uint64_t nfree;                 /* # of free pages below eoa_page */
+    uint64_t nwaiting;              /* # of freed pages waiting for max_lag */
+    H5FD_vfd_swmr_md_extent_t *pending; /* Freed extents, by tick */
+    uint32_t pending_head;          /* First extent still waiting */
+    uint32_t npending;              /* # of extents in pending */
+    uint32_t alloc_pending;         /* # of extents allocated */
+    H5FD_vfd_swmr_md_class_t classes[H5FD_MD_SPACE_NCLASSES];
+} H5FD_vfd_swmr_md_space_t;
     
+/*
+ * Feature flag for drivers that are sub-classed from H5FD_class_vector_t
+ * below and can service a whole batch of (type, addr, size, buf) requests
+ * in one callback (e.g. with preadv/pwritev or multi-range requests).
+ */
+#define H5FD_FEAT_VECTOR_IO             0x00010000
+
+/* Sub-class the H5FD_class_t to add vector I/O callbacks.  Drivers that
+ * don't set H5FD_FEAT_VECTOR_IO are serviced by looping over the 'read' &
+ * 'write' callbacks instead.  Addresses passed to the callbacks are absolute.
+ */
+typedef struct H5FD_class_vector_t {
+    H5FD_class_t        super;          /* Superclass information & methods */
+    herr_t  (*read_vector)(H5FD_t *file, hid_t dxpl_id, uint32_t count,
+                const H5FD_mem_t types[], const haddr_t addrs[],
+                const size_t sizes[], void *bufs[]/*out*/);
+    herr_t  (*write_vector)(H5FD_t *file, hid_t dxpl_id, uint32_t count,
+                const H5FD_mem_t types[], const haddr_t addrs[],
+                const size_t sizes[], const void *bufs[]);
+} H5FD_class_vector_t;
+
+/* Definitions for the asynchronous I/O queue depth file access property */
+#define H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_NAME  "vfd_async_queue_depth"   /* Max. # of async I/O requests in flight */
+
+/* Definitions for the VFD SWMR tick notification file access property */
+#define H5F_ACS_VFD_SWMR_NOTIFY_NAME        "vfd_swmr_notify"   /* Publish/wait for ticks through shared memory */
+
+/* Definitions for the metadata prefetch window file access property */
+#define H5F_ACS_VFD_PREFETCH_WINDOW_NAME    "vfd_prefetch_window"   /* Max. # of prefetched metadata reads */
+
+/* Definitions for the page buffer read-ahead file access property */
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_NAME   "page_buffer_prefetch"  /* # of pages to read ahead of sequential reads */
+
 #ifdef H5_HAVE_PARALLEL
 /* ======== Temporary data transfer properties ======== */
 /* Definitions for memory MPI type property */
@@ -177,10 +301,43 @@ typedef struct H5FD_mpio_fapl_t {
 #endif /* H5_HAVE_PARALLEL */
 
 
+/* Asynchronous I/O engine & request handles (defined in H5FDasync.c) */
+typedef struct H5FD_async_t H5FD_async_t;
+typedef struct H5FD_async_req_t H5FD_async_req_t;
+
+/* Prefetch window statistics for a file's asynchronous I/O engine */
+typedef struct H5FD_async_stats_t {
+    uint64_t    hits;           /* Reads served from the window */
+    uint64_t    misses;         /* Reads that went to the driver */
+    uint64_t    evictions;      /* Slots replaced before serving a read */
+    uint64_t    prefetches;     /* Prefetch reads submitted */
+    uint64_t    ghost_hits;     /* Misses on ranges a tier evicted, which moved the split */
+    unsigned    meta_slots;     /* Slots the metadata tier fills before evicting its own */
+} H5FD_async_stats_t;
+
+/* Superblock signature address cache statistics */
+typedef struct H5FD_sig_cache_stats_t {
+    uint64_t    hits;           /* Signature found at the remembered address */
+    uint64_t    misses;         /* Signature searched for */
+    uint64_t    evictions;      /* Entries replaced by another file's */
+    uint64_t    invalidations;  /* Entries dropped because the file changed */
+} H5FD_sig_cache_stats_t;
+
+/* VFD SWMR tick notification channel (defined in H5FDvfd_swmr_notify.c) */
+typedef struct H5FD_vfd_swmr_notify_t H5FD_vfd_swmr_notify_t;
+
+/* VFD SWMR writer tick pipeline & tick snapshots (defined in H5FDvfd_swmr_flush.c) */
+typedef struct H5FD_vfd_swmr_flush_t H5FD_vfd_swmr_flush_t;
+typedef struct H5FD_vfd_swmr_tick_t H5FD_vfd_swmr_tick_t;
+
+
 /*****************************/
 /* Library Private Variables */
 /*****************************/
 
+/* # of async I/O engines with a metadata prefetch window */
+H5_DLLVAR unsigned H5FD_async_nprefetch_g;
+
 
 /******************************/
 /* Library Private Prototypes */
@@ -191,6 +348,7 @@ struct H5F_t;
 
 H5_DLL int H5FD_term_interface(void);
 H5_DLL herr_t H5FD_locate_signature(H5FD_t *file, haddr_t *sig_addr);
+H5_DLL herr_t H5FD_sig_cache_get_stats(H5FD_sig_cache_stats_t *stats/*out*/);
 H5_DLL H5FD_class_t *H5FD_get_class(hid_t id);
 H5_DLL hsize_t H5FD_sb_size(H5FD_t *file);
 H5_DLL herr_t H5FD_sb_encode(H5FD_t *file, char *name/*out*/, uint8_t *buf);
@@ -220,6 +378,12 @@ H5_DLL herr_t H5FD_read(H5FD_t *file, H5FD_mem_t type, haddr_t addr,
     size_t size, void *buf/*out*/);
 H5_DLL herr_t H5FD_write(H5FD_t *file, H5FD_mem_t type, haddr_t addr,
     size_t size, const void *buf);
+H5_DLL herr_t H5FD_read_vector(H5FD_t *file, uint32_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    void *bufs[]/*out*/);
+H5_DLL herr_t H5FD_write_vector(H5FD_t *file, uint32_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    const void *bufs[]);
 H5_DLL herr_t H5FD_flush(H5FD_t *file, hbool_t closing);
 H5_DLL herr_t H5FD_truncate(H5FD_t *file, hbool_t closing);
 H5_DLL herr_t H5FD_lock(H5FD_t *file, hbool_t rw);
@@ -230,9 +394,99 @@ H5_DLL herr_t H5FD_set_base_addr(H5FD_t *file, haddr_t base_addr);
 H5_DLL haddr_t H5FD_get_base_addr(const H5FD_t *file);
 H5_DLL herr_t H5FD_set_paged_aggr(H5FD_t *file, hbool_t paged);
 
+/* Function prototypes for asynchronous I/O */
+H5_DLL H5FD_async_t *H5FD_async_open(H5FD_t *file, hid_t fapl_id);
+H5_DLL herr_t H5FD_async_close(H5FD_async_t *aio);
+H5_DLL herr_t H5FD_async_file_open(H5FD_t *file, hid_t fapl_id);
+H5_DLL herr_t H5FD_async_file_close(H5FD_t *file);
+H5_DLL H5FD_async_t *H5FD_async_get_engine(const H5FD_t *file);
+H5_DLL herr_t H5FD_read_async(H5FD_async_t *aio, H5FD_mem_t type, haddr_t addr,
+    size_t size, void *buf/*out*/, H5FD_async_req_t **req/*out*/);
+H5_DLL herr_t H5FD_write_async(H5FD_async_t *aio, H5FD_mem_t type, haddr_t addr,
+    size_t size, const void *buf, H5FD_async_req_t **req/*out*/);
+H5_DLL herr_t H5FD_async_test(H5FD_async_req_t *req, hbool_t *done/*out*/);
+H5_DLL herr_t H5FD_async_wait(H5FD_async_req_t *req);
+H5_DLL herr_t H5FD_async_prefetch(H5FD_async_t *aio, H5FD_mem_t type,
+    haddr_t addr, size_t size);
+H5_DLL htri_t H5FD_async_prefetch_read(const H5FD_t *file, H5FD_mem_t type,
+    haddr_t addr, size_t size, void *buf/*out*/);
+H5_DLL herr_t H5FD_async_prefetch_invalidate(const H5FD_t *file, haddr_t addr,
+    size_t size);
+H5_DLL void H5FD_async_prefetch_end_of_tick(void);
+H5_DLL herr_t H5FD_async_prefetch_sequential(const H5FD_t *file, H5FD_mem_t type,
+    haddr_t addr, size_t size);
+H5_DLL herr_t H5FD_async_get_stats(const H5FD_t *file, H5FD_async_stats_t *stats/*out*/);
+
 /* Function prototypes for VFD SWMR */
 H5_DLL herr_t H5FD_writer_end_of_tick();
 H5_DLL herr_t H5FD_reader_end_of_tick();
+H5_DLL herr_t H5FD_vfd_swmr_idx_hash_build(H5FD_vfd_swmr_idx_hash_t *hash,
+    const H5FD_vfd_swmr_idx_entry_t entries[], uint32_t nentries);
+H5_DLL herr_t H5FD_vfd_swmr_idx_hash_dest(H5FD_vfd_swmr_idx_hash_t *hash);
+H5_DLL H5FD_vfd_swmr_idx_entry_t *H5FD_vfd_swmr_idx_hash_lookup(
+    const H5FD_vfd_swmr_idx_hash_t *hash, H5FD_vfd_swmr_idx_entry_t entries[],
+    uint64_t page);
+H5_DLL herr_t H5FD_vfd_swmr_idx_hash_insert(H5FD_vfd_swmr_idx_hash_t *hash,
+    const H5FD_vfd_swmr_idx_entry_t entries[]);
+H5_DLL herr_t H5FD_vfd_swmr_idx_hash_touch(H5FD_vfd_swmr_idx_hash_t *hash,
+    const H5FD_vfd_swmr_idx_entry_t entries[],
+    H5FD_vfd_swmr_idx_entry_t *entry, uint64_t tick);
+H5_DLL herr_t H5FD_vfd_swmr_idx_hash_reset_changed(H5FD_vfd_swmr_idx_hash_t *hash);
+H5_DLL herr_t H5FD_vfd_swmr_idx_hash_remove_moved(H5FD_vfd_swmr_idx_hash_t *hash,
+    H5FD_vfd_swmr_idx_entry_t entries[], uint32_t *nentries);
+H5_DLL herr_t H5FD_vfd_swmr_idx_encode(uint8_t *image/*out*/, uint64_t tick,
+    const H5FD_vfd_swmr_idx_entry_t entries[], uint32_t nentries);
+H5_DLL herr_t H5FD_vfd_swmr_idx_decode(const uint8_t *image, size_t len,
+    uint64_t *tick/*out*/, H5FD_vfd_swmr_idx_entry_t entries[]/*out*/,
+    uint32_t *nentries/*out*/, uint32_t max_entries);
+H5_DLL herr_t H5FD_vfd_swmr_delta_prepare(H5FD_vfd_swmr_idx_hash_t *hash,
+    H5FD_vfd_swmr_idx_entry_t entries[]);
+H5_DLL hbool_t H5FD_vfd_swmr_delta_want_checkpoint(const H5FD_vfd_swmr_idx_hash_t *hash,
+    uint64_t tick, uint64_t checkpoint_tick);
+H5_DLL herr_t H5FD_vfd_swmr_delta_encode(uint8_t *image/*out*/,
+    const H5FD_vfd_swmr_idx_hash_t *hash, H5FD_vfd_swmr_idx_entry_t entries[],
+    uint64_t tick, uint64_t checkpoint_tick, haddr_t checkpoint_offset,
+    hsize_t checkpoint_length);
+H5_DLL herr_t H5FD_vfd_swmr_delta_decode(const uint8_t *image, size_t len,
+    H5FD_vfd_swmr_delta_t *delta/*out*/);
+H5_DLL herr_t H5FD_vfd_swmr_delta_apply(const H5FD_vfd_swmr_delta_t *delta,
+    H5FD_vfd_swmr_idx_entry_t entries[], uint32_t *nentries, uint32_t max_entries);
+H5_DLL herr_t H5FD_vfd_swmr_notify_open(const char *md_file_path,
+    hbool_t writer, H5FD_vfd_swmr_notify_t **chan/*out*/);
+H5_DLL herr_t H5FD_vfd_swmr_notify_close(H5FD_vfd_swmr_notify_t *chan);
+H5_DLL herr_t H5FD_vfd_swmr_notify_publish(H5FD_vfd_swmr_notify_t *chan,
+    uint64_t tick, haddr_t index_offset, hsize_t index_length);
+H5_DLL htri_t H5FD_vfd_swmr_notify_wait(H5FD_vfd_swmr_notify_t *chan,
+    uint64_t last_tick, uint64_t timeout_ns, uint64_t *tick/*out*/,
+    haddr_t *index_offset/*out*/, hsize_t *index_length/*out*/);
+H5_DLL herr_t H5FD_vfd_swmr_flush_open(int md_fd, uint32_t page_size,
+    unsigned max_lag, unsigned depth, H5FD_vfd_swmr_notify_t *chan,
+    H5FD_vfd_swmr_flush_t **fl/*out*/);
+H5_DLL herr_t H5FD_vfd_swmr_flush_close(H5FD_vfd_swmr_flush_t *fl);
+H5_DLL herr_t H5FD_vfd_swmr_flush_begin(H5FD_vfd_swmr_flush_t *fl, uint64_t tick,
+    H5FD_vfd_swmr_tick_t **snap/*out*/);
+H5_DLL herr_t H5FD_vfd_swmr_flush_add_page(H5FD_vfd_swmr_flush_t *fl,
+    H5FD_vfd_swmr_tick_t *snap, uint64_t md_file_page_offset, const void *image,
+    uint32_t length);
+H5_DLL herr_t H5FD_vfd_swmr_flush_submit(H5FD_vfd_swmr_flush_t *fl,
+    H5FD_vfd_swmr_tick_t *snap, const H5FD_vfd_swmr_idx_entry_t entries[],
+    uint32_t nentries, haddr_t index_offset);
+H5_DLL herr_t H5FD_vfd_swmr_flush_wait(H5FD_vfd_swmr_flush_t *fl, uint64_t tick,
+    uint64_t *flushed_tick/*out*/);
+H5_DLL herr_t H5FD_vfd_swmr_md_space_init(H5FD_vfd_swmr_md_space_t *sp,
+    uint32_t page_size, uint64_t md_pages_reserved, uint64_t max_lag);
+H5_DLL herr_t H5FD_vfd_swmr_md_space_dest(H5FD_vfd_swmr_md_space_t *sp);
+H5_DLL herr_t H5FD_vfd_swmr_md_space_alloc(H5FD_vfd_swmr_md_space_t *sp,
+    uint64_t tick, uint32_t length, uint64_t *page/*out*/);
+H5_DLL herr_t H5FD_vfd_swmr_md_space_free(H5FD_vfd_swmr_md_space_t *sp,
+    uint64_t tick, uint64_t page, uint32_t length);
+H5_DLL herr_t H5FD_vfd_swmr_md_space_compact(H5FD_vfd_swmr_md_space_t *sp,
+    H5FD_vfd_swmr_idx_hash_t *hash, H5FD_vfd_swmr_idx_entry_t entries[],
+    uint32_t nentries, uint64_t tick, uint32_t max_moves, uint32_t moved[]/*out*/,
+    uint32_t *nmoved/*out*/);
+H5_DLL herr_t H5FD_vfd_swmr_idx_diff(const H5FD_vfd_swmr_idx_entry_t old_entries[],
+    uint32_t old_n, const H5FD_vfd_swmr_idx_entry_t new_entries[],
+    uint32_t new_n, uint64_t changed_pages[]/*out*/, uint32_t *nchanged/*out*/);
 
 /* Function prototypes for MPI based VFDs*/
 #ifdef H5_HAVE_PARALLEL
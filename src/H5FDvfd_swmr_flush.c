@@ -0,0 +1,611 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5FDvfd_swmr_flush.c
+ *
+ * Purpose:		Pipelined end of tick for the VFD SWMR writer.
+ *
+ *                      At the end of tick T the writer copies the metadata
+ *                      pages changed in T into a snapshot with
+ *                      H5FD_vfd_swmr_flush_begin() /
+ *                      H5FD_vfd_swmr_flush_add_page(), and hands it, with
+ *                      the index for T, to H5FD_vfd_swmr_flush_submit().
+ *                      A flusher thread then writes the pages, the index
+ *                      and, last, the header to the metadata file, and
+ *                      publishes the tick to readers, while the writer
+ *                      goes on with tick T + 1.
+ *
+ *                      Up to DEPTH snapshots (1 for plain double
+ *                      buffering) may be queued or being written.  Since
+ *                      readers would otherwise fall behind by more than
+ *                      max_lag ticks, DEPTH is kept below max_lag and
+ *                      H5FD_vfd_swmr_flush_begin() blocks the writer while
+ *                      all DEPTH snapshots are still in the flusher's
+ *                      hands.
+ *
+ *                      Without pthreads each snapshot is written when it
+ *                      is submitted.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+#include "H5FDmodule.h"         /* This source code file is part of the H5FD module */
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5FDpkg.h"		/* File Drivers				*/
+#include "H5MMprivate.h"        /* Memory management                    */
+
+#ifdef H5_HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* H5_HAVE_PTHREAD_H */
+
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Upper limit on the number of snapshots in the flusher's hands */
+#define H5FD_VFD_SWMR_FLUSH_MAX_DEPTH   8
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+/* Changed metadata pages, index & header of one tick */
+struct H5FD_vfd_swmr_tick_t {
+    uint64_t    tick;           /* Tick of the snapshot */
+    uint8_t    *images;         /* Page images, back to back */
+    size_t      images_size;    /* # of bytes used in images */
+    size_t      images_alloc;   /* # of bytes allocated for images */
+    haddr_t    *offsets;        /* Metadata file offsets of the pages, in bytes */
+    uint32_t   *lengths;        /* Lengths of the pages, in bytes */
+    uint32_t    npages;         /* # of pages */
+    uint32_t    alloc_pages;    /* # of pages allocated for offsets & lengths */
+    uint8_t    *index;          /* Encoded index */
+    size_t      index_alloc;    /* # of bytes allocated for index */
+    haddr_t     index_offset;   /* Metadata file offset of the index */
+    hsize_t     index_length;   /* Length of the index */
+    uint8_t     hdr[H5FD_MD_HEADER_SIZE];       /* Encoded header */
+};
+
+/* Tick pipeline of a VFD SWMR writer */
+struct H5FD_vfd_swmr_flush_t {
+    int         md_fd;          /* Metadata file descriptor */
+    uint32_t    page_size;      /* Page size of the HDF5 file */
+    H5FD_vfd_swmr_notify_t *chan;       /* Channel to publish ticks on, or NULL */
+    unsigned    depth;          /* Max. # of snapshots queued or being written */
+    unsigned    nsnaps;         /* # of snapshots in the ring: depth + 1 */
+    H5FD_vfd_swmr_tick_t snaps[H5FD_VFD_SWMR_FLUSH_MAX_DEPTH + 1];  /* Ring of snapshots */
+    unsigned    fill;           /* Ring position of the snapshot to fill next */
+    unsigned    head;           /* Ring position of the oldest queued snapshot */
+    unsigned    nqueued;        /* # of snapshots queued or being written */
+    hbool_t     filling;        /* Whether snaps[fill] is handed out */
+    uint64_t    flushed_tick;   /* Last tick written & published */
+    int         err;            /* errno value of a failed write, 0 otherwise */
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_t mutex;      /* Protects the fields from 'head' on */
+    pthread_cond_t queue_cv;    /* Signalled when a snapshot is queued or on shutdown */
+    pthread_cond_t done_cv;     /* Signalled when a snapshot is written */
+    pthread_t   flusher;        /* Flusher thread */
+    hbool_t     started;        /* Whether the flusher thread is running */
+    hbool_t     shutdown;       /* Whether the flusher should exit */
+#endif /* H5_HAVE_PTHREAD_H */
+};
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static int H5FD__vfd_swmr_flush_pwrite(int fd, const uint8_t *buf, size_t size,
+    haddr_t offset);
+static int H5FD__vfd_swmr_flush_write(H5FD_vfd_swmr_flush_t *fl,
+    const H5FD_vfd_swmr_tick_t *snap);
+static void H5FD__vfd_swmr_flush_done(H5FD_vfd_swmr_flush_t *fl,
+    const H5FD_vfd_swmr_tick_t *snap, int err);
+#ifdef H5_HAVE_PTHREAD_H
+static void *H5FD__vfd_swmr_flusher(void *_fl);
+#endif /* H5_HAVE_PTHREAD_H */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_flush_open
+ *
+ * Purpose:     Start the tick pipeline of a writer, for the metadata file
+ *              MD_FD of an HDF5 file with pages of PAGE_SIZE bytes.
+ *              DEPTH snapshots may be in the flusher's hands at once,
+ *              clamped to [1, MAX_LAG - 1]; ticks are published on CHAN
+ *              too, if it isn't NULL.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_flush_open(int md_fd, uint32_t page_size, unsigned max_lag,
+    unsigned depth, H5FD_vfd_swmr_notify_t *chan, H5FD_vfd_swmr_flush_t **flp)
+{
+    H5FD_vfd_swmr_flush_t *fl = NULL;   /* New pipeline */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(md_fd >= 0);
+    HDassert(page_size > 0);
+    HDassert(max_lag >= 3);
+    HDassert(flp);
+
+    if(NULL == (fl = (H5FD_vfd_swmr_flush_t *)H5MM_calloc(sizeof(H5FD_vfd_swmr_flush_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for tick pipeline")
+    fl->md_fd = md_fd;
+    fl->page_size = page_size;
+    fl->chan = chan;
+    fl->depth = MIN3(MAX(depth, 1), max_lag - 1, H5FD_VFD_SWMR_FLUSH_MAX_DEPTH);
+    fl->nsnaps = fl->depth + 1;
+
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_init(&fl->mutex, NULL);
+    pthread_cond_init(&fl->queue_cv, NULL);
+    pthread_cond_init(&fl->done_cv, NULL);
+    if(pthread_create(&fl->flusher, NULL, H5FD__vfd_swmr_flusher, fl))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't start tick flusher thread")
+    fl->started = TRUE;
+#endif /* H5_HAVE_PTHREAD_H */
+
+    *flp = fl;
+    fl = NULL;
+
+done:
+    if(fl) {
+#ifdef H5_HAVE_PTHREAD_H
+        pthread_cond_destroy(&fl->done_cv);
+        pthread_cond_destroy(&fl->queue_cv);
+        pthread_mutex_destroy(&fl->mutex);
+#endif /* H5_HAVE_PTHREAD_H */
+        fl = (H5FD_vfd_swmr_flush_t *)H5MM_xfree(fl);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_flush_open() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_flush_close
+ *
+ * Purpose:     Wait for the submitted snapshots to be written, stop the
+ *              flusher and free the pipeline.  The metadata file and the
+ *              channel are left open.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL, also when a snapshot couldn't be
+ *                              written
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_flush_close(H5FD_vfd_swmr_flush_t *fl)
+{
+    unsigned u;                         /* Local index variable */
+    int err;                            /* Write error */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(fl);
+    HDassert(!fl->filling);
+
+#ifdef H5_HAVE_PTHREAD_H
+    /* The flusher drains the queue before it exits */
+    if(fl->started) {
+        pthread_mutex_lock(&fl->mutex);
+        fl->shutdown = TRUE;
+        pthread_cond_signal(&fl->queue_cv);
+        pthread_mutex_unlock(&fl->mutex);
+        pthread_join(fl->flusher, NULL);
+    } /* end if */
+    pthread_cond_destroy(&fl->done_cv);
+    pthread_cond_destroy(&fl->queue_cv);
+    pthread_mutex_destroy(&fl->mutex);
+#endif /* H5_HAVE_PTHREAD_H */
+    err = fl->err;
+
+    for(u = 0; u < fl->nsnaps; u++) {
+        H5MM_xfree(fl->snaps[u].images);
+        H5MM_xfree(fl->snaps[u].offsets);
+        H5MM_xfree(fl->snaps[u].lengths);
+        H5MM_xfree(fl->snaps[u].index);
+    } /* end for */
+    H5MM_xfree(fl);
+
+    if(err)
+        HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "can't write metadata file")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_flush_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_flush_begin
+ *
+ * Purpose:     Get an empty snapshot for tick TICK, waiting while DEPTH
+ *              snapshots are still queued or being written.  This is the
+ *              pipeline's backpressure on the writer.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL, also when an earlier snapshot
+ *                              couldn't be written
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_flush_begin(H5FD_vfd_swmr_flush_t *fl, uint64_t tick,
+    H5FD_vfd_swmr_tick_t **snapp)
+{
+    H5FD_vfd_swmr_tick_t *snap;         /* Snapshot handed out */
+    int err;                            /* Write error */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(fl);
+    HDassert(!fl->filling);
+    HDassert(snapp);
+
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_lock(&fl->mutex);
+    while(fl->nqueued == fl->depth && 0 == fl->err)
+        pthread_cond_wait(&fl->done_cv, &fl->mutex);
+#endif /* H5_HAVE_PTHREAD_H */
+    err = fl->err;
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_unlock(&fl->mutex);
+#endif /* H5_HAVE_PTHREAD_H */
+    if(err)
+        HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "can't write metadata file")
+
+    snap = &fl->snaps[fl->fill];
+    snap->tick = tick;
+    snap->images_size = 0;
+    snap->npages = 0;
+    fl->filling = TRUE;
+    *snapp = snap;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_flush_begin() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_flush_add_page
+ *
+ * Purpose:     Copy the LENGTH bytes of a changed metadata page (or multi
+ *              page entry) at page MD_FILE_PAGE_OFFSET of the metadata
+ *              file into SNAP.  The buffers of a snapshot are kept from
+ *              tick to tick, so this only allocates while they grow.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_flush_add_page(H5FD_vfd_swmr_flush_t *fl, H5FD_vfd_swmr_tick_t *snap,
+    uint64_t md_file_page_offset, const void *image, uint32_t length)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(fl);
+    HDassert(fl->filling && snap == &fl->snaps[fl->fill]);
+    HDassert(image);
+
+    if(snap->npages == snap->alloc_pages) {
+        uint32_t alloc_pages = MAX(2 * snap->alloc_pages, 64);
+        haddr_t *offsets;
+        uint32_t *lengths;
+
+        if(NULL == (offsets = (haddr_t *)H5MM_realloc(snap->offsets, alloc_pages * sizeof(haddr_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for snapshot pages")
+        snap->offsets = offsets;
+        if(NULL == (lengths = (uint32_t *)H5MM_realloc(snap->lengths, alloc_pages * sizeof(uint32_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for snapshot pages")
+        snap->lengths = lengths;
+        snap->alloc_pages = alloc_pages;
+    } /* end if */
+
+    if(snap->images_size + length > snap->images_alloc) {
+        size_t images_alloc = MAX(2 * snap->images_alloc, snap->images_size + length);
+        uint8_t *images;
+
+        if(NULL == (images = (uint8_t *)H5MM_realloc(snap->images, images_alloc)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for snapshot pages")
+        snap->images = images;
+        snap->images_alloc = images_alloc;
+    } /* end if */
+
+    HDmemcpy(snap->images + snap->images_size, image, (size_t)length);
+    snap->images_size += length;
+    snap->offsets[snap->npages] = (haddr_t)(md_file_page_offset * fl->page_size);
+    snap->lengths[snap->npages] = length;
+    snap->npages++;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_flush_add_page() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_flush_submit
+ *
+ * Purpose:     Encode the NENTRIES entries of the index for SNAP's tick,
+ *              to be written at INDEX_OFFSET of the metadata file, and
+ *              the header pointing at it, and queue SNAP for the flusher.
+ *              ENTRIES may change again as soon as this returns.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_flush_submit(H5FD_vfd_swmr_flush_t *fl, H5FD_vfd_swmr_tick_t *snap,
+    const H5FD_vfd_swmr_idx_entry_t entries[], uint32_t nentries, haddr_t index_offset)
+{
+    size_t index_length = H5FD_MD_INDEX_SIZE((size_t)nentries);
+    uint8_t *p;                         /* Pointer into header */
+    uint32_t metadata_chksum;           /* Computed metadata checksum value */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(fl);
+    HDassert(fl->filling && snap == &fl->snaps[fl->fill]);
+    HDassert(entries || 0 == nentries);
+
+    if(index_length > snap->index_alloc) {
+        uint8_t *index;
+
+        if(NULL == (index = (uint8_t *)H5MM_realloc(snap->index, index_length)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for snapshot index")
+        snap->index = index;
+        snap->index_alloc = index_length;
+    } /* end if */
+    H5FD_vfd_swmr_idx_encode(snap->index, snap->tick, entries, nentries);
+    snap->index_offset = index_offset;
+    snap->index_length = (hsize_t)index_length;
+
+    p = snap->hdr;
+    HDmemcpy(p, H5FD_MD_HEADER_MAGIC, (size_t)H5_SIZEOF_MAGIC);
+    p += H5_SIZEOF_MAGIC;
+    UINT32ENCODE(p, fl->page_size);
+    UINT64ENCODE(p, snap->tick);
+    UINT64ENCODE(p, snap->index_offset);
+    UINT64ENCODE(p, snap->index_length);
+    metadata_chksum = H5_checksum_metadata_fast(snap->hdr, (size_t)(p - snap->hdr), 0);
+    UINT32ENCODE(p, metadata_chksum);
+    HDassert((size_t)(p - snap->hdr) == H5FD_MD_HEADER_SIZE);
+
+    fl->filling = FALSE;
+    fl->fill = (fl->fill + 1) % fl->nsnaps;
+
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_lock(&fl->mutex);
+    fl->nqueued++;
+    pthread_cond_signal(&fl->queue_cv);
+    pthread_mutex_unlock(&fl->mutex);
+#else /* H5_HAVE_PTHREAD_H */
+    fl->nqueued++;
+    H5FD__vfd_swmr_flush_done(fl, snap, H5FD__vfd_swmr_flush_write(fl, snap));
+    if(fl->err)
+        HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "can't write metadata file")
+#endif /* H5_HAVE_PTHREAD_H */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_flush_submit() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_flush_wait
+ *
+ * Purpose:     Wait for the snapshots up to tick TICK to be written and
+ *              published, e.g. before the writer reuses metadata file
+ *              space freed in TICK.  *FLUSHED_TICK, if not NULL, is set to
+ *              the last tick published.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL, when a snapshot couldn't be written
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_flush_wait(H5FD_vfd_swmr_flush_t *fl, uint64_t tick,
+    uint64_t *flushed_tick)
+{
+    int err;                            /* Write error */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(fl);
+
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_lock(&fl->mutex);
+    while(fl->flushed_tick < tick && fl->nqueued > 0 && 0 == fl->err)
+        pthread_cond_wait(&fl->done_cv, &fl->mutex);
+#endif /* H5_HAVE_PTHREAD_H */
+    err = fl->err;
+    if(flushed_tick)
+        *flushed_tick = fl->flushed_tick;
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_unlock(&fl->mutex);
+#endif /* H5_HAVE_PTHREAD_H */
+    if(err)
+        HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "can't write metadata file")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_flush_wait() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_flush_pwrite
+ *
+ * Purpose:     Write SIZE bytes of BUF at OFFSET of FD, retrying short
+ *              and interrupted writes.
+ *
+ * Return:      0 on success, the errno value otherwise
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__vfd_swmr_flush_pwrite(int fd, const uint8_t *buf, size_t size, haddr_t offset)
+{
+    while(size > 0) {
+        ssize_t nbytes = HDpwrite(fd, buf, size, (HDoff_t)offset);
+
+        if(nbytes < 0) {
+            if(EINTR == errno)
+                continue;
+            return errno;
+        } /* end if */
+        if(0 == nbytes)
+            return EIO;
+        buf += nbytes;
+        size -= (size_t)nbytes;
+        offset += (haddr_t)nbytes;
+    } /* end while */
+
+    return 0;
+} /* end H5FD__vfd_swmr_flush_pwrite() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_flush_write
+ *
+ * Purpose:     Write a snapshot to the metadata file: the pages and the
+ *              index first, then the header, so that a reader never finds
+ *              a header pointing at a tick that isn't all there.  Runs on
+ *              the flusher thread, so it makes no library calls.
+ *
+ * Return:      0 on success, the errno value otherwise
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__vfd_swmr_flush_write(H5FD_vfd_swmr_flush_t *fl, const H5FD_vfd_swmr_tick_t *snap)
+{
+    const uint8_t *image = snap->images;
+    uint32_t u;
+    int err;
+
+    for(u = 0; u < snap->npages; u++) {
+        if(0 != (err = H5FD__vfd_swmr_flush_pwrite(fl->md_fd, image, (size_t)snap->lengths[u], snap->offsets[u])))
+            return err;
+        image += snap->lengths[u];
+    } /* end for */
+    if(0 != (err = H5FD__vfd_swmr_flush_pwrite(fl->md_fd, snap->index, (size_t)snap->index_length, snap->index_offset)))
+        return err;
+
+    return H5FD__vfd_swmr_flush_pwrite(fl->md_fd, snap->hdr, (size_t)H5FD_MD_HEADER_SIZE, (haddr_t)0);
+} /* end H5FD__vfd_swmr_flush_write() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_flush_done
+ *
+ * Purpose:     Publish a written snapshot, or keep its error, and retire
+ *              it from the queue.  Called with the mutex held.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__vfd_swmr_flush_done(H5FD_vfd_swmr_flush_t *fl, const H5FD_vfd_swmr_tick_t *snap, int err)
+{
+    if(err) {
+        if(0 == fl->err)
+            fl->err = err;
+    } /* end if */
+    else if(0 == fl->err) {
+        /* Only touches the shared page, so it's fine off the main thread */
+        if(fl->chan)
+            H5FD_vfd_swmr_notify_publish(fl->chan, snap->tick, snap->index_offset, snap->index_length);
+        fl->flushed_tick = snap->tick;
+    } /* end else-if */
+
+    fl->head = (fl->head + 1) % fl->nsnaps;
+    fl->nqueued--;
+} /* end H5FD__vfd_swmr_flush_done() */
+
+#ifdef H5_HAVE_PTHREAD_H
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_flusher
+ *
+ * Purpose:     Flusher thread: write queued snapshots in tick order until
+ *              shut down with an empty queue.  Once a write fails, later
+ *              snapshots are dropped unwritten.
+ *
+ * Return:      NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD__vfd_swmr_flusher(void *_fl)
+{
+    H5FD_vfd_swmr_flush_t *fl = (H5FD_vfd_swmr_flush_t *)_fl;
+
+    pthread_mutex_lock(&fl->mutex);
+    for(;;) {
+        const H5FD_vfd_swmr_tick_t *snap;
+        int err = 0;
+
+        while(0 == fl->nqueued && !fl->shutdown)
+            pthread_cond_wait(&fl->queue_cv, &fl->mutex);
+        if(0 == fl->nqueued)
+            break;
+
+        /* The writer doesn't touch queued snapshots, so write unlocked */
+        snap = &fl->snaps[fl->head];
+        if(0 == fl->err) {
+            pthread_mutex_unlock(&fl->mutex);
+            err = H5FD__vfd_swmr_flush_write(fl, snap);
+            pthread_mutex_lock(&fl->mutex);
+        } /* end if */
+
+        H5FD__vfd_swmr_flush_done(fl, snap, err);
+        pthread_cond_broadcast(&fl->done_cv);
+    } /* end for */
+    pthread_mutex_unlock(&fl->mutex);
+
+    return NULL;
+} /* end H5FD__vfd_swmr_flusher() */
+
+#endif /* H5_HAVE_PTHREAD_H */
@@ -0,0 +1,926 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5FDvfd_swmr_idx.c
+ *
+ * Purpose:		In-memory support routines for the VFD SWMR metadata
+ *                      file index.
+ *
+ *                      The index itself is the flat array of
+ *                      H5FD_vfd_swmr_idx_entry_t sorted by HDF5 page offset
+ *                      that is written to the metadata file as 'VIDX'.  The
+ *                      routines here keep an open-addressing hash table over
+ *                      that array, so that page lookups are O(1), plus the
+ *                      lists of entries the writer changed and removed
+ *                      since the last full index was written, so that end
+ *                      of tick processing is proportional to the number of
+ *                      changed entries.
+ *
+ *                      Between full indices ("checkpoints") the writer
+ *                      emits 'VDLT' delta records holding only those
+ *                      entries.  A delta is relative to the checkpoint, not
+ *                      to the previous tick, so a reader that missed ticks
+ *                      still only needs the latest record.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+#include "H5FDmodule.h"         /* This source code file is part of the H5FD module */
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5FDpkg.h"		/* File Drivers				*/
+#include "H5MMprivate.h"        /* Memory management                    */
+
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Smallest hash table allocated */
+#define H5FD_VFD_SWMR_IDX_HASH_MIN_SLOTS        64
+
+/* Empty hash table slot */
+#define H5FD_VFD_SWMR_IDX_HASH_EMPTY            0
+
+/* Fibonacci hashing of a page offset into a table of 2^(64 - SHIFT) slots */
+#define H5FD_VFD_SWMR_IDX_HASH(PAGE, SHIFT)                                 \
+    ((uint32_t)(((uint64_t)(PAGE) * (uint64_t)0x9E3779B97F4A7C15ULL) >> (SHIFT)))
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static herr_t H5FD__vfd_swmr_idx_hash_resize(H5FD_vfd_swmr_idx_hash_t *hash,
+    const H5FD_vfd_swmr_idx_entry_t entries[], uint32_t min_entries);
+static void H5FD__vfd_swmr_idx_hash_put(H5FD_vfd_swmr_idx_hash_t *hash,
+    uint64_t page, uint32_t pos);
+static int H5FD__vfd_swmr_page_cmp(const void *_p1, const void *_p2);
+static uint32_t H5FD__vfd_swmr_page_uniq(uint64_t pages[], uint32_t npages);
+
+
+/*********************/
+/* Package Variables */
+/*********************/
+
+
+/*****************************/
+/* Library Private Variables */
+/*****************************/
+
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_idx_hash_put
+ *
+ * Purpose:     Store entry position POS for PAGE in the hash table, using
+ *              linear probing.  The table must have a free slot.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__vfd_swmr_idx_hash_put(H5FD_vfd_swmr_idx_hash_t *hash, uint64_t page,
+    uint32_t pos)
+{
+    uint32_t mask = hash->nslots - 1;   /* Mask for wrapping probes */
+    uint32_t slot;                      /* Slot being probed */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(slot = H5FD_VFD_SWMR_IDX_HASH(page, hash->shift); hash->slots[slot] != H5FD_VFD_SWMR_IDX_HASH_EMPTY; slot = (slot + 1) & mask)
+        ;
+    hash->slots[slot] = pos + 1;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__vfd_swmr_idx_hash_put() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_idx_hash_resize
+ *
+ * Purpose:     Make sure the hash table can hold MIN_ENTRIES entries at a
+ *              load factor of at most 1/2, and rehash the first
+ *              hash->nentries entries of ENTRIES if it had to grow.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__vfd_swmr_idx_hash_resize(H5FD_vfd_swmr_idx_hash_t *hash,
+    const H5FD_vfd_swmr_idx_entry_t entries[], uint32_t min_entries)
+{
+    uint32_t nslots;                    /* New # of slots */
+    unsigned shift;                     /* New hash shift */
+    uint32_t u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(hash->slots && (uint64_t)min_entries * 2 <= hash->nslots)
+        HGOTO_DONE(SUCCEED)
+
+    for(nslots = H5FD_VFD_SWMR_IDX_HASH_MIN_SLOTS, shift = 64 - 6; (uint64_t)nslots < (uint64_t)min_entries * 2; nslots <<= 1, shift--)
+        if(nslots >= ((uint32_t)1 << 31))
+            HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "too many metadata file index entries")
+
+    hash->slots = (uint32_t *)H5MM_xfree(hash->slots);
+    if(NULL == (hash->slots = (uint32_t *)H5MM_calloc(nslots * sizeof(uint32_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for metadata file index hash")
+    hash->nslots = nslots;
+    hash->shift = shift;
+
+    for(u = 0; u < hash->nentries; u++)
+        H5FD__vfd_swmr_idx_hash_put(hash, entries[u].hdf5_page_offset, u);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vfd_swmr_idx_hash_resize() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_hash_build
+ *
+ * Purpose:     (Re)build the hash table over the NENTRIES entries of a
+ *              metadata file index, e.g. after a reader has decoded a new
+ *              index or the writer has sorted entries added during a tick.
+ *              The list of changed entries is cleared.
+ *
+ *              The hash table refers to entries by position, so it must be
+ *              rebuilt whenever entries move within the array.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_hash_build(H5FD_vfd_swmr_idx_hash_t *hash,
+    const H5FD_vfd_swmr_idx_entry_t entries[], uint32_t nentries)
+{
+    uint32_t u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(hash);
+    HDassert(entries || 0 == nentries);
+
+    /* Reset the table */
+    hash->nentries = 0;
+    if(H5FD__vfd_swmr_idx_hash_resize(hash, entries, nentries) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTALLOC, FAIL, "can't size metadata file index hash")
+    HDmemset(hash->slots, 0, hash->nslots * sizeof(uint32_t));
+
+    for(u = 0; u < nentries; u++)
+        H5FD__vfd_swmr_idx_hash_put(hash, entries[u].hdf5_page_offset, u);
+    hash->nentries = nentries;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_idx_hash_build() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_hash_dest
+ *
+ * Purpose:     Release the memory held by a metadata file index hash.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_hash_dest(H5FD_vfd_swmr_idx_hash_t *hash)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(hash);
+
+    hash->slots = (uint32_t *)H5MM_xfree(hash->slots);
+    hash->changed = (uint64_t *)H5MM_xfree(hash->changed);
+    hash->removed = (uint64_t *)H5MM_xfree(hash->removed);
+    HDmemset(hash, 0, sizeof(*hash));
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_idx_hash_dest() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_hash_lookup
+ *
+ * Purpose:     Find the entry for HDF5 file page PAGE in the metadata
+ *              file index ENTRIES.
+ *
+ * Return:      Success:        Pointer to the entry
+ *              Failure:        NULL (PAGE is not in the index)
+ *
+ *-------------------------------------------------------------------------
+ */
+H5FD_vfd_swmr_idx_entry_t *
+H5FD_vfd_swmr_idx_hash_lookup(const H5FD_vfd_swmr_idx_hash_t *hash,
+    H5FD_vfd_swmr_idx_entry_t entries[], uint64_t page)
+{
+    uint32_t mask;                      /* Mask for wrapping probes */
+    uint32_t slot;                      /* Slot being probed */
+    H5FD_vfd_swmr_idx_entry_t *ret_value = NULL;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(hash);
+
+    if(hash->nentries > 0) {
+        mask = hash->nslots - 1;
+        for(slot = H5FD_VFD_SWMR_IDX_HASH(page, hash->shift); hash->slots[slot] != H5FD_VFD_SWMR_IDX_HASH_EMPTY; slot = (slot + 1) & mask)
+            if(entries[hash->slots[slot] - 1].hdf5_page_offset == page) {
+                ret_value = &entries[hash->slots[slot] - 1];
+                break;
+            } /* end if */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_idx_hash_lookup() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_hash_insert
+ *
+ * Purpose:     Add the entry the writer has just appended at position
+ *              hash->nentries of ENTRIES to the hash table.  Lookups work
+ *              immediately; the array must be sorted and the table rebuilt
+ *              with H5FD_vfd_swmr_idx_hash_build() before the index is
+ *              written to the metadata file.  New entries should also be
+ *              passed to H5FD_vfd_swmr_idx_hash_touch().
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_hash_insert(H5FD_vfd_swmr_idx_hash_t *hash,
+    const H5FD_vfd_swmr_idx_entry_t entries[])
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(hash);
+    HDassert(entries);
+
+    if(H5FD__vfd_swmr_idx_hash_resize(hash, entries, hash->nentries + 1) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTALLOC, FAIL, "can't grow metadata file index hash")
+
+    H5FD__vfd_swmr_idx_hash_put(hash, entries[hash->nentries].hdf5_page_offset, hash->nentries);
+    hash->nentries++;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_idx_hash_insert() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_hash_touch
+ *
+ * Purpose:     Record that the writer changed ENTRY during tick TICK.
+ *              The entry's tick_of_last_change is set, and its page offset
+ *              is added to the list of changed entries the first time it
+ *              is touched in a tick.  The list is emptied with
+ *              H5FD_vfd_swmr_idx_hash_reset_changed() once the writer has
+ *              written a full index.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_hash_touch(H5FD_vfd_swmr_idx_hash_t *hash,
+    const H5FD_vfd_swmr_idx_entry_t entries[],
+    H5FD_vfd_swmr_idx_entry_t *entry, uint64_t tick)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(hash);
+    HDassert(entry >= entries && entry < entries + hash->nentries);
+
+    if(entry->tick_of_last_change != tick) {
+        if(hash->nchanged >= hash->alloc_changed) {
+            uint32_t na = MAX(H5FD_VFD_SWMR_IDX_HASH_MIN_SLOTS, hash->alloc_changed * 2);
+            uint64_t *x;
+
+            if(NULL == (x = (uint64_t *)H5MM_realloc(hash->changed, na * sizeof(uint64_t))))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for changed entry list")
+            hash->changed = x;
+            hash->alloc_changed = na;
+        } /* end if */
+
+        hash->changed[hash->nchanged++] = entry->hdf5_page_offset;
+        entry->tick_of_last_change = tick;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_idx_hash_touch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_hash_reset_changed
+ *
+ * Purpose:     Empty the lists of changed & removed entries, after the
+ *              writer has written a full index (checkpoint).
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_hash_reset_changed(H5FD_vfd_swmr_idx_hash_t *hash)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(hash);
+
+    hash->nchanged = 0;
+    hash->nremoved = 0;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_idx_hash_reset_changed() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_diff
+ *
+ * Purpose:     Compare two metadata file indices, both sorted by HDF5 page
+ *              offset, and return in CHANGED_PAGES the HDF5 page offsets
+ *              of the entries that were added, removed, or moved to a
+ *              different place in the metadata file.  CHANGED_PAGES must
+ *              have room for OLD_N + NEW_N page offsets.
+ *
+ *              This is a single merge pass over the two arrays, so a
+ *              reader's end of tick costs O(N) rather than a search of the
+ *              old index for every entry of the new one.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_diff(const H5FD_vfd_swmr_idx_entry_t old_entries[],
+    uint32_t old_n, const H5FD_vfd_swmr_idx_entry_t new_entries[],
+    uint32_t new_n, uint64_t changed_pages[], uint32_t *nchanged)
+{
+    uint32_t i = 0, j = 0;              /* Positions in the old & new indices */
+    uint32_t n = 0;                     /* # of changed pages found */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(old_entries || 0 == old_n);
+    HDassert(new_entries || 0 == new_n);
+    HDassert(changed_pages);
+    HDassert(nchanged);
+
+    while(i < old_n || j < new_n) {
+        if(j == new_n || (i < old_n && old_entries[i].hdf5_page_offset < new_entries[j].hdf5_page_offset))
+            /* Removed */
+            changed_pages[n++] = old_entries[i++].hdf5_page_offset;
+        else if(i == old_n || new_entries[j].hdf5_page_offset < old_entries[i].hdf5_page_offset)
+            /* Added */
+            changed_pages[n++] = new_entries[j++].hdf5_page_offset;
+        else {
+            /* In both: changed if the page (or its length) moved */
+            if(old_entries[i].md_file_page_offset != new_entries[j].md_file_page_offset
+                    || old_entries[i].length != new_entries[j].length)
+                changed_pages[n++] = new_entries[j].hdf5_page_offset;
+            i++;
+            j++;
+        } /* end else */
+    } /* end while */
+
+    *nchanged = n;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_idx_diff() */
+
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_page_cmp
+ *
+ * Purpose:     Comparison callback for sorting page offsets.
+ *
+ * Return:      -1, 0 or 1
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__vfd_swmr_page_cmp(const void *_p1, const void *_p2)
+{
+    uint64_t p1 = *(const uint64_t *)_p1;
+    uint64_t p2 = *(const uint64_t *)_p2;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    FUNC_LEAVE_NOAPI(p1 < p2 ? -1 : (p1 > p2 ? 1 : 0))
+} /* end H5FD__vfd_swmr_page_cmp() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_page_uniq
+ *
+ * Purpose:     Sort a list of page offsets and drop duplicates.
+ *
+ * Return:      # of page offsets left in the list
+ *
+ *-------------------------------------------------------------------------
+ */
+static uint32_t
+H5FD__vfd_swmr_page_uniq(uint64_t pages[], uint32_t npages)
+{
+    uint32_t u, v;                      /* Local index variables */
+    uint32_t ret_value = npages;        /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(npages > 1) {
+        HDqsort(pages, (size_t)npages, sizeof(uint64_t), H5FD__vfd_swmr_page_cmp);
+        for(u = 1, v = 0; u < npages; u++)
+            if(pages[u] != pages[v])
+                pages[++v] = pages[u];
+        ret_value = v + 1;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vfd_swmr_page_uniq() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_hash_remove_moved
+ *
+ * Purpose:     Drop the entries flagged is_moved_to_hdf5_file from the
+ *              writer's index, record their pages as removed and rebuild
+ *              the hash table once for the whole batch.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_hash_remove_moved(H5FD_vfd_swmr_idx_hash_t *hash,
+    H5FD_vfd_swmr_idx_entry_t entries[], uint32_t *nentries)
+{
+    uint32_t u, v;                      /* Local index variables */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(hash);
+    HDassert(entries);
+    HDassert(nentries);
+
+    for(u = 0, v = 0; u < *nentries; u++) {
+        if(entries[u].is_moved_to_hdf5_file) {
+            if(hash->nremoved >= hash->alloc_removed) {
+                uint32_t na = MAX(H5FD_VFD_SWMR_IDX_HASH_MIN_SLOTS, hash->alloc_removed * 2);
+                uint64_t *x;
+
+                if(NULL == (x = (uint64_t *)H5MM_realloc(hash->removed, na * sizeof(uint64_t))))
+                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for removed entry list")
+                hash->removed = x;
+                hash->alloc_removed = na;
+            } /* end if */
+            hash->removed[hash->nremoved++] = entries[u].hdf5_page_offset;
+        } /* end if */
+        else {
+            if(u != v)
+                entries[v] = entries[u];
+            v++;
+        } /* end else */
+    } /* end for */
+
+    if(v != *nentries) {
+        *nentries = v;
+        if(H5FD_vfd_swmr_idx_hash_build(hash, entries, v) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't rebuild metadata file index hash")
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_idx_hash_remove_moved() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_encode
+ *
+ * Purpose:     Encode a full metadata file index (a checkpoint) into
+ *              IMAGE, which must hold H5FD_MD_INDEX_SIZE(NENTRIES) bytes.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_encode(uint8_t *image, uint64_t tick,
+    const H5FD_vfd_swmr_idx_entry_t entries[], uint32_t nentries)
+{
+    uint8_t *p = image;                 /* Pointer into image */
+    uint32_t metadata_chksum;           /* Computed metadata checksum value */
+    uint32_t u;                         /* Local index variable */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(image);
+    HDassert(entries || 0 == nentries);
+
+    HDmemcpy(p, H5FD_MD_INDEX_MAGIC, (size_t)H5_SIZEOF_MAGIC);
+    p += H5_SIZEOF_MAGIC;
+    UINT64ENCODE(p, tick);
+    UINT32ENCODE(p, nentries);
+
+    for(u = 0; u < nentries; u++) {
+        UINT32ENCODE(p, entries[u].hdf5_page_offset);
+        UINT32ENCODE(p, entries[u].md_file_page_offset);
+        UINT32ENCODE(p, entries[u].length);
+    } /* end for */
+
+    metadata_chksum = H5_checksum_metadata_fast(image, (size_t)(p - image), 0);
+    UINT32ENCODE(p, metadata_chksum);
+
+    HDassert((size_t)(p - image) == H5FD_MD_INDEX_SIZE(nentries));
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_idx_encode() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_idx_decode
+ *
+ * Purpose:     Verify and decode a full metadata file index of LEN bytes.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_idx_decode(const uint8_t *image, size_t len, uint64_t *tick,
+    H5FD_vfd_swmr_idx_entry_t entries[], uint32_t *nentries,
+    uint32_t max_entries)
+{
+    const uint8_t *p = image;           /* Pointer into image */
+    uint32_t stored_chksum;             /* Stored metadata checksum value */
+    uint32_t computed_chksum;           /* Computed metadata checksum value */
+    uint32_t n;                         /* # of entries */
+    uint32_t u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(image);
+    HDassert(tick);
+    HDassert(nentries);
+
+    if(len < H5FD_MD_INDEX_SIZE(0))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTDECODE, FAIL, "metadata file index too small")
+    if(HDmemcmp(p, H5FD_MD_INDEX_MAGIC, (size_t)H5_SIZEOF_MAGIC))
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "wrong metadata file index signature")
+    p += H5_SIZEOF_MAGIC;
+    UINT64DECODE(p, *tick);
+    UINT32DECODE(p, n);
+
+    if(len < H5FD_MD_INDEX_SIZE((size_t)n))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTDECODE, FAIL, "metadata file index truncated")
+    if(n > max_entries)
+        HGOTO_ERROR(H5E_VFL, H5E_NOSPACE, FAIL, "metadata file index too large")
+
+    computed_chksum = H5_checksum_metadata_fast(image, H5FD_MD_INDEX_SIZE((size_t)n) - H5FD_SIZEOF_CHKSUM, 0);
+
+    for(u = 0; u < n; u++) {
+        UINT32DECODE(p, entries[u].hdf5_page_offset);
+        UINT32DECODE(p, entries[u].md_file_page_offset);
+        UINT32DECODE(p, entries[u].length);
+        entries[u].tick_of_last_change = 0;
+        entries[u].is_moved_to_hdf5_file = FALSE;
+    } /* end for */
+
+    UINT32DECODE(p, stored_chksum);
+    if(stored_chksum != computed_chksum)
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "incorrect metadata file index checksum")
+
+    *nentries = n;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_idx_decode() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_delta_prepare
+ *
+ * Purpose:     Get the writer's changed & removed lists ready for
+ *              H5FD_vfd_swmr_delta_encode(): sort them, drop duplicates,
+ *              drop changed pages that have since been removed and
+ *              removed pages that have since been re-added.
+ *
+ *              On return hash->nchanged and hash->nremoved give the
+ *              number of entries the delta will hold.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_delta_prepare(H5FD_vfd_swmr_idx_hash_t *hash,
+    H5FD_vfd_swmr_idx_entry_t entries[])
+{
+    uint32_t u, v;                      /* Local index variables */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(hash);
+
+    hash->nchanged = H5FD__vfd_swmr_page_uniq(hash->changed, hash->nchanged);
+    for(u = 0, v = 0; u < hash->nchanged; u++)
+        if(H5FD_vfd_swmr_idx_hash_lookup(hash, entries, hash->changed[u]))
+            hash->changed[v++] = hash->changed[u];
+    hash->nchanged = v;
+
+    hash->nremoved = H5FD__vfd_swmr_page_uniq(hash->removed, hash->nremoved);
+    for(u = 0, v = 0; u < hash->nremoved; u++)
+        if(NULL == H5FD_vfd_swmr_idx_hash_lookup(hash, entries, hash->removed[u]))
+            hash->removed[v++] = hash->removed[u];
+    hash->nremoved = v;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_delta_prepare() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_delta_want_checkpoint
+ *
+ * Purpose:     Decide whether the writer should write a full index at
+ *              TICK rather than a delta: when H5FD_MD_DELTA_MAX_TICKS
+ *              ticks have passed since the last checkpoint, or when the
+ *              (prepared) delta would be at least half the size of the
+ *              full index.
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+hbool_t
+H5FD_vfd_swmr_delta_want_checkpoint(const H5FD_vfd_swmr_idx_hash_t *hash,
+    uint64_t tick, uint64_t checkpoint_tick)
+{
+    hbool_t ret_value = FALSE;          /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(hash);
+
+    if(tick - checkpoint_tick >= H5FD_MD_DELTA_MAX_TICKS
+            || 2 * H5FD_MD_DELTA_SIZE((size_t)hash->nchanged, (size_t)hash->nremoved) >= H5FD_MD_INDEX_SIZE((size_t)hash->nentries))
+        ret_value = TRUE;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_delta_want_checkpoint() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_delta_encode
+ *
+ * Purpose:     Encode a delta index record for TICK, relative to the full
+ *              index written at CHECKPOINT_TICK, into IMAGE.  IMAGE must
+ *              hold H5FD_MD_DELTA_SIZE(hash->nchanged, hash->nremoved)
+ *              bytes and H5FD_vfd_swmr_delta_prepare() must have been
+ *              called.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_delta_encode(uint8_t *image, const H5FD_vfd_swmr_idx_hash_t *hash,
+    H5FD_vfd_swmr_idx_entry_t entries[], uint64_t tick, uint64_t checkpoint_tick,
+    haddr_t checkpoint_offset, hsize_t checkpoint_length)
+{
+    uint8_t *p = image;                 /* Pointer into image */
+    uint32_t metadata_chksum;           /* Computed metadata checksum value */
+    uint32_t u;                         /* Local index variable */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(image);
+    HDassert(hash);
+
+    HDmemcpy(p, H5FD_MD_DELTA_MAGIC, (size_t)H5_SIZEOF_MAGIC);
+    p += H5_SIZEOF_MAGIC;
+    UINT64ENCODE(p, tick);
+    UINT64ENCODE(p, checkpoint_tick);
+    UINT64ENCODE(p, checkpoint_offset);
+    UINT64ENCODE(p, checkpoint_length);
+    UINT32ENCODE(p, hash->nchanged);
+    UINT32ENCODE(p, hash->nremoved);
+
+    for(u = 0; u < hash->nchanged; u++) {
+        const H5FD_vfd_swmr_idx_entry_t *entry = H5FD_vfd_swmr_idx_hash_lookup(hash, entries, hash->changed[u]);
+
+        HDassert(entry);
+        UINT32ENCODE(p, entry->hdf5_page_offset);
+        UINT32ENCODE(p, entry->md_file_page_offset);
+        UINT32ENCODE(p, entry->length);
+    } /* end for */
+    for(u = 0; u < hash->nremoved; u++)
+        UINT32ENCODE(p, hash->removed[u]);
+
+    metadata_chksum = H5_checksum_metadata_fast(image, (size_t)(p - image), 0);
+    UINT32ENCODE(p, metadata_chksum);
+
+    HDassert((size_t)(p - image) == H5FD_MD_DELTA_SIZE((size_t)hash->nchanged, (size_t)hash->nremoved));
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_delta_encode() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_delta_decode
+ *
+ * Purpose:     Verify a delta index record of LEN bytes and decode its
+ *              header into DELTA.  The changed & removed entries stay in
+ *              IMAGE, which must outlive DELTA.
+ *
+ *              A reader whose index is older than delta->checkpoint_tick
+ *              must first load the full index at delta->checkpoint_offset.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_delta_decode(const uint8_t *image, size_t len,
+    H5FD_vfd_swmr_delta_t *delta)
+{
+    const uint8_t *p = image;           /* Pointer into image */
+    uint32_t stored_chksum;             /* Stored metadata checksum value */
+    uint32_t computed_chksum;           /* Computed metadata checksum value */
+    size_t delta_size;                  /* Size of the record */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(image);
+    HDassert(delta);
+
+    if(len < H5FD_MD_DELTA_SIZE(0, 0))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTDECODE, FAIL, "metadata file delta index too small")
+    if(HDmemcmp(p, H5FD_MD_DELTA_MAGIC, (size_t)H5_SIZEOF_MAGIC))
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "wrong metadata file delta index signature")
+    p += H5_SIZEOF_MAGIC;
+    UINT64DECODE(p, delta->tick);
+    UINT64DECODE(p, delta->checkpoint_tick);
+    UINT64DECODE(p, delta->checkpoint_offset);
+    UINT64DECODE(p, delta->checkpoint_length);
+    UINT32DECODE(p, delta->nchanged);
+    UINT32DECODE(p, delta->nremoved);
+
+    delta_size = H5FD_MD_DELTA_SIZE((size_t)delta->nchanged, (size_t)delta->nremoved);
+    if(len < delta_size)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTDECODE, FAIL, "metadata file delta index truncated")
+    if(delta->checkpoint_tick > delta->tick)
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "delta index is older than its checkpoint")
+
+    /* Only the changed entries are checksummed, not the whole index */
+    computed_chksum = H5_checksum_metadata_fast(image, delta_size - H5FD_SIZEOF_CHKSUM, 0);
+    delta->changed_image = p;
+    delta->removed_image = p + (size_t)delta->nchanged * H5FD_MD_INDEX_ENTRY_SIZE;
+    p = image + delta_size - H5FD_SIZEOF_CHKSUM;
+    UINT32DECODE(p, stored_chksum);
+    if(stored_chksum != computed_chksum)
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "incorrect metadata file delta index checksum")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_delta_decode() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_delta_apply
+ *
+ * Purpose:     Replay a decoded delta onto a reader's sorted index of
+ *              *NENTRIES entries, which must be at least as new as the
+ *              delta's checkpoint.  Since the changed entries hold their
+ *              final values, replaying the same delta twice is harmless.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_delta_apply(const H5FD_vfd_swmr_delta_t *delta,
+    H5FD_vfd_swmr_idx_entry_t entries[], uint32_t *nentries,
+    uint32_t max_entries)
+{
+    H5FD_vfd_swmr_idx_entry_t *merged = NULL;   /* Merged index */
+    H5FD_vfd_swmr_idx_entry_t chg;      /* Current changed entry */
+    const uint8_t *cp, *rp;             /* Pointers into changed & removed images */
+    uint64_t rem = 0;                   /* Current removed page */
+    uint32_t i = 0, c = 0, r = 0;       /* Positions in old, changed & removed */
+    uint32_t n = 0;                     /* # of entries in merged index */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(delta);
+    HDassert(entries);
+    HDassert(nentries);
+
+    if(0 == delta->nchanged && 0 == delta->nremoved)
+        HGOTO_DONE(SUCCEED)
+
+    if(NULL == (merged = (H5FD_vfd_swmr_idx_entry_t *)H5MM_malloc(((size_t)*nentries + delta->nchanged) * sizeof(H5FD_vfd_swmr_idx_entry_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for merged index")
+
+    HDmemset(&chg, 0, sizeof(chg));
+    cp = delta->changed_image;
+    rp = delta->removed_image;
+    if(delta->nchanged > 0) {
+        UINT32DECODE(cp, chg.hdf5_page_offset);
+        UINT32DECODE(cp, chg.md_file_page_offset);
+        UINT32DECODE(cp, chg.length);
+    } /* end if */
+    if(delta->nremoved > 0)
+        UINT32DECODE(rp, rem);
+
+    while(i < *nentries || c < delta->nchanged) {
+        if(c < delta->nchanged && (i == *nentries || chg.hdf5_page_offset <= entries[i].hdf5_page_offset)) {
+            /* Changed or added entry replaces any old one */
+            if(i < *nentries && chg.hdf5_page_offset == entries[i].hdf5_page_offset)
+                i++;
+            merged[n++] = chg;
+            if(++c < delta->nchanged) {
+                UINT32DECODE(cp, chg.hdf5_page_offset);
+                UINT32DECODE(cp, chg.md_file_page_offset);
+                UINT32DECODE(cp, chg.length);
+            } /* end if */
+        } /* end if */
+        else {
+            /* Old entry, kept unless removed */
+            while(r < delta->nremoved && rem < entries[i].hdf5_page_offset)
+                if(++r < delta->nremoved)
+                    UINT32DECODE(rp, rem);
+            if(!(r < delta->nremoved && rem == entries[i].hdf5_page_offset))
+                merged[n++] = entries[i];
+            i++;
+        } /* end else */
+    } /* end while */
+
+    if(n > max_entries)
+        HGOTO_ERROR(H5E_VFL, H5E_NOSPACE, FAIL, "metadata file index too large")
+    HDmemcpy(entries, merged, (size_t)n * sizeof(H5FD_vfd_swmr_idx_entry_t));
+    *nentries = n;
+
+done:
+    if(merged)
+        merged = (H5FD_vfd_swmr_idx_entry_t *)H5MM_xfree(merged);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_delta_apply() */
@@ -0,0 +1,406 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5FDvfd_swmr_notify.c
+ *
+ * Purpose:		Same-host tick notification for VFD SWMR readers.
+ *
+ *                      The writer publishes the tick number and the
+ *                      location of the metadata file index in a shared
+ *                      memory page, named after the metadata file, under
+ *                      a sequence lock.  Readers block on the sequence
+ *                      word with a futex until it changes instead of
+ *                      re-reading the metadata file header on a timer, and
+ *                      then read the header once.
+ *
+ *                      The channel is Linux only.  Elsewhere, or when the
+ *                      writer did not create a channel (e.g. the metadata
+ *                      file is on a remote file system), opening it yields
+ *                      no channel and readers keep polling the header.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+#include "H5FDmodule.h"         /* This source code file is part of the H5FD module */
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5FDpkg.h"		/* File Drivers				*/
+#include "H5MMprivate.h"        /* Memory management                    */
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#define H5FD_VFD_SWMR_NOTIFY_SUPPORTED
+#endif /* __linux__ */
+
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Shared page signature & size */
+#define H5FD_VFD_SWMR_NOTIFY_MAGIC      0x48355354      /* "H5ST" */
+#define H5FD_VFD_SWMR_NOTIFY_PAGE_SIZE  4096
+
+/* Length of the shared memory object name: "/h5swmr-" + 16 hex digits */
+#define H5FD_VFD_SWMR_NOTIFY_NAME_LEN   32
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+/* Layout of the shared page.  'seq' is odd while the writer is updating
+ * the page and is the futex word readers sleep on.
+ */
+typedef struct H5FD_vfd_swmr_notify_page_t {
+    uint32_t magic;                 /* H5FD_VFD_SWMR_NOTIFY_MAGIC */
+    uint32_t seq;                   /* Sequence lock / futex word */
+    uint32_t waiters;               /* # of readers blocked in the futex */
+    uint32_t closed;                /* Writer has closed the file */
+    uint64_t tick;                  /* Current tick */
+    uint64_t index_offset;          /* Offset of the index in the metadata file */
+    uint64_t index_length;          /* Length of the index */
+} H5FD_vfd_swmr_notify_page_t;
+
+/* Notification channel */
+struct H5FD_vfd_swmr_notify_t {
+    H5FD_vfd_swmr_notify_page_t *page;  /* Mapped shared page */
+    hbool_t writer;                     /* Whether this end publishes ticks */
+    char name[H5FD_VFD_SWMR_NOTIFY_NAME_LEN]; /* Shared memory object name */
+};
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static void H5FD__vfd_swmr_notify_name(const char *md_file_path, char *name);
+
+
+/*********************/
+/* Package Variables */
+/*********************/
+
+
+/*****************************/
+/* Library Private Variables */
+/*****************************/
+
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_notify_name
+ *
+ * Purpose:     Derive the shared memory object name for a metadata file
+ *              from a 64-bit FNV-1a hash of its path.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__vfd_swmr_notify_name(const char *md_file_path, char *name)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;     /* FNV-1a offset basis */
+    const unsigned char *p;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(p = (const unsigned char *)md_file_path; *p; p++)
+        h = (h ^ *p) * 0x100000001b3ULL;
+    HDsnprintf(name, H5FD_VFD_SWMR_NOTIFY_NAME_LEN, "/h5swmr-%016llx", (unsigned long long)h);
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__vfd_swmr_notify_name() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_notify_open
+ *
+ * Purpose:     Open the notification channel for the metadata file
+ *              MD_FILE_PATH.  The writer creates it; readers attach to an
+ *              existing one.
+ *
+ *              *CHAN is set to NULL, and SUCCEED returned, when no channel
+ *              is available (unsupported platform, or no writer channel);
+ *              callers then poll the metadata file header.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_notify_open(const char *md_file_path, hbool_t writer,
+    H5FD_vfd_swmr_notify_t **chan)
+{
+#ifdef H5FD_VFD_SWMR_NOTIFY_SUPPORTED
+    H5FD_vfd_swmr_notify_t *ch = NULL;  /* New channel */
+    int fd = -1;                        /* Shared memory object descriptor */
+    h5_stat_t sb;                       /* Info about the object */
+    void *addr = MAP_FAILED;            /* Mapped page */
+#endif /* H5FD_VFD_SWMR_NOTIFY_SUPPORTED */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(md_file_path);
+    HDassert(chan);
+
+    *chan = NULL;
+
+#ifdef H5FD_VFD_SWMR_NOTIFY_SUPPORTED
+    if(NULL == (ch = (H5FD_vfd_swmr_notify_t *)H5MM_calloc(sizeof(H5FD_vfd_swmr_notify_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for notification channel")
+    ch->writer = writer;
+    H5FD__vfd_swmr_notify_name(md_file_path, ch->name);
+
+    if(writer) {
+        if((fd = shm_open(ch->name, O_RDWR | O_CREAT, H5_POSIX_CREATE_MODE_RW)) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTOPENFILE, FAIL, "can't create notification channel")
+        if(HDftruncate(fd, (HDoff_t)H5FD_VFD_SWMR_NOTIFY_PAGE_SIZE) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't size notification channel")
+    } /* end if */
+    else {
+        /* No channel: the writer doesn't publish on this host */
+        if((fd = shm_open(ch->name, O_RDWR, 0)) < 0)
+            HGOTO_DONE(SUCCEED)
+        if(HDfstat(fd, &sb) < 0 || sb.st_size < (HDoff_t)H5FD_VFD_SWMR_NOTIFY_PAGE_SIZE)
+            HGOTO_DONE(SUCCEED)
+    } /* end else */
+
+    if(MAP_FAILED == (addr = mmap(NULL, (size_t)H5FD_VFD_SWMR_NOTIFY_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (HDoff_t)0)))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "can't map notification channel")
+    ch->page = (H5FD_vfd_swmr_notify_page_t *)addr;
+
+    if(writer) {
+        uint32_t seq = 0;
+
+        /* Keep the sequence moving forward if a previous writer left a page */
+        if(H5FD_VFD_SWMR_NOTIFY_MAGIC == __atomic_load_n(&ch->page->magic, __ATOMIC_ACQUIRE))
+            seq = (__atomic_load_n(&ch->page->seq, __ATOMIC_RELAXED) + 2) & ~(uint32_t)1;
+        ch->page->tick = 0;
+        ch->page->index_offset = 0;
+        ch->page->index_length = 0;
+        __atomic_store_n(&ch->page->closed, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&ch->page->seq, seq, __ATOMIC_RELEASE);
+        __atomic_store_n(&ch->page->magic, H5FD_VFD_SWMR_NOTIFY_MAGIC, __ATOMIC_RELEASE);
+    } /* end if */
+    else if(H5FD_VFD_SWMR_NOTIFY_MAGIC != __atomic_load_n(&ch->page->magic, __ATOMIC_ACQUIRE))
+        HGOTO_DONE(SUCCEED)
+
+    *chan = ch;
+    ch = NULL;
+
+done:
+    if(fd >= 0)
+        HDclose(fd);
+    if(ch) {
+        if(ch->page)
+            munmap((void *)ch->page, (size_t)H5FD_VFD_SWMR_NOTIFY_PAGE_SIZE);
+        ch = (H5FD_vfd_swmr_notify_t *)H5MM_xfree(ch);
+    } /* end if */
+#endif /* H5FD_VFD_SWMR_NOTIFY_SUPPORTED */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_notify_open() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_notify_close
+ *
+ * Purpose:     Close a notification channel.  The writer marks the page
+ *              closed, wakes any blocked readers and removes the name.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_notify_close(H5FD_vfd_swmr_notify_t *chan)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(chan);
+
+#ifdef H5FD_VFD_SWMR_NOTIFY_SUPPORTED
+    if(chan->writer) {
+        __atomic_store_n(&chan->page->closed, 1, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&chan->page->seq, 2, __ATOMIC_SEQ_CST);
+        syscall(SYS_futex, &chan->page->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        shm_unlink(chan->name);
+    } /* end if */
+    munmap((void *)chan->page, (size_t)H5FD_VFD_SWMR_NOTIFY_PAGE_SIZE);
+#endif /* H5FD_VFD_SWMR_NOTIFY_SUPPORTED */
+
+    chan = (H5FD_vfd_swmr_notify_t *)H5MM_xfree(chan);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_notify_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_notify_publish
+ *
+ * Purpose:     Publish a new tick, after the writer has written the
+ *              metadata file header for it, and wake blocked readers.
+ *              The futex is only woken when a reader is waiting, so
+ *              publishing to no readers costs no system call.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_notify_publish(H5FD_vfd_swmr_notify_t *chan, uint64_t tick,
+    haddr_t index_offset, hsize_t index_length)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(chan);
+    HDassert(chan->writer);
+
+#ifdef H5FD_VFD_SWMR_NOTIFY_SUPPORTED
+{
+    H5FD_vfd_swmr_notify_page_t *pg = chan->page;
+    uint32_t seq = __atomic_load_n(&pg->seq, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&pg->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&pg->tick, tick, __ATOMIC_RELAXED);
+    __atomic_store_n(&pg->index_offset, (uint64_t)index_offset, __ATOMIC_RELAXED);
+    __atomic_store_n(&pg->index_length, (uint64_t)index_length, __ATOMIC_RELAXED);
+    __atomic_store_n(&pg->seq, seq + 2, __ATOMIC_SEQ_CST);
+
+    if(__atomic_load_n(&pg->waiters, __ATOMIC_SEQ_CST) > 0)
+        syscall(SYS_futex, &pg->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+#endif /* H5FD_VFD_SWMR_NOTIFY_SUPPORTED */
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_notify_publish() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_notify_wait
+ *
+ * Purpose:     Wait up to TIMEOUT_NS nanoseconds for the writer to publish
+ *              a tick newer than LAST_TICK, and return the tick and the
+ *              index location.  A TIMEOUT_NS of 0 just checks.
+ *
+ * Return:      Success:        TRUE if a newer tick was published
+ *                              FALSE on timeout or if the writer closed
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+htri_t
+H5FD_vfd_swmr_notify_wait(H5FD_vfd_swmr_notify_t *chan, uint64_t last_tick,
+    uint64_t timeout_ns, uint64_t *tick, haddr_t *index_offset,
+    hsize_t *index_length)
+{
+#ifdef H5FD_VFD_SWMR_NOTIFY_SUPPORTED
+    H5FD_vfd_swmr_notify_page_t *pg;    /* Shared page */
+    struct timespec now, deadline;      /* Current time & time to give up */
+    struct timespec rel;                /* Time left */
+    uint32_t seq1, seq2;                /* Sequence before & after reading */
+    uint64_t t, off, len;               /* Published values */
+#endif /* H5FD_VFD_SWMR_NOTIFY_SUPPORTED */
+    htri_t ret_value = FALSE;           /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(chan);
+    HDassert(tick);
+
+#ifdef H5FD_VFD_SWMR_NOTIFY_SUPPORTED
+    pg = chan->page;
+    if(HDclock_gettime(CLOCK_MONOTONIC, &deadline) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "can't get time")
+    deadline.tv_sec += (time_t)(timeout_ns / 1000000000);
+    deadline.tv_nsec += (long)(timeout_ns % 1000000000);
+    if(deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    } /* end if */
+
+    for(;;) {
+        /* Read a consistent snapshot, unless the writer is mid-update */
+        seq1 = __atomic_load_n(&pg->seq, __ATOMIC_ACQUIRE);
+        if(0 == (seq1 & 1)) {
+            t = __atomic_load_n(&pg->tick, __ATOMIC_RELAXED);
+            off = __atomic_load_n(&pg->index_offset, __ATOMIC_RELAXED);
+            len = __atomic_load_n(&pg->index_length, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            seq2 = __atomic_load_n(&pg->seq, __ATOMIC_RELAXED);
+            if(seq1 != seq2)
+                continue;
+
+            if(t > last_tick) {
+                *tick = t;
+                if(index_offset)
+                    *index_offset = (haddr_t)off;
+                if(index_length)
+                    *index_length = (hsize_t)len;
+                HGOTO_DONE(TRUE)
+            } /* end if */
+            if(__atomic_load_n(&pg->closed, __ATOMIC_ACQUIRE))
+                HGOTO_DONE(FALSE)
+        } /* end if */
+
+        /* Sleep until the sequence moves on from seq1 */
+        if(HDclock_gettime(CLOCK_MONOTONIC, &now) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "can't get time")
+        rel.tv_sec = deadline.tv_sec - now.tv_sec;
+        rel.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if(rel.tv_nsec < 0) {
+            rel.tv_sec--;
+            rel.tv_nsec += 1000000000;
+        } /* end if */
+        if(rel.tv_sec < 0)
+            HGOTO_DONE(FALSE)
+
+        __atomic_add_fetch(&pg->waiters, 1, __ATOMIC_SEQ_CST);
+        if(syscall(SYS_futex, &pg->seq, FUTEX_WAIT, seq1, &rel, NULL, 0) < 0
+                && errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT) {
+            __atomic_sub_fetch(&pg->waiters, 1, __ATOMIC_SEQ_CST);
+            HGOTO_ERROR(H5E_VFL, H5E_SYSERRSTR, FAIL, "can't wait for tick notification")
+        } /* end if */
+        __atomic_sub_fetch(&pg->waiters, 1, __ATOMIC_SEQ_CST);
+    } /* end for */
+#endif /* H5FD_VFD_SWMR_NOTIFY_SUPPORTED */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_notify_wait() */
@@ -0,0 +1,593 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5FDvfd_swmr_space.c
+ *
+ * Purpose:		Free space management for the VFD SWMR metadata file.
+ *
+ *                      The writer allocates metadata file pages for the
+ *                      entries of the index here, past the
+ *                      md_pages_reserved pages holding the header and
+ *                      index, and frees them when an entry is rewritten
+ *                      elsewhere or moved to the HDF5 file.  Readers may
+ *                      still be reading a freed extent through an index up
+ *                      to max_lag ticks old, so freed extents wait that
+ *                      long before they are reused.
+ *
+ *                      Free extents are kept in size classes of [2^c,
+ *                      2^(c+1)) pages, each sorted by page, and allocation
+ *                      takes the lowest fitting extent, so that live pages
+ *                      stay packed towards the start of the file.  Freed
+ *                      extents are merged with their free neighbours, and
+ *                      the end of allocated space shrinks when the last
+ *                      extent becomes free, so the file stays bounded by
+ *                      its live pages plus max_lag ticks of garbage.
+ *
+ *                      H5FD_vfd_swmr_md_space_compact() additionally moves
+ *                      a few of the highest entries into lower holes each
+ *                      tick, for writers whose holes don't refill on
+ *                      their own.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+#include "H5FDmodule.h"         /* This source code file is part of the H5FD module */
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5FDpkg.h"		/* File Drivers				*/
+#include "H5MMprivate.h"        /* Memory management                    */
+
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Smallest list allocated */
+#define H5FD_MD_SPACE_MIN_ALLOC         16
+
+/* # of pages needed for LEN bytes */
+#define H5FD_MD_SPACE_NPAGES(SP, LEN)   (((uint64_t)(LEN) + (SP)->page_size - 1) / (SP)->page_size)
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static unsigned H5FD__vfd_swmr_md_space_class(uint64_t npages);
+static uint32_t H5FD__vfd_swmr_md_space_find(const H5FD_vfd_swmr_md_class_t *cls,
+    uint64_t page);
+static herr_t H5FD__vfd_swmr_md_space_insert(H5FD_vfd_swmr_md_space_t *sp,
+    const H5FD_vfd_swmr_md_extent_t *ext);
+static void H5FD__vfd_swmr_md_space_remove(H5FD_vfd_swmr_md_space_t *sp,
+    unsigned c, uint32_t pos);
+static herr_t H5FD__vfd_swmr_md_space_put(H5FD_vfd_swmr_md_space_t *sp,
+    H5FD_vfd_swmr_md_extent_t ext);
+static herr_t H5FD__vfd_swmr_md_space_release(H5FD_vfd_swmr_md_space_t *sp,
+    uint64_t tick);
+static htri_t H5FD__vfd_swmr_md_space_take(H5FD_vfd_swmr_md_space_t *sp,
+    uint64_t npages, uint64_t below, uint64_t *page);
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_md_space_class
+ *
+ * Purpose:     Get the size class of an extent of NPAGES pages.
+ *
+ * Return:      Size class
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+H5FD__vfd_swmr_md_space_class(uint64_t npages)
+{
+    unsigned c = 0;
+
+    while(c < H5FD_MD_SPACE_NCLASSES - 1 && (npages >> (c + 1)) != 0)
+        c++;
+
+    return c;
+} /* end H5FD__vfd_swmr_md_space_class() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_md_space_find
+ *
+ * Purpose:     Find the position of the first extent of size class CLS
+ *              at or after PAGE.
+ *
+ * Return:      Position, CLS->nextents if there is none
+ *
+ *-------------------------------------------------------------------------
+ */
+static uint32_t
+H5FD__vfd_swmr_md_space_find(const H5FD_vfd_swmr_md_class_t *cls, uint64_t page)
+{
+    uint32_t lo = 0, hi = cls->nextents;
+
+    while(lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+
+        if(cls->extents[mid].page < page)
+            lo = mid + 1;
+        else
+            hi = mid;
+    } /* end while */
+
+    return lo;
+} /* end H5FD__vfd_swmr_md_space_find() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_md_space_insert
+ *
+ * Purpose:     Add the free extent EXT to its size class.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__vfd_swmr_md_space_insert(H5FD_vfd_swmr_md_space_t *sp,
+    const H5FD_vfd_swmr_md_extent_t *ext)
+{
+    H5FD_vfd_swmr_md_class_t *cls = &sp->classes[H5FD__vfd_swmr_md_space_class(ext->npages)];
+    uint32_t pos;
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(cls->nextents == cls->alloc_extents) {
+        uint32_t na = MAX(H5FD_MD_SPACE_MIN_ALLOC, 2 * cls->alloc_extents);
+        H5FD_vfd_swmr_md_extent_t *x;
+
+        if(NULL == (x = (H5FD_vfd_swmr_md_extent_t *)H5MM_realloc(cls->extents, na * sizeof(H5FD_vfd_swmr_md_extent_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for metadata file free list")
+        cls->extents = x;
+        cls->alloc_extents = na;
+    } /* end if */
+
+    pos = H5FD__vfd_swmr_md_space_find(cls, ext->page);
+    HDmemmove(&cls->extents[pos + 1], &cls->extents[pos], (cls->nextents - pos) * sizeof(H5FD_vfd_swmr_md_extent_t));
+    cls->extents[pos] = *ext;
+    cls->nextents++;
+    sp->nfree += ext->npages;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vfd_swmr_md_space_insert() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_md_space_remove
+ *
+ * Purpose:     Remove the free extent at position POS of size class C.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__vfd_swmr_md_space_remove(H5FD_vfd_swmr_md_space_t *sp, unsigned c, uint32_t pos)
+{
+    H5FD_vfd_swmr_md_class_t *cls = &sp->classes[c];
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(pos < cls->nextents);
+
+    sp->nfree -= cls->extents[pos].npages;
+    cls->nextents--;
+    HDmemmove(&cls->extents[pos], &cls->extents[pos + 1], (cls->nextents - pos) * sizeof(H5FD_vfd_swmr_md_extent_t));
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__vfd_swmr_md_space_remove() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_md_space_put
+ *
+ * Purpose:     Make the extent EXT free for reuse: merge it with the free
+ *              extents on either side for as long as there are any, then
+ *              give it back to the end of allocated space if it reaches
+ *              it, or add it to the free lists otherwise.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__vfd_swmr_md_space_put(H5FD_vfd_swmr_md_space_t *sp, H5FD_vfd_swmr_md_extent_t ext)
+{
+    unsigned c;                         /* Size class */
+    hbool_t merged;                     /* Whether a pass merged an extent */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Each merge moves an end of the extent, and with it the neighbour to
+     * look for, which may be in a class this pass has already been
+     * through.  Go round until a pass merges nothing.
+     */
+    do {
+        merged = FALSE;
+        for(c = 0; c < H5FD_MD_SPACE_NCLASSES; c++) {
+            H5FD_vfd_swmr_md_class_t *cls = &sp->classes[c];
+            uint32_t pos = H5FD__vfd_swmr_md_space_find(cls, ext.page);
+
+            /* Following extent */
+            if(pos < cls->nextents && cls->extents[pos].page == ext.page + ext.npages) {
+                ext.npages += cls->extents[pos].npages;
+                H5FD__vfd_swmr_md_space_remove(sp, c, pos);
+                merged = TRUE;
+            } /* end if */
+
+            /* Preceding extent */
+            if(pos > 0 && cls->extents[pos - 1].page + cls->extents[pos - 1].npages == ext.page) {
+                ext.page = cls->extents[pos - 1].page;
+                ext.npages += cls->extents[pos - 1].npages;
+                H5FD__vfd_swmr_md_space_remove(sp, c, pos - 1);
+                merged = TRUE;
+            } /* end if */
+        } /* end for */
+    } while(merged);
+
+    if(ext.page + ext.npages == sp->eoa_page)
+        sp->eoa_page = ext.page;
+    else if(H5FD__vfd_swmr_md_space_insert(sp, &ext) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINSERT, FAIL, "can't add metadata file free extent")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vfd_swmr_md_space_put() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_md_space_release
+ *
+ * Purpose:     Make the extents freed at least max_lag ticks before TICK
+ *              reusable.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__vfd_swmr_md_space_release(H5FD_vfd_swmr_md_space_t *sp, uint64_t tick)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    while(sp->pending_head < sp->npending && sp->pending[sp->pending_head].tick + sp->max_lag <= tick) {
+        H5FD_vfd_swmr_md_extent_t ext = sp->pending[sp->pending_head++];
+
+        sp->nwaiting -= ext.npages;
+        if(H5FD__vfd_swmr_md_space_put(sp, ext) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTFREE, FAIL, "can't release metadata file extent")
+    } /* end while */
+
+    /* Slide the queue back once it's half drained */
+    if(sp->pending_head > 0 && sp->pending_head >= sp->npending / 2) {
+        sp->npending -= sp->pending_head;
+        HDmemmove(sp->pending, &sp->pending[sp->pending_head], sp->npending * sizeof(H5FD_vfd_swmr_md_extent_t));
+        sp->pending_head = 0;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vfd_swmr_md_space_release() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vfd_swmr_md_space_take
+ *
+ * Purpose:     Take NPAGES pages from the lowest free extent that holds
+ *              them and starts below page BELOW.
+ *
+ * Return:      Success:        TRUE with *PAGE set, or FALSE if there is
+ *                              no such extent
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static htri_t
+H5FD__vfd_swmr_md_space_take(H5FD_vfd_swmr_md_space_t *sp, uint64_t npages,
+    uint64_t below, uint64_t *page)
+{
+    H5FD_vfd_swmr_md_extent_t ext;      /* Extent taken from */
+    unsigned c, best_c = 0;             /* Size classes */
+    uint32_t pos, best_pos = 0;         /* Positions in size classes */
+    hbool_t found = FALSE;              /* Whether an extent was found */
+    htri_t ret_value = TRUE;            /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Extents in npages' own class may be too short: first fit.  Any
+     * extent of a larger class will do, so only its first is a candidate.
+     */
+    for(c = H5FD__vfd_swmr_md_space_class(npages); c < H5FD_MD_SPACE_NCLASSES; c++) {
+        const H5FD_vfd_swmr_md_class_t *cls = &sp->classes[c];
+
+        for(pos = 0; pos < cls->nextents && cls->extents[pos].page < below; pos++)
+            if(cls->extents[pos].npages >= npages) {
+                if(!found || cls->extents[pos].page < sp->classes[best_c].extents[best_pos].page) {
+                    best_c = c;
+                    best_pos = pos;
+                    found = TRUE;
+                } /* end if */
+                break;
+            } /* end if */
+    } /* end for */
+    if(!found)
+        HGOTO_DONE(FALSE)
+
+    ext = sp->classes[best_c].extents[best_pos];
+    H5FD__vfd_swmr_md_space_remove(sp, best_c, best_pos);
+    *page = ext.page;
+
+    /* Keep the rest of the extent free */
+    if(ext.npages > npages) {
+        ext.page += npages;
+        ext.npages -= npages;
+        if(H5FD__vfd_swmr_md_space_insert(sp, &ext) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINSERT, FAIL, "can't add metadata file free extent")
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vfd_swmr_md_space_take() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_md_space_init
+ *
+ * Purpose:     Set up the free space of an empty metadata file with pages
+ *              of PAGE_SIZE bytes, whose first MD_PAGES_RESERVED pages
+ *              hold the header and the index, for a writer whose readers
+ *              may lag by up to MAX_LAG ticks.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_md_space_init(H5FD_vfd_swmr_md_space_t *sp, uint32_t page_size,
+    uint64_t md_pages_reserved, uint64_t max_lag)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(sp);
+    HDassert(page_size > 0);
+
+    HDmemset(sp, 0, sizeof(*sp));
+    sp->page_size = page_size;
+    sp->max_lag = max_lag;
+    sp->first_page = sp->eoa_page = md_pages_reserved;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_md_space_init() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_md_space_dest
+ *
+ * Purpose:     Release the memory held by the metadata file free space.
+ *
+ * Return:      SUCCEED
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_md_space_dest(H5FD_vfd_swmr_md_space_t *sp)
+{
+    unsigned c;                         /* Size class */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(sp);
+
+    for(c = 0; c < H5FD_MD_SPACE_NCLASSES; c++)
+        sp->classes[c].extents = (H5FD_vfd_swmr_md_extent_t *)H5MM_xfree(sp->classes[c].extents);
+    sp->pending = (H5FD_vfd_swmr_md_extent_t *)H5MM_xfree(sp->pending);
+    H5FD_vfd_swmr_md_space_init(sp, sp->page_size, sp->first_page, sp->max_lag);
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_vfd_swmr_md_space_dest() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_md_space_alloc
+ *
+ * Purpose:     Allocate metadata file pages for LENGTH bytes during tick
+ *              TICK: the lowest free extent that holds them, or new pages
+ *              at the end of allocated space.  *PAGE is set to the first
+ *              page, as for md_file_page_offset.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_md_space_alloc(H5FD_vfd_swmr_md_space_t *sp, uint64_t tick,
+    uint32_t length, uint64_t *page)
+{
+    uint64_t npages;                    /* # of pages to allocate */
+    htri_t found;                       /* Whether a free extent was found */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(sp);
+    HDassert(length > 0);
+    HDassert(page);
+
+    npages = H5FD_MD_SPACE_NPAGES(sp, length);
+
+    if(H5FD__vfd_swmr_md_space_release(sp, tick) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTFREE, FAIL, "can't release metadata file extents")
+    if((found = H5FD__vfd_swmr_md_space_take(sp, npages, sp->eoa_page, page)) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTALLOC, FAIL, "can't allocate from metadata file free list")
+    if(!found) {
+        *page = sp->eoa_page;
+        sp->eoa_page += npages;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_md_space_alloc() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_md_space_free
+ *
+ * Purpose:     Free the metadata file pages of LENGTH bytes at PAGE during
+ *              tick TICK.  They are reused from tick TICK + max_lag on.
+ *              Ticks must not go backwards from one call to the next.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_md_space_free(H5FD_vfd_swmr_md_space_t *sp, uint64_t tick,
+    uint64_t page, uint32_t length)
+{
+    H5FD_vfd_swmr_md_extent_t *ext;     /* Extent freed */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(sp);
+    HDassert(page >= sp->first_page);
+    HDassert(sp->npending == 0 || sp->pending[sp->npending - 1].tick <= tick);
+
+    if(sp->npending == sp->alloc_pending) {
+        uint32_t na = MAX(H5FD_MD_SPACE_MIN_ALLOC, 2 * sp->alloc_pending);
+        H5FD_vfd_swmr_md_extent_t *x;
+
+        if(NULL == (x = (H5FD_vfd_swmr_md_extent_t *)H5MM_realloc(sp->pending, na * sizeof(H5FD_vfd_swmr_md_extent_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for metadata file free list")
+        sp->pending = x;
+        sp->alloc_pending = na;
+    } /* end if */
+
+    ext = &sp->pending[sp->npending++];
+    ext->page = page;
+    ext->npages = H5FD_MD_SPACE_NPAGES(sp, length);
+    ext->tick = tick;
+    sp->nwaiting += ext->npages;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_md_space_free() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_vfd_swmr_md_space_compact
+ *
+ * Purpose:     Move up to MAX_MOVES of the entries highest in the
+ *              metadata file into lower free extents during tick TICK,
+ *              highest first, stopping at the first that finds no lower
+ *              hole.  Their old pages are freed and their
+ *              md_file_page_offset is updated; the entries are touched in
+ *              HASH, if not NULL, for the next delta index.
+ *
+ *              The positions of the moved entries in ENTRIES are returned
+ *              in MOVED (of at least MAX_MOVES elements) and their count
+ *              in *NMOVED: the writer must write their images at the new
+ *              offsets in this tick.
+ *
+ * Return:      Success:        SUCCEED
+ *              Failure:        FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_vfd_swmr_md_space_compact(H5FD_vfd_swmr_md_space_t *sp,
+    H5FD_vfd_swmr_idx_hash_t *hash, H5FD_vfd_swmr_idx_entry_t entries[],
+    uint32_t nentries, uint64_t tick, uint32_t max_moves, uint32_t moved[],
+    uint32_t *nmoved)
+{
+    uint64_t below = UINT64_MAX;        /* Only move entries starting below this */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(sp);
+    HDassert(entries || 0 == nentries);
+    HDassert(moved || 0 == max_moves);
+    HDassert(nmoved);
+
+    *nmoved = 0;
+
+    if(H5FD__vfd_swmr_md_space_release(sp, tick) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTFREE, FAIL, "can't release metadata file extents")
+
+    while(*nmoved < max_moves && sp->nfree > 0) {
+        H5FD_vfd_swmr_idx_entry_t *entry = NULL;
+        uint64_t page;
+        uint32_t u, top = 0;
+        htri_t found;
+
+        /* Highest entry not looked at yet */
+        for(u = 0; u < nentries; u++)
+            if(!entries[u].is_moved_to_hdf5_file && entries[u].md_file_page_offset < below
+                    && (NULL == entry || entries[u].md_file_page_offset > entry->md_file_page_offset)) {
+                entry = &entries[u];
+                top = u;
+            } /* end if */
+        if(NULL == entry)
+            break;
+        below = entry->md_file_page_offset;
+
+        if((found = H5FD__vfd_swmr_md_space_take(sp, H5FD_MD_SPACE_NPAGES(sp, entry->length), below, &page)) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTALLOC, FAIL, "can't allocate from metadata file free list")
+        if(!found)
+            break;
+
+        if(H5FD_vfd_swmr_md_space_free(sp, tick, entry->md_file_page_offset, entry->length) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTFREE, FAIL, "can't free metadata file extent")
+        entry->md_file_page_offset = page;
+        if(hash) {
+            if(H5FD_vfd_swmr_idx_hash_touch(hash, entries, entry, tick) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_CANTINSERT, FAIL, "can't record moved index entry")
+        } /* end if */
+        else
+            entry->tick_of_last_change = tick;
+        moved[(*nmoved)++] = top;
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_vfd_swmr_md_space_compact() */
@@ -1,19 +1,1308 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/utsname.h>
 #include <zf_log.h>
 #include <hdf5.h>
+#ifdef H5F_LOG_HAVE_CURL
+#include <curl/curl.h>
+#endif
+#ifdef H5F_LOG_HAVE_LIBRDKAFKA
+#include <librdkafka/rdkafka.h>
+#endif
+
+/* Asynchronous SWMR log.
+ *
+ * H5F_post_vfd_swrm_log_entry() normally formats and outputs each entry
+ * with ZF_LOGI on the calling thread, so a writer pays for the formatting
+ * and for the output callback (often an fwrite + fflush) at every tick.
+ *
+ * After H5F_vfd_swmr_log_async_start(), entries are instead copied as
+ * fixed-size records into a single-producer/single-consumer ring owned by
+ * the posting thread, which takes no lock.  A background thread collects
+ * the records of every ring, orders them by timestamp, and either passes
+ * them on to ZF_LOGI or, when given a stream, formats the whole batch into
+ * one buffer and writes it with a single fwrite/fflush.
+ *
+ * A full ring drops the entry (counted, see
+ * H5F_vfd_swmr_log_async_dropped()) or makes the poster wait for room,
+ * depending on the overflow policy.
+ */
+
+/* Longest entry body kept in a record, longer ones are truncated */
+#define H5F_LOG_BODY_SIZE       112
+
+/* Max. # of records written per batch */
+#define H5F_LOG_BATCH_SIZE      4096
+
+/* Time the background thread sleeps when every ring is empty */
+#define H5F_LOG_IDLE_NS         1000000L
+
+/* Time a poster sleeps between checks of a full ring, with the block policy */
+#define H5F_LOG_BLOCK_NS        50000L
+
+/* Overflow policies for a full ring */
+typedef enum H5F_log_overflow_t {
+  H5F_LOG_OVERFLOW_DROP,        /* Drop the entry and count it */
+  H5F_LOG_OVERFLOW_BLOCK        /* Wait until the background thread makes room */
+} H5F_log_overflow_t;
+
+/* One log entry */
+typedef struct H5F_log_rec_t {
+  uint64_t timestamp;           /* CLOCK_MONOTONIC time of the entry, in ns */
+  int entry_type_code;          /* Entry type code */
+  char body[H5F_LOG_BODY_SIZE]; /* NUL-terminated entry body */
+} H5F_log_rec_t;
+
+/* Ring of records posted by one thread */
+typedef struct H5F_log_ring_t {
+  uint64_t head;                /* # of records pushed, written by the poster */
+  uint64_t tail;                /* # of records popped, written by the background thread */
+  H5F_log_rec_t *recs;          /* Records, (mask + 1) of them */
+  struct H5F_log_ring_t *next;  /* Next ring in the list of all rings */
+} H5F_log_ring_t;
+
+/* State of the asynchronous log */
+static struct {
+  int running;                  /* Whether entries go through the rings */
+  int stopping;                 /* Set to make the background thread finish */
+  int nposters;                 /* # of threads between checking running and the end of their push */
+  uint64_t mask;                /* Ring capacity - 1, capacity is a power of 2 */
+  H5F_log_overflow_t overflow;  /* Overflow policy */
+  FILE *stream;                 /* Stream for batched output, or NULL for ZF_LOGI */
+  uint64_t dropped;             /* # of entries dropped */
+  pthread_key_t key;            /* Ring of the calling thread */
+  pthread_mutex_t mutex;        /* Protects the list of rings */
+  H5F_log_ring_t *rings;        /* All rings */
+  H5F_log_ring_t *cursor;       /* Ring the next batch starts at, NULL for the first */
+  H5F_log_rec_t *batch;         /* Records of a batch, for the background thread */
+  char *buf;                    /* Formatted batch, for the background thread */
+  size_t buf_size;              /* Size of buf */
+  pthread_t thread;             /* Background thread */
+} H5F_log_async_g = {0, 0, 0, 0, H5F_LOG_OVERFLOW_DROP, NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER, NULL, NULL, NULL, NULL, 0, 0};
+
+
+static uint64_t
+H5F__log_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+static void
+H5F__log_sleep(long ns)
+{
+  struct timespec ts;
+
+  ts.tv_sec = 0;
+  ts.tv_nsec = ns;
+  nanosleep(&ts, NULL);
+}
+
+
+/* Get the calling thread's ring, creating it on its first entry.  Returns
+ * NULL when out of memory.
+ */
+static H5F_log_ring_t *
+H5F__log_ring(void)
+{
+  H5F_log_ring_t *ring;
+
+  if ((ring = (H5F_log_ring_t *)pthread_getspecific(H5F_log_async_g.key)) != NULL)
+    return ring;
+
+  if ((ring = (H5F_log_ring_t *)calloc(1, sizeof(*ring))) == NULL)
+    return NULL;
+  if ((ring->recs = (H5F_log_rec_t *)malloc((size_t)(H5F_log_async_g.mask + 1) * sizeof(H5F_log_rec_t))) == NULL) {
+    free(ring);
+    return NULL;
+  }
+
+  /* Rings stay on the list, and are freed, until the log is stopped, so
+   * the records of threads that have exited still get written.
+   */
+  pthread_mutex_lock(&H5F_log_async_g.mutex);
+  ring->next = H5F_log_async_g.rings;
+  H5F_log_async_g.rings = ring;
+  pthread_mutex_unlock(&H5F_log_async_g.mutex);
+  pthread_setspecific(H5F_log_async_g.key, ring);
+
+  return ring;
+}
+
+
+/* Push an entry onto the calling thread's ring */
+static void
+H5F__log_push(int entry_type_code, const char *body)
+{
+  H5F_log_ring_t *ring;
+  H5F_log_rec_t *rec;
+  uint64_t head;
+
+  if ((ring = H5F__log_ring()) == NULL) {
+    __atomic_fetch_add(&H5F_log_async_g.dropped, 1, __ATOMIC_RELAXED);
+    return;
+  }
 
-void 
+  head = ring->head;
+  while (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > H5F_log_async_g.mask) {
+    if (H5F_log_async_g.overflow == H5F_LOG_OVERFLOW_DROP) {
+      __atomic_fetch_add(&H5F_log_async_g.dropped, 1, __ATOMIC_RELAXED);
+      return;
+    }
+    H5F__log_sleep(H5F_LOG_BLOCK_NS);
+  }
+
+  rec = &ring->recs[head & H5F_log_async_g.mask];
+  rec->timestamp = H5F__log_now();
+  rec->entry_type_code = entry_type_code;
+  strncpy(rec->body, body ? body : "", H5F_LOG_BODY_SIZE - 1);
+  rec->body[H5F_LOG_BODY_SIZE - 1] = '\0';
+
+  __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+
+static int
+H5F__log_rec_cmp(const void *_a, const void *_b)
+{
+  const H5F_log_rec_t *a = (const H5F_log_rec_t *)_a;
+  const H5F_log_rec_t *b = (const H5F_log_rec_t *)_b;
+
+  return (a->timestamp > b->timestamp) - (a->timestamp < b->timestamp);
+}
+
+
+/* Pop up to H5F_LOG_BATCH_SIZE records from the rings into BATCH, in
+ * timestamp order.  Returns the number of records popped.
+ */
+static size_t
+H5F__log_collect(H5F_log_rec_t *batch)
+{
+  H5F_log_ring_t *first, *start, *ring;
+  size_t n = 0;
+
+  pthread_mutex_lock(&H5F_log_async_g.mutex);
+  first = H5F_log_async_g.rings;
+  pthread_mutex_unlock(&H5F_log_async_g.mutex);
+  if (first == NULL)
+    return 0;
+
+  /* Go round the rings from where the last batch stopped, so that a busy
+   * ring can't keep the ones after it waiting.  Rings are only ever added
+   * at the front, so the rest of the list can be walked without the lock.
+   */
+  start = ring = H5F_log_async_g.cursor ? H5F_log_async_g.cursor : first;
+  do {
+    uint64_t tail = ring->tail;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    while (tail != head && n < H5F_LOG_BATCH_SIZE)
+      batch[n++] = ring->recs[tail++ & H5F_log_async_g.mask];
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+    ring = ring->next ? ring->next : first;
+  } while (ring != start && n < H5F_LOG_BATCH_SIZE);
+  H5F_log_async_g.cursor = ring;
+
+  if (n > 1)
+    qsort(batch, n, sizeof(*batch), H5F__log_rec_cmp);
+
+  return n;
+}
+
+
+/* Output a batch of records */
+static void
+H5F__log_write(const H5F_log_rec_t *batch, size_t n, char *buf, size_t buf_size)
+{
+  size_t u, len = 0;
+
+  if (H5F_log_async_g.stream == NULL) {
+    for (u = 0; u < n; u++)
+      ZF_LOGI("%i %s", batch[u].entry_type_code, batch[u].body);
+    return;
+  }
+
+  for (u = 0; u < n; u++) {
+    int ret = snprintf(buf + len, buf_size - len, "%llu.%09llu %i %s\n",
+                       (unsigned long long)(batch[u].timestamp / 1000000000ULL),
+                       (unsigned long long)(batch[u].timestamp % 1000000000ULL),
+                       batch[u].entry_type_code, batch[u].body);
+
+    if (ret > 0)
+      len += ((size_t)ret < buf_size - len) ? (size_t)ret : buf_size - len - 1;
+  }
+  fwrite(buf, 1, len, H5F_log_async_g.stream);
+  fflush(H5F_log_async_g.stream);
+}
+
+
+/* Background thread.  Everything it needs is set up by
+ * H5F_vfd_swmr_log_async_start(), so it can't fail once started.
+ */
+static void *
+H5F__log_thread(void *arg)
+{
+  (void)arg;
+
+  for (;;) {
+    int stopping = __atomic_load_n(&H5F_log_async_g.stopping, __ATOMIC_ACQUIRE);
+    size_t n = H5F__log_collect(H5F_log_async_g.batch);
+
+    if (n > 0)
+      H5F__log_write(H5F_log_async_g.batch, n, H5F_log_async_g.buf, H5F_log_async_g.buf_size);
+    else if (stopping)
+      break;
+    else
+      H5F__log_sleep(H5F_LOG_IDLE_NS);
+  }
+
+  return NULL;
+}
+
+
+/* Send SWMR log entries through per-thread rings and a background thread.
+ * Each posting thread gets a ring of RING_SIZE records, rounded up to a
+ * power of 2.  OVERFLOW says what to do when a ring is full.  Entries are
+ * written to STREAM in batches, or passed on to ZF_LOGI when it is NULL.
+ *
+ * Returns 0 on success, -1 on failure or if the log is already running.
+ */
+int
+H5F_vfd_swmr_log_async_start(size_t ring_size, H5F_log_overflow_t overflow, FILE *stream)
+{
+  uint64_t cap = 2;
+
+  if (H5F_log_async_g.running || ring_size == 0)
+    return -1;
+
+  while (cap < ring_size)
+    cap <<= 1;
+  H5F_log_async_g.mask = cap - 1;
+  H5F_log_async_g.overflow = overflow;
+  H5F_log_async_g.stream = stream;
+  H5F_log_async_g.stopping = 0;
+  H5F_log_async_g.cursor = NULL;
+  __atomic_store_n(&H5F_log_async_g.dropped, 0, __ATOMIC_RELAXED);
+
+  /* Room for a full batch of the longest lines */
+  H5F_log_async_g.buf_size = stream ? (size_t)H5F_LOG_BATCH_SIZE * (H5F_LOG_BODY_SIZE + 48) : 0;
+  H5F_log_async_g.batch = (H5F_log_rec_t *)malloc(H5F_LOG_BATCH_SIZE * sizeof(H5F_log_rec_t));
+  H5F_log_async_g.buf = stream ? (char *)malloc(H5F_log_async_g.buf_size) : NULL;
+  if (H5F_log_async_g.batch == NULL || (stream && H5F_log_async_g.buf == NULL)) {
+    ZF_LOGE("can't allocate SWMR log batch");
+    goto error;
+  }
+
+  if (pthread_key_create(&H5F_log_async_g.key, NULL))
+    goto error;
+  if (pthread_create(&H5F_log_async_g.thread, NULL, H5F__log_thread, NULL)) {
+    pthread_key_delete(H5F_log_async_g.key);
+    goto error;
+  }
+
+  __atomic_store_n(&H5F_log_async_g.running, 1, __ATOMIC_SEQ_CST);
+  return 0;
+
+error:
+  free(H5F_log_async_g.buf);
+  free(H5F_log_async_g.batch);
+  H5F_log_async_g.buf = NULL;
+  H5F_log_async_g.batch = NULL;
+  return -1;
+}
+
+
+/* Write out every pending entry, stop the background thread and go back
+ * to logging entries synchronously.  Threads may go on posting entries
+ * meanwhile: the rings are only freed once every push under way has
+ * finished, and later entries are logged synchronously.
+ *
+ * Returns 0 on success, -1 if the log isn't running.
+ */
+int
+H5F_vfd_swmr_log_async_stop(void)
+{
+  H5F_log_ring_t *ring, *next;
+
+  if (!H5F_log_async_g.running)
+    return -1;
+
+  /* Pairs with the count of posters in H5F_post_vfd_swrm_log_entry():
+   * a poster either sees the log stopped or is waited for here.  The
+   * background thread keeps draining meanwhile, so posters blocked on a
+   * full ring get through.
+   */
+  __atomic_store_n(&H5F_log_async_g.running, 0, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(&H5F_log_async_g.nposters, __ATOMIC_SEQ_CST) > 0)
+    H5F__log_sleep(H5F_LOG_BLOCK_NS);
+
+  __atomic_store_n(&H5F_log_async_g.stopping, 1, __ATOMIC_RELEASE);
+  pthread_join(H5F_log_async_g.thread, NULL);
+
+  for (ring = H5F_log_async_g.rings; ring; ring = next) {
+    next = ring->next;
+    free(ring->recs);
+    free(ring);
+  }
+  H5F_log_async_g.rings = NULL;
+  H5F_log_async_g.cursor = NULL;
+  pthread_key_delete(H5F_log_async_g.key);
+  free(H5F_log_async_g.buf);
+  free(H5F_log_async_g.batch);
+  H5F_log_async_g.buf = NULL;
+  H5F_log_async_g.batch = NULL;
+
+  return 0;
+}
+
+
+/* Number of entries dropped because a ring was full, since the last start */
+unsigned long long
+H5F_vfd_swmr_log_async_dropped(void)
+{
+  return (unsigned long long)__atomic_load_n(&H5F_log_async_g.dropped, __ATOMIC_RELAXED);
+}
+
+
+void
 H5F_post_vfd_swrm_log_entry(hid_t fid, int entry_type_code, char * body)
 {
-  if (fid < 0) 
+  if (fid < 0)
+    return; 			/* No operation */
+
+  /* Count in before looking at the mode, so that
+   * H5F_vfd_swmr_log_async_stop() doesn't free the rings under the push
+   */
+  __atomic_fetch_add(&H5F_log_async_g.nposters, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&H5F_log_async_g.running, __ATOMIC_SEQ_CST)) {
+    H5F__log_push(entry_type_code, body);
+    __atomic_fetch_sub(&H5F_log_async_g.nposters, 1, __ATOMIC_RELEASE);
+  }
+  else {
+    __atomic_fetch_sub(&H5F_log_async_g.nposters, 1, __ATOMIC_RELEASE);
+    ZF_LOGI("%i %s", entry_type_code, body);
+  }
+}
+
+/* Binary SWMR event log.
+ *
+ * H5F_post_vfd_swmr_log_event() appends a fixed-size record per event to
+ * the file named by log_file_path in the file's VFD SWMR configuration,
+ * with H5F_LOG_EVENT_SUFFIX added so it doesn't clash with the text log.
+ * test/swmrlog2csv.py converts the log to CSV or Parquet.
+ *
+ * The log starts with an 8 byte header: the magic "H5SE", a format
+ * version byte, the record size in bytes and two reserved bytes.  Each
+ * record holds, little-endian:
+ *
+ *      tick            uint64
+ *      timestamp       uint64, CLOCK_MONOTONIC ns
+ *      duration        uint64, ns
+ *      bytes           uint64
+ *      entry type code int32
+ *      metadata pages  uint32
+ *      raw data pages  uint32
+ *      reserved        uint32
+ *
+ * Logs are keyed by file ID.  The library never hands out an ID twice, so
+ * a log whose ID is no longer valid belongs to a closed file: the next
+ * event for it, or an open that finds the table full, closes that log.
+ * H5F_vfd_swmr_log_event_close() closes a log straight away.
+ */
+
+#define H5F_LOG_EVENT_SUFFIX    ".bin"
+#define H5F_LOG_EVENT_MAGIC     "H5SE"
+#define H5F_LOG_EVENT_VERSION   1
+#define H5F_LOG_EVENT_REC_SIZE  48
+
+/* Max. # of files with an event log open at once */
+#define H5F_LOG_EVENT_MAX_FILES 16
+
+/* One event */
+typedef struct H5F_vfd_swmr_log_event_t {
+  uint64_t tick;                /* Tick number */
+  uint64_t timestamp;           /* CLOCK_MONOTONIC time, in ns, 0 for "now" */
+  uint64_t duration;            /* Duration, in ns */
+  uint64_t bytes;               /* Bytes moved */
+  int entry_type_code;          /* Entry type code, as for H5F_post_vfd_swrm_log_entry() */
+  uint32_t md_pages;            /* Metadata pages involved */
+  uint32_t raw_pages;           /* Raw data pages involved */
+} H5F_vfd_swmr_log_event_t;
+
+/* Event logs of open files */
+static struct {
+  pthread_mutex_t mutex;        /* Protects the table */
+  struct {
+    hid_t fid;                  /* Caller's file ID, the key of the entry */
+    int is_file;                /* Whether FID was checked to be a library file ID */
+    FILE *fp;                   /* Event log */
+  } files[H5F_LOG_EVENT_MAX_FILES];
+  int nfiles;                   /* # of used entries */
+} H5F_log_event_g = {PTHREAD_MUTEX_INITIALIZER, {{0, 0, NULL}}, 0};
+
+int H5F_vfd_swmr_log_event_close(hid_t fid);
+
+
+static uint8_t *
+H5F__log_encode(uint8_t *p, uint64_t val, unsigned size)
+{
+  unsigned u;
+
+  for (u = 0; u < size; u++, val >>= 8)
+    *p++ = (uint8_t)(val & 0xff);
+  return p;
+}
+
+
+/* Find the event log of FID, or NULL.  Call with the table locked. */
+static FILE *
+H5F__log_event_find(hid_t fid)
+{
+  int i;
+
+  for (i = 0; i < H5F_log_event_g.nfiles; i++)
+    if (H5F_log_event_g.files[i].fid == fid)
+      return H5F_log_event_g.files[i].fp;
+  return NULL;
+}
+
+
+/* Close the logs of library files that have been closed.  Only runs
+ * when a log is opened, never per event.  The IDs are checked with the
+ * table unlocked, as H5Iis_valid() takes the library lock.
+ */
+static void
+H5F__log_event_prune(void)
+{
+  hid_t fids[H5F_LOG_EVENT_MAX_FILES];
+  int i, n = 0;
+
+  pthread_mutex_lock(&H5F_log_event_g.mutex);
+  for (i = 0; i < H5F_log_event_g.nfiles; i++)
+    if (H5F_log_event_g.files[i].is_file)
+      fids[n++] = H5F_log_event_g.files[i].fid;
+  pthread_mutex_unlock(&H5F_log_event_g.mutex);
+
+  for (i = 0; i < n; i++)
+    if (H5Iis_valid(fids[i]) <= 0)
+      H5F_vfd_swmr_log_event_close(fids[i]);
+}
+
+
+/* Open the event log for FID at PATH, or at the log_file_path of FID's
+ * VFD SWMR configuration plus H5F_LOG_EVENT_SUFFIX when PATH is NULL.
+ * A log that already exists is appended to.
+ *
+ * FID is the key events are posted with.  It is only checked here: with
+ * a NULL PATH it must be an open file, whose log is closed once a later
+ * open finds the file closed.  With a PATH, it can be any ID the caller
+ * likes, and the log stays open until H5F_vfd_swmr_log_event_close().
+ *
+ * Returns 0 on success, -1 on failure or if FID has no log path.
+ */
+int
+H5F_vfd_swmr_log_event_open(hid_t fid, const char *path)
+{
+  char name[H5F__MAX_VFD_SWMR_FILE_NAME_LEN + sizeof(H5F_LOG_EVENT_SUFFIX)];
+  uint8_t hdr[8];
+  FILE *fp;
+  int is_file = (path == NULL);
+  int ret_value = -1;
+
+  if (fid < 0)
+    return -1;
+
+  if (path == NULL) {
+    H5F_vfd_swmr_config_t config;
+    hid_t fapl;
+
+    if ((fapl = H5Fget_access_plist(fid)) < 0)
+      return -1;
+    if (H5Pget_vfd_swmr_config(fapl, &config) < 0 || config.log_file_path[0] == '\0') {
+      H5Pclose(fapl);
+      return -1;
+    }
+    H5Pclose(fapl);
+    snprintf(name, sizeof(name), "%s%s", config.log_file_path, H5F_LOG_EVENT_SUFFIX);
+    path = name;
+  }
+
+  /* Make room from closed files */
+  H5F__log_event_prune();
+
+  pthread_mutex_lock(&H5F_log_event_g.mutex);
+
+  if (H5F__log_event_find(fid) != NULL) {
+    ret_value = 0;
+    goto done;
+  }
+  if (H5F_log_event_g.nfiles == H5F_LOG_EVENT_MAX_FILES) {
+    ZF_LOGE("too many SWMR event logs open");
+    goto done;
+  }
+  if ((fp = fopen(path, "ab")) == NULL) {
+    ZF_LOGE("can't open SWMR event log %s", path);
+    goto done;
+  }
+
+  /* Start a new log with its header */
+  if (ftell(fp) == 0) {
+    memcpy(hdr, H5F_LOG_EVENT_MAGIC, 4);
+    hdr[4] = H5F_LOG_EVENT_VERSION;
+    hdr[5] = H5F_LOG_EVENT_REC_SIZE;
+    hdr[6] = hdr[7] = 0;
+    if (fwrite(hdr, sizeof(hdr), 1, fp) != 1) {
+      fclose(fp);
+      goto done;
+    }
+  }
+
+  H5F_log_event_g.files[H5F_log_event_g.nfiles].fid = fid;
+  H5F_log_event_g.files[H5F_log_event_g.nfiles].is_file = is_file;
+  H5F_log_event_g.files[H5F_log_event_g.nfiles].fp = fp;
+  H5F_log_event_g.nfiles++;
+  ret_value = 0;
+
+done:
+  pthread_mutex_unlock(&H5F_log_event_g.mutex);
+  return ret_value;
+}
+
+
+/* Flush and close the event log of FID, if it has one.  An event posted
+ * for FID afterwards opens the log again.
+ */
+int
+H5F_vfd_swmr_log_event_close(hid_t fid)
+{
+  int i, ret_value = 0;
+
+  pthread_mutex_lock(&H5F_log_event_g.mutex);
+  for (i = 0; i < H5F_log_event_g.nfiles; i++)
+    if (H5F_log_event_g.files[i].fid == fid) {
+      if (fclose(H5F_log_event_g.files[i].fp) != 0)
+        ret_value = -1;
+      H5F_log_event_g.files[i] = H5F_log_event_g.files[--H5F_log_event_g.nfiles];
+      break;
+    }
+  pthread_mutex_unlock(&H5F_log_event_g.mutex);
+
+  return ret_value;
+}
+
+
+/* Append EV to the event log of FID, opening the log on the first event.
+ * Records are buffered by stdio and reach the disk when the buffer fills
+ * or the log is closed.  FID is only looked up in the table; it was
+ * checked when its log was opened.
+ */
+void
+H5F_post_vfd_swmr_log_event(hid_t fid, const H5F_vfd_swmr_log_event_t *ev)
+{
+  uint8_t rec[H5F_LOG_EVENT_REC_SIZE];
+  uint8_t *p = rec;
+  FILE *fp;
+
+  if (fid < 0 || ev == NULL)
     return; 			/* No operation */
 
-  ZF_LOGI("%i %s", entry_type_code, body);
+  p = H5F__log_encode(p, ev->tick, 8);
+  p = H5F__log_encode(p, ev->timestamp ? ev->timestamp : H5F__log_now(), 8);
+  p = H5F__log_encode(p, ev->duration, 8);
+  p = H5F__log_encode(p, ev->bytes, 8);
+  p = H5F__log_encode(p, (uint64_t)(uint32_t)ev->entry_type_code, 4);
+  p = H5F__log_encode(p, ev->md_pages, 4);
+  p = H5F__log_encode(p, ev->raw_pages, 4);
+  p = H5F__log_encode(p, 0, 4);
+
+  /* The table stays locked across the write, so that
+   * H5F_vfd_swmr_log_event_close() can't close the stream under it
+   */
+  pthread_mutex_lock(&H5F_log_event_g.mutex);
+  if ((fp = H5F__log_event_find(fid)) == NULL) {
+    pthread_mutex_unlock(&H5F_log_event_g.mutex);
+    if (H5F_vfd_swmr_log_event_open(fid, NULL) < 0)
+      return;
+    pthread_mutex_lock(&H5F_log_event_g.mutex);
+    fp = H5F__log_event_find(fid);
+  }
+  if (fp == NULL || fwrite(rec, sizeof(rec), 1, fp) != 1)
+    ZF_LOGW("can't write SWMR event log record");
+  pthread_mutex_unlock(&H5F_log_event_g.mutex);
+}
+
+
+/* Streaming log sink.
+ *
+ * H5F_vfd_swmr_log_sink_callback() is a zf_log output callback that turns
+ * each log line into a JSON document and ships it in batches, so SWMR and
+ * I/O metrics can be searched seconds after they are logged, without the
+ * copy / mongoimport / Beam / mongolastic passes of bin/cron.sh:
+ *
+ *   zf_log_set_output_v(H5F_LOG_SINK_OUT);
+ *
+ * Documents look like
+ *
+ *   {"@timestamp":"2018-09-10T12:00:00.123Z","host":"jelly","pid":42,
+ *    "level":"info","tag":"...","code":3,"msg":"..."}
+ *
+ * where "code" is the entry type code of H5F_post_vfd_swrm_log_entry()
+ * lines and "tag" is only there for tagged lines.
+ *
+ * Documents are appended to one of two buffers of max_bytes / 2 each.  A
+ * background thread swaps them and sends the full one every flush_ms, or
+ * as soon as it is half full, while the other fills.  A document that
+ * doesn't fit is dropped and counted (see H5F_vfd_swmr_log_sink_dropped()),
+ * so a slow or unreachable server never holds up the logging thread nor
+ * takes more than max_bytes.  Documents that fail to send are counted too,
+ * including those an Elasticsearch bulk reply lists with an error.  HTTP
+ * requests time out after about flush_ms, so the background thread keeps
+ * pace with the buffers.
+ *
+ * The sink URL gives the transport:
+ *
+ *   http://HOST:PORT/INDEX   Elasticsearch bulk API, with H5F_LOG_HAVE_CURL
+ *   kafka://BROKERS/TOPIC    Kafka topic, with H5F_LOG_HAVE_LIBRDKAFKA
+ *   file://PATH              NDJSON file, e.g. for mongoimport or Filebeat
+ */
+
+/* Longest document, longer messages are truncated */
+#define H5F_LOG_SINK_DOC_SIZE   1024
+
+/* Smallest max_bytes */
+#define H5F_LOG_SINK_MIN_BYTES  (4 * H5F_LOG_SINK_DOC_SIZE)
+
+/* Elasticsearch bulk action line before each document */
+#define H5F_LOG_SINK_ES_ACTION  "{\"index\":{}}\n"
+
+/* Shortest HTTP request timeout, whatever flush_ms is */
+#define H5F_LOG_SINK_MIN_TIMEOUT_MS 1000L
+
+/* Markers of failures in an Elasticsearch bulk reply: the top level flag
+ * and the error object of each failed item
+ */
+#define H5F_LOG_SINK_ES_ERRORS  "\"errors\":true"
+#define H5F_LOG_SINK_ES_ERROR   "\"error\":"
+
+/* Time given to Kafka to deliver what's queued when the sink stops */
+#define H5F_LOG_SINK_KAFKA_FLUSH_MS 10000
+
+/* zf_log output spec of the sink, see ZF_LOG_OUT_STDERR */
+#define H5F_LOG_SINK_OUT ZF_LOG_PUT_MSG, NULL, H5F_vfd_swmr_log_sink_callback
+
+/* Transports */
+typedef enum H5F_log_sink_kind_t {
+  H5F_LOG_SINK_FILE,            /* NDJSON file */
+  H5F_LOG_SINK_ELASTIC,         /* Elasticsearch bulk API */
+  H5F_LOG_SINK_KAFKA            /* Kafka topic */
+} H5F_log_sink_kind_t;
+
+/* State of the sink */
+static struct {
+  int running;                  /* Whether the callback takes documents */
+  int stopping;                 /* Set to make the background thread finish */
+  H5F_log_sink_kind_t kind;     /* Transport */
+  size_t half;                  /* Capacity of each buffer */
+  long flush_ms;                /* Longest time a document waits in a buffer */
+  char *bufs[2];                /* Buffers */
+  int cur;                      /* Buffer being filled */
+  size_t len;                   /* Bytes in the buffer being filled */
+  size_t ndocs;                 /* Documents in the buffer being filled */
+  unsigned long long dropped;   /* # of documents dropped or not sent */
+  char host[64];                /* Host name put into documents */
+  pthread_mutex_t mutex;        /* Protects the buffers and counters */
+  pthread_cond_t cond;          /* Signals the background thread */
+  pthread_t thread;             /* Background thread */
+  FILE *fp;                     /* File transport */
+#ifdef H5F_LOG_HAVE_CURL
+  int curl_global;              /* Whether curl_global_init() needs undoing */
+  CURL *curl;                   /* Elasticsearch transport */
+  struct curl_slist *headers;   /* Request headers */
+  size_t errors_at;             /* Chars of H5F_LOG_SINK_ES_ERRORS matched in the reply */
+  size_t error_at;              /* Chars of H5F_LOG_SINK_ES_ERROR matched in the reply */
+  int errors;                   /* Whether the reply has H5F_LOG_SINK_ES_ERRORS */
+  size_t nerrors;               /* # of H5F_LOG_SINK_ES_ERROR in the reply */
+#endif
+#ifdef H5F_LOG_HAVE_LIBRDKAFKA
+  rd_kafka_t *rk;               /* Kafka transport */
+  rd_kafka_topic_t *rkt;        /* Kafka topic */
+#endif
+} H5F_log_sink_g;
+
+
+/* Append the JSON string escape of the N bytes at S to DST, which has
+ * ROOM bytes left, truncating if it doesn't fit.  Returns the number of
+ * bytes appended.
+ */
+static size_t
+H5F__log_sink_escape(char *dst, size_t room, const char *s, size_t n)
+{
+  size_t u, len = 0;
+
+  for (u = 0; u < n; u++) {
+    unsigned char c = (unsigned char)s[u];
+    char esc[8];
+    size_t elen = 0;
+
+    if (c == '"' || c == '\\') {
+      esc[elen++] = '\\';
+      esc[elen++] = (char)c;
+    }
+    else if (c < 0x20)
+      elen = (size_t)snprintf(esc, sizeof(esc), "\\u%04x", c);
+    else
+      esc[elen++] = (char)c;
+
+    if (len + elen > room)
+      break;
+    memcpy(dst + len, esc, elen);
+    len += elen;
+  }
+
+  return len;
+}
+
+
+/* Format MSG as a document into DOC, of H5F_LOG_SINK_DOC_SIZE bytes.
+ * Returns the length of the document, newline included.
+ */
+static size_t
+H5F__log_sink_format(const zf_log_message *msg, char *doc)
+{
+  static const char *const levels[] = {"", "verbose", "debug", "info", "warn", "error", "fatal"};
+  /* Keep room for the closing "}\n */
+  const size_t room = H5F_LOG_SINK_DOC_SIZE - 3;
+  const char *b = msg->msg_b, *e = msg->p, *s;
+  struct timespec ts;
+  struct tm tm;
+  char stamp[32];
+  size_t len = 0;
+  int ret;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  gmtime_r(&ts.tv_sec, &tm);
+  strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm);
+
+  if (H5F_log_sink_g.kind == H5F_LOG_SINK_ELASTIC) {
+    memcpy(doc, H5F_LOG_SINK_ES_ACTION, sizeof(H5F_LOG_SINK_ES_ACTION) - 1);
+    len = sizeof(H5F_LOG_SINK_ES_ACTION) - 1;
+  }
+  ret = snprintf(doc + len, room - len, "{\"@timestamp\":\"%s.%03ldZ\",\"host\":\"%s\",\"pid\":%ld,\"level\":\"%s\"",
+                 stamp, ts.tv_nsec / 1000000L, H5F_log_sink_g.host, (long)getpid(),
+                 (msg->lvl > 0 && msg->lvl <= ZF_LOG_FATAL) ? levels[msg->lvl] : "none");
+  if (ret > 0)
+    len += ((size_t)ret < room - len) ? (size_t)ret : room - len - 1;
+
+  if (msg->tag && len + 9 < room) {
+    memcpy(doc + len, ",\"tag\":\"", 8);
+    len += 8;
+    len += H5F__log_sink_escape(doc + len, room - len - 1, msg->tag, strlen(msg->tag));
+    doc[len++] = '"';
+  }
+
+  /* Lines of H5F_post_vfd_swrm_log_entry() start with the type code */
+  for (s = (b < e && *b == '-') ? b + 1 : b; s < e && *s >= '0' && *s <= '9'; s++)
+    ;
+  if (s < e && *s == ' ' && s > b && s[-1] != '-' && s - b < 12) {
+    ret = snprintf(doc + len, room - len, ",\"code\":%.*s", (int)(s - b), b);
+    if (ret > 0 && (size_t)ret < room - len) {
+      len += (size_t)ret;
+      b = s + 1;
+    }
+  }
+
+  if (len + 9 < room) {
+    memcpy(doc + len, ",\"msg\":\"", 8);
+    len += 8;
+    len += H5F__log_sink_escape(doc + len, room - len - 1, b, (size_t)(e - b));
+    doc[len++] = '"';
+  }
+  doc[len++] = '}';
+  doc[len++] = '\n';
+
+  return len;
+}
+
+
+#ifdef H5F_LOG_HAVE_CURL
+/* Discard the bulk API response, only its status is checked */
+static size_t
+H5F__log_sink_curl_write(char *ptr, size_t size, size_t nmemb, void *arg)
+{
+  size_t u, n = size * nmemb;
+
+  (void)arg;
+
+  /* The reply comes in pieces, so the markers are matched a char at a
+   * time.  Neither marker can restart part-way but at its opening quote.
+   */
+  for (u = 0; u < n; u++) {
+    char c = ptr[u];
+
+    if (c == H5F_LOG_SINK_ES_ERRORS[H5F_log_sink_g.errors_at])
+      H5F_log_sink_g.errors_at++;
+    else
+      H5F_log_sink_g.errors_at = (c == '"');
+    if (H5F_log_sink_g.errors_at == sizeof(H5F_LOG_SINK_ES_ERRORS) - 1) {
+      H5F_log_sink_g.errors = 1;
+      H5F_log_sink_g.errors_at = 0;
+    }
+
+    if (c == H5F_LOG_SINK_ES_ERROR[H5F_log_sink_g.error_at])
+      H5F_log_sink_g.error_at++;
+    else
+      H5F_log_sink_g.error_at = (c == '"');
+    if (H5F_log_sink_g.error_at == sizeof(H5F_LOG_SINK_ES_ERROR) - 1) {
+      H5F_log_sink_g.nerrors++;
+      H5F_log_sink_g.error_at = 0;
+    }
+  }
+
+  return n;
+}
+#endif
+
+
+/* Send the N documents of LEN bytes at BUF.  Returns the number of
+ * documents that weren't sent, 0 on success.
+ */
+static size_t
+H5F__log_sink_send(const char *buf, size_t len, size_t n)
+{
+  switch (H5F_log_sink_g.kind) {
+  case H5F_LOG_SINK_FILE:
+    if (fwrite(buf, 1, len, H5F_log_sink_g.fp) != len || fflush(H5F_log_sink_g.fp))
+      return n;
+    return 0;
+
+  case H5F_LOG_SINK_ELASTIC:
+#ifdef H5F_LOG_HAVE_CURL
+  {
+    long status = 0;
+    int attempt;
+    CURLcode rc;
+
+    /* One retry, for a dropped keep-alive connection, but not after a
+     * timeout
+     */
+    for (attempt = 0; attempt < 2; attempt++) {
+      H5F_log_sink_g.errors_at = H5F_log_sink_g.error_at = 0;
+      H5F_log_sink_g.errors = 0;
+      H5F_log_sink_g.nerrors = 0;
+      curl_easy_setopt(H5F_log_sink_g.curl, CURLOPT_POSTFIELDS, buf);
+      curl_easy_setopt(H5F_log_sink_g.curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)len);
+      if ((rc = curl_easy_perform(H5F_log_sink_g.curl)) == CURLE_OK
+          && curl_easy_getinfo(H5F_log_sink_g.curl, CURLINFO_RESPONSE_CODE, &status) == CURLE_OK
+          && status >= 200 && status < 300) {
+        /* The other items were indexed, so a partial failure isn't
+         * retried.  A reply flagging errors without listing any fails
+         * the whole batch.
+         */
+        if (!H5F_log_sink_g.errors)
+          return 0;
+        return H5F_log_sink_g.nerrors > 0 && H5F_log_sink_g.nerrors < n ? H5F_log_sink_g.nerrors : n;
+      }
+      if (rc == CURLE_OPERATION_TIMEDOUT)
+        break;
+    }
+  }
+#endif
+    return n;
+
+  case H5F_LOG_SINK_KAFKA:
+#ifdef H5F_LOG_HAVE_LIBRDKAFKA
+  {
+    const char *b = buf, *e = buf + len;
+    size_t failed = 0;
+
+    /* One message per document; the producer batches them again */
+    while (b < e) {
+      const char *nl = (const char *)memchr(b, '\n', (size_t)(e - b));
+
+      while (rd_kafka_produce(H5F_log_sink_g.rkt, RD_KAFKA_PARTITION_UA, RD_KAFKA_MSG_F_COPY,
+                              (void *)b, (size_t)(nl - b), NULL, 0, NULL) < 0) {
+        if (rd_kafka_last_error() != RD_KAFKA_RESP_ERR__QUEUE_FULL) {
+          failed++;
+          break;
+        }
+        rd_kafka_poll(H5F_log_sink_g.rk, 100);
+      }
+      b = nl + 1;
+    }
+    rd_kafka_poll(H5F_log_sink_g.rk, 0);
+    return failed;
+  }
+#else
+    return n;
+#endif
+  }
+
+  return n;
 }
 
+
+static void *
+H5F__log_sink_thread(void *arg)
+{
+  (void)arg;
+
+  for (;;) {
+    struct timespec deadline;
+    const char *buf;
+    size_t len, n, failed;
+    int stopping;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += H5F_log_sink_g.flush_ms / 1000;
+    deadline.tv_nsec += (H5F_log_sink_g.flush_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&H5F_log_sink_g.mutex);
+    while (!H5F_log_sink_g.stopping && H5F_log_sink_g.len < H5F_log_sink_g.half / 2)
+      if (pthread_cond_timedwait(&H5F_log_sink_g.cond, &H5F_log_sink_g.mutex, &deadline))
+        break;
+    stopping = H5F_log_sink_g.stopping;
+    buf = H5F_log_sink_g.bufs[H5F_log_sink_g.cur];
+    len = H5F_log_sink_g.len;
+    n = H5F_log_sink_g.ndocs;
+    H5F_log_sink_g.cur ^= 1;
+    H5F_log_sink_g.len = 0;
+    H5F_log_sink_g.ndocs = 0;
+    pthread_mutex_unlock(&H5F_log_sink_g.mutex);
+
+    /* zf_log may be sending here, so failures aren't logged */
+    if (len > 0 && (failed = H5F__log_sink_send(buf, len, n)) > 0) {
+      pthread_mutex_lock(&H5F_log_sink_g.mutex);
+      H5F_log_sink_g.dropped += failed;
+      pthread_mutex_unlock(&H5F_log_sink_g.mutex);
+    }
+    if (stopping && len == 0)
+      break;
+  }
+
+  return NULL;
+}
+
+
+/* zf_log output callback, use with H5F_LOG_SINK_OUT */
+void
+H5F_vfd_swmr_log_sink_callback(const zf_log_message *msg, void *arg)
+{
+  char doc[H5F_LOG_SINK_DOC_SIZE];
+  size_t len;
+
+  (void)arg;
+  if (!__atomic_load_n(&H5F_log_sink_g.running, __ATOMIC_ACQUIRE))
+    return;
+
+  len = H5F__log_sink_format(msg, doc);
+
+  pthread_mutex_lock(&H5F_log_sink_g.mutex);
+  if (H5F_log_sink_g.len + len > H5F_log_sink_g.half)
+    H5F_log_sink_g.dropped++;
+  else {
+    memcpy(H5F_log_sink_g.bufs[H5F_log_sink_g.cur] + H5F_log_sink_g.len, doc, len);
+    H5F_log_sink_g.len += len;
+    H5F_log_sink_g.ndocs++;
+  }
+  if (H5F_log_sink_g.len >= H5F_log_sink_g.half / 2)
+    pthread_cond_signal(&H5F_log_sink_g.cond);
+  pthread_mutex_unlock(&H5F_log_sink_g.mutex);
+}
+
+
+/* Close the transport of the sink */
+static void
+H5F__log_sink_close(void)
+{
+  switch (H5F_log_sink_g.kind) {
+  case H5F_LOG_SINK_FILE:
+    if (H5F_log_sink_g.fp)
+      fclose(H5F_log_sink_g.fp);
+    H5F_log_sink_g.fp = NULL;
+    break;
+
+  case H5F_LOG_SINK_ELASTIC:
+#ifdef H5F_LOG_HAVE_CURL
+    if (H5F_log_sink_g.curl)
+      curl_easy_cleanup(H5F_log_sink_g.curl);
+    curl_slist_free_all(H5F_log_sink_g.headers);
+    H5F_log_sink_g.curl = NULL;
+    H5F_log_sink_g.headers = NULL;
+    if (H5F_log_sink_g.curl_global)
+      curl_global_cleanup();
+    H5F_log_sink_g.curl_global = 0;
+#endif
+    break;
+
+  case H5F_LOG_SINK_KAFKA:
+#ifdef H5F_LOG_HAVE_LIBRDKAFKA
+    if (H5F_log_sink_g.rk && rd_kafka_flush(H5F_log_sink_g.rk, H5F_LOG_SINK_KAFKA_FLUSH_MS) != RD_KAFKA_RESP_ERR_NO_ERROR)
+      H5F_log_sink_g.dropped += (unsigned long long)rd_kafka_outq_len(H5F_log_sink_g.rk);
+    if (H5F_log_sink_g.rkt)
+      rd_kafka_topic_destroy(H5F_log_sink_g.rkt);
+    if (H5F_log_sink_g.rk)
+      rd_kafka_destroy(H5F_log_sink_g.rk);
+    H5F_log_sink_g.rkt = NULL;
+    H5F_log_sink_g.rk = NULL;
+#endif
+    break;
+  }
+}
+
+
+/* Open the transport of URL.  Returns 0 on success, -1 on failure. */
+static int
+H5F__log_sink_open(const char *url)
+{
+  if (strncmp(url, "file://", 7) == 0) {
+    H5F_log_sink_g.kind = H5F_LOG_SINK_FILE;
+    return (H5F_log_sink_g.fp = fopen(url + 7, "a")) ? 0 : -1;
+  }
+
+  if (strncmp(url, "http://", 7) == 0 || strncmp(url, "https://", 8) == 0) {
+    H5F_log_sink_g.kind = H5F_LOG_SINK_ELASTIC;
+#ifdef H5F_LOG_HAVE_CURL
+  {
+    char endpoint[1024];
+    size_t n = strlen(url);
+    long timeout_ms;
+
+    /* http://HOST:PORT/INDEX/_bulk */
+    while (n > 0 && url[n - 1] == '/')
+      n--;
+    if (n + sizeof("/_bulk") > sizeof(endpoint))
+      return -1;
+    snprintf(endpoint, sizeof(endpoint), "%.*s/_bulk", (int)n, url);
+
+    /* Each start is paired with the curl_global_cleanup() of its stop */
+    if (curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK)
+      return -1;
+    H5F_log_sink_g.curl_global = 1;
+    if ((H5F_log_sink_g.curl = curl_easy_init()) == NULL
+        || (H5F_log_sink_g.headers = curl_slist_append(NULL, "Content-Type: application/x-ndjson")) == NULL) {
+      H5F__log_sink_close();
+      return -1;
+    }
+    curl_easy_setopt(H5F_log_sink_g.curl, CURLOPT_URL, endpoint);
+    curl_easy_setopt(H5F_log_sink_g.curl, CURLOPT_HTTPHEADER, H5F_log_sink_g.headers);
+    curl_easy_setopt(H5F_log_sink_g.curl, CURLOPT_WRITEFUNCTION, H5F__log_sink_curl_write);
+    curl_easy_setopt(H5F_log_sink_g.curl, CURLOPT_NOSIGNAL, 1L);
+
+    /* A stuck server holds up at most about one flush of the other buffer */
+    timeout_ms = H5F_log_sink_g.flush_ms > H5F_LOG_SINK_MIN_TIMEOUT_MS ? H5F_log_sink_g.flush_ms : H5F_LOG_SINK_MIN_TIMEOUT_MS;
+    curl_easy_setopt(H5F_log_sink_g.curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+    curl_easy_setopt(H5F_log_sink_g.curl, CURLOPT_CONNECTTIMEOUT_MS, timeout_ms / 2);
+    return 0;
+  }
+#else
+    return -1;
+#endif
+  }
+
+  if (strncmp(url, "kafka://", 8) == 0) {
+    H5F_log_sink_g.kind = H5F_LOG_SINK_KAFKA;
+#ifdef H5F_LOG_HAVE_LIBRDKAFKA
+  {
+    const char *topic = strchr(url + 8, '/');
+    char brokers[1024], val[32], errstr[512];
+    rd_kafka_conf_t *conf;
+
+    if (topic == NULL || topic[1] == '\0' || (size_t)(topic - url - 8) >= sizeof(brokers))
+      return -1;
+    snprintf(brokers, sizeof(brokers), "%.*s", (int)(topic - url - 8), url + 8);
+
+    conf = rd_kafka_conf_new();
+    if (rd_kafka_conf_set(conf, "bootstrap.servers", brokers, errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+      rd_kafka_conf_destroy(conf);
+      return -1;
+    }
+    /* The producer's own queue shares the sink's memory bound */
+    snprintf(val, sizeof(val), "%ld", H5F_log_sink_g.flush_ms);
+    rd_kafka_conf_set(conf, "linger.ms", val, errstr, sizeof(errstr));
+    snprintf(val, sizeof(val), "%zu", H5F_log_sink_g.half / 1024 > 0 ? H5F_log_sink_g.half / 1024 : 1);
+    rd_kafka_conf_set(conf, "queue.buffering.max.kbytes", val, errstr, sizeof(errstr));
+    rd_kafka_conf_set(conf, "compression.type", "lz4", errstr, sizeof(errstr));
+
+    if ((H5F_log_sink_g.rk = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr))) == NULL) {
+      rd_kafka_conf_destroy(conf);
+      return -1;
+    }
+    if ((H5F_log_sink_g.rkt = rd_kafka_topic_new(H5F_log_sink_g.rk, topic + 1, NULL)) == NULL) {
+      H5F__log_sink_close();
+      return -1;
+    }
+    return 0;
+  }
+#else
+    return -1;
+#endif
+  }
+
+  return -1;
+}
+
+
+/* Start sending log documents to URL, holding at most MAX_BYTES of them
+ * and sending them at least every FLUSH_MS.  Messages only reach the sink
+ * once zf_log outputs to it, see H5F_LOG_SINK_OUT.
+ *
+ * Returns 0 on success, -1 on failure, if URL's transport isn't built in
+ * or if the sink is already running.
+ */
+int
+H5F_vfd_swmr_log_sink_start(const char *url, size_t max_bytes, long flush_ms)
+{
+  struct utsname un;
+
+  if (H5F_log_sink_g.running || url == NULL || flush_ms <= 0)
+    return -1;
+
+  if (max_bytes < H5F_LOG_SINK_MIN_BYTES)
+    max_bytes = H5F_LOG_SINK_MIN_BYTES;
+  H5F_log_sink_g.half = max_bytes / 2;
+  H5F_log_sink_g.flush_ms = flush_ms;
+  H5F_log_sink_g.cur = 0;
+  H5F_log_sink_g.len = 0;
+  H5F_log_sink_g.ndocs = 0;
+  H5F_log_sink_g.dropped = 0;
+  H5F_log_sink_g.stopping = 0;
+  if (uname(&un) < 0)
+    strcpy(un.nodename, "unknown");
+  H5F__log_sink_escape(H5F_log_sink_g.host, sizeof(H5F_log_sink_g.host) - 1, un.nodename, strlen(un.nodename));
+
+  if ((H5F_log_sink_g.bufs[0] = (char *)malloc(H5F_log_sink_g.half)) == NULL
+      || (H5F_log_sink_g.bufs[1] = (char *)malloc(H5F_log_sink_g.half)) == NULL)
+    goto error;
+  if (H5F__log_sink_open(url) < 0)
+    goto error;
+
+  pthread_mutex_init(&H5F_log_sink_g.mutex, NULL);
+  pthread_cond_init(&H5F_log_sink_g.cond, NULL);
+  if (pthread_create(&H5F_log_sink_g.thread, NULL, H5F__log_sink_thread, NULL)) {
+    pthread_cond_destroy(&H5F_log_sink_g.cond);
+    pthread_mutex_destroy(&H5F_log_sink_g.mutex);
+    goto error;
+  }
+
+  __atomic_store_n(&H5F_log_sink_g.running, 1, __ATOMIC_RELEASE);
+  return 0;
+
+error:
+  H5F__log_sink_close();
+  free(H5F_log_sink_g.bufs[0]);
+  free(H5F_log_sink_g.bufs[1]);
+  H5F_log_sink_g.bufs[0] = H5F_log_sink_g.bufs[1] = NULL;
+  return -1;
+}
+
+
+/* Send every pending document and stop the sink; later messages given to
+ * the callback are ignored.  No thread may be logging to the sink while
+ * this runs.
+ *
+ * Returns 0 on success, -1 if the sink isn't running.
+ */
+int
+H5F_vfd_swmr_log_sink_stop(void)
+{
+  if (!H5F_log_sink_g.running)
+    return -1;
+
+  __atomic_store_n(&H5F_log_sink_g.running, 0, __ATOMIC_RELEASE);
+  pthread_mutex_lock(&H5F_log_sink_g.mutex);
+  H5F_log_sink_g.stopping = 1;
+  pthread_cond_signal(&H5F_log_sink_g.cond);
+  pthread_mutex_unlock(&H5F_log_sink_g.mutex);
+  pthread_join(H5F_log_sink_g.thread, NULL);
+
+  H5F__log_sink_close();
+  pthread_cond_destroy(&H5F_log_sink_g.cond);
+  pthread_mutex_destroy(&H5F_log_sink_g.mutex);
+  free(H5F_log_sink_g.bufs[0]);
+  free(H5F_log_sink_g.bufs[1]);
+  H5F_log_sink_g.bufs[0] = H5F_log_sink_g.bufs[1] = NULL;
+
+  return 0;
+}
+
+
+/* Number of documents dropped for lack of room or not sent, since the
+ * last start */
+unsigned long long
+H5F_vfd_swmr_log_sink_dropped(void)
+{
+  unsigned long long n;
+
+  if (!H5F_log_sink_g.running)
+    return H5F_log_sink_g.dropped;
+  pthread_mutex_lock(&H5F_log_sink_g.mutex);
+  n = H5F_log_sink_g.dropped;
+  pthread_mutex_unlock(&H5F_log_sink_g.mutex);
+  return n;
+}
+
+
 /* Test. */
+static void *
+test_poster(void *arg)
+{
+  int i;
+
+  (void)arg;
+  for (i = 0; i < 1000; i++)
+    H5F_post_vfd_swrm_log_entry(1, i, "async test");
+  return NULL;
+}
+
 int main(int argc, char** argv)
 {
+  pthread_t threads[4];
+  int i;
+
   H5F_post_vfd_swrm_log_entry(1, 1, "test");
-}
 
+  if (H5F_vfd_swmr_log_async_start(256, H5F_LOG_OVERFLOW_BLOCK, stdout) < 0)
+    return 1;
+  for (i = 0; i < 4; i++)
+    pthread_create(&threads[i], NULL, test_poster, NULL);
+  for (i = 0; i < 4; i++)
+    pthread_join(threads[i], NULL);
+  H5F_vfd_swmr_log_async_stop();
+  fprintf(stderr, "dropped %llu\n", H5F_vfd_swmr_log_async_dropped());
+
+  if (H5F_vfd_swmr_log_event_open(1, "test_events.bin") < 0)
+    return 1;
+  for (i = 0; i < 10; i++) {
+    H5F_vfd_swmr_log_event_t ev = {(uint64_t)i, 0, 1000, 4096, 1, 2, 3};
 
+    H5F_post_vfd_swmr_log_event(1, &ev);
+  }
+  if (H5F_vfd_swmr_log_event_close(1) < 0)
+    return 1;
+
+  if (H5F_vfd_swmr_log_sink_start("file://test_sink.json", 1 << 16, 100) < 0)
+    return 1;
+  zf_log_set_output_v(H5F_LOG_SINK_OUT);
+  H5F_post_vfd_swrm_log_entry(1, 7, "sink \"test\"");
+  ZF_LOGW("sink warning");
+  H5F_vfd_swmr_log_sink_stop();
+  zf_log_set_output_v(ZF_LOG_OUT_STDERR);
+  fprintf(stderr, "sink dropped %llu\n", H5F_vfd_swmr_log_sink_dropped());
+
+  return 0;
+}
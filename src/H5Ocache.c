@@ -44,6 +44,16 @@
 /* Local Macros */
 /****************/
 
+/* Encoded ref. count message.  These are H5Orefcount.c's definitions under
+ * the same names, and belong with them in H5Opkg.h.
+ */
+#ifndef H5O_REFCOUNT_VERSION
+#define H5O_REFCOUNT_VERSION            0
+#endif /* H5O_REFCOUNT_VERSION */
+#ifndef H5O_REFCOUNT_SIZE
+#define H5O_REFCOUNT_SIZE               (1 + 4)         /* Version + count */
+#endif /* H5O_REFCOUNT_SIZE */
+
 
 /******************/
 /* Local Typedefs */
@@ -90,6 +100,8 @@ static herr_t H5O__prefix_deserialize(const uint8_t *image,
 static herr_t H5O__chunk_deserialize(H5O_t *oh, haddr_t addr, size_t len,
     const uint8_t *image, H5O_common_cache_ud_t *udata, hbool_t *dirty);
 static herr_t H5O__chunk_serialize(const H5F_t *f, H5O_t *oh, unsigned chunkno);
+static size_t H5O__chunk_count_msgs(const H5O_t *oh, const uint8_t *chunk_image,
+    const uint8_t *eom_ptr);
 
 /* Misc. routines */
 static herr_t H5O__add_cont_msg(H5O_cont_msgs_t *cont_msg_info,
@@ -249,6 +261,7 @@ H5O__cache_verify_chksum(const void *_image, size_t len, void *_udata)
     const uint8_t *image = (const uint8_t *)_image;    	/* Pointer into raw data buffer */
     H5O_cache_ud_t *udata = (H5O_cache_ud_t *)_udata;  	/* User data for callback */
     htri_t ret_value = TRUE;	/* Return value */
+    H5_SPAN_DECL(span_start)    /* Start of the tracing span */
 
     FUNC_ENTER_STATIC_NOERR
 
@@ -263,7 +276,8 @@ H5O__cache_verify_chksum(const void *_image, size_t len, void *_udata)
         uint32_t computed_chksum;   /* Computed metadata checksum value */
 
         /* Get stored and computed checksums */
-        H5F_get_checksums(image, len, &stored_chksum, &computed_chksum);
+        H5F_get_checksums(image, len, &stored_chksum, NULL);
+        computed_chksum = H5_checksum_metadata_fast(image, len - H5O_SIZEOF_CHKSUM, 0);
 
         if(stored_chksum != computed_chksum) {
             /* These fields are not deserialized yet in H5O__prefix_deserialize() */
@@ -280,6 +294,8 @@ H5O__cache_verify_chksum(const void *_image, size_t len, void *_udata)
     else
         HDassert(!(udata->common.file_intent & H5F_ACC_SWMR_WRITE));
 
+    H5_SPAN_END(span_start, H5_SPAN_CACHE_VERIFY_CHKSUM, H5AC_OHDR_ID, len);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5O__cache_verify_chksum() */
 
@@ -311,6 +327,7 @@ H5O__cache_deserialize(const void *image, size_t len, void *_udata,
     H5O_t          *oh = NULL;          /* Object header read in */
     H5O_cache_ud_t *udata = (H5O_cache_ud_t *)_udata;   /* User data for callback */
     void *          ret_value = NULL;   /* Return value */
+    H5_SPAN_DECL(span_start)            /* Start of the tracing span */
 
     FUNC_ENTER_STATIC
 
@@ -367,6 +384,8 @@ done:
         if(H5O__free(oh) < 0)
             HDONE_ERROR(H5E_OHDR, H5E_CANTRELEASE, NULL, "unable to destroy object header data")
 
+    H5_SPAN_END(span_start, H5_SPAN_CACHE_DESERIALIZE, H5AC_OHDR_ID, len);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5O__cache_deserialize() */
 
@@ -426,6 +445,7 @@ H5O__cache_serialize(const H5F_t *f, void *image, size_t len, void *_thing)
     H5O_t      *oh = (H5O_t *)_thing;   /* Object header to encode */
     uint8_t     *chunk_image;           /* Pointer to object header prefix buffer */
     herr_t      ret_value = SUCCEED;    /* Return value */
+    H5_SPAN_DECL(span_start)            /* Start of the tracing span */
 
     FUNC_ENTER_STATIC
 
@@ -545,6 +565,8 @@ H5O__cache_serialize(const H5F_t *f, void *image, size_t len, void *_thing)
     HDmemcpy(image, oh->chunk[0].image, len);
 
 done:
+    H5_SPAN_END(span_start, H5_SPAN_CACHE_SERIALIZE, H5AC_OHDR_ID, len);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5O__cache_serialize() */
 
@@ -736,7 +758,8 @@ H5O__cache_chk_verify_chksum(const void *_image, size_t len, void *_udata)
         uint32_t computed_chksum;   /* Computed metadata checksum value */
 
 	/* Get stored and computed checksums */
-	H5F_get_checksums(image, len, &stored_chksum, &computed_chksum);
+	H5F_get_checksums(image, len, &stored_chksum, NULL);
+	computed_chksum = H5_checksum_metadata_fast(image, len - H5O_SIZEOF_CHKSUM, 0);
 
 	if(stored_chksum != computed_chksum)
 	    ret_value = FALSE;
@@ -1289,6 +1312,47 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5O__prefix_deserialize() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5O__chunk_count_msgs
+ *
+ * Purpose:	Count the messages in a chunk's image by walking only the
+ *              message headers, so the message table can be grown once
+ *              per chunk instead of once per message.  The count is an
+ *              upper bound (null messages may be merged later) and
+ *              stops at the first message that would overrun the chunk,
+ *              which H5O__chunk_deserialize() then reports.
+ *
+ * Return:	# of messages found
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5O__chunk_count_msgs(const H5O_t *oh, const uint8_t *chunk_image,
+    const uint8_t *eom_ptr)
+{
+    size_t nmesgs = 0;          /* # of messages found */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    while(eom_ptr - chunk_image >= H5O_SIZEOF_MSGHDR_OH(oh)) {
+        size_t mesg_size;       /* Size of message */
+
+        /* Skip type, then get size */
+        chunk_image += (oh->version == H5O_VERSION_1) ? 2 : 1;
+        UINT16DECODE(chunk_image, mesg_size);
+
+        /* Skip the rest of the header & the message body */
+        chunk_image += (size_t)H5O_SIZEOF_MSGHDR_OH(oh) - ((oh->version == H5O_VERSION_1) ? 4 : 3);
+        if(mesg_size > (size_t)(eom_ptr - chunk_image))
+            break;
+        chunk_image += mesg_size;
+        nmesgs++;
+    } /* end while */
+
+    FUNC_LEAVE_NOAPI(nmesgs)
+} /* H5O__chunk_count_msgs() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5O__chunk_deserialize
@@ -1374,6 +1438,15 @@ H5O__chunk_deserialize(H5O_t *oh, haddr_t addr, size_t len, const uint8_t *image
 #ifndef NDEBUG
     nullcnt = 0;
 #endif /* NDEBUG */
+
+    /* Make room in the message table for all of this chunk's messages at once */
+    {
+        size_t chunk_nmesgs = H5O__chunk_count_msgs(oh, chunk_image, eom_ptr);
+
+        if(oh->nmesgs + chunk_nmesgs > oh->alloc_nmesgs)
+            if(H5O_alloc_msgs(oh, (oh->nmesgs + chunk_nmesgs) - oh->alloc_nmesgs) < 0)
+                HGOTO_ERROR(H5E_OHDR, H5E_CANTALLOC, FAIL, "can't allocate more space for messages")
+    }
     while(chunk_image < eom_ptr) {
         size_t mesg_size;       /* Size of message read in */
         unsigned id;            /* ID (type) of current message */
@@ -1541,21 +1614,23 @@ H5O__chunk_deserialize(H5O_t *oh, haddr_t addr, size_t len, const uint8_t *image
             } /* end if */
             /* Check if message is a ref. count message */
             else if(H5O_REFCOUNT_ID == id) {
-                H5O_refcount_t *refcount;
+                const uint8_t *p = mesg->raw;   /* Pointer into raw message */
+                H5O_refcount_t refcount;        /* Link count from message */
 
-                /* Decode ref. count message */
                 if(oh->version <= H5O_VERSION_1)
                     HGOTO_ERROR(H5E_OHDR, H5E_VERSION, FAIL, "object header version does not support reference count message")
-                refcount = (H5O_refcount_t *)(H5O_MSG_REFCOUNT->decode)(udata->f, NULL, 0, &ioflags, mesg->raw_size, mesg->raw);
 
-                /* Save 'native' form of ref. count message */
-                mesg->native = refcount;
+                /* Only the link count is needed to load the header, so read
+                 * it from the raw message and leave the 'native' form to be
+                 * decoded when the message itself is accessed.
+                 */
+                if(mesg->raw_size < H5O_REFCOUNT_SIZE || *p++ != H5O_REFCOUNT_VERSION)
+                    HGOTO_ERROR(H5E_OHDR, H5E_CANTSET, FAIL, "can't decode refcount")
+                UINT32DECODE(p, refcount);
 
                 /* Set object header values */
                 oh->has_refcount_msg = TRUE;
-                if(!refcount)
-                    HGOTO_ERROR(H5E_OHDR, H5E_CANTSET, FAIL, "can't decode refcount")
-                oh->nlink = *refcount;
+                oh->nlink = refcount;
             } /* end if */
             /* Check if message is a link message */
             else if(H5O_LINK_ID == id) {
@@ -1681,7 +1756,7 @@ H5O__chunk_serialize(const H5F_t *f, H5O_t *oh, unsigned chunkno)
                 (H5O_SIZEOF_CHKSUM + oh->chunk[chunkno].gap), 0, oh->chunk[chunkno].gap);
 
         /* Compute metadata checksum */
-        metadata_chksum = H5_checksum_metadata(oh->chunk[chunkno].image, (oh->chunk[chunkno].size - H5O_SIZEOF_CHKSUM), 0);
+        metadata_chksum = H5_checksum_metadata_fast(oh->chunk[chunkno].image, (oh->chunk[chunkno].size - H5O_SIZEOF_CHKSUM), 0);
 
         /* Metadata checksum */
         chunk_image = oh->chunk[chunkno].image + (oh->chunk[chunkno].size - H5O_SIZEOF_CHKSUM);
@@ -265,6 +265,35 @@
 #define H5F_ACS_VFD_SWMR_CONFIG_DEF    H5F__DEFAULT_VFD_SWMR_CONFIG
 #define H5F_ACS_VFD_SWMR_CONFIG_ENC    H5P__facc_vfd_swmr_config_enc
 #define H5F_ACS_VFD_SWMR_CONFIG_DEC    H5P__facc_vfd_swmr_config_dec
+/* Version & flags of the VFD SWMR configuration encoding */
+#define H5F_ACS_VFD_SWMR_CONFIG_ENC_VERSION     2
+#define H5F_ACS_VFD_SWMR_CONFIG_ENC_DEFAULT     0x01    /* Default configuration, nothing else encoded */
+#define H5F_ACS_VFD_SWMR_CONFIG_ENC_WRITER      0x02    /* vfd_swmr_writer set */
+#define H5F_ACS_VFD_SWMR_CONFIG_ENC_FLUSH_RAW   0x04    /* flush_raw_data set */
+
+/* Definitions for the asynchronous I/O queue depth */
+#define H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_SIZE      sizeof(unsigned)
+#define H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_DEF       0
+#define H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_ENC       H5P__encode_unsigned
+#define H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_DEC       H5P__decode_unsigned
+
+/* Definitions for the VFD SWMR tick notification flag */
+#define H5F_ACS_VFD_SWMR_NOTIFY_SIZE            sizeof(hbool_t)
+#define H5F_ACS_VFD_SWMR_NOTIFY_DEF             FALSE
+#define H5F_ACS_VFD_SWMR_NOTIFY_ENC             H5P__encode_hbool_t
+#define H5F_ACS_VFD_SWMR_NOTIFY_DEC             H5P__decode_hbool_t
+
+/* Definitions for the metadata prefetch window */
+#define H5F_ACS_VFD_PREFETCH_WINDOW_SIZE        sizeof(unsigned)
+#define H5F_ACS_VFD_PREFETCH_WINDOW_DEF         0
+#define H5F_ACS_VFD_PREFETCH_WINDOW_ENC         H5P__encode_unsigned
+#define H5F_ACS_VFD_PREFETCH_WINDOW_DEC         H5P__decode_unsigned
+
+/* Definitions for page buffer read-ahead */
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_SIZE       sizeof(unsigned)
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_DEF        0
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_ENC        H5P__encode_unsigned
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_DEC        H5P__decode_unsigned
 
 /******************/
 /* Local Typedefs */
@@ -312,7 +341,9 @@ static herr_t H5P__facc_multi_type_enc(const void *value, void **_pp, size_t *si
 static herr_t H5P__facc_multi_type_dec(const void **_pp, void *value);
 static herr_t H5P__facc_libver_type_enc(const void *value, void **_pp, size_t *size);
 static herr_t H5P__facc_libver_type_dec(const void **_pp, void *value);
+static size_t H5P__facc_vfd_swmr_config_enc_var(uint64_t enc_value, uint8_t **pp);
 static herr_t H5P__facc_vfd_swmr_config_enc(const void *value, void **_pp, size_t *size);
+static herr_t H5P__facc_vfd_swmr_config_dec_var(const uint8_t **pp, uint64_t *enc_value);
 static herr_t H5P__facc_vfd_swmr_config_dec(const void **_pp, void *value);
 
 /* Metadata cache log location property callbacks */
@@ -407,6 +438,10 @@ static const unsigned H5F_def_page_buf_min_meta_perc_g = H5F_ACS_PAGE_BUFFER_MIN
 static const unsigned H5F_def_page_buf_min_raw_perc_g = H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_DEF;      /* Default page buffer mininum raw data size */
 
 static const H5F_vfd_swmr_config_t H5F_def_vfd_swmr_config_g = H5F_ACS_VFD_SWMR_CONFIG_DEF;     /* Default vfd swmr configuration */
+static const unsigned H5F_def_vfd_async_queue_depth_g = H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_DEF;    /* Default async I/O queue depth */
+static const hbool_t H5F_def_vfd_swmr_notify_g = H5F_ACS_VFD_SWMR_NOTIFY_DEF;    /* Default VFD SWMR tick notification flag */
+static const unsigned H5F_def_vfd_prefetch_window_g = H5F_ACS_VFD_PREFETCH_WINDOW_DEF;    /* Default metadata prefetch window */
+static const unsigned H5F_def_page_buf_prefetch_g = H5F_ACS_PAGE_BUFFER_PREFETCH_DEF;    /* Default page buffer sequential read-ahead */
 
 
 /*-------------------------------------------------------------------------
@@ -660,6 +695,30 @@ H5P__facc_reg_prop(H5P_genclass_t *pclass)
             NULL, NULL, NULL, NULL) < 0)
         HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
 
+    /* Register the asynchronous I/O queue depth */
+    if(H5P__register_real(pclass, H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_NAME, H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_SIZE, &H5F_def_vfd_async_queue_depth_g,
+            NULL, NULL, NULL, H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_ENC, H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
+    /* Register the VFD SWMR tick notification flag */
+    if(H5P__register_real(pclass, H5F_ACS_VFD_SWMR_NOTIFY_NAME, H5F_ACS_VFD_SWMR_NOTIFY_SIZE, &H5F_def_vfd_swmr_notify_g,
+            NULL, NULL, NULL, H5F_ACS_VFD_SWMR_NOTIFY_ENC, H5F_ACS_VFD_SWMR_NOTIFY_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
+    /* Register the metadata prefetch window */
+    if(H5P__register_real(pclass, H5F_ACS_VFD_PREFETCH_WINDOW_NAME, H5F_ACS_VFD_PREFETCH_WINDOW_SIZE, &H5F_def_vfd_prefetch_window_g,
+            NULL, NULL, NULL, H5F_ACS_VFD_PREFETCH_WINDOW_ENC, H5F_ACS_VFD_PREFETCH_WINDOW_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
+    /* Register page buffer read-ahead */
+    if(H5P__register_real(pclass, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, H5F_ACS_PAGE_BUFFER_PREFETCH_SIZE, &H5F_def_page_buf_prefetch_g,
+            NULL, NULL, NULL, H5F_ACS_PAGE_BUFFER_PREFETCH_ENC, H5F_ACS_PAGE_BUFFER_PREFETCH_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
 done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5P__facc_reg_prop() */
@@ -3943,12 +4002,49 @@ H5P__facc_libver_type_dec(const void **_pp, void *_value)
 } /* end H5P__facc_libver_type_dec() */
 
 
+/*-------------------------------------------------------------------------
+ * Function:    H5P__facc_vfd_swmr_config_enc_var
+ *
+ * Purpose:     Encode a value for the VFD SWMR config property as its
+ *              length in bytes followed by its significant bytes, the way
+ *              sizes are encoded elsewhere in this file.
+ *
+ * Return:      Size of the encoded value
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5P__facc_vfd_swmr_config_enc_var(uint64_t enc_value, uint8_t **pp)
+{
+    unsigned enc_size = H5VM_limit_enc_size(enc_value);     /* Size of encoded value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(enc_size < 256);
+
+    if(NULL != *pp) {
+        *(*pp)++ = (uint8_t)enc_size;
+        UINT64ENCODE_VAR(*pp, enc_value, enc_size);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI((size_t)1 + enc_size)
+} /* end H5P__facc_vfd_swmr_config_enc_var() */
+
+
 /*-------------------------------------------------------------------------
  * Function:    H5P__facc_vfd_swmr_config_enc
  *
  * Purpose:     Callback routine which is called whenever the VFD SWMR config
  *              property in the file access property list is encoded.
  *
+ *              The encoding starts with a version byte and a flags byte.
+ *              A configuration equal to the default is encoded as just
+ *              those two bytes, since most file access property lists
+ *              encoded for other processes don't use VFD SWMR.  Otherwise
+ *              the integers follow as variable length values and the
+ *              paths as length-prefixed strings, instead of fixed
+ *              H5F__MAX_VFD_SWMR_FILE_NAME_LEN + 1 byte buffers.
+ *
  * Return:      Success:    Non-negative
  *              Failure:    Negative
  *
@@ -3960,44 +4056,104 @@ static herr_t
 H5P__facc_vfd_swmr_config_enc(const void *value, void **_pp, size_t *size)
 {
     const H5F_vfd_swmr_config_t *config = (const H5F_vfd_swmr_config_t *)value; /* Create local aliases for values */
+    const H5F_vfd_swmr_config_t *def = &H5F_def_vfd_swmr_config_g;
     uint8_t **pp = (uint8_t **)_pp;
+    size_t md_len, log_len;     /* Lengths of the paths */
+    uint8_t flags = 0;          /* Flags for the encoding */
 
     FUNC_ENTER_STATIC_NOERR
 
     /* Sanity check */
     HDassert(value);
+    HDassert(size);
     HDcompile_assert(sizeof(size_t) <= sizeof(uint64_t));
 
-    if(NULL != *pp) {
-
-        /* int */
-        INT32ENCODE(*pp, (int32_t)config->version);
-        INT32ENCODE(*pp, (int32_t)config->tick_len);
-        INT32ENCODE(*pp, (int32_t)config->max_lag);
-        H5_ENCODE_UNSIGNED(*pp, config->vfd_swmr_writer);
-        H5_ENCODE_UNSIGNED(*pp, config->flush_raw_data);
-        INT32ENCODE(*pp, (int32_t)config->md_pages_reserved);
-        HDmemcpy(*pp, (const uint8_t *)(config->md_file_path), (size_t)(H5F__MAX_VFD_SWMR_FILE_NAME_LEN + 1));
-        *pp += H5F__MAX_VFD_SWMR_FILE_NAME_LEN + 1;
-        HDmemcpy(*pp, (const uint8_t *)(config->log_file_path), (size_t)(H5F__MAX_VFD_SWMR_FILE_NAME_LEN + 1));
-        *pp += H5F__MAX_VFD_SWMR_FILE_NAME_LEN + 1;
+    md_len = HDstrlen(config->md_file_path);
+    log_len = HDstrlen(config->log_file_path);
+
+    /* Check for the default configuration */
+    if(config->version == def->version && config->tick_len == def->tick_len
+            && config->max_lag == def->max_lag
+            && config->vfd_swmr_writer == def->vfd_swmr_writer
+            && config->flush_raw_data == def->flush_raw_data
+            && config->md_pages_reserved == def->md_pages_reserved
+            && !HDstrcmp(config->md_file_path, def->md_file_path)
+            && !HDstrcmp(config->log_file_path, def->log_file_path))
+        flags |= H5F_ACS_VFD_SWMR_CONFIG_ENC_DEFAULT;
+    else {
+        if(config->vfd_swmr_writer)
+            flags |= H5F_ACS_VFD_SWMR_CONFIG_ENC_WRITER;
+        if(config->flush_raw_data)
+            flags |= H5F_ACS_VFD_SWMR_CONFIG_ENC_FLUSH_RAW;
+    } /* end else */
 
+    if(NULL != *pp) {
+        *(*pp)++ = (uint8_t)H5F_ACS_VFD_SWMR_CONFIG_ENC_VERSION;
+        *(*pp)++ = flags;
+    } /* end if */
+    *size += 2;
+
+    if(!(flags & H5F_ACS_VFD_SWMR_CONFIG_ENC_DEFAULT)) {
+        /* int (as its two's complement bits, so negative values stay small) */
+        *size += H5P__facc_vfd_swmr_config_enc_var((uint64_t)(uint32_t)config->version, pp);
+        *size += H5P__facc_vfd_swmr_config_enc_var((uint64_t)(uint32_t)config->tick_len, pp);
+        *size += H5P__facc_vfd_swmr_config_enc_var((uint64_t)(uint32_t)config->max_lag, pp);
+        *size += H5P__facc_vfd_swmr_config_enc_var((uint64_t)(uint32_t)config->md_pages_reserved, pp);
+
+        /* strings */
+        *size += H5P__facc_vfd_swmr_config_enc_var((uint64_t)md_len, pp) + md_len;
+        if(NULL != *pp) {
+            HDmemcpy(*pp, config->md_file_path, md_len);
+            *pp += md_len;
+        } /* end if */
+        *size += H5P__facc_vfd_swmr_config_enc_var((uint64_t)log_len, pp) + log_len;
+        if(NULL != *pp) {
+            HDmemcpy(*pp, config->log_file_path, log_len);
+            *pp += log_len;
+        } /* end if */
     } /* end if */
-
-    /* Compute encoded size */
-    *size += ( (4 * sizeof(int32_t)) + sizeof(unsigned) + 
-               (2 * (H5F__MAX_VFD_SWMR_FILE_NAME_LEN + 1)) );
 
     FUNC_LEAVE_NOAPI(SUCCEED)
 } /* end H5P__facc_vfd_swmr_config_enc() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P__facc_vfd_swmr_config_dec_var
+ *
+ * Purpose:     Decode a value encoded with
+ *              H5P__facc_vfd_swmr_config_enc_var().
+ *
+ * Return:      Success:    Non-negative
+ *              Failure:    Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5P__facc_vfd_swmr_config_dec_var(const uint8_t **pp, uint64_t *enc_value)
+{
+    unsigned enc_size;          /* Size of encoded value */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_STATIC
 
+    enc_size = *(*pp)++;
+    if(enc_size > sizeof(uint64_t))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "invalid size of encoded value")
+    UINT64DECODE_VAR(*pp, *enc_value, enc_size);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P__facc_vfd_swmr_config_dec_var() */
+
+
 /*-------------------------------------------------------------------------
  * Function:    H5P__facc_vfd_swmr_config_dec
  *
  * Purpose:     Callback routine which is called whenever the VFD SWMR
  *              config property in the file access property list is decoded.
  *
+ *              Only the bytes actually encoded for the paths are copied.
+ *
  * Return:      Success:    Non-negative
  *              Failure:    Negative
  *
@@ -4010,8 +4166,11 @@ H5P__facc_vfd_swmr_config_dec(const void **_pp, void *_value)
 {
     H5F_vfd_swmr_config_t *config = (H5F_vfd_swmr_config_t *)_value;
     const uint8_t **pp = (const uint8_t **)_pp;
+    uint64_t enc_value;         /* Decoded value */
+    uint8_t flags;              /* Flags for the encoding */
+    herr_t ret_value = SUCCEED; /* Return value */
 
-    FUNC_ENTER_STATIC_NOERR
+    FUNC_ENTER_STATIC
 
     /* Sanity checks */
     HDassert(pp);
@@ -4022,24 +4181,50 @@ H5P__facc_vfd_swmr_config_dec(const void **_pp, void *_value)
     /* Set property to default value */
     HDmemcpy(config, &H5F_def_vfd_swmr_config_g, sizeof(H5F_vfd_swmr_config_t));
 
-    /* int */
-    INT32DECODE(*pp, config->version);
-    INT32DECODE(*pp, config->tick_len);
-    INT32DECODE(*pp, config->max_lag);
-
-    H5_DECODE_UNSIGNED(*pp, config->vfd_swmr_writer);
-    H5_DECODE_UNSIGNED(*pp, config->flush_raw_data);
+    if(*(*pp)++ != H5F_ACS_VFD_SWMR_CONFIG_ENC_VERSION)
+        HGOTO_ERROR(H5E_PLIST, H5E_VERSION, FAIL, "unknown version of encoded VFD SWMR config")
+    flags = *(*pp)++;
 
-    /* int */
-    INT32DECODE(*pp, config->md_pages_reserved);
+    /* Nothing else is encoded for the default configuration */
+    if(flags & H5F_ACS_VFD_SWMR_CONFIG_ENC_DEFAULT)
+        HGOTO_DONE(SUCCEED)
 
-    HDstrcpy(config->md_file_path, (const char *)(*pp));
-    *pp += H5F__MAX_VFD_SWMR_FILE_NAME_LEN + 1;
+    config->vfd_swmr_writer = (flags & H5F_ACS_VFD_SWMR_CONFIG_ENC_WRITER) ? TRUE : FALSE;
+    config->flush_raw_data = (flags & H5F_ACS_VFD_SWMR_CONFIG_ENC_FLUSH_RAW) ? TRUE : FALSE;
 
-    HDstrcpy(config->log_file_path, (const char *)(*pp));
-    *pp += H5F__MAX_VFD_SWMR_FILE_NAME_LEN + 1;
+    /* int */
+    if(H5P__facc_vfd_swmr_config_dec_var(pp, &enc_value) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTDECODE, FAIL, "can't decode version")
+    config->version = (int32_t)(uint32_t)enc_value;
+    if(H5P__facc_vfd_swmr_config_dec_var(pp, &enc_value) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTDECODE, FAIL, "can't decode tick length")
+    config->tick_len = (int32_t)(uint32_t)enc_value;
+    if(H5P__facc_vfd_swmr_config_dec_var(pp, &enc_value) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTDECODE, FAIL, "can't decode max lag")
+    config->max_lag = (int32_t)(uint32_t)enc_value;
+    if(H5P__facc_vfd_swmr_config_dec_var(pp, &enc_value) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTDECODE, FAIL, "can't decode reserved metadata pages")
+    config->md_pages_reserved = (int32_t)(uint32_t)enc_value;
+
+    /* strings */
+    if(H5P__facc_vfd_swmr_config_dec_var(pp, &enc_value) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTDECODE, FAIL, "can't decode metadata file path length")
+    if(enc_value > H5F__MAX_VFD_SWMR_FILE_NAME_LEN)
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "metadata file path too long")
+    HDmemcpy(config->md_file_path, *pp, (size_t)enc_value);
+    config->md_file_path[enc_value] = '\0';
+    *pp += enc_value;
+
+    if(H5P__facc_vfd_swmr_config_dec_var(pp, &enc_value) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTDECODE, FAIL, "can't decode log file path length")
+    if(enc_value > H5F__MAX_VFD_SWMR_FILE_NAME_LEN)
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "log file path too long")
+    HDmemcpy(config->log_file_path, *pp, (size_t)enc_value);
+    config->log_file_path[enc_value] = '\0';
+    *pp += enc_value;
 
-    FUNC_LEAVE_NOAPI(SUCCEED)
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5P__facc_vfd_swmr_config_dec() */
 
 /*-------------------------------------------------------------------------
@@ -5055,6 +5240,68 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Pget_page_buffer_size() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P_set_page_buffer_prefetch
+ *
+ * Purpose:     Set the number of pages read ahead once reads are seen to
+ *              be sequential: after a run of back-to-back reads of the
+ *              same size and type, the next PREFETCH_PAGES ranges are
+ *              read in the background through the asynchronous I/O
+ *              engine (see H5P_set_vfd_async_queue_depth()).  Files of
+ *              drivers other than sec2 don't read ahead.  0 (the default)
+ *              disables read-ahead.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5P_set_page_buffer_prefetch(H5P_genplist_t *plist, unsigned prefetch_pages)
+{
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(plist);
+
+    /* Set value */
+    if(H5P_set(plist, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, &prefetch_pages) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set page buffer read-ahead")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P_set_page_buffer_prefetch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P_get_page_buffer_prefetch
+ *
+ * Purpose:     Retrieve the number of pages read ahead of sequential reads
+ *              from the FAPL PLIST.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5P_get_page_buffer_prefetch(H5P_genplist_t *plist, unsigned *prefetch_pages)
+{
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(plist);
+
+    /* Get value */
+    if(prefetch_pages)
+        if(H5P_get(plist, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, prefetch_pages) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get page buffer read-ahead")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P_get_page_buffer_prefetch() */
+
 /*-------------------------------------------------------------------------
  * Function:    H5Pset_vfd_swmr_config
  *
@@ -5167,3 +5414,184 @@ H5Pget_vfd_swmr_config(hid_t plist_id, H5F_vfd_swmr_config_t *config_ptr)
 done:
     FUNC_LEAVE_API(ret_value)
 } /* H5Pget_vfd_swmr_config() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P_set_vfd_async_queue_depth
+ *
+ * Purpose:     Set the maximum number of asynchronous raw I/O requests
+ *              that may be in flight at once for files opened with the
+ *              FAPL PLIST.  A depth of 0 (the default) disables
+ *              asynchronous I/O: requests are then completed as they are
+ *              submitted.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5P_set_vfd_async_queue_depth(H5P_genplist_t *plist, unsigned queue_depth)
+{
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(plist);
+
+    /* Set value */
+    if(H5P_set(plist, H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_NAME, &queue_depth) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set async I/O queue depth")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P_set_vfd_async_queue_depth() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P_get_vfd_async_queue_depth
+ *
+ * Purpose:     Retrieve the asynchronous I/O queue depth from the FAPL
+ *              PLIST.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5P_get_vfd_async_queue_depth(H5P_genplist_t *plist, unsigned *queue_depth)
+{
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(plist);
+
+    /* Get value */
+    if(queue_depth)
+        if(H5P_get(plist, H5F_ACS_VFD_ASYNC_QUEUE_DEPTH_NAME, queue_depth) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get async I/O queue depth")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P_get_vfd_async_queue_depth() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P_set_vfd_swmr_notify
+ *
+ * Purpose:     Enable or disable same-host tick notification for VFD SWMR.
+ *              When enabled, the writer publishes each tick in a shared
+ *              memory page and readers block until a new tick is
+ *              published instead of polling the metadata file header.
+ *              Readers fall back to polling when the writer does not
+ *              publish to the local host.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5P_set_vfd_swmr_notify(H5P_genplist_t *plist, hbool_t notify)
+{
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(plist);
+
+    /* Set value */
+    if(H5P_set(plist, H5F_ACS_VFD_SWMR_NOTIFY_NAME, &notify) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set VFD SWMR tick notification flag")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P_set_vfd_swmr_notify() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P_get_vfd_swmr_notify
+ *
+ * Purpose:     Retrieve the VFD SWMR tick notification flag from the FAPL
+ *              PLIST.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5P_get_vfd_swmr_notify(H5P_genplist_t *plist, hbool_t *notify)
+{
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(plist);
+
+    /* Get value */
+    if(notify)
+        if(H5P_get(plist, H5F_ACS_VFD_SWMR_NOTIFY_NAME, notify) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get VFD SWMR tick notification flag")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P_get_vfd_swmr_notify() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P_set_vfd_prefetch_window
+ *
+ * Purpose:     Set the number of metadata reads that may be prefetched
+ *              ahead of use for files opened with this FAPL.  Prefetches
+ *              are serviced by the asynchronous I/O engine, so they need
+ *              a non-zero queue depth (see
+ *              H5P_set_vfd_async_queue_depth()).
+ *              A window of 0 (the default) disables prefetching.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5P_set_vfd_prefetch_window(H5P_genplist_t *plist, unsigned window)
+{
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(plist);
+
+    /* Set value */
+    if(H5P_set(plist, H5F_ACS_VFD_PREFETCH_WINDOW_NAME, &window) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set metadata prefetch window")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P_set_vfd_prefetch_window() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P_get_vfd_prefetch_window
+ *
+ * Purpose:     Retrieve the metadata prefetch window from the FAPL PLIST.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5P_get_vfd_prefetch_window(H5P_genplist_t *plist, unsigned *window)
+{
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(plist);
+
+    /* Get value */
+    if(window)
+        if(H5P_get(plist, H5F_ACS_VFD_PREFETCH_WINDOW_NAME, window) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get metadata prefetch window")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5P_get_vfd_prefetch_window() */
@@ -25,14 +25,136 @@
 #include "H5Eprivate.h"		/* Error handling			*/
 #include "H5FLprivate.h"	/* Free Lists				*/
 #include "H5Iprivate.h"		/* ID Functions				*/
+#include "H5MMprivate.h"	/* Memory management			*/
+#include "H5SLprivate.h"	/* Skip Lists				*/
 #include "H5Spkg.h"		/* Dataspace functions			*/
 #include "H5VMprivate.h"         /* Vector functions			*/
 
+/* GCC & clang on x86 can build single functions for AVX2 without -mavx2,
+ * so the AVX2 gathers are always built there and chosen at run time
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && \
+        (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define H5S_HYPER_AVX2
+#include <immintrin.h>
+#endif /* x86 GCC >= 4.9 or clang */
+
 /* Local Macros */
 
+/* Selection flag for the compact span tree encoding (see H5S_hyper_serialize_compact) */
+#define H5S_SELECT_FLAG_SPANS   0x02
+
+/* Copy N elements of S bytes between a buffer where they are STRIDE bytes
+ * apart and a packed buffer, four at a time.  S is a constant in each use,
+ * so the copies become single (unaligned) loads & stores.
+ */
+#define H5S_HYPER_COPY_STRIDE(S, GATHER, BUF, STRIDE, TBUF, N) {              \
+    uint8_t *_b = (BUF);                                                       \
+    uint8_t *_t = (TBUF);                                                      \
+    size_t _n = (N);                                                           \
+                                                                               \
+    if(GATHER) {                                                               \
+        for(; _n >= 4; _n -= 4, _b += 4 * (STRIDE), _t += 4 * (S)) {           \
+            HDmemcpy(_t, _b, S);                                               \
+            HDmemcpy(_t + (S), _b + (STRIDE), S);                              \
+            HDmemcpy(_t + 2 * (S), _b + 2 * (STRIDE), S);                      \
+            HDmemcpy(_t + 3 * (S), _b + 3 * (STRIDE), S);                      \
+        }                                                                      \
+        for(; _n > 0; _n--, _b += (STRIDE), _t += (S))                         \
+            HDmemcpy(_t, _b, S);                                               \
+    }                                                                          \
+    else {                                                                     \
+        for(; _n >= 4; _n -= 4, _b += 4 * (STRIDE), _t += 4 * (S)) {           \
+            HDmemcpy(_b, _t, S);                                               \
+            HDmemcpy(_b + (STRIDE), _t + (S), S);                              \
+            HDmemcpy(_b + 2 * (STRIDE), _t + 2 * (S), S);                      \
+            HDmemcpy(_b + 3 * (STRIDE), _t + 3 * (S), S);                      \
+        }                                                                      \
+        for(; _n > 0; _n--, _b += (STRIDE), _t += (S))                         \
+            HDmemcpy(_b, _t, S);                                               \
+    }                                                                          \
+}
+
 /* Local datatypes */
 
+/* Node of a span tree search index, for one list of spans.  Lists shared
+ * between several spans of a tree share one node.
+ */
+typedef struct H5S_hyper_idx_node_t {
+    size_t      first;          /* Index of the list's first span in the index */
+    size_t      nspans;         /* # of spans in the list */
+    hsize_t    *bounds;         /* Low & high bounds of everything below the list, for this & all faster dimensions */
+} H5S_hyper_idx_node_t;
+
+/* Span in a span tree search index */
+typedef struct H5S_hyper_idx_span_t {
+    hsize_t     low, high;      /* Bounds of span */
+    const H5S_hyper_idx_node_t *down;   /* List of spans in the next dimension down, NULL at the bottom */
+} H5S_hyper_idx_span_t;
+
+/* Search index for a span tree: the tree flattened into arrays, with
+ * bounding boxes for each list, so intersection queries can binary search
+ * each list and skip lists entirely outside a block.  Indices are kept in
+ * H5S_hyper_idx_g, keyed on the address of the tree's root.  Moving the
+ * tree only updates the index's offset; every other routine that changes
+ * a tree in place drops the index.
+ */
+typedef struct H5S_hyper_span_idx_t {
+    size_t      key;            /* Address of the tree's root, the key in H5S_hyper_idx_g */
+    unsigned    rank;           /* # of dimensions of the tree */
+    hssize_t    offset[H5O_LAYOUT_NDIMS];  /* Offset subtracted from the tree's coordinates since it was indexed */
+    H5S_hyper_idx_node_t *nodes;        /* Nodes, the root first */
+    H5S_hyper_idx_span_t *spans;        /* Spans, each list contiguous */
+    size_t      nnodes;         /* # of nodes used */
+    size_t      nspans;         /* # of spans used */
+    size_t      nbounds;        /* # of bounds used */
+    hsize_t    *bounds;         /* Bounds for all nodes */
+} H5S_hyper_span_idx_t;
+
+/* One hyperslab of a batch for H5S_select_hyperslabs(), for sorting */
+typedef struct H5S_hyper_batch_slab_t {
+    unsigned    rank;           /* # of dimensions of the hyperslab */
+    const hsize_t *start;       /* Start of the hyperslab */
+    size_t      idx;            /* Index of the hyperslab in the batch */
+} H5S_hyper_batch_slab_t;
+
+/* How a span tree with a search index overlaps a block */
+typedef enum H5S_hyper_idx_overlap_t {
+    H5S_HYPER_IDX_DISJOINT = 0, /* No element of the tree is in the block */
+    H5S_HYPER_IDX_PARTIAL,      /* Some elements might be in the block */
+    H5S_HYPER_IDX_INSIDE        /* All elements of the tree are in the block */
+} H5S_hyper_idx_overlap_t;
+
+/* Kernels for copying regular selections between a buffer and a packed
+ * buffer (see H5S_hyper_copy_regular), as chosen with the data transfer
+ * property list.
+ */
+typedef enum H5S_sel_copy_t {
+    H5S_SEL_COPY_SEQ_LIST = 0,  /* Always use offset/length sequence lists */
+    H5S_SEL_COPY_DEFAULT,       /* Fastest kernel available */
+    H5S_SEL_COPY_STRIDE,        /* Unrolled fixed-stride copies */
+    H5S_SEL_COPY_SIMD,          /* Vector gathers where available, else as H5S_SEL_COPY_STRIDE */
+    H5S_SEL_COPY_NTYPES         /* Number of kernels (must be last) */
+} H5S_sel_copy_t;
+
 /* Static function prototypes */
+static void H5S__hyper_idx_count(H5S_hyper_span_info_t *spans, unsigned ndims,
+    size_t *nnodes, size_t *nspans, size_t *nbounds);
+static const H5S_hyper_idx_node_t *H5S__hyper_idx_fill(H5S_hyper_span_idx_t *idx,
+    H5S_hyper_span_info_t *spans, unsigned ndims);
+static H5S_hyper_span_idx_t *H5S__hyper_idx_build(H5S_hyper_span_info_t *spans,
+    unsigned rank);
+static H5S_hyper_span_idx_t *H5S__hyper_idx_get(const H5S_hyper_span_info_t *spans);
+static void H5S__hyper_idx_free(H5S_hyper_span_info_t *spans);
+static void H5S__hyper_idx_move(H5S_hyper_span_info_t *spans, unsigned rank,
+    const hssize_t *offset);
+static hbool_t H5S__hyper_idx_block(const H5S_hyper_span_idx_t *idx,
+    const hsize_t *start, const hsize_t *end, hsize_t *idx_start, hsize_t *idx_end);
+static hbool_t H5S__hyper_idx_intersect(const H5S_hyper_idx_span_t *idx_spans,
+    const H5S_hyper_idx_node_t *node, unsigned ndims,
+    const hsize_t *start, const hsize_t *end);
+static H5S_hyper_idx_overlap_t H5S__hyper_idx_and_block(H5S_hyper_span_info_t *spans,
+    const H5S_hyper_span_info_t *block_spans);
 static H5S_hyper_span_t *H5S__hyper_new_span(hsize_t low, hsize_t high,
     H5S_hyper_span_info_t *down, H5S_hyper_span_t *next);
 static herr_t H5S__hyper_span_precompute(H5S_hyper_span_info_t *spans, size_t elmt_size);
@@ -61,9 +183,19 @@ static H5S_hyper_span_info_t *H5S__hyper_make_spans(unsigned rank,
     const hsize_t *start, const hsize_t *stride, const hsize_t *count,
     const hsize_t *block);
 static herr_t H5S__hyper_generate_spans(H5S_t *space);
+static void H5S__hyper_copy_stride(H5S_sel_copy_t how, hbool_t gather,
+    size_t elem_size, uint8_t *buf, hsize_t stride, uint8_t *tbuf, size_t n);
 static herr_t H5S__generate_hyperslab(H5S_t *space, H5S_seloper_t op,
     const hsize_t start[], const hsize_t stride[], const hsize_t count[],
     const hsize_t block[]);
+#ifndef NEW_HYPERSLAB_API
+static herr_t H5S__generate_hyperslab_spans(H5S_t *space, H5S_seloper_t op,
+    H5S_hyper_span_info_t *new_spans);
+static int H5S__hyper_batch_cmp(const void *_slab1, const void *_slab2);
+static H5S_hyper_span_info_t *H5S__hyper_union_spans(unsigned rank,
+    size_t nslabs, const hsize_t start[], const hsize_t stride[],
+    const hsize_t count[], const hsize_t block[]);
+#endif /* NEW_HYPERSLAB_API */
 /* Needed for use in hyperslab code (H5Shyper.c) */
 #ifdef NEW_HYPERSLAB_API
 static herr_t H5S_select_select (H5S_t *space1, H5S_seloper_t op, H5S_t *space2);
@@ -72,6 +204,10 @@ static void H5S__hyper_get_clip_diminfo(hsize_t start, hsize_t stride,
     hsize_t *count, hsize_t *block, hsize_t clip_size);
 static hsize_t H5S__hyper_get_clip_extent_real(const H5S_t *clip_space,
     hsize_t num_slices, hbool_t incl_trail);
+static hssize_t H5S__hyper_serial_size_real(const H5S_t *space, hbool_t compact);
+static herr_t H5S__hyper_serialize_real(const H5S_t *space, hbool_t compact,
+    uint8_t **p);
+static size_t H5S__hyper_compact_encode(const H5S_t *space, uint8_t **p);
 
 /* Selection callbacks */
 static herr_t H5S__hyper_copy(H5S_t *dst, const H5S_t *src, hbool_t share_selection);
@@ -164,6 +300,16 @@ static const hsize_t H5S_hyper_ones_g[H5O_LAYOUT_NDIMS] = {
     1,1,1,1, 1,1,1,1,
     1,1,1,1, 1,1,1,1,1};
 
+#ifdef H5S_HYPER_AVX2
+/* Whether the CPU has AVX2 (-1 until checked) */
+static int H5S_hyper_avx2_g = -1;
+#endif /* H5S_HYPER_AVX2 */
+
+/* Search indices of span trees, keyed on the address of each tree's root
+ * (created with the first index & closed with the last)
+ */
+static H5SL_t *H5S_hyper_idx_g = NULL;
+
 /* Declare a free list to manage the H5S_hyper_sel_t struct */
 H5FL_DEFINE_STATIC(H5S_hyper_sel_t);
 
@@ -1558,6 +1704,9 @@ H5S__hyper_free_span_info(H5S_hyper_span_info_t *span_info)
             span = next_span;
         } /* end while */
 
+        /* Free any search index for the tree */
+        H5S__hyper_idx_free(span_info);
+
         /* Free this span info */
         span_info = H5FL_FREE(H5S_hyper_span_info_t, span_info);
     } /* end if */
@@ -1947,25 +2096,26 @@ done:
 
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_serial_size
+    H5S__hyper_serial_size_real
  PURPOSE
     Determine the number of bytes needed to store the serialized hyperslab
-        selection information.
+        selection information, in either encoding.
  USAGE
-    hssize_t H5S__hyper_serial_size(space)
+    hssize_t H5S__hyper_serial_size_real(space, compact)
         H5S_t *space;             IN: Dataspace pointer to query
+        hbool_t compact;          IN: Whether to size the compact encoding
  RETURNS
     The number of bytes required on success, negative on an error.
  DESCRIPTION
-    Determines the number of bytes required to serialize the current hyperslab
-    selection information for storage on disk.
+    Determines the number of bytes H5S__hyper_serialize_real() will use to
+    serialize the current hyperslab selection information.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
 static hssize_t
-H5S__hyper_serial_size(const H5S_t *space)
+H5S__hyper_serial_size_real(const H5S_t *space, hbool_t compact)
 {
     hsize_t block_count;       /* block counter for regular hyperslabs */
     unsigned u;                /* Counter */
@@ -1975,8 +2125,8 @@ H5S__hyper_serial_size(const H5S_t *space)
 
     HDassert(space);
 
-    /* Check for version (right now, an unlimited dimension is the only thing
-     * that would bump the version) */
+    /* Check for version (an unlimited dimension or the compact encoding bump
+     * the version) */
     if(space->select.sel_info.hslab->unlim_dim >= 0)
         /* Version 2 */
         /* Size required is always:
@@ -1987,6 +2137,12 @@ H5S__hyper_serial_size(const H5S_t *space)
          */
         ret_value = (hssize_t)17 + ((hssize_t)4 * (hssize_t)space->extent.rank
                 * (hssize_t)8);
+    else if(compact)
+        /* Version 2, with the H5S_SELECT_FLAG_SPANS flag */
+        /* <type (4 bytes)> + <version (4 bytes)> + <flags (1 byte)> +
+         * <length (4 bytes)> + <rank (4 bytes)> + <encoded selection>
+         */
+        ret_value = (hssize_t)17 + (hssize_t)H5S__hyper_compact_encode(space, NULL);
     else {
         /* Version 1 */
         /* Basic number of bytes required to serialize hyperslab selection:
@@ -2010,6 +2166,38 @@ H5S__hyper_serial_size(const H5S_t *space)
         ret_value += (hssize_t)(8 * block_count * space->extent.rank);
     } /* end else */
 
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_serial_size_real() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_serial_size
+ PURPOSE
+    Determine the number of bytes needed to store the serialized hyperslab
+        selection information.
+ USAGE
+    hssize_t H5S__hyper_serial_size(space)
+        H5S_t *space;             IN: Dataspace pointer to query
+ RETURNS
+    The number of bytes required on success, negative on an error.
+ DESCRIPTION
+    Determines the number of bytes required to serialize the current hyperslab
+    selection information for storage on disk.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static hssize_t
+H5S__hyper_serial_size(const H5S_t *space)
+{
+    hssize_t ret_value = -1;   /* return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    ret_value = H5S__hyper_serial_size_real(space, FALSE);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5S__hyper_serial_size() */
 
@@ -2097,27 +2285,32 @@ H5S__hyper_serialize_helper(const H5S_hyper_span_info_t *spans,
 
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_serialize
+    H5S__hyper_serialize_real
  PURPOSE
-    Serialize the current selection into a user-provided buffer.
+    Serialize the current selection into a user-provided buffer, in either
+        encoding.
  USAGE
-    herr_t H5S_hyper_serialize(space, p)
+    herr_t H5S__hyper_serialize_real(space, compact, p)
         const H5S_t *space;     IN: Dataspace with selection to serialize
+        hbool_t compact;        IN: Whether to use the compact encoding
         uint8_t **p;            OUT: Pointer to buffer to put serialized
                                 selection.  Will be advanced to end of
                                 serialized selection.
  RETURNS
     Non-negative on success/Negative on failure
  DESCRIPTION
-    Serializes the current element selection into a buffer.  (Primarily for
-    storing on disk).
+    Serializes the current element selection into a buffer.  Selections
+    with an unlimited dimension are always version 2 with the
+    H5S_SELECT_FLAG_UNLIM flag.  Otherwise COMPACT selects version 2 with
+    the H5S_SELECT_FLAG_SPANS flag (see H5S__hyper_compact_encode()),
+    and version 1, a list of blocks, is used if it's not set.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
 static herr_t
-H5S__hyper_serialize(const H5S_t *space, uint8_t **p)
+H5S__hyper_serialize_real(const H5S_t *space, hbool_t compact, uint8_t **p)
 {
     uint8_t *pp;            /* Local pointer for decoding */
     uint8_t *lenp;          /* Pointer to length location for later storage */
@@ -2139,6 +2332,10 @@ H5S__hyper_serialize(const H5S_t *space, uint8_t **p)
         version = 2;
         flags |= H5S_SELECT_FLAG_UNLIM;
     } /* end if */
+    else if(compact) {
+        version = 2;
+        flags |= H5S_SELECT_FLAG_SPANS;
+    } /* end if */
     else
         version = 1;
 
@@ -2171,6 +2368,14 @@ H5S__hyper_serialize(const H5S_t *space, uint8_t **p)
             UINT64ENCODE(pp, space->select.sel_info.hslab->opt_diminfo[i].block);
         } /* end for */
     } /* end if */
+    /* Check for the compact span tree encoding */
+    else if(flags & H5S_SELECT_FLAG_SPANS) {
+        size_t enc_len;         /* Length of the encoded selection */
+
+        enc_len = H5S__hyper_compact_encode(space, &pp);
+        H5_CHECK_OVERFLOW(len + enc_len, size_t, uint32_t);
+        len += (uint32_t)enc_len;
+    } /* end if */
     /* Check for a "regular" hyperslab selection */
     else if(space->select.sel_info.hslab->diminfo_valid) {
         const H5S_hyper_dim_t *diminfo;         /* Alias for dataspace's diminfo information */
@@ -2289,1730 +2494,2878 @@ H5S__hyper_serialize(const H5S_t *space, uint8_t **p)
     *p = pp;
 
     FUNC_LEAVE_NOAPI(SUCCEED)
-} /* end H5S__hyper_serialize() */
+} /* end H5S__hyper_serialize_real() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_deserialize
+    H5S__hyper_serialize
  PURPOSE
-    Deserialize the current selection from a user-provided buffer.
+    Serialize the current selection into a user-provided buffer.
  USAGE
-    herr_t H5S__hyper_deserialize(space, p)
-        H5S_t *space;           IN/OUT: Dataspace pointer to place
-                                selection into
-        uint32_t version        IN: Selection version
-        uint8_t flags           IN: Selection flags
-        uint8 **p;              OUT: Pointer to buffer holding serialized
+    herr_t H5S_hyper_serialize(space, p)
+        const H5S_t *space;     IN: Dataspace with selection to serialize
+        uint8_t **p;            OUT: Pointer to buffer to put serialized
                                 selection.  Will be advanced to end of
                                 serialized selection.
  RETURNS
     Non-negative on success/Negative on failure
  DESCRIPTION
-    Deserializes the current selection into a buffer.  (Primarily for retrieving
-    from disk).
+    Serializes the current element selection into a buffer.  (Primarily for
+    storing on disk).
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
 static herr_t
-H5S__hyper_deserialize(H5S_t *space, uint32_t H5_ATTR_UNUSED version, uint8_t flags,
-    const uint8_t **p)
+H5S__hyper_serialize(const H5S_t *space, uint8_t **p)
 {
-    unsigned rank;           	/* Rank of points */
-    const uint8_t *pp;          /* Local pointer for decoding */
-    hsize_t start[H5O_LAYOUT_NDIMS];	/* Hyperslab start information */
-    hsize_t block[H5O_LAYOUT_NDIMS];    /* Hyperslab block information */
-    unsigned u;             	/* Local counting variable */
-    herr_t ret_value = FAIL;  	/* Return value */
-
-    FUNC_ENTER_STATIC
-
-    /* Check args */
-    HDassert(space);
-    HDassert(p);
-    pp = (*p);
-    HDassert(pp);
+    herr_t ret_value = SUCCEED; /* Return value */
 
-    /* Deserialize slabs to select */
-    /* (The header and rank have already beed decoded) */
-    rank = space->extent.rank;  /* Retrieve rank from space */
+    FUNC_ENTER_STATIC_NOERR
 
-    /* If there is an unlimited dimension, only encode opt_unlim_diminfo */
-    if(flags & H5S_SELECT_FLAG_UNLIM) {
-        hsize_t stride[H5O_LAYOUT_NDIMS];	/* Hyperslab stride information */
-        hsize_t count[H5O_LAYOUT_NDIMS];	/* Hyperslab count information */
+    ret_value = H5S__hyper_serialize_real(space, FALSE, p);
 
-        /* Sanity checks */
-        HDassert(H5S_UNLIMITED == HSIZE_UNDEF);
-        HDassert(version >= 2);
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_serialize() */
 
-        /* Iterate over dimensions */
-        for(u = 0; u < rank; u++) {
-            /* Decode start/stride/block/count */
-            UINT64DECODE(pp, start[u]);
-            UINT64DECODE(pp, stride[u]);
-            UINT64DECODE(pp, count[u]);
-            UINT64DECODE(pp, block[u]);
-        } /* end for */
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_varint_encode
+ PURPOSE
+    Encode an unsigned value as a variable-length integer
+ USAGE
+    size_t H5S__hyper_varint_encode(val, p)
+        hsize_t val;            IN: Value to encode
+        uint8_t **p;            IN/OUT: Pointer to buffer to encode into,
+                                advanced past the value.  If NULL, the
+                                value is only sized.
+ RETURNS
+    Number of bytes in the encoded value, can't fail
+ DESCRIPTION
+    Stores 7 bits per byte, least significant first, with the high bit set
+    in every byte but the last.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static size_t
+H5S__hyper_varint_encode(hsize_t val, uint8_t **p)
+{
+    size_t ret_value = 1;       /* Return value */
 
-        /* Select the hyperslab to the current selection */
-        if((ret_value = H5S_select_hyperslab(space, H5S_SELECT_SET, start, stride, count, block)) < 0)
-            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTSET, FAIL, "can't change selection")
-    } /* end if */
-    else {
-        const hsize_t *stride;  /* Hyperslab stride information */
-        const hsize_t *count;   /* Hyperslab count information */
-        hsize_t end[H5O_LAYOUT_NDIMS];	/* Hyperslab end information */
-        hsize_t *tstart;	/* Temporary hyperslab pointers */
-        hsize_t *tend;		/* Temporary hyperslab pointers */
-        hsize_t *tblock;	/* Temporary hyperslab pointers */
-        size_t num_elem;      	/* Number of elements in selection */
-        unsigned v;            	/* Local counting variable */
+    FUNC_ENTER_STATIC_NOERR
 
-        /* Decode the number of points */
-        UINT32DECODE(pp, num_elem);
+    while(val >= 0x80) {
+        if(p)
+            *(*p)++ = (uint8_t)(val | 0x80);
+        val >>= 7;
+        ret_value++;
+    } /* end while */
+    if(p)
+        *(*p)++ = (uint8_t)val;
 
-        /* Set the count & stride for all blocks */
-        stride = count = H5S_hyper_ones_g;
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_varint_encode() */
 
-        /* Retrieve the coordinates from the buffer */
-        for(u = 0; u < num_elem; u++) {
-            /* Decode the starting points */
-            for(tstart = start, v = 0; v < rank; v++, tstart++)
-                UINT32DECODE(pp, *tstart);
 
-            /* Decode the ending points */
-            for(tend = end, v = 0; v < rank; v++, tend++)
-                UINT32DECODE(pp, *tend);
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_varint_decode
+ PURPOSE
+    Decode a variable-length integer
+ USAGE
+    herr_t H5S__hyper_varint_decode(p, p_end, val)
+        const uint8_t **p;      IN/OUT: Pointer to buffer to decode from,
+                                advanced past the value
+        const uint8_t *p_end;   IN: End of the buffer
+        hsize_t *val;           OUT: Decoded value
+ RETURNS
+    Non-negative on success/Negative on failure
+ DESCRIPTION
+    Decodes a value encoded by H5S__hyper_varint_encode().  Fails if the
+    value runs past P_END or doesn't fit in an hsize_t.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_varint_decode(const uint8_t **p, const uint8_t *p_end, hsize_t *val)
+{
+    const uint8_t *pp = *p;     /* Local pointer for decoding */
+    unsigned shift = 0;         /* Bit position of next 7 bits */
+    herr_t ret_value = SUCCEED; /* Return value */
 
-            /* Change the ending points into blocks */
-            for(tblock = block, tstart = start, tend = end, v = 0; v < rank; v++, tstart++, tend++, tblock++)
-                *tblock = (*tend - *tstart) + 1;
+    FUNC_ENTER_STATIC
 
-            /* Select or add the hyperslab to the current selection */
-            if((ret_value = H5S_select_hyperslab(space, (u == 0 ? H5S_SELECT_SET : H5S_SELECT_OR), start, stride, count, block)) < 0)
-                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTSET, FAIL, "can't change selection")
-        } /* end for */
-    } /* end else */
+    *val = 0;
+    do {
+        hsize_t bits;           /* Next 7 bits of the value */
+
+        if(pp >= p_end)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "variable-length integer runs past end of buffer")
+        if(shift >= (8 * sizeof(hsize_t)))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "variable-length integer too long")
+        bits = (hsize_t)(*pp & 0x7f);
+        if(((bits << shift) >> shift) != bits)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "variable-length integer too large")
+        *val |= bits << shift;
+        shift += 7;
+    } while(*pp++ & 0x80);
 
-    /* Update decoding pointer */
     *p = pp;
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_deserialize() */
+} /* end H5S__hyper_varint_decode() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_span_blocklist
+    H5S__hyper_compact_encode_helper
  PURPOSE
-    Get a list of hyperslab blocks currently selected
+    Encode a span tree in the compact selection format
  USAGE
-    herr_t H5S__hyper_span_blocklist(spans, start, end, rank, startblock, numblocks, buf)
-        H5S_hyper_span_info_t *spans;   IN: Dataspace pointer of selection to query
-        hsize_t start[];       IN/OUT: Accumulated start points
-        hsize_t end[];         IN/OUT: Accumulated end points
-        hsize_t rank;           IN: Rank of dataspace
-        hsize_t *startblock;    IN/OUT: Hyperslab block to start with
-        hsize_t *numblocks;     IN/OUT: Number of hyperslab blocks to get
-        hsize_t **buf;          OUT: List of hyperslab blocks selected
+    size_t H5S__hyper_compact_encode_helper(spans, ndims, p)
+        const H5S_hyper_span_info_t *spans; IN: Span tree to encode
+        unsigned ndims;         IN: # of dimensions in span tree
+        uint8_t **p;            IN/OUT: Pointer to buffer to encode into,
+                                advanced past the tree.  If NULL, the tree
+                                is only sized.
  RETURNS
-    Non-negative on success/Negative on failure
+    Number of bytes in the encoded tree, can't fail
  DESCRIPTION
-        Puts a list of the hyperslab blocks into the user's buffer.  The blocks
-    start with the '*startblock'th block in the list of blocks and put
-    '*numblocks' number of blocks into the user's buffer (or until the end of
-    the list of blocks, whichever happens first)
-        The block coordinates have the same dimensionality (rank) as the
-    dataspace they are located within.  The list of blocks is formatted as
-    follows: <"start" coordinate> immediately followed by <"opposite" corner
-    coordinate>, followed by the next "start" and "opposite" coordinate, etc.
-    until all the block information requested has been put into the user's
-    buffer.
-        No guarantee of any order of the blocks is implied.
+    Each list of spans is encoded as a series of runs, ended by a zero.  A
+    run is a group of spans with the same length, the same distance between
+    them and the same spans in the next dimension down, encoded as:
+        <# of spans> <gap before first span> <length - 1>
+        [<gap between spans>, if more than one span]
+        [<down code>, if not the fastest dimension]
+    Gaps are counted from the end of the previous span (or from 0 for the
+    first run).  A down code of 0 is followed by the run's list of spans in
+    the next dimension, 1 means the run has the same list as the previous
+    run.  All values are variable-length integers.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static herr_t
-H5S__hyper_span_blocklist(const H5S_hyper_span_info_t *spans, hsize_t start[],
-    hsize_t end[], hsize_t rank, hsize_t *startblock, hsize_t *numblocks,
-    hsize_t **buf)
+static size_t
+H5S__hyper_compact_encode_helper(const H5S_hyper_span_info_t *spans,
+    unsigned ndims, uint8_t **p)
 {
-    const H5S_hyper_span_t *curr;     /* Pointer to current hyperslab span */
-    hsize_t u;                  /* Index variable */
-    herr_t ret_value = SUCCEED; /* return value */
+    const H5S_hyper_span_t *curr;       /* First span in current run */
+    const H5S_hyper_span_info_t *prev_down = NULL;  /* Down list of previous run */
+    hsize_t prev_end = 0;               /* Coordinate after end of previous run */
+    size_t ret_value = 0;               /* Return value */
 
-    FUNC_ENTER_STATIC
+    FUNC_ENTER_STATIC_NOERR
 
-    /* Sanity checks */
     HDassert(spans);
-    HDassert(rank < H5O_LAYOUT_NDIMS);
-    HDassert(start);
-    HDassert(end);
-    HDassert(startblock);
-    HDassert(numblocks && *numblocks > 0);
-    HDassert(buf && *buf);
+    HDassert(ndims > 0);
 
-    /* Walk through the list of spans, recursing or outputting them */
     curr = spans->head;
-    while(curr != NULL && *numblocks > 0) {
-        /* Recurse if this node has down spans */
-        if(curr->down != NULL) {
-            /* Add the starting and ending points for this span to the list */
-            start[rank] = curr->low;
-            end[rank] = curr->high;
+    while(curr != NULL) {
+        const H5S_hyper_span_t *last = curr;    /* Last span in run */
+        const H5S_hyper_span_t *next;           /* Next span to check for the run */
+        hsize_t len = curr->high - curr->low;   /* Length of spans in run, minus 1 */
+        hsize_t gap = 0;                        /* Gap between spans in run */
+        hsize_t nspans = 1;                     /* # of spans in run */
+
+        /* Extend the run while the spans repeat */
+        for(next = curr->next; next != NULL; next = next->next) {
+            if((next->high - next->low) != len)
+                break;
+            if(nspans == 1)
+                gap = next->low - (last->high + 1);
+            else if((next->low - (last->high + 1)) != gap)
+                break;
+            if(!H5S__hyper_cmp_spans(next->down, curr->down))
+                break;
+            last = next;
+            nspans++;
+        } /* end for */
 
-            /* Recurse down to the next dimension */
-            if(H5S__hyper_span_blocklist(curr->down, start, end, (rank + 1), startblock, numblocks, buf) < 0)
-                HGOTO_ERROR(H5E_INTERNAL, H5E_CANTFREE, FAIL, "failed to release hyperslab spans")
-        } /* end if */
-        else {
-            /* Skip this block if we haven't skipped all the startblocks yet */
-            if(*startblock > 0) {
-                /* Decrement the starting block */
-                (*startblock)--;
-            } /* end if */
-            /* Process this block */
+        ret_value += H5S__hyper_varint_encode(nspans, p);
+        ret_value += H5S__hyper_varint_encode(curr->low - prev_end, p);
+        ret_value += H5S__hyper_varint_encode(len, p);
+        if(nspans > 1)
+            ret_value += H5S__hyper_varint_encode(gap, p);
+        if(ndims > 1) {
+            HDassert(curr->down);
+            if(prev_down && H5S__hyper_cmp_spans(curr->down, prev_down))
+                ret_value += H5S__hyper_varint_encode((hsize_t)1, p);
             else {
-                /* Encode all the previous dimensions starting & ending points */
+                ret_value += H5S__hyper_varint_encode((hsize_t)0, p);
+                ret_value += H5S__hyper_compact_encode_helper(curr->down, ndims - 1, p);
+            } /* end else */
+            prev_down = curr->down;
+        } /* end if */
 
-                /* Copy previous starting points */
-                for(u = 0; u < rank; u++, (*buf)++)
-                    HDmemcpy(*buf, &start[u], sizeof(hsize_t));
-
-                /* Copy starting point for this span */
-                HDmemcpy(*buf, &curr->low, sizeof(hsize_t));
-                (*buf)++;
-
-                /* Copy previous ending points */
-                for(u = 0; u < rank; u++, (*buf)++)
-                    HDmemcpy(*buf, &end[u], sizeof(hsize_t));
-
-                /* Copy starting point for this span */
-                HDmemcpy(*buf, &curr->high, sizeof(hsize_t));
-                (*buf)++;
-
-                /* Decrement the number of blocks processed */
-                (*numblocks)--;
-            } /* end else */
-        } /* end else */
-
-        /* Advance to next node */
-        curr = curr->next;
+        prev_end = last->high + 1;
+        curr = last->next;
     } /* end while */
 
-done:
+    /* End of list */
+    ret_value += H5S__hyper_varint_encode((hsize_t)0, p);
+
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_span_blocklist() */
+} /* end H5S__hyper_compact_encode_helper() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S__get_select_hyper_blocklist
+    H5S__hyper_compact_encode
  PURPOSE
-    Get the list of hyperslab blocks currently selected
+    Encode a hyperslab selection in the compact selection format
  USAGE
-    herr_t H5S__get_select_hyper_blocklist(space, startblock, numblocks, buf)
-        H5S_t *space;           IN: Dataspace pointer of selection to query
-        hsize_t startblock;     IN: Hyperslab block to start with
-        hsize_t numblocks;      IN: Number of hyperslab blocks to get
-        hsize_t *buf;           OUT: List of hyperslab blocks selected
+    size_t H5S__hyper_compact_encode(space, p)
+        const H5S_t *space;     IN: Dataspace with selection to encode
+        uint8_t **p;            IN/OUT: Pointer to buffer to encode into,
+                                advanced past the selection.  If NULL, the
+                                selection is only sized.
  RETURNS
-    Non-negative on success, negative on failure
+    Number of bytes in the encoded selection, can't fail
  DESCRIPTION
-        Puts a list of the hyperslab blocks into the user's buffer.  The blocks
-    start with the 'startblock'th block in the list of blocks and put
-    'numblocks' number of blocks into the user's buffer (or until the end of
-    the list of blocks, whichever happens first)
-        The block coordinates have the same dimensionality (rank) as the
-    dataspace they are located within.  The list of blocks is formatted as
-    follows: <"start" coordinate> immediately followed by <"opposite" corner
-    coordinate>, followed by the next "start" and "opposite" coordinate, etc.
-    until all the block information requested has been put into the user's
-    buffer.
-        No guarantee of any order of the blocks is implied.
+    Encodes the selection information following the rank: a 0 followed by
+    the start/stride/count/block of each dimension for regular selections,
+    or a 1 followed by the span tree (see
+    H5S__hyper_compact_encode_helper()).
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static herr_t
-H5S__get_select_hyper_blocklist(H5S_t *space, hbool_t internal, hsize_t startblock, hsize_t numblocks, hsize_t *buf)
+static size_t
+H5S__hyper_compact_encode(const H5S_t *space, uint8_t **p)
 {
-    herr_t ret_value = SUCCEED; /* Return value */
+    size_t ret_value = 0;       /* Return value */
 
     FUNC_ENTER_STATIC_NOERR
 
     HDassert(space);
-    HDassert(buf);
-    HDassert(space->select.sel_info.hslab->unlim_dim < 0);
 
-    /* Check for a "regular" hyperslab selection */
     if(space->select.sel_info.hslab->diminfo_valid) {
-        const H5S_hyper_dim_t *diminfo; /* Alias for dataspace's diminfo information */
-        hsize_t tmp_count[H5O_LAYOUT_NDIMS];    /* Temporary hyperslab counts */
-        hsize_t offset[H5O_LAYOUT_NDIMS];      /* Offset of element in dataspace */
-        unsigned fast_dim;          /* Rank of the fastest changing dimension for the dataspace */
-        unsigned ndims;             /* Rank of the dataspace */
-        hbool_t done;               /* Whether we are done with the iteration */
-        unsigned u;                 /* Counter */
-
-        /* Set some convienence values */
-        ndims = space->extent.rank;
-        fast_dim = ndims - 1;
-
-        /* Check which set of dimension information to use */
-        if(internal)
-            /*
-             * Use the "optimized dimension information" to pass back information
-             * on the blocks set, not the "application information".
-             */
-            diminfo = space->select.sel_info.hslab->opt_diminfo;
-        else
-            if(space->select.sel_info.hslab->unlim_dim >= 0)
-                /*
-                 * There is an unlimited dimension so we must use opt_diminfo as
-                 * it has been "clipped" to the current extent.
-                 */
-                diminfo = space->select.sel_info.hslab->opt_diminfo;
-            else
-                /*
-                 * Use the "application dimension information" to pass back to
-                 * the user the blocks they set, not the optimized, internal
-                 * information.
-                 */
-                diminfo = space->select.sel_info.hslab->app_diminfo;
+        const H5S_hyper_dim_t *diminfo = space->select.sel_info.hslab->opt_diminfo;
+        unsigned u;
 
-        /* Build the tables of count sizes as well as the initial offset */
-        for(u = 0; u < ndims; u++) {
-            tmp_count[u] = diminfo[u].count;
-            offset[u] = diminfo[u].start;
+        ret_value += H5S__hyper_varint_encode((hsize_t)0, p);
+        for(u = 0; u < space->extent.rank; u++) {
+            ret_value += H5S__hyper_varint_encode(diminfo[u].start, p);
+            ret_value += H5S__hyper_varint_encode(diminfo[u].stride, p);
+            ret_value += H5S__hyper_varint_encode(diminfo[u].count, p);
+            ret_value += H5S__hyper_varint_encode(diminfo[u].block, p);
         } /* end for */
-
-        /* We're not done with the iteration */
-        done = FALSE;
-
-        /* Go iterate over the hyperslabs */
-        while(!done && numblocks > 0) {
-            hsize_t temp_off;           /* Offset in a given dimension */
-
-            /* Iterate over the blocks in the fastest dimension */
-            while(tmp_count[fast_dim] > 0 && numblocks > 0) {
-
-                /* Check if we should copy this block information */
-                if(startblock == 0) {
-                    /* Copy the starting location */
-                    HDmemcpy(buf, offset, sizeof(hsize_t) * ndims);
-                    buf += ndims;
-
-                    /* Compute the ending location */
-                    HDmemcpy(buf, offset, sizeof(hsize_t) * ndims);
-                    for(u = 0; u < ndims; u++)
-                        buf[u] += (diminfo[u].block - 1);
-                    buf += ndims;
-
-                    /* Decrement the number of blocks to retrieve */
-                    numblocks--;
-                } /* end if */
-                else
-                    startblock--;
-
-                /* Move the offset to the next sequence to start */
-                offset[fast_dim] += diminfo[fast_dim].stride;
-
-                /* Decrement the block count */
-                tmp_count[fast_dim]--;
-            } /* end while */
-
-            /* Work on other dimensions if necessary */
-            if(fast_dim > 0 && numblocks > 0) {
-                int temp_dim;               /* Temporary rank holder */
-
-                /* Reset the block counts */
-                tmp_count[fast_dim] = diminfo[fast_dim].count;
-
-                /* Bubble up the decrement to the slower changing dimensions */
-                temp_dim = (int)(fast_dim - 1);
-                while(temp_dim >= 0 && !done) {
-                    /* Decrement the block count */
-                    tmp_count[temp_dim]--;
-
-                    /* Check if we have more blocks left */
-                    if(tmp_count[temp_dim] > 0)
-                        break;
-
-                    /* Check for getting out of iterator */
-                    if(temp_dim == 0)
-                        done = TRUE;
-
-                    /* Reset the block count in this dimension */
-                    tmp_count[temp_dim] = diminfo[temp_dim].count;
-
-                    /* Wrapped a dimension, go up to next dimension */
-                    temp_dim--;
-                } /* end while */
-            } /* end if */
-
-            /* Re-compute offset array */
-            for(u = 0; u < ndims; u++) {
-                temp_off = diminfo[u].start + diminfo[u].stride * (diminfo[u].count - tmp_count[u]);
-                offset[u] = temp_off;
-            } /* end for */
-        } /* end while */
     } /* end if */
     else {
-        hsize_t start[H5O_LAYOUT_NDIMS];   /* Location of start of hyperslab */
-        hsize_t end[H5O_LAYOUT_NDIMS];     /* Location of end of hyperslab */
+        HDassert(space->select.sel_info.hslab->span_lst);
 
-        ret_value = H5S__hyper_span_blocklist(space->select.sel_info.hslab->span_lst, start, end, (hsize_t)0, &startblock, &numblocks, &buf);
+        ret_value += H5S__hyper_varint_encode((hsize_t)1, p);
+        ret_value += H5S__hyper_compact_encode_helper(space->select.sel_info.hslab->span_lst, space->extent.rank, p);
     } /* end else */
 
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__get_select_hyper_blocklist() */
+} /* end H5S__hyper_compact_encode() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5Sget_select_hyper_blocklist
+    H5S_hyper_serial_size_compact
  PURPOSE
-    Get the list of hyperslab blocks currently selected
+    Determine the number of bytes needed to store a hyperslab selection in
+        the compact selection format.
  USAGE
-    herr_t H5Sget_select_hyper_blocklist(dsid, startblock, numblocks, buf)
-        hid_t dsid;             IN: Dataspace ID of selection to query
-        hsize_t startblock;     IN: Hyperslab block to start with
-        hsize_t numblocks;      IN: Number of hyperslab blocks to get
-        hsize_t buf[];          OUT: List of hyperslab blocks selected
+    hssize_t H5S_hyper_serial_size_compact(space)
+        H5S_t *space;             IN: Dataspace pointer to query
  RETURNS
-    Non-negative on success, negative on failure
+    The number of bytes required on success, negative on an error.
  DESCRIPTION
-        Puts a list of the hyperslab blocks into the user's buffer.  The blocks
-    start with the 'startblock'th block in the list of blocks and put
-    'numblocks' number of blocks into the user's buffer (or until the end of
-    the list of blocks, whichever happen first)
-        The block coordinates have the same dimensionality (rank) as the
-    dataspace they are located within.  The list of blocks is formatted as
-    follows: <"start" coordinate> immediately followed by <"opposite" corner
-    coordinate>, followed by the next "start" and "opposite" coordinate, etc.
-    until all the block information requested has been put into the user's
-    buffer.
-        No guarantee of any order of the blocks is implied.
+    Same as H5S__hyper_serial_size(), for H5S_hyper_serialize_compact().
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-herr_t
-H5Sget_select_hyper_blocklist(hid_t spaceid, hsize_t startblock,
-    hsize_t numblocks, hsize_t buf[/*numblocks*/])
+hssize_t
+H5S_hyper_serial_size_compact(const H5S_t *space)
 {
-    H5S_t *space;               /* Dataspace to modify selection of */
-    herr_t ret_value;           /* return value */
+    hssize_t ret_value = -1;   /* return value */
 
-    FUNC_ENTER_API(FAIL)
-    H5TRACE4("e", "ihh*[a2]h", spaceid, startblock, numblocks, buf);
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
 
-    /* Check args */
-    if(buf == NULL)
-        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "invalid pointer")
-    if(NULL == (space = (H5S_t *)H5I_object_verify(spaceid, H5I_DATASPACE)))
-        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a dataspace")
-    if(H5S_GET_SELECT_TYPE(space)!=H5S_SEL_HYPERSLABS)
-        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a hyperslab selection")
-    if(space->select.sel_info.hslab->unlim_dim >= 0)
-        HGOTO_ERROR(H5E_DATASPACE, H5E_UNSUPPORTED, FAIL, "cannot get blocklist for unlimited selection")
+    HDassert(space);
+    HDassert(H5S_GET_SELECT_TYPE(space) == H5S_SEL_HYPERSLABS);
 
-    /* Go get the correct number of blocks */
-    if(numblocks > 0)
-        ret_value = H5S__get_select_hyper_blocklist(space, 0, startblock, numblocks, buf);
-    else
-        ret_value = SUCCEED;      /* Successfully got 0 blocks... */
+    ret_value = H5S__hyper_serial_size_real(space, TRUE);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S_hyper_serial_size_compact() */
 
-done:
-    FUNC_LEAVE_API(ret_value)
-} /* end H5Sget_select_hyper_blocklist() */
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S_hyper_bounds_helper
+    H5S_hyper_serialize_compact
  PURPOSE
-    Gets the bounding box containing the selection.
+    Serialize a hyperslab selection in the compact selection format.
  USAGE
-    htri_t H5S_hyper_bounds_helper(spans, offset, rank);
-        const H5S_hyper_span_info_t *spans; IN: Pointer to current hyperslab span tree
-        const hssize_t *offset;         IN: Pointer to offset array
-        hsize_t rank;                   IN: Current rank looking at
-        hsize_t *start;                 OUT: Start array bounds
-        hsize_t *end;                   OUT: End array bounds
+    herr_t H5S_hyper_serialize_compact(space, p)
+        const H5S_t *space;     IN: Dataspace with selection to serialize
+        uint8_t **p;            OUT: Pointer to buffer to put serialized
+                                selection.  Will be advanced to end of
+                                serialized selection.
  RETURNS
-    Non-negative on success, negative on failure
+    Non-negative on success/Negative on failure
  DESCRIPTION
-    Retrieves the bounding box containing the current selection and places
-    it into the user's buffers.  The start and end buffers must be large
-    enough to hold the dataspace rank number of coordinates.  The bounding box
-    exactly contains the selection, ie. if a 2-D element selection is currently
-    defined with the following points: (4,5), (6,8) (10,7), the bounding box
-    with be (4, 5), (10, 8).
-        The bounding box calculations _does_ include the current offset of the
-    selection within the dataspace extent.
+    Serializes the selection as version 2 with the H5S_SELECT_FLAG_SPANS
+    flag, keeping the structure of the span tree instead of listing every
+    block.  Repeating spans and lists are only stored once, and values are
+    delta & variable-length coded, so irregular selections are typically
+    one to two orders of magnitude smaller than with H5S__hyper_serialize().
+    The result is decoded by H5S__hyper_deserialize(), through the same
+    selection deserialization path, which rejects selections reaching
+    outside of the dataspace extent.
+
+    Intended for handing selections to other processes; files should keep
+    using H5S__hyper_serialize(), which older versions of the library can
+    read.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static herr_t
-H5S_hyper_bounds_helper(const H5S_hyper_span_info_t *spans, const hssize_t *offset, hsize_t rank, hsize_t *start, hsize_t *end)
+herr_t
+H5S_hyper_serialize_compact(const H5S_t *space, uint8_t **p)
 {
-    H5S_hyper_span_t *curr;             /* Hyperslab information nodes */
-    herr_t      ret_value = SUCCEED;    /* Return value */
-
-    FUNC_ENTER_NOAPI_NOINIT
+    herr_t ret_value = SUCCEED; /* Return value */
 
-    HDassert(spans);
-    HDassert(offset);
-    HDassert(rank < H5O_LAYOUT_NDIMS);
-    HDassert(start);
-    HDassert(end);
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
 
-    /* Check each point to determine whether selection+offset is within extent */
-    curr=spans->head;
-    while(curr!=NULL) {
-        /* Check for offset moving selection negative */
-        if(((hssize_t)curr->low + offset[rank]) < 0)
-            HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "offset moves selection out of bounds")
-
-        /* Check if the current span extends the bounding box */
-        if((curr->low + (hsize_t)offset[rank]) < start[rank])
-            start[rank] = curr->low + (hsize_t)offset[rank];
-        if((curr->high + (hsize_t)offset[rank]) > end[rank])
-            end[rank] = curr->high + (hsize_t)offset[rank];
-
-        /* Recurse if this node has down spans */
-        if(curr->down != NULL) {
-            if(H5S_hyper_bounds_helper(curr->down, offset, (rank + 1), start, end) < 0)
-                HGOTO_ERROR(H5E_DATASPACE, H5E_BADSELECT, FAIL, "failure in lower dimension")
-        } /* end if */
+    /* Sanity checks */
+    HDassert(space);
+    HDassert(H5S_GET_SELECT_TYPE(space) == H5S_SEL_HYPERSLABS);
+    HDassert(p && *p);
 
-        /* Advance to next node */
-        curr = curr->next;
-    } /* end while */
+    ret_value = H5S__hyper_serialize_real(space, TRUE, p);
 
-done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S_hyper_bounds_helper() */
+} /* end H5S_hyper_serialize_compact() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_bounds
+    H5S__hyper_compact_decode_helper
  PURPOSE
-    Gets the bounding box containing the selection.
+    Decode a span tree in the compact selection format
  USAGE
-    herr_t H5S__hyper_bounds(space, hsize_t *start, hsize_t *end)
-        H5S_t *space;           IN: Dataspace pointer of selection to query
-        hsize_t *start;         OUT: Starting coordinate of bounding box
-        hsize_t *end;           OUT: Opposite coordinate of bounding box
+    H5S_hyper_span_info_t *H5S__hyper_compact_decode_helper(p, p_end, ndims, size)
+        const uint8_t **p;      IN/OUT: Pointer to buffer to decode from,
+                                advanced past the tree
+        const uint8_t *p_end;   IN: End of the buffer
+        unsigned ndims;         IN: # of dimensions in span tree
+        const hsize_t *size;    IN: Size of the dataspace extent in the
+                                NDIMS dimensions of the span tree
  RETURNS
-    Non-negative on success, negative on failure
+    Pointer to span tree, with a reference count of 1, on success, NULL on
+    failure
  DESCRIPTION
-    Retrieves the bounding box containing the current selection and places
-    it into the user's buffers.  The start and end buffers must be large
-    enough to hold the dataspace rank number of coordinates.  The bounding box
-    exactly contains the selection, ie. if a 2-D element selection is currently
-    defined with the following points: (4,5), (6,8) (10,7), the bounding box
-    with be (4, 5), (10, 8).
-        The bounding box calculations _does_ include the current offset of the
-    selection within the dataspace extent.
+    Decodes a span tree encoded by H5S__hyper_compact_encode_helper(),
+    building the spans directly.  The spans of a run share one list in the
+    next dimension down, as do runs coded as repeating the previous run's
+    list.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
+    Each run is checked against SIZE before its spans are allocated, so
+    damaged input can't make spans outside of the extent, or more spans
+    than fit in it.
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static herr_t
-H5S__hyper_bounds(const H5S_t *space, hsize_t *start, hsize_t *end)
+static H5S_hyper_span_info_t *
+H5S__hyper_compact_decode_helper(const uint8_t **p, const uint8_t *p_end,
+    unsigned ndims, const hsize_t *size)
 {
-    unsigned rank;              /* Dataspace rank */
-    unsigned i;                 /* index variable */
-    herr_t ret_value = SUCCEED; /* Return value */
+    H5S_hyper_span_info_t *spans = NULL;    /* New list of spans */
+    H5S_hyper_span_info_t *down = NULL;     /* List of spans in next dimension down */
+    H5S_hyper_span_t *last_span = NULL;     /* Last span in list */
+    hsize_t prev_end = 0;                   /* Coordinate after end of previous run */
+    H5S_hyper_span_info_t *ret_value = NULL;    /* Return value */
 
     FUNC_ENTER_STATIC
 
-    /* Sanity check */
-    HDassert(space);
-    HDassert(start);
-    HDassert(end);
+    HDassert(p && *p);
+    HDassert(p_end);
+    HDassert(ndims > 0);
+    HDassert(size);
 
-    /* Set the start and end arrays up */
-    rank = space->extent.rank;
-    for(i = 0; i < rank; i++) {
-        start[i] = HSIZET_MAX;
-        end[i] = 0;
-    } /* end for */
+    /* Allocate the list */
+    if(NULL == (spans = H5FL_MALLOC(H5S_hyper_span_info_t)))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span info")
+    spans->count = 1;
+    spans->scratch = NULL;
+    spans->head = NULL;
 
-    /* Check for a "regular" hyperslab selection */
-    if(space->select.sel_info.hslab->diminfo_valid) {
-        const H5S_hyper_dim_t *diminfo = space->select.sel_info.hslab->opt_diminfo; /* local alias for diminfo */
+    /* Decode the runs of spans */
+    while(1) {
+        hsize_t nspans, gap, len, low;      /* Run information */
+        hsize_t u;                          /* Local index variable */
 
-        /* Check each dimension */
-        for(i = 0; i < rank; i++) {
-            /* Check for offset moving selection negative */
-            if((space->select.offset[i] + (hssize_t)diminfo[i].start) < 0)
-                HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "offset moves selection out of bounds")
+        if(H5S__hyper_varint_decode(p, p_end, &nspans) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, NULL, "can't decode run of spans")
+        if(0 == nspans)
+            break;
+        if(H5S__hyper_varint_decode(p, p_end, &gap) < 0 || H5S__hyper_varint_decode(p, p_end, &len) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, NULL, "can't decode run of spans")
+
+        /* The first span must fit in the extent (prev_end is never past it) */
+        if(gap >= (size[0] - prev_end) || len >= (size[0] - prev_end - gap))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, NULL, "span outside of dataspace extent")
+        low = prev_end + gap;
+
+        /* So must the last one */
+        gap = 0;
+        if(nspans > 1) {
+            hsize_t room = size[0] - (low + len + 1);  /* Elements left after the first span */
+
+            if(H5S__hyper_varint_decode(p, p_end, &gap) < 0)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, NULL, "can't decode run of spans")
+            if(gap >= room || (nspans - 1) > (room / (gap + len + 1)))
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, NULL, "span outside of dataspace extent")
+        } /* end if */
 
-            /* Compute the smallest location in this dimension */
-            start[i] = diminfo[i].start + (hsize_t)space->select.offset[i];
+        /* Get the list in the next dimension down for the run */
+        if(ndims > 1) {
+            hsize_t down_code;
+
+            if(H5S__hyper_varint_decode(p, p_end, &down_code) < 0)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, NULL, "can't decode run of spans")
+            if(0 == down_code) {
+                if(down)
+                    if(H5S__hyper_free_span_info(down) < 0)
+                        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTFREE, NULL, "can't release hyperslab spans")
+                if(NULL == (down = H5S__hyper_compact_decode_helper(p, p_end, ndims - 1, size + 1)))
+                    HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, NULL, "can't decode hyperslab spans")
+            } /* end if */
+            else if(1 != down_code || NULL == down)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADVALUE, NULL, "invalid hyperslab span list code")
+        } /* end if */
 
-            /* Compute the largest location in this dimension */
-            if((int)i == space->select.sel_info.hslab->unlim_dim)
-                end[i] = H5S_UNLIMITED;
+        /* Add the spans in the run */
+        for(u = 0; u < nspans; u++) {
+            H5S_hyper_span_t *span;
+
+            if(u > 0)
+                low += len + 1 + gap;
+            if(NULL == (span = H5S__hyper_new_span(low, low + len, down, NULL)))
+                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span")
+            if(last_span)
+                last_span->next = span;
             else
-                end[i] = diminfo[i].start + diminfo[i].stride * (diminfo[i].count - 1) + (diminfo[i].block - 1) + (hsize_t)space->select.offset[i];
+                spans->head = span;
+            last_span = span;
         } /* end for */
-    } /* end if */
-    else {
-        /* Call the recursive routine to get the bounds for the span tree */
-        ret_value = H5S_hyper_bounds_helper(space->select.sel_info.hslab->span_lst, space->select.offset, (hsize_t)0, start, end);
-    } /* end if */
+
+        prev_end = low + len + 1;
+    } /* end while */
+
+    if(NULL == spans->head)
+        HGOTO_ERROR(H5E_DATASPACE, H5E_BADVALUE, NULL, "empty list of hyperslab spans")
+
+    ret_value = spans;
 
 done:
+    /* Release our reference to the last list in the next dimension down */
+    if(down)
+        if(H5S__hyper_free_span_info(down) < 0)
+            HDONE_ERROR(H5E_DATASPACE, H5E_CANTFREE, NULL, "can't release hyperslab spans")
+    if(NULL == ret_value && spans)
+        if(H5S__hyper_free_span_info(spans) < 0)
+            HDONE_ERROR(H5E_DATASPACE, H5E_CANTFREE, NULL, "can't release hyperslab spans")
+
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_bounds() */
+} /* end H5S__hyper_compact_decode_helper() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_offset
+    H5S__hyper_compact_decode
  PURPOSE
-    Gets the linear offset of the first element for the selection.
+    Deserialize a hyperslab selection in the compact selection format
  USAGE
-    herr_t H5S__hyper_offset(space, offset)
-        const H5S_t *space;     IN: Dataspace pointer of selection to query
-        hsize_t *offset;        OUT: Linear offset of first element in selection
+    herr_t H5S__hyper_compact_decode(space, p, p_end)
+        H5S_t *space;           IN/OUT: Dataspace pointer to place
+                                selection into
+        const uint8 **p;        IN/OUT: Pointer to buffer holding the
+                                encoded selection, after the rank.  Will be
+                                advanced to end of selection.
+        const uint8_t *p_end;   IN: End of the encoded selection
  RETURNS
-    Non-negative on success, negative on failure
+    Non-negative on success/Negative on failure
  DESCRIPTION
-    Retrieves the linear offset (in "units" of elements) of the first element
-    selected within the dataspace.
+    Decodes a selection encoded by H5S__hyper_compact_encode() into the
+    dataspace, replacing its current selection.  The selection must fill
+    the buffer up to P_END exactly and lie within the dataspace extent.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
-    Calling this function on a "none" selection returns fail.
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
 static herr_t
-H5S__hyper_offset(const H5S_t *space, hsize_t *offset)
+H5S__hyper_compact_decode(H5S_t *space, const uint8_t **p, const uint8_t *p_end)
 {
-    const hssize_t *sel_offset; /* Pointer to the selection's offset */
-    const hsize_t *dim_size;    /* Pointer to a dataspace's extent */
-    hsize_t accum;              /* Accumulator for dimension sizes */
-    unsigned rank;              /* Dataspace rank */
-    int i;                      /* index variable */
-    herr_t ret_value = SUCCEED; /* Return value */
+    H5S_hyper_span_info_t *spans = NULL;    /* Decoded span tree */
+    hsize_t kind;                           /* Kind of encoded selection */
+    unsigned u;                             /* Local index variable */
+    herr_t ret_value = SUCCEED;             /* Return value */
 
     FUNC_ENTER_STATIC
 
-    HDassert(space && space->extent.rank>0);
-    HDassert(offset);
-
-    /* Start at linear offset 0 */
-    *offset = 0;
-
-    /* Set up pointers to arrays of values */
-    rank = space->extent.rank;
-    sel_offset = space->select.offset;
-    dim_size = space->extent.size;
-
-    /* Check for a "regular" hyperslab selection */
-    if(space->select.sel_info.hslab->diminfo_valid) {
-        const H5S_hyper_dim_t *diminfo = space->select.sel_info.hslab->opt_diminfo; /* Local alias for diminfo */
-
-        /* Loop through starting coordinates, calculating the linear offset */
-        accum = 1;
-        for(i = (int)(rank - 1); i >= 0; i--) {
-            hssize_t hyp_offset = (hssize_t)diminfo[i].start + sel_offset[i]; /* Hyperslab's offset in this dimension */
-
-            /* Check for offset moving selection out of the dataspace */
-            if(hyp_offset < 0 || (hsize_t)hyp_offset >= dim_size[i])
-                HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "offset moves selection out of bounds")
-
-            /* Add the hyperslab's offset in this dimension to the total linear offset */
-            *offset += (hsize_t)(hyp_offset * (hssize_t)accum);
+    HDassert(space);
+    HDassert(p && *p);
+    HDassert(p_end);
 
-            /* Increase the accumulator */
-            accum *= dim_size[i];
-        } /* end for */
-    } /* end if */
-    else {
-        const H5S_hyper_span_t *span;           /* Hyperslab span node */
-        hsize_t dim_accum[H5S_MAX_RANK];        /* Accumulators, for each dimension */
+    if(H5S__hyper_varint_decode(p, p_end, &kind) < 0)
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "can't decode kind of selection")
 
-        /* Calculate the accumulator for each dimension */
-        accum = 1;
-        for(i = (int)(rank - 1); i >= 0; i--) {
-            /* Set the accumulator for this dimension */
-            dim_accum[i] = accum;
+    if(0 == kind) {
+        hsize_t start[H5O_LAYOUT_NDIMS];    /* Hyperslab start information */
+        hsize_t stride[H5O_LAYOUT_NDIMS];   /* Hyperslab stride information */
+        hsize_t count[H5O_LAYOUT_NDIMS];    /* Hyperslab count information */
+        hsize_t block[H5O_LAYOUT_NDIMS];    /* Hyperslab block information */
 
-            /* Increase the accumulator */
-            accum *= dim_size[i];
+        for(u = 0; u < space->extent.rank; u++) {
+            hsize_t size = space->extent.size[u];   /* Size of the extent in the dimension */
+
+            if(H5S__hyper_varint_decode(p, p_end, &start[u]) < 0 || H5S__hyper_varint_decode(p, p_end, &stride[u]) < 0
+                    || H5S__hyper_varint_decode(p, p_end, &count[u]) < 0 || H5S__hyper_varint_decode(p, p_end, &block[u]) < 0)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "can't decode regular hyperslab")
+
+            /* The blocks can't overlap and must fit in the extent */
+            if(0 == count[u] || 0 == block[u] || (count[u] > 1 && stride[u] < block[u]))
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADVALUE, FAIL, "invalid regular hyperslab")
+            if(block[u] > size || start[u] > (size - block[u])
+                    || (count[u] > 1 && (count[u] - 1) > ((size - block[u] - start[u]) / stride[u])))
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "hyperslab outside of dataspace extent")
         } /* end for */
+        if(*p != p_end)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "extra data after encoded selection")
 
-        /* Get information for the first span, in the slowest changing dimension */
-        span = space->select.sel_info.hslab->span_lst->head;
+        if(H5S_select_hyperslab(space, H5S_SELECT_SET, start, stride, count, block) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTSET, FAIL, "can't change selection")
+    } /* end if */
+    else if(1 == kind) {
+        if(NULL == (spans = H5S__hyper_compact_decode_helper(p, p_end, space->extent.rank, space->extent.size)))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "can't decode hyperslab spans")
+        if(*p != p_end)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "extra data after encoded selection")
 
-        /* Work down the spans, computing the linear offset */
-        i = 0;
-        while(span) {
-            hssize_t hyp_offset = (hssize_t)span->low + sel_offset[i]; /* Hyperslab's offset in this dimension */
+        /* Remove current selection */
+        if(H5S_SELECT_RELEASE(space) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDELETE, FAIL, "can't release selection")
 
-            /* Check for offset moving selection out of the dataspace */
-            if(hyp_offset < 0 || (hsize_t)hyp_offset >= dim_size[i])
-                HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "offset moves selection out of bounds")
+        /* Allocate space for the hyperslab selection information */
+        if(NULL == (space->select.sel_info.hslab = H5FL_MALLOC(H5S_hyper_sel_t)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate hyperslab info")
 
-            /* Add the hyperslab's offset in this dimension to the total linear offset */
-            *offset += (hsize_t)(hyp_offset * (hssize_t)dim_accum[i]);
+        /* Set the selection to the new span tree */
+        space->select.sel_info.hslab->span_lst = spans;
+        spans = NULL;
+        space->select.type = H5S_sel_hyper;
+        space->select.sel_info.hslab->diminfo_valid = FALSE;
+        space->select.sel_info.hslab->unlim_dim = -1;
+        space->select.num_elem = H5S__hyper_spans_nelem(space->select.sel_info.hslab->span_lst);
 
-            /* Advance to first span in "down" dimension */
-            if(span->down) {
-                HDassert(span->down->head);
-                span = span->down->head;
-            } /* end if */
-            else
-                span = NULL;
-            i++;
-        } /* end while */
-    } /* end else */
+        /* Attempt to rebuild "optimized" start/stride/count/block information.
+         * from resulting hyperslab span tree */
+        H5S__hyper_rebuild(space);
+    } /* end if */
+    else
+        HGOTO_ERROR(H5E_DATASPACE, H5E_BADVALUE, FAIL, "unknown kind of encoded selection")
 
 done:
-    FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_offset() */
+    if(spans)
+        if(H5S__hyper_free_span_info(spans) < 0)
+            HDONE_ERROR(H5E_DATASPACE, H5E_CANTFREE, FAIL, "can't release hyperslab spans")
 
-
-/*--------------------------------------------------------------------------
- NAME
-    H5S__hyper_unlim_dim
- PURPOSE
-    Return unlimited dimension of selection, or -1 if none
- USAGE
-    int H5S__hyper_unlim_dim(space)
-        H5S_t *space;           IN: Dataspace pointer to check
- RETURNS
-    Unlimited dimension of selection, or -1 if none (never fails).
- DESCRIPTION
-    Returns the index of the unlimited dimension of the selection, or -1
-    if the selection has no unlimited dimension.
- GLOBAL VARIABLES
- COMMENTS, BUGS, ASSUMPTIONS
- EXAMPLES
- REVISION LOG
---------------------------------------------------------------------------*/
-static int
-H5S__hyper_unlim_dim(const H5S_t *space)
-{
-    FUNC_ENTER_STATIC_NOERR
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_compact_decode() */
 
-    FUNC_LEAVE_NOAPI(space->select.sel_info.hslab->unlim_dim);
-} /* end H5S__hyper_unlim_dim() */
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_num_elem_non_unlim
+    H5S__hyper_deserialize
  PURPOSE
-    Return number of elements in the non-unlimited dimensions
+    Deserialize the current selection from a user-provided buffer.
  USAGE
-    herr_t H5S__hyper_num_elem_non_unlim(space,num_elem_non_unlim)
-        H5S_t *space;           IN: Dataspace pointer to check
-        hsize_t *num_elem_non_unlim; OUT: Number of elements in the non-unlimited dimensions
+    herr_t H5S__hyper_deserialize(space, p)
+        H5S_t *space;           IN/OUT: Dataspace pointer to place
+                                selection into
+        uint32_t version        IN: Selection version
+        uint8_t flags           IN: Selection flags
+        uint8 **p;              OUT: Pointer to buffer holding serialized
+                                selection.  Will be advanced to end of
+                                serialized selection.
  RETURNS
     Non-negative on success/Negative on failure
  DESCRIPTION
-    Returns the number of elements in a slice through the non-unlimited
-    dimensions of the selection.  Fails if the selection has no unlimited
-    dimension.
+    Deserializes the current selection into a buffer.  (Primarily for retrieving
+    from disk).
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
 static herr_t
-H5S__hyper_num_elem_non_unlim(const H5S_t *space, hsize_t *num_elem_non_unlim)
+H5S__hyper_deserialize(H5S_t *space, uint32_t H5_ATTR_UNUSED version, uint8_t flags,
+    const uint8_t **p)
 {
-    herr_t ret_value = SUCCEED;
-
-    FUNC_ENTER_STATIC
-
+    unsigned rank;           	/* Rank of points */
+    const uint8_t *pp;          /* Local pointer for decoding */
+    hsize_t start[H5O_LAYOUT_NDIMS];	/* Hyperslab start information */
+    hsize_t block[H5O_LAYOUT_NDIMS];    /* Hyperslab block information */
+    unsigned u;             	/* Local counting variable */
+    herr_t ret_value = FAIL;  	/* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Check args */
+    HDassert(space);
+    HDassert(p);
+    pp = (*p);
+    HDassert(pp);
+
+    /* Deserialize slabs to select */
+    /* (The header and rank have already beed decoded) */
+    rank = space->extent.rank;  /* Retrieve rank from space */
+
+    /* If there is an unlimited dimension, only encode opt_unlim_diminfo */
+    if(flags & H5S_SELECT_FLAG_UNLIM) {
+        hsize_t stride[H5O_LAYOUT_NDIMS];	/* Hyperslab stride information */
+        hsize_t count[H5O_LAYOUT_NDIMS];	/* Hyperslab count information */
+
+        /* Sanity checks */
+        HDassert(H5S_UNLIMITED == HSIZE_UNDEF);
+        HDassert(version >= 2);
+
+        /* Iterate over dimensions */
+        for(u = 0; u < rank; u++) {
+            /* Decode start/stride/block/count */
+            UINT64DECODE(pp, start[u]);
+            UINT64DECODE(pp, stride[u]);
+            UINT64DECODE(pp, count[u]);
+            UINT64DECODE(pp, block[u]);
+        } /* end for */
+
+        /* Select the hyperslab to the current selection */
+        if((ret_value = H5S_select_hyperslab(space, H5S_SELECT_SET, start, stride, count, block)) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTSET, FAIL, "can't change selection")
+    } /* end if */
+    /* Check for the compact span tree encoding */
+    else if(flags & H5S_SELECT_FLAG_SPANS) {
+        const uint8_t *lenp = pp - 8;   /* Length of the rank & selection, stored before the rank */
+        uint32_t len;                   /* Length of the rank & selection */
+
+        HDassert(version >= 2);
+
+        /* The length bounds the encoded selection */
+        UINT32DECODE(lenp, len);
+        if(len <= 4)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "invalid length of compact selection")
+
+        if((ret_value = H5S__hyper_compact_decode(space, &pp, pp + (len - 4))) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDECODE, FAIL, "can't decode compact selection")
+    } /* end if */
+    else {
+        const hsize_t *stride;  /* Hyperslab stride information */
+        const hsize_t *count;   /* Hyperslab count information */
+        hsize_t end[H5O_LAYOUT_NDIMS];	/* Hyperslab end information */
+        hsize_t *tstart;	/* Temporary hyperslab pointers */
+        hsize_t *tend;		/* Temporary hyperslab pointers */
+        hsize_t *tblock;	/* Temporary hyperslab pointers */
+        size_t num_elem;      	/* Number of elements in selection */
+        unsigned v;            	/* Local counting variable */
+
+        /* Decode the number of points */
+        UINT32DECODE(pp, num_elem);
+
+        /* Set the count & stride for all blocks */
+        stride = count = H5S_hyper_ones_g;
+
+        /* Retrieve the coordinates from the buffer */
+        for(u = 0; u < num_elem; u++) {
+            /* Decode the starting points */
+            for(tstart = start, v = 0; v < rank; v++, tstart++)
+                UINT32DECODE(pp, *tstart);
+
+            /* Decode the ending points */
+            for(tend = end, v = 0; v < rank; v++, tend++)
+                UINT32DECODE(pp, *tend);
+
+            /* Change the ending points into blocks */
+            for(tblock = block, tstart = start, tend = end, v = 0; v < rank; v++, tstart++, tend++, tblock++)
+                *tblock = (*tend - *tstart) + 1;
+
+            /* Select or add the hyperslab to the current selection */
+            if((ret_value = H5S_select_hyperslab(space, (u == 0 ? H5S_SELECT_SET : H5S_SELECT_OR), start, stride, count, block)) < 0)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTSET, FAIL, "can't change selection")
+        } /* end for */
+    } /* end else */
+
+    /* Update decoding pointer */
+    *p = pp;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_deserialize() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_span_blocklist
+ PURPOSE
+    Get a list of hyperslab blocks currently selected
+ USAGE
+    herr_t H5S__hyper_span_blocklist(spans, start, end, rank, startblock, numblocks, buf)
+        H5S_hyper_span_info_t *spans;   IN: Dataspace pointer of selection to query
+        hsize_t start[];       IN/OUT: Accumulated start points
+        hsize_t end[];         IN/OUT: Accumulated end points
+        hsize_t rank;           IN: Rank of dataspace
+        hsize_t *startblock;    IN/OUT: Hyperslab block to start with
+        hsize_t *numblocks;     IN/OUT: Number of hyperslab blocks to get
+        hsize_t **buf;          OUT: List of hyperslab blocks selected
+ RETURNS
+    Non-negative on success/Negative on failure
+ DESCRIPTION
+        Puts a list of the hyperslab blocks into the user's buffer.  The blocks
+    start with the '*startblock'th block in the list of blocks and put
+    '*numblocks' number of blocks into the user's buffer (or until the end of
+    the list of blocks, whichever happens first)
+        The block coordinates have the same dimensionality (rank) as the
+    dataspace they are located within.  The list of blocks is formatted as
+    follows: <"start" coordinate> immediately followed by <"opposite" corner
+    coordinate>, followed by the next "start" and "opposite" coordinate, etc.
+    until all the block information requested has been put into the user's
+    buffer.
+        No guarantee of any order of the blocks is implied.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_span_blocklist(const H5S_hyper_span_info_t *spans, hsize_t start[],
+    hsize_t end[], hsize_t rank, hsize_t *startblock, hsize_t *numblocks,
+    hsize_t **buf)
+{
+    const H5S_hyper_span_t *curr;     /* Pointer to current hyperslab span */
+    hsize_t u;                  /* Index variable */
+    herr_t ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(spans);
+    HDassert(rank < H5O_LAYOUT_NDIMS);
+    HDassert(start);
+    HDassert(end);
+    HDassert(startblock);
+    HDassert(numblocks && *numblocks > 0);
+    HDassert(buf && *buf);
+
+    /* Walk through the list of spans, recursing or outputting them */
+    curr = spans->head;
+    while(curr != NULL && *numblocks > 0) {
+        /* Recurse if this node has down spans */
+        if(curr->down != NULL) {
+            /* Add the starting and ending points for this span to the list */
+            start[rank] = curr->low;
+            end[rank] = curr->high;
+
+            /* Recurse down to the next dimension */
+            if(H5S__hyper_span_blocklist(curr->down, start, end, (rank + 1), startblock, numblocks, buf) < 0)
+                HGOTO_ERROR(H5E_INTERNAL, H5E_CANTFREE, FAIL, "failed to release hyperslab spans")
+        } /* end if */
+        else {
+            /* Skip this block if we haven't skipped all the startblocks yet */
+            if(*startblock > 0) {
+                /* Decrement the starting block */
+                (*startblock)--;
+            } /* end if */
+            /* Process this block */
+            else {
+                /* Encode all the previous dimensions starting & ending points */
+
+                /* Copy previous starting points */
+                for(u = 0; u < rank; u++, (*buf)++)
+                    HDmemcpy(*buf, &start[u], sizeof(hsize_t));
+
+                /* Copy starting point for this span */
+                HDmemcpy(*buf, &curr->low, sizeof(hsize_t));
+                (*buf)++;
+
+                /* Copy previous ending points */
+                for(u = 0; u < rank; u++, (*buf)++)
+                    HDmemcpy(*buf, &end[u], sizeof(hsize_t));
+
+                /* Copy starting point for this span */
+                HDmemcpy(*buf, &curr->high, sizeof(hsize_t));
+                (*buf)++;
+
+                /* Decrement the number of blocks processed */
+                (*numblocks)--;
+            } /* end else */
+        } /* end else */
+
+        /* Advance to next node */
+        curr = curr->next;
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_span_blocklist() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__get_select_hyper_blocklist
+ PURPOSE
+    Get the list of hyperslab blocks currently selected
+ USAGE
+    herr_t H5S__get_select_hyper_blocklist(space, startblock, numblocks, buf)
+        H5S_t *space;           IN: Dataspace pointer of selection to query
+        hsize_t startblock;     IN: Hyperslab block to start with
+        hsize_t numblocks;      IN: Number of hyperslab blocks to get
+        hsize_t *buf;           OUT: List of hyperslab blocks selected
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+        Puts a list of the hyperslab blocks into the user's buffer.  The blocks
+    start with the 'startblock'th block in the list of blocks and put
+    'numblocks' number of blocks into the user's buffer (or until the end of
+    the list of blocks, whichever happens first)
+        The block coordinates have the same dimensionality (rank) as the
+    dataspace they are located within.  The list of blocks is formatted as
+    follows: <"start" coordinate> immediately followed by <"opposite" corner
+    coordinate>, followed by the next "start" and "opposite" coordinate, etc.
+    until all the block information requested has been put into the user's
+    buffer.
+        No guarantee of any order of the blocks is implied.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__get_select_hyper_blocklist(H5S_t *space, hbool_t internal, hsize_t startblock, hsize_t numblocks, hsize_t *buf)
+{
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(space);
+    HDassert(buf);
+    HDassert(space->select.sel_info.hslab->unlim_dim < 0);
+
+    /* Check for a "regular" hyperslab selection */
+    if(space->select.sel_info.hslab->diminfo_valid) {
+        const H5S_hyper_dim_t *diminfo; /* Alias for dataspace's diminfo information */
+        hsize_t tmp_count[H5O_LAYOUT_NDIMS];    /* Temporary hyperslab counts */
+        hsize_t offset[H5O_LAYOUT_NDIMS];      /* Offset of element in dataspace */
+        unsigned fast_dim;          /* Rank of the fastest changing dimension for the dataspace */
+        unsigned ndims;             /* Rank of the dataspace */
+        hbool_t done;               /* Whether we are done with the iteration */
+        unsigned u;                 /* Counter */
+
+        /* Set some convienence values */
+        ndims = space->extent.rank;
+        fast_dim = ndims - 1;
+
+        /* Check which set of dimension information to use */
+        if(internal)
+            /*
+             * Use the "optimized dimension information" to pass back information
+             * on the blocks set, not the "application information".
+             */
+            diminfo = space->select.sel_info.hslab->opt_diminfo;
+        else
+            if(space->select.sel_info.hslab->unlim_dim >= 0)
+                /*
+                 * There is an unlimited dimension so we must use opt_diminfo as
+                 * it has been "clipped" to the current extent.
+                 */
+                diminfo = space->select.sel_info.hslab->opt_diminfo;
+            else
+                /*
+                 * Use the "application dimension information" to pass back to
+                 * the user the blocks they set, not the optimized, internal
+                 * information.
+                 */
+                diminfo = space->select.sel_info.hslab->app_diminfo;
+
+        /* Build the tables of count sizes as well as the initial offset */
+        for(u = 0; u < ndims; u++) {
+            tmp_count[u] = diminfo[u].count;
+            offset[u] = diminfo[u].start;
+        } /* end for */
+
+        /* We're not done with the iteration */
+        done = FALSE;
+
+        /* Go iterate over the hyperslabs */
+        while(!done && numblocks > 0) {
+            hsize_t temp_off;           /* Offset in a given dimension */
+
+            /* Iterate over the blocks in the fastest dimension */
+            while(tmp_count[fast_dim] > 0 && numblocks > 0) {
+
+                /* Check if we should copy this block information */
+                if(startblock == 0) {
+                    /* Copy the starting location */
+                    HDmemcpy(buf, offset, sizeof(hsize_t) * ndims);
+                    buf += ndims;
+
+                    /* Compute the ending location */
+                    HDmemcpy(buf, offset, sizeof(hsize_t) * ndims);
+                    for(u = 0; u < ndims; u++)
+                        buf[u] += (diminfo[u].block - 1);
+                    buf += ndims;
+
+                    /* Decrement the number of blocks to retrieve */
+                    numblocks--;
+                } /* end if */
+                else
+                    startblock--;
+
+                /* Move the offset to the next sequence to start */
+                offset[fast_dim] += diminfo[fast_dim].stride;
+
+                /* Decrement the block count */
+                tmp_count[fast_dim]--;
+            } /* end while */
+
+            /* Work on other dimensions if necessary */
+            if(fast_dim > 0 && numblocks > 0) {
+                int temp_dim;               /* Temporary rank holder */
+
+                /* Reset the block counts */
+                tmp_count[fast_dim] = diminfo[fast_dim].count;
+
+                /* Bubble up the decrement to the slower changing dimensions */
+                temp_dim = (int)(fast_dim - 1);
+                while(temp_dim >= 0 && !done) {
+                    /* Decrement the block count */
+                    tmp_count[temp_dim]--;
+
+                    /* Check if we have more blocks left */
+                    if(tmp_count[temp_dim] > 0)
+                        break;
+
+                    /* Check for getting out of iterator */
+                    if(temp_dim == 0)
+                        done = TRUE;
+
+                    /* Reset the block count in this dimension */
+                    tmp_count[temp_dim] = diminfo[temp_dim].count;
+
+                    /* Wrapped a dimension, go up to next dimension */
+                    temp_dim--;
+                } /* end while */
+            } /* end if */
+
+            /* Re-compute offset array */
+            for(u = 0; u < ndims; u++) {
+                temp_off = diminfo[u].start + diminfo[u].stride * (diminfo[u].count - tmp_count[u]);
+                offset[u] = temp_off;
+            } /* end for */
+        } /* end while */
+    } /* end if */
+    else {
+        hsize_t start[H5O_LAYOUT_NDIMS];   /* Location of start of hyperslab */
+        hsize_t end[H5O_LAYOUT_NDIMS];     /* Location of end of hyperslab */
+
+        ret_value = H5S__hyper_span_blocklist(space->select.sel_info.hslab->span_lst, start, end, (hsize_t)0, &startblock, &numblocks, &buf);
+    } /* end else */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__get_select_hyper_blocklist() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5Sget_select_hyper_blocklist
+ PURPOSE
+    Get the list of hyperslab blocks currently selected
+ USAGE
+    herr_t H5Sget_select_hyper_blocklist(dsid, startblock, numblocks, buf)
+        hid_t dsid;             IN: Dataspace ID of selection to query
+        hsize_t startblock;     IN: Hyperslab block to start with
+        hsize_t numblocks;      IN: Number of hyperslab blocks to get
+        hsize_t buf[];          OUT: List of hyperslab blocks selected
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+        Puts a list of the hyperslab blocks into the user's buffer.  The blocks
+    start with the 'startblock'th block in the list of blocks and put
+    'numblocks' number of blocks into the user's buffer (or until the end of
+    the list of blocks, whichever happen first)
+        The block coordinates have the same dimensionality (rank) as the
+    dataspace they are located within.  The list of blocks is formatted as
+    follows: <"start" coordinate> immediately followed by <"opposite" corner
+    coordinate>, followed by the next "start" and "opposite" coordinate, etc.
+    until all the block information requested has been put into the user's
+    buffer.
+        No guarantee of any order of the blocks is implied.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+herr_t
+H5Sget_select_hyper_blocklist(hid_t spaceid, hsize_t startblock,
+    hsize_t numblocks, hsize_t buf[/*numblocks*/])
+{
+    H5S_t *space;               /* Dataspace to modify selection of */
+    herr_t ret_value;           /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE4("e", "ihh*[a2]h", spaceid, startblock, numblocks, buf);
+
+    /* Check args */
+    if(buf == NULL)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "invalid pointer")
+    if(NULL == (space = (H5S_t *)H5I_object_verify(spaceid, H5I_DATASPACE)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a dataspace")
+    if(H5S_GET_SELECT_TYPE(space)!=H5S_SEL_HYPERSLABS)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a hyperslab selection")
+    if(space->select.sel_info.hslab->unlim_dim >= 0)
+        HGOTO_ERROR(H5E_DATASPACE, H5E_UNSUPPORTED, FAIL, "cannot get blocklist for unlimited selection")
+
+    /* Go get the correct number of blocks */
+    if(numblocks > 0)
+        ret_value = H5S__get_select_hyper_blocklist(space, 0, startblock, numblocks, buf);
+    else
+        ret_value = SUCCEED;      /* Successfully got 0 blocks... */
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Sget_select_hyper_blocklist() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S_hyper_bounds_helper
+ PURPOSE
+    Gets the bounding box containing the selection.
+ USAGE
+    htri_t H5S_hyper_bounds_helper(spans, offset, rank);
+        const H5S_hyper_span_info_t *spans; IN: Pointer to current hyperslab span tree
+        const hssize_t *offset;         IN: Pointer to offset array
+        hsize_t rank;                   IN: Current rank looking at
+        hsize_t *start;                 OUT: Start array bounds
+        hsize_t *end;                   OUT: End array bounds
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+    Retrieves the bounding box containing the current selection and places
+    it into the user's buffers.  The start and end buffers must be large
+    enough to hold the dataspace rank number of coordinates.  The bounding box
+    exactly contains the selection, ie. if a 2-D element selection is currently
+    defined with the following points: (4,5), (6,8) (10,7), the bounding box
+    with be (4, 5), (10, 8).
+        The bounding box calculations _does_ include the current offset of the
+    selection within the dataspace extent.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S_hyper_bounds_helper(const H5S_hyper_span_info_t *spans, const hssize_t *offset, hsize_t rank, hsize_t *start, hsize_t *end)
+{
+    H5S_hyper_span_t *curr;             /* Hyperslab information nodes */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(spans);
+    HDassert(offset);
+    HDassert(rank < H5O_LAYOUT_NDIMS);
+    HDassert(start);
+    HDassert(end);
+
+    /* Check each point to determine whether selection+offset is within extent */
+    curr=spans->head;
+    while(curr!=NULL) {
+        /* Check for offset moving selection negative */
+        if(((hssize_t)curr->low + offset[rank]) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "offset moves selection out of bounds")
+
+        /* Check if the current span extends the bounding box */
+        if((curr->low + (hsize_t)offset[rank]) < start[rank])
+            start[rank] = curr->low + (hsize_t)offset[rank];
+        if((curr->high + (hsize_t)offset[rank]) > end[rank])
+            end[rank] = curr->high + (hsize_t)offset[rank];
+
+        /* Recurse if this node has down spans */
+        if(curr->down != NULL) {
+            if(H5S_hyper_bounds_helper(curr->down, offset, (rank + 1), start, end) < 0)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADSELECT, FAIL, "failure in lower dimension")
+        } /* end if */
+
+        /* Advance to next node */
+        curr = curr->next;
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S_hyper_bounds_helper() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_bounds
+ PURPOSE
+    Gets the bounding box containing the selection.
+ USAGE
+    herr_t H5S__hyper_bounds(space, hsize_t *start, hsize_t *end)
+        H5S_t *space;           IN: Dataspace pointer of selection to query
+        hsize_t *start;         OUT: Starting coordinate of bounding box
+        hsize_t *end;           OUT: Opposite coordinate of bounding box
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+    Retrieves the bounding box containing the current selection and places
+    it into the user's buffers.  The start and end buffers must be large
+    enough to hold the dataspace rank number of coordinates.  The bounding box
+    exactly contains the selection, ie. if a 2-D element selection is currently
+    defined with the following points: (4,5), (6,8) (10,7), the bounding box
+    with be (4, 5), (10, 8).
+        The bounding box calculations _does_ include the current offset of the
+    selection within the dataspace extent.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_bounds(const H5S_t *space, hsize_t *start, hsize_t *end)
+{
+    unsigned rank;              /* Dataspace rank */
+    unsigned i;                 /* index variable */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(space);
+    HDassert(start);
+    HDassert(end);
+
+    /* Set the start and end arrays up */
+    rank = space->extent.rank;
+    for(i = 0; i < rank; i++) {
+        start[i] = HSIZET_MAX;
+        end[i] = 0;
+    } /* end for */
+
+    /* Check for a "regular" hyperslab selection */
+    if(space->select.sel_info.hslab->diminfo_valid) {
+        const H5S_hyper_dim_t *diminfo = space->select.sel_info.hslab->opt_diminfo; /* local alias for diminfo */
+
+        /* Check each dimension */
+        for(i = 0; i < rank; i++) {
+            /* Check for offset moving selection negative */
+            if((space->select.offset[i] + (hssize_t)diminfo[i].start) < 0)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "offset moves selection out of bounds")
+
+            /* Compute the smallest location in this dimension */
+            start[i] = diminfo[i].start + (hsize_t)space->select.offset[i];
+
+            /* Compute the largest location in this dimension */
+            if((int)i == space->select.sel_info.hslab->unlim_dim)
+                end[i] = H5S_UNLIMITED;
+            else
+                end[i] = diminfo[i].start + diminfo[i].stride * (diminfo[i].count - 1) + (diminfo[i].block - 1) + (hsize_t)space->select.offset[i];
+        } /* end for */
+    } /* end if */
+    else {
+        /* Call the recursive routine to get the bounds for the span tree */
+        ret_value = H5S_hyper_bounds_helper(space->select.sel_info.hslab->span_lst, space->select.offset, (hsize_t)0, start, end);
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_bounds() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_offset
+ PURPOSE
+    Gets the linear offset of the first element for the selection.
+ USAGE
+    herr_t H5S__hyper_offset(space, offset)
+        const H5S_t *space;     IN: Dataspace pointer of selection to query
+        hsize_t *offset;        OUT: Linear offset of first element in selection
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+    Retrieves the linear offset (in "units" of elements) of the first element
+    selected within the dataspace.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    Calling this function on a "none" selection returns fail.
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_offset(const H5S_t *space, hsize_t *offset)
+{
+    const hssize_t *sel_offset; /* Pointer to the selection's offset */
+    const hsize_t *dim_size;    /* Pointer to a dataspace's extent */
+    hsize_t accum;              /* Accumulator for dimension sizes */
+    unsigned rank;              /* Dataspace rank */
+    int i;                      /* index variable */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(space && space->extent.rank>0);
+    HDassert(offset);
+
+    /* Start at linear offset 0 */
+    *offset = 0;
+
+    /* Set up pointers to arrays of values */
+    rank = space->extent.rank;
+    sel_offset = space->select.offset;
+    dim_size = space->extent.size;
+
+    /* Check for a "regular" hyperslab selection */
+    if(space->select.sel_info.hslab->diminfo_valid) {
+        const H5S_hyper_dim_t *diminfo = space->select.sel_info.hslab->opt_diminfo; /* Local alias for diminfo */
+
+        /* Loop through starting coordinates, calculating the linear offset */
+        accum = 1;
+        for(i = (int)(rank - 1); i >= 0; i--) {
+            hssize_t hyp_offset = (hssize_t)diminfo[i].start + sel_offset[i]; /* Hyperslab's offset in this dimension */
+
+            /* Check for offset moving selection out of the dataspace */
+            if(hyp_offset < 0 || (hsize_t)hyp_offset >= dim_size[i])
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "offset moves selection out of bounds")
+
+            /* Add the hyperslab's offset in this dimension to the total linear offset */
+            *offset += (hsize_t)(hyp_offset * (hssize_t)accum);
+
+            /* Increase the accumulator */
+            accum *= dim_size[i];
+        } /* end for */
+    } /* end if */
+    else {
+        const H5S_hyper_span_t *span;           /* Hyperslab span node */
+        hsize_t dim_accum[H5S_MAX_RANK];        /* Accumulators, for each dimension */
+
+        /* Calculate the accumulator for each dimension */
+        accum = 1;
+        for(i = (int)(rank - 1); i >= 0; i--) {
+            /* Set the accumulator for this dimension */
+            dim_accum[i] = accum;
+
+            /* Increase the accumulator */
+            accum *= dim_size[i];
+        } /* end for */
+
+        /* Get information for the first span, in the slowest changing dimension */
+        span = space->select.sel_info.hslab->span_lst->head;
+
+        /* Work down the spans, computing the linear offset */
+        i = 0;
+        while(span) {
+            hssize_t hyp_offset = (hssize_t)span->low + sel_offset[i]; /* Hyperslab's offset in this dimension */
+
+            /* Check for offset moving selection out of the dataspace */
+            if(hyp_offset < 0 || (hsize_t)hyp_offset >= dim_size[i])
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "offset moves selection out of bounds")
+
+            /* Add the hyperslab's offset in this dimension to the total linear offset */
+            *offset += (hsize_t)(hyp_offset * (hssize_t)dim_accum[i]);
+
+            /* Advance to first span in "down" dimension */
+            if(span->down) {
+                HDassert(span->down->head);
+                span = span->down->head;
+            } /* end if */
+            else
+                span = NULL;
+            i++;
+        } /* end while */
+    } /* end else */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_offset() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_unlim_dim
+ PURPOSE
+    Return unlimited dimension of selection, or -1 if none
+ USAGE
+    int H5S__hyper_unlim_dim(space)
+        H5S_t *space;           IN: Dataspace pointer to check
+ RETURNS
+    Unlimited dimension of selection, or -1 if none (never fails).
+ DESCRIPTION
+    Returns the index of the unlimited dimension of the selection, or -1
+    if the selection has no unlimited dimension.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static int
+H5S__hyper_unlim_dim(const H5S_t *space)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    FUNC_LEAVE_NOAPI(space->select.sel_info.hslab->unlim_dim);
+} /* end H5S__hyper_unlim_dim() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_num_elem_non_unlim
+ PURPOSE
+    Return number of elements in the non-unlimited dimensions
+ USAGE
+    herr_t H5S__hyper_num_elem_non_unlim(space,num_elem_non_unlim)
+        H5S_t *space;           IN: Dataspace pointer to check
+        hsize_t *num_elem_non_unlim; OUT: Number of elements in the non-unlimited dimensions
+ RETURNS
+    Non-negative on success/Negative on failure
+ DESCRIPTION
+    Returns the number of elements in a slice through the non-unlimited
+    dimensions of the selection.  Fails if the selection has no unlimited
+    dimension.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_num_elem_non_unlim(const H5S_t *space, hsize_t *num_elem_non_unlim)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(space);
+    HDassert(num_elem_non_unlim);
+
+    /* Get number of elements in the non-unlimited dimensions */
+    if(space->select.sel_info.hslab->unlim_dim >= 0)
+        *num_elem_non_unlim = space->select.sel_info.hslab->num_elem_non_unlim;
+    else
+        HGOTO_ERROR(H5E_DATASPACE, H5E_BADVALUE, FAIL, "selection has no unlimited dimension")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_num_elem_non_unlim() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_is_contiguous
+ PURPOSE
+    Check if a hyperslab selection is contiguous within the dataspace extent.
+ USAGE
+    htri_t H5S__hyper_is_contiguous(space)
+        H5S_t *space;           IN: Dataspace pointer to check
+ RETURNS
+    TRUE/FALSE/FAIL
+ DESCRIPTION
+    Checks to see if the current selection in the dataspace is contiguous.
+    This is primarily used for reading the entire selection in one swoop.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static htri_t
+H5S__hyper_is_contiguous(const H5S_t *space)
+{
+    hbool_t small_contiguous,       /* Flag for small contiguous block */
+        large_contiguous;           /* Flag for large contiguous block */
+    unsigned u;                     /* index variable */
+    htri_t ret_value = FALSE;       /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(space);
+
+    /* Check for a "regular" hyperslab selection */
+    if(space->select.sel_info.hslab->diminfo_valid) {
+        const H5S_hyper_dim_t *diminfo=space->select.sel_info.hslab->opt_diminfo; /* local alias for diminfo */
+
+        /*
+         * For a regular hyperslab to be contiguous, it must have only one
+         * block (i.e. count==1 in all dimensions) and the block size must be
+         * the same as the dataspace extent's in all but the slowest changing
+         * dimension. (dubbed "large contiguous" block)
+         *
+         * OR
+         *
+         * The selection must have only one block (i.e. count==1) in all
+         * dimensions and the block size must be 1 in all but the fastest
+         * changing dimension. (dubbed "small contiguous" block)
+         */
+
+        /* Initialize flags */
+        large_contiguous = TRUE;	/* assume true and reset if the dimensions don't match */
+        small_contiguous = FALSE;	/* assume false initially */
+
+        /* Check for a "large contigous" block */
+        for(u = 0; u < space->extent.rank; u++) {
+            if(diminfo[u].count > 1) {
+                large_contiguous = FALSE;
+                break;
+            } /* end if */
+            if(u > 0 && diminfo[u].block != space->extent.size[u]) {
+                large_contiguous = FALSE;
+                break;
+            } /* end if */
+        } /* end for */
+
+        /* If we didn't find a large contiguous block, check for a small one */
+        if(!large_contiguous) {
+            small_contiguous = TRUE;
+            for(u = 0; u < space->extent.rank; u++) {
+                if(diminfo[u].count > 1) {
+                    small_contiguous = FALSE;
+                    break;
+                } /* end if */
+                if(u < (space->extent.rank - 1) && diminfo[u].block != 1) {
+                    small_contiguous = FALSE;
+                    break;
+                } /* end if */
+            } /* end for */
+        } /* end if */
+
+        /* Indicate true if it's either a large or small contiguous block */
+        if(large_contiguous || small_contiguous)
+            ret_value = TRUE;
+    } /* end if */
+    else {
+        H5S_hyper_span_info_t *spans;   /* Hyperslab span info node */
+        H5S_hyper_span_t *span;         /* Hyperslab span node */
+
+        /*
+         * For a hyperslab to be contiguous, it must have only one block and
+         * (either it's size must be the same as the dataspace extent's in all
+         * but the slowest changing dimension
+         * OR
+         * block size must be 1 in all but the fastest changing dimension).
+         */
+        /* Initialize flags */
+        large_contiguous = TRUE;	/* assume true and reset if the dimensions don't match */
+        small_contiguous = FALSE;	/* assume false initially */
+
+        /* Get information for slowest changing information */
+        spans = space->select.sel_info.hslab->span_lst;
+        span = spans->head;
+
+        /* If there are multiple spans in the slowest changing dimension, the selection isn't contiguous */
+        if(span->next != NULL)
+            large_contiguous = FALSE;
+        else {
+            /* Now check the rest of the dimensions */
+            if(span->down != NULL) {
+                u = 1;    /* Current dimension working on */
+
+                /* Get the span information for the next fastest dimension */
+                spans = span->down;
+
+                /* Cycle down the spans until we run out of down spans or find a non-contiguous span */
+                while(spans != NULL) {
+                    span = spans->head;
+
+                    /* Check that this is the only span and it spans the entire dimension */
+                    if(span->next != NULL) {
+                        large_contiguous = FALSE;
+                        break;
+                    } /* end if */
+                    else {
+                        /* If this span doesn't cover the entire dimension, then this selection isn't contiguous */
+                        if(((span->high - span->low) + 1) != space->extent.size[u]) {
+                            large_contiguous = FALSE;
+                            break;
+                        } /* end if */
+                        else {
+                            /* Walk down to the next span */
+                            spans = span->down;
+
+                            /* Increment dimension */
+                            u++;
+                        } /* end else */
+                    } /* end else */
+                } /* end while */
+            } /* end if */
+        } /* end else */
+
+        /* If we didn't find a large contiguous block, check for a small one */
+        if(!large_contiguous) {
+            small_contiguous = TRUE;
+
+            /* Get information for slowest changing information */
+            spans = space->select.sel_info.hslab->span_lst;
+            span = spans->head;
+
+            /* Current dimension working on */
+            u = 0;
+
+            /* Cycle down the spans until we run out of down spans or find a non-contiguous span */
+            while(spans != NULL) {
+                span = spans->head;
+
+                /* Check that this is the only span and it spans the entire dimension */
+                if(span->next != NULL) {
+                    small_contiguous = FALSE;
+                    break;
+                } /* end if */
+                else {
+                    /* If this span doesn't cover the entire dimension, then this selection isn't contiguous */
+                    if(u < (space->extent.rank - 1) && ((span->high-span->low) + 1) != 1) {
+                        small_contiguous = FALSE;
+                        break;
+                    } /* end if */
+                    else {
+                        /* Walk down to the next span */
+                        spans = span->down;
+
+                        /* Increment dimension */
+                        u++;
+                    } /* end else */
+                } /* end else */
+            } /* end while */
+        } /* end if */
+
+        /* Indicate true if it's either a large or small contiguous block */
+        if(large_contiguous || small_contiguous)
+            ret_value = TRUE;
+    } /* end else */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_is_contiguous() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_is_single
+ PURPOSE
+    Check if a hyperslab selection is a single block within the dataspace extent.
+ USAGE
+    htri_t H5S__hyper_is_single(space)
+        H5S_t *space;           IN: Dataspace pointer to check
+ RETURNS
+    TRUE/FALSE/FAIL
+ DESCRIPTION
+    Checks to see if the current selection in the dataspace is a single block.
+    This is primarily used for reading the entire selection in one swoop.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static htri_t
+H5S__hyper_is_single(const H5S_t *space)
+{
+    htri_t ret_value = TRUE;        /* return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(space);
+
+    /* Check for a "single" hyperslab selection */
+    if(space->select.sel_info.hslab->diminfo_valid) {
+        unsigned u;                     /* index variable */
+
+        /*
+         * For a regular hyperslab to be single, it must have only one
+         * block (i.e. count==1 in all dimensions)
+         */
+
+        /* Check for a single block */
+        for(u = 0; u < space->extent.rank; u++) {
+            if(space->select.sel_info.hslab->opt_diminfo[u].count > 1)
+                HGOTO_DONE(FALSE)
+        } /* end for */
+    } /* end if */
+    else {
+        H5S_hyper_span_info_t *spans;   /* Hyperslab span info node */
+
+        /*
+         * For a region to be single, it must have only one block
+         */
+        /* Get information for slowest changing information */
+        spans = space->select.sel_info.hslab->span_lst;
+
+        /* Cycle down the spans until we run out of down spans or find a non-contiguous span */
+        while(spans != NULL) {
+            H5S_hyper_span_t *span;         /* Hyperslab span node */
+
+            span = spans->head;
+
+            /* Check that this is the only span and it spans the entire dimension */
+            if(span->next != NULL)
+                HGOTO_DONE(FALSE)
+            else
+                /* Walk down to the next span */
+                spans = span->down;
+        } /* end while */
+    } /* end else */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_is_single() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_is_regular
+ PURPOSE
+    Check if a hyperslab selection is "regular"
+ USAGE
+    htri_t H5S__hyper_is_regular(space)
+        const H5S_t *space;     IN: Dataspace pointer to check
+ RETURNS
+    TRUE/FALSE/FAIL
+ DESCRIPTION
+    Checks to see if the current selection in a dataspace is the a regular
+    pattern.
+    This is primarily used for reading the entire selection in one swoop.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    Doesn't check for "regular" hyperslab selections composed of spans
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static htri_t
+H5S__hyper_is_regular(const H5S_t *space)
+{
+    htri_t ret_value = FAIL;    /* return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Check args */
+    HDassert(space);
+
+    /* Only simple check for regular hyperslabs for now... */
+    if(space->select.sel_info.hslab->diminfo_valid)
+        ret_value = TRUE;
+    else
+        ret_value = FALSE;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_is_regular() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_release
+ PURPOSE
+    Release hyperslab selection information for a dataspace
+ USAGE
+    herr_t H5S__hyper_release(space)
+        H5S_t *space;       IN: Pointer to dataspace
+ RETURNS
+    Non-negative on success/Negative on failure
+ DESCRIPTION
+    Releases all hyperslab selection information for a dataspace
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+ * 	Robb Matzke, 1998-08-25
+ *	The fields which are freed are set to NULL to prevent them from being
+ *	freed again later.  This fixes some allocation problems where
+ *	changing the hyperslab selection of one dataspace causes a core dump
+ *	when closing some other dataspace.
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_release(H5S_t *space)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_STATIC
+
+    /* Check args */
+    HDassert(space && H5S_SEL_HYPERSLABS == H5S_GET_SELECT_TYPE(space));
+
+    /* Reset the number of points selected */
+    space->select.num_elem = 0;
+
+    /* Release irregular hyperslab information */
+    if(space->select.sel_info.hslab) {
+        if(space->select.sel_info.hslab->span_lst != NULL)
+            if(H5S__hyper_free_span_info(space->select.sel_info.hslab->span_lst) < 0)
+                HGOTO_ERROR(H5E_INTERNAL, H5E_CANTFREE, FAIL, "failed to release hyperslab spans")
+
+        /* Release space for the hyperslab selection information */
+        space->select.sel_info.hslab = H5FL_FREE(H5S_hyper_sel_t, space->select.sel_info.hslab);
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_release() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_recover_span
+ PURPOSE
+    Recover a generated span, if appropriate
+ USAGE
+    herr_t H5S__hyper_recover_span(recover, curr_span, next_span)
+        unsigned *recover;                 IN/OUT: Pointer recover flag
+        H5S_hyper_span_t **curr_span;   IN/OUT: Pointer to current span in list
+        H5S_hyper_span_t *next_span;    IN: Pointer to next span
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+    Check if the current span needs to be recovered and free it if so.
+    Set the current span to the next span in any case.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_recover_span(hbool_t *recover, H5S_hyper_span_t **curr_span, H5S_hyper_span_t *next_span)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(recover);
+    HDassert(curr_span);
+
+    /* Check if the span should be recovered */
+    if(*recover) {
+        H5S__hyper_free_span(*curr_span);
+        *recover = FALSE;
+    } /* end if */
+
+    /* Set the current span to next span */
+    *curr_span = next_span;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+}   /* H5S__hyper_recover_span() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_coord_to_span
+ PURPOSE
+    Create a span tree for a single element
+ USAGE
+    H5S_hyper_span_t *H5S__hyper_coord_to_span(rank, coords)
+        unsigned rank;                  IN: Number of dimensions of coordinate
+        hsize_t *coords;               IN: Location of element
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+    Create a span tree for a single element
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static H5S_hyper_span_t *
+H5S__hyper_coord_to_span(unsigned rank, const hsize_t *coords)
+{
+    H5S_hyper_span_t *new_span;         /* Pointer to new span tree for coordinate */
+    H5S_hyper_span_info_t *down = NULL; /* Pointer to new span tree for next level down */
+    H5S_hyper_span_t *ret_value = NULL; /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(rank > 0);
+    HDassert(coords);
+
+    /* Search for location to insert new element in tree */
+    if(rank > 1) {
+        /* Allocate a span info node */
+        if(NULL == (down = H5FL_CALLOC(H5S_hyper_span_info_t)))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span")
+
+
+        /* Build span tree for coordinates below this one */
+        if(NULL == (down->head = H5S__hyper_coord_to_span(rank - 1, &coords[1])))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span")
+    } /* end if */
+
+    /* Build span for this coordinate */
+    if(NULL == (new_span = H5S__hyper_new_span(coords[0], coords[0], down, NULL)))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span")
+
+    /* Set return value */
+    ret_value = new_span;
+
+done:
+    if(ret_value == NULL && down != NULL)
+        H5S__hyper_free_span_info(down);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_coord_to_span() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_add_span_element_helper
+ PURPOSE
+    Add a single element to a span tree
+ USAGE
+    herr_t H5S_hyper_add_span_element_helper(prev_span, span_tree, rank, coords)
+        H5S_hyper_span_info_t *span_tree;  IN/OUT: Pointer to span tree to append to
+        unsigned rank;                  IN: Number of dimensions of coordinates
+        hsize_t *coords;               IN: Location of element to add to span tree
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+    Add a single element to an existing span tree.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    Assumes that the element is not already covered by the span tree
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_add_span_element_helper(H5S_hyper_span_info_t *span_tree,
+    unsigned rank, const hsize_t *coords)
+{
+    H5S_hyper_span_info_t *tspan_info;  /* Temporary pointer to span info */
+    H5S_hyper_span_info_t *prev_span_info;  /* Pointer to span info for level above current position */
+    H5S_hyper_span_t *tmp_span;         /* Temporary pointer to a span */
+    H5S_hyper_span_t *tmp2_span;        /* Another temporary pointer to a span */
+    H5S_hyper_span_t *new_span;         /* New span created for element */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
     /* Sanity check */
-    HDassert(space);
-    HDassert(num_elem_non_unlim);
+    HDassert(span_tree);
+    HDassert(rank > 0);
+    HDassert(coords);
 
-    /* Get number of elements in the non-unlimited dimensions */
-    if(space->select.sel_info.hslab->unlim_dim >= 0)
-        *num_elem_non_unlim = space->select.sel_info.hslab->num_elem_non_unlim;
-    else
-        HGOTO_ERROR(H5E_DATASPACE, H5E_BADVALUE, FAIL, "selection has no unlimited dimension")
+    /* Get pointer to last span in span tree */
+    tspan_info=span_tree;
+    if(span_tree->scratch)
+        tmp_span=(H5S_hyper_span_t *)span_tree->scratch;
+    else {
+        tmp_span=span_tree->head;
+        HDassert(tmp_span);
+        span_tree->scratch=(H5S_hyper_span_info_t *)tmp_span;
+    } /* end else */
+
+    /* Find last span tree which includes a portion of the coordinate */
+    prev_span_info=NULL;
+    while(coords[0]>=tmp_span->low && coords[0]<=tmp_span->high) {
+        /* Move rank & coordinate offset down a dimension */
+        rank--;
+        coords++;
+
+        /* Remember the span tree we are descending into */
+        prev_span_info=tspan_info;
+        tspan_info=tmp_span->down;
+
+        /* Get the last span in this span's 'down' tree */
+        if(tspan_info->scratch)
+            tmp_span=(H5S_hyper_span_t *)tspan_info->scratch;
+        else {
+            tmp_span=tspan_info->head;
+            HDassert(tmp_span);
+            tspan_info->scratch=(H5S_hyper_span_info_t *)tmp_span;
+        } /* end else */
+    } /* end while */
+
+    /* Check if we made it all the way to the bottom span in the tree */
+    if(rank>1) {
+        /* Before we create another span at this level in the tree, check if
+         * the last span's "down tree" was equal to any other spans in this
+         * list of spans in the span tree.
+         *
+         * If so, release last span information and make last span merge into
+         * previous span (if possible), or at least share their "down tree"
+         * information.
+         */
+        tmp2_span=tspan_info->head;
+        while(tmp2_span!=tmp_span) {
+            if(H5S__hyper_cmp_spans(tmp2_span->down,tmp_span->down)==TRUE) {
+                /* Check for merging into previous span */
+                if(tmp2_span->high+1==tmp_span->low) {
+                    /* Release last span created */
+                    H5S__hyper_free_span(tmp_span);
+
+                    /* Increase size of previous span */
+                    tmp2_span->high++;
+                    tmp2_span->nelem++;
+
+                    /* Reset the 'tmp_span' for the rest of this block's algorithm */
+                    tmp_span=tmp2_span;
+                } /* end if */
+                /* Span is disjoint, but has the same "down tree" selection */
+                else {
+                    /* Release "down tree" information */
+                    H5S__hyper_free_span_info(tmp_span->down);
+
+                    /* Point at earlier span's "down tree" */
+                    tmp_span->down=tmp2_span->down;
+
+                    /* Increment reference count on shared "down tree" */
+                    tmp_span->down->count++;
+                } /* end else */
+
+                /* Found span to merge into, break out now */
+                break;
+            } /* end if */
+
+            /* Advance to next span to check */
+            tmp2_span=tmp2_span->next;
+        } /* end while */
+
+        /* Make span tree for current coordinates */
+        if(NULL == (new_span = H5S__hyper_coord_to_span(rank, coords)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate hyperslab span")
+
+        /* Add new span tree as span */
+        HDassert(tmp_span);
+        tmp_span->next=new_span;
+
+        /* Make scratch pointer point to last span in list */
+        HDassert(tspan_info);
+        tspan_info->scratch=(H5S_hyper_span_info_t *)new_span;
+
+        /* Set the proper 'pstride' for new span */
+        new_span->pstride=new_span->low-tmp_span->low;
+    } /* end if */
+    else {
+        /* Does new node adjoin existing node? */
+        if(tmp_span->high+1==coords[0]) {
+            tmp_span->high++;
+            tmp_span->nelem++;
+
+            /* Check if this span tree should now be merged with a level higher in the tree */
+            if(prev_span_info!=NULL) {
+                /* Before we create another span at this level in the tree, check if
+                 * the last span's "down tree" was equal to any other spans in this
+                 * list of spans in the span tree.
+                 *
+                 * If so, release last span information and make last span merge into
+                 * previous span (if possible), or at least share their "down tree"
+                 * information.
+                 */
+                tmp2_span=prev_span_info->head;
+                tmp_span=(H5S_hyper_span_t *)prev_span_info->scratch;
+                while(tmp2_span!=tmp_span) {
+                    if(H5S__hyper_cmp_spans(tmp2_span->down,tmp_span->down)==TRUE) {
+                        /* Check for merging into previous span */
+                        if(tmp2_span->high+1==tmp_span->low) {
+                            /* Release last span created */
+                            H5S__hyper_free_span(tmp_span);
+
+                            /* Increase size of previous span */
+                            tmp2_span->high++;
+                            tmp2_span->nelem++;
+
+                            /* Update pointers */
+                            tmp2_span->next=NULL;
+                            prev_span_info->scratch=(H5S_hyper_span_info_t *)tmp2_span;
+                        } /* end if */
+                        /* Span is disjoint, but has the same "down tree" selection */
+                        else {
+                            /* Release "down tree" information */
+                            H5S__hyper_free_span_info(tmp_span->down);
+
+                            /* Point at earlier span's "down tree" */
+                            tmp_span->down=tmp2_span->down;
+
+                            /* Increment reference count on shared "down tree" */
+                            tmp_span->down->count++;
+                        } /* end else */
+
+                        /* Found span to merge into, break out now */
+                        break;
+                    } /* end if */
+
+                    /* Advance to next span to check */
+                    tmp2_span=tmp2_span->next;
+                } /* end while */
+            } /* end if */
+        } /* end if */
+        else {
+            if(NULL == (new_span = H5S__hyper_new_span(coords[0], coords[0], NULL, NULL)))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate hyperslab span")
+
+            /* Add new span tree as span */
+            HDassert(tmp_span);
+            tmp_span->next=new_span;
+
+            /* Make scratch pointer point to last span in list */
+            tspan_info->scratch=(H5S_hyper_span_info_t *)new_span;
+
+            /* Set the proper 'pstride' for new span */
+            new_span->pstride = new_span->low - tmp_span->low;
+        } /* end else */
+    } /* end else */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_num_elem_non_unlim() */
+} /* end H5S__hyper_add_span_element_helper() */
 
 
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_is_contiguous
+    H5S_hyper_add_span_element
  PURPOSE
-    Check if a hyperslab selection is contiguous within the dataspace extent.
+    Add a single element to a span tree
  USAGE
-    htri_t H5S__hyper_is_contiguous(space)
-        H5S_t *space;           IN: Dataspace pointer to check
+    herr_t H5S_hyper_add_span_element(space, span_tree, rank, coords)
+        H5S_t *space;           IN/OUT: Pointer to dataspace to add coordinate to
+        unsigned rank;          IN: Number of dimensions of coordinates
+        hsize_t *coords;       IN: Location of element to add to span tree
  RETURNS
-    TRUE/FALSE/FAIL
+    Non-negative on success, negative on failure
  DESCRIPTION
-    Checks to see if the current selection in the dataspace is contiguous.
-    This is primarily used for reading the entire selection in one swoop.
+    Add a single element to an existing span tree.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
+    Assumes that the element is not already in the dataspace's selection
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static htri_t
-H5S__hyper_is_contiguous(const H5S_t *space)
+herr_t
+H5S_hyper_add_span_element(H5S_t *space, unsigned rank, const hsize_t *coords)
 {
-    hbool_t small_contiguous,       /* Flag for small contiguous block */
-        large_contiguous;           /* Flag for large contiguous block */
-    unsigned u;                     /* index variable */
-    htri_t ret_value = FALSE;       /* Return value */
+    H5S_hyper_span_info_t *head = NULL;    /* Pointer to new head of span tree */
+    herr_t      ret_value = SUCCEED;       /* Return value */
 
-    FUNC_ENTER_STATIC_NOERR
+    FUNC_ENTER_NOAPI(FAIL)
 
     HDassert(space);
+    HDassert(rank > 0);
+    HDassert(coords);
+    HDassert(space->extent.rank == rank);
 
-    /* Check for a "regular" hyperslab selection */
-    if(space->select.sel_info.hslab->diminfo_valid) {
-        const H5S_hyper_dim_t *diminfo=space->select.sel_info.hslab->opt_diminfo; /* local alias for diminfo */
-
-        /*
-         * For a regular hyperslab to be contiguous, it must have only one
-         * block (i.e. count==1 in all dimensions) and the block size must be
-         * the same as the dataspace extent's in all but the slowest changing
-         * dimension. (dubbed "large contiguous" block)
-         *
-         * OR
-         *
-         * The selection must have only one block (i.e. count==1) in all
-         * dimensions and the block size must be 1 in all but the fastest
-         * changing dimension. (dubbed "small contiguous" block)
-         */
-
-        /* Initialize flags */
-        large_contiguous = TRUE;	/* assume true and reset if the dimensions don't match */
-        small_contiguous = FALSE;	/* assume false initially */
-
-        /* Check for a "large contigous" block */
-        for(u = 0; u < space->extent.rank; u++) {
-            if(diminfo[u].count > 1) {
-                large_contiguous = FALSE;
-                break;
-            } /* end if */
-            if(u > 0 && diminfo[u].block != space->extent.size[u]) {
-                large_contiguous = FALSE;
-                break;
-            } /* end if */
-        } /* end for */
-
-        /* If we didn't find a large contiguous block, check for a small one */
-        if(!large_contiguous) {
-            small_contiguous = TRUE;
-            for(u = 0; u < space->extent.rank; u++) {
-                if(diminfo[u].count > 1) {
-                    small_contiguous = FALSE;
-                    break;
-                } /* end if */
-                if(u < (space->extent.rank - 1) && diminfo[u].block != 1) {
-                    small_contiguous = FALSE;
-                    break;
-                } /* end if */
-            } /* end for */
-        } /* end if */
-
-        /* Indicate true if it's either a large or small contiguous block */
-        if(large_contiguous || small_contiguous)
-            ret_value = TRUE;
-    } /* end if */
-    else {
-        H5S_hyper_span_info_t *spans;   /* Hyperslab span info node */
-        H5S_hyper_span_t *span;         /* Hyperslab span node */
-
-        /*
-         * For a hyperslab to be contiguous, it must have only one block and
-         * (either it's size must be the same as the dataspace extent's in all
-         * but the slowest changing dimension
-         * OR
-         * block size must be 1 in all but the fastest changing dimension).
-         */
-        /* Initialize flags */
-        large_contiguous = TRUE;	/* assume true and reset if the dimensions don't match */
-        small_contiguous = FALSE;	/* assume false initially */
-
-        /* Get information for slowest changing information */
-        spans = space->select.sel_info.hslab->span_lst;
-        span = spans->head;
-
-        /* If there are multiple spans in the slowest changing dimension, the selection isn't contiguous */
-        if(span->next != NULL)
-            large_contiguous = FALSE;
-        else {
-            /* Now check the rest of the dimensions */
-            if(span->down != NULL) {
-                u = 1;    /* Current dimension working on */
-
-                /* Get the span information for the next fastest dimension */
-                spans = span->down;
+    /* Check if this is the first element in the selection */
+    if(NULL == space->select.sel_info.hslab) {
+        /* Allocate a span info node */
+        if(NULL == (head = H5FL_CALLOC(H5S_hyper_span_info_t)))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, FAIL, "can't allocate hyperslab span info")
 
-                /* Cycle down the spans until we run out of down spans or find a non-contiguous span */
-                while(spans != NULL) {
-                    span = spans->head;
+        /* Set the reference count */
+        head->count = 1;
 
-                    /* Check that this is the only span and it spans the entire dimension */
-                    if(span->next != NULL) {
-                        large_contiguous = FALSE;
-                        break;
-                    } /* end if */
-                    else {
-                        /* If this span doesn't cover the entire dimension, then this selection isn't contiguous */
-                        if(((span->high - span->low) + 1) != space->extent.size[u]) {
-                            large_contiguous = FALSE;
-                            break;
-                        } /* end if */
-                        else {
-                            /* Walk down to the next span */
-                            spans = span->down;
+        /* Build span tree for this coordinate */
+        if(NULL == (head->head = H5S__hyper_coord_to_span(rank, coords)))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, FAIL, "can't allocate hyperslab spans for coordinate")
 
-                            /* Increment dimension */
-                            u++;
-                        } /* end else */
-                    } /* end else */
-                } /* end while */
-            } /* end if */
-        } /* end else */
+        /* Allocate selection info */
+        if(NULL == (space->select.sel_info.hslab = H5FL_MALLOC(H5S_hyper_sel_t)))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, FAIL, "can't allocate hyperslab selection")
 
-        /* If we didn't find a large contiguous block, check for a small one */
-        if(!large_contiguous) {
-            small_contiguous = TRUE;
+        /* Set the selection to the new span tree */
+        space->select.sel_info.hslab->span_lst = head;
 
-            /* Get information for slowest changing information */
-            spans = space->select.sel_info.hslab->span_lst;
-            span = spans->head;
+        /* Set selection type */
+        space->select.type = H5S_sel_hyper;
 
-            /* Current dimension working on */
-            u = 0;
+        /* Reset "regular" hyperslab flag */
+        space->select.sel_info.hslab->diminfo_valid = FALSE;
 
-            /* Cycle down the spans until we run out of down spans or find a non-contiguous span */
-            while(spans != NULL) {
-                span = spans->head;
+        /* Set unlim_dim */
+        space->select.sel_info.hslab->unlim_dim = -1;
 
-                /* Check that this is the only span and it spans the entire dimension */
-                if(span->next != NULL) {
-                    small_contiguous = FALSE;
-                    break;
-                } /* end if */
-                else {
-                    /* If this span doesn't cover the entire dimension, then this selection isn't contiguous */
-                    if(u < (space->extent.rank - 1) && ((span->high-span->low) + 1) != 1) {
-                        small_contiguous = FALSE;
-                        break;
-                    } /* end if */
-                    else {
-                        /* Walk down to the next span */
-                        spans = span->down;
+        /* Set # of elements in selection */
+        space->select.num_elem = 1;
+    } /* end if */
+    else {
+        /* The tree is changed in place, so any search index is stale */
+        H5S__hyper_idx_free(space->select.sel_info.hslab->span_lst);
 
-                        /* Increment dimension */
-                        u++;
-                    } /* end else */
-                } /* end else */
-            } /* end while */
-        } /* end if */
+        if(H5S__hyper_add_span_element_helper(space->select.sel_info.hslab->span_lst, rank, coords) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, FAIL, "can't insert coordinate into span tree")
 
-        /* Indicate true if it's either a large or small contiguous block */
-        if(large_contiguous || small_contiguous)
-            ret_value = TRUE;
+        /* Increment # of elements in selection */
+        space->select.num_elem++;
     } /* end else */
 
+done:
+    if(ret_value < 0)
+        if(head)
+            H5S__hyper_free_span_info(head);
+
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_is_contiguous() */
+} /* end H5S_hyper_add_span_element() */
 
 
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_is_single
+    H5S_hyper_reset_scratch
  PURPOSE
-    Check if a hyperslab selection is a single block within the dataspace extent.
+    Reset the scratch information for span tree
  USAGE
-    htri_t H5S__hyper_is_single(space)
-        H5S_t *space;           IN: Dataspace pointer to check
+    herr_t H5S_hyper_reset_scratch(space)
+        H5S_t *space;           IN/OUT: Pointer to dataspace to reset scratch pointers
  RETURNS
-    TRUE/FALSE/FAIL
+    Non-negative on success, negative on failure
  DESCRIPTION
-    Checks to see if the current selection in the dataspace is a single block.
-    This is primarily used for reading the entire selection in one swoop.
+    Resets the "scratch" pointers used for various tasks in computing hyperslab
+    spans.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static htri_t
-H5S__hyper_is_single(const H5S_t *space)
-{
-    htri_t ret_value = TRUE;        /* return value */
-
-    FUNC_ENTER_STATIC_NOERR
-
-    HDassert(space);
-
-    /* Check for a "single" hyperslab selection */
-    if(space->select.sel_info.hslab->diminfo_valid) {
-        unsigned u;                     /* index variable */
-
-        /*
-         * For a regular hyperslab to be single, it must have only one
-         * block (i.e. count==1 in all dimensions)
-         */
-
-        /* Check for a single block */
-        for(u = 0; u < space->extent.rank; u++) {
-            if(space->select.sel_info.hslab->opt_diminfo[u].count > 1)
-                HGOTO_DONE(FALSE)
-        } /* end for */
-    } /* end if */
-    else {
-        H5S_hyper_span_info_t *spans;   /* Hyperslab span info node */
-
-        /*
-         * For a region to be single, it must have only one block
-         */
-        /* Get information for slowest changing information */
-        spans = space->select.sel_info.hslab->span_lst;
+herr_t
+H5S_hyper_reset_scratch(H5S_t *space)
+{
+    herr_t      ret_value = SUCCEED;       /* Return value */
 
-        /* Cycle down the spans until we run out of down spans or find a non-contiguous span */
-        while(spans != NULL) {
-            H5S_hyper_span_t *span;         /* Hyperslab span node */
+    FUNC_ENTER_NOAPI(FAIL)
 
-            span = spans->head;
+    HDassert(space);
 
-            /* Check that this is the only span and it spans the entire dimension */
-            if(span->next != NULL)
-                HGOTO_DONE(FALSE)
-            else
-                /* Walk down to the next span */
-                spans = span->down;
-        } /* end while */
-    } /* end else */
+    /* Check if there are spans in the span tree */
+    if(space->select.sel_info.hslab->span_lst != NULL)
+        /* Reset the scratch pointers for the next routine which needs them */
+        H5S__hyper_span_scratch(space->select.sel_info.hslab->span_lst);
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_is_single() */
+} /* end H5S_hyper_reset_scratch() */
 
 
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_is_regular
+    H5S_hyper_convert
  PURPOSE
-    Check if a hyperslab selection is "regular"
+    Convert a compatible selection to span tree form
  USAGE
-    htri_t H5S__hyper_is_regular(space)
-        const H5S_t *space;     IN: Dataspace pointer to check
+    herr_t H5S_hyper_convert(space)
+        H5S_t *space;           IN/OUT: Pointer to dataspace to convert
  RETURNS
-    TRUE/FALSE/FAIL
+    Non-negative on success, negative on failure
  DESCRIPTION
-    Checks to see if the current selection in a dataspace is the a regular
-    pattern.
-    This is primarily used for reading the entire selection in one swoop.
+    Converts a compatible selection (currently only "all" selections) to the
+    span-tree form of a hyperslab selection. (Point and "none" selection aren't
+    currently supported and hyperslab selection always have the span-tree form
+    available).
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
-    Doesn't check for "regular" hyperslab selections composed of spans
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static htri_t
-H5S__hyper_is_regular(const H5S_t *space)
+herr_t
+H5S_hyper_convert(H5S_t *space)
 {
-    htri_t ret_value = FAIL;    /* return value */
+    herr_t      ret_value = SUCCEED;       /* Return value */
 
-    FUNC_ENTER_STATIC_NOERR
+    FUNC_ENTER_NOAPI(FAIL)
 
-    /* Check args */
     HDassert(space);
 
-    /* Only simple check for regular hyperslabs for now... */
-    if(space->select.sel_info.hslab->diminfo_valid)
-        ret_value = TRUE;
-    else
-        ret_value = FALSE;
+    /* Check the type of selection */
+    switch(H5S_GET_SELECT_TYPE(space)) {
+        case H5S_SEL_ALL:    /* All elements selected in dataspace */
+            /* Convert current "all" selection to "real" hyperslab selection */
+            {
+                const hsize_t *tmp_start;       /* Temporary start information */
+                const hsize_t *tmp_stride;      /* Temporary stride information */
+                const hsize_t *tmp_count;       /* Temporary count information */
+                const hsize_t *tmp_block;       /* Temporary block information */
+
+                /* Set up temporary information for the dimensions */
+                tmp_start = H5S_hyper_zeros_g;
+                tmp_stride = tmp_count = H5S_hyper_ones_g;
+                tmp_block = space->extent.size;
+
+                /* Convert to hyperslab selection */
+                if(H5S_select_hyperslab(space,H5S_SELECT_SET,tmp_start,tmp_stride,tmp_count,tmp_block)<0)
+                    HGOTO_ERROR(H5E_DATASPACE, H5E_CANTSET, FAIL, "can't convert selection")
+            } /* end case */
+            break;
+
+        case H5S_SEL_HYPERSLABS:        /* Hyperslab selection */
+            break;
+
+        case H5S_SEL_NONE:   /* No elements selected in dataspace */
+        case H5S_SEL_POINTS: /* Point selection */
+        case H5S_SEL_ERROR:  /* Selection error */
+        case H5S_SEL_N:      /* Selection count */
+        default:
+            HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, FAIL, "can't convert to span tree selection")
+    } /* end switch */
 
+done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_is_regular() */
+} /* end H5S_hyper_convert() */
 
+#ifdef LATER
 
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_release
+    H5S_hyper_intersect_helper
  PURPOSE
-    Release hyperslab selection information for a dataspace
+    Helper routine to detect intersections in span trees
  USAGE
-    herr_t H5S__hyper_release(space)
-        H5S_t *space;       IN: Pointer to dataspace
+    htri_t H5S_hyper_intersect_helper(spans1, spans2)
+        H5S_hyper_span_info_t *spans1;     IN: First span tree to operate with
+        H5S_hyper_span_info_t *spans2;     IN: Second span tree to operate with
  RETURNS
-    Non-negative on success/Negative on failure
+    Non-negative on success, negative on failure
  DESCRIPTION
-    Releases all hyperslab selection information for a dataspace
+    Quickly detect intersections between two span trees
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
- * 	Robb Matzke, 1998-08-25
- *	The fields which are freed are set to NULL to prevent them from being
- *	freed again later.  This fixes some allocation problems where
- *	changing the hyperslab selection of one dataspace causes a core dump
- *	when closing some other dataspace.
 --------------------------------------------------------------------------*/
-static herr_t
-H5S__hyper_release(H5S_t *space)
+static htri_t
+H5S_hyper_intersect_helper (H5S_hyper_span_info_t *spans1, H5S_hyper_span_info_t *spans2)
 {
-    herr_t ret_value = SUCCEED;
+    H5S_hyper_span_t *curr1;    /* Pointer to current span in 1st span tree */
+    H5S_hyper_span_t *curr2;    /* Pointer to current span in 2nd span tree */
+    htri_t status;              /* Status from recursive call */
+    htri_t ret_value=FALSE;     /* Return value */
 
-    FUNC_ENTER_STATIC
+    FUNC_ENTER_NOAPI_NOINIT
 
-    /* Check args */
-    HDassert(space && H5S_SEL_HYPERSLABS == H5S_GET_SELECT_TYPE(space));
+    /* Sanity check */
+    HDassert((spans1 && spans2) || (spans1 == NULL && spans2 == NULL));
 
-    /* Reset the number of points selected */
-    space->select.num_elem = 0;
+    /* "NULL" span trees compare as overlapping */
+    if(spans1==NULL && spans2==NULL)
+        HGOTO_DONE(TRUE);
 
-    /* Release irregular hyperslab information */
-    if(space->select.sel_info.hslab) {
-        if(space->select.sel_info.hslab->span_lst != NULL)
-            if(H5S__hyper_free_span_info(space->select.sel_info.hslab->span_lst) < 0)
-                HGOTO_ERROR(H5E_INTERNAL, H5E_CANTFREE, FAIL, "failed to release hyperslab spans")
+    /* Get the span lists for each span in this tree */
+    curr1=spans1->head;
+    curr2=spans2->head;
 
-        /* Release space for the hyperslab selection information */
-        space->select.sel_info.hslab = H5FL_FREE(H5S_hyper_sel_t, space->select.sel_info.hslab);
-    } /* end if */
+    /* Iterate over the spans in each tree */
+    while(curr1!=NULL && curr2!=NULL) {
+        /* Check for 1st span entirely before 2nd span */
+        if(curr1->high<curr2->low)
+            curr1=curr1->next;
+        /* Check for 2nd span entirely before 1st span */
+        else if(curr2->high<curr1->low)
+            curr2=curr2->next;
+        /* Spans must overlap */
+        else {
+            /* Recursively check spans in next dimension down */
+            if((status=H5S_hyper_intersect_helper(curr1->down,curr2->down))<0)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_BADSELECT, FAIL, "can't perform hyperslab intersection check")
+
+            /* If there is a span intersection in the down dimensions, the span trees overlap */
+            if(status==TRUE)
+                HGOTO_DONE(TRUE);
+
+            /* No intersection in down dimensions, advance to next span */
+            if(curr1->high<curr2->high)
+                curr1=curr1->next;
+            else
+                curr2=curr2->next;
+        } /* end else */
+    } /* end while */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_release() */
+}   /* H5S_hyper_intersect_helper() */
 
 
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_recover_span
+    H5S_hyper_intersect
  PURPOSE
-    Recover a generated span, if appropriate
+    Detect intersections in span trees
  USAGE
-    herr_t H5S__hyper_recover_span(recover, curr_span, next_span)
-        unsigned *recover;                 IN/OUT: Pointer recover flag
-        H5S_hyper_span_t **curr_span;   IN/OUT: Pointer to current span in list
-        H5S_hyper_span_t *next_span;    IN: Pointer to next span
+    htri_t H5S_hyper_intersect(space1, space2)
+        H5S_t *space1;     IN: First dataspace to operate on span tree
+        H5S_t *space2;     IN: Second dataspace to operate on span tree
  RETURNS
     Non-negative on success, negative on failure
  DESCRIPTION
-    Check if the current span needs to be recovered and free it if so.
-    Set the current span to the next span in any case.
+    Quickly detect intersections between two span trees
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static herr_t
-H5S__hyper_recover_span(hbool_t *recover, H5S_hyper_span_t **curr_span, H5S_hyper_span_t *next_span)
+htri_t
+H5S_hyper_intersect (H5S_t *space1, H5S_t *space2)
 {
-    FUNC_ENTER_STATIC_NOERR
+    htri_t ret_value=FAIL;      /* Return value */
 
-    HDassert(recover);
-    HDassert(curr_span);
+    FUNC_ENTER_NOAPI_NOINIT
 
-    /* Check if the span should be recovered */
-    if(*recover) {
-        H5S__hyper_free_span(*curr_span);
-        *recover = FALSE;
-    } /* end if */
+    /* Sanity check */
+    HDassert(space1);
+    HDassert(space2);
 
-    /* Set the current span to next span */
-    *curr_span = next_span;
+    /* Check that the space selections both have span trees */
+    if(space1->select.sel_info.hslab->span_lst==NULL ||
+            space2->select.sel_info.hslab->span_lst==NULL)
+        HGOTO_ERROR(H5E_DATASPACE, H5E_UNINITIALIZED, FAIL, "dataspace does not have span tree")
 
-    FUNC_LEAVE_NOAPI(SUCCEED)
-}   /* H5S__hyper_recover_span() */
+    /* Check that the dataspaces are both the same rank */
+    if(space1->extent.rank!=space2->extent.rank)
+        HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "dataspace ranks don't match")
+
+    /* Perform the span-by-span intersection check */
+    if((ret_value=H5S_hyper_intersect_helper(space1->select.sel_info.hslab->span_lst,space2->select.sel_info.hslab->span_lst))<0)
+        HGOTO_ERROR(H5E_DATASPACE, H5E_BADSELECT, FAIL, "can't perform hyperslab intersection check")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+}   /* H5S_hyper_intersect() */
+#endif /* LATER */
 
 
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_coord_to_span
+    H5S__hyper_idx_count
  PURPOSE
-    Create a span tree for a single element
+    Count the nodes, spans & bounds needed to index a span tree
  USAGE
-    H5S_hyper_span_t *H5S__hyper_coord_to_span(rank, coords)
-        unsigned rank;                  IN: Number of dimensions of coordinate
-        hsize_t *coords;               IN: Location of element
+    void H5S__hyper_idx_count(spans, ndims, nnodes, nspans, nbounds)
+        H5S_hyper_span_info_t *spans;   IN: Span tree to count
+        unsigned ndims;                 IN: # of dimensions in the tree
+        size_t *nnodes;                 IN/OUT: # of index nodes
+        size_t *nspans;                 IN/OUT: # of index spans
+        size_t *nbounds;                IN/OUT: # of index bounds
  RETURNS
-    Non-negative on success, negative on failure
+    None
  DESCRIPTION
-    Create a span tree for a single element
+    Walk the span tree, counting each shared list once.  Lists visited are
+    marked with their scratch pointer, which must be reset by the caller.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static H5S_hyper_span_t *
-H5S__hyper_coord_to_span(unsigned rank, const hsize_t *coords)
+static void
+H5S__hyper_idx_count(H5S_hyper_span_info_t *spans, unsigned ndims,
+    size_t *nnodes, size_t *nspans, size_t *nbounds)
 {
-    H5S_hyper_span_t *new_span;         /* Pointer to new span tree for coordinate */
-    H5S_hyper_span_info_t *down = NULL; /* Pointer to new span tree for next level down */
-    H5S_hyper_span_t *ret_value = NULL; /* Return value */
-
-    FUNC_ENTER_STATIC
+    H5S_hyper_span_t *span;     /* Current span */
 
-    HDassert(rank > 0);
-    HDassert(coords);
+    FUNC_ENTER_STATIC_NOERR
 
-    /* Search for location to insert new element in tree */
-    if(rank > 1) {
-        /* Allocate a span info node */
-        if(NULL == (down = H5FL_CALLOC(H5S_hyper_span_info_t)))
-            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span")
+    HDassert(spans);
+    HDassert(ndims > 0);
 
+    if(spans->scratch == NULL) {
+        spans->scratch = (H5S_hyper_span_info_t *)~((size_t)NULL);
 
-        /* Build span tree for coordinates below this one */
-        if(NULL == (down->head = H5S__hyper_coord_to_span(rank - 1, &coords[1])))
-            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span")
+        (*nnodes)++;
+        *nbounds += 2 * ndims;
+        for(span = spans->head; span != NULL; span = span->next) {
+            (*nspans)++;
+            if(span->down)
+                H5S__hyper_idx_count(span->down, ndims - 1, nnodes, nspans, nbounds);
+        } /* end for */
     } /* end if */
 
-    /* Build span for this coordinate */
-    if(NULL == (new_span = H5S__hyper_new_span(coords[0], coords[0], down, NULL)))
-        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span")
-
-    /* Set return value */
-    ret_value = new_span;
-
-done:
-    if(ret_value == NULL && down != NULL)
-        H5S__hyper_free_span_info(down);
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5S__hyper_idx_count() */
 
-    FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_coord_to_span() */
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S__hyper_add_span_element_helper
+    H5S__hyper_idx_fill
  PURPOSE
-    Add a single element to a span tree
+    Add a list of spans to a span tree search index
  USAGE
-    herr_t H5S_hyper_add_span_element_helper(prev_span, span_tree, rank, coords)
-        H5S_hyper_span_info_t *span_tree;  IN/OUT: Pointer to span tree to append to
-        unsigned rank;                  IN: Number of dimensions of coordinates
-        hsize_t *coords;               IN: Location of element to add to span tree
+    const H5S_hyper_idx_node_t *H5S__hyper_idx_fill(idx, spans, ndims)
+        H5S_hyper_span_idx_t *idx;      IN/OUT: Index to fill
+        H5S_hyper_span_info_t *spans;   IN: Span list to add
+        unsigned ndims;                 IN: # of dimensions in the list's tree
  RETURNS
-    Non-negative on success, negative on failure
+    Index node for the list, can't fail
  DESCRIPTION
-    Add a single element to an existing span tree.
+    Add the list and, recursively, the lists below it to the index, then
+    compute the list's bounding box from its spans and their down lists.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
-    Assumes that the element is not already covered by the span tree
+    The arrays in the index must have been sized with
+    H5S__hyper_idx_count().  Each list's node is remembered in the list's
+    scratch pointer, which must be reset by the caller.
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static herr_t
-H5S__hyper_add_span_element_helper(H5S_hyper_span_info_t *span_tree,
-    unsigned rank, const hsize_t *coords)
+static const H5S_hyper_idx_node_t *
+H5S__hyper_idx_fill(H5S_hyper_span_idx_t *idx, H5S_hyper_span_info_t *spans,
+    unsigned ndims)
 {
-    H5S_hyper_span_info_t *tspan_info;  /* Temporary pointer to span info */
-    H5S_hyper_span_info_t *prev_span_info;  /* Pointer to span info for level above current position */
-    H5S_hyper_span_t *tmp_span;         /* Temporary pointer to a span */
-    H5S_hyper_span_t *tmp2_span;        /* Another temporary pointer to a span */
-    H5S_hyper_span_t *new_span;         /* New span created for element */
-    herr_t ret_value = SUCCEED;         /* Return value */
-
-    FUNC_ENTER_STATIC
-
-    /* Sanity check */
-    HDassert(span_tree);
-    HDassert(rank > 0);
-    HDassert(coords);
-
-    /* Get pointer to last span in span tree */
-    tspan_info=span_tree;
-    if(span_tree->scratch)
-        tmp_span=(H5S_hyper_span_t *)span_tree->scratch;
-    else {
-        tmp_span=span_tree->head;
-        HDassert(tmp_span);
-        span_tree->scratch=(H5S_hyper_span_info_t *)tmp_span;
-    } /* end else */
-
-    /* Find last span tree which includes a portion of the coordinate */
-    prev_span_info=NULL;
-    while(coords[0]>=tmp_span->low && coords[0]<=tmp_span->high) {
-        /* Move rank & coordinate offset down a dimension */
-        rank--;
-        coords++;
-
-        /* Remember the span tree we are descending into */
-        prev_span_info=tspan_info;
-        tspan_info=tmp_span->down;
-
-        /* Get the last span in this span's 'down' tree */
-        if(tspan_info->scratch)
-            tmp_span=(H5S_hyper_span_t *)tspan_info->scratch;
-        else {
-            tmp_span=tspan_info->head;
-            HDassert(tmp_span);
-            tspan_info->scratch=(H5S_hyper_span_info_t *)tmp_span;
-        } /* end else */
-    } /* end while */
-
-    /* Check if we made it all the way to the bottom span in the tree */
-    if(rank>1) {
-        /* Before we create another span at this level in the tree, check if
-         * the last span's "down tree" was equal to any other spans in this
-         * list of spans in the span tree.
-         *
-         * If so, release last span information and make last span merge into
-         * previous span (if possible), or at least share their "down tree"
-         * information.
-         */
-        tmp2_span=tspan_info->head;
-        while(tmp2_span!=tmp_span) {
-            if(H5S__hyper_cmp_spans(tmp2_span->down,tmp_span->down)==TRUE) {
-                /* Check for merging into previous span */
-                if(tmp2_span->high+1==tmp_span->low) {
-                    /* Release last span created */
-                    H5S__hyper_free_span(tmp_span);
-
-                    /* Increase size of previous span */
-                    tmp2_span->high++;
-                    tmp2_span->nelem++;
-
-                    /* Reset the 'tmp_span' for the rest of this block's algorithm */
-                    tmp_span=tmp2_span;
-                } /* end if */
-                /* Span is disjoint, but has the same "down tree" selection */
-                else {
-                    /* Release "down tree" information */
-                    H5S__hyper_free_span_info(tmp_span->down);
-
-                    /* Point at earlier span's "down tree" */
-                    tmp_span->down=tmp2_span->down;
-
-                    /* Increment reference count on shared "down tree" */
-                    tmp_span->down->count++;
-                } /* end else */
-
-                /* Found span to merge into, break out now */
-                break;
-            } /* end if */
-
-            /* Advance to next span to check */
-            tmp2_span=tmp2_span->next;
-        } /* end while */
+    H5S_hyper_idx_node_t *node;     /* Index node for list */
+    H5S_hyper_span_t *span;         /* Current span */
+    size_t u;                       /* Local index variable */
+    unsigned v;                     /* Local index variable */
+    const H5S_hyper_idx_node_t *ret_value = NULL;   /* Return value */
 
-        /* Make span tree for current coordinates */
-        if(NULL == (new_span = H5S__hyper_coord_to_span(rank, coords)))
-            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate hyperslab span")
+    FUNC_ENTER_STATIC_NOERR
 
-        /* Add new span tree as span */
-        HDassert(tmp_span);
-        tmp_span->next=new_span;
+    HDassert(idx);
+    HDassert(spans);
+    HDassert(ndims > 0);
+
+    /* Check for a list already in the index */
+    if(spans->scratch != NULL)
+        HGOTO_DONE((const H5S_hyper_idx_node_t *)spans->scratch)
+
+    /* Set up the node, reserving the list's spans so they are contiguous */
+    node = &idx->nodes[idx->nnodes++];
+    node->first = idx->nspans;
+    node->nspans = 0;
+    for(span = spans->head; span != NULL; span = span->next)
+        node->nspans++;
+    idx->nspans += node->nspans;
+    node->bounds = &idx->bounds[idx->nbounds];
+    idx->nbounds += 2 * ndims;
+    for(v = 0; v < ndims; v++) {
+        node->bounds[2 * v] = HSIZET_MAX;
+        node->bounds[(2 * v) + 1] = 0;
+    } /* end for */
+    spans->scratch = (H5S_hyper_span_info_t *)node;
 
-        /* Make scratch pointer point to last span in list */
-        HDassert(tspan_info);
-        tspan_info->scratch=(H5S_hyper_span_info_t *)new_span;
+    /* Add the spans & the lists below them */
+    for(span = spans->head, u = node->first; span != NULL; span = span->next, u++) {
+        H5S_hyper_idx_span_t *idx_span = &idx->spans[u];
 
-        /* Set the proper 'pstride' for new span */
-        new_span->pstride=new_span->low-tmp_span->low;
-    } /* end if */
-    else {
-        /* Does new node adjoin existing node? */
-        if(tmp_span->high+1==coords[0]) {
-            tmp_span->high++;
-            tmp_span->nelem++;
+        idx_span->low = span->low;
+        idx_span->high = span->high;
+        node->bounds[0] = MIN(node->bounds[0], span->low);
+        node->bounds[1] = MAX(node->bounds[1], span->high);
+        if(span->down) {
+            idx_span->down = H5S__hyper_idx_fill(idx, span->down, ndims - 1);
+            for(v = 1; v < ndims; v++) {
+                node->bounds[2 * v] = MIN(node->bounds[2 * v], idx_span->down->bounds[2 * (v - 1)]);
+                node->bounds[(2 * v) + 1] = MAX(node->bounds[(2 * v) + 1], idx_span->down->bounds[(2 * (v - 1)) + 1]);
+            } /* end for */
+        } /* end if */
+        else
+            idx_span->down = NULL;
+    } /* end for */
 
-            /* Check if this span tree should now be merged with a level higher in the tree */
-            if(prev_span_info!=NULL) {
-                /* Before we create another span at this level in the tree, check if
-                 * the last span's "down tree" was equal to any other spans in this
-                 * list of spans in the span tree.
-                 *
-                 * If so, release last span information and make last span merge into
-                 * previous span (if possible), or at least share their "down tree"
-                 * information.
-                 */
-                tmp2_span=prev_span_info->head;
-                tmp_span=(H5S_hyper_span_t *)prev_span_info->scratch;
-                while(tmp2_span!=tmp_span) {
-                    if(H5S__hyper_cmp_spans(tmp2_span->down,tmp_span->down)==TRUE) {
-                        /* Check for merging into previous span */
-                        if(tmp2_span->high+1==tmp_span->low) {
-                            /* Release last span created */
-                            H5S__hyper_free_span(tmp_span);
+    ret_value = node;
 
-                            /* Increase size of previous span */
-                            tmp2_span->high++;
-                            tmp2_span->nelem++;
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_idx_fill() */
 
-                            /* Update pointers */
-                            tmp2_span->next=NULL;
-                            prev_span_info->scratch=(H5S_hyper_span_info_t *)tmp2_span;
-                        } /* end if */
-                        /* Span is disjoint, but has the same "down tree" selection */
-                        else {
-                            /* Release "down tree" information */
-                            H5S__hyper_free_span_info(tmp_span->down);
 
-                            /* Point at earlier span's "down tree" */
-                            tmp_span->down=tmp2_span->down;
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_idx_build
+ PURPOSE
+    Build the search index for a span tree
+ USAGE
+    H5S_hyper_span_idx_t *H5S__hyper_idx_build(spans, rank)
+        H5S_hyper_span_info_t *spans;   IN: Span tree to index
+        unsigned rank;                  IN: # of dimensions in the tree
+ RETURNS
+    Pointer to the index on success, NULL on failure
+ DESCRIPTION
+    Flatten the span tree into a single allocation holding the index
+    nodes, spans & bounds, and add it to the indices in H5S_hyper_idx_g.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    Uses the scratch pointers in the span tree, and resets them when done.
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static H5S_hyper_span_idx_t *
+H5S__hyper_idx_build(H5S_hyper_span_info_t *spans, unsigned rank)
+{
+    H5S_hyper_span_idx_t *idx = NULL;   /* New index */
+    size_t nnodes = 0, nspans = 0, nbounds = 0;     /* Sizes of the index arrays */
+    H5S_hyper_span_idx_t *ret_value = NULL;     /* Return value */
 
-                            /* Increment reference count on shared "down tree" */
-                            tmp_span->down->count++;
-                        } /* end else */
+    FUNC_ENTER_STATIC
 
-                        /* Found span to merge into, break out now */
-                        break;
-                    } /* end if */
+    HDassert(spans);
+    HDassert(spans->head);
+    HDassert(rank > 0 && rank <= H5S_MAX_RANK);
 
-                    /* Advance to next span to check */
-                    tmp2_span=tmp2_span->next;
-                } /* end while */
-            } /* end if */
-        } /* end if */
-        else {
-            if(NULL == (new_span = H5S__hyper_new_span(coords[0], coords[0], NULL, NULL)))
-                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate hyperslab span")
+    /* Size the index */
+    H5S__hyper_idx_count(spans, rank, &nnodes, &nspans, &nbounds);
+    H5S__hyper_span_scratch(spans);
 
-            /* Add new span tree as span */
-            HDassert(tmp_span);
-            tmp_span->next=new_span;
+    /* Allocate the index & its arrays together */
+    if(NULL == (idx = (H5S_hyper_span_idx_t *)H5MM_malloc(sizeof(H5S_hyper_span_idx_t) +
+            (nnodes * sizeof(H5S_hyper_idx_node_t)) + (nspans * sizeof(H5S_hyper_idx_span_t)) +
+            (nbounds * sizeof(hsize_t)))))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, NULL, "can't allocate hyperslab span index")
+    idx->key = (size_t)spans;
+    idx->rank = rank;
+    HDmemset(idx->offset, 0, sizeof(idx->offset));
+    idx->nodes = (H5S_hyper_idx_node_t *)(idx + 1);
+    idx->spans = (H5S_hyper_idx_span_t *)(idx->nodes + nnodes);
+    idx->bounds = (hsize_t *)(idx->spans + nspans);
+    idx->nnodes = idx->nspans = idx->nbounds = 0;
+
+    /* Fill the index */
+    H5S__hyper_idx_fill(idx, spans, rank);
+    H5S__hyper_span_scratch(spans);
+    HDassert(idx->nnodes == nnodes);
+    HDassert(idx->nspans == nspans);
+    HDassert(idx->nbounds == nbounds);
 
-            /* Make scratch pointer point to last span in list */
-            tspan_info->scratch=(H5S_hyper_span_info_t *)new_span;
+    /* Add it to the indices */
+    if(NULL == H5S_hyper_idx_g && NULL == (H5S_hyper_idx_g = H5SL_create(H5SL_TYPE_SIZE, NULL)))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTCREATE, NULL, "can't create hyperslab span index list")
+    if(H5SL_insert(H5S_hyper_idx_g, idx, &idx->key) < 0)
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, NULL, "can't insert hyperslab span index")
 
-            /* Set the proper 'pstride' for new span */
-            new_span->pstride = new_span->low - tmp_span->low;
-        } /* end else */
-    } /* end else */
+    ret_value = idx;
 
 done:
+    if(NULL == ret_value && idx)
+        idx = (H5S_hyper_span_idx_t *)H5MM_xfree(idx);
+
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__hyper_add_span_element_helper() */
+} /* end H5S__hyper_idx_build() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S_hyper_add_span_element
+    H5S__hyper_idx_get
  PURPOSE
-    Add a single element to a span tree
+    Find the search index for a span tree
  USAGE
-    herr_t H5S_hyper_add_span_element(space, span_tree, rank, coords)
-        H5S_t *space;           IN/OUT: Pointer to dataspace to add coordinate to
-        unsigned rank;          IN: Number of dimensions of coordinates
-        hsize_t *coords;       IN: Location of element to add to span tree
+    H5S_hyper_span_idx_t *H5S__hyper_idx_get(spans)
+        const H5S_hyper_span_info_t *spans;   IN: Root of span tree
  RETURNS
-    Non-negative on success, negative on failure
+    Pointer to the index, NULL if the tree has none
  DESCRIPTION
-    Add a single element to an existing span tree.
+    Look up the index of the tree rooted at spans in H5S_hyper_idx_g.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
-    Assumes that the element is not already in the dataspace's selection
+    Costs nothing while no tree has an index.
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-herr_t
-H5S_hyper_add_span_element(H5S_t *space, unsigned rank, const hsize_t *coords)
+static H5S_hyper_span_idx_t *
+H5S__hyper_idx_get(const H5S_hyper_span_info_t *spans)
 {
-    H5S_hyper_span_info_t *head = NULL;    /* Pointer to new head of span tree */
-    herr_t      ret_value = SUCCEED;       /* Return value */
+    H5S_hyper_span_idx_t *ret_value = NULL;     /* Return value */
 
-    FUNC_ENTER_NOAPI(FAIL)
+    FUNC_ENTER_STATIC_NOERR
 
-    HDassert(space);
-    HDassert(rank > 0);
-    HDassert(coords);
-    HDassert(space->extent.rank == rank);
+    HDassert(spans);
 
-    /* Check if this is the first element in the selection */
-    if(NULL == space->select.sel_info.hslab) {
-        /* Allocate a span info node */
-        if(NULL == (head = H5FL_CALLOC(H5S_hyper_span_info_t)))
-            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, FAIL, "can't allocate hyperslab span info")
+    if(H5S_hyper_idx_g) {
+        size_t key = (size_t)spans;     /* Key of the tree's index */
 
-        /* Set the reference count */
-        head->count = 1;
+        ret_value = (H5S_hyper_span_idx_t *)H5SL_search(H5S_hyper_idx_g, &key);
+    } /* end if */
 
-        /* Build span tree for this coordinate */
-        if(NULL == (head->head = H5S__hyper_coord_to_span(rank, coords)))
-            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, FAIL, "can't allocate hyperslab spans for coordinate")
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_idx_get() */
 
-        /* Allocate selection info */
-        if(NULL == (space->select.sel_info.hslab = H5FL_MALLOC(H5S_hyper_sel_t)))
-            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTALLOC, FAIL, "can't allocate hyperslab selection")
 
-        /* Set the selection to the new span tree */
-        space->select.sel_info.hslab->span_lst = head;
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_idx_free
+ PURPOSE
+    Release the search index for a span tree
+ USAGE
+    void H5S__hyper_idx_free(spans)
+        H5S_hyper_span_info_t *spans;   IN/OUT: Root of span tree
+ RETURNS
+    None
+ DESCRIPTION
+    Release the index of the tree rooted at spans, if it has one.  Must be
+    called whenever the tree is changed in place (except when it's only
+    moved, see H5S__hyper_idx_move()) or released.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    Closes H5S_hyper_idx_g with the last index.
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static void
+H5S__hyper_idx_free(H5S_hyper_span_info_t *spans)
+{
+    FUNC_ENTER_STATIC_NOERR
 
-        /* Set selection type */
-        space->select.type = H5S_sel_hyper;
+    HDassert(spans);
 
-        /* Reset "regular" hyperslab flag */
-        space->select.sel_info.hslab->diminfo_valid = FALSE;
+    if(H5S_hyper_idx_g) {
+        size_t key = (size_t)spans;     /* Key of the tree's index */
+        H5S_hyper_span_idx_t *idx;      /* Index of the tree */
 
-        /* Set unlim_dim */
-        space->select.sel_info.hslab->unlim_dim = -1;
+        if(NULL != (idx = (H5S_hyper_span_idx_t *)H5SL_remove(H5S_hyper_idx_g, &key))) {
+            idx = (H5S_hyper_span_idx_t *)H5MM_xfree(idx);
 
-        /* Set # of elements in selection */
-        space->select.num_elem = 1;
+            if(0 == H5SL_count(H5S_hyper_idx_g)) {
+                (void)H5SL_close(H5S_hyper_idx_g);
+                H5S_hyper_idx_g = NULL;
+            } /* end if */
+        } /* end if */
     } /* end if */
-    else {
-        if(H5S__hyper_add_span_element_helper(space->select.sel_info.hslab->span_lst, rank, coords) < 0)
-            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, FAIL, "can't insert coordinate into span tree")
 
-        /* Increment # of elements in selection */
-        space->select.num_elem++;
-    } /* end else */
-
-done:
-    if(ret_value < 0)
-        if(head)
-            H5S__hyper_free_span_info(head);
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5S__hyper_idx_free() */
 
-    FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S_hyper_add_span_element() */
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S_hyper_reset_scratch
+    H5S__hyper_idx_move
  PURPOSE
-    Reset the scratch information for span tree
+    Move the search index for a span tree along with the tree
  USAGE
-    herr_t H5S_hyper_reset_scratch(space)
-        H5S_t *space;           IN/OUT: Pointer to dataspace to reset scratch pointers
+    void H5S__hyper_idx_move(spans, rank, offset)
+        H5S_hyper_span_info_t *spans;   IN: Root of span tree
+        unsigned rank;                  IN: # of dimensions in the tree
+        const hssize_t *offset;         IN: Offset subtracted from the tree's coordinates
  RETURNS
-    Non-negative on success, negative on failure
+    None
  DESCRIPTION
-    Resets the "scratch" pointers used for various tasks in computing hyperslab
-    spans.
+    Add offset to the offset of the index of the tree rooted at spans, if
+    it has one, so it stays valid without being rebuilt when the tree is
+    moved.  Queries apply the offset to their blocks (see
+    H5S__hyper_idx_block()).
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-herr_t
-H5S_hyper_reset_scratch(H5S_t *space)
+static void
+H5S__hyper_idx_move(H5S_hyper_span_info_t *spans, unsigned rank,
+    const hssize_t *offset)
 {
-    herr_t      ret_value = SUCCEED;       /* Return value */
+    H5S_hyper_span_idx_t *idx;          /* Index of the tree */
 
-    FUNC_ENTER_NOAPI(FAIL)
+    FUNC_ENTER_STATIC_NOERR
 
-    HDassert(space);
+    HDassert(spans);
+    HDassert(offset);
 
-    /* Check if there are spans in the span tree */
-    if(space->select.sel_info.hslab->span_lst != NULL)
-        /* Reset the scratch pointers for the next routine which needs them */
-        H5S__hyper_span_scratch(space->select.sel_info.hslab->span_lst);
+    if(NULL != (idx = H5S__hyper_idx_get(spans))) {
+        unsigned u;                     /* Local index variable */
+
+        HDassert(idx->rank == rank);
+        for(u = 0; u < rank; u++)
+            idx->offset[u] += offset[u];
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5S__hyper_idx_move() */
 
-done:
-    FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S_hyper_reset_scratch() */
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S_hyper_convert
+    H5S__hyper_idx_block
  PURPOSE
-    Convert a compatible selection to span tree form
+    Convert a block to the coordinates of a span tree search index
  USAGE
-    herr_t H5S_hyper_convert(space)
-        H5S_t *space;           IN/OUT: Pointer to dataspace to convert
+    hbool_t H5S__hyper_idx_block(idx, start, end, idx_start, idx_end)
+        const H5S_hyper_span_idx_t *idx;    IN: Index to query
+        const hsize_t *start;   IN: Starting coordinate for block
+        const hsize_t *end;     IN: Ending coordinate for block
+        hsize_t *idx_start;     OUT: Starting coordinate in the index
+        hsize_t *idx_end;       OUT: Ending coordinate in the index
  RETURNS
-    Non-negative on success, negative on failure
+    FALSE if the block is entirely outside the coordinates of the index
+    (so can't intersect the tree), TRUE otherwise
  DESCRIPTION
-    Converts a compatible selection (currently only "all" selections) to the
-    span-tree form of a hyperslab selection. (Point and "none" selection aren't
-    currently supported and hyperslab selection always have the span-tree form
-    available).
+    Add the offset the tree has been moved by since it was indexed to the
+    block, clipping it at 0.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-herr_t
-H5S_hyper_convert(H5S_t *space)
+static hbool_t
+H5S__hyper_idx_block(const H5S_hyper_span_idx_t *idx, const hsize_t *start,
+    const hsize_t *end, hsize_t *idx_start, hsize_t *idx_end)
 {
-    herr_t      ret_value = SUCCEED;       /* Return value */
-
-    FUNC_ENTER_NOAPI(FAIL)
-
-    HDassert(space);
-
-    /* Check the type of selection */
-    switch(H5S_GET_SELECT_TYPE(space)) {
-        case H5S_SEL_ALL:    /* All elements selected in dataspace */
-            /* Convert current "all" selection to "real" hyperslab selection */
-            {
-                const hsize_t *tmp_start;       /* Temporary start information */
-                const hsize_t *tmp_stride;      /* Temporary stride information */
-                const hsize_t *tmp_count;       /* Temporary count information */
-                const hsize_t *tmp_block;       /* Temporary block information */
+    unsigned u;                         /* Local index variable */
+    hbool_t ret_value = TRUE;           /* Return value */
 
-                /* Set up temporary information for the dimensions */
-                tmp_start = H5S_hyper_zeros_g;
-                tmp_stride = tmp_count = H5S_hyper_ones_g;
-                tmp_block = space->extent.size;
+    FUNC_ENTER_STATIC_NOERR
 
-                /* Convert to hyperslab selection */
-                if(H5S_select_hyperslab(space,H5S_SELECT_SET,tmp_start,tmp_stride,tmp_count,tmp_block)<0)
-                    HGOTO_ERROR(H5E_DATASPACE, H5E_CANTSET, FAIL, "can't convert selection")
-            } /* end case */
-            break;
+    HDassert(idx);
+    HDassert(start);
+    HDassert(end);
+    HDassert(idx_start);
+    HDassert(idx_end);
 
-        case H5S_SEL_HYPERSLABS:        /* Hyperslab selection */
-            break;
+    for(u = 0; u < idx->rank; u++) {
+        hssize_t offset = idx->offset[u];  /* Offset of the tree in this dimension */
 
-        case H5S_SEL_NONE:   /* No elements selected in dataspace */
-        case H5S_SEL_POINTS: /* Point selection */
-        case H5S_SEL_ERROR:  /* Selection error */
-        case H5S_SEL_N:      /* Selection count */
-        default:
-            HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, FAIL, "can't convert to span tree selection")
-    } /* end switch */
+        if(offset >= 0) {
+            idx_start[u] = start[u] + (hsize_t)offset;
+            idx_end[u] = end[u] + (hsize_t)offset;
+        } /* end if */
+        else {
+            if(end[u] < (hsize_t)(-offset))
+                HGOTO_DONE(FALSE)
+            idx_start[u] = (start[u] < (hsize_t)(-offset)) ? 0 : start[u] - (hsize_t)(-offset);
+            idx_end[u] = end[u] - (hsize_t)(-offset);
+        } /* end else */
+    } /* end for */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S_hyper_convert() */
+} /* end H5S__hyper_idx_block() */
+
 
-#ifdef LATER
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S_hyper_intersect_helper
+    H5S__hyper_idx_intersect
  PURPOSE
-    Helper routine to detect intersections in span trees
+    Detect intersections between a block and a span tree search index
  USAGE
-    htri_t H5S_hyper_intersect_helper(spans1, spans2)
-        H5S_hyper_span_info_t *spans1;     IN: First span tree to operate with
-        H5S_hyper_span_info_t *spans2;     IN: Second span tree to operate with
+    hbool_t H5S__hyper_idx_intersect(idx_spans, node, ndims, start, end)
+        const H5S_hyper_idx_span_t *idx_spans;  IN: Spans of the index
+        const H5S_hyper_idx_node_t *node;       IN: List of spans to check
+        unsigned ndims;     IN: # of dimensions from the list down
+        hsize_t *start;     IN: Starting coordinate for block
+        hsize_t *end;       IN: Ending coordinate for block
  RETURNS
-    Non-negative on success, negative on failure
+    TRUE/FALSE
  DESCRIPTION
-    Quickly detect intersections between two span trees
+    Same as H5S__hyper_intersect_block_helper(), but rejects lists whose
+    bounding box is outside the block and finds the first span which can
+    overlap the block with a binary search.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-static htri_t
-H5S_hyper_intersect_helper (H5S_hyper_span_info_t *spans1, H5S_hyper_span_info_t *spans2)
+static hbool_t
+H5S__hyper_idx_intersect(const H5S_hyper_idx_span_t *idx_spans,
+    const H5S_hyper_idx_node_t *node, unsigned ndims,
+    const hsize_t *start, const hsize_t *end)
 {
-    H5S_hyper_span_t *curr1;    /* Pointer to current span in 1st span tree */
-    H5S_hyper_span_t *curr2;    /* Pointer to current span in 2nd span tree */
-    htri_t status;              /* Status from recursive call */
-    htri_t ret_value=FALSE;     /* Return value */
-
-    FUNC_ENTER_NOAPI_NOINIT
+    const H5S_hyper_idx_span_t *span;   /* Current span */
+    const H5S_hyper_idx_span_t *last_span;  /* End of list */
+    size_t lo, hi;                      /* Binary search bounds */
+    unsigned u;                         /* Local index variable */
+    hbool_t ret_value = FALSE;          /* Return value */
 
-    /* Sanity check */
-    HDassert((spans1 && spans2) || (spans1 == NULL && spans2 == NULL));
-
-    /* "NULL" span trees compare as overlapping */
-    if(spans1==NULL && spans2==NULL)
-        HGOTO_DONE(TRUE);
+    FUNC_ENTER_STATIC_NOERR
 
-    /* Get the span lists for each span in this tree */
-    curr1=spans1->head;
-    curr2=spans2->head;
+    HDassert(idx_spans);
+    HDassert(node);
+    HDassert(ndims > 0);
 
-    /* Iterate over the spans in each tree */
-    while(curr1!=NULL && curr2!=NULL) {
-        /* Check for 1st span entirely before 2nd span */
-        if(curr1->high<curr2->low)
-            curr1=curr1->next;
-        /* Check for 2nd span entirely before 1st span */
-        else if(curr2->high<curr1->low)
-            curr2=curr2->next;
-        /* Spans must overlap */
-        else {
-            /* Recursively check spans in next dimension down */
-            if((status=H5S_hyper_intersect_helper(curr1->down,curr2->down))<0)
-                HGOTO_ERROR(H5E_DATASPACE, H5E_BADSELECT, FAIL, "can't perform hyperslab intersection check")
+    /* Check the bounding box of the list */
+    for(u = 0; u < ndims; u++)
+        if(node->bounds[(2 * u) + 1] < start[u] || node->bounds[2 * u] > end[u])
+            HGOTO_DONE(FALSE)
 
-            /* If there is a span intersection in the down dimensions, the span trees overlap */
-            if(status==TRUE)
-                HGOTO_DONE(TRUE);
+    /* Find the first span not entirely before the block */
+    lo = node->first;
+    hi = node->first + node->nspans;
+    while(lo < hi) {
+        size_t mid = lo + ((hi - lo) / 2);
 
-            /* No intersection in down dimensions, advance to next span */
-            if(curr1->high<curr2->high)
-                curr1=curr1->next;
-            else
-                curr2=curr2->next;
-        } /* end else */
+        if(idx_spans[mid].high < start[0])
+            lo = mid + 1;
+        else
+            hi = mid;
     } /* end while */
 
+    /* Check spans until one is past the end of the block */
+    last_span = &idx_spans[node->first + node->nspans];
+    for(span = &idx_spans[lo]; span < last_span && span->low <= end[0]; span++)
+        if(span->down == NULL || H5S__hyper_idx_intersect(idx_spans, span->down, ndims - 1, start + 1, end + 1))
+            HGOTO_DONE(TRUE)
+
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-}   /* H5S_hyper_intersect_helper() */
+} /* end H5S__hyper_idx_intersect() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
-    H5S_hyper_intersect
+    H5S__hyper_idx_and_block
  PURPOSE
-    Detect intersections in span trees
+    Check how a single block overlaps a span tree, with the tree's index
  USAGE
-    htri_t H5S_hyper_intersect(space1, space2)
-        H5S_t *space1;     IN: First dataspace to operate on span tree
-        H5S_t *space2;     IN: Second dataspace to operate on span tree
+    H5S_hyper_idx_overlap_t H5S__hyper_idx_and_block(spans, block_spans)
+        H5S_hyper_span_info_t *spans;   IN: Root of span tree
+        const H5S_hyper_span_info_t *block_spans;   IN: Span tree to AND with it
  RETURNS
-    Non-negative on success, negative on failure
+    H5S_HYPER_IDX_DISJOINT if block_spans is a single block which misses
+    the tree, H5S_HYPER_IDX_INSIDE if it's a single block holding the
+    tree's bounding box, H5S_HYPER_IDX_PARTIAL otherwise (including when
+    the tree has no index, or block_spans isn't a single block)
  DESCRIPTION
-    Quickly detect intersections between two span trees
+    Lets an AND of a tree with a block (e.g. a selection with each chunk
+    of a dataset) skip clipping the tree when the index settles the result:
+    empty for a disjoint block, the whole tree for a block holding it.
  GLOBAL VARIABLES
  COMMENTS, BUGS, ASSUMPTIONS
  EXAMPLES
  REVISION LOG
 --------------------------------------------------------------------------*/
-htri_t
-H5S_hyper_intersect (H5S_t *space1, H5S_t *space2)
+static H5S_hyper_idx_overlap_t
+H5S__hyper_idx_and_block(H5S_hyper_span_info_t *spans,
+    const H5S_hyper_span_info_t *block_spans)
 {
-    htri_t ret_value=FAIL;      /* Return value */
-
-    FUNC_ENTER_NOAPI_NOINIT
-
-    /* Sanity check */
-    HDassert(space1);
-    HDassert(space2);
+    const H5S_hyper_span_idx_t *idx;    /* Index of the tree */
+    hsize_t start[H5O_LAYOUT_NDIMS];    /* Starting coordinate for block */
+    hsize_t end[H5O_LAYOUT_NDIMS];      /* Ending coordinate for block */
+    hsize_t idx_start[H5O_LAYOUT_NDIMS];    /* Starting coordinate for block, in the index */
+    hsize_t idx_end[H5O_LAYOUT_NDIMS];  /* Ending coordinate for block, in the index */
+    const hsize_t *bounds;              /* Bounding box of the tree */
+    unsigned u;                         /* Local index variable */
+    H5S_hyper_idx_overlap_t ret_value = H5S_HYPER_IDX_PARTIAL;  /* Return value */
 
-    /* Check that the space selections both have span trees */
-    if(space1->select.sel_info.hslab->span_lst==NULL ||
-            space2->select.sel_info.hslab->span_lst==NULL)
-        HGOTO_ERROR(H5E_DATASPACE, H5E_UNINITIALIZED, FAIL, "dataspace does not have span tree")
+    FUNC_ENTER_STATIC_NOERR
 
-    /* Check that the dataspaces are both the same rank */
-    if(space1->extent.rank!=space2->extent.rank)
-        HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "dataspace ranks don't match")
+    HDassert(spans);
+    HDassert(block_spans);
 
-    /* Perform the span-by-span intersection check */
-    if((ret_value=H5S_hyper_intersect_helper(space1->select.sel_info.hslab->span_lst,space2->select.sel_info.hslab->span_lst))<0)
-        HGOTO_ERROR(H5E_DATASPACE, H5E_BADSELECT, FAIL, "can't perform hyperslab intersection check")
+    /* Only trees indexed already, since building an index for one block
+     * costs more than clipping
+     */
+    if(NULL == (idx = H5S__hyper_idx_get(spans)))
+        HGOTO_DONE(H5S_HYPER_IDX_PARTIAL)
+
+    /* Get the block, if the other tree is one */
+    for(u = 0; u < idx->rank; u++) {
+        if(NULL == block_spans || NULL == block_spans->head || block_spans->head->next)
+            HGOTO_DONE(H5S_HYPER_IDX_PARTIAL)
+        start[u] = block_spans->head->low;
+        end[u] = block_spans->head->high;
+        block_spans = block_spans->head->down;
+    } /* end for */
+    if(block_spans)
+        HGOTO_DONE(H5S_HYPER_IDX_PARTIAL)
+
+    /* Check the block against the index */
+    if(!H5S__hyper_idx_block(idx, start, end, idx_start, idx_end))
+        HGOTO_DONE(H5S_HYPER_IDX_DISJOINT)
+    if(!H5S__hyper_idx_intersect(idx->spans, &idx->nodes[0], idx->rank, idx_start, idx_end))
+        HGOTO_DONE(H5S_HYPER_IDX_DISJOINT)
+    bounds = idx->nodes[0].bounds;
+    for(u = 0; u < idx->rank; u++)
+        if(bounds[2 * u] < idx_start[u] || bounds[(2 * u) + 1] > idx_end[u])
+            HGOTO_DONE(H5S_HYPER_IDX_PARTIAL)
+    ret_value = H5S_HYPER_IDX_INSIDE;
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-}   /* H5S_hyper_intersect() */
-#endif /* LATER */
+} /* end H5S__hyper_idx_and_block() */
+
 
-
 /*--------------------------------------------------------------------------
  NAME
     H5S__hyper_intersect_block_helper
@@ -4108,6 +5461,10 @@ done:
 htri_t
 H5S_hyper_intersect_block(H5S_t *space, const hsize_t *start, const hsize_t *end)
 {
+    H5S_hyper_span_info_t *spans;   /* Span tree for selection */
+    H5S_hyper_span_idx_t *idx;      /* Search index for span tree */
+    hsize_t idx_start[H5O_LAYOUT_NDIMS];    /* Starting coordinate for block, in the index */
+    hsize_t idx_end[H5O_LAYOUT_NDIMS];  /* Ending coordinate for block, in the index */
     htri_t ret_value = FAIL;    /* Return value */
 
     FUNC_ENTER_NOAPI(FAIL)
@@ -4127,8 +5484,25 @@ H5S_hyper_intersect_block(H5S_t *space, const hsize_t *start, const hsize_t *end
         if(H5S__hyper_generate_spans(space) < 0)
             HGOTO_ERROR(H5E_DATASPACE, H5E_UNINITIALIZED, FAIL, "dataspace does not have span tree")
 
-    /* Perform the span-by-span intersection check */
-    ret_value = H5S__hyper_intersect_block_helper(space->select.sel_info.hslab->span_lst, start, end);
+    spans = space->select.sel_info.hslab->span_lst;
+
+    /* Index the span tree on first use, since the same selection is usually
+     * checked against many blocks (e.g. every chunk of a dataset)
+     */
+    if(NULL == (idx = H5S__hyper_idx_get(spans)) && spans->head)
+        if(NULL == (idx = H5S__hyper_idx_build(spans, space->extent.rank)))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTCREATE, FAIL, "can't build span tree index")
+
+    if(idx) {
+        /* Perform the indexed intersection check, where the tree was when indexed */
+        if(H5S__hyper_idx_block(idx, start, end, idx_start, idx_end))
+            ret_value = H5S__hyper_idx_intersect(idx->spans, &idx->nodes[0], idx->rank, idx_start, idx_end);
+        else
+            ret_value = FALSE;
+    } /* end if */
+    else
+        /* Perform the span-by-span intersection check */
+        ret_value = H5S__hyper_intersect_block_helper(spans, start, end);
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -4236,6 +5610,16 @@ H5S__hyper_adjust_u(H5S_t *space, const hsize_t *offset)
 
         /* Reset the scratch pointers for the next routine which needs them */
         H5S__hyper_span_scratch(space->select.sel_info.hslab->span_lst);
+
+        /* Move any search index along with the spans */
+        if(H5S_hyper_idx_g) {
+            hssize_t s_offset[H5O_LAYOUT_NDIMS];    /* Signed offset */
+            unsigned u;                         /* Local index variable */
+
+            for(u = 0; u < space->extent.rank; u++)
+                s_offset[u] = (hssize_t)offset[u];
+            H5S__hyper_idx_move(space->select.sel_info.hslab->span_lst, space->extent.rank, s_offset);
+        } /* end if */
     } /* end if */
 
     FUNC_LEAVE_NOAPI_VOID
@@ -4709,6 +6093,9 @@ H5S_hyper_adjust_s(H5S_t *space, const hssize_t *offset)
 
         /* Reset the scratch pointers for the next routine which needs them */
         H5S__hyper_span_scratch(space->select.sel_info.hslab->span_lst);
+
+        /* Move any search index along with the spans */
+        H5S__hyper_idx_move(space->select.sel_info.hslab->span_lst, space->extent.rank, offset);
     } /* end if */
 
 done:
@@ -4876,6 +6263,10 @@ H5S__hyper_append_span(H5S_hyper_span_t **prev_span,
     } /* end if */
     /* Merge or append to existing merged spans list */
     else {
+        /* The list changes, so any search index is stale */
+        if(*span_tree)
+            H5S__hyper_idx_free(*span_tree);
+
         /* Check if span can just extend the previous merged span */
         if((((*prev_span)->high + 1) == low) &&
                 H5S__hyper_cmp_spans(down, (*prev_span)->down)==TRUE) {
@@ -6252,18 +7643,60 @@ done:
  * Programmer:	Quincey Koziol (split from HS_select_hyperslab()).
  *              Tuesday, September 12, 2000
  *
- * Modifications:
+ * Modifications:
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5S__generate_hyperslab (H5S_t *space, H5S_seloper_t op,
+		      const hsize_t start[],
+		      const hsize_t stride[],
+		      const hsize_t count[],
+		      const hsize_t block[])
+{
+    H5S_hyper_span_info_t *new_spans;   /* Span tree for new hyperslab */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Check args */
+    HDassert(space);
+    HDassert(op > H5S_SELECT_NOOP && op < H5S_SELECT_INVALID);
+    HDassert(start);
+    HDassert(stride);
+    HDassert(count);
+    HDassert(block);
+
+    /* Generate span tree for new hyperslab information */
+    if(NULL == (new_spans = H5S__hyper_make_spans(space->extent.rank, start, stride, count, block)))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, FAIL, "can't create hyperslab information")
+
+    /* Combine it with the current selection (releases the new spans) */
+    if(H5S__generate_hyperslab_spans(space, op, new_spans) < 0)
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, FAIL, "can't generate hyperslabs")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__generate_hyperslab() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5S__generate_hyperslab_spans
+ *
+ * Purpose:	Combine a span tree with the current selection, for
+ *              H5S__generate_hyperslab() and H5S_select_hyperslabs()
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ * Note:	NEW_SPANS is always taken over (and released if not kept),
+ *              even on failure.
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-H5S__generate_hyperslab (H5S_t *space, H5S_seloper_t op,
-		      const hsize_t start[],
-		      const hsize_t stride[],
-		      const hsize_t count[],
-		      const hsize_t block[])
+H5S__generate_hyperslab_spans(H5S_t *space, H5S_seloper_t op,
+    H5S_hyper_span_info_t *new_spans)
 {
-    H5S_hyper_span_info_t *new_spans=NULL;  /* Span tree for new hyperslab */
     H5S_hyper_span_info_t *a_not_b = NULL;      /* Span tree for hyperslab spans in old span tree and not in new span tree */
     H5S_hyper_span_info_t *a_and_b = NULL;      /* Span tree for hyperslab spans in both old and new span trees */
     H5S_hyper_span_info_t *b_not_a = NULL;      /* Span tree for hyperslab spans in new span tree and not in old span tree */
@@ -6274,14 +7707,7 @@ H5S__generate_hyperslab (H5S_t *space, H5S_seloper_t op,
     /* Check args */
     HDassert(space);
     HDassert(op > H5S_SELECT_NOOP && op < H5S_SELECT_INVALID);
-    HDassert(start);
-    HDassert(stride);
-    HDassert(count);
-    HDassert(block);
-
-    /* Generate span tree for new hyperslab information */
-    if(NULL == (new_spans = H5S__hyper_make_spans(space->extent.rank, start, stride, count, block)))
-        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, FAIL, "can't create hyperslab information")
+    HDassert(new_spans);
 
     /* Generate list of blocks to add/remove based on selection operation */
     if(op==H5S_SELECT_SET) {
@@ -6297,10 +7723,39 @@ H5S__generate_hyperslab (H5S_t *space, H5S_seloper_t op,
     } /* end if */
     else {
         hbool_t updated_spans = FALSE;  /* Whether the spans in the selection were modified */
+        H5S_hyper_idx_overlap_t overlap = H5S_HYPER_IDX_PARTIAL;   /* How a single new block overlaps the selection */
 
-        /* Generate lists of spans which overlap and don't overlap */
-        if(H5S__hyper_clip_spans(space->select.sel_info.hslab->span_lst,new_spans,&a_not_b,&a_and_b,&b_not_a)<0)
-            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTCLIP, FAIL, "can't clip hyperslab information")
+        /* Check an AND with a single block against the selection's search
+         * index, if it has one, which can settle the result without clipping
+         */
+        if(op == H5S_SELECT_AND)
+            overlap = H5S__hyper_idx_and_block(space->select.sel_info.hslab->span_lst, new_spans);
+
+        if(overlap == H5S_HYPER_IDX_INSIDE) {
+            H5S_hyper_span_info_t *spans = space->select.sel_info.hslab->span_lst;
+
+            /* The selection is unchanged, but give it its own tree if the
+             * tree is shared, as clipping would have, so the selection
+             * can be changed in place (e.g. moved to a chunk's origin)
+             */
+            if(spans->count > 1) {
+                if(NULL == (space->select.sel_info.hslab->span_lst = H5S__hyper_copy_span(spans))) {
+                    space->select.sel_info.hslab->span_lst = spans;
+                    HGOTO_ERROR(H5E_DATASPACE, H5E_CANTCOPY, FAIL, "can't copy hyperslab span tree")
+                } /* end if */
+                if(H5S__hyper_free_span_info(spans) < 0)
+                    HGOTO_ERROR(H5E_INTERNAL, H5E_CANTFREE, FAIL, "failed to release hyperslab spans")
+            } /* end if */
+
+            HGOTO_DONE(SUCCEED)
+        } /* end if */
+
+        /* Generate lists of spans which overlap and don't overlap (a block
+         * disjoint from the selection overlaps nothing)
+         */
+        if(overlap == H5S_HYPER_IDX_PARTIAL)
+            if(H5S__hyper_clip_spans(space->select.sel_info.hslab->span_lst,new_spans,&a_not_b,&a_and_b,&b_not_a)<0)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTCLIP, FAIL, "can't clip hyperslab information")
 
         switch(op) {
             case H5S_SELECT_OR:
@@ -6483,7 +7938,7 @@ done:
             HDONE_ERROR(H5E_INTERNAL, H5E_CANTFREE, FAIL, "failed to release temporary hyperslab spans")
 
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S__generate_hyperslab() */
+} /* end H5S__generate_hyperslab_spans() */
 
 
 /*-------------------------------------------------------------------------
@@ -6830,7 +8285,400 @@ H5S_select_hyperslab(H5S_t *space, H5S_seloper_t op, const hsize_t start[],
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5S_select_hyperslab() */
+} /* end H5S_select_hyperslab() */
+
+/*-------------------------------------------------------------------------
+ * Function:	H5S__hyper_batch_cmp
+ *
+ * Purpose:	Compare the starts of two hyperslabs of a batch, for qsort()
+ *
+ * Return:	<0, 0, >0 as the first hyperslab starts before, at or after
+ *              the second (ties broken by position in the batch)
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5S__hyper_batch_cmp(const void *_slab1, const void *_slab2)
+{
+    const H5S_hyper_batch_slab_t *slab1 = (const H5S_hyper_batch_slab_t *)_slab1;
+    const H5S_hyper_batch_slab_t *slab2 = (const H5S_hyper_batch_slab_t *)_slab2;
+    unsigned u;                         /* Local index variable */
+    int ret_value = 0;                  /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(u = 0; u < slab1->rank && 0 == ret_value; u++)
+        if(slab1->start[u] != slab2->start[u])
+            ret_value = (slab1->start[u] < slab2->start[u]) ? -1 : 1;
+    if(0 == ret_value && slab1->idx != slab2->idx)
+        ret_value = (slab1->idx < slab2->idx) ? -1 : 1;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_batch_cmp() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5S__hyper_union_spans
+ *
+ * Purpose:	Build the span tree for the union of a batch of hyperslabs.
+ *
+ *              START, STRIDE, COUNT and BLOCK hold RANK values for each of
+ *              the NSLABS hyperslabs, one after another.  STRIDE and BLOCK
+ *              may be NULL, for all '1's.  Hyperslabs with no elements are
+ *              skipped; the caller must make sure at least one remains.
+ *
+ *              The hyperslabs are sorted by their start, turned into one
+ *              span tree each, and neighbouring trees are then merged in
+ *              pairs, doubling the distance between them on each pass,
+ *              until one tree remains.  Merging trees of similar size this
+ *              way keeps the total work near O(N log N) spans, where
+ *              adding the hyperslabs to the selection one at a time costs
+ *              O(N^2), and the sort keeps each pair close together in the
+ *              dataspace so the merged trees stay small.
+ *
+ *              The merges of a pass are independent of each other, but
+ *              they run one after another: the span trees come from the
+ *              library's free lists, which aren't safe to use from more
+ *              than one thread.
+ *
+ * Return:	Pointer to new span tree on success, NULL on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5S_hyper_span_info_t *
+H5S__hyper_union_spans(unsigned rank, size_t nslabs, const hsize_t start[],
+    const hsize_t stride[], const hsize_t count[], const hsize_t block[])
+{
+    H5S_hyper_batch_slab_t *order = NULL;   /* Hyperslabs, in order of their start */
+    H5S_hyper_span_info_t **trees = NULL;   /* Span trees being merged */
+    size_t ntrees = 0;                  /* # of span trees */
+    size_t width;                       /* Distance between trees merged */
+    size_t u;                           /* Local index variable */
+    unsigned v;                         /* Local index variable */
+    H5S_hyper_span_info_t *ret_value = NULL;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Check args */
+    HDassert(rank > 0 && rank <= H5S_MAX_RANK);
+    HDassert(nslabs > 0);
+    HDassert(start);
+    HDassert(count);
+
+    if(NULL == (order = (H5S_hyper_batch_slab_t *)H5MM_malloc(nslabs * sizeof(H5S_hyper_batch_slab_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "can't allocate hyperslab order")
+    if(NULL == (trees = (H5S_hyper_span_info_t **)H5MM_malloc(nslabs * sizeof(H5S_hyper_span_info_t *))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "can't allocate span tree list")
+
+    /* Sort the hyperslabs which select anything by their start */
+    for(u = 0; u < nslabs; u++) {
+        for(v = 0; v < rank; v++)
+            if(0 == count[(u * rank) + v] || (block && 0 == block[(u * rank) + v]))
+                break;
+        if(v == rank) {
+            order[ntrees].rank = rank;
+            order[ntrees].start = &start[u * rank];
+            order[ntrees].idx = u;
+            ntrees++;
+        } /* end if */
+    } /* end for */
+    HDassert(ntrees > 0);
+    HDqsort(order, ntrees, sizeof(H5S_hyper_batch_slab_t), H5S__hyper_batch_cmp);
+
+    /* Generate a span tree for each hyperslab */
+    for(u = 0; u < ntrees; u++) {
+        hsize_t opt_stride[H5S_MAX_RANK];   /* Optimized stride information */
+        hsize_t opt_count[H5S_MAX_RANK];    /* Optimized count information */
+        hsize_t opt_block[H5S_MAX_RANK];    /* Optimized block information */
+        size_t off = order[u].idx * rank;   /* Offset of the hyperslab's values */
+
+        /* Merge contiguous blocks, as H5S_select_hyperslab() does */
+        for(v = 0; v < rank; v++) {
+            hsize_t s = stride ? stride[off + v] : 1;
+            hsize_t b = block ? block[off + v] : 1;
+
+            if(s == b) {
+                opt_stride[v] = 1;
+                opt_count[v] = 1;
+                opt_block[v] = b * count[off + v];
+            } /* end if */
+            else {
+                opt_stride[v] = (count[off + v] == 1) ? 1 : s;
+                opt_count[v] = count[off + v];
+                opt_block[v] = b;
+            } /* end else */
+        } /* end for */
+
+        if(NULL == (trees[u] = H5S__hyper_make_spans(rank, order[u].start, opt_stride, opt_count, opt_block)))
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, NULL, "can't create hyperslab information")
+    } /* end for */
+
+    /* Merge neighbouring trees in pairs, until one is left */
+    for(width = 1; width < ntrees; width *= 2)
+        for(u = 0; (u + width) < ntrees; u += 2 * width) {
+            H5S_hyper_span_info_t *merged;  /* Union of the pair */
+
+            if(NULL == (merged = H5S__hyper_merge_spans_helper(trees[u], trees[u + width])))
+                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTMERGE, NULL, "can't merge hyperslab spans")
+            if(H5S__hyper_free_span_info(trees[u]) < 0 || H5S__hyper_free_span_info(trees[u + width]) < 0) {
+                trees[u] = trees[u + width] = NULL;
+                H5S__hyper_free_span_info(merged);
+                HGOTO_ERROR(H5E_DATASPACE, H5E_CANTFREE, NULL, "can't release hyperslab spans")
+            } /* end if */
+            trees[u] = merged;
+            trees[u + width] = NULL;
+        } /* end for */
+
+    /* Set return value */
+    ret_value = trees[0];
+    trees[0] = NULL;
+
+done:
+    if(trees) {
+        for(u = 0; u < ntrees; u++)
+            if(trees[u])
+                if(H5S__hyper_free_span_info(trees[u]) < 0)
+                    HDONE_ERROR(H5E_DATASPACE, H5E_CANTFREE, NULL, "can't release hyperslab spans")
+        H5MM_xfree(trees);
+    } /* end if */
+    H5MM_xfree(order);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S__hyper_union_spans() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5S_select_hyperslabs
+ *
+ * Purpose:	Combine the union of a batch of NSLABS hyperslabs with the
+ *              current selection of SPACE, with the same result as
+ *              selecting the first hyperslab with OP and OR'ing the others
+ *              into it, when OP is H5S_SELECT_SET or H5S_SELECT_OR.
+ *
+ *              START, STRIDE, COUNT and BLOCK each hold rank values for
+ *              every hyperslab, one hyperslab after another.  If STRIDE or
+ *              BLOCK is NULL, they are assumed to be set to all '1'.
+ *
+ *              Building the union of the batch first, instead of adding
+ *              one hyperslab at a time, avoids re-walking the whole
+ *              selection for every hyperslab, which makes large irregular
+ *              selections much faster to build.  Unlimited hyperslabs
+ *              can't be part of a batch.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5S_select_hyperslabs(H5S_t *space, H5S_seloper_t op, size_t nslabs,
+    const hsize_t start[], const hsize_t stride[], const hsize_t count[],
+    const hsize_t block[])
+{
+    H5S_hyper_span_info_t *spans = NULL;    /* Union of the hyperslabs */
+    unsigned rank;                  /* # of dimensions of the dataspace */
+    size_t nselect = 0;             /* # of hyperslabs selecting anything */
+    size_t last = 0;                /* Last hyperslab selecting anything */
+    size_t u;                       /* Local index variable */
+    unsigned v;                     /* Local index variable */
+    herr_t ret_value = SUCCEED;     /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Check args */
+    HDassert(space);
+    if(H5S_SCALAR == H5S_GET_EXTENT_TYPE(space))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "hyperslab doesn't support H5S_SCALAR space")
+    if(H5S_NULL == H5S_GET_EXTENT_TYPE(space))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "hyperslab doesn't support H5S_NULL space")
+    if(nslabs == 0 || start == NULL || count == NULL)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "hyperslabs not specified")
+    if(!(op > H5S_SELECT_NOOP && op < H5S_SELECT_INVALID))
+        HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, FAIL, "invalid selection operation")
+
+    /*
+     * Check new selection.
+     */
+    rank = space->extent.rank;
+    for(u = 0; u < nslabs; u++) {
+        hbool_t empty = FALSE;      /* Whether the hyperslab selects nothing */
+
+        for(v = 0; v < rank; v++) {
+            hsize_t s = stride ? stride[(u * rank) + v] : 1;
+            hsize_t b = block ? block[(u * rank) + v] : 1;
+            hsize_t c = count[(u * rank) + v];
+
+            /* Check for 0-sized strides */
+            if(s == 0)
+                HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "invalid stride==0 value")
+
+            /* Check for overlapping hyperslab blocks in new selection. */
+            if(c > 1 && s < b)
+                HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "hyperslab blocks overlap")
+            if(c == H5S_UNLIMITED || b == H5S_UNLIMITED)
+                HGOTO_ERROR(H5E_DATASPACE, H5E_UNSUPPORTED, FAIL, "unlimited hyperslabs can't be selected in a batch")
+            if(c == 0 || b == 0)
+                empty = TRUE;
+        } /* end for */
+        if(!empty) {
+            nselect++;
+            last = u;
+        } /* end if */
+    } /* end for */
+
+    /* Let H5S_select_hyperslab() handle a batch of zero or one hyperslabs,
+     * so that the regular description of a single hyperslab is kept */
+    if(nselect <= 1)
+        HGOTO_DONE(H5S_select_hyperslab(space, op, &start[last * rank],
+                stride ? &stride[last * rank] : NULL, &count[last * rank],
+                block ? &block[last * rank] : NULL))
+
+    /* Check for operating on unlimited selection */
+    if((H5S_GET_SELECT_TYPE(space) == H5S_SEL_HYPERSLABS)
+            && (space->select.sel_info.hslab->unlim_dim >= 0)
+            && (op != H5S_SELECT_SET))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_UNSUPPORTED, FAIL, "unsupported operation on unlimited selection")
+
+    /* Fixup operation for non-hyperslab selections */
+    switch(H5S_GET_SELECT_TYPE(space)) {
+        case H5S_SEL_NONE:   /* No elements selected in dataspace */
+            switch(op) {
+                case H5S_SELECT_SET:   /* Select "set" operation */
+                    /* Change "none" selection to hyperslab selection */
+                    break;
+
+                case H5S_SELECT_OR:    /* Binary "or" operation for hyperslabs */
+                case H5S_SELECT_XOR:   /* Binary "xor" operation for hyperslabs */
+                case H5S_SELECT_NOTA:  /* Binary "B not A" operation for hyperslabs */
+                    op = H5S_SELECT_SET; /* Maps to "set" operation when applied to "none" selection */
+                    break;
+
+                case H5S_SELECT_AND:   /* Binary "and" operation for hyperslabs */
+                case H5S_SELECT_NOTB:  /* Binary "A not B" operation for hyperslabs */
+                    HGOTO_DONE(SUCCEED);        /* Selection stays "none" */
+
+                case H5S_SELECT_NOOP:
+                case H5S_SELECT_APPEND:
+                case H5S_SELECT_PREPEND:
+                case H5S_SELECT_INVALID:
+                default:
+                    HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, FAIL, "invalid selection operation")
+            } /* end switch */
+            break;
+
+        case H5S_SEL_ALL:    /* All elements selected in dataspace */
+            switch(op) {
+                case H5S_SELECT_SET:   /* Select "set" operation */
+                    /* Change "all" selection to hyperslab selection */
+                    break;
+
+                case H5S_SELECT_OR:    /* Binary "or" operation for hyperslabs */
+                    HGOTO_DONE(SUCCEED);        /* Selection stays "all" */
+
+                case H5S_SELECT_AND:   /* Binary "and" operation for hyperslabs */
+                    op = H5S_SELECT_SET; /* Maps to "set" operation when applied to "none" selection */
+                    break;
+
+                case H5S_SELECT_XOR:   /* Binary "xor" operation for hyperslabs */
+                case H5S_SELECT_NOTB:  /* Binary "A not B" operation for hyperslabs */
+                    /* Convert current "all" selection to "real" hyperslab selection */
+                    /* Then allow operation to proceed */
+                    if(H5S_select_hyperslab(space, H5S_SELECT_SET, H5S_hyper_zeros_g, H5S_hyper_ones_g, H5S_hyper_ones_g, space->extent.size) < 0)
+                        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDELETE, FAIL, "can't convert selection")
+                    break;
+
+                case H5S_SELECT_NOTA:  /* Binary "B not A" operation for hyperslabs */
+                    /* Convert to "none" selection */
+                    if(H5S_select_none(space) < 0)
+                        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTSELECT, FAIL, "can't convert selection")
+                    HGOTO_DONE(SUCCEED);
+
+                case H5S_SELECT_NOOP:
+                case H5S_SELECT_APPEND:
+                case H5S_SELECT_PREPEND:
+                case H5S_SELECT_INVALID:
+                default:
+                    HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, FAIL, "invalid selection operation")
+            } /* end switch */
+            break;
+
+        case H5S_SEL_HYPERSLABS:
+            /* Hyperslab operation on hyperslab selection, OK */
+            break;
+
+        case H5S_SEL_POINTS: /* Can't combine hyperslab operations and point selections currently */
+            if(op == H5S_SELECT_SET)      /* Allow only "set" operation to proceed */
+                break;
+            /* Else fall through to error */
+
+        case H5S_SEL_ERROR:
+        case H5S_SEL_N:
+        default:
+            HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, FAIL, "invalid selection operation")
+    } /* end switch */
+
+    /* Build the union of the new hyperslabs */
+    if(NULL == (spans = H5S__hyper_union_spans(rank, nslabs, start, stride, count, block)))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, FAIL, "can't create hyperslab information")
+
+    if(op == H5S_SELECT_SET) {
+        /* If we are setting a new selection, remove current selection first */
+        if(H5S_SELECT_RELEASE(space) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTDELETE, FAIL, "can't release selection")
+
+        /* Allocate space for the hyperslab selection information */
+        if(NULL == (space->select.sel_info.hslab = H5FL_MALLOC(H5S_hyper_sel_t)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate hyperslab info")
+
+        /* Set the selection to the new span tree */
+        space->select.sel_info.hslab->span_lst = spans;
+        spans = NULL;
+        space->select.type = H5S_sel_hyper;
+        space->select.sel_info.hslab->diminfo_valid = FALSE;
+        space->select.sel_info.hslab->unlim_dim = -1;
+        space->select.num_elem = H5S__hyper_spans_nelem(space->select.sel_info.hslab->span_lst);
+
+        /* Attempt to rebuild "optimized" start/stride/count/block information.
+         * from resulting hyperslab span tree */
+        H5S__hyper_rebuild(space);
+    } /* end if */
+    else if(op >= H5S_SELECT_OR && op <= H5S_SELECT_NOTA) {
+        H5S_hyper_span_info_t *new_spans = spans;   /* Spans handed over */
+
+        /* Sanity check */
+        HDassert(H5S_GET_SELECT_TYPE(space) == H5S_SEL_HYPERSLABS);
+
+        /* The spans are released by H5S__generate_hyperslab_spans() */
+        spans = NULL;
+
+        /* Check if there's no hyperslab span information currently */
+        if(NULL == space->select.sel_info.hslab->span_lst)
+            if(H5S__hyper_generate_spans(space) < 0) {
+                H5S__hyper_free_span_info(new_spans);
+                HGOTO_ERROR(H5E_DATASPACE, H5E_UNINITIALIZED, FAIL, "dataspace does not have span tree")
+            } /* end if */
+
+        /* Indicate that the regular dimensions are no longer valid */
+        space->select.sel_info.hslab->diminfo_valid = FALSE;
+
+        /* Set selection type */
+        /* (Could be overridden by resetting selection to 'none', below) */
+        space->select.type = H5S_sel_hyper;
+
+        /* Combine the new hyperslabs with the current selection */
+        if(H5S__generate_hyperslab_spans(space, op, new_spans) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_CANTINSERT, FAIL, "can't generate hyperslabs")
+    } /* end if */
+    else
+        HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, FAIL, "invalid selection operation")
+
+done:
+    if(spans)
+        if(H5S__hyper_free_span_info(spans) < 0)
+            HDONE_ERROR(H5E_DATASPACE, H5E_CANTFREE, FAIL, "can't release hyperslab spans")
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S_select_hyperslabs() */
+
 
 
 /*--------------------------------------------------------------------------
@@ -6895,6 +8743,8 @@ H5Sselect_hyperslab(hid_t space_id, H5S_seloper_t op, const hsize_t start[],
 done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Sselect_hyperslab() */
+
+
 #else /* NEW_HYPERSLAB_API */ /* Works */
 
 /*-------------------------------------------------------------------------
@@ -8769,6 +10619,558 @@ loc += fast_dim_buf_off;
     FUNC_LEAVE_NOAPI(SUCCEED)
 } /* end H5S__hyper_get_seq_list_opt() */
 
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_get_seq_list_opt_3d
+ PURPOSE
+    Create a list of offsets & lengths for a regular selection of rank 3 or
+    less
+ USAGE
+    herr_t H5S__hyper_get_seq_list_opt_3d(space,iter,maxseq,maxelem,nseq,nelem,off,len)
+        H5S_t *space;           IN: Dataspace containing selection to use.
+        H5S_sel_iter_t *iter;   IN/OUT: Selection iterator describing last
+                                    position of interest in selection.
+        size_t maxseq;          IN: Maximum number of sequences to generate
+        size_t maxelem;         IN: Maximum number of elements to include in the
+                                    generated sequences
+        size_t *nseq;           OUT: Actual number of sequences generated
+        size_t *nelem;          OUT: Actual number of elements in sequences generated
+        hsize_t *off;           OUT: Array of offsets
+        size_t *len;            OUT: Array of lengths
+ RETURNS
+    Non-negative on success/Negative on failure.
+ DESCRIPTION
+    Same as H5S__hyper_get_seq_list_opt(), for the (possibly flattened)
+    regular selections of rank 1 to 3 that make up most I/O.  The selection
+    is padded to three dimensions with single element dimensions, so a
+    single loop with fixed trip counts handles all three ranks, without the
+    per-dimension wrap & skip arrays of the general routine.
+
+    Blocks which start where the previous sequence ended are merged into
+    it, so selections whose rows abut (e.g. the last block in each row
+    reaching the edge of the extent and the first block starting at 0)
+    produce one sequence per contiguous run.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    Must start at the beginning of a block in the fastest changing
+    dimension, like H5S__hyper_get_seq_list_opt().
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static herr_t
+H5S__hyper_get_seq_list_opt_3d(const H5S_t *space, H5S_sel_iter_t *iter,
+    size_t maxseq, size_t maxelem, size_t *nseq, size_t *nelem,
+    hsize_t *off, size_t *len)
+{
+    const H5S_hyper_dim_t *tdiminfo;    /* Temporary pointer to diminfo information */
+    const hsize_t *mem_size;            /* Size of the source buffer */
+    const hssize_t *sel_off;            /* Selection offset in dataspace */
+    hsize_t start[3], stride[3], count[3], block[3];   /* Padded selection information */
+    hsize_t pos[3];                     /* Padded iterator location */
+    hsize_t abs_off[3];                 /* Padded selection offset, in elements */
+    size_t fast_partial = 0;            /* Elements output from a partial block */
+    hsize_t cnt[3], blk[3];             /* Current block & row within the block, for each dimension */
+    hsize_t slab[3];                    /* Bytes per step in each dimension */
+    hsize_t loc;                        /* Byte offset of the current block */
+    size_t curr_seq = 0;                /* Current sequence being operated on */
+    size_t io_left;                     /* The number of elements left in I/O operation */
+    size_t start_io_left;               /* The initial number of elements left in I/O operation */
+    size_t elem_size;                   /* Size of each element iterating over */
+    size_t fast_block;                  /* Elements in a block of the fastest dimension */
+    unsigned ndims;                     /* Number of dimensions of dataset */
+    unsigned pad;                       /* Number of padding dimensions */
+    unsigned u;                         /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Check args */
+    HDassert(space);
+    HDassert(iter);
+    HDassert(maxseq > 0);
+    HDassert(maxelem > 0);
+    HDassert(nseq);
+    HDassert(nelem);
+    HDassert(off);
+    HDassert(len);
+
+    /* Set the local copy of the diminfo pointer */
+    tdiminfo = iter->u.hyp.diminfo;
+
+    /* Check if this is a "flattened" regular hyperslab selection */
+    if(iter->u.hyp.iter_rank != 0 && iter->u.hyp.iter_rank < space->extent.rank) {
+        ndims = iter->u.hyp.iter_rank;
+        sel_off = iter->u.hyp.sel_off;
+        mem_size = iter->u.hyp.size;
+    } /* end if */
+    else {
+        ndims = space->extent.rank;
+        sel_off = space->select.offset;
+        mem_size = space->extent.size;
+    } /* end else */
+    HDassert(ndims > 0 && ndims <= 3);
+
+    /* Pad the selection out to three dimensions */
+    pad = 3 - ndims;
+    elem_size = iter->elmt_size;
+    for(u = 0; u < pad; u++) {
+        start[u] = 0;
+        stride[u] = 1;
+        count[u] = 1;
+        block[u] = 1;
+        pos[u] = 0;
+        abs_off[u] = 0;
+        slab[u] = 0;
+    } /* end for */
+    for(u = pad; u < 3; u++) {
+        start[u] = tdiminfo[u - pad].start;
+        stride[u] = tdiminfo[u - pad].stride;
+        count[u] = tdiminfo[u - pad].count;
+        block[u] = tdiminfo[u - pad].block;
+        pos[u] = iter->u.hyp.off[u - pad];
+        abs_off[u] = (hsize_t)sel_off[u - pad];
+    } /* end for */
+    slab[2] = elem_size;
+    if(pad < 2)
+        slab[1] = slab[2] * mem_size[2 - pad];
+    if(pad < 1)
+        slab[0] = slab[1] * mem_size[1];
+
+    /* Sanity check that there aren't any "remainder" sequences in process */
+    HDassert(!((pos[2] - start[2]) % stride[2] != 0 ||
+            ((pos[2] != start[2]) && count[2] == 1)));
+
+    /* Compute the current "counts" for this location */
+    for(u = 0; u < 3; u++) {
+        if(count[u] == 1) {
+            cnt[u] = 0;
+            blk[u] = pos[u] - start[u];
+        } /* end if */
+        else {
+            cnt[u] = (pos[u] - start[u]) / stride[u];
+            blk[u] = (pos[u] - start[u]) % stride[u];
+        } /* end else */
+    } /* end for */
+
+    /* Calculate the number of elements to sequence through */
+    H5_CHECK_OVERFLOW(iter->elmt_left, hsize_t, size_t);
+    io_left = start_io_left = MIN((size_t)iter->elmt_left, maxelem);
+    H5_CHECKED_ASSIGN(fast_block, size_t, block[2], hsize_t);
+
+    /* Compute the initial buffer offset */
+    loc = (pos[0] + abs_off[0]) * slab[0] + (pos[1] + abs_off[1]) * slab[1]
+            + (pos[2] + abs_off[2]) * slab[2];
+
+    while(io_left > 0 && curr_seq < maxseq) {
+        size_t nelmts = MIN(fast_block, io_left);   /* Elements in this sequence */
+        size_t nbytes = nelmts * elem_size;         /* Bytes in this sequence */
+
+        /* Store the sequence information, merging it into the last if they abut */
+        if(curr_seq > 0 && (off[curr_seq - 1] + len[curr_seq - 1]) == loc)
+            len[curr_seq - 1] += nbytes;
+        else {
+            off[curr_seq] = loc;
+            len[curr_seq] = nbytes;
+            curr_seq++;
+        } /* end else */
+        io_left -= nelmts;
+
+        /* Check for stopping within a block */
+        if(nelmts < fast_block) {
+            fast_partial = nelmts;
+            break;
+        } /* end if */
+
+        /* Move to the next block in the fastest dimension */
+        if(++cnt[2] < count[2]) {
+            loc += stride[2] * slab[2];
+            continue;
+        } /* end if */
+        cnt[2] = 0;
+
+        /* Move to the next row in the middle dimension, then the slowest */
+        if(++blk[1] < block[1])
+            pos[1]++;
+        else {
+            blk[1] = 0;
+            if(++cnt[1] < count[1])
+                pos[1] += (stride[1] - block[1]) + 1;
+            else {
+                cnt[1] = 0;
+                pos[1] = start[1];
+
+                if(++blk[0] < block[0])
+                    pos[0]++;
+                else {
+                    blk[0] = 0;
+                    if(++cnt[0] < count[0])
+                        pos[0] += (stride[0] - block[0]) + 1;
+                    else {
+                        cnt[0] = 0;
+                        pos[0] = start[0];
+                    } /* end else */
+                } /* end else */
+            } /* end else */
+        } /* end else */
+
+        loc = (pos[0] + abs_off[0]) * slab[0] + (pos[1] + abs_off[1]) * slab[1]
+                + (start[2] + abs_off[2]) * slab[2];
+    } /* end while */
+
+    /* Update the iterator with the location we stopped */
+    pos[2] = start[2] + (cnt[2] * stride[2]) + fast_partial;
+    for(u = pad; u < 3; u++)
+        iter->u.hyp.off[u - pad] = pos[u];
+
+    /* Decrement the number of elements left in selection */
+    iter->elmt_left -= (start_io_left - io_left);
+
+    /* Increment the number of sequences generated */
+    *nseq += curr_seq;
+
+    /* Increment the number of elements used */
+    *nelem += start_io_left - io_left;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5S__hyper_get_seq_list_opt_3d() */
+
+#ifdef H5S_HYPER_AVX2
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_gather_avx2
+ PURPOSE
+    Gather 4 or 8 byte elements a fixed stride apart with AVX2
+ USAGE
+    size_t H5S__hyper_gather_avx2(elem_size, buf, s, tbuf, n)
+        size_t elem_size;       IN: Size of each element (4 or 8 bytes)
+        const uint8_t *buf;     IN: First element in the strided buffer
+        int s;                  IN: Bytes between elements in BUF
+        uint8_t *tbuf;          OUT: Packed buffer
+        size_t n;               IN: Number of elements to copy
+ RETURNS
+    Number of elements gathered, a multiple of the vector width.
+ DESCRIPTION
+    Gathers eight 4 byte or four 8 byte elements at a time, leaving the
+    rest for the scalar copies.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    Built for AVX2 whatever the compiler flags, so must only be called
+    once H5S_hyper_avx2_g says the CPU has AVX2.  The offsets of a vector
+    must fit in its 32-bit indices.
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+__attribute__((target("avx2"))) static size_t
+H5S__hyper_gather_avx2(size_t elem_size, const uint8_t *buf, int s,
+    uint8_t *tbuf, size_t n)
+{
+    size_t ngathered = 0;       /* # of elements gathered */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(elem_size == 4) {
+        const __m256i idx = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+
+        for(; ngathered + 8 <= n; ngathered += 8, buf += 8 * (size_t)s, tbuf += 32)
+            _mm256_storeu_si256((__m256i *)tbuf, _mm256_i32gather_epi32((const int *)buf, idx, 1));
+    } /* end if */
+    else {
+        const __m128i idx = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+
+        HDassert(elem_size == 8);
+        for(; ngathered + 4 <= n; ngathered += 4, buf += 4 * (size_t)s, tbuf += 32)
+            _mm256_storeu_si256((__m256i *)tbuf, _mm256_i32gather_epi64((const long long *)buf, idx, 1));
+    } /* end else */
+
+    FUNC_LEAVE_NOAPI(ngathered)
+} /* end H5S__hyper_gather_avx2() */
+#endif /* H5S_HYPER_AVX2 */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S__hyper_copy_stride
+ PURPOSE
+    Copy elements a fixed stride apart to/from a packed buffer
+ USAGE
+    void H5S__hyper_copy_stride(how, gather, elem_size, buf, stride, tbuf, n)
+        H5S_sel_copy_t how;     IN: Kernel to use
+        hbool_t gather;         IN: Whether to copy from BUF to TBUF (or back)
+        size_t elem_size;       IN: Size of each element (1, 2, 4 or 8 bytes)
+        uint8_t *buf;           IN/OUT: First element in the strided buffer
+        hsize_t stride;         IN: Bytes between elements in BUF
+        uint8_t *tbuf;          IN/OUT: Packed buffer
+        size_t n;               IN: Number of elements to copy
+ RETURNS
+    None.
+ DESCRIPTION
+    Copies one row of single element blocks.  When the CPU has AVX2
+    (checked with cpuid on first use), 4 & 8 byte elements are gathered
+    eight or four at a time with vector gathers; everything else uses
+    unrolled scalar copies.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    AVX2 has no scatter, so scatters are always scalar.
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+static void
+H5S__hyper_copy_stride(H5S_sel_copy_t how, hbool_t gather, size_t elem_size,
+    uint8_t *buf, hsize_t stride, uint8_t *tbuf, size_t n)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+#ifdef H5S_HYPER_AVX2
+    /* Gather 4 & 8 byte elements with vector gathers, while the offsets fit
+     * in the 32-bit indices */
+    if(how != H5S_SEL_COPY_STRIDE && gather && (elem_size == 4 || elem_size == 8)
+            && stride <= (hsize_t)(INT_MAX / 8)) {
+        /* Check the CPU once */
+        if(H5S_hyper_avx2_g < 0) {
+            __builtin_cpu_init();
+            H5S_hyper_avx2_g = __builtin_cpu_supports("avx2") ? 1 : 0;
+        } /* end if */
+
+        if(H5S_hyper_avx2_g) {
+            size_t ngathered = H5S__hyper_gather_avx2(elem_size, buf, (int)stride, tbuf, n);
+
+            buf += ngathered * stride;
+            tbuf += ngathered * elem_size;
+            n -= ngathered;
+        } /* end if */
+    } /* end if */
+#else /* H5S_HYPER_AVX2 */
+    (void)how;
+#endif /* H5S_HYPER_AVX2 */
+
+    switch(elem_size) {
+        case 1:
+            H5S_HYPER_COPY_STRIDE(1, gather, buf, stride, tbuf, n)
+            break;
+
+        case 2:
+            H5S_HYPER_COPY_STRIDE(2, gather, buf, stride, tbuf, n)
+            break;
+
+        case 4:
+            H5S_HYPER_COPY_STRIDE(4, gather, buf, stride, tbuf, n)
+            break;
+
+        case 8:
+            H5S_HYPER_COPY_STRIDE(8, gather, buf, stride, tbuf, n)
+            break;
+
+        default:
+            HDassert(0 && "unsupported element size");
+            break;
+    } /* end switch */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5S__hyper_copy_stride() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5S_hyper_copy_regular
+ PURPOSE
+    Gather/scatter a regular selection directly from its diminfo
+ USAGE
+    herr_t H5S_hyper_copy_regular(space,iter,how,gather,buf,tbuf,nelmts,ncopied)
+        const H5S_t *space;     IN: Dataspace containing selection to use.
+        H5S_sel_iter_t *iter;   IN/OUT: Selection iterator describing last
+                                    position of interest in selection.
+        H5S_sel_copy_t how;     IN: Kernel to use
+        hbool_t gather;         IN: Whether to gather from BUF into TBUF
+                                    (or scatter from TBUF into BUF)
+        void *buf;              IN/OUT: Buffer described by the dataspace
+        void *tbuf;             IN/OUT: Packed buffer
+        size_t nelmts;          IN: Maximum number of elements to copy
+        size_t *ncopied;        OUT: Number of elements copied
+ RETURNS
+    Non-negative on success/Negative on failure.
+ DESCRIPTION
+    Copies up to NELMTS elements of the selection, from the position of
+    ITER, between BUF and TBUF, without building offset/length sequences.
+    This serves the selections where the sequence lists cost the most: one
+    1, 2, 4 or 8 byte element in each block of the fastest changing
+    dimension, where each sequence would copy a single element.
+
+    Sets NCOPIED to zero without touching ITER when the selection isn't one
+    of those (or HOW is H5S_SEL_COPY_SEQ_LIST), so the caller
+    (H5D__gather_mem() / H5D__scatter_mem()) can fall back to sequence
+    lists.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    Handles regular selections of (flattened) rank 3 or less, like
+    H5S__hyper_get_seq_list_opt_3d(), with which it keeps ITER compatible.
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+herr_t
+H5S_hyper_copy_regular(const H5S_t *space, H5S_sel_iter_t *iter,
+    H5S_sel_copy_t how, hbool_t gather, void *_buf, void *_tbuf,
+    size_t nelmts, size_t *ncopied)
+{
+    uint8_t *buf = (uint8_t *)_buf;     /* Buffer described by the dataspace */
+    uint8_t *tbuf = (uint8_t *)_tbuf;   /* Packed buffer */
+    const H5S_hyper_dim_t *tdiminfo;    /* Temporary pointer to diminfo information */
+    const hsize_t *mem_size;            /* Size of the source buffer */
+    const hssize_t *sel_off;            /* Selection offset in dataspace */
+    hsize_t start[3], stride[3], count[3], block[3];   /* Padded selection information */
+    hsize_t pos[3];                     /* Padded iterator location */
+    hsize_t abs_off[3];                 /* Padded selection offset, in elements */
+    hsize_t cnt[3], blk[3];             /* Current block & row within the block, for each dimension */
+    hsize_t slab[3];                    /* Bytes per step in each dimension */
+    hsize_t loc;                        /* Byte offset of the current block */
+    size_t io_left;                     /* The number of elements left to copy */
+    size_t start_io_left;               /* The initial number of elements left to copy */
+    size_t elem_size;                   /* Size of each element */
+    unsigned ndims;                     /* Number of dimensions of dataset */
+    unsigned pad;                       /* Number of padding dimensions */
+    unsigned u;                         /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Check args */
+    HDassert(space);
+    HDassert(iter);
+    HDassert(how >= H5S_SEL_COPY_SEQ_LIST && how < H5S_SEL_COPY_NTYPES);
+    HDassert(buf);
+    HDassert(tbuf);
+    HDassert(ncopied);
+
+    *ncopied = 0;
+
+    /* Check for a selection this can copy */
+    if(how == H5S_SEL_COPY_SEQ_LIST || iter->type != H5S_sel_iter_hyper
+            || !iter->u.hyp.diminfo_valid || iter->elmt_left == 0 || nelmts == 0)
+        HGOTO_DONE(SUCCEED)
+    elem_size = iter->elmt_size;
+    if(elem_size != 1 && elem_size != 2 && elem_size != 4 && elem_size != 8)
+        HGOTO_DONE(SUCCEED)
+
+    /* Set the local copy of the diminfo pointer */
+    tdiminfo = iter->u.hyp.diminfo;
+
+    /* Check if this is a "flattened" regular hyperslab selection */
+    if(iter->u.hyp.iter_rank != 0 && iter->u.hyp.iter_rank < space->extent.rank) {
+        ndims = iter->u.hyp.iter_rank;
+        sel_off = iter->u.hyp.sel_off;
+        mem_size = iter->u.hyp.size;
+    } /* end if */
+    else {
+        ndims = space->extent.rank;
+        sel_off = space->select.offset;
+        mem_size = space->extent.size;
+    } /* end else */
+    if(ndims > 3 || tdiminfo[ndims - 1].block != 1 || tdiminfo[ndims - 1].count == 1)
+        HGOTO_DONE(SUCCEED)
+
+    /* Pad the selection out to three dimensions */
+    pad = 3 - ndims;
+    for(u = 0; u < pad; u++) {
+        start[u] = 0;
+        stride[u] = 1;
+        count[u] = 1;
+        block[u] = 1;
+        pos[u] = 0;
+        abs_off[u] = 0;
+        slab[u] = 0;
+    } /* end for */
+    for(u = pad; u < 3; u++) {
+        start[u] = tdiminfo[u - pad].start;
+        stride[u] = tdiminfo[u - pad].stride;
+        count[u] = tdiminfo[u - pad].count;
+        block[u] = tdiminfo[u - pad].block;
+        pos[u] = iter->u.hyp.off[u - pad];
+        abs_off[u] = (hsize_t)sel_off[u - pad];
+    } /* end for */
+    slab[2] = elem_size;
+    if(pad < 2)
+        slab[1] = slab[2] * mem_size[2 - pad];
+    if(pad < 1)
+        slab[0] = slab[1] * mem_size[1];
+
+    /* Compute the current "counts" for this location */
+    for(u = 0; u < 3; u++) {
+        if(count[u] == 1) {
+            cnt[u] = 0;
+            blk[u] = pos[u] - start[u];
+        } /* end if */
+        else {
+            cnt[u] = (pos[u] - start[u]) / stride[u];
+            blk[u] = (pos[u] - start[u]) % stride[u];
+        } /* end else */
+    } /* end for */
+    HDassert(blk[2] == 0);
+
+    /* Calculate the number of elements to copy */
+    H5_CHECK_OVERFLOW(iter->elmt_left, hsize_t, size_t);
+    io_left = start_io_left = MIN((size_t)iter->elmt_left, nelmts);
+
+    /* Compute the initial buffer offset */
+    loc = (pos[0] + abs_off[0]) * slab[0] + (pos[1] + abs_off[1]) * slab[1]
+            + (pos[2] + abs_off[2]) * slab[2];
+
+    while(io_left > 0) {
+        size_t row;                     /* Elements copied from this row */
+
+        /* Copy the rest of the row in the fastest dimension */
+        H5_CHECKED_ASSIGN(row, size_t, MIN(count[2] - cnt[2], (hsize_t)io_left), hsize_t);
+        H5S__hyper_copy_stride(how, gather, elem_size, buf + loc, stride[2] * slab[2], tbuf, row);
+        tbuf += row * elem_size;
+        io_left -= row;
+
+        /* Check for stopping within the row */
+        if((cnt[2] += row) < count[2])
+            break;
+        cnt[2] = 0;
+
+        /* Move to the next row in the middle dimension, then the slowest */
+        if(++blk[1] < block[1])
+            pos[1]++;
+        else {
+            blk[1] = 0;
+            if(++cnt[1] < count[1])
+                pos[1] += (stride[1] - block[1]) + 1;
+            else {
+                cnt[1] = 0;
+                pos[1] = start[1];
+
+                if(++blk[0] < block[0])
+                    pos[0]++;
+                else {
+                    blk[0] = 0;
+                    if(++cnt[0] < count[0])
+                        pos[0] += (stride[0] - block[0]) + 1;
+                    else {
+                        cnt[0] = 0;
+                        pos[0] = start[0];
+                    } /* end else */
+                } /* end else */
+            } /* end else */
+        } /* end else */
+
+        loc = (pos[0] + abs_off[0]) * slab[0] + (pos[1] + abs_off[1]) * slab[1]
+                + (start[2] + abs_off[2]) * slab[2];
+    } /* end while */
+
+    /* Update the iterator with the location we stopped */
+    pos[2] = start[2] + (cnt[2] * stride[2]);
+    for(u = pad; u < 3; u++)
+        iter->u.hyp.off[u - pad] = pos[u];
+
+    /* Decrement the number of elements left in selection */
+    iter->elmt_left -= (start_io_left - io_left);
+
+    *ncopied = start_io_left - io_left;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5S_hyper_copy_regular() */
+
+
 
 /*--------------------------------------------------------------------------
  NAME
@@ -9221,6 +11623,9 @@ H5S__hyper_get_seq_list(const H5S_t *space, unsigned H5_ATTR_UNUSED flags, H5S_s
         if(single_block)
             /* Use single-block optimized call to generate sequence list */
             ret_value = H5S__hyper_get_seq_list_single(space, iter, maxseq, maxelem, nseq, nelem, off, len);
+        else if(ndims <= 3)
+            /* Use low-rank optimized call to generate sequence list */
+            ret_value = H5S__hyper_get_seq_list_opt_3d(space, iter, maxseq, maxelem, nseq, nelem, off, len);
         else
             /* Use optimized call to generate sequence list */
             ret_value = H5S__hyper_get_seq_list_opt(space, iter, maxseq, maxelem, nseq, nelem, off, len);
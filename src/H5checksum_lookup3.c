@@ -0,0 +1,347 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5checksum_lookup3.c
+ *
+ * Purpose:		Alternate implementations of the Jenkins lookup3
+ *                      metadata checksum, selected at run time.
+ *
+ *                      All implementations return exactly the value of
+ *                      H5_checksum_lookup3().  lookup3 mixes each 12-byte
+ *                      block into the state left by the previous one, so a
+ *                      single buffer can't be split across SIMD lanes; the
+ *                      speedup comes from loading whole 32-bit words on
+ *                      little-endian hosts (the "hashlittle" path of the
+ *                      reference code) instead of assembling them a byte at
+ *                      a time.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"		/* Generic Functions			*/
+
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* lookup3 mixing & finalization, from the reference implementation */
+#define H5_lookup3_rot(x, k) (((x) << (k)) ^ ((x) >> (32 - (k))))
+#define H5_lookup3_mix(a, b, c)                                             \
+{                                                                           \
+    a -= c;  a ^= H5_lookup3_rot(c,  4);  c += b;                           \
+    b -= a;  b ^= H5_lookup3_rot(a,  6);  a += c;                           \
+    c -= b;  c ^= H5_lookup3_rot(b,  8);  b += a;                           \
+    a -= c;  a ^= H5_lookup3_rot(c, 16);  c += b;                           \
+    b -= a;  b ^= H5_lookup3_rot(a, 19);  a += c;                           \
+    c -= b;  c ^= H5_lookup3_rot(b,  4);  b += a;                           \
+}
+#define H5_lookup3_final(a, b, c)                                           \
+{                                                                           \
+    c ^= b; c -= H5_lookup3_rot(b, 14);                                     \
+    a ^= c; a -= H5_lookup3_rot(c, 11);                                     \
+    b ^= a; b -= H5_lookup3_rot(a, 25);                                     \
+    c ^= b; c -= H5_lookup3_rot(b, 16);                                     \
+    a ^= c; a -= H5_lookup3_rot(c,  4);                                     \
+    b ^= a; b -= H5_lookup3_rot(a, 14);                                     \
+    c ^= b; c -= H5_lookup3_rot(b, 24);                                     \
+}
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+/* Signature of a checksum implementation */
+typedef uint32_t (*H5_checksum_func_t)(const void *data, size_t len, uint32_t initval);
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static uint32_t H5_checksum_lookup3_byte(const void *data, size_t len, uint32_t initval);
+static uint32_t H5_checksum_lookup3_word(const void *data, size_t len, uint32_t initval);
+static uint32_t H5_checksum_lookup3_resolve(const void *data, size_t len, uint32_t initval);
+
+
+/*********************/
+/* Package Variables */
+/*********************/
+
+
+/*****************************/
+/* Library Private Variables */
+/*****************************/
+
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Implementations, indexed by H5_checksum_impl_t */
+static const struct {
+    const char *name;
+    H5_checksum_func_t func;
+} H5_checksum_impl_g[H5_CHECKSUM_IMPL_NTYPES] = {
+    {"byte", H5_checksum_lookup3_byte},
+    {"word", H5_checksum_lookup3_word}
+};
+
+/* Implementation used by H5_checksum_metadata_fast(), chosen on first use */
+static H5_checksum_func_t H5_checksum_metadata_fast_g = H5_checksum_lookup3_resolve;
+
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_checksum_lookup3_byte
+ *
+ * Purpose:     Portable lookup3, assembling each word from bytes.
+ *
+ * Return:      lookup3 checksum of the buffer
+ *
+ *-------------------------------------------------------------------------
+ */
+static uint32_t
+H5_checksum_lookup3_byte(const void *data, size_t len, uint32_t initval)
+{
+    const uint8_t *k = (const uint8_t *)data;
+    uint32_t a, b, c;
+
+    a = b = c = 0xdeadbeef + ((uint32_t)len) + initval;
+
+    while(len > 12) {
+        a += k[0];
+        a += ((uint32_t)k[1]) << 8;
+        a += ((uint32_t)k[2]) << 16;
+        a += ((uint32_t)k[3]) << 24;
+        b += k[4];
+        b += ((uint32_t)k[5]) << 8;
+        b += ((uint32_t)k[6]) << 16;
+        b += ((uint32_t)k[7]) << 24;
+        c += k[8];
+        c += ((uint32_t)k[9]) << 8;
+        c += ((uint32_t)k[10]) << 16;
+        c += ((uint32_t)k[11]) << 24;
+        H5_lookup3_mix(a, b, c);
+        len -= 12;
+        k += 12;
+    } /* end while */
+
+    /* Last block: affect all 32 bits of (c) */
+    switch(len) {
+        case 12: c += ((uint32_t)k[11]) << 24; /* FALLTHROUGH */
+        case 11: c += ((uint32_t)k[10]) << 16; /* FALLTHROUGH */
+        case 10: c += ((uint32_t)k[9]) << 8;   /* FALLTHROUGH */
+        case 9 : c += k[8];                    /* FALLTHROUGH */
+        case 8 : b += ((uint32_t)k[7]) << 24;  /* FALLTHROUGH */
+        case 7 : b += ((uint32_t)k[6]) << 16;  /* FALLTHROUGH */
+        case 6 : b += ((uint32_t)k[5]) << 8;   /* FALLTHROUGH */
+        case 5 : b += k[4];                    /* FALLTHROUGH */
+        case 4 : a += ((uint32_t)k[3]) << 24;  /* FALLTHROUGH */
+        case 3 : a += ((uint32_t)k[2]) << 16;  /* FALLTHROUGH */
+        case 2 : a += ((uint32_t)k[1]) << 8;   /* FALLTHROUGH */
+        case 1 : a += k[0];
+                 break;
+        case 0 : goto done;
+        default:
+            HDassert(0 && "This Should never be executed!");
+    } /* end switch */
+
+    H5_lookup3_final(a, b, c);
+
+done:
+    return c;
+} /* end H5_checksum_lookup3_byte() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_checksum_lookup3_word
+ *
+ * Purpose:     lookup3 for little-endian hosts, loading whole 32-bit
+ *              words.  The loads go through HDmemcpy() so the buffer
+ *              needn't be aligned; compilers emit a single load for them.
+ *
+ *              The final partial block is copied into a zeroed block,
+ *              which adds the same values as the byte-wise tail.
+ *
+ * Return:      lookup3 checksum of the buffer
+ *
+ *-------------------------------------------------------------------------
+ */
+static uint32_t
+H5_checksum_lookup3_word(const void *data, size_t len, uint32_t initval)
+{
+    const uint8_t *k = (const uint8_t *)data;
+    uint32_t w[3];
+    uint32_t a, b, c;
+
+    a = b = c = 0xdeadbeef + ((uint32_t)len) + initval;
+
+    while(len > 12) {
+        HDmemcpy(w, k, (size_t)12);
+        a += w[0];
+        b += w[1];
+        c += w[2];
+        H5_lookup3_mix(a, b, c);
+        len -= 12;
+        k += 12;
+    } /* end while */
+
+    if(0 == len)
+        return c;
+
+    w[0] = w[1] = w[2] = 0;
+    HDmemcpy(w, k, len);
+    a += w[0];
+    b += w[1];
+    c += w[2];
+
+    H5_lookup3_final(a, b, c);
+
+    return c;
+} /* end H5_checksum_lookup3_word() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_checksum_lookup3_resolve
+ *
+ * Purpose:     Pick the implementation for this host on first use, then
+ *              compute the checksum with it.
+ *
+ *              The word implementation is only correct on little-endian
+ *              hosts; big-endian hosts keep the byte implementation.
+ *
+ * Return:      lookup3 checksum of the buffer
+ *
+ *-------------------------------------------------------------------------
+ */
+static uint32_t
+H5_checksum_lookup3_resolve(const void *data, size_t len, uint32_t initval)
+{
+    const uint32_t probe = 1;
+
+    if(1 == *(const uint8_t *)&probe)
+        H5_checksum_metadata_fast_g = H5_checksum_lookup3_word;
+    else
+        H5_checksum_metadata_fast_g = H5_checksum_lookup3_byte;
+
+    return (*H5_checksum_metadata_fast_g)(data, len, initval);
+} /* end H5_checksum_lookup3_resolve() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_checksum_metadata_fast
+ *
+ * Purpose:     Compute the metadata checksum with the fastest lookup3
+ *              implementation for this host.  Returns the same value as
+ *              H5_checksum_metadata().
+ *
+ * Return:      checksum of input buffer (can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+uint32_t
+H5_checksum_metadata_fast(const void *data, size_t len, uint32_t initval)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Sanity check */
+    HDassert(data);
+
+    FUNC_LEAVE_NOAPI((*H5_checksum_metadata_fast_g)(data, len, initval))
+} /* end H5_checksum_metadata_fast() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_checksum_lookup3_impl
+ *
+ * Purpose:     Compute the lookup3 checksum with a given implementation,
+ *              for testing and benchmarking.  IMPL must be valid on this
+ *              host (see H5_checksum_impl_supported()).
+ *
+ * Return:      checksum of input buffer (can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+uint32_t
+H5_checksum_lookup3_impl(H5_checksum_impl_t impl, const void *data,
+    size_t len, uint32_t initval)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(impl >= 0 && impl < H5_CHECKSUM_IMPL_NTYPES);
+    HDassert(data);
+
+    FUNC_LEAVE_NOAPI((*H5_checksum_impl_g[impl].func)(data, len, initval))
+} /* end H5_checksum_lookup3_impl() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_checksum_impl_supported
+ *
+ * Purpose:     Check whether a lookup3 implementation gives correct
+ *              results on this host.
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+hbool_t
+H5_checksum_impl_supported(H5_checksum_impl_t impl)
+{
+    const uint32_t probe = 1;
+    hbool_t ret_value = FALSE;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(H5_CHECKSUM_IMPL_BYTE == impl)
+        ret_value = TRUE;
+    else if(H5_CHECKSUM_IMPL_WORD == impl)
+        ret_value = (hbool_t)(1 == *(const uint8_t *)&probe);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5_checksum_impl_supported() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_checksum_impl_name
+ *
+ * Purpose:     Get the name of a lookup3 implementation.
+ *
+ * Return:      Name of the implementation, or NULL if IMPL is invalid
+ *
+ *-------------------------------------------------------------------------
+ */
+const char *
+H5_checksum_impl_name(H5_checksum_impl_t impl)
+{
+    const char *ret_value = NULL;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(impl >= 0 && impl < H5_CHECKSUM_IMPL_NTYPES)
+        ret_value = H5_checksum_impl_g[impl].name;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5_checksum_impl_name() */
@@ -1151,6 +1151,9 @@ typedef off_t               h5_stat_size_t;
 #ifndef HDpowf
     #define HDpowf(X,Y)   powf(X,Y)
 #endif /* HDpowf */
+#ifndef HDpread
+    #define HDpread(F,B,C,O)    pread(F,B,C,O)
+#endif /* HDpread */
 #ifndef HDprintf
     #define HDprintf(...)   HDfprintf(stdout, __VA_ARGS__)
 #endif /* HDprintf */
@@ -1163,6 +1166,9 @@ typedef off_t               h5_stat_size_t;
 #ifndef HDputs
     #define HDputs(S)    puts(S)
 #endif /* HDputs */
+#ifndef HDpwrite
+    #define HDpwrite(F,B,C,O)    pwrite(F,B,C,O)
+#endif /* HDpwrite */
 #ifndef HDqsort
     #define HDqsort(M,N,Z,F)  qsort(M,N,Z,F)
 #endif /* HDqsort*/
@@ -2705,13 +2711,66 @@ H5_DLL int H5T_term_package(void);
 H5_DLL int H5T_top_term_package(void);
 H5_DLL int H5Z_term_package(void);
 
+/* lookup3 checksum implementations (see H5checksum_lookup3.c) */
+typedef enum H5_checksum_impl_t {
+    H5_CHECKSUM_IMPL_BYTE = 0,  /* Portable, byte at a time */
+    H5_CHECKSUM_IMPL_WORD,      /* 32-bit word loads, little-endian hosts only */
+    H5_CHECKSUM_IMPL_NTYPES     /* Number of implementations (must be last) */
+} H5_checksum_impl_t;
+
+/* Hot-path tracing spans (see H5span.c).  Only built when the library is
+ * configured with H5_HAVE_SPAN_TRACING; otherwise the macros below expand
+ * to nothing.  H5_SPAN_DECL() declares & starts a span and goes with the
+ * local variable declarations, H5_SPAN_END() records it.
+ */
+typedef enum H5_span_class_t {
+    H5_SPAN_FD_READ = 0,        /* H5FD_read(), by H5FD_mem_t */
+    H5_SPAN_FD_WRITE,           /* H5FD_write(), by H5FD_mem_t */
+    H5_SPAN_CACHE_DESERIALIZE,  /* Cache 'deserialize' callbacks, by client ID */
+    H5_SPAN_CACHE_SERIALIZE,    /* Cache 'serialize' callbacks, by client ID */
+    H5_SPAN_CACHE_VERIFY_CHKSUM,        /* Cache 'verify_chksum' callbacks, by client ID */
+    H5_SPAN_NCLASSES            /* Number of span classes (must be last) */
+} H5_span_class_t;
+
+#define H5_SPAN_NSUBTYPES       40      /* Max. H5FD_mem_t value / cache client ID + 1 */
+#define H5_SPAN_NBUCKETS        24      /* Latency buckets: [2^(i-1), 2^i) ns, the last is open */
+
+/* Span counters, per class & subtype */
+typedef struct H5_span_stats_t {
+    uint64_t calls[H5_SPAN_NCLASSES][H5_SPAN_NSUBTYPES];
+    uint64_t bytes[H5_SPAN_NCLASSES][H5_SPAN_NSUBTYPES];
+    uint64_t time_ns[H5_SPAN_NCLASSES][H5_SPAN_NSUBTYPES];
+    uint64_t hist[H5_SPAN_NCLASSES][H5_SPAN_NSUBTYPES][H5_SPAN_NBUCKETS];
+} H5_span_stats_t;
+
+#ifdef H5_HAVE_SPAN_TRACING
+#define H5_SPAN_DECL(V)         uint64_t V = H5_span_now();
+#define H5_SPAN_END(V, CLS, SUB, BYTES) H5_span_record(CLS, (unsigned)(SUB), (uint64_t)(BYTES), H5_span_now() - (V))
+#else /* H5_HAVE_SPAN_TRACING */
+#define H5_SPAN_DECL(V)
+#define H5_SPAN_END(V, CLS, SUB, BYTES)
+#endif /* H5_HAVE_SPAN_TRACING */
+
 /* Checksum functions */
 H5_DLL uint32_t H5_checksum_fletcher32(const void *data, size_t len);
 H5_DLL uint32_t H5_checksum_crc(const void *data, size_t len);
 H5_DLL uint32_t H5_checksum_lookup3(const void *data, size_t len, uint32_t initval);
 H5_DLL uint32_t H5_checksum_metadata(const void *data, size_t len, uint32_t initval);
+H5_DLL uint32_t H5_checksum_metadata_fast(const void *data, size_t len, uint32_t initval);
+H5_DLL uint32_t H5_checksum_lookup3_impl(H5_checksum_impl_t impl, const void *data, size_t len, uint32_t initval);
+H5_DLL hbool_t H5_checksum_impl_supported(H5_checksum_impl_t impl);
+H5_DLL const char *H5_checksum_impl_name(H5_checksum_impl_t impl);
 H5_DLL uint32_t H5_hash_string(const char *str);
 
+/* Tracing span routines */
+#ifdef H5_HAVE_SPAN_TRACING
+H5_DLL uint64_t H5_span_now(void);
+H5_DLL void H5_span_record(H5_span_class_t cls, unsigned sub, uint64_t bytes, uint64_t ns);
+H5_DLL herr_t H5_span_get_stats(H5_span_stats_t *stats/*out*/);
+H5_DLL herr_t H5_span_reset(void);
+H5_DLL herr_t H5_span_log(void);
+#endif /* H5_HAVE_SPAN_TRACING */
+
 /* Time related routines */
 H5_DLL time_t H5_make_time(struct tm *tm);
 H5_DLL void H5_nanosleep(uint64_t nanosec);
@@ -0,0 +1,329 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5span.c
+ *
+ * Purpose:		Hot-path tracing spans: call, byte & latency counters
+ *                      with a log2 latency histogram for H5FD_read() /
+ *                      H5FD_write() by memory type and for the metadata
+ *                      cache callbacks by client.
+ *
+ *                      Each thread counts into its own block, so recording
+ *                      a span takes no lock: two clock reads and a few
+ *                      adds.  H5_span_get_stats() sums the blocks of every
+ *                      thread that recorded a span, including threads that
+ *                      have since exited; counts of threads still running
+ *                      may be a few spans behind.
+ *
+ *                      Everything here is only built with
+ *                      H5_HAVE_SPAN_TRACING.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5VMprivate.h"	/* Vectors and arrays			*/
+#include "zf_log.h"             /* Logging                              */
+
+#ifdef H5_HAVE_SPAN_TRACING
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Thread-local storage class */
+#if defined(_MSC_VER)
+#define H5_SPAN_TLS     __declspec(thread)
+#else
+#define H5_SPAN_TLS     __thread
+#endif
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+/* Counters of one thread */
+typedef struct H5_span_block_t {
+    H5_span_stats_t stats;              /* Counters */
+    struct H5_span_block_t *next;       /* Next block of any thread */
+} H5_span_block_t;
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static H5_span_block_t *H5_span_block(void);
+
+
+/*****************************/
+/* Library Private Variables */
+/*****************************/
+
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Names of the span classes, for H5_span_log() */
+static const char *H5_span_class_name_g[H5_SPAN_NCLASSES] = {
+    "fd_read", "fd_write", "cache_deserialize", "cache_serialize", "cache_verify_chksum"
+};
+
+/* Block of the calling thread */
+static H5_SPAN_TLS H5_span_block_t *H5_span_self_s = NULL;
+
+/* Blocks of all threads.  Blocks are only ever added at the front, so the
+ * list past the head can be walked without the lock.
+ */
+static H5_span_block_t *H5_span_head_s = NULL;
+#ifdef H5_HAVE_PTHREAD_H
+static pthread_mutex_t H5_span_mutex_s = PTHREAD_MUTEX_INITIALIZER;
+#endif /* H5_HAVE_PTHREAD_H */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_span_now
+ *
+ * Purpose:     Get the monotonic clock for timing spans.
+ *
+ * Return:      Time in nanoseconds
+ *
+ *-------------------------------------------------------------------------
+ */
+uint64_t
+H5_span_now(void)
+{
+    struct timespec ts;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDclock_gettime(CLOCK_MONOTONIC, &ts);
+
+    FUNC_LEAVE_NOAPI((uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec)
+} /* end H5_span_now() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_span_record
+ *
+ * Purpose:     Count a span of class CLS and subtype SUB (the H5FD_mem_t
+ *              or cache client ID) that moved BYTES bytes in NS ns.
+ *              Spans are dropped if the thread's block can't be allocated.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+void
+H5_span_record(H5_span_class_t cls, unsigned sub, uint64_t bytes, uint64_t ns)
+{
+    H5_span_block_t *block;
+    unsigned bucket;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(cls < H5_SPAN_NCLASSES);
+    HDassert(sub < H5_SPAN_NSUBTYPES);
+
+    if(NULL != (block = H5_span_self_s) || NULL != (block = H5_span_block())) {
+        bucket = ns ? MIN(H5VM_log2_gen(ns) + 1, H5_SPAN_NBUCKETS - 1) : 0;
+
+        block->stats.calls[cls][sub]++;
+        block->stats.bytes[cls][sub] += bytes;
+        block->stats.time_ns[cls][sub] += ns;
+        block->stats.hist[cls][sub][bucket]++;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5_span_record() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_span_get_stats
+ *
+ * Purpose:     Sum the span counters of every thread into STATS.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5_span_get_stats(H5_span_stats_t *stats/*out*/)
+{
+    const H5_span_block_t *block;
+    const uint64_t *src;
+    uint64_t *dst;
+    size_t u, n = sizeof(H5_span_stats_t) / sizeof(uint64_t);
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(stats);
+
+    HDmemset(stats, 0, sizeof(*stats));
+
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_lock(&H5_span_mutex_s);
+#endif /* H5_HAVE_PTHREAD_H */
+    block = H5_span_head_s;
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_unlock(&H5_span_mutex_s);
+#endif /* H5_HAVE_PTHREAD_H */
+
+    /* The stats struct is all uint64_t counters, so sum it flat */
+    dst = (uint64_t *)stats;
+    for(; block; block = block->next) {
+        src = (const uint64_t *)&block->stats;
+        for(u = 0; u < n; u++)
+            dst[u] += src[u];
+    } /* end for */
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5_span_get_stats() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_span_reset
+ *
+ * Purpose:     Zero the span counters of every thread.  Spans recorded by
+ *              other threads while this runs may survive.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5_span_reset(void)
+{
+    H5_span_block_t *block;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_lock(&H5_span_mutex_s);
+#endif /* H5_HAVE_PTHREAD_H */
+    block = H5_span_head_s;
+#ifdef H5_HAVE_PTHREAD_H
+    pthread_mutex_unlock(&H5_span_mutex_s);
+#endif /* H5_HAVE_PTHREAD_H */
+
+    for(; block; block = block->next)
+        HDmemset(&block->stats, 0, sizeof(block->stats));
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5_span_reset() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_span_log
+ *
+ * Purpose:     Write a snapshot of the span counters through zf_log, one
+ *              ZF_LOGI line per class & subtype with any calls: calls,
+ *              bytes, total & mean time, and the upper bounds of the
+ *              latency buckets holding the median & 99th percentile.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5_span_log(void)
+{
+    H5_span_stats_t *stats;
+    unsigned c, s, b;
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Too big for the stack */
+    if(NULL == (stats = (H5_span_stats_t *)HDmalloc(sizeof(*stats))))
+        HGOTO_DONE(FAIL)
+    H5_span_get_stats(stats);
+
+    for(c = 0; c < H5_SPAN_NCLASSES; c++)
+        for(s = 0; s < H5_SPAN_NSUBTYPES; s++) {
+            uint64_t calls = stats->calls[c][s];
+            uint64_t seen = 0;
+            unsigned p50 = H5_SPAN_NBUCKETS, p99 = H5_SPAN_NBUCKETS - 1;
+
+            if(0 == calls)
+                continue;
+
+            for(b = 0; b < H5_SPAN_NBUCKETS; b++) {
+                seen += stats->hist[c][s][b];
+                if(H5_SPAN_NBUCKETS == p50 && seen * 2 >= calls)
+                    p50 = b;
+                if(seen * 100 >= calls * 99) {
+                    p99 = b;
+                    break;
+                } /* end if */
+            } /* end for */
+
+            ZF_LOGI("span %s %u calls %llu bytes %llu time_ns %llu mean_ns %llu p50_ns<%llu p99_ns<%llu",
+                    H5_span_class_name_g[c], s, (unsigned long long)calls,
+                    (unsigned long long)stats->bytes[c][s], (unsigned long long)stats->time_ns[c][s],
+                    (unsigned long long)(stats->time_ns[c][s] / calls),
+                    1ULL << p50, 1ULL << p99);
+        } /* end for */
+
+    HDfree(stats);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5_span_log() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5_span_block
+ *
+ * Purpose:     Create the calling thread's block on its first span.
+ *
+ * Return:      Pointer to the block, or NULL if out of memory
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5_span_block_t *
+H5_span_block(void)
+{
+    H5_span_block_t *block;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Use the system allocator: blocks outlive the library's free lists */
+    if(NULL != (block = (H5_span_block_t *)HDcalloc(1, sizeof(H5_span_block_t)))) {
+#ifdef H5_HAVE_PTHREAD_H
+        pthread_mutex_lock(&H5_span_mutex_s);
+#endif /* H5_HAVE_PTHREAD_H */
+        block->next = H5_span_head_s;
+        H5_span_head_s = block;
+#ifdef H5_HAVE_PTHREAD_H
+        pthread_mutex_unlock(&H5_span_mutex_s);
+#endif /* H5_HAVE_PTHREAD_H */
+        H5_span_self_s = block;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(block)
+} /* end H5_span_block() */
+
+#endif /* H5_HAVE_SPAN_TRACING */
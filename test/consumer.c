@@ -3,31 +3,43 @@
  All rights reserved.
  */
 
-#include <h5s.h>
+#include "h5s.h"
+
+/* Records taken from h5s at a time */
+#define BATCH 16
 
 int main(int argc, const char *argv[])
 {
-    /* Open file in MapR Hadoop FS. */
-    hid_t fid = h5s_open("maprfs://path/to/test.h5s");
+    /* Open file as a reader. */
+    hid_t fid = h5s_open("test.h5s", 0);
     /* Note: It can be any file system (local, http, s3, kafka, etc.). */
            
-    /* Poll interval in nano second. */    
-    int interval = 10;
+    /* Longest wait for new rows in nano seconds, one tick.  h5s_poll()
+     * returns as soon as the writer publishes a tick, when it is on this
+     * host, so this needn't be short. */
+    long interval = 400000000L;
     
     /* The number of records poll() has returned. */    
-    int n = 0;               
+    long n = 0;               
 
-    /* One row of record buffer from spreadsheet.  */
-    int record[1000000];
+    /* Rows of records from spreadsheet, owned by h5s.  */
+    const void *records;
 
-    int i = 0;
+    long i = 0;
     
-    while(true) {
-        if((n = h5s_poll(fid, "/group/dset", interval)) > 0) {
-            for(i = 0; i < n; i++){
-                h5s_read(fid, "/group/dset", &record);
-                /* your_process_function(record); */
-            }
+    if(fid < 0)
+        return -1;
+
+    while(1) {
+        if((n = h5s_poll(fid, "/group/dset", interval)) < 0)
+            break;
+        while(n > 0) {
+            /* Take the records of the last tick with as few reads as
+             * possible. */
+            if((i = h5s_read_view(fid, "/group/dset", &records, BATCH)) <= 0)
+                break;
+            /* your_process_function(records, i); */
+            n -= i;
         }
     }
     return h5s_close(fid);    
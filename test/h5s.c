@@ -0,0 +1,1219 @@
+/*
+ Copyright (C) 2018 Akadio, Inc.
+ All rights reserved.
+ */
+
+/*
+ * h5s on the public API with VFD SWMR, and the library's tick notification
+ * channel for readers on the writer's host; see h5s.h.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "h5s.h"
+
+#include "H5private.h"
+#include "H5FDprivate.h"
+#include "H5Iprivate.h"
+#include "H5Pprivate.h"
+
+/* Bytes a chunk of rows is made up to */
+#define H5S_CHUNK_NBYTES    (1024 * 1024)
+
+/* Bytes staged by the writer before it appends early */
+#define H5S_STAGE_NBYTES    (64 * 1024 * 1024)
+
+/* An open file */
+typedef struct h5s_file_t {
+    hid_t fid;
+    hbool_t writer;
+    double tick;                /* Tick length in seconds, 0 if not SWMR */
+    char *md_file_path;         /* Reader: metadata file, naming the channel */
+    H5FD_vfd_swmr_notify_t *notify; /* Reader: tick channel, NULL until attached */
+    uint64_t notify_tick;       /* Reader: last tick seen on NOTIFY */
+    struct h5s_file_t *next;
+} h5s_file_t;
+
+/* A dataset in use */
+typedef struct h5s_dset_t {
+    h5s_file_t *file;
+    char *path;
+    hid_t did;
+    hid_t type_id;              /* Memory type of the elements */
+    hsize_t ncols;
+    size_t row_nbytes;
+    hsize_t nrows;              /* Rows in the dataset */
+    hsize_t cursor;             /* Reader: next row to take */
+    unsigned char *stage;       /* Writer: rows not appended yet */
+    size_t nstaged;
+    size_t stage_rows;          /* Rows STAGE holds */
+    double tick_start;          /* Writer: when the rows began staging */
+    size_t tick_rows;           /* Writer: rows staged over the last whole tick */
+    unsigned char *view;        /* Reader: buffer of h5s_read_view() */
+    size_t view_rows;
+    struct h5s_dset_t *next;
+} h5s_dset_t;
+
+static h5s_file_t *h5s_files_g = NULL;
+static h5s_dset_t *h5s_dsets_g = NULL;
+
+static double
+h5s_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static h5s_file_t *
+h5s_find_file(hid_t fid)
+{
+    h5s_file_t *file;
+
+    for(file = h5s_files_g; file; file = file->next)
+        if(file->fid == fid)
+            return file;
+    return NULL;
+}
+
+/* Find dataset PATH of FID, opening it if it isn't in use yet */
+static h5s_dset_t *
+h5s_find_dset(hid_t fid, const char *path)
+{
+    h5s_file_t *file;
+    h5s_dset_t *dset;
+    hid_t sid = -1, ftype_id = -1;
+    hsize_t dims[2];
+
+    for(dset = h5s_dsets_g; dset; dset = dset->next)
+        if(dset->file->fid == fid && !strcmp(dset->path, path))
+            return dset;
+
+    if(NULL == (file = h5s_find_file(fid)))
+        return NULL;
+    if(NULL == (dset = (h5s_dset_t *)calloc(1, sizeof(*dset))))
+        return NULL;
+    dset->did = dset->type_id = -1;
+    dset->file = file;
+    if(NULL == (dset->path = strdup(path)))
+        goto error;
+    if((dset->did = H5Dopen2(fid, path, H5P_DEFAULT)) < 0)
+        goto error;
+    if((sid = H5Dget_space(dset->did)) < 0)
+        goto error;
+    if(H5Sget_simple_extent_ndims(sid) != 2 || H5Sget_simple_extent_dims(sid, dims, NULL) < 0)
+        goto error;
+    if((ftype_id = H5Dget_type(dset->did)) < 0)
+        goto error;
+    if((dset->type_id = H5Tget_native_type(ftype_id, H5T_DIR_DEFAULT)) < 0)
+        goto error;
+    dset->nrows = dims[0];
+    dset->ncols = dims[1];
+    dset->row_nbytes = H5Tget_size(dset->type_id) * (size_t)dims[1];
+    H5Tclose(ftype_id);
+    H5Sclose(sid);
+
+    dset->next = h5s_dsets_g;
+    h5s_dsets_g = dset;
+    return dset;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Tclose(ftype_id);
+        H5Sclose(sid);
+        H5Tclose(dset->type_id);
+        H5Dclose(dset->did);
+    } H5E_END_TRY;
+    free(dset->path);
+    free(dset);
+    return NULL;
+}
+
+/* Append NROWS rows of ROWS to DSET with one extend and one write */
+static herr_t
+h5s_append(h5s_dset_t *dset, const void *rows, size_t nrows)
+{
+    hsize_t dims[2], start[2], count[2];
+    hid_t fsid = -1, msid = -1;
+
+    if(nrows == 0)
+        return 0;
+
+    dims[0] = dset->nrows + nrows;
+    dims[1] = dset->ncols;
+    if(H5Dset_extent(dset->did, dims) < 0)
+        return -1;
+
+    start[0] = dset->nrows;
+    start[1] = 0;
+    count[0] = nrows;
+    count[1] = dset->ncols;
+    if((fsid = H5Dget_space(dset->did)) < 0)
+        goto error;
+    if(H5Sselect_hyperslab(fsid, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        goto error;
+    if((msid = H5Screate_simple(2, count, NULL)) < 0)
+        goto error;
+    if(H5Dwrite(dset->did, dset->type_id, msid, fsid, H5P_DEFAULT, rows) < 0)
+        goto error;
+    H5Sclose(msid);
+    H5Sclose(fsid);
+
+    dset->nrows += nrows;
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(msid);
+        H5Sclose(fsid);
+    } H5E_END_TRY;
+    return -1;
+}
+
+/* Append the staged rows of FILE's datasets whose tick is over by NOW */
+static herr_t
+h5s_append_due(h5s_file_t *file, double now)
+{
+    h5s_dset_t *dset;
+
+    for(dset = h5s_dsets_g; dset; dset = dset->next)
+        if(dset->file == file && dset->nstaged > 0 && now - dset->tick_start >= file->tick) {
+            if(h5s_append(dset, dset->stage, dset->nstaged) < 0)
+                return -1;
+            dset->tick_rows = dset->nstaged;
+            dset->nstaged = 0;
+        }
+
+    return 0;
+}
+
+/* Take up to MAX_ROWS rows from DSET into ROWS */
+static long
+h5s_take(h5s_dset_t *dset, void *rows, size_t max_rows)
+{
+    hsize_t start[2], count[2];
+    hid_t fsid = -1, msid = -1;
+    hsize_t n = dset->nrows - dset->cursor;
+
+    if(n > max_rows)
+        n = max_rows;
+    if(n == 0)
+        return 0;
+
+    start[0] = dset->cursor;
+    start[1] = 0;
+    count[0] = n;
+    count[1] = dset->ncols;
+    if((fsid = H5Dget_space(dset->did)) < 0)
+        goto error;
+    if(H5Sselect_hyperslab(fsid, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        goto error;
+    if((msid = H5Screate_simple(2, count, NULL)) < 0)
+        goto error;
+    if(H5Dread(dset->did, dset->type_id, msid, fsid, H5P_DEFAULT, rows) < 0)
+        goto error;
+    H5Sclose(msid);
+    H5Sclose(fsid);
+
+    dset->cursor += n;
+    return (long)n;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(msid);
+        H5Sclose(fsid);
+    } H5E_END_TRY;
+    return -1;
+}
+
+/* Name of the FAPL property holding h5s_kafka_config_t */
+#define H5S_KAFKA_PROP      "h5s_kafka_config"
+
+#ifdef H5S_HAVE_LIBRDKAFKA
+
+#include <librdkafka/rdkafka.h>
+
+#define H5S_KAFKA_PREFIX    "kafka://"
+
+/* Bytes before the rows of a message: first row, rows, bytes per row */
+#define H5S_KAFKA_HDR_NBYTES    16
+
+/* Messages consumed from the queue per poll, at most */
+#define H5S_KAFKA_POLL_MAX      1024
+
+/* A message of rows not all taken yet */
+typedef struct h5s_kmsg_t {
+    rd_kafka_message_t *msg;
+    size_t nrows;
+    size_t taken;
+    struct h5s_kmsg_t *next;
+} h5s_kmsg_t;
+
+/* A dataset streamed through Kafka */
+typedef struct h5s_kdset_t {
+    char *path;
+    size_t row_nbytes;
+    hsize_t next_row;           /* Writer: row the next write starts at */
+    h5s_kmsg_t *head, *tail;    /* Reader: messages in arrival order */
+    size_t nqueued;             /* Reader: rows not taken */
+    rd_kafka_message_t *viewed; /* Reader: message of the last view */
+    struct h5s_kdset_t *next;
+} h5s_kdset_t;
+
+/* Offsets of a partition assigned to a reader */
+typedef struct h5s_kpart_t {
+    int32_t partition;
+    int64_t seen;               /* Offset after the last message consumed */
+    int64_t committed;          /* Offset last committed */
+} h5s_kpart_t;
+
+/* A topic opened by h5s */
+typedef struct h5s_kafka_t {
+    rd_kafka_t *rk;
+    char *topic;
+    hbool_t writer;
+    int failed;                 /* Writer: messages the brokers didn't take */
+    double tick;                /* Reader: seconds between commits */
+    double committed_at;
+    h5s_kpart_t *parts;
+    size_t nparts;
+    h5s_kdset_t *dsets;
+} h5s_kafka_t;
+
+static H5I_type_t h5s_kafka_type_g = H5I_BADID;
+
+static h5s_kafka_t *
+h5s_kafka_find(hid_t fid)
+{
+    if(h5s_kafka_type_g == H5I_BADID || H5Iget_type(fid) != h5s_kafka_type_g)
+        return NULL;
+    return (h5s_kafka_t *)H5Iobject_verify(fid, h5s_kafka_type_g);
+}
+
+static h5s_kdset_t *
+h5s_kafka_dset(h5s_kafka_t *k, const char *path, size_t len, hbool_t create)
+{
+    h5s_kdset_t *d;
+
+    for(d = k->dsets; d; d = d->next)
+        if(strlen(d->path) == len && !strncmp(d->path, path, len))
+            return d;
+    if(!create)
+        return NULL;
+
+    if(NULL == (d = (h5s_kdset_t *)calloc(1, sizeof(*d))))
+        return NULL;
+    if(NULL == (d->path = strndup(path, len))) {
+        free(d);
+        return NULL;
+    }
+    d->next = k->dsets;
+    k->dsets = d;
+    return d;
+}
+
+static h5s_kpart_t *
+h5s_kafka_part(h5s_kafka_t *k, int32_t partition)
+{
+    h5s_kpart_t *parts;
+    size_t u;
+
+    for(u = 0; u < k->nparts; u++)
+        if(k->parts[u].partition == partition)
+            return &k->parts[u];
+
+    if(NULL == (parts = (h5s_kpart_t *)realloc(k->parts, (k->nparts + 1) * sizeof(*parts))))
+        return NULL;
+    k->parts = parts;
+    parts[k->nparts].partition = partition;
+    parts[k->nparts].seen = parts[k->nparts].committed = RD_KAFKA_OFFSET_INVALID;
+    return &parts[k->nparts++];
+}
+
+/* Commit, for each partition in REVOKED or for all if it's NULL, the offset
+ * of the first message with rows not taken yet */
+static herr_t
+h5s_kafka_commit(h5s_kafka_t *k, const rd_kafka_topic_partition_list_t *revoked, hbool_t sync)
+{
+    rd_kafka_topic_partition_list_t *list;
+    rd_kafka_resp_err_t err = RD_KAFKA_RESP_ERR_NO_ERROR;
+    size_t u;
+
+    if(NULL == (list = rd_kafka_topic_partition_list_new((int)k->nparts)))
+        return -1;
+
+    for(u = 0; u < k->nparts; u++) {
+        h5s_kpart_t *part = &k->parts[u];
+        int64_t done = part->seen;
+        h5s_kdset_t *d;
+        h5s_kmsg_t *m;
+
+        if(revoked && !rd_kafka_topic_partition_list_find(revoked, k->topic, part->partition))
+            continue;
+        for(d = k->dsets; d; d = d->next)
+            for(m = d->head; m; m = m->next)
+                if(m->msg->partition == part->partition && m->msg->offset < done)
+                    done = m->msg->offset;
+        if(done != RD_KAFKA_OFFSET_INVALID && done != part->committed) {
+            rd_kafka_topic_partition_list_add(list, k->topic, part->partition)->offset = done;
+            part->committed = done;
+        }
+    }
+
+    if(list->cnt > 0)
+        err = rd_kafka_commit(k->rk, list, !sync);
+    rd_kafka_topic_partition_list_destroy(list);
+    k->committed_at = h5s_now();
+
+    return err == RD_KAFKA_RESP_ERR_NO_ERROR ? 0 : -1;
+}
+
+/* Drop the rows, and forget the offsets, of the partitions in REVOKED: the
+ * reader they go to next starts over from the last commit */
+static void
+h5s_kafka_drop(h5s_kafka_t *k, const rd_kafka_topic_partition_list_t *revoked)
+{
+    h5s_kdset_t *d;
+    size_t u, v;
+
+    for(d = k->dsets; d; d = d->next) {
+        h5s_kmsg_t **mp = &d->head, *m;
+
+        d->tail = NULL;
+        while(NULL != (m = *mp))
+            if(rd_kafka_topic_partition_list_find(revoked, k->topic, m->msg->partition)) {
+                *mp = m->next;
+                d->nqueued -= m->nrows - m->taken;
+                rd_kafka_message_destroy(m->msg);
+                free(m);
+            }
+            else {
+                d->tail = m;
+                mp = &m->next;
+            }
+    }
+
+    for(u = v = 0; u < k->nparts; u++)
+        if(!rd_kafka_topic_partition_list_find(revoked, k->topic, k->parts[u].partition))
+            k->parts[v++] = k->parts[u];
+    k->nparts = v;
+}
+
+static void
+h5s_kafka_rebalance(rd_kafka_t *rk, rd_kafka_resp_err_t err, rd_kafka_topic_partition_list_t *partitions,
+    void *opaque)
+{
+    h5s_kafka_t *k = (h5s_kafka_t *)opaque;
+
+    if(err == RD_KAFKA_RESP_ERR__ASSIGN_PARTITIONS)
+        rd_kafka_assign(rk, partitions);
+    else {
+        if(err == RD_KAFKA_RESP_ERR__REVOKE_PARTITIONS)
+            h5s_kafka_commit(k, partitions, 1);
+        h5s_kafka_drop(k, partitions);
+        rd_kafka_assign(rk, NULL);
+    }
+}
+
+static void
+h5s_kafka_delivered(rd_kafka_t *rk, const rd_kafka_message_t *msg, void *opaque)
+{
+    (void)rk;
+
+    if(msg->err)
+        ((h5s_kafka_t *)opaque)->failed++;
+}
+
+static void
+h5s_kafka_encode(unsigned char *p, uint64_t n, unsigned nbytes)
+{
+    unsigned u;
+
+    for(u = 0; u < nbytes; u++, n >>= 8)
+        p[u] = (unsigned char)(n & 0xff);
+}
+
+static uint64_t
+h5s_kafka_decode(const unsigned char *p, unsigned nbytes)
+{
+    uint64_t n = 0;
+
+    while(nbytes-- > 0)
+        n = (n << 8) | p[nbytes];
+    return n;
+}
+
+/* Queue the rows of MSG, or drop it if it isn't a message of rows */
+static herr_t
+h5s_kafka_queue(h5s_kafka_t *k, rd_kafka_message_t *msg)
+{
+    const unsigned char *hdr = (const unsigned char *)msg->payload;
+    const char *key = (const char *)msg->key;
+    const char *hash = NULL;
+    h5s_kpart_t *part;
+    h5s_kdset_t *d;
+    h5s_kmsg_t *m;
+    size_t nrows, row_nbytes, u;
+
+    if(NULL == (part = h5s_kafka_part(k, msg->partition))) {
+        rd_kafka_message_destroy(msg);
+        return -1;
+    }
+    part->seen = msg->offset + 1;
+
+    for(u = 0; key && u < msg->key_len; u++)
+        if(key[u] == '#')
+            hash = key + u;
+    if(NULL == hash || msg->len < H5S_KAFKA_HDR_NBYTES)
+        goto drop;
+    nrows = (size_t)h5s_kafka_decode(hdr + 8, 4);
+    row_nbytes = (size_t)h5s_kafka_decode(hdr + 12, 4);
+    if(nrows == 0 || msg->len != H5S_KAFKA_HDR_NBYTES + nrows * row_nbytes)
+        goto drop;
+
+    if(NULL == (d = h5s_kafka_dset(k, key, (size_t)(hash - key), 1)))
+        goto error;
+    if(d->row_nbytes == 0)
+        d->row_nbytes = row_nbytes;
+    else if(d->row_nbytes != row_nbytes)
+        goto drop;
+
+    if(NULL == (m = (h5s_kmsg_t *)calloc(1, sizeof(*m))))
+        goto error;
+    m->msg = msg;
+    m->nrows = nrows;
+    if(d->tail)
+        d->tail->next = m;
+    else
+        d->head = m;
+    d->tail = m;
+    d->nqueued += nrows;
+    return 0;
+
+drop:
+    rd_kafka_message_destroy(msg);
+    return 0;
+
+error:
+    rd_kafka_message_destroy(msg);
+    return -1;
+}
+
+/* Take the next N rows of D's head message, copying them to COPY, or only
+ * returning where they are if it's NULL.  The message is dropped once all
+ * of its rows are taken, but a viewed one is kept until the next call. */
+static const void *
+h5s_kafka_take(h5s_kdset_t *d, size_t n, void *copy)
+{
+    h5s_kmsg_t *m = d->head;
+    const unsigned char *rows = (const unsigned char *)m->msg->payload + H5S_KAFKA_HDR_NBYTES
+            + m->taken * d->row_nbytes;
+
+    if(copy)
+        memcpy(copy, rows, n * d->row_nbytes);
+    m->taken += n;
+    d->nqueued -= n;
+    if(m->taken == m->nrows) {
+        if(NULL == (d->head = m->next))
+            d->tail = NULL;
+        if(copy)
+            rd_kafka_message_destroy(m->msg);
+        else
+            d->viewed = m->msg;
+        free(m);
+    }
+    return copy ? copy : rows;
+}
+
+static int
+h5s_kafka_set(rd_kafka_conf_t *conf, const char *name, const char *value)
+{
+    char errstr[256];
+
+    return rd_kafka_conf_set(conf, name, value, errstr, sizeof(errstr)) == RD_KAFKA_CONF_OK ? 0 : -1;
+}
+
+static hid_t
+h5s_kafka_open(const char *name, hbool_t writer, hid_t fapl)
+{
+    h5s_kafka_config_t config;
+    rd_kafka_conf_t *conf = NULL;
+    h5s_kafka_t *k = NULL;
+    const char *brokers = name + strlen(H5S_KAFKA_PREFIX);
+    const char *slash = strchr(brokers, '/');
+    char *servers = NULL;
+    char errstr[256], value[64];
+    hid_t fid;
+
+    if(NULL == slash || slash == brokers || slash[1] == '\0')
+        return -1;
+    if(h5s_get_kafka(fapl, &config) < 0)
+        return -1;
+    if(h5s_kafka_type_g == H5I_BADID && (h5s_kafka_type_g = H5Iregister_type(64, 0, NULL)) < 0)
+        return -1;
+
+    if(NULL == (k = (h5s_kafka_t *)calloc(1, sizeof(*k))))
+        return -1;
+    k->writer = writer;
+    k->tick = config.tick_len / 10.0;
+    k->committed_at = h5s_now();
+    if(NULL == (k->topic = strdup(slash + 1)) || NULL == (servers = strndup(brokers, (size_t)(slash - brokers))))
+        goto error;
+
+    if(NULL == (conf = rd_kafka_conf_new()))
+        goto error;
+    rd_kafka_conf_set_opaque(conf, k);
+    if(h5s_kafka_set(conf, "bootstrap.servers", servers) < 0)
+        goto error;
+    if(writer) {
+        snprintf(value, sizeof(value), "%d", config.linger_ms);
+        if(h5s_kafka_set(conf, "linger.ms", value) < 0)
+            goto error;
+        snprintf(value, sizeof(value), "%d", config.batch_nbytes);
+        if(h5s_kafka_set(conf, "batch.size", value) < 0)
+            goto error;
+        if(h5s_kafka_set(conf, "compression.codec", config.compression) < 0)
+            goto error;
+        rd_kafka_conf_set_dr_msg_cb(conf, h5s_kafka_delivered);
+    }
+    else {
+        /* Offsets are committed by h5s, for the rows taken */
+        if(h5s_kafka_set(conf, "group.id", config.group_id) < 0)
+            goto error;
+        if(h5s_kafka_set(conf, "enable.auto.commit", "false") < 0)
+            goto error;
+        if(h5s_kafka_set(conf, "auto.offset.reset", "earliest") < 0)
+            goto error;
+        rd_kafka_conf_set_rebalance_cb(conf, h5s_kafka_rebalance);
+    }
+
+    if(NULL == (k->rk = rd_kafka_new(writer ? RD_KAFKA_PRODUCER : RD_KAFKA_CONSUMER, conf, errstr, sizeof(errstr))))
+        goto error;
+    conf = NULL;
+
+    if(!writer) {
+        rd_kafka_topic_partition_list_t *topics;
+        rd_kafka_resp_err_t err;
+
+        rd_kafka_poll_set_consumer(k->rk);
+        if(NULL == (topics = rd_kafka_topic_partition_list_new(1)))
+            goto error;
+        rd_kafka_topic_partition_list_add(topics, k->topic, RD_KAFKA_PARTITION_UA);
+        err = rd_kafka_subscribe(k->rk, topics);
+        rd_kafka_topic_partition_list_destroy(topics);
+        if(err != RD_KAFKA_RESP_ERR_NO_ERROR)
+            goto error;
+    }
+
+    if((fid = H5Iregister(h5s_kafka_type_g, k)) < 0)
+        goto error;
+    free(servers);
+    return fid;
+
+error:
+    if(conf)
+        rd_kafka_conf_destroy(conf);
+    if(k->rk)
+        rd_kafka_destroy(k->rk);
+    free(servers);
+    free(k->topic);
+    free(k);
+    return -1;
+}
+
+static herr_t
+h5s_kafka_close(hid_t fid, h5s_kafka_t *k)
+{
+    herr_t ret_value = 0;
+
+    if(k->writer) {
+        if(rd_kafka_flush(k->rk, 60 * 1000) != RD_KAFKA_RESP_ERR_NO_ERROR || k->failed)
+            ret_value = -1;
+    }
+    else {
+        if(h5s_kafka_commit(k, NULL, 1) < 0)
+            ret_value = -1;
+        rd_kafka_consumer_close(k->rk);
+    }
+
+    while(k->dsets) {
+        h5s_kdset_t *d = k->dsets;
+
+        while(d->head) {
+            h5s_kmsg_t *m = d->head;
+
+            d->head = m->next;
+            rd_kafka_message_destroy(m->msg);
+            free(m);
+        }
+        if(d->viewed)
+            rd_kafka_message_destroy(d->viewed);
+        k->dsets = d->next;
+        free(d->path);
+        free(d);
+    }
+    rd_kafka_destroy(k->rk);
+    H5Iremove_verify(fid, h5s_kafka_type_g);
+    free(k->parts);
+    free(k->topic);
+    free(k);
+
+    return ret_value;
+}
+
+static herr_t
+h5s_kafka_write(h5s_kafka_t *k, const char *path, const void *rows, size_t nrows)
+{
+    h5s_kdset_t *d;
+    unsigned char *payload;
+    size_t nbytes;
+    char key[1024];
+    rd_kafka_resp_err_t err;
+
+    if(!k->writer || NULL == (d = h5s_kafka_dset(k, path, strlen(path), 0)))
+        return -1;
+    if(nrows == 0)
+        return 0;
+
+    nbytes = H5S_KAFKA_HDR_NBYTES + nrows * d->row_nbytes;
+    if(NULL == (payload = (unsigned char *)malloc(nbytes)))
+        return -1;
+    h5s_kafka_encode(payload, d->next_row, 8);
+    h5s_kafka_encode(payload + 8, nrows, 4);
+    h5s_kafka_encode(payload + 12, d->row_nbytes, 4);
+    memcpy(payload + H5S_KAFKA_HDR_NBYTES, rows, nrows * d->row_nbytes);
+    snprintf(key, sizeof(key), "%s#%llu", path, (unsigned long long)d->next_row);
+
+    /* Wait for the brokers while the producer's queue is full */
+    while(RD_KAFKA_RESP_ERR__QUEUE_FULL == (err = rd_kafka_producev(k->rk,
+            RD_KAFKA_V_TOPIC(k->topic), RD_KAFKA_V_KEY(key, strlen(key)),
+            RD_KAFKA_V_VALUE(payload, nbytes), RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_FREE),
+            RD_KAFKA_V_END)))
+        rd_kafka_poll(k->rk, 100);
+    if(err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        free(payload);
+        return -1;
+    }
+    d->next_row += nrows;
+
+    rd_kafka_poll(k->rk, 0);
+    return k->failed ? -1 : 0;
+}
+
+static long
+h5s_kafka_poll(h5s_kafka_t *k, const char *path, long interval)
+{
+    h5s_kdset_t *d;
+    int timeout_ms, n;
+
+    if(k->writer || NULL == (d = h5s_kafka_dset(k, path, strlen(path), 1)))
+        return -1;
+
+    timeout_ms = d->nqueued ? 0 : (int)((interval + 999999) / 1000000);
+    for(n = 0; n < H5S_KAFKA_POLL_MAX; n++) {
+        rd_kafka_message_t *msg;
+
+        if(NULL == (msg = rd_kafka_consumer_poll(k->rk, timeout_ms)))
+            break;
+        timeout_ms = 0;
+        if(msg->err) {
+            rd_kafka_message_destroy(msg);
+            continue;
+        }
+        if(h5s_kafka_queue(k, msg) < 0)
+            return -1;
+    }
+
+    if(h5s_now() - k->committed_at >= k->tick && h5s_kafka_commit(k, NULL, 0) < 0)
+        return -1;
+
+    return (long)d->nqueued;
+}
+
+static long
+h5s_kafka_read(h5s_kafka_t *k, const char *path, void *rows, size_t max_rows)
+{
+    h5s_kdset_t *d;
+    size_t taken = 0;
+
+    if(k->writer || NULL == (d = h5s_kafka_dset(k, path, strlen(path), 0)))
+        return k->writer ? -1 : 0;
+
+    while(taken < max_rows && d->head) {
+        size_t n = d->head->nrows - d->head->taken;
+
+        if(n > max_rows - taken)
+            n = max_rows - taken;
+        h5s_kafka_take(d, n, (unsigned char *)rows + taken * d->row_nbytes);
+        taken += n;
+    }
+    return (long)taken;
+}
+
+/* Rows are viewed in place, in the payload of the message */
+static long
+h5s_kafka_read_view(h5s_kafka_t *k, const char *path, const void **rows, size_t max_rows)
+{
+    h5s_kdset_t *d;
+    size_t n;
+
+    if(k->writer || NULL == (d = h5s_kafka_dset(k, path, strlen(path), 0)))
+        return k->writer ? -1 : 0;
+
+    if(d->viewed) {
+        rd_kafka_message_destroy(d->viewed);
+        d->viewed = NULL;
+    }
+    if(NULL == d->head || max_rows == 0)
+        return 0;
+
+    n = d->head->nrows - d->head->taken;
+    if(n > max_rows)
+        n = max_rows;
+    *rows = h5s_kafka_take(d, n, NULL);
+    return (long)n;
+}
+
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+herr_t
+h5s_set_kafka(hid_t fapl, const h5s_kafka_config_t *config)
+{
+    h5s_kafka_config_t value = *config;
+    htri_t exists;
+
+    if((exists = H5Pexist(fapl, H5S_KAFKA_PROP)) < 0)
+        return -1;
+    if(exists)
+        return H5Pset(fapl, H5S_KAFKA_PROP, &value);
+    return H5Pinsert2(fapl, H5S_KAFKA_PROP, sizeof(value), &value, NULL, NULL, NULL, NULL, NULL, NULL);
+}
+
+herr_t
+h5s_get_kafka(hid_t fapl, h5s_kafka_config_t *config)
+{
+    htri_t exists = 0;
+
+    if(fapl != H5P_DEFAULT && (exists = H5Pexist(fapl, H5S_KAFKA_PROP)) < 0)
+        return -1;
+    if(exists)
+        return H5Pget(fapl, H5S_KAFKA_PROP, config);
+
+    memset(config, 0, sizeof(*config));
+    strcpy(config->group_id, "h5s");
+    config->tick_len = 4;
+    config->linger_ms = 5;
+    config->batch_nbytes = 1024 * 1024;
+    strcpy(config->compression, "lz4");
+    return 0;
+}
+
+hid_t
+h5s_open(const char *name, hbool_t writer)
+{
+    return h5s_open_fapl(name, writer, H5P_DEFAULT);
+}
+
+hid_t
+h5s_open_fapl(const char *name, hbool_t writer, hid_t fapl_id)
+{
+    H5F_vfd_swmr_config_t config;
+    h5s_file_t *file = NULL;
+    hid_t fapl = -1, fcpl = -1, fid = -1;
+
+#ifdef H5S_HAVE_LIBRDKAFKA
+    if(!strncmp(name, H5S_KAFKA_PREFIX, strlen(H5S_KAFKA_PREFIX)))
+        return h5s_kafka_open(name, writer, fapl_id);
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+    memset(&config, 0, sizeof(config));
+    config.version = H5F__CURR_VFD_SWMR_CONFIG_VERSION;
+    config.tick_len = 4;
+    config.max_lag = 6;
+    config.vfd_swmr_writer = writer;
+    config.md_pages_reserved = 2;
+    snprintf(config.md_file_path, sizeof(config.md_file_path), "%s.md", name);
+
+    if((fapl = fapl_id == H5P_DEFAULT ? H5Pcreate(H5P_FILE_ACCESS) : H5Pcopy(fapl_id)) < 0)
+        goto error;
+    if(H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST) < 0)
+        goto error;
+
+    /* The writer creates the file, with paged allocation for VFD SWMR */
+    if(writer) {
+        H5E_BEGIN_TRY {
+            fid = H5Fopen(name, H5F_ACC_RDONLY, fapl);
+        } H5E_END_TRY;
+        if(fid < 0) {
+            if((fcpl = H5Pcreate(H5P_FILE_CREATE)) < 0)
+                goto error;
+            if(H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, 0, 1) < 0)
+                goto error;
+            if((fid = H5Fcreate(name, H5F_ACC_EXCL, fcpl, fapl)) < 0)
+                goto error;
+            H5Pclose(fcpl);
+            fcpl = -1;
+        }
+        if(H5Fclose(fid) < 0)
+            goto error;
+        fid = -1;
+    }
+
+    if(H5Pset_page_buffer_size(fapl, 4096, 0, 0) < 0)
+        goto error;
+    if(H5Pset_vfd_swmr_config(fapl, &config) < 0)
+        goto error;
+    /* Publish ticks, so readers on this host needn't sleep between polls */
+    if(writer && H5P_set_vfd_swmr_notify((H5P_genplist_t *)H5I_object(fapl), TRUE) < 0)
+        goto error;
+    if((fid = H5Fopen(name, writer ? H5F_ACC_RDWR : H5F_ACC_RDONLY, fapl)) < 0)
+        goto error;
+    H5Pclose(fapl);
+    fapl = -1;
+
+    if(NULL == (file = (h5s_file_t *)calloc(1, sizeof(*file))))
+        goto error;
+    if(!writer && NULL == (file->md_file_path = strdup(config.md_file_path)))
+        goto error;
+    file->fid = fid;
+    file->writer = writer;
+    file->tick = config.tick_len / 10.0;
+    file->next = h5s_files_g;
+    h5s_files_g = file;
+
+    return fid;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Fclose(fid);
+        H5Pclose(fcpl);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+    if(file)
+        free(file);
+    return -1;
+}
+
+herr_t
+h5s_close(hid_t fid)
+{
+    h5s_file_t **filep;
+    h5s_dset_t **dsetp;
+    herr_t ret_value = 0;
+#ifdef H5S_HAVE_LIBRDKAFKA
+    h5s_kafka_t *k;
+
+    if(NULL != (k = h5s_kafka_find(fid)))
+        return h5s_kafka_close(fid, k);
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+    for(dsetp = &h5s_dsets_g; *dsetp;) {
+        h5s_dset_t *dset = *dsetp;
+
+        if(dset->file->fid != fid) {
+            dsetp = &dset->next;
+            continue;
+        }
+        if(dset->nstaged && h5s_append(dset, dset->stage, dset->nstaged) < 0)
+            ret_value = -1;
+        if(H5Tclose(dset->type_id) < 0 || H5Dclose(dset->did) < 0)
+            ret_value = -1;
+        *dsetp = dset->next;
+        free(dset->stage);
+        free(dset->view);
+        free(dset->path);
+        free(dset);
+    }
+
+    for(filep = &h5s_files_g; *filep; filep = &(*filep)->next)
+        if((*filep)->fid == fid) {
+            h5s_file_t *file = *filep;
+
+            *filep = file->next;
+            if(file->notify && H5FD_vfd_swmr_notify_close(file->notify) < 0)
+                ret_value = -1;
+            free(file->md_file_path);
+            free(file);
+            break;
+        }
+
+    if(H5Fclose(fid) < 0)
+        ret_value = -1;
+    return ret_value;
+}
+
+herr_t
+h5s_create(hid_t fid, const char *path, hid_t type_id, hsize_t ncols)
+{
+    hsize_t dims[2] = {0, 0}, maxdims[2] = {H5S_UNLIMITED, 0}, chunk[2];
+    hid_t sid = -1, dcpl = -1, lcpl = -1, did = -1;
+    size_t row_nbytes = H5Tget_size(type_id) * (size_t)ncols;
+#ifdef H5S_HAVE_LIBRDKAFKA
+    h5s_kafka_t *k;
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+    if(row_nbytes == 0)
+        return -1;
+
+#ifdef H5S_HAVE_LIBRDKAFKA
+    /* Readers learn the row size from the messages */
+    if(NULL != (k = h5s_kafka_find(fid))) {
+        h5s_kdset_t *d;
+
+        if(!k->writer || NULL == (d = h5s_kafka_dset(k, path, strlen(path), 1)))
+            return -1;
+        d->row_nbytes = row_nbytes;
+        return 0;
+    }
+#endif /* H5S_HAVE_LIBRDKAFKA */
+    dims[1] = maxdims[1] = chunk[1] = ncols;
+    chunk[0] = row_nbytes < H5S_CHUNK_NBYTES ? H5S_CHUNK_NBYTES / row_nbytes : 1;
+
+    if((sid = H5Screate_simple(2, dims, maxdims)) < 0)
+        goto error;
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        goto error;
+    if(H5Pset_chunk(dcpl, 2, chunk) < 0)
+        goto error;
+    if((lcpl = H5Pcreate(H5P_LINK_CREATE)) < 0)
+        goto error;
+    if(H5Pset_create_intermediate_group(lcpl, 1) < 0)
+        goto error;
+    if((did = H5Dcreate2(fid, path, type_id, sid, lcpl, dcpl, H5P_DEFAULT)) < 0)
+        goto error;
+    H5Dclose(did);
+    H5Pclose(lcpl);
+    H5Pclose(dcpl);
+    H5Sclose(sid);
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(lcpl);
+        H5Pclose(dcpl);
+        H5Sclose(sid);
+    } H5E_END_TRY;
+    return -1;
+}
+
+herr_t
+h5s_write(hid_t fid, const char *path, const void *row)
+{
+    return h5s_write_batch(fid, path, row, 1);
+}
+
+herr_t
+h5s_write_batch(hid_t fid, const char *path, const void *rows, size_t nrows)
+{
+    h5s_dset_t *dset;
+    double now;
+#ifdef H5S_HAVE_LIBRDKAFKA
+    h5s_kafka_t *k;
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+#ifdef H5S_HAVE_LIBRDKAFKA
+    /* The producer batches by itself */
+    if(NULL != (k = h5s_kafka_find(fid)))
+        return h5s_kafka_write(k, path, rows, nrows);
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+    if(NULL == (dset = h5s_find_dset(fid, path)) || !dset->file->writer)
+        return -1;
+
+    /* Without ticks there is nothing to line up with */
+    if(dset->file->tick <= 0.0)
+        return h5s_append(dset, rows, nrows);
+
+    if(dset->stage_rows == 0) {
+        dset->stage_rows = H5S_STAGE_NBYTES / dset->row_nbytes;
+        if(dset->stage_rows == 0)
+            dset->stage_rows = 1;
+    }
+
+    /* Append what was staged, here or in other datasets of the file, if
+     * its tick is over, and what was staged here if the rows don't fit
+     */
+    now = h5s_now();
+    if(h5s_append_due(dset->file, now) < 0)
+        return -1;
+    if(dset->nstaged > 0 && dset->nstaged + nrows > dset->stage_rows) {
+        if(h5s_append(dset, dset->stage, dset->nstaged) < 0)
+            return -1;
+        dset->nstaged = 0;
+    }
+
+    /* Batches as big as the stage, or as a whole tick was, go out as
+     * they are
+     */
+    if(dset->nstaged == 0 && (nrows >= dset->stage_rows
+            || (dset->tick_rows > 0 && nrows >= dset->tick_rows)))
+        return h5s_append(dset, rows, nrows);
+
+    if(NULL == dset->stage)
+        if(NULL == (dset->stage = (unsigned char *)malloc(dset->stage_rows * dset->row_nbytes)))
+            return -1;
+    if(dset->nstaged == 0)
+        dset->tick_start = now;
+    memcpy(dset->stage + dset->nstaged * dset->row_nbytes, rows, nrows * dset->row_nbytes);
+    dset->nstaged += nrows;
+
+    return 0;
+}
+
+herr_t
+h5s_flush(hid_t fid, const char *path)
+{
+    h5s_dset_t *dset;
+#ifdef H5S_HAVE_LIBRDKAFKA
+    h5s_kafka_t *k;
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+#ifdef H5S_HAVE_LIBRDKAFKA
+    if(NULL != (k = h5s_kafka_find(fid)))
+        return k->writer && rd_kafka_flush(k->rk, 60 * 1000) == RD_KAFKA_RESP_ERR_NO_ERROR && !k->failed ? 0 : -1;
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+    if(NULL == (dset = h5s_find_dset(fid, path)) || !dset->file->writer)
+        return -1;
+    if(h5s_append(dset, dset->stage, dset->nstaged) < 0)
+        return -1;
+    dset->nstaged = 0;
+
+    return 0;
+}
+
+/* Reader: wait up to INTERVAL ns for the writer's next tick.  Readers on
+ * the writer's host wake on its tick notification channel (attached once
+ * the writer has created it); others sleep for INTERVAL. */
+static int
+h5s_wait_tick(h5s_file_t *file, long interval)
+{
+    struct timespec ts;
+    uint64_t tick;
+
+    if(!file->notify && H5FD_vfd_swmr_notify_open(file->md_file_path, FALSE, &file->notify) < 0)
+        return -1;
+    if(file->notify) {
+        htri_t published;
+
+        if((published = H5FD_vfd_swmr_notify_wait(file->notify, file->notify_tick,
+                (uint64_t)interval, &tick, NULL, NULL)) < 0)
+            return -1;
+        if(published)
+            file->notify_tick = tick;
+        return 0;
+    }
+
+    ts.tv_sec = interval / 1000000000L;
+    ts.tv_nsec = interval % 1000000000L;
+    nanosleep(&ts, NULL);
+
+    return 0;
+}
+
+long
+h5s_poll(hid_t fid, const char *path, long interval)
+{
+    h5s_dset_t *dset;
+    int pass;
+#ifdef H5S_HAVE_LIBRDKAFKA
+    h5s_kafka_t *k;
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+#ifdef H5S_HAVE_LIBRDKAFKA
+    if(NULL != (k = h5s_kafka_find(fid)))
+        return h5s_kafka_poll(k, path, interval);
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+    if(NULL == (dset = h5s_find_dset(fid, path)))
+        return -1;
+
+    /* The writer polls to keep its deadline while it has nothing to write */
+    if(dset->file->writer)
+        return h5s_append_due(dset->file, h5s_now()) < 0 ? -1 : 0;
+
+    for(pass = 0; pass < 2; pass++) {
+        hsize_t dims[2];
+        hid_t sid;
+
+        if(dset->cursor < dset->nrows)
+            break;
+        if(pass > 0 && interval > 0 && h5s_wait_tick(dset->file, interval) < 0)
+            return -1;
+
+        /* Rows published by the writer show up at the reader's ticks */
+        if(H5Drefresh(dset->did) < 0)
+            return -1;
+        if((sid = H5Dget_space(dset->did)) < 0)
+            return -1;
+        if(H5Sget_simple_extent_dims(sid, dims, NULL) < 0) {
+            H5Sclose(sid);
+            return -1;
+        }
+        H5Sclose(sid);
+        dset->nrows = dims[0];
+    }
+
+    return (long)(dset->nrows - dset->cursor);
+}
+
+herr_t
+h5s_read(hid_t fid, const char *path, void *row)
+{
+    return h5s_read_batch(fid, path, row, 1) == 1 ? 0 : -1;
+}
+
+long
+h5s_read_batch(hid_t fid, const char *path, void *rows, size_t max_rows)
+{
+    h5s_dset_t *dset;
+#ifdef H5S_HAVE_LIBRDKAFKA
+    h5s_kafka_t *k;
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+#ifdef H5S_HAVE_LIBRDKAFKA
+    if(NULL != (k = h5s_kafka_find(fid)))
+        return h5s_kafka_read(k, path, rows, max_rows);
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+    if(NULL == (dset = h5s_find_dset(fid, path)))
+        return -1;
+
+    return h5s_take(dset, rows, max_rows);
+}
+
+long
+h5s_read_view(hid_t fid, const char *path, const void **rows, size_t max_rows)
+{
+    h5s_dset_t *dset;
+    size_t n;
+#ifdef H5S_HAVE_LIBRDKAFKA
+    h5s_kafka_t *k;
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+#ifdef H5S_HAVE_LIBRDKAFKA
+    if(NULL != (k = h5s_kafka_find(fid)))
+        return h5s_kafka_read_view(k, path, rows, max_rows);
+#endif /* H5S_HAVE_LIBRDKAFKA */
+
+    if(NULL == (dset = h5s_find_dset(fid, path)))
+        return -1;
+
+    n = (size_t)(dset->nrows - dset->cursor);
+    if(n > max_rows)
+        n = max_rows;
+    if(n > dset->view_rows) {
+        free(dset->view);
+        dset->view_rows = 0;
+        if(NULL == (dset->view = (unsigned char *)malloc(n * dset->row_nbytes)))
+            return -1;
+        dset->view_rows = n;
+    }
+    *rows = dset->view;
+
+    return h5s_take(dset, dset->view, n);
+}
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2018 Akadio, Inc.
+ All rights reserved.
+ */
+
+/*
+ * h5s: append rows to, and follow, 2d datasets with an unlimited number
+ * of rows in a VFD SWMR file.
+ *
+ * The writer stages the rows given to h5s_write()/h5s_write_batch() and
+ * appends them with one extend-and-write per SWMR tick (tick_len tenths
+ * of a second), so that readers see the rows of a tick together.  Readers
+ * find new rows with h5s_poll() and take them with h5s_read_batch(), or
+ * h5s_read_view() to read straight into a buffer owned by h5s.
+ *
+ * Names of the form kafka://BROKERS/TOPIC stream through Kafka instead,
+ * when h5s is built with H5S_HAVE_LIBRDKAFKA.  Each write becomes one
+ * message keyed by the dataset path and first row, so the rows of a
+ * dataset spread over the topic's partitions, and readers opened with the
+ * same group split the partitions between them.  The producer batches and
+ * compresses messages as set with h5s_set_kafka() on the FAPL given to
+ * h5s_open_fapl(); readers commit the offsets of the rows they have taken
+ * once per tick.
+ */
+
+#ifndef H5S_STREAM_H
+#define H5S_STREAM_H
+
+#include "hdf5.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Kafka settings of a FAPL */
+typedef struct h5s_kafka_config_t {
+    char group_id[256];         /* Readers with the same group split partitions */
+    int tick_len;               /* Readers: tenths of a second between commits */
+    int linger_ms;              /* Writer: time to wait for a batch to fill */
+    int batch_nbytes;           /* Writer: largest batch sent in one request */
+    char compression[16];       /* Writer: "none", "gzip", "snappy", "lz4" or "zstd" */
+} h5s_kafka_config_t;
+
+/* Set or get the Kafka settings of FAPL; the get returns the defaults if
+ * none were set */
+herr_t h5s_set_kafka(hid_t fapl, const h5s_kafka_config_t *config);
+herr_t h5s_get_kafka(hid_t fapl, h5s_kafka_config_t *config);
+
+/* Open NAME as the SWMR writer, creating it if it doesn't exist, or as a
+ * reader */
+hid_t h5s_open(const char *name, hbool_t writer);
+hid_t h5s_open_fapl(const char *name, hbool_t writer, hid_t fapl);
+herr_t h5s_close(hid_t fid);
+
+/* Writer: create dataset PATH of rows of NCOLS elements of TYPE_ID */
+herr_t h5s_create(hid_t fid, const char *path, hid_t type_id, hsize_t ncols);
+
+/* Writer: append one row, or NROWS rows */
+herr_t h5s_write(hid_t fid, const char *path, const void *row);
+herr_t h5s_write_batch(hid_t fid, const char *path, const void *rows, size_t nrows);
+
+/* Writer: append the staged rows now, without waiting for the tick */
+herr_t h5s_flush(hid_t fid, const char *path);
+
+/* Reader: the number of rows not read yet, waiting up to INTERVAL ns
+ * once if there are none; on the writer's host the wait ends at the
+ * writer's next tick.  Writer: append the rows staged for a tick that is
+ * over, and return 0; a writer with nothing to write polls to keep rows
+ * from lingering past their tick */
+long h5s_poll(hid_t fid, const char *path, long interval);
+
+/* Reader: take the next row, or up to MAX_ROWS rows, returning the
+ * number of rows taken */
+herr_t h5s_read(hid_t fid, const char *path, void *row);
+long h5s_read_batch(hid_t fid, const char *path, void *rows, size_t max_rows);
+
+/* Reader: like h5s_read_batch(), but the rows are read into a buffer of
+ * h5s, returned in *ROWS and valid until the next call for PATH */
+long h5s_read_view(hid_t fid, const char *path, const void **rows, size_t max_rows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H5S_STREAM_H */
@@ -0,0 +1,1864 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/***********************************************************
+*
+* Test program:	 hyperslab_spans
+*
+* Tests irregular hyperslab selections, which are kept as span trees,
+* against a map of the elements they should select.
+*
+*************************************************************/
+
+#include "h5test.h"
+
+#include "H5CXprivate.h"        /* API Contexts                         */
+#include "H5Fprivate.h"         /* File access                          */
+#include "H5Iprivate.h"         /* IDs                                  */
+#include "H5Sprivate.h"         /* Dataspaces                           */
+
+#define SPANS_MAX_RANK          3
+#define SPANS_DIM               24
+#define SPANS_NBLOCKS           200
+#define SPANS_MAX_BLOCK         5
+#define SPANS_NREPEAT           20
+#define SPANS_SEED              1179
+
+/* Chunk that selections are mapped to, the same in each dimension */
+#define SPANS_CHUNK_START       8
+#define SPANS_CHUNK_DIM         8
+
+/* Blocks checked for intersection with a selection, and their size */
+#define SPANS_NQUERIES          500
+#define SPANS_MAX_QUERY         8
+
+/* Blocks ANDed with copies of a selection */
+#define SPANS_NANDS             50
+
+/* Batches of hyperslabs, and the selections they are combined with */
+#define SPANS_BATCH_NSLABS      100
+#define SPANS_BATCH_NBASE       30
+
+/* Regular selection for the compact encoding, the same in each dimension */
+#define SPANS_REG_START         1
+#define SPANS_REG_STRIDE        3
+#define SPANS_REG_COUNT         7
+#define SPANS_REG_BLOCK         2
+
+/* Bytes before the length of an encoded version 2 hyperslab selection:
+ * <type (4 bytes)> + <version (4 bytes)> + <flags (1 byte)>
+ */
+#define SPANS_ENC_LEN_OFFSET    9
+
+/* Elements copied at a time by the gather/scatter kernels, fewer than a
+ * row so the copies stop within rows, and the sequences made at a time by
+ * the sequence-list copies
+ */
+#define SPANS_COPY_NELMTS       5
+#define SPANS_COPY_MAXSEQ       4
+
+/* Regular selections checked for their sequence lists, in each rank */
+#define SPANS_SEQ_NSELS         100
+
+/* test routines for span tree selections */
+static unsigned test_span_sharing(void);
+static unsigned test_and_adjust(void);
+static unsigned test_compact_encode(void);
+static unsigned test_select_batch(void);
+static unsigned test_intersect_block(void);
+static unsigned test_copy_regular(void);
+static unsigned test_seq_list_regular(void);
+
+/* Blocks selected, so they can be selected again */
+static hsize_t spans_start_g[SPANS_NBLOCKS][SPANS_MAX_RANK];
+static hsize_t spans_block_g[SPANS_NBLOCKS][SPANS_MAX_RANK];
+
+/* Batch of hyperslabs, packed one hyperslab after another */
+static hsize_t spans_batch_start_g[SPANS_BATCH_NSLABS * SPANS_MAX_RANK];
+static hsize_t spans_batch_stride_g[SPANS_BATCH_NSLABS * SPANS_MAX_RANK];
+static hsize_t spans_batch_count_g[SPANS_BATCH_NSLABS * SPANS_MAX_RANK];
+static hsize_t spans_batch_block_g[SPANS_BATCH_NSLABS * SPANS_MAX_RANK];
+
+static const hsize_t spans_ones_g[SPANS_MAX_RANK] = {1, 1, 1};
+
+
+/*-------------------------------------------------------------------------
+ * Function:    map_npoints()
+ *
+ * Purpose:     Count the elements of a dataspace of RANK dimensions, each
+ *              SPANS_DIM long.
+ *
+ * Return:      # of elements
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+map_npoints(unsigned rank)
+{
+    size_t npoints = 1;
+    unsigned u;
+
+    for(u = 0; u < rank; u++)
+        npoints *= SPANS_DIM;
+
+    return npoints;
+} /* map_npoints() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    map_op()
+ *
+ * Purpose:     Apply a selection operation to one element of a map:
+ *              SELECTED is whether it's selected, IN_B whether it's in
+ *              what is combined with the selection.
+ *
+ * Return:      Whether the element is selected after the operation
+ *
+ *-------------------------------------------------------------------------
+ */
+static uint8_t
+map_op(uint8_t selected, hbool_t in_b, H5S_seloper_t op)
+{
+    switch(op) {
+        case H5S_SELECT_SET:
+            return (uint8_t)in_b;
+        case H5S_SELECT_OR:
+            return (uint8_t)(selected || in_b);
+        case H5S_SELECT_AND:
+            return (uint8_t)(selected && in_b);
+        case H5S_SELECT_XOR:
+            return (uint8_t)(selected != in_b);
+        case H5S_SELECT_NOTB:
+            return (uint8_t)(selected && !in_b);
+        case H5S_SELECT_NOTA:
+            return (uint8_t)(!selected && in_b);
+        default:
+            HDassert(0 && "unknown selection operation");
+    } /* end switch */
+
+    return selected;
+} /* map_op() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    map_select()
+ *
+ * Purpose:     Apply a hyperslab operation to MAP, which holds one byte per
+ *              element of a dataspace of RANK dimensions.  Each byte is
+ *              non-zero if its element is selected.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+map_select(uint8_t *map, unsigned rank, H5S_seloper_t op, const hsize_t *start,
+    const hsize_t *block)
+{
+    size_t npoints = map_npoints(rank);
+    size_t n;
+
+    for(n = 0; n < npoints; n++) {
+        size_t pos = n;
+        hbool_t in_block = TRUE;
+        unsigned u;
+
+        /* The last dimension changes fastest */
+        for(u = rank; u > 0; u--) {
+            hsize_t coord = (hsize_t)(pos % SPANS_DIM);
+
+            if(coord < start[u - 1] || coord >= start[u - 1] + block[u - 1])
+                in_block = FALSE;
+            pos /= SPANS_DIM;
+        } /* end for */
+
+        map[n] = map_op(map[n], in_block, op);
+    } /* end for */
+} /* map_select() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    random_block()
+ *
+ * Purpose:     Pick a block of up to SPANS_MAX_BLOCK elements on a side,
+ *              inside a dataspace of RANK dimensions.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+random_block(unsigned rank, hsize_t *start, hsize_t *block)
+{
+    unsigned u;
+
+    for(u = 0; u < rank; u++) {
+        block[u] = (hsize_t)(HDrandom() % SPANS_MAX_BLOCK) + 1;
+        start[u] = (hsize_t)HDrandom() % (SPANS_DIM - block[u] + 1);
+    } /* end for */
+} /* random_block() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    map_regular()
+ *
+ * Purpose:     OR the blocks of a regular hyperslab into MAP, for a
+ *              dataspace of RANK dimensions.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+map_regular(uint8_t *map, unsigned rank, const hsize_t *start,
+    const hsize_t *stride, const hsize_t *count, const hsize_t *block)
+{
+    size_t npoints = map_npoints(rank);
+    size_t n;
+
+    for(n = 0; n < npoints; n++) {
+        size_t pos = n;
+        hbool_t in_block = TRUE;
+        unsigned u;
+
+        /* The last dimension changes fastest */
+        for(u = rank; u > 0; u--) {
+            hsize_t coord = (hsize_t)(pos % SPANS_DIM);
+
+            /* A single block can be longer than its stride */
+            if(coord < start[u - 1])
+                in_block = FALSE;
+            else if(1 == count[u - 1]) {
+                if(coord - start[u - 1] >= block[u - 1])
+                    in_block = FALSE;
+            } /* end if */
+            else if((coord - start[u - 1]) / stride[u - 1] >= count[u - 1]
+                    || (coord - start[u - 1]) % stride[u - 1] >= block[u - 1])
+                in_block = FALSE;
+            pos /= SPANS_DIM;
+        } /* end for */
+
+        if(in_block)
+            map[n] = 1;
+    } /* end for */
+} /* map_regular() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    random_batch()
+ *
+ * Purpose:     Fill the batch of hyperslabs with NSLABS random ones,
+ *              inside a dataspace of RANK dimensions, and OR them into
+ *              MAP.  Some have two blocks in a dimension.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+random_batch(uint8_t *map, unsigned rank, size_t nslabs)
+{
+    size_t u;
+
+    for(u = 0; u < nslabs; u++) {
+        hsize_t *start = &spans_batch_start_g[u * rank];
+        hsize_t *stride = &spans_batch_stride_g[u * rank];
+        hsize_t *count = &spans_batch_count_g[u * rank];
+        hsize_t *block = &spans_batch_block_g[u * rank];
+        unsigned v;
+
+        random_block(rank, start, block);
+        for(v = 0; v < rank; v++) {
+            stride[v] = block[v] + 1 + (hsize_t)(HDrandom() % 3);
+            if(start[v] + stride[v] + block[v] <= SPANS_DIM && 0 == HDrandom() % 4)
+                count[v] = 2;
+            else
+                count[v] = 1;
+        } /* end for */
+
+        map_regular(map, rank, start, stride, count, block);
+    } /* end for */
+} /* random_batch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    random_regular()
+ *
+ * Purpose:     Pick a regular hyperslab inside a dataspace of RANK
+ *              dimensions.  Some dimensions are selected whole, and some
+ *              have blocks from one edge of the extent to the other, so
+ *              the rows of the selection abut.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+random_regular(unsigned rank, hsize_t *start, hsize_t *stride, hsize_t *count,
+    hsize_t *block)
+{
+    unsigned u;
+
+    for(u = 0; u < rank; u++) {
+        int kind = (int)(HDrandom() % 5);
+
+        if(0 == kind) {
+            start[u] = 0;
+            stride[u] = 1;
+            count[u] = 1;
+            block[u] = SPANS_DIM;
+        } /* end if */
+        else if(1 == kind) {
+            block[u] = (hsize_t)(HDrandom() % SPANS_MAX_BLOCK) + 1;
+            for(stride[u] = block[u] + 1; (SPANS_DIM - block[u]) % stride[u]; stride[u]++)
+                ;
+            count[u] = ((SPANS_DIM - block[u]) / stride[u]) + 1;
+            start[u] = 0;
+        } /* end if */
+        else {
+            block[u] = (hsize_t)(HDrandom() % SPANS_MAX_BLOCK) + 1;
+            stride[u] = block[u] + (hsize_t)(HDrandom() % 4);
+            count[u] = (hsize_t)(HDrandom() % (((SPANS_DIM - block[u]) / stride[u]) + 1)) + 1;
+            start[u] = (hsize_t)HDrandom() % (SPANS_DIM - ((count[u] - 1) * stride[u] + block[u]) + 1);
+        } /* end else */
+    } /* end for */
+} /* random_regular() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    map_intersect()
+ *
+ * Purpose:     Check whether any element of MAP, moved by OFFSET, is in
+ *              the block from START to END.
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+map_intersect(const uint8_t *map, unsigned rank, const hsize_t *start,
+    const hsize_t *end, const hssize_t *offset)
+{
+    size_t npoints = map_npoints(rank);
+    size_t n;
+
+    for(n = 0; n < npoints; n++)
+        if(map[n]) {
+            size_t pos = n;
+            hbool_t in_block = TRUE;
+            unsigned u;
+
+            for(u = rank; u > 0; u--) {
+                hsize_t coord = (hsize_t)((hssize_t)(pos % SPANS_DIM) + offset[u - 1]);
+
+                if(coord < start[u - 1] || coord > end[u - 1])
+                    in_block = FALSE;
+                pos /= SPANS_DIM;
+            } /* end for */
+
+            if(in_block)
+                return TRUE;
+        } /* end if */
+
+    return FALSE;
+} /* map_intersect() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_intersect()
+ *
+ * Purpose:     Check H5S_hyper_intersect_block() on SPACE against MAP,
+ *              moved by OFFSET, for SPANS_NQUERIES random blocks.
+ *
+ * Return:      0 if all the checks match
+ *              1 if one doesn't
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+check_intersect(H5S_t *space, const uint8_t *map, unsigned rank,
+    const hssize_t *offset)
+{
+    hsize_t start[SPANS_MAX_RANK];      /* Start of block */
+    hsize_t end[SPANS_MAX_RANK];        /* End of block */
+    htri_t status;                      /* Intersection found */
+    unsigned q, u;                      /* Local index variables */
+
+    for(q = 0; q < SPANS_NQUERIES; q++) {
+        /* The blocks reach past the extent, where moved elements can be */
+        for(u = 0; u < rank; u++) {
+            start[u] = (hsize_t)(HDrandom() % (SPANS_DIM + SPANS_MAX_QUERY));
+            end[u] = start[u] + (hsize_t)(HDrandom() % SPANS_MAX_QUERY);
+        } /* end for */
+
+        if((status = H5S_hyper_intersect_block(space, start, end)) < 0)
+            FAIL_STACK_ERROR
+        if((status > 0) != map_intersect(map, rank, start, end, offset))
+            TEST_ERROR
+    } /* end for */
+
+    /* A block covering everything */
+    for(u = 0; u < rank; u++) {
+        start[u] = 0;
+        end[u] = 2 * SPANS_DIM;
+    } /* end for */
+    if((status = H5S_hyper_intersect_block(space, start, end)) < 0)
+        FAIL_STACK_ERROR
+    if((status > 0) != map_intersect(map, rank, start, end, offset))
+        TEST_ERROR
+
+    return 0;
+
+error:
+    return 1;
+} /* check_intersect() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    copy_seq()
+ *
+ * Purpose:     Copy up to NELMTS elements of the selection of SPACE, from
+ *              the position of ITER, with sequence lists: into the packed
+ *              buffer TBUF from BUF if GATHER is set, else the other way.
+ *              The number of elements copied is returned in *NCOPIED.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+copy_seq(const H5S_t *space, H5S_sel_iter_t *iter, hbool_t gather,
+    uint8_t *buf, uint8_t *tbuf, size_t nelmts, size_t *ncopied)
+{
+    hsize_t off[SPANS_COPY_MAXSEQ];     /* Offsets of the sequences */
+    size_t len[SPANS_COPY_MAXSEQ];      /* Lengths of the sequences */
+    size_t nseq;                        /* Number of sequences */
+    size_t nelem;                       /* Number of elements in the sequences */
+    size_t u;                           /* Local index variable */
+
+    *ncopied = 0;
+    while(nelmts > 0 && iter->elmt_left > 0) {
+        if(H5S_SELECT_GET_SEQ_LIST(space, 0, iter, (size_t)SPANS_COPY_MAXSEQ, nelmts, &nseq, &nelem, off, len) < 0)
+            FAIL_STACK_ERROR
+        for(u = 0; u < nseq; u++) {
+            if(gather)
+                HDmemcpy(tbuf, buf + off[u], len[u]);
+            else
+                HDmemcpy(buf + off[u], tbuf, len[u]);
+            tbuf += len[u];
+        } /* end for */
+        nelmts -= nelem;
+        *ncopied += nelem;
+    } /* end while */
+
+    return 0;
+
+error:
+    return 1;
+} /* copy_seq() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    copy_mixed()
+ *
+ * Purpose:     Copy the whole selection of SPACE, of NELMTS elements of
+ *              ELEM_SIZE bytes, like copy_seq(), in pieces of
+ *              SPANS_COPY_NELMTS elements.  The pieces are copied by
+ *              H5S_hyper_copy_regular() with kernel HOW and by sequence
+ *              lists in turn, so each resumes the iterator of the other.
+ *
+ * Return:      0 if every piece is copied
+ *              1 if one isn't
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+copy_mixed(const H5S_t *space, H5S_sel_copy_t how, hbool_t gather,
+    size_t elem_size, uint8_t *buf, uint8_t *tbuf, size_t nelmts)
+{
+    H5S_sel_iter_t iter;                /* Selection iterator */
+    hbool_t iter_init = FALSE;          /* Whether the iterator is initialized */
+    size_t ncopied;                     /* Elements copied by one piece */
+    size_t done = 0;                    /* Elements copied so far */
+    unsigned piece;                     /* Index of the piece */
+
+    if(H5S_select_iter_init(&iter, space, elem_size) < 0)
+        FAIL_STACK_ERROR
+    iter_init = TRUE;
+
+    for(piece = 0; done < nelmts; piece++) {
+        if(piece % 2 == 0) {
+            if(H5S_hyper_copy_regular(space, &iter, how, gather, buf, tbuf + (done * elem_size), (size_t)SPANS_COPY_NELMTS, &ncopied) < 0)
+                FAIL_STACK_ERROR
+        } /* end if */
+        else if(copy_seq(space, &iter, gather, buf, tbuf + (done * elem_size), (size_t)SPANS_COPY_NELMTS, &ncopied))
+            TEST_ERROR
+        if(ncopied != MIN(nelmts - done, (size_t)SPANS_COPY_NELMTS))
+            TEST_ERROR
+        done += ncopied;
+        if(iter.elmt_left != (hsize_t)(nelmts - done))
+            TEST_ERROR
+    } /* end for */
+
+    if(H5S_SELECT_ITER_RELEASE(&iter) < 0)
+        FAIL_STACK_ERROR
+
+    return 0;
+
+error:
+    if(iter_init)
+        H5S_SELECT_ITER_RELEASE(&iter);
+
+    return 1;
+} /* copy_mixed() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_copy_unsupported()
+ *
+ * Purpose:     Check that H5S_hyper_copy_regular() copies nothing from
+ *              the selection of SPACE, with elements of ELEM_SIZE bytes,
+ *              and leaves the iterator where it was.
+ *
+ * Return:      0 if nothing was copied
+ *              1 if something was
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+check_copy_unsupported(const H5S_t *space, size_t elem_size, uint8_t *buf,
+    uint8_t *tbuf)
+{
+    H5S_sel_iter_t iter;                /* Selection iterator */
+    hbool_t iter_init = FALSE;          /* Whether the iterator is initialized */
+    hsize_t nleft;                      /* Elements left before the copy */
+    size_t ncopied;                     /* Elements copied */
+
+    if(H5S_select_iter_init(&iter, space, elem_size) < 0)
+        FAIL_STACK_ERROR
+    iter_init = TRUE;
+    nleft = iter.elmt_left;
+
+    if(H5S_hyper_copy_regular(space, &iter, H5S_SEL_COPY_DEFAULT, TRUE, buf, tbuf, (size_t)SPANS_COPY_NELMTS, &ncopied) < 0)
+        FAIL_STACK_ERROR
+    if(ncopied != 0 || iter.elmt_left != nleft)
+        TEST_ERROR
+
+    if(H5S_SELECT_ITER_RELEASE(&iter) < 0)
+        FAIL_STACK_ERROR
+
+    return 0;
+
+error:
+    if(iter_init)
+        H5S_SELECT_ITER_RELEASE(&iter);
+
+    return 1;
+} /* check_copy_unsupported() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_seq_list()
+ *
+ * Purpose:     Check the sequence lists for the selection of SPACE, with
+ *              elements of ELEM_SIZE bytes, against the NRUNS runs of
+ *              contiguous bytes EXP_OFF/EXP_LEN it should select.
+ *              Without LIMITED, one call for all the runs must make them
+ *              exactly, with abutting blocks merged.  With LIMITED, the
+ *              calls are for a few elements or sequences at a time, and
+ *              they must make the runs once the sequences that abut are
+ *              merged.  OFF/LEN hold the sequences made, and SEQ_OFF/
+ *              SEQ_LEN those from each call; all fit NPOINTS sequences.
+ *
+ * Return:      0 if the sequences match
+ *              1 if they don't
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+check_seq_list(const H5S_t *space, size_t elem_size, hbool_t limited,
+    size_t nruns, const hsize_t *exp_off, const size_t *exp_len, hsize_t *off,
+    size_t *len, hsize_t *seq_off, size_t *seq_len)
+{
+    H5S_sel_iter_t iter;                /* Selection iterator */
+    hbool_t iter_init = FALSE;          /* Whether the iterator is initialized */
+    size_t maxseq, maxelem;             /* Limits for a call */
+    size_t nseq, nelem;                 /* Sequences & elements from a call */
+    size_t nmade = 0;                   /* Sequences made */
+    size_t u;                           /* Local index variable */
+
+    if(H5S_select_iter_init(&iter, space, elem_size) < 0)
+        FAIL_STACK_ERROR
+    iter_init = TRUE;
+
+    while(iter.elmt_left > 0) {
+        if(limited) {
+            maxseq = (size_t)(HDrandom() % SPANS_COPY_MAXSEQ) + 1;
+            maxelem = (size_t)(HDrandom() % (2 * SPANS_COPY_NELMTS)) + 1;
+        } /* end if */
+        else {
+            maxseq = nruns;
+            maxelem = (size_t)iter.elmt_left;
+        } /* end else */
+        if(H5S_SELECT_GET_SEQ_LIST(space, 0, &iter, maxseq, maxelem, &nseq, &nelem, seq_off, seq_len) < 0)
+            FAIL_STACK_ERROR
+        if(0 == nseq || nseq > maxseq || 0 == nelem || nelem > maxelem)
+            TEST_ERROR
+        if(!limited && iter.elmt_left > 0)
+            TEST_ERROR
+
+        for(u = 0; u < nseq; u++) {
+            if(limited && nmade > 0 && off[nmade - 1] + len[nmade - 1] == seq_off[u])
+                len[nmade - 1] += seq_len[u];
+            else {
+                if(nmade == nruns)
+                    TEST_ERROR
+                off[nmade] = seq_off[u];
+                len[nmade] = seq_len[u];
+                nmade++;
+            } /* end else */
+        } /* end for */
+    } /* end while */
+
+    if(H5S_SELECT_ITER_RELEASE(&iter) < 0)
+        FAIL_STACK_ERROR
+    iter_init = FALSE;
+
+    if(nmade != nruns)
+        TEST_ERROR
+    for(u = 0; u < nruns; u++)
+        if(off[u] != exp_off[u] || len[u] != exp_len[u])
+            TEST_ERROR
+
+    return 0;
+
+error:
+    if(iter_init)
+        H5S_SELECT_ITER_RELEASE(&iter);
+
+    return 1;
+} /* check_seq_list() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_sel()
+ *
+ * Purpose:     Check that the selection of SID is made of the elements set
+ *              in MAP: the element count must match, and the blocks of
+ *              the selection must cover each element in MAP exactly once.
+ *
+ * Return:      0 if the selection matches
+ *              1 if it doesn't
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+check_sel(hid_t sid, const uint8_t *map, unsigned rank)
+{
+    size_t npoints = map_npoints(rank);
+    uint8_t *seen = NULL;
+    hsize_t *blocks = NULL;
+    hssize_t nblocks;
+    hsize_t nselected = 0;
+    hsize_t b;
+    size_t n;
+
+    for(n = 0; n < npoints; n++)
+        if(map[n])
+            nselected++;
+    if(H5Sget_select_npoints(sid) != (hssize_t)nselected)
+        TEST_ERROR
+    if(nselected == 0)
+        return 0;
+
+    if((nblocks = H5Sget_select_hyper_nblocks(sid)) <= 0)
+        TEST_ERROR
+    if(NULL == (blocks = (hsize_t *)HDmalloc((size_t)nblocks * 2 * rank * sizeof(hsize_t))))
+        TEST_ERROR
+    if(NULL == (seen = (uint8_t *)HDcalloc(npoints, 1)))
+        TEST_ERROR
+    if(H5Sget_select_hyper_blocklist(sid, (hsize_t)0, (hsize_t)nblocks, blocks) < 0)
+        FAIL_STACK_ERROR
+
+    for(b = 0; b < (hsize_t)nblocks; b++) {
+        const hsize_t *lo = &blocks[b * 2 * rank];
+        const hsize_t *hi = lo + rank;
+
+        for(n = 0; n < npoints; n++) {
+            size_t pos = n;
+            hbool_t in_block = TRUE;
+            unsigned u;
+
+            for(u = rank; u > 0; u--) {
+                hsize_t coord = (hsize_t)(pos % SPANS_DIM);
+
+                if(coord < lo[u - 1] || coord > hi[u - 1])
+                    in_block = FALSE;
+                pos /= SPANS_DIM;
+            } /* end for */
+
+            if(in_block) {
+                if(!map[n] || seen[n])
+                    TEST_ERROR
+                seen[n] = 1;
+                nselected--;
+            } /* end if */
+        } /* end for */
+    } /* end for */
+    if(nselected != 0)
+        TEST_ERROR
+
+    HDfree(blocks);
+    HDfree(seen);
+    return 0;
+
+error:
+    HDfree(blocks);
+    HDfree(seen);
+    return 1;
+} /* check_sel() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_and_block()
+ *
+ * Purpose:     Check that ANDing copies of the selection of SPACE, which
+ *              share its span tree, with blocks selects the elements of
+ *              MAP in each block, for SPANS_NANDS random blocks and a
+ *              block holding the whole dataspace, and that the selection
+ *              itself (SID) is unchanged.
+ *
+ * Return:      0 if all the checks match
+ *              1 if one doesn't
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+check_and_block(hid_t sid, const H5S_t *space, const uint8_t *map,
+    unsigned rank)
+{
+    size_t npoints = map_npoints(rank);
+    hsize_t start[SPANS_MAX_RANK];      /* Start of block */
+    hsize_t block[SPANS_MAX_RANK];      /* Size of block */
+    H5S_t *and_space = NULL;            /* Dataspace of the copy */
+    hid_t and_sid = -1;                 /* Copy ANDed with the block */
+    uint8_t *and_map = NULL;            /* Elements that should be selected in the copy */
+    unsigned q, u;                      /* Local index variables */
+
+    if(NULL == (and_map = (uint8_t *)HDmalloc(npoints)))
+        TEST_ERROR
+
+    for(q = 0; q <= SPANS_NANDS; q++) {
+        if(q < SPANS_NANDS)
+            random_block(rank, start, block);
+        else
+            for(u = 0; u < rank; u++) {
+                start[u] = 0;
+                block[u] = SPANS_DIM;
+            } /* end for */
+
+        if(NULL == (and_space = H5S_copy(space, TRUE, TRUE)))
+            FAIL_STACK_ERROR
+        if(H5S_select_hyperslab(and_space, H5S_SELECT_AND, start, NULL, spans_ones_g, block) < 0)
+            FAIL_STACK_ERROR
+        if((and_sid = H5I_register(H5I_DATASPACE, and_space, TRUE)) < 0)
+            FAIL_STACK_ERROR
+        and_space = NULL;
+
+        HDmemcpy(and_map, map, npoints);
+        map_select(and_map, rank, H5S_SELECT_AND, start, block);
+        if(check_sel(and_sid, and_map, rank))
+            TEST_ERROR
+
+        if(H5Sclose(and_sid) < 0)
+            FAIL_STACK_ERROR
+        and_sid = -1;
+    } /* end for */
+
+    if(check_sel(sid, map, rank))
+        TEST_ERROR
+
+    HDfree(and_map);
+    return 0;
+
+error:
+    if(and_space)
+        H5S_close(and_space);
+    H5E_BEGIN_TRY {
+        H5Sclose(and_sid);
+    } H5E_END_TRY;
+    HDfree(and_map);
+    return 1;
+} /* check_and_block() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_span_sharing()
+ *
+ * Purpose:     Verify selections whose span trees share nodes, in 2-D
+ *              and 3-D:
+ *              --a selection built from many OR'ed blocks
+ *              --copies of it, which share its nodes
+ *              --blocks OR'ed into the copies again, which share nodes
+ *                of the trees they are merged with
+ *              --copies outliving the selection they were made from
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_span_sharing(void)
+{
+    hsize_t dims[SPANS_MAX_RANK] = {SPANS_DIM, SPANS_DIM, SPANS_DIM};
+    hid_t sid = -1;                     /* Selection built */
+    hid_t copy1 = -1, copy2 = -1;       /* Copies of it */
+    uint8_t *map = NULL;                /* Elements that should be selected */
+    unsigned rank;                      /* Rank of the selections */
+    unsigned u;                         /* Local index variable */
+
+    TESTING("span tree sharing between selections")
+
+    HDsrandom(SPANS_SEED);
+
+    for(rank = 2; rank <= SPANS_MAX_RANK; rank++) {
+        if(NULL == (map = (uint8_t *)HDcalloc(map_npoints(rank), 1)))
+            TEST_ERROR
+        if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Sselect_none(sid) < 0)
+            FAIL_STACK_ERROR
+
+        /* Build the selection one block at a time */
+        for(u = 0; u < SPANS_NBLOCKS; u++) {
+            random_block(rank, spans_start_g[u], spans_block_g[u]);
+            if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, spans_start_g[u], NULL, spans_ones_g, spans_block_g[u]) < 0)
+                FAIL_STACK_ERROR
+            map_select(map, rank, H5S_SELECT_OR, spans_start_g[u], spans_block_g[u]);
+        } /* end for */
+        if(check_sel(sid, map, rank))
+            TEST_ERROR
+
+        /* Copies select the same elements */
+        if((copy1 = H5Scopy(sid)) < 0)
+            FAIL_STACK_ERROR
+        if((copy2 = H5Scopy(copy1)) < 0)
+            FAIL_STACK_ERROR
+        if(check_sel(copy1, map, rank) || check_sel(copy2, map, rank))
+            TEST_ERROR
+
+        /* Blocks already selected don't change a copy, nor the others */
+        for(u = 0; u < SPANS_NREPEAT; u++)
+            if(H5Sselect_hyperslab(copy1, H5S_SELECT_OR, spans_start_g[u], NULL, spans_ones_g, spans_block_g[u]) < 0)
+                FAIL_STACK_ERROR
+        if(check_sel(copy1, map, rank) || check_sel(sid, map, rank) || check_sel(copy2, map, rank))
+            TEST_ERROR
+
+        /* The copies outlive the original */
+        if(H5Sclose(sid) < 0)
+            FAIL_STACK_ERROR
+        sid = -1;
+        if(check_sel(copy1, map, rank) || check_sel(copy2, map, rank))
+            TEST_ERROR
+
+        /* New blocks change only the copy they go into */
+        for(u = 0; u < SPANS_NREPEAT; u++) {
+            random_block(rank, spans_start_g[u], spans_block_g[u]);
+            if(H5Sselect_hyperslab(copy2, H5S_SELECT_OR, spans_start_g[u], NULL, spans_ones_g, spans_block_g[u]) < 0)
+                FAIL_STACK_ERROR
+        } /* end for */
+        if(check_sel(copy1, map, rank))
+            TEST_ERROR
+        for(u = 0; u < SPANS_NREPEAT; u++)
+            map_select(map, rank, H5S_SELECT_OR, spans_start_g[u], spans_block_g[u]);
+        if(check_sel(copy2, map, rank))
+            TEST_ERROR
+
+        if(H5Sclose(copy1) < 0)
+            FAIL_STACK_ERROR
+        copy1 = -1;
+        if(H5Sclose(copy2) < 0)
+            FAIL_STACK_ERROR
+        copy2 = -1;
+        HDfree(map);
+        map = NULL;
+    } /* end for */
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(sid);
+        H5Sclose(copy1);
+        H5Sclose(copy2);
+    } H5E_END_TRY;
+    HDfree(map);
+
+    return 1;
+} /* test_span_sharing() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_and_adjust()
+ *
+ * Purpose:     Verify that mapping an irregular selection to a chunk, the
+ *              way chunked I/O does, leaves the selection alone, in 2-D
+ *              and 3-D: a copy that shares the selection's tree is ANDed
+ *              with a chunk holding the whole selection, then moved to
+ *              the chunk's origin.  Most rows of the selection cross the
+ *              whole chunk, so their trees match the chunk's.
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_and_adjust(void)
+{
+    hsize_t dims[SPANS_MAX_RANK] = {SPANS_DIM, SPANS_DIM, SPANS_DIM};
+    hsize_t chunk_start[SPANS_MAX_RANK];    /* Start of the chunk */
+    hsize_t chunk_block[SPANS_MAX_RANK];    /* Size of the chunk */
+    hsize_t chunk_end[SPANS_MAX_RANK];  /* End of the chunk */
+    hsize_t start[SPANS_MAX_RANK];      /* Start of each block */
+    hsize_t block[SPANS_MAX_RANK];      /* Size of each block */
+    hid_t sid = -1;                     /* Selection mapped */
+    hid_t chunk_sid = -1;               /* Selection in the chunk */
+    H5S_t *space;                       /* Dataspace of the selection */
+    H5S_t *chunk_space = NULL;          /* Dataspace of the selection in the chunk */
+    uint8_t *map = NULL;                /* Elements that should be selected */
+    uint8_t *chunk_map = NULL;          /* Elements that should be selected in the chunk */
+    size_t npoints;                     /* # of elements in the dataspace */
+    size_t n;                           /* Local index variable */
+    unsigned rank;                      /* Rank of the selections */
+    unsigned u, v;                      /* Local index variables */
+
+    TESTING("chunk mapping of irregular selections")
+
+    for(rank = 2; rank <= SPANS_MAX_RANK; rank++) {
+        npoints = map_npoints(rank);
+        if(NULL == (map = (uint8_t *)HDcalloc(npoints, 1)))
+            TEST_ERROR
+        if(NULL == (chunk_map = (uint8_t *)HDcalloc(npoints, 1)))
+            TEST_ERROR
+        for(u = 0; u < rank; u++) {
+            chunk_start[u] = SPANS_CHUNK_START;
+            chunk_block[u] = SPANS_CHUNK_DIM;
+            chunk_end[u] = (SPANS_CHUNK_START + SPANS_CHUNK_DIM) - 1;
+        } /* end for */
+        if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Sselect_none(sid) < 0)
+            FAIL_STACK_ERROR
+
+        /* Every other row across the chunk, and part of one row between */
+        for(u = 0; u <= SPANS_CHUNK_DIM / 2; u++) {
+            for(v = 0; v < rank; v++) {
+                start[v] = chunk_start[v];
+                block[v] = chunk_block[v];
+            } /* end for */
+            if(u < SPANS_CHUNK_DIM / 2)
+                start[0] = SPANS_CHUNK_START + (2 * u);
+            else {
+                for(v = 1; v < rank; v++) {
+                    start[v] = SPANS_CHUNK_START + 1;
+                    block[v] = 2;
+                } /* end for */
+                start[0] = SPANS_CHUNK_START + 1;
+            } /* end else */
+            block[0] = 1;
+            if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, start, NULL, spans_ones_g, block) < 0)
+                FAIL_STACK_ERROR
+            map_select(map, rank, H5S_SELECT_OR, start, block);
+        } /* end for */
+        if(NULL == (space = (H5S_t *)H5I_object_verify(sid, H5I_DATASPACE)))
+            FAIL_STACK_ERROR
+
+        /* Map the selection to the chunk, after checking they intersect,
+         * which indexes the selection
+         */
+        if(H5S_hyper_intersect_block(space, chunk_start, chunk_end) <= 0)
+            TEST_ERROR
+        if(NULL == (chunk_space = H5S_copy(space, TRUE, TRUE)))
+            FAIL_STACK_ERROR
+        if(H5S_select_hyperslab(chunk_space, H5S_SELECT_AND, chunk_start, NULL, spans_ones_g, chunk_block) < 0)
+            FAIL_STACK_ERROR
+        H5S_SELECT_ADJUST_U(chunk_space, chunk_start);
+        if((chunk_sid = H5I_register(H5I_DATASPACE, chunk_space, TRUE)) < 0)
+            FAIL_STACK_ERROR
+        chunk_space = NULL;
+
+        /* The elements of the selection, moved to the chunk's origin */
+        for(n = 0; n < npoints; n++)
+            if(map[n]) {
+                size_t pos = n;
+                size_t chunk_pos = 0;
+                size_t scale = 1;
+
+                for(u = rank; u > 0; u--) {
+                    chunk_pos += ((pos % SPANS_DIM) - SPANS_CHUNK_START) * scale;
+                    scale *= SPANS_DIM;
+                    pos /= SPANS_DIM;
+                } /* end for */
+                chunk_map[chunk_pos] = 1;
+            } /* end if */
+
+        /* The selection in the chunk moved, and the selection didn't */
+        if(check_sel(chunk_sid, chunk_map, rank))
+            TEST_ERROR
+        if(check_sel(sid, map, rank))
+            TEST_ERROR
+
+        if(H5Sclose(chunk_sid) < 0)
+            FAIL_STACK_ERROR
+        chunk_sid = -1;
+        if(H5Sclose(sid) < 0)
+            FAIL_STACK_ERROR
+        sid = -1;
+        HDfree(map);
+        map = NULL;
+        HDfree(chunk_map);
+        chunk_map = NULL;
+    } /* end for */
+
+    PASSED()
+    return 0;
+
+error:
+    if(chunk_space)
+        H5S_close(chunk_space);
+    H5E_BEGIN_TRY {
+        H5Sclose(chunk_sid);
+        H5Sclose(sid);
+    } H5E_END_TRY;
+    HDfree(map);
+    HDfree(chunk_map);
+
+    return 1;
+} /* test_and_adjust() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_compact_encode()
+ *
+ * Purpose:     Verify the compact encoding of hyperslab selections, for a
+ *              regular and an irregular selection in 2-D and 3-D:
+ *              --the encoded selection fills the size reported for it, and
+ *                is smaller than the list of blocks
+ *              --decoding it selects the same elements
+ *              --every truncation of it fails to decode, without reading
+ *                past its end (the length is fixed up to match), as does
+ *                extra data after it
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_compact_encode(void)
+{
+    hsize_t dims[SPANS_MAX_RANK] = {SPANS_DIM, SPANS_DIM, SPANS_DIM};
+    hsize_t start[SPANS_MAX_RANK];      /* Start of each block */
+    hsize_t block[SPANS_MAX_RANK];      /* Size of each block */
+    hid_t sid = -1;                     /* Selection encoded */
+    hid_t dec_sid = -1;                 /* Selection decoded */
+    H5S_t *space;                       /* Dataspace of the selection encoded */
+    H5S_t *dec_space;                   /* Dataspace of the selection decoded */
+    uint8_t *map = NULL;                /* Elements that should be selected */
+    uint8_t *buf = NULL;                /* Encoded selection */
+    uint8_t *tbuf = NULL;               /* Damaged copy of the encoded selection */
+    uint8_t *p;                         /* Pointer for encoding */
+    const uint8_t *cp;                  /* Pointer for decoding */
+    hssize_t size;                      /* Size of the encoded selection */
+    size_t enc_len;                     /* Length of the selection after the header */
+    size_t cut;                         /* Length of a truncated selection */
+    unsigned regular;                   /* Whether the selection is regular */
+    herr_t ret;                         /* Generic return value */
+    unsigned rank;                      /* Rank of the selections */
+    unsigned u;                         /* Local index variable */
+
+    TESTING("compact encoding of hyperslab selections")
+
+    HDsrandom(SPANS_SEED);
+
+    for(rank = 2; rank <= SPANS_MAX_RANK; rank++)
+        for(regular = 0; regular < 2; regular++) {
+            if(NULL == (map = (uint8_t *)HDcalloc(map_npoints(rank), 1)))
+                TEST_ERROR
+            if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+                FAIL_STACK_ERROR
+            if((dec_sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+                FAIL_STACK_ERROR
+
+            if(regular) {
+                hsize_t stride[SPANS_MAX_RANK], count[SPANS_MAX_RANK];
+                size_t nblocks = 1;
+                size_t b;
+
+                for(u = 0; u < rank; u++) {
+                    start[u] = SPANS_REG_START;
+                    stride[u] = SPANS_REG_STRIDE;
+                    count[u] = SPANS_REG_COUNT;
+                    block[u] = SPANS_REG_BLOCK;
+                    nblocks *= SPANS_REG_COUNT;
+                } /* end for */
+                if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, stride, count, block) < 0)
+                    FAIL_STACK_ERROR
+
+                /* Map each block */
+                for(b = 0; b < nblocks; b++) {
+                    hsize_t bstart[SPANS_MAX_RANK];
+                    size_t rest = b;
+
+                    for(u = rank; u > 0; u--) {
+                        bstart[u - 1] = SPANS_REG_START + SPANS_REG_STRIDE * (hsize_t)(rest % SPANS_REG_COUNT);
+                        rest /= SPANS_REG_COUNT;
+                    } /* end for */
+                    map_select(map, rank, H5S_SELECT_OR, bstart, block);
+                } /* end for */
+            } /* end if */
+            else {
+                if(H5Sselect_none(sid) < 0)
+                    FAIL_STACK_ERROR
+                for(u = 0; u < SPANS_NBLOCKS; u++) {
+                    random_block(rank, start, block);
+                    if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, start, NULL, spans_ones_g, block) < 0)
+                        FAIL_STACK_ERROR
+                    map_select(map, rank, H5S_SELECT_OR, start, block);
+                } /* end for */
+            } /* end else */
+
+            if(NULL == (space = (H5S_t *)H5I_object_verify(sid, H5I_DATASPACE)))
+                FAIL_STACK_ERROR
+            if(NULL == (dec_space = (H5S_t *)H5I_object_verify(dec_sid, H5I_DATASPACE)))
+                FAIL_STACK_ERROR
+
+            /* Encode the selection */
+            if((size = H5S_hyper_serial_size_compact(space)) < 0)
+                FAIL_STACK_ERROR
+            if(size >= H5S_select_serial_size(space))
+                TEST_ERROR
+            if(NULL == (buf = (uint8_t *)HDmalloc((size_t)size)))
+                TEST_ERROR
+            p = buf;
+            if(H5S_hyper_serialize_compact(space, &p) < 0)
+                FAIL_STACK_ERROR
+            if(p != buf + size)
+                TEST_ERROR
+
+            /* Decode it */
+            cp = buf;
+            if(H5S_select_deserialize(&dec_space, &cp) < 0)
+                FAIL_STACK_ERROR
+            if(cp != buf + size)
+                TEST_ERROR
+            if(check_sel(dec_sid, map, rank))
+                TEST_ERROR
+
+            /* Truncated selections, with the length changed to match */
+            enc_len = (size_t)size - (SPANS_ENC_LEN_OFFSET + 8);
+            for(cut = 0; cut < enc_len; cut++) {
+                if(NULL == (tbuf = (uint8_t *)HDmalloc(SPANS_ENC_LEN_OFFSET + 8 + cut)))
+                    TEST_ERROR
+                HDmemcpy(tbuf, buf, SPANS_ENC_LEN_OFFSET + 8 + cut);
+                p = tbuf + SPANS_ENC_LEN_OFFSET;
+                UINT32ENCODE(p, (uint32_t)(4 + cut));
+
+                cp = tbuf;
+                H5E_BEGIN_TRY {
+                    ret = H5S_select_deserialize(&dec_space, &cp);
+                } H5E_END_TRY;
+                if(ret >= 0)
+                    TEST_ERROR
+                HDfree(tbuf);
+                tbuf = NULL;
+            } /* end for */
+
+            /* A byte past the end of the selection */
+            if(NULL == (tbuf = (uint8_t *)HDmalloc((size_t)size + 1)))
+                TEST_ERROR
+            HDmemcpy(tbuf, buf, (size_t)size);
+            tbuf[size] = 0;
+            p = tbuf + SPANS_ENC_LEN_OFFSET;
+            UINT32ENCODE(p, (uint32_t)(4 + enc_len + 1));
+            cp = tbuf;
+            H5E_BEGIN_TRY {
+                ret = H5S_select_deserialize(&dec_space, &cp);
+            } H5E_END_TRY;
+            if(ret >= 0)
+                TEST_ERROR
+            HDfree(tbuf);
+            tbuf = NULL;
+
+            if(H5Sclose(sid) < 0)
+                FAIL_STACK_ERROR
+            sid = -1;
+            if(H5Sclose(dec_sid) < 0)
+                FAIL_STACK_ERROR
+            dec_sid = -1;
+            HDfree(buf);
+            buf = NULL;
+            HDfree(map);
+            map = NULL;
+        } /* end for */
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(sid);
+        H5Sclose(dec_sid);
+    } H5E_END_TRY;
+    HDfree(tbuf);
+    HDfree(buf);
+    HDfree(map);
+
+    return 1;
+} /* test_compact_encode() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_select_batch()
+ *
+ * Purpose:     Verify H5S_select_hyperslabs() in 2-D and 3-D:
+ *              --a batch combined with an irregular selection with each
+ *                set operation
+ *              --with H5S_SELECT_SET and H5S_SELECT_OR, the same selection
+ *                as one H5Sselect_hyperslab() call per hyperslab
+ *              --a 0 stride or an unlimited count fails, and leaves the
+ *                selection alone
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_select_batch(void)
+{
+    const H5S_seloper_t ops[] = {H5S_SELECT_SET, H5S_SELECT_OR, H5S_SELECT_AND,
+            H5S_SELECT_XOR, H5S_SELECT_NOTB, H5S_SELECT_NOTA};
+    hsize_t dims[SPANS_MAX_RANK] = {SPANS_DIM, SPANS_DIM, SPANS_DIM};
+    hsize_t start[SPANS_MAX_RANK];      /* Start of each block */
+    hsize_t block[SPANS_MAX_RANK];      /* Size of each block */
+    hsize_t saved;                      /* Value changed for an error */
+    hid_t sid = -1;                     /* Selection the batch is combined with */
+    hid_t ref_sid = -1;                 /* Selection built one hyperslab at a time */
+    H5S_t *space;                       /* Dataspace of the selection */
+    uint8_t *map = NULL;                /* Elements that should be selected */
+    uint8_t *umap = NULL;               /* Elements of the batch */
+    size_t npoints;                     /* # of elements in the dataspace */
+    size_t n;                           /* Local index variable */
+    herr_t ret;                         /* Generic return value */
+    unsigned rank;                      /* Rank of the selections */
+    unsigned o, u;                      /* Local index variables */
+
+    TESTING("batched hyperslab selection")
+
+    HDsrandom(SPANS_SEED);
+
+    for(rank = 2; rank <= SPANS_MAX_RANK; rank++) {
+        npoints = map_npoints(rank);
+        if(NULL == (map = (uint8_t *)HDcalloc(npoints, 1)))
+            TEST_ERROR
+        if(NULL == (umap = (uint8_t *)HDcalloc(npoints, 1)))
+            TEST_ERROR
+
+        for(o = 0; o < NELMTS(ops); o++) {
+            /* Irregular selection to combine the batch with */
+            if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+                FAIL_STACK_ERROR
+            if(H5Sselect_none(sid) < 0)
+                FAIL_STACK_ERROR
+            HDmemset(map, 0, npoints);
+            for(u = 0; u < SPANS_BATCH_NBASE; u++) {
+                random_block(rank, start, block);
+                if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, start, NULL, spans_ones_g, block) < 0)
+                    FAIL_STACK_ERROR
+                map_select(map, rank, H5S_SELECT_OR, start, block);
+            } /* end for */
+            if((ref_sid = H5Scopy(sid)) < 0)
+                FAIL_STACK_ERROR
+
+            /* Combine the batch */
+            HDmemset(umap, 0, npoints);
+            random_batch(umap, rank, SPANS_BATCH_NSLABS);
+            if(NULL == (space = (H5S_t *)H5I_object_verify(sid, H5I_DATASPACE)))
+                FAIL_STACK_ERROR
+            if(H5S_select_hyperslabs(space, ops[o], SPANS_BATCH_NSLABS, spans_batch_start_g,
+                    spans_batch_stride_g, spans_batch_count_g, spans_batch_block_g) < 0)
+                FAIL_STACK_ERROR
+            for(n = 0; n < npoints; n++)
+                map[n] = map_op(map[n], (hbool_t)umap[n], ops[o]);
+            if(check_sel(sid, map, rank))
+                TEST_ERROR
+
+            /* Build the same selection one hyperslab at a time */
+            if(ops[o] == H5S_SELECT_SET || ops[o] == H5S_SELECT_OR) {
+                for(u = 0; u < SPANS_BATCH_NSLABS; u++)
+                    if(H5Sselect_hyperslab(ref_sid, (u == 0 ? ops[o] : H5S_SELECT_OR),
+                            &spans_batch_start_g[u * rank], &spans_batch_stride_g[u * rank],
+                            &spans_batch_count_g[u * rank], &spans_batch_block_g[u * rank]) < 0)
+                        FAIL_STACK_ERROR
+                if(check_sel(ref_sid, map, rank))
+                    TEST_ERROR
+            } /* end if */
+
+            if(H5Sclose(sid) < 0)
+                FAIL_STACK_ERROR
+            sid = -1;
+            if(H5Sclose(ref_sid) < 0)
+                FAIL_STACK_ERROR
+            ref_sid = -1;
+        } /* end for */
+
+        /* Batches that can't be selected */
+        if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Sselect_none(sid) < 0)
+            FAIL_STACK_ERROR
+        HDmemset(map, 0, npoints);
+        for(u = 0; u < SPANS_BATCH_NBASE; u++) {
+            random_block(rank, start, block);
+            if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, start, NULL, spans_ones_g, block) < 0)
+                FAIL_STACK_ERROR
+            map_select(map, rank, H5S_SELECT_OR, start, block);
+        } /* end for */
+        random_batch(umap, rank, SPANS_BATCH_NSLABS);
+        if(NULL == (space = (H5S_t *)H5I_object_verify(sid, H5I_DATASPACE)))
+            FAIL_STACK_ERROR
+
+        saved = spans_batch_stride_g[(SPANS_BATCH_NSLABS / 2) * rank];
+        spans_batch_stride_g[(SPANS_BATCH_NSLABS / 2) * rank] = 0;
+        H5E_BEGIN_TRY {
+            ret = H5S_select_hyperslabs(space, H5S_SELECT_OR, SPANS_BATCH_NSLABS, spans_batch_start_g,
+                    spans_batch_stride_g, spans_batch_count_g, spans_batch_block_g);
+        } H5E_END_TRY;
+        if(ret >= 0)
+            TEST_ERROR
+        spans_batch_stride_g[(SPANS_BATCH_NSLABS / 2) * rank] = saved;
+
+        saved = spans_batch_count_g[(SPANS_BATCH_NSLABS * rank) - 1];
+        spans_batch_count_g[(SPANS_BATCH_NSLABS * rank) - 1] = H5S_UNLIMITED;
+        H5E_BEGIN_TRY {
+            ret = H5S_select_hyperslabs(space, H5S_SELECT_OR, SPANS_BATCH_NSLABS, spans_batch_start_g,
+                    spans_batch_stride_g, spans_batch_count_g, spans_batch_block_g);
+        } H5E_END_TRY;
+        if(ret >= 0)
+            TEST_ERROR
+        spans_batch_count_g[(SPANS_BATCH_NSLABS * rank) - 1] = saved;
+
+        if(check_sel(sid, map, rank))
+            TEST_ERROR
+        if(H5Sclose(sid) < 0)
+            FAIL_STACK_ERROR
+        sid = -1;
+
+        HDfree(umap);
+        umap = NULL;
+        HDfree(map);
+        map = NULL;
+    } /* end for */
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(sid);
+        H5Sclose(ref_sid);
+    } H5E_END_TRY;
+    HDfree(umap);
+    HDfree(map);
+
+    return 1;
+} /* test_select_batch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_intersect_block()
+ *
+ * Purpose:     Verify H5S_hyper_intersect_block() on irregular selections
+ *              in 2-D and 3-D, which it indexes on first use:
+ *              --random blocks, against a map of the selection
+ *              --the same after the selection offset is normalized into
+ *                the span tree, which the index must follow
+ *              --and after it's denormalized again
+ *              --copies sharing the indexed tree, ANDed with blocks
+ *              --a selection changed by an OR after being indexed
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_intersect_block(void)
+{
+    hsize_t dims[SPANS_MAX_RANK] = {SPANS_DIM, SPANS_DIM, SPANS_DIM};
+    hsize_t start[SPANS_MAX_RANK];      /* Start of each block */
+    hsize_t block[SPANS_MAX_RANK];      /* Size of each block */
+    hssize_t offset[SPANS_MAX_RANK];    /* Selection offset */
+    hssize_t old_offset[SPANS_MAX_RANK];    /* Selection offset, while normalized */
+    const hssize_t zeros[SPANS_MAX_RANK] = {0, 0, 0};
+    hid_t sid = -1;                     /* Selection checked */
+    H5S_t *space;                       /* Dataspace of the selection */
+    uint8_t *map = NULL;                /* Elements that should be selected */
+    htri_t normalized;                  /* Whether the offset was normalized */
+    unsigned rank;                      /* Rank of the selections */
+    unsigned u;                         /* Local index variable */
+
+    TESTING("hyperslab block intersection")
+
+    HDsrandom(SPANS_SEED);
+
+    for(rank = 2; rank <= SPANS_MAX_RANK; rank++) {
+        if(NULL == (map = (uint8_t *)HDcalloc(map_npoints(rank), 1)))
+            TEST_ERROR
+        if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Sselect_none(sid) < 0)
+            FAIL_STACK_ERROR
+        for(u = 0; u < SPANS_NBLOCKS; u++) {
+            random_block(rank, start, block);
+            if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, start, NULL, spans_ones_g, block) < 0)
+                FAIL_STACK_ERROR
+            map_select(map, rank, H5S_SELECT_OR, start, block);
+        } /* end for */
+        if(NULL == (space = (H5S_t *)H5I_object_verify(sid, H5I_DATASPACE)))
+            FAIL_STACK_ERROR
+
+        /* Without an offset */
+        if(check_intersect(space, map, rank, zeros))
+            TEST_ERROR
+
+        /* With an offset, moved into the span tree */
+        for(u = 0; u < rank; u++)
+            offset[u] = 1 + (hssize_t)(HDrandom() % 3);
+        if(H5Soffset_simple(sid, offset) < 0)
+            FAIL_STACK_ERROR
+        if((normalized = H5S_hyper_normalize_offset(space, old_offset)) < 0)
+            FAIL_STACK_ERROR
+        if(!normalized)
+            TEST_ERROR
+        if(check_intersect(space, map, rank, offset))
+            TEST_ERROR
+
+        /* Moved back */
+        if(H5S_hyper_denormalize_offset(space, old_offset) < 0)
+            FAIL_STACK_ERROR
+        if(check_intersect(space, map, rank, zeros))
+            TEST_ERROR
+        if(H5Soffset_simple(sid, zeros) < 0)
+            FAIL_STACK_ERROR
+
+        /* ANDed with blocks */
+        if(check_and_block(sid, space, map, rank))
+            TEST_ERROR
+
+        /* Changed after being indexed */
+        random_block(rank, start, block);
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, start, NULL, spans_ones_g, block) < 0)
+            FAIL_STACK_ERROR
+        map_select(map, rank, H5S_SELECT_OR, start, block);
+        if(check_intersect(space, map, rank, zeros))
+            TEST_ERROR
+
+        if(H5Sclose(sid) < 0)
+            FAIL_STACK_ERROR
+        sid = -1;
+        HDfree(map);
+        map = NULL;
+    } /* end for */
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(sid);
+    } H5E_END_TRY;
+    HDfree(map);
+
+    return 1;
+} /* test_intersect_block() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_copy_regular()
+ *
+ * Purpose:     Verify H5S_hyper_copy_regular() against the sequence-list
+ *              copy, for regular selections in 1-D to 3-D with one
+ *              element per block in the fastest dimension, with and
+ *              without a selection offset:
+ *              --each kernel gathers the elements the sequence lists do,
+ *                for each element size it handles, sharing the iterator
+ *                with the sequence lists
+ *              --scattering them back writes the same buffer
+ *              --it copies nothing for elements of other sizes, for
+ *                blocks of more than one element in the fastest dimension
+ *                and for irregular selections
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_copy_regular(void)
+{
+    hsize_t dims[SPANS_MAX_RANK] = {SPANS_DIM, SPANS_DIM, SPANS_DIM};
+    hsize_t start[SPANS_MAX_RANK];      /* Start of the selection */
+    hsize_t stride[SPANS_MAX_RANK];     /* Stride of the selection */
+    hsize_t count[SPANS_MAX_RANK];      /* Count of the selection */
+    hsize_t block[SPANS_MAX_RANK];      /* Block of the selection */
+    hssize_t offset[SPANS_MAX_RANK];    /* Selection offset */
+    const hsize_t zeros[SPANS_MAX_RANK] = {0, 0, 0};
+    const size_t elem_sizes[] = {1, 2, 4, 8};
+    const H5S_sel_copy_t kernels[] = {H5S_SEL_COPY_DEFAULT, H5S_SEL_COPY_STRIDE, H5S_SEL_COPY_SIMD};
+    H5S_sel_iter_t iter;                /* Iterator for the reference copies */
+    hbool_t iter_init = FALSE;          /* Whether the iterator is initialized */
+    hid_t sid = -1;                     /* Selection copied */
+    H5S_t *space;                       /* Dataspace of the selection */
+    uint8_t *buf = NULL;                /* Buffer for the dataspace */
+    uint8_t *out = NULL;                /* Buffer scattered to */
+    uint8_t *exp_out = NULL;            /* Buffer scattered to by sequence lists */
+    uint8_t *tbuf = NULL;               /* Packed buffer */
+    uint8_t *exp_tbuf = NULL;           /* Packed buffer from sequence lists */
+    size_t npoints;                     /* # of elements in the dataspace */
+    size_t nelmts;                      /* # of elements selected */
+    size_t ncopied;                     /* Elements copied */
+    unsigned rank;                      /* Rank of the selections */
+    unsigned with_offset;               /* Whether the selection is offset */
+    unsigned e, k;                      /* Indices of the element size & kernel */
+    size_t v;                           /* Local index variable */
+    unsigned u;                         /* Local index variable */
+
+    TESTING("regular hyperslab gather/scatter kernels")
+
+    for(rank = 1; rank <= SPANS_MAX_RANK; rank++) {
+        npoints = map_npoints(rank);
+        if(NULL == (buf = (uint8_t *)HDmalloc(npoints * 8)))
+            TEST_ERROR
+        if(NULL == (out = (uint8_t *)HDmalloc(npoints * 8)))
+            TEST_ERROR
+        if(NULL == (exp_out = (uint8_t *)HDmalloc(npoints * 8)))
+            TEST_ERROR
+        if(NULL == (tbuf = (uint8_t *)HDmalloc(npoints * 8)))
+            TEST_ERROR
+        if(NULL == (exp_tbuf = (uint8_t *)HDmalloc(npoints * 8)))
+            TEST_ERROR
+        for(v = 0; v < npoints * 8; v++)
+            buf[v] = (uint8_t)(v % 251);
+
+        for(u = 0; u < rank; u++) {
+            start[u] = SPANS_REG_START;
+            stride[u] = SPANS_REG_STRIDE;
+            count[u] = SPANS_REG_COUNT;
+            block[u] = (u == rank - 1) ? 1 : SPANS_REG_BLOCK;
+        } /* end for */
+        if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, stride, count, block) < 0)
+            FAIL_STACK_ERROR
+        if(NULL == (space = (H5S_t *)H5I_object_verify(sid, H5I_DATASPACE)))
+            FAIL_STACK_ERROR
+        nelmts = (size_t)H5S_GET_SELECT_NPOINTS(space);
+
+        for(with_offset = 0; with_offset < 2; with_offset++) {
+            for(u = 0; u < rank; u++)
+                offset[u] = with_offset ? (hssize_t)(u + 1) : 0;
+            if(H5Soffset_simple(sid, offset) < 0)
+                FAIL_STACK_ERROR
+
+            for(e = 0; e < NELMTS(elem_sizes); e++) {
+                size_t elem_size = elem_sizes[e];
+
+                /* Gather & scatter with sequence lists */
+                HDmemset(exp_out, 0, npoints * elem_size);
+                if(H5S_select_iter_init(&iter, space, elem_size) < 0)
+                    FAIL_STACK_ERROR
+                iter_init = TRUE;
+                if(copy_seq(space, &iter, TRUE, buf, exp_tbuf, nelmts, &ncopied))
+                    TEST_ERROR
+                if(ncopied != nelmts)
+                    TEST_ERROR
+                if(H5S_SELECT_ITER_RELEASE(&iter) < 0)
+                    FAIL_STACK_ERROR
+                if(H5S_select_iter_init(&iter, space, elem_size) < 0)
+                    FAIL_STACK_ERROR
+                if(copy_seq(space, &iter, FALSE, exp_out, exp_tbuf, nelmts, &ncopied))
+                    TEST_ERROR
+                if(H5S_SELECT_ITER_RELEASE(&iter) < 0)
+                    FAIL_STACK_ERROR
+                iter_init = FALSE;
+
+                /* Each kernel must match them */
+                for(k = 0; k < NELMTS(kernels); k++) {
+                    HDmemset(tbuf, 0, nelmts * elem_size);
+                    if(copy_mixed(space, kernels[k], TRUE, elem_size, buf, tbuf, nelmts))
+                        TEST_ERROR
+                    if(HDmemcmp(tbuf, exp_tbuf, nelmts * elem_size))
+                        TEST_ERROR
+
+                    HDmemset(out, 0, npoints * elem_size);
+                    if(copy_mixed(space, kernels[k], FALSE, elem_size, out, tbuf, nelmts))
+                        TEST_ERROR
+                    if(HDmemcmp(out, exp_out, npoints * elem_size))
+                        TEST_ERROR
+                } /* end for */
+            } /* end for */
+        } /* end for */
+        for(u = 0; u < rank; u++)
+            offset[u] = 0;
+        if(H5Soffset_simple(sid, offset) < 0)
+            FAIL_STACK_ERROR
+
+        /* Elements of a size without a kernel */
+        if(check_copy_unsupported(space, (size_t)3, buf, tbuf))
+            TEST_ERROR
+
+        /* Blocks in the fastest dimension */
+        block[rank - 1] = SPANS_REG_BLOCK;
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, stride, count, block) < 0)
+            FAIL_STACK_ERROR
+        if(check_copy_unsupported(space, (size_t)4, buf, tbuf))
+            TEST_ERROR
+
+        /* An irregular selection */
+        block[rank - 1] = 1;
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, stride, count, block) < 0)
+            FAIL_STACK_ERROR
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_OR, zeros, NULL, spans_ones_g, spans_ones_g) < 0)
+            FAIL_STACK_ERROR
+        if(check_copy_unsupported(space, (size_t)4, buf, tbuf))
+            TEST_ERROR
+
+        if(H5Sclose(sid) < 0)
+            FAIL_STACK_ERROR
+        sid = -1;
+        HDfree(buf);
+        buf = NULL;
+        HDfree(out);
+        out = NULL;
+        HDfree(exp_out);
+        exp_out = NULL;
+        HDfree(tbuf);
+        tbuf = NULL;
+        HDfree(exp_tbuf);
+        exp_tbuf = NULL;
+    } /* end for */
+
+    PASSED()
+    return 0;
+
+error:
+    if(iter_init)
+        H5S_SELECT_ITER_RELEASE(&iter);
+    H5E_BEGIN_TRY {
+        H5Sclose(sid);
+    } H5E_END_TRY;
+    HDfree(buf);
+    HDfree(out);
+    HDfree(exp_out);
+    HDfree(tbuf);
+    HDfree(exp_tbuf);
+
+    return 1;
+} /* test_copy_regular() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_seq_list_regular()
+ *
+ * Purpose:     Verify the sequence lists for random regular selections
+ *              in 1-D to 3-D, which take the low-rank path, against a map
+ *              of the selection:
+ *              --one call makes the runs of contiguous elements, one
+ *                sequence each, also where rows abut
+ *              --calls for a few elements or sequences at a time resume
+ *                where the last one stopped
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_seq_list_regular(void)
+{
+    hsize_t dims[SPANS_MAX_RANK] = {SPANS_DIM, SPANS_DIM, SPANS_DIM};
+    hsize_t start[SPANS_MAX_RANK];      /* Start of the selection */
+    hsize_t stride[SPANS_MAX_RANK];     /* Stride of the selection */
+    hsize_t count[SPANS_MAX_RANK];      /* Count of the selection */
+    hsize_t block[SPANS_MAX_RANK];      /* Block of the selection */
+    const size_t elem_sizes[] = {1, 4, 8};
+    hid_t sid = -1;                     /* Selection checked */
+    H5S_t *space;                       /* Dataspace of the selection */
+    uint8_t *map = NULL;                /* Elements that should be selected */
+    hsize_t *exp_off = NULL;            /* Offsets of the runs selected */
+    size_t *exp_len = NULL;             /* Lengths of the runs selected */
+    hsize_t *off = NULL;                /* Offsets of the sequences made */
+    size_t *len = NULL;                 /* Lengths of the sequences made */
+    hsize_t *seq_off = NULL;            /* Offsets of the sequences from a call */
+    size_t *seq_len = NULL;             /* Lengths of the sequences from a call */
+    size_t npoints;                     /* # of elements in the dataspace */
+    size_t nruns;                       /* # of runs selected */
+    size_t elem_size;                   /* Size of the elements */
+    unsigned rank;                      /* Rank of the selections */
+    unsigned n;                         /* Index of the selection */
+    size_t v;                           /* Local index variable */
+
+    TESTING("sequence lists for regular hyperslabs")
+
+    HDsrandom(SPANS_SEED);
+
+    for(rank = 1; rank <= SPANS_MAX_RANK; rank++) {
+        npoints = map_npoints(rank);
+        if(NULL == (map = (uint8_t *)HDmalloc(npoints)))
+            TEST_ERROR
+        if(NULL == (exp_off = (hsize_t *)HDmalloc(npoints * sizeof(hsize_t))))
+            TEST_ERROR
+        if(NULL == (exp_len = (size_t *)HDmalloc(npoints * sizeof(size_t))))
+            TEST_ERROR
+        if(NULL == (off = (hsize_t *)HDmalloc(npoints * sizeof(hsize_t))))
+            TEST_ERROR
+        if(NULL == (len = (size_t *)HDmalloc(npoints * sizeof(size_t))))
+            TEST_ERROR
+        if(NULL == (seq_off = (hsize_t *)HDmalloc(npoints * sizeof(hsize_t))))
+            TEST_ERROR
+        if(NULL == (seq_len = (size_t *)HDmalloc(npoints * sizeof(size_t))))
+            TEST_ERROR
+        if((sid = H5Screate_simple((int)rank, dims, NULL)) < 0)
+            FAIL_STACK_ERROR
+        if(NULL == (space = (H5S_t *)H5I_object_verify(sid, H5I_DATASPACE)))
+            FAIL_STACK_ERROR
+
+        for(n = 0; n < SPANS_SEQ_NSELS; n++) {
+            elem_size = elem_sizes[n % NELMTS(elem_sizes)];
+
+            random_regular(rank, start, stride, count, block);
+            if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, stride, count, block) < 0)
+                FAIL_STACK_ERROR
+            HDmemset(map, 0, npoints);
+            map_regular(map, rank, start, stride, count, block);
+
+            /* The runs of contiguous elements selected */
+            nruns = 0;
+            for(v = 0; v < npoints; v++)
+                if(map[v]) {
+                    if(nruns > 0 && exp_off[nruns - 1] + exp_len[nruns - 1] == v * elem_size)
+                        exp_len[nruns - 1] += elem_size;
+                    else {
+                        exp_off[nruns] = v * elem_size;
+                        exp_len[nruns] = elem_size;
+                        nruns++;
+                    } /* end else */
+                } /* end if */
+
+            if(check_seq_list(space, elem_size, FALSE, nruns, exp_off, exp_len, off, len, seq_off, seq_len))
+                TEST_ERROR
+            if(check_seq_list(space, elem_size, TRUE, nruns, exp_off, exp_len, off, len, seq_off, seq_len))
+                TEST_ERROR
+        } /* end for */
+
+        if(H5Sclose(sid) < 0)
+            FAIL_STACK_ERROR
+        sid = -1;
+        HDfree(map);
+        map = NULL;
+        HDfree(exp_off);
+        exp_off = NULL;
+        HDfree(exp_len);
+        exp_len = NULL;
+        HDfree(off);
+        off = NULL;
+        HDfree(len);
+        len = NULL;
+        HDfree(seq_off);
+        seq_off = NULL;
+        HDfree(seq_len);
+        seq_len = NULL;
+    } /* end for */
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(sid);
+    } H5E_END_TRY;
+    HDfree(map);
+    HDfree(exp_off);
+    HDfree(exp_len);
+    HDfree(off);
+    HDfree(len);
+    HDfree(seq_off);
+    HDfree(seq_len);
+
+    return 1;
+} /* test_seq_list_regular() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Tests span tree selections
+ *
+ * Return:      EXIT_SUCCESS/EXIT_FAILURE
+ *
+ *-------------------------------------------------------------------------
+ */
+int
+main(void)
+{
+    unsigned    nerrors = 0;            /* Cumulative error count */
+    hbool_t     api_ctx_pushed = FALSE; /* Whether API context pushed */
+
+    h5_reset();
+
+    /* Push API context */
+    if(H5CX_push() < 0) FAIL_STACK_ERROR
+    api_ctx_pushed = TRUE;
+
+    nerrors += test_span_sharing();
+    nerrors += test_and_adjust();
+    nerrors += test_compact_encode();
+    nerrors += test_select_batch();
+    nerrors += test_intersect_block();
+    nerrors += test_copy_regular();
+    nerrors += test_seq_list_regular();
+
+    if(nerrors)
+        goto error;
+
+    /* Pop API context */
+    if(api_ctx_pushed && H5CX_pop() < 0) FAIL_STACK_ERROR
+    api_ctx_pushed = FALSE;
+
+    HDputs("All span tree selection tests passed.");
+
+    HDexit(EXIT_SUCCESS);
+
+error:
+    HDprintf("***** %d SPAN TREE SELECTION TEST%s FAILED! *****\n",
+        nerrors, nerrors > 1 ? "S" : "");
+
+    if(api_ctx_pushed) H5CX_pop();
+
+    HDexit(EXIT_FAILURE);
+} /* main() */
@@ -1,4 +1,9 @@
+# Usage: json2csv.py [input.json [output.csv]]
+# Converts newline-delimited JSON, e.g. the results of the benchmarks
+# target, to CSV.
+import sys
 import pandas as pd
-df = pd.read_json('splunk-00000-of-00001.json', lines=True)
-df.to_csv('ior_superset.csv')
-
+inp = sys.argv[1] if len(sys.argv) > 1 else 'splunk-00000-of-00001.json'
+out = sys.argv[2] if len(sys.argv) > 2 else 'ior_superset.csv'
+df = pd.read_json(inp, lines=True)
+df.to_csv(out)
@@ -5,27 +5,47 @@
 
  */
 
-#include <h5s.h>
+#include <stdlib.h>
+
+#include "h5s.h"
+
+/* Records handed to h5s at a time */
+#define BATCH 16
 
 int main(int argc, const char *argv[])
 {
-    /* Open file in MapR Hadoop FS. */
-    hid_t fid = h5s_open("maprfs://path/to/test.h5s");
+    /* Open file as the writer. */
+    hid_t fid = h5s_open("test.h5s", 1);
     
     /* Note: It can be any file system (local, http, s3, kafka, etc.). */    
 
     int i = 0;
+    int n = argc > 1 ? atoi(argv[1]) : 0;
     
     /* A spreadsheet with million columns and unlimited (*) rows. */
-    int record[1000000];
+    int ncols = 1000000;
+    int *records;
     
-    while(i < atoi(argv[1])) {
-        /* Set record. */
-        record[0] = 255;
-        /* Append record to the 2d dataset (i.e., dset[*][1000000]). */
-        if(h5s_write(fid, '/group/dset', record) < 0) 
+    if(fid < 0)
+        return -1;
+    if(h5s_create(fid, "/group/dset", H5T_NATIVE_INT, ncols) < 0)
+        return -1;
+    if(NULL == (records = (int *)calloc((size_t)BATCH * ncols, sizeof(int))))
+        return -1;
+
+    while(i < n) {
+        int nrows = n - i < BATCH ? n - i : BATCH;
+        int r;
+
+        /* Set records. */
+        for(r = 0; r < nrows; r++)
+            records[r * ncols] = 255;
+        /* Append records to the 2d dataset (i.e., dset[*][1000000]); h5s
+         * hands them to readers once per tick. */
+        if(h5s_write_batch(fid, "/group/dset", records, nrows) < 0) 
             return -1;
-        
+        i += nrows;
     }
+    free(records);
     return h5s_close(fid);    
 }
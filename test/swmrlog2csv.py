@@ -0,0 +1,49 @@
+# Convert a binary VFD SWMR event log (see H5F_post_vfd_swmr_log_event()
+# in src/H5Flog.c) to CSV, or to Parquet when the output name ends in
+# .parquet (needs pandas with pyarrow or fastparquet).
+#
+# Usage: python3 swmrlog2csv.py output.log.bin [events.csv]
+import csv
+import struct
+import sys
+
+MAGIC = b'H5SE'
+VERSION = 1
+FIELDS = ['tick', 'timestamp_ns', 'duration_ns', 'bytes', 'entry_type_code',
+          'md_pages', 'raw_pages']
+RECORD = struct.Struct('<QQQQiIII')
+
+
+def read_events(path):
+    with open(path, 'rb') as f:
+        hdr = f.read(8)
+        if len(hdr) != 8 or hdr[:4] != MAGIC:
+            sys.exit('%s: not a SWMR event log' % path)
+        if hdr[4] != VERSION:
+            sys.exit('%s: unknown event log version %d' % (path, hdr[4]))
+        rec_size = hdr[5]
+        if rec_size < RECORD.size:
+            sys.exit('%s: bad record size %d' % (path, rec_size))
+        while True:
+            rec = f.read(rec_size)
+            if len(rec) < rec_size:
+                break
+            yield RECORD.unpack_from(rec)[:len(FIELDS)]
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit('usage: %s LOG [OUTPUT]' % sys.argv[0])
+    out = sys.argv[2] if len(sys.argv) > 2 else sys.argv[1] + '.csv'
+    if out.endswith('.parquet'):
+        import pandas as pd
+        pd.DataFrame(list(read_events(sys.argv[1])), columns=FIELDS).to_parquet(out)
+    else:
+        with open(out, 'w', newline='') as f:
+            w = csv.writer(f)
+            w.writerow(FIELDS)
+            w.writerows(read_events(sys.argv[1]))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,972 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/***********************************************************
+*
+* Test program:	 vfd_async
+*
+* Tests the asynchronous I/O engine behind the VFD dispatch layer.
+*
+*************************************************************/
+
+#include "h5test.h"
+
+#include "H5CXprivate.h"        /* API Contexts                         */
+#include "H5FDprivate.h"        /* File drivers                         */
+#include "H5Iprivate.h"         /* IDs                                  */
+#include "H5Pprivate.h"         /* Property lists                       */
+
+#define FILENAME_LEN            1024
+#define QUEUE_DEPTH             4
+#define NREQS                   16
+#define REQ_SIZE                512
+
+/* Property list of a FAPL ID, for the library's own property routines */
+#define FAPL_PLIST(F)           ((H5P_genplist_t *)H5I_object(F))
+
+/* test routines for the async I/O engine */
+static unsigned test_async_sec2(void);
+static unsigned test_async_core(void);
+static unsigned test_async_close(void);
+static unsigned test_prefetch_window(void);
+static unsigned test_read_ahead(void);
+static unsigned test_prefetch_tiers(void);
+static unsigned test_vector_io(void);
+
+const char *FILENAME[] = {
+    "vfd_async",
+    "vfd_async_core",
+    NULL
+};
+
+
+/*-------------------------------------------------------------------------
+ * Function:    open_file()
+ *
+ * Purpose:     Create NAME with FAPL, whose driver is already set, and a
+ *              queue depth of QUEUE_DEPTH.  The EOA is set to cover
+ *              NREQS requests of REQ_SIZE bytes, twice over.
+ *
+ * Return:      Success:        The open file
+ *              Failure:        NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_t *
+open_file(const char *name, hid_t fapl)
+{
+    H5FD_t *file = NULL;
+
+    if(H5P_set_vfd_async_queue_depth(FAPL_PLIST(fapl), QUEUE_DEPTH) < 0)
+        FAIL_STACK_ERROR
+    if(NULL == (file = H5FDopen(name, H5F_ACC_RDWR | H5F_ACC_CREAT | H5F_ACC_TRUNC, fapl, HADDR_UNDEF)))
+        FAIL_STACK_ERROR
+    if(H5FDset_eoa(file, H5FD_MEM_DRAW, (haddr_t)(2 * NREQS * REQ_SIZE)) < 0)
+        FAIL_STACK_ERROR
+
+    return file;
+
+error:
+    if(file)
+        H5FDclose(file);
+    return NULL;
+} /* open_file() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_requests()
+ *
+ * Purpose:     With FILE's engine, write NREQS requests in a row without
+ *              waiting, read them back the same way, and check both the
+ *              data and what H5FDread() sees.  The first write extends
+ *              the file, so the driver's EOF must follow it.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+check_requests(H5FD_t *file)
+{
+    H5FD_async_t *aio;                          /* File's engine */
+    H5FD_async_req_t *req[NREQS];               /* Requests in flight */
+    uint8_t wbuf[NREQS][REQ_SIZE];              /* Data written */
+    uint8_t rbuf[NREQS][REQ_SIZE];              /* Data read back */
+    hbool_t done = FALSE;                       /* Whether a request completed */
+    herr_t status;                              /* Status of a failing call */
+    unsigned u, v;                              /* Local index variables */
+
+    /* Opening the file attached the engine */
+    if(NULL == (aio = H5FD_async_get_engine(file)))
+        TEST_ERROR
+
+    /* Extend the file */
+    HDmemset(wbuf, 0, sizeof(wbuf));
+    if(H5FD_write_async(aio, H5FD_MEM_DRAW, (haddr_t)0, sizeof(wbuf), wbuf, &req[0]) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_wait(req[0]) < 0)
+        FAIL_STACK_ERROR
+    if(H5FDget_eof(file, H5FD_MEM_DRAW) != (haddr_t)sizeof(wbuf))
+        TEST_ERROR
+
+    /* Overwrite it, with every request in flight before waiting */
+    for(u = 0; u < NREQS; u++) {
+        for(v = 0; v < REQ_SIZE; v++)
+            wbuf[u][v] = (uint8_t)(u * 7 + v);
+        if(H5FD_write_async(aio, H5FD_MEM_DRAW, (haddr_t)u * REQ_SIZE, (size_t)REQ_SIZE, wbuf[u], &req[u]) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+    for(u = 0; u < NREQS; u++)
+        if(H5FD_async_wait(req[u]) < 0)
+            FAIL_STACK_ERROR
+    if(H5FDget_eof(file, H5FD_MEM_DRAW) != (haddr_t)sizeof(wbuf))
+        TEST_ERROR
+
+    /* Read back in reverse order */
+    HDmemset(rbuf, 0, sizeof(rbuf));
+    for(u = NREQS; u > 0; u--)
+        if(H5FD_read_async(aio, H5FD_MEM_DRAW, (haddr_t)(u - 1) * REQ_SIZE, (size_t)REQ_SIZE, rbuf[u - 1], &req[u - 1]) < 0)
+            FAIL_STACK_ERROR
+    if(H5FD_async_test(req[0], &done) < 0)
+        FAIL_STACK_ERROR
+    for(u = 0; u < NREQS; u++)
+        if(H5FD_async_wait(req[u]) < 0)
+            FAIL_STACK_ERROR
+    if(HDmemcmp(rbuf, wbuf, sizeof(wbuf)))
+        TEST_ERROR
+
+    /* The driver sees the same bytes */
+    HDmemset(rbuf, 0, sizeof(rbuf));
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, sizeof(rbuf), rbuf) < 0)
+        FAIL_STACK_ERROR
+    if(HDmemcmp(rbuf, wbuf, sizeof(wbuf)))
+        TEST_ERROR
+
+    /* Requests past the EOA are rejected at submission */
+    H5E_BEGIN_TRY {
+        status = H5FD_read_async(aio, H5FD_MEM_DRAW, (haddr_t)(2 * NREQS * REQ_SIZE), (size_t)REQ_SIZE, rbuf[0], &req[0]);
+    } H5E_END_TRY;
+    if(status >= 0)
+        TEST_ERROR
+
+    return 0;
+
+error:
+    return 1;
+} /* check_requests() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_vector()
+ *
+ * Purpose:     Write NREQS entries of REQ_SIZE bytes, out of address
+ *              order and of two memory types, with H5FD_write_vector()
+ *              and read them back with H5FDread(), then the other way
+ *              round.  If FILE's engine has a prefetch window (WINDOW),
+ *              the entries are then read from a prefetched copy of the file
+ *              and, after part of it is rewritten, from the file again.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+check_vector(H5FD_t *file, hbool_t window)
+{
+    H5FD_mem_t types[NREQS];                    /* Entry memory types */
+    haddr_t addrs[NREQS];                       /* Entry addresses */
+    size_t sizes[NREQS];                        /* Entry sizes */
+    const void *wbufs[NREQS];                   /* Entry data written */
+    void *rbufs[NREQS];                         /* Entry data read */
+    uint8_t wbuf[NREQS][REQ_SIZE];              /* Data written */
+    uint8_t rbuf[NREQS][REQ_SIZE];              /* Data read back */
+    H5FD_async_t *aio;                          /* File's engine */
+    H5FD_async_stats_t stats;                   /* Window statistics */
+    unsigned u, v;                              /* Local index variables */
+
+    for(u = 0; u < NREQS; u++) {
+        types[u] = (u % 2) ? H5FD_MEM_OHDR : H5FD_MEM_DRAW;
+        addrs[u] = (haddr_t)((u * 5) % NREQS) * REQ_SIZE;
+        sizes[u] = REQ_SIZE;
+        wbufs[u] = wbuf[u];
+        rbufs[u] = rbuf[u];
+    } /* end for */
+
+    /* Vector write, scalar reads */
+    for(u = 0; u < NREQS; u++)
+        for(v = 0; v < REQ_SIZE; v++)
+            wbuf[u][v] = (uint8_t)(u * 3 + v);
+    if(H5FD_write_vector(file, NREQS, types, addrs, sizes, wbufs) < 0)
+        FAIL_STACK_ERROR
+    for(u = 0; u < NREQS; u++) {
+        if(H5FDread(file, types[u], H5P_DEFAULT, addrs[u], sizes[u], rbuf[u]) < 0)
+            FAIL_STACK_ERROR
+        if(HDmemcmp(rbuf[u], wbuf[u], REQ_SIZE))
+            TEST_ERROR
+    } /* end for */
+
+    /* Scalar writes, vector read */
+    for(u = 0; u < NREQS; u++) {
+        for(v = 0; v < REQ_SIZE; v++)
+            wbuf[u][v] = (uint8_t)(u * 11 + v + 1);
+        if(H5FDwrite(file, types[u], H5P_DEFAULT, addrs[u], sizes[u], wbuf[u]) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+    HDmemset(rbuf, 0, sizeof(rbuf));
+    if(H5FD_read_vector(file, NREQS, types, addrs, sizes, rbufs) < 0)
+        FAIL_STACK_ERROR
+    if(HDmemcmp(rbuf, wbuf, sizeof(rbuf)))
+        TEST_ERROR
+
+    /* Vector reads from the prefetch window */
+    if(NULL == (aio = H5FD_async_get_engine(file)))
+        TEST_ERROR
+    if(H5FD_async_prefetch(aio, H5FD_MEM_DRAW, (haddr_t)0, (size_t)(NREQS * REQ_SIZE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.prefetches != (window ? 1 : 0))
+        TEST_ERROR
+    if(window) {
+        /* Only entries of the prefetched type are served from it */
+        HDmemset(rbuf, 0, sizeof(rbuf));
+        if(H5FD_read_vector(file, NREQS, types, addrs, sizes, rbufs) < 0)
+            FAIL_STACK_ERROR
+        if(HDmemcmp(rbuf, wbuf, sizeof(rbuf)))
+            TEST_ERROR
+        if(H5FD_async_get_stats(file, &stats) < 0)
+            FAIL_STACK_ERROR
+        if(stats.hits != NREQS / 2)
+            TEST_ERROR
+
+        /* A vector write drops the prefetched copy */
+        for(u = 0; u < NREQS; u += 4)
+            HDmemset(wbuf[u], 0xff, REQ_SIZE);
+        if(H5FD_write_vector(file, NREQS, types, addrs, sizes, wbufs) < 0)
+            FAIL_STACK_ERROR
+        HDmemset(rbuf, 0, sizeof(rbuf));
+        if(H5FD_read_vector(file, NREQS, types, addrs, sizes, rbufs) < 0)
+            FAIL_STACK_ERROR
+        if(HDmemcmp(rbuf, wbuf, sizeof(rbuf)))
+            TEST_ERROR
+        if(H5FD_async_get_stats(file, &stats) < 0)
+            FAIL_STACK_ERROR
+        if(stats.hits != NREQS / 2)
+            TEST_ERROR
+    } /* end if */
+
+    return 0;
+
+error:
+    return 1;
+} /* check_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_async_sec2()
+ *
+ * Purpose:     Verify the engine on a sec2 file, serviced by the
+ *              io_uring or thread pool backend:
+ *              --requests complete with the data written, in any order
+ *              --the driver sees the data the engine wrote
+ *              --the driver's EOF follows writes that extend the file
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_async_sec2(void)
+{
+    char filename[FILENAME_LEN];        /* Filename to use */
+    hid_t fapl = -1;                    /* File access property list */
+    H5FD_t *file = NULL;                /* File */
+
+    TESTING("async I/O on a sec2 file")
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_sec2(fapl) < 0)
+        FAIL_STACK_ERROR
+    h5_fixname(FILENAME[0], fapl, filename, sizeof(filename));
+
+    if(NULL == (file = open_file(filename, fapl)))
+        TEST_ERROR
+    if(check_requests(file))
+        TEST_ERROR
+
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    return 1;
+} /* test_async_sec2() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_async_core()
+ *
+ * Purpose:     Verify the engine on a core file with a backing store,
+ *              which must go through the driver:
+ *              --requests complete with the data written
+ *              --the data lands in the memory image and, once the file
+ *                is closed, in the backing store
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_async_core(void)
+{
+    char filename[FILENAME_LEN];        /* Filename to use */
+    hid_t fapl = -1;                    /* File access property list */
+    H5FD_t *file = NULL;                /* File */
+    uint8_t buf[NREQS * REQ_SIZE];      /* Backing store contents */
+    int fd = -1;                        /* Backing store descriptor */
+    unsigned u;                         /* Local index variable */
+
+    TESTING("async I/O on a core file with a backing store")
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_core(fapl, (size_t)(64 * 1024), TRUE) < 0)
+        FAIL_STACK_ERROR
+    h5_fixname(FILENAME[1], fapl, filename, sizeof(filename));
+
+    if(NULL == (file = open_file(filename, fapl)))
+        TEST_ERROR
+    if(check_requests(file))
+        TEST_ERROR
+
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+
+    /* The image was flushed to the backing store on close */
+    if((fd = HDopen(filename, O_RDONLY)) < 0)
+        TEST_ERROR
+    if(HDread(fd, buf, sizeof(buf)) != (ssize_t)sizeof(buf))
+        TEST_ERROR
+    HDclose(fd);
+    fd = -1;
+    for(u = 0; u < sizeof(buf); u++)
+        if(buf[u] != (uint8_t)((u / REQ_SIZE) * 7 + u % REQ_SIZE))
+            TEST_ERROR
+
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    if(fd >= 0)
+        HDclose(fd);
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    return 1;
+} /* test_async_core() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_async_close()
+ *
+ * Purpose:     Verify closing an engine:
+ *              --closing fails while a request is outstanding, and leaves
+ *                the engine usable
+ *              --prefetches still in flight don't stop it closing
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_async_close(void)
+{
+    char filename[FILENAME_LEN];        /* Filename to use */
+    hid_t fapl = -1;                    /* File access property list */
+    H5FD_t *file = NULL;                /* File */
+    H5FD_async_t *aio;                  /* File's engine */
+    H5FD_async_req_t *req = NULL;       /* Outstanding request */
+    uint8_t buf[REQ_SIZE];              /* Data */
+    herr_t status;                      /* Status of a failing call */
+
+    TESTING("closing an async I/O engine")
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_sec2(fapl) < 0)
+        FAIL_STACK_ERROR
+    if(H5P_set_vfd_prefetch_window(FAPL_PLIST(fapl), 2) < 0)
+        FAIL_STACK_ERROR
+    h5_fixname(FILENAME[0], fapl, filename, sizeof(filename));
+
+    if(NULL == (file = open_file(filename, fapl)))
+        TEST_ERROR
+    if(NULL == (aio = H5FD_async_get_engine(file)))
+        TEST_ERROR
+    HDmemset(buf, 1, sizeof(buf));
+    if(H5FDwrite(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, sizeof(buf), buf) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5FD_async_prefetch(aio, H5FD_MEM_DRAW, (haddr_t)0, sizeof(buf)) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_read_async(aio, H5FD_MEM_DRAW, (haddr_t)0, sizeof(buf), buf, &req) < 0)
+        FAIL_STACK_ERROR
+    H5E_BEGIN_TRY {
+        status = H5FD_async_close(aio);
+    } H5E_END_TRY;
+    if(status >= 0)
+        TEST_ERROR
+    if(H5FD_async_get_engine(file) != aio)
+        TEST_ERROR
+
+    /* Still usable */
+    if(H5FD_async_wait(req) < 0)
+        FAIL_STACK_ERROR
+    req = NULL;
+    if(H5FD_read_async(aio, H5FD_MEM_DRAW, (haddr_t)0, sizeof(buf), buf, &req) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_wait(req) < 0)
+        FAIL_STACK_ERROR
+    req = NULL;
+
+    if(H5FD_async_prefetch(aio, H5FD_MEM_DRAW, (haddr_t)REQ_SIZE, sizeof(buf)) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_close(aio) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_get_engine(file) != NULL)
+        TEST_ERROR
+
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    if(req)
+        H5FD_async_wait(req);
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    return 1;
+} /* test_async_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_prefetch_window()
+ *
+ * Purpose:     Verify the prefetch window of a sec2 file's engine:
+ *              --a read inside a prefetched range is served from it
+ *              --a write drops the slots it overlaps
+ *              --a range with an async write outstanding isn't prefetched
+ *              --a VFD SWMR reader's end of tick drops every slot, so
+ *                changes made by another process are seen
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_prefetch_window(void)
+{
+    char filename[FILENAME_LEN];        /* Filename to use */
+    hid_t fapl = -1;                    /* File access property list */
+    H5FD_t *file = NULL;                /* File */
+    H5FD_async_t *aio;                  /* File's engine */
+    H5FD_async_req_t *req = NULL;       /* Outstanding write */
+    H5FD_async_stats_t stats;           /* Window statistics */
+    uint8_t wbuf[REQ_SIZE];             /* Data written */
+    uint8_t rbuf[REQ_SIZE];             /* Data read */
+    int fd = -1;                        /* Second descriptor, for the "writer" */
+
+    TESTING("async I/O engine prefetch window")
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_sec2(fapl) < 0)
+        FAIL_STACK_ERROR
+    if(H5P_set_vfd_prefetch_window(FAPL_PLIST(fapl), 4) < 0)
+        FAIL_STACK_ERROR
+    h5_fixname(FILENAME[0], fapl, filename, sizeof(filename));
+
+    if(NULL == (file = open_file(filename, fapl)))
+        TEST_ERROR
+    if(NULL == (aio = H5FD_async_get_engine(file)))
+        TEST_ERROR
+    HDmemset(wbuf, 1, sizeof(wbuf));
+    if(H5FDwrite(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, sizeof(wbuf), wbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5FDwrite(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)REQ_SIZE, sizeof(wbuf), wbuf) < 0)
+        FAIL_STACK_ERROR
+
+    /* Hit */
+    if(H5FD_async_prefetch(aio, H5FD_MEM_DRAW, (haddr_t)0, sizeof(wbuf)) < 0)
+        FAIL_STACK_ERROR
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)16, (size_t)32, rbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.prefetches != 1 || stats.hits != 1 || stats.misses != 0 || rbuf[0] != 1)
+        TEST_ERROR
+
+    /* A write drops the slot */
+    HDmemset(wbuf, 2, sizeof(wbuf));
+    if(H5FDwrite(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)32, (size_t)16, wbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)32, (size_t)16, rbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.hits != 1 || stats.misses != 1 || rbuf[0] != 2)
+        TEST_ERROR
+
+    /* No prefetch over an outstanding write */
+    HDmemset(wbuf, 3, sizeof(wbuf));
+    if(H5FD_write_async(aio, H5FD_MEM_DRAW, (haddr_t)REQ_SIZE, sizeof(wbuf), wbuf, &req) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_prefetch(aio, H5FD_MEM_DRAW, (haddr_t)REQ_SIZE, sizeof(wbuf)) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.prefetches != 1)
+        TEST_ERROR
+    if(H5FD_async_wait(req) < 0)
+        FAIL_STACK_ERROR
+    req = NULL;
+
+    /* Another process changes a prefetched range */
+    if(H5FD_async_prefetch(aio, H5FD_MEM_DRAW, (haddr_t)REQ_SIZE, sizeof(wbuf)) < 0)
+        FAIL_STACK_ERROR
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)REQ_SIZE, sizeof(rbuf), rbuf) < 0)
+        FAIL_STACK_ERROR
+    if(rbuf[0] != 3)
+        TEST_ERROR
+    if((fd = HDopen(filename, O_RDWR)) < 0)
+        TEST_ERROR
+    HDmemset(wbuf, 4, sizeof(wbuf));
+    if(HDpwrite(fd, wbuf, sizeof(wbuf), (HDoff_t)REQ_SIZE) != (ssize_t)sizeof(wbuf))
+        TEST_ERROR
+    HDclose(fd);
+    fd = -1;
+    if(H5FD_reader_end_of_tick() < 0)
+        FAIL_STACK_ERROR
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)REQ_SIZE, sizeof(rbuf), rbuf) < 0)
+        FAIL_STACK_ERROR
+    if(rbuf[0] != 4 || rbuf[REQ_SIZE - 1] != 4)
+        TEST_ERROR
+
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    if(req)
+        H5FD_async_wait(req);
+    if(fd >= 0)
+        HDclose(fd);
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    return 1;
+} /* test_prefetch_window() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_read_ahead()
+ *
+ * Purpose:     Verify page buffer read-ahead on a sec2 file with no queue
+ *              depth of its own: once reads are seen to follow each
+ *              other, most of a run of NREQS is served from the ranges
+ *              read ahead of it.
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_read_ahead(void)
+{
+    char filename[FILENAME_LEN];        /* Filename to use */
+    hid_t fapl = -1;                    /* File access property list */
+    H5FD_t *file = NULL;                /* File */
+    H5FD_async_stats_t stats;           /* Window statistics */
+    uint8_t wbuf[NREQS][REQ_SIZE];      /* Data written */
+    uint8_t rbuf[REQ_SIZE];             /* Data read */
+    unsigned prefetch_pages = 0;        /* Read-ahead from the FAPL */
+    unsigned u;                         /* Local index variable */
+
+    TESTING("page buffer read-ahead")
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_sec2(fapl) < 0)
+        FAIL_STACK_ERROR
+    if(H5P_set_page_buffer_prefetch(FAPL_PLIST(fapl), 2) < 0)
+        FAIL_STACK_ERROR
+    if(H5P_get_page_buffer_prefetch(FAPL_PLIST(fapl), &prefetch_pages) < 0)
+        FAIL_STACK_ERROR
+    if(prefetch_pages != 2)
+        TEST_ERROR
+    h5_fixname(FILENAME[0], fapl, filename, sizeof(filename));
+
+    /* Read-ahead attaches an engine by itself */
+    if(NULL == (file = H5FDopen(filename, H5F_ACC_RDWR | H5F_ACC_CREAT | H5F_ACC_TRUNC, fapl, HADDR_UNDEF)))
+        FAIL_STACK_ERROR
+    if(NULL == H5FD_async_get_engine(file))
+        TEST_ERROR
+    if(H5FDset_eoa(file, H5FD_MEM_DRAW, (haddr_t)sizeof(wbuf)) < 0)
+        FAIL_STACK_ERROR
+    for(u = 0; u < NREQS; u++)
+        HDmemset(wbuf[u], (int)(u + 1), sizeof(wbuf[u]));
+    if(H5FDwrite(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, sizeof(wbuf), wbuf) < 0)
+        FAIL_STACK_ERROR
+
+    /* Read the file front to back */
+    for(u = 0; u < NREQS; u++) {
+        if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)u * REQ_SIZE, sizeof(rbuf), rbuf) < 0)
+            FAIL_STACK_ERROR
+        if(rbuf[0] != (uint8_t)(u + 1) || rbuf[REQ_SIZE - 1] != (uint8_t)(u + 1))
+            TEST_ERROR
+    } /* end for */
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.hits + stats.misses != NREQS || stats.hits < NREQS / 2)
+        TEST_ERROR
+
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    return 1;
+} /* test_read_ahead() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    check_tiers()
+ *
+ * Purpose:     With a window of 4 slots on FILE, fill it with raw data,
+ *              make a metadata prefetch evict the least recently used raw
+ *              slot, then miss on that slot's range.  The split of the
+ *              window must start at META_START metadata slots and end at
+ *              META_END.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+check_tiers(H5FD_t *file, unsigned meta_start, unsigned meta_end)
+{
+    H5FD_async_t *aio;                  /* File's engine */
+    H5FD_async_stats_t stats;           /* Window statistics */
+    uint8_t rbuf[REQ_SIZE];             /* Data read */
+    unsigned u;                         /* Local index variable */
+
+    if(NULL == (aio = H5FD_async_get_engine(file)))
+        TEST_ERROR
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.meta_slots != meta_start)
+        TEST_ERROR
+
+    /* Fill the window with raw data, and use it in order */
+    for(u = 0; u < 4; u++)
+        if(H5FD_async_prefetch(aio, H5FD_MEM_DRAW, (haddr_t)u * REQ_SIZE, (size_t)REQ_SIZE) < 0)
+            FAIL_STACK_ERROR
+    for(u = 0; u < 4; u++)
+        if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)u * REQ_SIZE, sizeof(rbuf), rbuf) < 0)
+            FAIL_STACK_ERROR
+
+    /* Metadata is under its share, so takes the oldest raw data slot */
+    if(H5FD_async_prefetch(aio, H5FD_MEM_OHDR, (haddr_t)8 * REQ_SIZE, (size_t)REQ_SIZE) < 0)
+        FAIL_STACK_ERROR
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)REQ_SIZE, sizeof(rbuf), rbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.evictions != 1 || stats.hits != 5 || stats.misses != 0 || stats.ghost_hits != 0)
+        TEST_ERROR
+
+    /* Missing on the evicted range moves the split to raw data */
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, sizeof(rbuf), rbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.misses != 1 || stats.ghost_hits != 1 || stats.meta_slots != meta_end)
+        TEST_ERROR
+
+    /* A second miss on it doesn't count again */
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, sizeof(rbuf), rbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_async_get_stats(file, &stats) < 0)
+        FAIL_STACK_ERROR
+    if(stats.misses != 2 || stats.ghost_hits != 1 || stats.meta_slots != meta_end)
+        TEST_ERROR
+
+    return 0;
+
+error:
+    return 1;
+} /* check_tiers() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_prefetch_tiers()
+ *
+ * Purpose:     Verify the metadata and raw data tiers of the prefetch
+ *              window:
+ *              --the window starts split evenly
+ *              --a tier under its share takes the other tier's least
+ *                recently used slot
+ *              --a miss on a range a tier evicted grows that tier
+ *              --unless that takes the other tier below the minimum set
+ *                with H5Pset_page_buffer_size()
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_prefetch_tiers(void)
+{
+    char filename[FILENAME_LEN];        /* Filename to use */
+    hid_t fapl = -1;                    /* File access property list */
+    H5FD_t *file = NULL;                /* File */
+
+    TESTING("async I/O engine prefetch window tiers")
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_sec2(fapl) < 0)
+        FAIL_STACK_ERROR
+    if(H5P_set_vfd_prefetch_window(FAPL_PLIST(fapl), 4) < 0)
+        FAIL_STACK_ERROR
+    h5_fixname(FILENAME[0], fapl, filename, sizeof(filename));
+
+    /* No minimums */
+    if(NULL == (file = open_file(filename, fapl)))
+        TEST_ERROR
+    if(check_tiers(file, 2, 1))
+        TEST_ERROR
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+
+    /* Half the window kept for metadata */
+    if(H5Pset_page_buffer_size(fapl, (size_t)(4 * REQ_SIZE), 50, 0) < 0)
+        FAIL_STACK_ERROR
+    if(NULL == (file = open_file(filename, fapl)))
+        TEST_ERROR
+    if(check_tiers(file, 2, 2))
+        TEST_ERROR
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    return 1;
+} /* test_prefetch_tiers() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_vector_io()
+ *
+ * Purpose:     Compare vector and scalar I/O on a sec2 file with a
+ *              prefetch window and on a core file with a backing store.
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_vector_io(void)
+{
+    char filename[FILENAME_LEN];        /* Filename to use */
+    hid_t fapl = -1;                    /* File access property list */
+    H5FD_t *file = NULL;                /* File */
+
+    TESTING("vector I/O with the async I/O engine")
+
+    /* sec2, with the window */
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_sec2(fapl) < 0)
+        FAIL_STACK_ERROR
+    if(H5P_set_vfd_prefetch_window(FAPL_PLIST(fapl), 2) < 0)
+        FAIL_STACK_ERROR
+    h5_fixname(FILENAME[0], fapl, filename, sizeof(filename));
+
+    if(NULL == (file = open_file(filename, fapl)))
+        TEST_ERROR
+    if(check_vector(file, TRUE))
+        TEST_ERROR
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    /* core, through the driver */
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_core(fapl, (size_t)(64 * 1024), TRUE) < 0)
+        FAIL_STACK_ERROR
+    h5_fixname(FILENAME[1], fapl, filename, sizeof(filename));
+
+    if(NULL == (file = open_file(filename, fapl)))
+        TEST_ERROR
+    if(check_vector(file, FALSE))
+        TEST_ERROR
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+    file = NULL;
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    return 1;
+} /* test_vector_io() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Tests the asynchronous I/O engine
+ *
+ * Return:      EXIT_SUCCESS/EXIT_FAILURE
+ *
+ *-------------------------------------------------------------------------
+ */
+int
+main(void)
+{
+    hid_t       fapl = -1;              /* File access property list for cleanup */
+    unsigned    nerrors = 0;            /* Cumulative error count */
+    hbool_t     api_ctx_pushed = FALSE; /* Whether API context pushed */
+
+    h5_reset();
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Push API context */
+    if(H5CX_push() < 0) FAIL_STACK_ERROR
+    api_ctx_pushed = TRUE;
+
+    nerrors += test_async_sec2();
+    nerrors += test_async_core();
+    nerrors += test_async_close();
+    nerrors += test_prefetch_window();
+    nerrors += test_read_ahead();
+    nerrors += test_prefetch_tiers();
+    nerrors += test_vector_io();
+
+    h5_clean_files(FILENAME, fapl);
+    fapl = -1;
+
+    if(nerrors)
+        goto error;
+
+    /* Pop API context */
+    if(api_ctx_pushed && H5CX_pop() < 0) FAIL_STACK_ERROR
+    api_ctx_pushed = FALSE;
+
+    HDputs("All async I/O engine tests passed.");
+
+    HDexit(EXIT_SUCCESS);
+
+error:
+    HDprintf("***** %d ASYNC I/O ENGINE TEST%s FAILED! *****\n",
+        nerrors, nerrors > 1 ? "S" : "");
+
+    H5E_BEGIN_TRY {
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    if(api_ctx_pushed) H5CX_pop();
+
+    HDexit(EXIT_FAILURE);
+} /* main() */
@@ -0,0 +1,314 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/***********************************************************
+*
+* Test program:	 vfd_sig_cache
+*
+* Tests the cache of superblock signature addresses kept across file opens.
+*
+*************************************************************/
+
+#include "h5test.h"
+
+#include "H5CXprivate.h"        /* API Contexts                         */
+#include "H5Fprivate.h"         /* File access                          */
+#include "H5FDprivate.h"        /* File drivers                         */
+
+#define FILENAME_LEN            1024
+#define USERBLOCK_SIZE          512
+#define MTIME_SEC               1000000000
+
+/* test routines for the signature address cache */
+static unsigned test_sig_cache(void);
+
+const char *FILENAME[] = {
+    "vfd_sig_cache",
+    NULL
+};
+
+#ifndef H5_HAVE_WIN32_API
+
+/*-------------------------------------------------------------------------
+ * Function:    locate()
+ *
+ * Purpose:     Open NAME with FAPL and look for its signature, returning
+ *              its address in *SIG_ADDR and the EOA left by the search in
+ *              *EOA.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+locate(const char *name, hid_t fapl, haddr_t *sig_addr, haddr_t *eoa)
+{
+    H5FD_t *file = NULL;
+
+    if(NULL == (file = H5FDopen(name, H5F_ACC_RDONLY, fapl, HADDR_UNDEF)))
+        FAIL_STACK_ERROR
+    if(H5FD_locate_signature(file, sig_addr) < 0)
+        FAIL_STACK_ERROR
+    *eoa = H5FDget_eoa(file, H5FD_MEM_SUPER);
+    if(H5FDclose(file) < 0)
+        FAIL_STACK_ERROR
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+    } H5E_END_TRY;
+    return 1;
+} /* locate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    set_mtime()
+ *
+ * Purpose:     Set the modification time of NAME to MTIME_SEC seconds and
+ *              NSEC nanoseconds.
+ *
+ * Return:      0 on success, 1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+set_mtime(const char *name, long nsec)
+{
+    struct timespec times[2];
+
+    times[0].tv_sec = 0;
+    times[0].tv_nsec = UTIME_OMIT;
+    times[1].tv_sec = MTIME_SEC;
+    times[1].tv_nsec = nsec;
+
+    return utimensat(AT_FDCWD, name, times, 0) < 0 ? 1 : 0;
+} /* set_mtime() */
+#endif /* H5_HAVE_WIN32_API */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_sig_cache()
+ *
+ * Purpose:     Verify the signature address cache on a file with a user
+ *              block:
+ *              --the first search misses and the next open hits
+ *              --H5Fopen() uses the cache
+ *              --a change of the modification time that only shows in
+ *                the nanoseconds drops the entry
+ *              --an entry whose address no longer holds the signature is
+ *                dropped, and the EOA is put back when the search then
+ *                fails
+ *              --a file without a user block doesn't use the cache
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_sig_cache(void)
+{
+#ifndef H5_HAVE_WIN32_API
+    char filename[FILENAME_LEN];        /* Filename to use */
+    hid_t fapl = -1;                    /* File access property list */
+    hid_t fcpl = -1;                    /* File creation property list */
+    hid_t fid = -1;                     /* File ID */
+    H5FD_sig_cache_stats_t before;      /* Cache statistics before each step */
+    H5FD_sig_cache_stats_t after;       /* Cache statistics after each step */
+    haddr_t sig_addr;                   /* Signature address found */
+    haddr_t eoa;                        /* EOA after the search */
+    int fd = -1;                        /* Descriptor, for damaging the file */
+#endif /* H5_HAVE_WIN32_API */
+
+    TESTING("superblock signature address cache")
+
+#ifdef H5_HAVE_WIN32_API
+    SKIPPED();
+    HDputs("    The cache needs POSIX file identities");
+    return 0;
+#else /* H5_HAVE_WIN32_API */
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fapl_sec2(fapl) < 0)
+        FAIL_STACK_ERROR
+    if((fcpl = H5Pcreate(H5P_FILE_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_userblock(fcpl, (hsize_t)USERBLOCK_SIZE) < 0)
+        FAIL_STACK_ERROR
+    h5_fixname(FILENAME[0], fapl, filename, sizeof(filename));
+
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, fcpl, fapl)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0)
+        FAIL_STACK_ERROR
+    fid = -1;
+    if(set_mtime(filename, 100L))
+        TEST_ERROR
+
+    /* Miss, then hit */
+    if(H5FD_sig_cache_get_stats(&before) < 0)
+        FAIL_STACK_ERROR
+    if(locate(filename, fapl, &sig_addr, &eoa))
+        TEST_ERROR
+    if(sig_addr != USERBLOCK_SIZE)
+        TEST_ERROR
+    if(locate(filename, fapl, &sig_addr, &eoa))
+        TEST_ERROR
+    if(sig_addr != USERBLOCK_SIZE || eoa != USERBLOCK_SIZE + H5F_SIGNATURE_LEN)
+        TEST_ERROR
+    if(H5FD_sig_cache_get_stats(&after) < 0)
+        FAIL_STACK_ERROR
+    if(after.misses != before.misses + 1 || after.hits != before.hits + 1)
+        TEST_ERROR
+
+    /* Reopening the file through the library hits */
+    before = after;
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0)
+        FAIL_STACK_ERROR
+    fid = -1;
+    if(H5FD_sig_cache_get_stats(&after) < 0)
+        FAIL_STACK_ERROR
+    if(after.hits != before.hits + 1 || after.misses != before.misses)
+        TEST_ERROR
+
+    /* A change within the same second */
+    before = after;
+    if(set_mtime(filename, 200L))
+        TEST_ERROR
+    if(locate(filename, fapl, &sig_addr, &eoa))
+        TEST_ERROR
+    if(sig_addr != USERBLOCK_SIZE)
+        TEST_ERROR
+    if(H5FD_sig_cache_get_stats(&after) < 0)
+        FAIL_STACK_ERROR
+    if(after.invalidations != before.invalidations + 1 || after.misses != before.misses + 1
+            || after.hits != before.hits)
+        TEST_ERROR
+
+    /* The signature is gone, but the size & time say the file is the same */
+    before = after;
+    if((fd = HDopen(filename, O_RDWR)) < 0)
+        TEST_ERROR
+    if(HDpwrite(fd, "XXXXXXXX", (size_t)H5F_SIGNATURE_LEN, (HDoff_t)USERBLOCK_SIZE) != H5F_SIGNATURE_LEN)
+        TEST_ERROR
+    HDclose(fd);
+    fd = -1;
+    if(set_mtime(filename, 200L))
+        TEST_ERROR
+    if(locate(filename, fapl, &sig_addr, &eoa))
+        TEST_ERROR
+    if(sig_addr != HADDR_UNDEF || eoa != 0)
+        TEST_ERROR
+    if(H5FD_sig_cache_get_stats(&after) < 0)
+        FAIL_STACK_ERROR
+    if(after.invalidations != before.invalidations + 1 || after.misses != before.misses + 1
+            || after.hits != before.hits)
+        TEST_ERROR
+
+    /* The signature at address 0 is found before the cache is looked at */
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0)
+        FAIL_STACK_ERROR
+    fid = -1;
+    if(H5FD_sig_cache_get_stats(&before) < 0)
+        FAIL_STACK_ERROR
+    if(locate(filename, fapl, &sig_addr, &eoa))
+        TEST_ERROR
+    if(sig_addr != 0 || eoa != H5F_SIGNATURE_LEN)
+        TEST_ERROR
+    if(H5FD_sig_cache_get_stats(&after) < 0)
+        FAIL_STACK_ERROR
+    if(HDmemcmp(&after, &before, sizeof(after)))
+        TEST_ERROR
+
+    if(H5Pclose(fcpl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    if(fd >= 0)
+        HDclose(fd);
+    H5E_BEGIN_TRY {
+        H5Fclose(fid);
+        H5Pclose(fcpl);
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    return 1;
+#endif /* H5_HAVE_WIN32_API */
+} /* test_sig_cache() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Tests the superblock signature address cache
+ *
+ * Return:      EXIT_SUCCESS/EXIT_FAILURE
+ *
+ *-------------------------------------------------------------------------
+ */
+int
+main(void)
+{
+    hid_t       fapl = -1;              /* File access property list for cleanup */
+    unsigned    nerrors = 0;            /* Cumulative error count */
+    hbool_t     api_ctx_pushed = FALSE; /* Whether API context pushed */
+
+    h5_reset();
+
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Push API context */
+    if(H5CX_push() < 0) FAIL_STACK_ERROR
+    api_ctx_pushed = TRUE;
+
+    nerrors += test_sig_cache();
+
+    h5_clean_files(FILENAME, fapl);
+    fapl = -1;
+
+    if(nerrors)
+        goto error;
+
+    /* Pop API context */
+    if(api_ctx_pushed && H5CX_pop() < 0) FAIL_STACK_ERROR
+    api_ctx_pushed = FALSE;
+
+    HDputs("All signature address cache tests passed.");
+
+    HDexit(EXIT_SUCCESS);
+
+error:
+    HDprintf("***** %d SIGNATURE ADDRESS CACHE TEST%s FAILED! *****\n",
+        nerrors, nerrors > 1 ? "S" : "");
+
+    H5E_BEGIN_TRY {
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+
+    if(api_ctx_pushed) H5CX_pop();
+
+    HDexit(EXIT_FAILURE);
+} /* main() */
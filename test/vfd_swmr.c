@@ -33,6 +33,7 @@
 #include "H5Fpkg.h"
 
 #include "H5CXprivate.h"        /* API Contexts                         */
+#include "H5FDprivate.h"        /* File drivers                         */
 #include "H5Iprivate.h"
 #include "H5PBprivate.h"
 
@@ -49,6 +50,11 @@ static unsigned open_file(char *filename, hid_t fapl, hsize_t page_size, size_t
 static unsigned test_fapl();
 static unsigned test_file_end_tick();
 static unsigned test_file_fapl();
+static unsigned test_md_index_hash();
+static unsigned test_md_index_delta();
+static unsigned test_tick_notify();
+static unsigned test_tick_pipeline();
+static unsigned test_md_space();
 
 const char *FILENAME[] = {
     "filepaged",
@@ -615,6 +621,598 @@ error:
     return 1;
 } /* test_file_end_tick() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    test_md_index_hash()
+ *
+ * Purpose:     Verify the in-memory hash over the metadata file index:
+ *              --lookups of present and absent pages after a build
+ *              --lookups after appending entries (with table growth)
+ *              --the writer's list of entries changed in a tick
+ *              --the diff of two indices
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_md_index_hash()
+{
+    H5FD_vfd_swmr_idx_hash_t hash;              /* Index hash */
+    H5FD_vfd_swmr_idx_entry_t *idx = NULL;    /* Metadata file idx */
+    H5FD_vfd_swmr_idx_entry_t *new_idx = NULL; /* Index at the next tick */
+    uint64_t *changed = NULL;                   /* Changed pages */
+    uint32_t nchanged;                          /* # of changed pages */
+    uint32_t u;                                 /* Local idx variable */
+
+    TESTING("VFD SWMR metadata file idx hash")
+
+    HDmemset(&hash, 0, sizeof(hash));
+    if(NULL == (idx = (H5FD_vfd_swmr_idx_entry_t *)HDcalloc(4 * NX * NY, sizeof(H5FD_vfd_swmr_idx_entry_t))))
+        TEST_ERROR
+    if(NULL == (new_idx = (H5FD_vfd_swmr_idx_entry_t *)HDcalloc(4 * NX * NY, sizeof(H5FD_vfd_swmr_idx_entry_t))))
+        TEST_ERROR
+    if(NULL == (changed = (uint64_t *)HDcalloc(8 * NX * NY, sizeof(uint64_t))))
+        TEST_ERROR
+
+    /* Build over every third page */
+    for(u = 0; u < NX * NY; u++) {
+        idx[u].hdf5_page_offset = 3 * u;
+        idx[u].md_file_page_offset = u + 1;
+        idx[u].length = 4096;
+    } /* end for */
+    if(H5FD_vfd_swmr_idx_hash_build(&hash, idx, NX * NY) < 0)
+        FAIL_STACK_ERROR
+
+    for(u = 0; u < NX * NY; u++) {
+        if(H5FD_vfd_swmr_idx_hash_lookup(&hash, idx, 3 * u) != &idx[u])
+            TEST_ERROR
+        if(H5FD_vfd_swmr_idx_hash_lookup(&hash, idx, 3 * u + 1) != NULL)
+            TEST_ERROR
+    } /* end for */
+
+    /* Append entries in one tick, forcing the table to grow */
+    for(u = NX * NY; u < 4 * NX * NY; u++) {
+        idx[u].hdf5_page_offset = 3 * u;
+        if(H5FD_vfd_swmr_idx_hash_insert(&hash, idx) < 0)
+            FAIL_STACK_ERROR
+        if(H5FD_vfd_swmr_idx_hash_touch(&hash, idx, &idx[u], 1) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+    for(u = 0; u < 4 * NX * NY; u++)
+        if(H5FD_vfd_swmr_idx_hash_lookup(&hash, idx, 3 * u) != &idx[u])
+            TEST_ERROR
+
+    /* Touching an entry twice in a tick records it once */
+    if(H5FD_vfd_swmr_idx_hash_touch(&hash, idx, &idx[0], 1) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_idx_hash_touch(&hash, idx, &idx[0], 1) < 0)
+        FAIL_STACK_ERROR
+    if(hash.nchanged != 3 * NX * NY + 1)
+        TEST_ERROR
+    if(H5FD_vfd_swmr_idx_hash_reset_changed(&hash) < 0)
+        FAIL_STACK_ERROR
+    if(hash.nchanged != 0)
+        TEST_ERROR
+
+    /* Diff: one entry moved, one removed, one added */
+    HDmemcpy(new_idx, idx, NX * NY * sizeof(H5FD_vfd_swmr_idx_entry_t));
+    new_idx[10].md_file_page_offset = 0;
+    HDmemmove(&new_idx[20], &new_idx[21], (NX * NY - 21) * sizeof(H5FD_vfd_swmr_idx_entry_t));
+    new_idx[NX * NY - 1].hdf5_page_offset = 3 * NX * NY;
+    if(H5FD_vfd_swmr_idx_diff(idx, NX * NY, new_idx, NX * NY, changed, &nchanged) < 0)
+        FAIL_STACK_ERROR
+    if(nchanged != 3 || changed[0] != 30 || changed[1] != 60 || changed[2] != 3 * NX * NY)
+        TEST_ERROR
+
+    if(H5FD_vfd_swmr_idx_hash_dest(&hash) < 0)
+        FAIL_STACK_ERROR
+    HDfree(idx);
+    HDfree(new_idx);
+    HDfree(changed);
+
+    PASSED()
+    return 0;
+
+error:
+    H5FD_vfd_swmr_idx_hash_dest(&hash);
+    if(idx)
+        HDfree(idx);
+    if(new_idx)
+        HDfree(new_idx);
+    if(changed)
+        HDfree(changed);
+
+    return 1;
+} /* test_md_index_hash() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_md_index_delta()
+ *
+ * Purpose:     Verify that a reader which replays a delta index record
+ *              onto the checkpoint it last read ends up with the writer's
+ *              index, after entries were changed, added and removed, and
+ *              that a corrupted delta is rejected.
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_md_index_delta()
+{
+    H5FD_vfd_swmr_idx_hash_t hash;              /* Writer's index hash */
+    H5FD_vfd_swmr_idx_entry_t widx[NX + 2];     /* Writer's index */
+    H5FD_vfd_swmr_idx_entry_t ridx[NX + 2];     /* Reader's index */
+    H5FD_vfd_swmr_delta_t delta;                /* Decoded delta */
+    uint8_t *image = NULL;                      /* Full index image */
+    uint8_t *dimage = NULL;                     /* Delta index image */
+    uint32_t nw = NX, nr = 0;                   /* # of writer & reader entries */
+    uint64_t tick;                              /* Tick of the full index */
+    size_t dsize;                               /* Size of the delta */
+    uint32_t u;                                 /* Local index variable */
+    herr_t ret;                                 /* Generic return value */
+
+    TESTING("VFD SWMR metadata file delta index")
+
+    HDmemset(&hash, 0, sizeof(hash));
+    HDmemset(widx, 0, sizeof(widx));
+    if(NULL == (image = (uint8_t *)HDmalloc(H5FD_MD_INDEX_SIZE(NX))))
+        TEST_ERROR
+    if(NULL == (dimage = (uint8_t *)HDmalloc(H5FD_MD_DELTA_SIZE(NX + 2, NX))))
+        TEST_ERROR
+
+    /* Checkpoint at tick 1 over the even pages */
+    for(u = 0; u < NX; u++) {
+        widx[u].hdf5_page_offset = 2 * u;
+        widx[u].md_file_page_offset = u + 1;
+        widx[u].length = 4096;
+    } /* end for */
+    if(H5FD_vfd_swmr_idx_hash_build(&hash, widx, nw) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_idx_encode(image, 1, widx, nw) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_idx_decode(image, H5FD_MD_INDEX_SIZE(NX), &tick, ridx, &nr, NX + 2) < 0)
+        FAIL_STACK_ERROR
+    if(tick != 1 || nr != NX)
+        TEST_ERROR
+
+    /* Tick 2: move two entries, add a page at the end, remove one */
+    widx[5].md_file_page_offset = NX + 1;
+    if(H5FD_vfd_swmr_idx_hash_touch(&hash, widx, &widx[5], 2) < 0)
+        FAIL_STACK_ERROR
+    widx[50].md_file_page_offset = NX + 2;
+    if(H5FD_vfd_swmr_idx_hash_touch(&hash, widx, &widx[50], 2) < 0)
+        FAIL_STACK_ERROR
+    widx[nw].hdf5_page_offset = 2 * NX;
+    widx[nw].md_file_page_offset = NX + 3;
+    widx[nw].length = 8192;
+    if(H5FD_vfd_swmr_idx_hash_insert(&hash, widx) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_idx_hash_touch(&hash, widx, &widx[nw], 2) < 0)
+        FAIL_STACK_ERROR
+    nw++;
+    widx[7].is_moved_to_hdf5_file = TRUE;
+    if(H5FD_vfd_swmr_idx_hash_remove_moved(&hash, widx, &nw) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_delta_prepare(&hash, widx) < 0)
+        FAIL_STACK_ERROR
+    if(hash.nchanged != 3 || hash.nremoved != 1)
+        TEST_ERROR
+    if(H5FD_vfd_swmr_delta_want_checkpoint(&hash, 2, 1))
+        TEST_ERROR
+    if(!H5FD_vfd_swmr_delta_want_checkpoint(&hash, 1 + H5FD_MD_DELTA_MAX_TICKS, 1))
+        TEST_ERROR
+    dsize = H5FD_MD_DELTA_SIZE(hash.nchanged, hash.nremoved);
+    if(H5FD_vfd_swmr_delta_encode(dimage, &hash, widx, 2, 1, 0, H5FD_MD_INDEX_SIZE(NX)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Reader replays the delta */
+    if(H5FD_vfd_swmr_delta_decode(dimage, dsize, &delta) < 0)
+        FAIL_STACK_ERROR
+    if(delta.tick != 2 || delta.checkpoint_tick != 1)
+        TEST_ERROR
+    if(H5FD_vfd_swmr_delta_apply(&delta, ridx, &nr, NX + 2) < 0)
+        FAIL_STACK_ERROR
+    if(nr != nw)
+        TEST_ERROR
+    for(u = 0; u < nr; u++)
+        if(ridx[u].hdf5_page_offset != widx[u].hdf5_page_offset
+                || ridx[u].md_file_page_offset != widx[u].md_file_page_offset
+                || ridx[u].length != widx[u].length)
+            TEST_ERROR
+
+    /* Corrupted delta */
+    dimage[H5_SIZEOF_MAGIC] ^= 1;
+    H5E_BEGIN_TRY {
+        ret = H5FD_vfd_swmr_delta_decode(dimage, dsize, &delta);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        TEST_ERROR
+
+    if(H5FD_vfd_swmr_idx_hash_dest(&hash) < 0)
+        FAIL_STACK_ERROR
+    HDfree(image);
+    HDfree(dimage);
+
+    PASSED()
+    return 0;
+
+error:
+    H5FD_vfd_swmr_idx_hash_dest(&hash);
+    if(image)
+        HDfree(image);
+    if(dimage)
+        HDfree(dimage);
+
+    return 1;
+} /* test_md_index_delta() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_tick_notify()
+ *
+ * Purpose:     Verify the same-host tick notification channel:
+ *              --a reader finds no channel when no writer created one
+ *              --a published tick is seen once, with its index location
+ *              --waiting times out when no new tick is published
+ *              --the reader stops waiting once the writer closes
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_tick_notify()
+{
+    H5FD_vfd_swmr_notify_t *wchan = NULL;       /* Writer's channel */
+    H5FD_vfd_swmr_notify_t *rchan = NULL;       /* Reader's channel */
+    uint64_t tick = 0;                          /* Published tick */
+    haddr_t index_offset = HADDR_UNDEF;         /* Published index offset */
+    hsize_t index_length = 0;                   /* Published index length */
+
+    TESTING("VFD SWMR tick notification")
+
+    if(H5FD_vfd_swmr_notify_open("./notify_none.md", FALSE, &rchan) < 0)
+        FAIL_STACK_ERROR
+    if(rchan != NULL)
+        TEST_ERROR
+
+    if(H5FD_vfd_swmr_notify_open("./notify.md", TRUE, &wchan) < 0)
+        FAIL_STACK_ERROR
+    if(NULL == wchan) {
+        SKIPPED()
+        HDputs("    Tick notification is not supported on this platform");
+        return 0;
+    } /* end if */
+    if(H5FD_vfd_swmr_notify_open("./notify.md", FALSE, &rchan) < 0)
+        FAIL_STACK_ERROR
+    if(NULL == rchan)
+        TEST_ERROR
+
+    /* Nothing published yet */
+    if(H5FD_vfd_swmr_notify_wait(rchan, 0, 0, &tick, &index_offset, &index_length) != FALSE)
+        TEST_ERROR
+
+    if(H5FD_vfd_swmr_notify_publish(wchan, 1, 4096, H5FD_MD_INDEX_SIZE(2)) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_notify_wait(rchan, 0, 1000000, &tick, &index_offset, &index_length) != TRUE)
+        TEST_ERROR
+    if(tick != 1 || index_offset != 4096 || index_length != H5FD_MD_INDEX_SIZE(2))
+        TEST_ERROR
+
+    /* No newer tick: time out after 1 ms */
+    if(H5FD_vfd_swmr_notify_wait(rchan, 1, 1000000, &tick, NULL, NULL) != FALSE)
+        TEST_ERROR
+
+    /* Writer closes */
+    if(H5FD_vfd_swmr_notify_close(wchan) < 0)
+        FAIL_STACK_ERROR
+    wchan = NULL;
+    if(H5FD_vfd_swmr_notify_wait(rchan, 1, 1000000000, &tick, NULL, NULL) != FALSE)
+        TEST_ERROR
+    if(H5FD_vfd_swmr_notify_close(rchan) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED()
+    return 0;
+
+error:
+    if(rchan)
+        H5FD_vfd_swmr_notify_close(rchan);
+    if(wchan)
+        H5FD_vfd_swmr_notify_close(wchan);
+
+    return 1;
+} /* test_tick_notify() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_tick_pipeline()
+ *
+ * Purpose:     Verify the writer's tick pipeline:
+ *              --the writer can begin tick T + 1 while T is being written
+ *              --after waiting for the last tick, the metadata file holds
+ *                its header, index and pages
+ *              --ticks come out in order, none published twice
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_tick_pipeline()
+{
+    H5FD_vfd_swmr_flush_t *fl = NULL;           /* Tick pipeline */
+    H5FD_vfd_swmr_tick_t *snap = NULL;          /* Snapshot being filled */
+    H5FD_vfd_swmr_idx_entry_t idx[NY];          /* Writer's index */
+    H5FD_vfd_swmr_idx_entry_t ridx[NY];         /* Index read back */
+    uint8_t page[4096];                         /* Page image */
+    uint8_t hdr[H5FD_MD_HEADER_SIZE];           /* Header read back */
+    uint8_t *image = NULL;                      /* Index read back */
+    const uint8_t *p;                           /* Pointer into header */
+    uint64_t tick, flushed_tick = 0;            /* Ticks */
+    uint64_t index_offset, index_length;        /* Index location in the header */
+    uint32_t page_size, nr = 0;                 /* Page size & # of entries read back */
+    uint32_t u;                                 /* Local index variables */
+    int fd = -1;                                /* Metadata file descriptor */
+
+    TESTING("VFD SWMR writer tick pipeline")
+
+    if((fd = HDopen("./tick_pipeline.md", O_RDWR | O_CREAT | O_TRUNC, H5_POSIX_CREATE_MODE_RW)) < 0)
+        TEST_ERROR
+    if(NULL == (image = (uint8_t *)HDmalloc(H5FD_MD_INDEX_SIZE(NY))))
+        TEST_ERROR
+
+    /* Double buffered */
+    if(H5FD_vfd_swmr_flush_open(fd, 4096, 3, 1, NULL, &fl) < 0)
+        FAIL_STACK_ERROR
+
+    /* Each tick rewrites page U with the tick number, at metadata file
+     * page U + 1, and points the index at page NY + 1 */
+    for(tick = 1; tick <= NX; tick++) {
+        uint64_t last_flushed = flushed_tick;
+
+        if(H5FD_vfd_swmr_flush_begin(fl, tick, &snap) < 0)
+            FAIL_STACK_ERROR
+        for(u = 0; u < NY; u++) {
+            HDmemset(page, (int)((tick + u) & 0xff), sizeof(page));
+            idx[u].hdf5_page_offset = u;
+            idx[u].md_file_page_offset = u + 1;
+            idx[u].length = (uint32_t)sizeof(page);
+            if(H5FD_vfd_swmr_flush_add_page(fl, snap, idx[u].md_file_page_offset, page, idx[u].length) < 0)
+                FAIL_STACK_ERROR
+        } /* end for */
+        if(H5FD_vfd_swmr_flush_submit(fl, snap, idx, NY, (haddr_t)(NY + 1) * 4096) < 0)
+            FAIL_STACK_ERROR
+
+        /* The entries are the writer's again once submitted */
+        HDmemset(idx, 0, sizeof(idx));
+
+        if(H5FD_vfd_swmr_flush_wait(fl, 0, &flushed_tick) < 0)
+            FAIL_STACK_ERROR
+        if(flushed_tick < last_flushed || flushed_tick > tick)
+            TEST_ERROR
+    } /* end for */
+
+    if(H5FD_vfd_swmr_flush_wait(fl, NX, &flushed_tick) < 0)
+        FAIL_STACK_ERROR
+    if(flushed_tick != NX)
+        TEST_ERROR
+    if(H5FD_vfd_swmr_flush_close(fl) < 0)
+        FAIL_STACK_ERROR
+    fl = NULL;
+
+    /* Header */
+    if(HDpread(fd, hdr, sizeof(hdr), (HDoff_t)0) != (ssize_t)sizeof(hdr))
+        TEST_ERROR
+    if(HDmemcmp(hdr, H5FD_MD_HEADER_MAGIC, (size_t)H5_SIZEOF_MAGIC))
+        TEST_ERROR
+    p = hdr + H5_SIZEOF_MAGIC;
+    UINT32DECODE(p, page_size);
+    UINT64DECODE(p, tick);
+    UINT64DECODE(p, index_offset);
+    UINT64DECODE(p, index_length);
+    if(page_size != 4096 || tick != NX || index_offset != (NY + 1) * 4096 || index_length != H5FD_MD_INDEX_SIZE(NY))
+        TEST_ERROR
+
+    /* Index & pages of the last tick */
+    if(HDpread(fd, image, (size_t)index_length, (HDoff_t)index_offset) != (ssize_t)index_length)
+        TEST_ERROR
+    if(H5FD_vfd_swmr_idx_decode(image, (size_t)index_length, &tick, ridx, &nr, NY) < 0)
+        FAIL_STACK_ERROR
+    if(tick != NX || nr != NY)
+        TEST_ERROR
+    for(u = 0; u < NY; u++) {
+        if(ridx[u].hdf5_page_offset != u || ridx[u].md_file_page_offset != u + 1)
+            TEST_ERROR
+        if(HDpread(fd, page, sizeof(page), (HDoff_t)(u + 1) * 4096) != (ssize_t)sizeof(page))
+            TEST_ERROR
+        if(page[0] != (uint8_t)((NX + u) & 0xff) || page[sizeof(page) - 1] != page[0])
+            TEST_ERROR
+    } /* end for */
+
+    HDclose(fd);
+    HDremove("./tick_pipeline.md");
+    HDfree(image);
+
+    PASSED()
+    return 0;
+
+error:
+    if(fl)
+        H5FD_vfd_swmr_flush_close(fl);
+    if(fd >= 0) {
+        HDclose(fd);
+        HDremove("./tick_pipeline.md");
+    } /* end if */
+    if(image)
+        HDfree(image);
+
+    return 1;
+} /* test_tick_pipeline() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_md_space()
+ *
+ * Purpose:     Verify the metadata file free space:
+ *              --pages are allocated past the reserved pages
+ *              --freed pages aren't reused before max_lag ticks
+ *              --freed neighbours are merged, and the lowest fit is used
+ *              --neighbours of mixed sizes freed in any order merge into
+ *                one extent
+ *              --the end of allocated space shrinks when its last pages
+ *                are freed
+ *              --compaction moves the highest entries into lower holes
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_md_space()
+{
+    H5FD_vfd_swmr_md_space_t sp;                /* Free space */
+    H5FD_vfd_swmr_idx_entry_t idx[NY];          /* Index entries */
+    uint64_t pages[NY];                         /* Allocated pages */
+    uint64_t page;                              /* Allocated page */
+    uint32_t moved[NY], nmoved;                 /* Entries moved */
+    uint32_t u;                                 /* Local index variable */
+
+    TESTING("VFD SWMR metadata file free space")
+
+    /* 2 reserved pages, readers lag by up to 3 ticks */
+    H5FD_vfd_swmr_md_space_init(&sp, 4096, 2, 3);
+
+    /* One page each, from page 2 on */
+    for(u = 0; u < NY; u++) {
+        if(H5FD_vfd_swmr_md_space_alloc(&sp, 1, 4096, &pages[u]) < 0)
+            FAIL_STACK_ERROR
+        if(pages[u] != 2 + u)
+            TEST_ERROR
+    } /* end for */
+
+    /* A freed page waits for max_lag ticks */
+    if(H5FD_vfd_swmr_md_space_free(&sp, 2, pages[1], 4096) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_md_space_free(&sp, 2, pages[2], 4096) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_md_space_alloc(&sp, 4, 4096, &page) < 0)
+        FAIL_STACK_ERROR
+    if(page != 2 + NY || sp.nwaiting != 2)
+        TEST_ERROR
+    if(H5FD_vfd_swmr_md_space_free(&sp, 4, page, 4096) < 0)
+        FAIL_STACK_ERROR
+
+    /* ...then pages 3 and 4 are merged, and hold 2 pages */
+    if(H5FD_vfd_swmr_md_space_alloc(&sp, 5, 2 * 4096, &page) < 0)
+        FAIL_STACK_ERROR
+    if(page != pages[1] || sp.nfree != 0)
+        TEST_ERROR
+
+    /* Freeing the last page gives it back to the end of allocated space */
+    if(H5FD_vfd_swmr_md_space_alloc(&sp, 7, 4096, &page) < 0)
+        FAIL_STACK_ERROR
+    if(page != 2 + NY || sp.eoa_page != 3 + NY)
+        TEST_ERROR
+    if(H5FD_vfd_swmr_md_space_free(&sp, 7, page, 4096) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_md_space_free(&sp, 7, pages[NY - 1], 4096) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_md_space_alloc(&sp, 10, 100, &page) < 0)
+        FAIL_STACK_ERROR
+    if(page != 1 + NY || sp.eoa_page != 2 + NY || sp.nfree != 0)
+        TEST_ERROR
+    H5FD_vfd_swmr_md_space_dest(&sp);
+
+    /* Extents of several size classes, all but the last freed odd ones
+     * first, then even ones from the top down, come back as one extent
+     */
+    H5FD_vfd_swmr_md_space_init(&sp, 4096, 2, 3);
+    for(u = 0; u < NY; u++)
+        if(H5FD_vfd_swmr_md_space_alloc(&sp, 1, (u % 5 + 1) * 4096, &pages[u]) < 0)
+            FAIL_STACK_ERROR
+    for(u = 1; u < NY - 1; u += 2)
+        if(H5FD_vfd_swmr_md_space_free(&sp, 1, pages[u], (u % 5 + 1) * 4096) < 0)
+            FAIL_STACK_ERROR
+    for(u = NY; u >= 2; u -= 2)
+        if(H5FD_vfd_swmr_md_space_free(&sp, 2, pages[u - 2], ((u - 2) % 5 + 1) * 4096) < 0)
+            FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_md_space_alloc(&sp, 5, (uint32_t)(pages[NY - 1] - 2) * 4096, &page) < 0)
+        FAIL_STACK_ERROR
+    if(page != 2 || sp.nfree != 0 || sp.nwaiting != 0)
+        TEST_ERROR
+
+    /* ...and with the last one freed too, the file is empty again */
+    if(H5FD_vfd_swmr_md_space_free(&sp, 5, page, (uint32_t)(pages[NY - 1] - 2) * 4096) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_md_space_free(&sp, 5, pages[NY - 1], ((NY - 1) % 5 + 1) * 4096) < 0)
+        FAIL_STACK_ERROR
+    if(H5FD_vfd_swmr_md_space_alloc(&sp, 8, 4096, &page) < 0)
+        FAIL_STACK_ERROR
+    if(page != 2 || sp.eoa_page != 3 || sp.nfree != 0)
+        TEST_ERROR
+    H5FD_vfd_swmr_md_space_dest(&sp);
+
+    /* Compaction: entries at pages 2 .. NY + 1, the lower half freed */
+    H5FD_vfd_swmr_md_space_init(&sp, 4096, 2, 3);
+    HDmemset(idx, 0, sizeof(idx));
+    for(u = 0; u < NY; u++) {
+        idx[u].hdf5_page_offset = u;
+        idx[u].length = 4096;
+        if(H5FD_vfd_swmr_md_space_alloc(&sp, 1, idx[u].length, &idx[u].md_file_page_offset) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+    for(u = 0; u < NY / 2; u++) {
+        idx[u].is_moved_to_hdf5_file = TRUE;
+        if(H5FD_vfd_swmr_md_space_free(&sp, 1, idx[u].md_file_page_offset, idx[u].length) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+
+    /* Nothing moves before the holes are reusable */
+    if(H5FD_vfd_swmr_md_space_compact(&sp, NULL, idx, NY, 2, NY, moved, &nmoved) < 0)
+        FAIL_STACK_ERROR
+    if(nmoved != 0)
+        TEST_ERROR
+
+    /* Two moves per tick, highest first */
+    if(H5FD_vfd_swmr_md_space_compact(&sp, NULL, idx, NY, 4, 2, moved, &nmoved) < 0)
+        FAIL_STACK_ERROR
+    if(nmoved != 2 || moved[0] != NY - 1 || moved[1] != NY - 2)
+        TEST_ERROR
+    if(idx[NY - 1].md_file_page_offset != 2 || idx[NY - 2].md_file_page_offset != 3
+            || idx[NY - 1].tick_of_last_change != 4)
+        TEST_ERROR
+
+    /* Until no entry is above a hole; the moved pages come back after
+     * max_lag ticks, and the file shrinks to its live pages */
+    for(page = 5; page < 5 + NY; page++)
+        if(H5FD_vfd_swmr_md_space_compact(&sp, NULL, idx, NY, page, 2, moved, &nmoved) < 0)
+            FAIL_STACK_ERROR
+    if(sp.eoa_page != 2 + (NY - NY / 2) || sp.nfree != 0 || sp.nwaiting != 0)
+        TEST_ERROR
+    for(u = NY / 2; u < NY; u++)
+        if(idx[u].md_file_page_offset < 2 || idx[u].md_file_page_offset >= sp.eoa_page)
+            TEST_ERROR
+
+    H5FD_vfd_swmr_md_space_dest(&sp);
+
+    PASSED()
+    return 0;
+
+error:
+    H5FD_vfd_swmr_md_space_dest(&sp);
+
+    return 1;
+} /* test_md_space() */
+
 
 /*-------------------------------------------------------------------------
  * Function:    main()
@@ -689,6 +1287,11 @@ main(void)
     nerrors += test_fapl();
     nerrors += test_file_fapl();
     nerrors += test_file_end_tick();
+    nerrors += test_md_index_hash();
+    nerrors += test_md_index_delta();
+    nerrors += test_tick_notify();
+    nerrors += test_tick_pipeline();
+    nerrors += test_md_space();
 
     h5_clean_files(FILENAME, fapl);
 
@@ -132,6 +132,9 @@ typedef struct {
     hbool_t         merge;             /* Merge external file. */
     int             depth;	           /* Merge external file up to a specific depth. */
     hbool_t         prune;	           /* Don't follow external file. */
+    int             threads;           /* Number of filter threads for the pipelined copy */
+    hsize_t         mem_budget;        /* Bytes of buffers for copying a dataset (0 for the defaults) */
+    hsize_t         stripe_size;       /* File system stripe size to align hyperslabs to (0 for none) */
 } pack_opt_t;
 
 
@@ -196,6 +199,20 @@ int do_copy_refobjs(hid_t fidin,
                     trav_table_t *travt,
                     pack_opt_t *options);
 
+/*-------------------------------------------------------------------------
+ * pipeline module
+ *-------------------------------------------------------------------------
+ */
+
+typedef struct pipeline_t pipeline_t;
+
+pipeline_t* pipeline_init(int nthreads, size_t mem_budget);
+int         pipeline_copy(pipeline_t *pl,
+                          hid_t dset_in,
+                          hid_t dset_out,
+                          hid_t wtype_id);
+int         pipeline_end(pipeline_t *pl);
+
 /*-------------------------------------------------------------------------
  * filters and verify module
  *-------------------------------------------------------------------------
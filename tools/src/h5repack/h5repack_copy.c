@@ -33,12 +33,20 @@
 /* size of buffer/# of bytes to xfer at a time when copying userblock */
 #define USERBLOCK_XFER_SIZE     512
 #define LINK_BUF_SIZE   1024
+/* most chunks read before they are written by copy_chunks_raw() */
+#define RAW_CHUNK_BATCH 256
 /*-------------------------------------------------------------------------
  * local functions
  *-------------------------------------------------------------------------
  */
 static int get_hyperslab(hid_t dcpl_id, int rank_dset, hsize_t dims_dset[],
-        size_t size_datum, hsize_t dims_hslab[], hsize_t * hslab_nbytes_p);
+        size_t size_datum, hsize_t buf_size, hsize_t stripe_size,
+        hsize_t dims_hslab[], hsize_t * hslab_nbytes_p);
+static int same_chunk_storage(hid_t dset_in, hid_t dset_out);
+static int write_chunk_batch(hid_t dset_out, int rank, unsigned n, const hsize_t *offsets,
+        const uint32_t *masks, const hsize_t *sizes, const unsigned char *buf);
+static int copy_chunks_raw(hid_t dset_in, hid_t dset_out, size_t batch_nbytes_max,
+        void **buf_p, size_t *buf_nbytes_p);
 static void print_dataset_info(hid_t dcpl_id, char *objname, double per, int pr);
 static int do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
         pack_opt_t *options);
@@ -371,7 +379,7 @@ done:
  * Function: get_hyperslab
  *
  * Purpose: Calulate a hyperslab from a dataset for higher performance.
- *          The size of hyperslab is limitted by H5TOOLS_BUFSIZE.
+ *          The size of hyperslab is limitted by BUF_SIZE.
  *          Return the hyperslab dimentions and size in byte.
  *
  * Return:  0 - SUCCEED, -1 FAILED
@@ -381,6 +389,8 @@ done:
  *   rank_dset : [IN] dataset rank
  *   dims_dset[] : [IN] dataset dimentions
  *   size_datum : [IN] size of a data element in byte
+ *   buf_size : [IN] size of the hyperslab buffer in byte
+ *   stripe_size : [IN] file system stripe size in byte, or 0
  *   dims_hslab[] : [OUT] calculated hyperslab dimentions
  *   * hslab_nbytes_p : [OUT] total byte of the hyperslab
  *
@@ -397,19 +407,27 @@ done:
  *      the boundary would be dataset's dims.
  *
  *   The calulation starts from the last dimention (h5dump dims output).
+ *
+ *   In case 3, if the hyperslab is made of whole rows of the dataset and
+ *   STRIPE_SIZE is given, the number of rows is rounded down so that each
+ *   hyperslab is a whole number of stripes, as long as that leaves at least
+ *   one row: the writes then start and end on stripe boundaries of the
+ *   dataset (which are file system stripe boundaries if the dataset is
+ *   aligned, see -a).
  *-----------------------------------------*/
 
 int
 get_hyperslab(hid_t dcpl_id, int rank_dset, hsize_t dims_dset[],
-        size_t size_datum, hsize_t dims_hslab[], hsize_t * hslab_nbytes_p)
+        size_t size_datum, hsize_t buf_size, hsize_t stripe_size,
+        hsize_t dims_hslab[], hsize_t * hslab_nbytes_p)
 {
     int     k;
     H5D_layout_t dset_layout;
     int     rank_chunk;
     hsize_t dims_chunk[H5S_MAX_RANK];
     hsize_t size_chunk = 1;
-    hsize_t nchunk_fit;                   /* number of chunks that fits in hyperslab buffer (H5TOOLS_BUFSIZE) */
-    hsize_t ndatum_fit;                   /* number of dataum that fits in hyperslab buffer (H5TOOLS_BUFSIZE) */
+    hsize_t nchunk_fit;                   /* number of chunks that fits in hyperslab buffer (buf_size) */
+    hsize_t ndatum_fit;                   /* number of dataum that fits in hyperslab buffer (buf_size) */
     hsize_t chunk_dims_map[H5S_MAX_RANK]; /* mapped chunk dimentions */
     hsize_t hs_dims_map[H5S_MAX_RANK];    /* mapped hyperslab dimentions */
     hsize_t hslab_nbytes;                 /* size of hyperslab in byte */
@@ -432,7 +450,7 @@ get_hyperslab(hid_t dcpl_id, int rank_dset, hsize_t dims_dset[],
             size_chunk *= dims_chunk[k - 1];
 
         /* figure out how many chunks can fit in the hyperslab buffer */
-        nchunk_fit = (H5TOOLS_BUFSIZE / size_datum) / size_chunk;
+        nchunk_fit = (buf_size / size_datum) / size_chunk;
 
         /* 1. if a chunk fit in hyperslab buffer */
         if (nchunk_fit >= 1) {
@@ -476,7 +494,7 @@ get_hyperslab(hid_t dcpl_id, int rank_dset, hsize_t dims_dset[],
              * The calculation boundary is a chunk dims.
              */
             for (k = rank_dset; k > 0; --k) {
-                ndatum_fit = H5TOOLS_BUFSIZE / hslab_nbytes;
+                ndatum_fit = buf_size / hslab_nbytes;
 
                 /* if a datum is bigger than rest of buffer */
                 if (ndatum_fit == 0)
@@ -500,7 +518,7 @@ get_hyperslab(hid_t dcpl_id, int rank_dset, hsize_t dims_dset[],
          * The calculation boundary is dataset dims.
          */
         for (k = rank_dset; k > 0; --k) {
-            ndatum_fit = H5TOOLS_BUFSIZE / hslab_nbytes;
+            ndatum_fit = buf_size / hslab_nbytes;
 
             /* if a datum is bigger than rest of buffer */
             if (ndatum_fit == 0)
@@ -514,6 +532,30 @@ get_hyperslab(hid_t dcpl_id, int rank_dset, hsize_t dims_dset[],
             if (hslab_nbytes <= 0)
                 H5TOOLS_GOTO_ERROR((-1), "calculate total size for the hyperslab failed");
         }
+
+        /* align hyperslabs of whole rows to the stripe */
+        if (stripe_size > 0 && rank_dset > 0) {
+            hsize_t row_nbytes = hslab_nbytes / dims_hslab[0];
+            hsize_t a = row_nbytes, b = stripe_size, r;
+            hsize_t nrows_stripe;  /* rows in a whole number of stripes */
+
+            for (k = 1; k < rank_dset; k++)
+                if (dims_hslab[k] != dims_dset[k])
+                    break;
+
+            /* rows per stripe multiple = stripe_size / gcd(row_nbytes, stripe_size) */
+            while (b != 0) {
+                r = a % b;
+                a = b;
+                b = r;
+            }
+            nrows_stripe = stripe_size / a;
+
+            if (k == rank_dset && dims_hslab[0] < dims_dset[0] && dims_hslab[0] >= nrows_stripe) {
+                dims_hslab[0] -= dims_hslab[0] % nrows_stripe;
+                hslab_nbytes = row_nbytes * dims_hslab[0];
+            }
+        }
     }
 
     /* pass out the hyperslab size*/
@@ -523,6 +565,271 @@ done:
     return ret_value;
 } /* end get_hyperslab() */
 
+/*-------------------------------------------------------------------------
+ * Function: same_chunk_storage
+ *
+ * Purpose:  Check if the stored chunks of DSET_IN are valid chunks of
+ *           DSET_OUT as they are: both are chunked with the same chunk
+ *           dims, extent, fixed size datatype and filter pipeline,
+ *           including the filter parameters set for the dataset.
+ *
+ * Return:   1 - same, 0 - different, -1 FAILED
+ *-------------------------------------------------------------------------
+ */
+static int
+same_chunk_storage(hid_t dset_in, hid_t dset_out)
+{
+    hid_t    dcpl[2] = {H5I_INVALID_HID, H5I_INVALID_HID};
+    hid_t    tid[2] = {H5I_INVALID_HID, H5I_INVALID_HID};
+    hid_t    sid[2] = {H5I_INVALID_HID, H5I_INVALID_HID};
+    hid_t    dset[2];
+    int      rank[2];
+    int      nfilters[2];
+    unsigned opts[2];
+    hsize_t  dims[2][H5S_MAX_RANK];
+    hsize_t  chunk_dims[2][H5S_MAX_RANK];
+    htri_t   equal;
+    int      j, f;
+    int      ret_value = 1;
+
+    dset[0] = dset_in;
+    dset[1] = dset_out;
+    for (j = 0; j < 2; j++) {
+        if ((dcpl[j] = H5Dget_create_plist(dset[j])) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Dget_create_plist failed");
+        if (H5Pget_layout(dcpl[j]) != H5D_CHUNKED)
+            H5TOOLS_GOTO_DONE(0);
+        if ((tid[j] = H5Dget_type(dset[j])) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Dget_type failed");
+        if ((sid[j] = H5Dget_space(dset[j])) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Dget_space failed");
+        if ((rank[j] = H5Sget_simple_extent_ndims(sid[j])) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Sget_simple_extent_ndims failed");
+        if (H5Sget_simple_extent_dims(sid[j], dims[j], NULL) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Sget_simple_extent_dims failed");
+        if (H5Pget_chunk(dcpl[j], rank[j], chunk_dims[j]) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Pget_chunk failed");
+        if (H5Pget_chunk_opts(dcpl[j], &opts[j]) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Pget_chunk_opts failed");
+        if ((nfilters[j] = H5Pget_nfilters(dcpl[j])) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Pget_nfilters failed");
+    }
+
+    /* VL and reference data point outside the chunks */
+    if (H5Tdetect_class(tid[0], H5T_VLEN) != FALSE || H5Tdetect_class(tid[0], H5T_REFERENCE) != FALSE
+            || H5Tis_variable_str(tid[0]) != FALSE)
+        H5TOOLS_GOTO_DONE(0);
+    if ((equal = H5Tequal(tid[0], tid[1])) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Tequal failed");
+    if (!equal)
+        H5TOOLS_GOTO_DONE(0);
+
+    if (rank[0] != rank[1] || opts[0] != opts[1] || nfilters[0] != nfilters[1])
+        H5TOOLS_GOTO_DONE(0);
+    for (j = 0; j < rank[0]; j++)
+        if (dims[0][j] != dims[1][j] || chunk_dims[0][j] != chunk_dims[1][j])
+            H5TOOLS_GOTO_DONE(0);
+
+    for (f = 0; f < nfilters[0]; f++) {
+        unsigned     flags[2];
+        unsigned     cd_values[2][CD_VALUES];
+        size_t       cd_nelmts[2];
+        unsigned     config;
+        H5Z_filter_t filtn[2];
+
+        for (j = 0; j < 2; j++) {
+            cd_nelmts[j] = CD_VALUES;
+            if ((filtn[j] = H5Pget_filter2(dcpl[j], (unsigned)f, &flags[j], &cd_nelmts[j], cd_values[j], 0, NULL, &config)) < 0)
+                H5TOOLS_GOTO_ERROR((-1), "H5Pget_filter2 failed");
+        }
+        if (filtn[0] != filtn[1] || flags[0] != flags[1] || cd_nelmts[0] != cd_nelmts[1])
+            H5TOOLS_GOTO_DONE(0);
+        if (HDmemcmp(cd_values[0], cd_values[1], MIN(cd_nelmts[0], CD_VALUES) * sizeof(unsigned)))
+            H5TOOLS_GOTO_DONE(0);
+    }
+
+done:
+    H5E_BEGIN_TRY {
+        for (j = 0; j < 2; j++) {
+            H5Sclose(sid[j]);
+            H5Tclose(tid[j]);
+            H5Pclose(dcpl[j]);
+        }
+    } H5E_END_TRY;
+
+    return ret_value;
+} /* end same_chunk_storage() */
+
+/*-------------------------------------------------------------------------
+ * Function: write_chunk_batch
+ *
+ * Purpose:  Write the N chunks read into BUF by copy_chunks_raw(), one
+ *           after the other, to DSET_OUT.
+ *
+ * Return:   0 - SUCCEED, -1 FAILED
+ *-------------------------------------------------------------------------
+ */
+static int
+write_chunk_batch(hid_t dset_out, int rank, unsigned n, const hsize_t *offsets,
+        const uint32_t *masks, const hsize_t *sizes, const unsigned char *buf)
+{
+    size_t   pos = 0;
+    unsigned u;
+    int      ret_value = 0;
+
+    for (u = 0; u < n; u++) {
+        if (H5Dwrite_chunk(dset_out, H5P_DEFAULT, masks[u], offsets + u * (unsigned)rank,
+                (size_t)sizes[u], buf + pos) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Dwrite_chunk failed");
+        pos += (size_t)sizes[u];
+    }
+
+done:
+    return ret_value;
+} /* end write_chunk_batch() */
+
+/*-------------------------------------------------------------------------
+ * Function: copy_chunks_raw
+ *
+ * Purpose:  Copy the stored chunks of DSET_IN to DSET_OUT as they are,
+ *           with H5Dread_chunk() and H5Dwrite_chunk(), without running
+ *           the filters, when same_chunk_storage() allows it.
+ *
+ *           The chunks are visited in logical order and read in batches
+ *           of up to RAW_CHUNK_BATCH chunks or BATCH_NBYTES_MAX bytes
+ *           before the batch is written, so that reads and writes each
+ *           run through their file in long sequences.  Chunks that were
+ *           never written are left unallocated in the output too.
+ *
+ *           The batch is read into *BUF_P, of *BUF_NBYTES_P bytes, which
+ *           is grown as needed and kept for the next dataset.
+ *
+ * Return:   1 - copied, 0 - can't be copied this way, nothing was
+ *           written, -1 FAILED
+ *-------------------------------------------------------------------------
+ */
+static int
+copy_chunks_raw(hid_t dset_in, hid_t dset_out, size_t batch_nbytes_max,
+        void **buf_p, size_t *buf_nbytes_p)
+{
+    hid_t    dcpl_id = H5I_INVALID_HID;
+    hid_t    f_space_id = H5I_INVALID_HID;
+    int      rank;
+    int      k;
+    hsize_t  dims[H5S_MAX_RANK];
+    hsize_t  chunk_dims[H5S_MAX_RANK];
+    hsize_t  nchunks_dim[H5S_MAX_RANK];
+    hsize_t  nchunks = 1;
+    hsize_t  chunkno;
+    hsize_t *batch_offset = NULL;          /* offsets of the chunks in the batch */
+    uint32_t batch_mask[RAW_CHUNK_BATCH];  /* filter masks of the chunks */
+    hsize_t  batch_size[RAW_CHUNK_BATCH];  /* sizes of the chunks */
+    unsigned batch_n = 0;                  /* chunks in the batch */
+    size_t   batch_nbytes = 0;             /* bytes in the batch */
+    size_t   buf_size;
+    unsigned char *buf;
+    int      ret_value = 1;
+
+    if ((ret_value = same_chunk_storage(dset_in, dset_out)) <= 0)
+        goto done;
+
+    if ((dcpl_id = H5Dget_create_plist(dset_in)) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Dget_create_plist failed");
+    if ((f_space_id = H5Dget_space(dset_in)) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Dget_space failed");
+    if ((rank = H5Sget_simple_extent_ndims(f_space_id)) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Sget_simple_extent_ndims failed");
+    if (H5Sget_simple_extent_dims(f_space_id, dims, NULL) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Sget_simple_extent_dims failed");
+    if (H5Pget_chunk(dcpl_id, rank, chunk_dims) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Pget_chunk failed");
+
+    for (k = 0; k < rank; k++) {
+        nchunks_dim[k] = (dims[k] + chunk_dims[k] - 1) / chunk_dims[k];
+        nchunks *= nchunks_dim[k];
+    }
+
+    if (NULL == (batch_offset = (hsize_t *)HDmalloc(RAW_CHUNK_BATCH * (size_t)MAX(rank, 1) * sizeof(hsize_t))))
+        H5TOOLS_GOTO_ERROR((-1), "can't allocate space for chunk offsets");
+    buf_size = MAX(batch_nbytes_max, *buf_nbytes_p);
+    if (buf_size > *buf_nbytes_p) {
+        if (*buf_p)
+            HDfree(*buf_p);
+        *buf_nbytes_p = 0;
+        if (NULL == (*buf_p = HDmalloc(buf_size)))
+            H5TOOLS_GOTO_ERROR((-1), "can't allocate space for chunks");
+        *buf_nbytes_p = buf_size;
+    }
+    buf = (unsigned char *)*buf_p;
+
+    for (chunkno = 0; chunkno < nchunks; chunkno++) {
+        hsize_t *offset = batch_offset + batch_n * (unsigned)rank;
+        hsize_t  idx = chunkno;
+        haddr_t  addr = HADDR_UNDEF;
+        hsize_t  size = 0;
+
+        /* offset of chunk CHUNKNO, in row-major chunk order */
+        for (k = rank; k > 0; --k) {
+            offset[k - 1] = (idx % nchunks_dim[k - 1]) * chunk_dims[k - 1];
+            idx /= nchunks_dim[k - 1];
+        }
+        if (H5Dget_chunk_info_by_coord(dset_in, offset, &batch_mask[batch_n], &addr, &size) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Dget_chunk_info_by_coord failed");
+
+        /* not written */
+        if (addr == HADDR_UNDEF || size == 0)
+            continue;
+
+        /* write the batch if the chunk doesn't fit, and start the next
+         * batch with the chunk */
+        if (batch_n > 0 && batch_nbytes + size > buf_size) {
+            if (write_chunk_batch(dset_out, rank, batch_n, batch_offset, batch_mask, batch_size, buf) < 0)
+                H5TOOLS_GOTO_ERROR((-1), "write_chunk_batch failed");
+            HDmemmove(batch_offset, offset, (size_t)rank * sizeof(hsize_t));
+            batch_mask[0] = batch_mask[batch_n];
+            offset = batch_offset;
+            batch_n = 0;
+            batch_nbytes = 0;
+        }
+
+        /* a chunk bigger than the buffer */
+        if (size > buf_size) {
+            HDfree(*buf_p);
+            *buf_nbytes_p = 0;
+            if (NULL == (*buf_p = HDmalloc((size_t)size)))
+                H5TOOLS_GOTO_ERROR((-1), "can't allocate space for chunks");
+            *buf_nbytes_p = buf_size = (size_t)size;
+            buf = (unsigned char *)*buf_p;
+        }
+
+        if (H5Dread_chunk(dset_in, H5P_DEFAULT, offset, &batch_mask[batch_n], buf + batch_nbytes) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Dread_chunk failed");
+        batch_size[batch_n] = size;
+        batch_nbytes += (size_t)size;
+
+        if (++batch_n == RAW_CHUNK_BATCH) {
+            if (write_chunk_batch(dset_out, rank, batch_n, batch_offset, batch_mask, batch_size, buf) < 0)
+                H5TOOLS_GOTO_ERROR((-1), "write_chunk_batch failed");
+            batch_n = 0;
+            batch_nbytes = 0;
+        }
+    }
+
+    if (batch_n > 0)
+        if (write_chunk_batch(dset_out, rank, batch_n, batch_offset, batch_mask, batch_size, buf) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "write_chunk_batch failed");
+
+done:
+    H5E_BEGIN_TRY {
+        H5Sclose(f_space_id);
+        H5Pclose(dcpl_id);
+    } H5E_END_TRY;
+    if (batch_offset)
+        HDfree(batch_offset);
+
+    return ret_value;
+} /* end copy_chunks_raw() */
+
 /*-------------------------------------------------------------------------
  * Function: do_copy_objects
  *
@@ -574,6 +881,10 @@ done:
  *     Selection would be same as the hyperslab except for the remaining edge portion
  *     of the dataset. The code take care of the remaining portion if exist.
  *
+ *  With --mem_budget=M, M replaces both H5TOOLS_MALLOCSIZE and H5TOOLS_BUFSIZE.
+ *  The whole-dataset and hyperslab buffers are kept and reused by the next
+ *  datasets, and only grown when a dataset needs more.
+ *
  *-------------------------------------------------------------------------
  */
 
@@ -605,7 +916,12 @@ do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
     int apply_s;         /* flag for apply filter to small dataset sizes */
     int apply_f;         /* flag for apply filter to return error on H5Dcreate */
     void *buf = NULL;    /* buffer for raw data */
+    size_t buf_nbytes = 0; /* bytes allocated for buf */
     void *hslab_buf = NULL; /* hyperslab buffer for raw data */
+    size_t hslab_buf_nbytes = 0; /* bytes allocated for hslab_buf */
+    pipeline_t *pl = NULL;  /* filter threads for --threads */
+    hsize_t malloc_size; /* largest dataset read in one operation */
+    hsize_t hslab_size;  /* size of the hyperslab buffer */
     int has_filter;      /* current object has a filter */
     int req_filter;      /* there was a request for a filter */
     int req_obj_layout = 0; /* request layout to current object */
@@ -630,10 +946,20 @@ do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
         HDprintf("-----------------------------------------\n");
     }
 
+    /* the buffers are kept from one dataset to the next, up to the memory
+     * budget if one is given */
+    malloc_size = options->mem_budget ? options->mem_budget : H5TOOLS_MALLOCSIZE;
+    hslab_size = options->mem_budget ? options->mem_budget : H5TOOLS_BUFSIZE;
+
+    /* start the filter threads; without them, copy serially */
+    if (options->threads > 1)
+        if (NULL == (pl = pipeline_init(options->threads, (size_t)options->mem_budget)))
+            if (options->verbose)
+                HDprintf(" warning: could not start %d threads, copying serially\n", options->threads);
+
     if (travt->objs) {
         for (i = 0; i < travt->nobjs; i++) {
             /* init variables per obj */
-            buf = NULL;
             limit_maxdims = FALSE;
 
             switch (travt->objs[i].type) {
@@ -710,6 +1036,9 @@ do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
             case H5TRAV_TYPE_DATASET:
             {
                 hbool_t use_h5ocopy;
+                double t_start;             /* time the data copy started */
+                double t_copy = 0.0;        /* seconds to copy the data */
+                const char *copy_method = NULL; /* how the data was copied */
 
                 has_filter = 0;
                 req_filter = 0;
@@ -946,12 +1275,39 @@ do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
                              */
                             if (nelmts > 0 && space_status != H5D_SPACE_STATUS_NOT_ALLOCATED) {
                                 size_t need = (size_t)(nelmts * msize); /* bytes needed */
+                                int copied; /* copied by chunks */
+                                hbool_t use_buf = FALSE; /* read the whole dataset into buf */
+
+                                t_start = H5_get_time();
+
+                                /* copy the stored chunks as they are if the filters,
+                                 * chunking and datatype don't change */
+                                if ((copied = copy_chunks_raw(dset_in, dset_out, (size_t)hslab_size, &hslab_buf, &hslab_buf_nbytes)) < 0)
+                                    H5TOOLS_GOTO_ERROR((-1), "copy_chunks_raw failed");
+                                if (copied)
+                                    copy_method = "raw chunks";
+
+                                /* else read, filter and write chunks in parallel if we can */
+                                if (!copied && pl != NULL)
+                                    if ((copied = pipeline_copy(pl, dset_in, dset_out, wtype_id)) < 0)
+                                        H5TOOLS_GOTO_ERROR((-1), "pipeline_copy failed");
+                                if (copied && !copy_method)
+                                    copy_method = "pipeline";
 
                                 /* have to read the whole dataset if there is only one element in the dataset */
-                                if (need < H5TOOLS_MALLOCSIZE)
-                                    buf = HDmalloc(need);
+                                if (!copied && need < malloc_size) {
+                                    if (need > buf_nbytes) {
+                                        if (buf != NULL)
+                                            HDfree(buf);
+                                        buf_nbytes = 0;
+                                        if (NULL != (buf = HDmalloc(need)))
+                                            buf_nbytes = need;
+                                    }
+                                    use_buf = (buf != NULL);
+                                }
 
-                                if (buf != NULL) {
+                                if (use_buf) {
+                                    copy_method = "one read";
                                     if(H5Dread(dset_in, wtype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
                                         H5TOOLS_GOTO_ERROR((-1), "H5Dread failed");
                                     if(H5Dwrite(dset_out, wtype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
@@ -962,13 +1318,8 @@ do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
                                     if (TRUE == H5Tdetect_class(wtype_id, H5T_VLEN))
                                         if (H5Treclaim(wtype_id, f_space_id, H5P_DEFAULT, buf) < 0)
                                             H5TOOLS_GOTO_ERROR((-1), "H5Treclaim failed");
-
-                                    if (buf != NULL) { /* TODO: is buf potentially released by H5Dvlen_reclaim()? */
-                                        HDfree(buf);
-                                        buf = NULL;
-                                    }
                                 }
-                                else { /* possibly not enough memory, read/write by hyperslabs */
+                                else if (!copied) { /* possibly not enough memory, read/write by hyperslabs */
                                     size_t p_type_nbytes = msize; /*size of memory type */
                                     hsize_t p_nelmts = nelmts; /*total elements */
                                     hsize_t elmtno; /*counter  */
@@ -1006,12 +1357,19 @@ do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
                                     }
 
                                     /* get hyperslab dims and size in byte */
-                                    if (get_hyperslab(dcpl_tmp, rank, dims, p_type_nbytes, hslab_dims, &hslab_nbytes) < 0)
+                                    if (get_hyperslab(dcpl_tmp, rank, dims, p_type_nbytes, hslab_size, options->stripe_size, hslab_dims, &hslab_nbytes) < 0)
                                         H5TOOLS_GOTO_ERROR((-1), "get_hyperslab failed");
 
-                                    hslab_buf = HDmalloc((size_t)hslab_nbytes);
-                                    if (hslab_buf == NULL)
-                                        H5TOOLS_GOTO_ERROR((-1), "can't allocate space for hyperslab");
+                                    copy_method = "hyperslabs";
+                                    if (hslab_nbytes > hslab_buf_nbytes) {
+                                        if (hslab_buf != NULL)
+                                            HDfree(hslab_buf);
+                                        hslab_buf_nbytes = 0;
+                                        hslab_buf = HDmalloc((size_t)hslab_nbytes);
+                                        if (hslab_buf == NULL)
+                                            H5TOOLS_GOTO_ERROR((-1), "can't allocate space for hyperslab");
+                                        hslab_buf_nbytes = (size_t)hslab_nbytes;
+                                    }
 
                                     hslab_nelmts = hslab_nbytes / p_type_nbytes;
                                     hslab_space = H5Screate_simple(1, &hslab_nelmts, NULL);
@@ -1066,11 +1424,9 @@ do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
                                     } /* end for (hyperslab selection loop) */
 
                                     H5Sclose(hslab_space);
-                                    if (hslab_buf != NULL) {
-                                        HDfree(hslab_buf);
-                                        hslab_buf = NULL;
-                                    }
                                 } /* end if reading/writing by hyperslab */
+
+                                t_copy = H5_get_time() - t_start;
                             } /* end if (nelmts > 0 && space_status != H5D_SPACE_STATUS_NOT_ALLOCATED) */
 
                             /*-------------------------------------------------------------------------
@@ -1101,6 +1457,12 @@ do_copy_objects(hid_t fidin, hid_t fidout, trav_table_t *travt,
 
                                 if (has_filter && apply_f == 0)
                                     HDprintf(" <warning: could not apply the filter to %s>\n", travt->objs[i].name);
+
+                                /* print the throughput, to tune the memory budget */
+                                if (copy_method)
+                                    HDprintf("  %-27s %.1f MB/s (%llu bytes in %.3f s, %s)\n", "",
+                                            t_copy > 0.0 ? (double)size_dset / t_copy / (1024.0 * 1024.0) : 0.0,
+                                            (unsigned long long)size_dset, t_copy, copy_method);
                             } /* end if verbose (print compression) */
 
                             /*-------------------------------------------------------------------------
@@ -1310,6 +1672,7 @@ done:
         HDfree(buf);
     if (hslab_buf != NULL)
         HDfree(hslab_buf);
+    pipeline_end(pl);
 
     return ret_value;
 } /* end do_copy_objects() */
@@ -70,7 +70,10 @@ static struct long_options l_opts[] = {
     { "dst-vol-info",        require_arg, '6' },
     { "depth",        require_arg, 'x' },
     { "merge",        no_arg, 'X' },
-    { "prune",        no_arg, 'p' },            
+    { "prune",        no_arg, 'p' },
+    { "threads",      require_arg, '7' },
+    { "mem_budget",   require_arg, '8' },
+    { "stripe_size",  require_arg, '9' },
     { NULL, 0, '\0' }
 };
 
@@ -138,6 +141,14 @@ static void usage(const char *prog) {
     PRINTVALSTREAM(rawoutstream, "                           for H5Pset_file_space_strategy\n");
     PRINTVALSTREAM(rawoutstream, "   -G FS_PAGESIZE, --fs_pagesize=FS_PAGESIZE   File space page size for\n");
     PRINTVALSTREAM(rawoutstream, "                           H5Pset_file_space_page_size\n");
+    PRINTVALSTREAM(rawoutstream, "   --threads=N             Filter (compress) chunks of each dataset with N\n");
+    PRINTVALSTREAM(rawoutstream, "                           threads while reading and writing. The output file\n");
+    PRINTVALSTREAM(rawoutstream, "                           is the same for any N\n");
+    PRINTVALSTREAM(rawoutstream, "   --mem_budget=SIZE       Memory to use for the buffers copying a dataset\n");
+    PRINTVALSTREAM(rawoutstream, "                           (default is up to 128M for datasets read at once,\n");
+    PRINTVALSTREAM(rawoutstream, "                           1M for the hyperslabs of larger ones)\n");
+    PRINTVALSTREAM(rawoutstream, "   --stripe_size=SIZE      Make the hyperslabs of contiguous datasets whole\n");
+    PRINTVALSTREAM(rawoutstream, "                           numbers of file system stripes of SIZE\n");
     PRINTVALSTREAM(rawoutstream, "\n");
     PRINTVALSTREAM(rawoutstream, "    M - is an integer greater than 1, size of dataset in bytes (default is 0)\n");
     PRINTVALSTREAM(rawoutstream, "    E - is a filename.\n");
@@ -153,6 +164,7 @@ static void usage(const char *prog) {
     PRINTVALSTREAM(rawoutstream, "        a power of 2 (1024 default)\n");
     PRINTVALSTREAM(rawoutstream, "    F - is the shared object header message type, any of <dspace|dtype|fill|\n");
     PRINTVALSTREAM(rawoutstream, "        pline|attr>. If F is not specified, S applies to all messages\n");
+    PRINTVALSTREAM(rawoutstream, "    SIZE - is a number of bytes, optionally followed by K, M or G\n");
     PRINTVALSTREAM(rawoutstream, "\n");
     PRINTVALSTREAM(rawoutstream, "    BOUND is an integer indicating the library release versions to use when\n");
     PRINTVALSTREAM(rawoutstream, "          creating objects in the file (see H5Pset_libver_bounds()):\n");
@@ -426,6 +438,48 @@ set_sort_order(const char *form)
     return iter_order;
 }
 
+/*-------------------------------------------------------------------------
+ * Function:    set_size
+ *
+ * Purpose: translate a size string input parameter, a number of bytes
+ *          optionally followed by K, M or G (for KiB, MiB or GiB), to
+ *          a hsize_t return value
+ *
+ * Return: size in bytes, or 0 if the string is not a size
+ *-------------------------------------------------------------------------
+ */
+static hsize_t
+set_size(const char *form)
+{
+    char   *end = NULL;
+    hsize_t size = (hsize_t)HDstrtoull(form, &end, 0);
+
+    if (end == form)
+        return 0;
+
+    switch (*end) {
+        case 'k':
+        case 'K':
+            size <<= 10;
+            end++;
+            break;
+        case 'm':
+        case 'M':
+            size <<= 20;
+            end++;
+            break;
+        case 'g':
+        case 'G':
+            size <<= 30;
+            end++;
+            break;
+        default:
+            break;
+    }
+
+    return *end == '\0' ? size : 0;
+}
+
 /*-------------------------------------------------------------------------
  * Function: parse_command_line
  *
@@ -716,6 +770,34 @@ int parse_command_line(int argc, const char **argv, pack_opt_t* options)
                 out_vol_info.info_string = opt_arg;
                 break;
 
+            case '7':
+                options->threads = HDatoi(opt_arg);
+                if (options->threads < 1) {
+                    error_msg("invalid number of threads <%s>\n", opt_arg);
+                    h5tools_setstatus(EXIT_FAILURE);
+                    ret_value = -1;
+                    goto done;
+                }
+                break;
+
+            case '8':
+                if (0 == (options->mem_budget = set_size(opt_arg))) {
+                    error_msg("invalid memory budget <%s>\n", opt_arg);
+                    h5tools_setstatus(EXIT_FAILURE);
+                    ret_value = -1;
+                    goto done;
+                }
+                break;
+
+            case '9':
+                if (0 == (options->stripe_size = set_size(opt_arg))) {
+                    error_msg("invalid stripe size <%s>\n", opt_arg);
+                    h5tools_setstatus(EXIT_FAILURE);
+                    ret_value = -1;
+                    goto done;
+                }
+                break;
+
 	case 'X':
 	  options->merge = TRUE;
 	  break;
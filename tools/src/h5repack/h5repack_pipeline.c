@@ -0,0 +1,625 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Board of Trustees of the University of Illinois.         *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Pipelined dataset copy for the --threads option.
+ *
+ * The copy of a chunked output dataset is split in three stages:
+ *
+ *  reader: the main thread reads each output chunk with H5Dread() into a
+ *          free slot and queues it;
+ *  filter: the worker threads run the output filter pipeline (shuffle and
+ *          deflate) on queued slots;
+ *  writer: the main thread writes the filtered chunks, in chunk order, with
+ *          H5Dwrite_chunk().
+ *
+ * The number of slots bounds the chunks in flight, and with them the
+ * memory used; the slots are kept for the next dataset while its chunks
+ * fit, and a memory budget, if given, caps the number of slots.  The library is only ever called from the main thread, so
+ * this works with or without a thread-safe library, and since chunks are
+ * written in a fixed order with the same bytes as the library's filters
+ * produce, the output file doesn't depend on the number of threads.
+ */
+
+#include "h5repack.h"
+#include "h5tools.h"
+#include "h5tools_utils.h"
+
+#if defined(H5_HAVE_PTHREAD_H) && defined(H5_HAVE_FILTER_DEFLATE)
+#define H5REPACK_HAVE_PIPELINE
+#include <pthread.h>
+#if defined(H5_HAVE_ZLIB_H) && !defined(H5_ZLIB_HEADER)
+#define H5_ZLIB_HEADER "zlib.h"
+#endif
+#if defined(H5_ZLIB_HEADER)
+#include H5_ZLIB_HEADER
+#endif
+#endif
+
+/*-------------------------------------------------------------------------
+ * macros
+ *-------------------------------------------------------------------------
+ */
+
+/* maximum number of filter threads */
+#define PIPELINE_MAX_THREADS    64
+
+/* chunks in flight per filter thread */
+#define PIPELINE_SLOTS_PER_THREAD 2
+
+/*-------------------------------------------------------------------------
+ * typedefs
+ *-------------------------------------------------------------------------
+ */
+
+#ifdef H5REPACK_HAVE_PIPELINE
+
+/* state of a slot */
+typedef enum {
+    SLOT_FREE = 0,  /* unused */
+    SLOT_QUEUED,    /* read, waiting for a filter thread */
+    SLOT_DONE       /* filtered, waiting to be written */
+} slot_state_t;
+
+/* one chunk in flight */
+typedef struct {
+    slot_state_t state;
+    hsize_t      offset[H5S_MAX_RANK]; /* logical offset of the chunk */
+    void        *buf;                  /* chunk, then filtered chunk */
+    void        *tmp;                  /* filter output */
+    size_t       nbytes;               /* bytes in buf */
+    uint32_t     filter_mask;          /* filters skipped */
+    int          status;               /* 0, ok, -1 filter failed */
+} slot_t;
+
+/* a filter of the output pipeline */
+typedef struct {
+    H5Z_filter_t filtn;
+    unsigned     flags;
+    unsigned     cd_value;             /* shuffle: type size, deflate: level */
+} pipe_filter_t;
+
+struct pipeline_t {
+    int             nthreads;
+    pthread_t       threads[PIPELINE_MAX_THREADS];
+    pthread_mutex_t mutex;
+    pthread_cond_t  work_cond;         /* a slot was queued or shutting down */
+    pthread_cond_t  done_cond;         /* a slot was filtered */
+    hbool_t         shutdown;
+    size_t          mem_budget;        /* bytes for all slots, 0 for no limit */
+
+    /* the dataset being copied */
+    pipe_filter_t   filter[H5_REPACK_MAX_NFILTERS];
+    int             nfilters;
+    size_t          tmp_nbytes;        /* bytes in each slot buffer */
+
+    /* the slots, and a FIFO of queued slot indices */
+    slot_t         *slots;
+    unsigned        nslots;
+    unsigned       *queue;
+    unsigned        q_head;
+    unsigned        q_count;
+};
+
+#endif /* H5REPACK_HAVE_PIPELINE */
+
+/*-------------------------------------------------------------------------
+ * local functions
+ *-------------------------------------------------------------------------
+ */
+#ifdef H5REPACK_HAVE_PIPELINE
+static void *pipeline_worker(void *arg);
+static int pipeline_filter(pipeline_t *pl, slot_t *slot);
+static int pipeline_setup(pipeline_t *pl, hid_t dcpl_id, size_t chunk_nbytes);
+static void pipeline_drain(pipeline_t *pl);
+static void pipeline_free_slots(pipeline_t *pl);
+#endif /* H5REPACK_HAVE_PIPELINE */
+
+
+/*-------------------------------------------------------------------------
+ * Function: pipeline_init
+ *
+ * Purpose:  start NTHREADS filter threads for pipeline_copy(), which
+ *           keeps the chunks in flight within MEM_BUDGET bytes (0 for
+ *           no limit) as long as each thread can have one
+ *
+ * Return:   the pipeline, or NULL if it can't be started or this build
+ *           has no pthreads or zlib (the caller then copies serially)
+ *-------------------------------------------------------------------------
+ */
+pipeline_t *
+pipeline_init(int nthreads, size_t mem_budget)
+{
+#ifdef H5REPACK_HAVE_PIPELINE
+    pipeline_t *pl = NULL;
+
+    if (nthreads < 1)
+        return NULL;
+    if (nthreads > PIPELINE_MAX_THREADS)
+        nthreads = PIPELINE_MAX_THREADS;
+
+    if (NULL == (pl = (pipeline_t *)HDcalloc(1, sizeof(pipeline_t))))
+        return NULL;
+    pl->mem_budget = mem_budget;
+    pthread_mutex_init(&pl->mutex, NULL);
+    pthread_cond_init(&pl->work_cond, NULL);
+    pthread_cond_init(&pl->done_cond, NULL);
+
+    for (pl->nthreads = 0; pl->nthreads < nthreads; pl->nthreads++)
+        if (pthread_create(&pl->threads[pl->nthreads], NULL, pipeline_worker, pl) != 0)
+            break;
+
+    if (pl->nthreads == 0) {
+        pipeline_end(pl);
+        return NULL;
+    }
+
+    return pl;
+#else
+    (void)nthreads;
+    (void)mem_budget;
+
+    return NULL;
+#endif /* H5REPACK_HAVE_PIPELINE */
+} /* end pipeline_init() */
+
+/*-------------------------------------------------------------------------
+ * Function: pipeline_end
+ *
+ * Purpose:  stop the filter threads and free the pipeline
+ *
+ * Return:   0, ok
+ *-------------------------------------------------------------------------
+ */
+int
+pipeline_end(pipeline_t *pl)
+{
+#ifdef H5REPACK_HAVE_PIPELINE
+    int t;
+
+    if (pl == NULL)
+        return 0;
+
+    pthread_mutex_lock(&pl->mutex);
+    pl->shutdown = TRUE;
+    pthread_cond_broadcast(&pl->work_cond);
+    pthread_mutex_unlock(&pl->mutex);
+
+    for (t = 0; t < pl->nthreads; t++)
+        pthread_join(pl->threads[t], NULL);
+
+    pipeline_free_slots(pl);
+    pthread_cond_destroy(&pl->done_cond);
+    pthread_cond_destroy(&pl->work_cond);
+    pthread_mutex_destroy(&pl->mutex);
+    HDfree(pl);
+#else
+    (void)pl;
+#endif /* H5REPACK_HAVE_PIPELINE */
+
+    return 0;
+} /* end pipeline_end() */
+
+/*-------------------------------------------------------------------------
+ * Function: pipeline_copy
+ *
+ * Purpose:  copy the data of DSET_IN to DSET_OUT, read with the memory
+ *           type WTYPE_ID that DSET_OUT was created with, through the
+ *           pipeline.
+ *
+ *           Only chunked output datasets of fixed size types, with no
+ *           filters other than shuffle and deflate, can be copied this way.
+ *
+ * Return:   1, copied,
+ *           0, the dataset can't be copied this way; nothing was written,
+ *          -1, failed
+ *-------------------------------------------------------------------------
+ */
+int
+pipeline_copy(pipeline_t *pl, hid_t dset_in, hid_t dset_out, hid_t wtype_id)
+{
+#ifdef H5REPACK_HAVE_PIPELINE
+    hid_t    dcpl_id = H5I_INVALID_HID;
+    hid_t    f_space_id = H5I_INVALID_HID;
+    hid_t    m_space_id = H5I_INVALID_HID;
+    int      rank;
+    int      k;
+    unsigned opts;
+    size_t   msize;
+    hsize_t  dims[H5S_MAX_RANK];
+    hsize_t  chunk_dims[H5S_MAX_RANK];
+    hsize_t  nchunks_dim[H5S_MAX_RANK];
+    hsize_t  count[H5S_MAX_RANK];
+    hsize_t  zero[H5S_MAX_RANK];
+    hsize_t  nchunks = 1;
+    hsize_t  next_read;
+    hsize_t  next_write;
+    size_t   chunk_nbytes;
+    size_t   u;
+    void    *fill = NULL;
+    int      ret_value = 1;
+
+    if (pl == NULL)
+        return 0;
+
+    /* the output must be chunked and of a fixed size type */
+    if (H5Tdetect_class(wtype_id, H5T_VLEN) != FALSE || H5Tdetect_class(wtype_id, H5T_REFERENCE) != FALSE)
+        return 0;
+    if (H5Tis_variable_str(wtype_id) != FALSE)
+        return 0;
+    if ((dcpl_id = H5Dget_create_plist(dset_out)) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Dget_create_plist failed");
+    if (H5Pget_layout(dcpl_id) != H5D_CHUNKED)
+        H5TOOLS_GOTO_DONE(0);
+
+    /* keep the library's handling of partial edge chunks */
+    if (H5Pget_chunk_opts(dcpl_id, &opts) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Pget_chunk_opts failed");
+    if (opts & H5D_CHUNK_DONT_FILTER_PARTIAL_CHUNKS)
+        H5TOOLS_GOTO_DONE(0);
+
+    if ((f_space_id = H5Dget_space(dset_out)) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Dget_space failed");
+    if ((rank = H5Sget_simple_extent_ndims(f_space_id)) <= 0)
+        H5TOOLS_GOTO_DONE(0);
+    if (H5Sget_simple_extent_dims(f_space_id, dims, NULL) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Sget_simple_extent_dims failed");
+    if (H5Pget_chunk(dcpl_id, rank, chunk_dims) != rank)
+        H5TOOLS_GOTO_ERROR((-1), "H5Pget_chunk failed");
+    if ((msize = H5Tget_size(wtype_id)) == 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Tget_size failed");
+
+    chunk_nbytes = msize;
+    for (k = 0; k < rank; k++) {
+        chunk_nbytes *= (size_t)chunk_dims[k];
+        nchunks_dim[k] = (dims[k] + chunk_dims[k] - 1) / chunk_dims[k];
+        nchunks *= nchunks_dim[k];
+        zero[k] = 0;
+    }
+
+    /* nothing gained by a single chunk */
+    if (nchunks < 2)
+        H5TOOLS_GOTO_DONE(0);
+
+    if ((ret_value = pipeline_setup(pl, dcpl_id, chunk_nbytes)) <= 0)
+        goto done;
+
+    /* replicate the fill value, to pad partial edge chunks with
+     * as the library would */
+    if (NULL == (fill = HDmalloc(chunk_nbytes)))
+        H5TOOLS_GOTO_ERROR((-1), "can't allocate space for fill value");
+    if (H5Pget_fill_value(dcpl_id, wtype_id, fill) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Pget_fill_value failed");
+    for (u = msize; u < chunk_nbytes; u += msize)
+        HDmemcpy((char *)fill + u, fill, msize);
+
+    if ((m_space_id = H5Screate_simple(rank, chunk_dims, NULL)) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Screate_simple failed");
+
+    for (next_read = 0, next_write = 0; next_write < nchunks; next_write++) {
+        slot_t *slot;
+
+        /* reader: fill the free slots */
+        while (next_read < nchunks && next_read - next_write < pl->nslots) {
+            hsize_t  idx = next_read;
+            hbool_t  partial = FALSE;
+
+            slot = &pl->slots[next_read % pl->nslots];
+
+            /* offset of chunk NEXT_READ, in row-major chunk order */
+            for (k = rank; k > 0; --k) {
+                slot->offset[k - 1] = (idx % nchunks_dim[k - 1]) * chunk_dims[k - 1];
+                idx /= nchunks_dim[k - 1];
+                count[k - 1] = MIN(chunk_dims[k - 1], dims[k - 1] - slot->offset[k - 1]);
+                if (count[k - 1] < chunk_dims[k - 1])
+                    partial = TRUE;
+            }
+
+            if (partial) {
+                HDmemcpy(slot->buf, fill, chunk_nbytes);
+                if (H5Sselect_hyperslab(m_space_id, H5S_SELECT_SET, zero, NULL, count, NULL) < 0)
+                    H5TOOLS_GOTO_ERROR((-1), "H5Sselect_hyperslab failed");
+            }
+            else if (H5Sselect_all(m_space_id) < 0)
+                H5TOOLS_GOTO_ERROR((-1), "H5Sselect_all failed");
+            if (H5Sselect_hyperslab(f_space_id, H5S_SELECT_SET, slot->offset, NULL, count, NULL) < 0)
+                H5TOOLS_GOTO_ERROR((-1), "H5Sselect_hyperslab failed");
+            if (H5Dread(dset_in, wtype_id, m_space_id, f_space_id, H5P_DEFAULT, slot->buf) < 0)
+                H5TOOLS_GOTO_ERROR((-1), "H5Dread failed");
+
+            slot->nbytes = chunk_nbytes;
+            slot->filter_mask = 0;
+            slot->status = 0;
+
+            pthread_mutex_lock(&pl->mutex);
+            slot->state = SLOT_QUEUED;
+            pl->queue[(pl->q_head + pl->q_count) % pl->nslots] = (unsigned)(next_read % pl->nslots);
+            pl->q_count++;
+            pthread_cond_signal(&pl->work_cond);
+            pthread_mutex_unlock(&pl->mutex);
+
+            next_read++;
+        }
+
+        /* writer: the chunks go out in order */
+        slot = &pl->slots[next_write % pl->nslots];
+        pthread_mutex_lock(&pl->mutex);
+        while (slot->state != SLOT_DONE)
+            pthread_cond_wait(&pl->done_cond, &pl->mutex);
+        pthread_mutex_unlock(&pl->mutex);
+
+        if (slot->status < 0)
+            H5TOOLS_GOTO_ERROR((-1), "filter failed");
+        if (H5Dwrite_chunk(dset_out, H5P_DEFAULT, slot->filter_mask, slot->offset, slot->nbytes, slot->buf) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Dwrite_chunk failed");
+        slot->state = SLOT_FREE;
+    }
+
+done:
+    /* wait for chunks still being filtered */
+    if (pl->slots)
+        pipeline_drain(pl);
+    if (fill)
+        HDfree(fill);
+    H5E_BEGIN_TRY {
+        H5Sclose(m_space_id);
+        H5Sclose(f_space_id);
+        H5Pclose(dcpl_id);
+    } H5E_END_TRY;
+
+    return ret_value;
+#else
+    (void)pl;
+    (void)dset_in;
+    (void)dset_out;
+    (void)wtype_id;
+
+    return 0;
+#endif /* H5REPACK_HAVE_PIPELINE */
+} /* end pipeline_copy() */
+
+#ifdef H5REPACK_HAVE_PIPELINE
+
+/*-------------------------------------------------------------------------
+ * Function: pipeline_setup
+ *
+ * Purpose:  get the filters of DCPL_ID and make sure the slots can hold
+ *           chunks of CHUNK_NBYTES
+ *
+ * Return:   1, ok, 0, a filter can't be run by the pipeline, -1, failed
+ *-------------------------------------------------------------------------
+ */
+static int
+pipeline_setup(pipeline_t *pl, hid_t dcpl_id, size_t chunk_nbytes)
+{
+    int      nfilters;
+    int      f;
+    unsigned u;
+    size_t   tmp_nbytes;
+    int      ret_value = 1;
+
+    if ((nfilters = H5Pget_nfilters(dcpl_id)) < 0)
+        H5TOOLS_GOTO_ERROR((-1), "H5Pget_nfilters failed");
+    if (nfilters > H5_REPACK_MAX_NFILTERS)
+        H5TOOLS_GOTO_DONE(0);
+
+    for (f = 0; f < nfilters; f++) {
+        unsigned cd_values[CD_VALUES];
+        size_t   cd_nelmts = CD_VALUES;
+        unsigned flags;
+        unsigned config;
+        H5Z_filter_t filtn;
+
+        if ((filtn = H5Pget_filter2(dcpl_id, (unsigned)f, &flags, &cd_nelmts, cd_values, 0, NULL, &config)) < 0)
+            H5TOOLS_GOTO_ERROR((-1), "H5Pget_filter2 failed");
+        if ((filtn != H5Z_FILTER_SHUFFLE && filtn != H5Z_FILTER_DEFLATE) || cd_nelmts < 1)
+            H5TOOLS_GOTO_DONE(0);
+
+        pl->filter[f].filtn = filtn;
+        pl->filter[f].flags = flags;
+        pl->filter[f].cd_value = cd_values[0];
+    }
+    pl->nfilters = nfilters;
+
+    /* a chunk can grow by deflate */
+    tmp_nbytes = (size_t)compressBound((uLong)chunk_nbytes);
+
+    /* keep the slots of the last dataset if the chunks fit */
+    if (pl->slots && pl->tmp_nbytes >= tmp_nbytes)
+        H5TOOLS_GOTO_DONE(1);
+    pipeline_free_slots(pl);
+
+    pl->nslots = (unsigned)pl->nthreads * PIPELINE_SLOTS_PER_THREAD;
+    if (pl->mem_budget > 0) {
+        size_t nslots = pl->mem_budget / (2 * tmp_nbytes);
+
+        nslots = MAX(nslots, (size_t)pl->nthreads);
+        pl->nslots = (unsigned)MIN(nslots, (size_t)pl->nslots);
+    }
+    if (NULL == (pl->slots = (slot_t *)HDcalloc(pl->nslots, sizeof(slot_t))))
+        H5TOOLS_GOTO_ERROR((-1), "can't allocate pipeline slots");
+    if (NULL == (pl->queue = (unsigned *)HDcalloc(pl->nslots, sizeof(unsigned))))
+        H5TOOLS_GOTO_ERROR((-1), "can't allocate pipeline queue");
+    pl->tmp_nbytes = tmp_nbytes;
+    for (u = 0; u < pl->nslots; u++) {
+        /* both buffers take filter output, so size them for it */
+        if (NULL == (pl->slots[u].buf = HDmalloc(tmp_nbytes)))
+            H5TOOLS_GOTO_ERROR((-1), "can't allocate pipeline buffers");
+        if (NULL == (pl->slots[u].tmp = HDmalloc(tmp_nbytes)))
+            H5TOOLS_GOTO_ERROR((-1), "can't allocate pipeline buffers");
+    }
+
+done:
+    if (ret_value < 0)
+        pipeline_free_slots(pl);
+
+    return ret_value;
+} /* end pipeline_setup() */
+
+/*-------------------------------------------------------------------------
+ * Function: pipeline_filter
+ *
+ * Purpose:  run the output filters on the chunk in SLOT, as the library's
+ *           filter pipeline would: a failed optional filter is skipped
+ *           and flagged in the filter mask.
+ *
+ * Return:   0, ok, -1, a mandatory filter failed
+ *-------------------------------------------------------------------------
+ */
+static int
+pipeline_filter(pipeline_t *pl, slot_t *slot)
+{
+    int f;
+
+    for (f = 0; f < pl->nfilters; f++) {
+        const pipe_filter_t *filter = &pl->filter[f];
+        void  *swap;
+        hbool_t failed = FALSE;
+
+        if (filter->filtn == H5Z_FILTER_SHUFFLE) {
+            size_t size = filter->cd_value;
+            size_t nelmts = size ? slot->nbytes / size : 0;
+            size_t leftover;
+            size_t i, j;
+            const unsigned char *src = (const unsigned char *)slot->buf;
+            unsigned char *dst = (unsigned char *)slot->tmp;
+
+            /* the library leaves these alone too */
+            if (size <= 1 || nelmts <= 1)
+                continue;
+
+            for (j = 0; j < size; j++)
+                for (i = 0; i < nelmts; i++)
+                    dst[j * nelmts + i] = src[i * size + j];
+            leftover = slot->nbytes % size;
+            if (leftover)
+                HDmemcpy(dst + nelmts * size, src + nelmts * size, leftover);
+        }
+        else {
+            uLongf z_nbytes = (uLongf)pl->tmp_nbytes;
+
+            if (compress2((Bytef *)slot->tmp, &z_nbytes, (const Bytef *)slot->buf,
+                    (uLong)slot->nbytes, (int)filter->cd_value) != Z_OK)
+                failed = TRUE;
+            else
+                slot->nbytes = (size_t)z_nbytes;
+        }
+
+        if (failed) {
+            if (!(filter->flags & H5Z_FLAG_OPTIONAL))
+                return -1;
+            slot->filter_mask |= (uint32_t)1 << f;
+            continue;
+        }
+
+        swap = slot->buf;
+        slot->buf = slot->tmp;
+        slot->tmp = swap;
+    }
+
+    return 0;
+} /* end pipeline_filter() */
+
+/*-------------------------------------------------------------------------
+ * Function: pipeline_worker
+ *
+ * Purpose:  filter thread: filter queued slots until shut down
+ *
+ * Return:   NULL
+ *-------------------------------------------------------------------------
+ */
+static void *
+pipeline_worker(void *arg)
+{
+    pipeline_t *pl = (pipeline_t *)arg;
+
+    pthread_mutex_lock(&pl->mutex);
+    for (;;) {
+        slot_t *slot;
+
+        while (pl->q_count == 0 && !pl->shutdown)
+            pthread_cond_wait(&pl->work_cond, &pl->mutex);
+        if (pl->q_count == 0)
+            break;
+
+        slot = &pl->slots[pl->queue[pl->q_head]];
+        pl->q_head = (pl->q_head + 1) % pl->nslots;
+        pl->q_count--;
+        pthread_mutex_unlock(&pl->mutex);
+
+        slot->status = pipeline_filter(pl, slot);
+
+        pthread_mutex_lock(&pl->mutex);
+        slot->state = SLOT_DONE;
+        pthread_cond_broadcast(&pl->done_cond);
+    }
+    pthread_mutex_unlock(&pl->mutex);
+
+    return NULL;
+} /* end pipeline_worker() */
+
+/*-------------------------------------------------------------------------
+ * Function: pipeline_drain
+ *
+ * Purpose:  wait for the queued slots to be filtered, and free all slots
+ *
+ * Return:   void
+ *-------------------------------------------------------------------------
+ */
+static void
+pipeline_drain(pipeline_t *pl)
+{
+    unsigned u;
+
+    pthread_mutex_lock(&pl->mutex);
+    for (u = 0; u < pl->nslots; u++) {
+        while (pl->slots[u].state == SLOT_QUEUED)
+            pthread_cond_wait(&pl->done_cond, &pl->mutex);
+        pl->slots[u].state = SLOT_FREE;
+    }
+    pl->q_head = 0;
+    pthread_mutex_unlock(&pl->mutex);
+} /* end pipeline_drain() */
+
+/*-------------------------------------------------------------------------
+ * Function: pipeline_free_slots
+ *
+ * Purpose:  free the slots and their buffers
+ *
+ * Return:   void
+ *-------------------------------------------------------------------------
+ */
+static void
+pipeline_free_slots(pipeline_t *pl)
+{
+    unsigned u;
+
+    if (pl->slots) {
+        for (u = 0; u < pl->nslots; u++) {
+            if (pl->slots[u].buf)
+                HDfree(pl->slots[u].buf);
+            if (pl->slots[u].tmp)
+                HDfree(pl->slots[u].tmp);
+        }
+        HDfree(pl->slots);
+        pl->slots = NULL;
+    }
+    if (pl->queue) {
+        HDfree(pl->queue);
+        pl->queue = NULL;
+    }
+    pl->nslots = 0;
+    pl->tmp_nbytes = 0;
+}  /* end pipeline_free_slots() */
+
+#endif /* H5REPACK_HAVE_PIPELINE */